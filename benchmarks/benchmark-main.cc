@@ -4,6 +4,8 @@
 #include "value-types.hh"
 #include "prim-types.hh"
 #include "usdGeom.hh"
+#include "tydra/skinning.hh"
+#include "integerCoding.h"
 
 using namespace tinyusdz;
 
@@ -61,8 +63,7 @@ UBENCH(perf, timesamples_double_10M)
   tinyusdz::value::TimeSamples ts;
 
   for (size_t i = 0; i < ns; i++) {
-    ts.times.push_back(double(i));
-    ts.values.push_back(double(i));
+    ts.add_sample(double(i), value::Value(double(i)));
   }
 }
 
@@ -104,6 +105,93 @@ UBENCH(perf, string_vector_10M)
 
 }
 
+// 100K vertices, 4 influences per vertex, 64 joints chain.
+UBENCH_EX(tydra, skinning_lbs_100K)
+{
+  using namespace tinyusdz::tydra;
+
+  constexpr size_t nverts = 100 * 1000;
+  constexpr int njoints = 64;
+  constexpr int ninfluences = 4;
+
+  SkelHierarchy skel;
+  Animation anim;
+  {
+    SkelNode *node = &skel.root_node;
+    std::string path = "j0";
+    for (int j = 0; j < njoints; j++) {
+      if (j > 0) {
+        path += "/j" + std::to_string(j);
+        node->children.emplace_back();
+        node = &node->children.back();
+        node->rest_transform.m[3][1] = 1.0;
+        node->bind_transform.m[3][1] = double(j);
+      }
+      node->joint_path = path;
+      node->joint_id = j;
+
+      AnimationChannel rot(AnimationChannel::ChannelType::Rotation);
+      rot.rotations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f, 1.0f}});
+      rot.rotations.samples.push_back({1.0f, {0.0f, 0.0f, 0.0998f, 0.995f}});
+      anim.channels_map[path].emplace(rot.type, rot);
+      AnimationChannel trans(AnimationChannel::ChannelType::Translation);
+      trans.translations.static_value = value::float3{0.0f, (j > 0) ? 1.0f : 0.0f, 0.0f};
+      anim.channels_map[path].emplace(trans.type, trans);
+    }
+  }
+
+  RenderMesh mesh;
+  mesh.points.resize(nverts);
+  mesh.joint_and_weights.elementSize = ninfluences;
+  mesh.joint_and_weights.jointIndices.resize(nverts * ninfluences);
+  mesh.joint_and_weights.jointWeights.resize(nverts * ninfluences);
+  for (size_t i = 0; i < nverts; i++) {
+    const float y = float(njoints - 1) * float(i) / float(nverts);
+    mesh.points[i] = {float(i % 10) * 0.1f, y, 0.0f};
+    const int j = int(y);
+    for (int k = 0; k < ninfluences; k++) {
+      mesh.joint_and_weights.jointIndices[i * ninfluences + size_t(k)] = (std::min)(j + k, njoints - 1);
+      mesh.joint_and_weights.jointWeights[i * ninfluences + size_t(k)] = 0.25f;
+    }
+  }
+
+  SkinningConfig config;
+  SkinningEvaluator evaluator;
+  evaluator.Setup(mesh, &skel, config);
+
+  DeformedMesh deformed;
+
+  UBENCH_DO_BENCHMARK() {
+    evaluator.Evaluate(&anim, 0.5, &deformed);
+  }
+}
+
+// Decode 1M indices(e.g. faceVertexIndices) with reused working space, as
+// CrateReader does.
+UBENCH_EX(crate, integer_decompress_1M)
+{
+  using Compressor = tinyusdz::Usd_IntegerCompression;
+
+  constexpr size_t n = 1000 * 1000;
+  std::vector<int32_t> ints(n);
+  uint32_t x = 1;
+  for (size_t i = 0; i < n; i++) {
+    x = x * 1664525u + 1013904223u;
+    ints[i] = int32_t(i / 2) + int32_t((x >> 16) % 64);
+  }
+
+  std::vector<char> compressed(Compressor::GetCompressedBufferSize(n));
+  std::string err;
+  size_t compressed_size = Compressor::CompressToBuffer(ints.data(), n, compressed.data(), &err);
+
+  std::vector<char> working_space(Compressor::GetDecompressionWorkingSpaceSize(n));
+  std::vector<int32_t> decoded(n);
+
+  UBENCH_DO_BENCHMARK() {
+    Compressor::DecompressFromBuffer(compressed.data(), compressed_size, decoded.data(), n, &err, working_space.data());
+  }
+}
+
 //int main(int argc, char **argv)
 //{
 //  benchmark_any_type();
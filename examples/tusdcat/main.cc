@@ -188,6 +188,22 @@ int main(int argc, char **argv) {
     resolver.set_current_working_path(base_dir);
     resolver.set_search_paths({base_dir});
 
+    // Parse each referenced asset only once across composition passes, and
+    // load assets of each pass in parallel.
+    tinyusdz::LayerCache layer_cache;
+
+    tinyusdz::SublayersCompositionOptions sublayers_options;
+    sublayers_options.layer_cache = &layer_cache;
+    sublayers_options.num_threads = -1;
+
+    tinyusdz::ReferencesCompositionOptions references_options;
+    references_options.layer_cache = &layer_cache;
+    references_options.num_threads = -1;
+
+    tinyusdz::PayloadCompositionOptions payload_options;
+    payload_options.layer_cache = &layer_cache;
+    payload_options.num_threads = -1;
+
     //
     // LIVRPS strength ordering
     // - [x] Local(subLayers)
@@ -201,7 +217,7 @@ int main(int argc, char **argv) {
     tinyusdz::Layer src_layer = root_layer;
     if (comp_features.subLayers) {
       tinyusdz::Layer composited_layer;
-      if (!tinyusdz::CompositeSublayers(resolver, src_layer, &composited_layer, &warn, &err)) {
+      if (!tinyusdz::CompositeSublayers(resolver, src_layer, &composited_layer, &warn, &err, sublayers_options)) {
         std::cerr << "Failed to composite subLayers: " << err << "\n";
         return -1;
       }
@@ -228,7 +244,7 @@ int main(int argc, char **argv) {
           has_unresolved = true;
 
           tinyusdz::Layer composited_layer;
-          if (!tinyusdz::CompositeReferences(resolver, src_layer, &composited_layer, &warn, &err)) {
+          if (!tinyusdz::CompositeReferences(resolver, src_layer, &composited_layer, &warn, &err, references_options)) {
             std::cerr << "Failed to composite `references`: " << err << "\n";
             return -1;
           }
@@ -251,7 +267,7 @@ int main(int argc, char **argv) {
           has_unresolved = true;
 
           tinyusdz::Layer composited_layer;
-          if (!tinyusdz::CompositePayload(resolver, src_layer, &composited_layer, &warn, &err)) {
+          if (!tinyusdz::CompositePayload(resolver, src_layer, &composited_layer, &warn, &err, payload_options)) {
             std::cerr << "Failed to composite `payload`: " << err << "\n";
             return -1;
           }
@@ -0,0 +1,13 @@
+curdir=`pwd`
+
+builddir=${curdir}/build_thread
+
+rm -rf ${builddir}
+mkdir ${builddir}
+
+# Build with multi-threading enabled, so that unit tests compare parallel
+# loading/conversion against serial ones.
+cd ${builddir} && cmake \
+  -DCMAKE_VERBOSE_MAKEFILE=1 \
+  -DTINYUSDZ_ENABLE_THREAD=On \
+  ..
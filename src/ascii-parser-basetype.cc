@@ -16,9 +16,11 @@
 #include <atomic>
 //#include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <set>
 #include <sstream>
@@ -141,11 +143,11 @@ int parseInt(const std::string &s, int *out_result) {
   return 0;  // OK
 }
 
-nonstd::expected<float, std::string> ParseFloat(const std::string &s) {
+nonstd::expected<float, std::string> ParseFloat(const char *s, const char *e) {
 
   // Parse with fast_float
   float result;
-  auto ans = fast_float::from_chars(s.data(), s.data() + s.size(), result);
+  auto ans = fast_float::from_chars(s, e, result);
   if (ans.ec != std::errc()) {
     // Current `fast_float` implementation does not report detailed parsing err.
     return nonstd::make_unexpected("Parse failed.");
@@ -154,11 +156,11 @@ nonstd::expected<float, std::string> ParseFloat(const std::string &s) {
   return result;
 }
 
-nonstd::expected<double, std::string> ParseDouble(const std::string &s) {
+nonstd::expected<double, std::string> ParseDouble(const char *s, const char *e) {
 
   // Parse with fast_float
   double result;
-  auto ans = fast_float::from_chars(s.data(), s.data() + s.size(), result);
+  auto ans = fast_float::from_chars(s, e, result);
   if (ans.ec != std::errc()) {
     // Current `fast_float` implementation does not report detailed parsing err.
     return nonstd::make_unexpected("Parse failed.");
@@ -167,6 +169,371 @@ nonstd::expected<double, std::string> ParseDouble(const std::string &s) {
   return result;
 }
 
+///
+/// Element layout for the numeric array fast path.
+/// `rows` = 0: scalar, 1: tuple `(a, b, ...)`, >= 2: matrix `((...), ...)`.
+///
+template <typename T>
+struct NumericArrayTraits {
+  static constexpr bool supported = false;
+};
+
+#define NUMERIC_ARRAY_TRAITS(__ty, __scalar_ty, __rows, __cols) \
+  template <>                                                    \
+  struct NumericArrayTraits<__ty> {                              \
+    static constexpr bool supported = true;                      \
+    using scalar_type = __scalar_ty;                             \
+    static constexpr size_t rows = __rows;                       \
+    static constexpr size_t cols = __cols;                       \
+  };
+
+NUMERIC_ARRAY_TRAITS(int32_t, int32_t, 0, 1)
+NUMERIC_ARRAY_TRAITS(value::int2, int32_t, 1, 2)
+NUMERIC_ARRAY_TRAITS(value::int3, int32_t, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::int4, int32_t, 1, 4)
+NUMERIC_ARRAY_TRAITS(float, float, 0, 1)
+NUMERIC_ARRAY_TRAITS(value::float2, float, 1, 2)
+NUMERIC_ARRAY_TRAITS(value::float3, float, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::float4, float, 1, 4)
+NUMERIC_ARRAY_TRAITS(double, double, 0, 1)
+NUMERIC_ARRAY_TRAITS(value::double2, double, 1, 2)
+NUMERIC_ARRAY_TRAITS(value::double3, double, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::double4, double, 1, 4)
+NUMERIC_ARRAY_TRAITS(value::texcoord2f, float, 1, 2)
+NUMERIC_ARRAY_TRAITS(value::texcoord2d, double, 1, 2)
+NUMERIC_ARRAY_TRAITS(value::texcoord3f, float, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::texcoord3d, double, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::point3f, float, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::point3d, double, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::normal3f, float, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::normal3d, double, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::vector3f, float, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::vector3d, double, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::color3f, float, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::color3d, double, 1, 3)
+NUMERIC_ARRAY_TRAITS(value::color4f, float, 1, 4)
+NUMERIC_ARRAY_TRAITS(value::color4d, double, 1, 4)
+NUMERIC_ARRAY_TRAITS(value::matrix2f, float, 2, 2)
+NUMERIC_ARRAY_TRAITS(value::matrix3f, float, 3, 3)
+NUMERIC_ARRAY_TRAITS(value::matrix4f, float, 4, 4)
+NUMERIC_ARRAY_TRAITS(value::matrix2d, double, 2, 2)
+NUMERIC_ARRAY_TRAITS(value::matrix3d, double, 3, 3)
+NUMERIC_ARRAY_TRAITS(value::matrix4d, double, 4, 4)
+
+#undef NUMERIC_ARRAY_TRAITS
+
+///
+/// Scans the content of numeric array literal(after `[`) directly on the input
+/// buffer.
+///
+/// Only the plain form(numbers, whitespaces, newlines and separators) is
+/// accepted. Anything else(comment, `None`, inf/nan, malformed literal, ...)
+/// makes the scan fail, and the caller falls back to the generic parser, which
+/// also reports the error.
+///
+class NumericArrayScanner {
+ public:
+  NumericArrayScanner(const char *p, const char *end)
+      : _p(p), _end(end), _line_start(p) {}
+
+  const char *pos() const { return _p; }
+
+  // The number of newlines consumed.
+  int num_newlines() const { return _num_newlines; }
+
+  // The beginning of the current line. Valid when `num_newlines() > 0`.
+  const char *line_start() const { return _line_start; }
+
+  ///
+  /// Scans elements until `]`. The scan position stays at the closing `]`.
+  ///
+  template <typename T>
+  bool Scan(std::vector<T> *result) {
+    using Traits = NumericArrayTraits<T>;
+    using S = typename Traits::scalar_type;
+    constexpr size_t kNumScalars =
+        (Traits::rows == 0) ? 1 : (Traits::rows * Traits::cols);
+    static_assert(sizeof(T) == sizeof(S) * kNumScalars,
+                  "Element must be a packed array of scalars.");
+
+    // Pre-scan to size the output. Numeric literals never contain `]`, so
+    // the first `]` closes the array.
+    const void *close = memchr(_p, ']', size_t(_end - _p));
+    if (!close) {
+      return false;
+    }
+    _end = reinterpret_cast<const char *>(close);
+
+    if (memchr(_p, '#', size_t(_end - _p))) {
+      // Has a comment.
+      return false;
+    }
+
+    size_t n;
+    if (Traits::rows == 0) {
+      // May be one larger than the actual number of elements when the array
+      // ends with `,`
+      n = size_t(std::count(_p, _end, ',')) + 1;
+    } else {
+      n = size_t(std::count(_p, _end, '(')) /
+          ((Traits::rows == 1) ? 1 : (Traits::rows + 1));
+    }
+
+    if (n == 0) {
+      return false;
+    }
+
+    result->resize(n);
+
+    size_t count = 0;
+    S buf[kNumScalars];
+    while (count < n) {
+      SkipWhitespaceAndNewline();
+
+      bool ok;
+      if (Traits::rows == 0) {
+        ok = ReadScalar(&buf[0]);
+      } else if (Traits::rows == 1) {
+        ok = ReadTuple(Traits::cols, buf);
+      } else {
+        ok = ReadMatrix(Traits::rows, Traits::cols, buf);
+      }
+
+      if (!ok) {
+        return false;
+      }
+
+      memcpy(reinterpret_cast<void *>(&(*result)[count]), buf, sizeof(T));
+      count++;
+
+      SkipWhitespaceAndNewline();
+      if (_p == _end) {
+        break;
+      }
+
+      if (*_p != ',') {
+        return false;
+      }
+      _p++;
+
+      // Allow `,` at the end of the array.
+      SkipWhitespaceAndNewline();
+      if (_p == _end) {
+        break;
+      }
+    }
+
+    if (_p != _end) {
+      return false;
+    }
+
+    result->resize(count);
+
+    return true;
+  }
+
+ private:
+  static bool IsDigit(const char c) { return (c >= '0') && (c <= '9'); }
+
+  // Same character set as AsciiParser::SkipWhitespaceAndNewline()
+  void SkipWhitespaceAndNewline() {
+    while (_p < _end) {
+      const char c = *_p;
+      if ((c == ' ') || (c == '\t') || (c == '\f') || (c == ';')) {
+        _p++;
+      } else if (c == '\n') {
+        _p++;
+        _num_newlines++;
+        _line_start = _p;
+      } else if (c == '\r') {
+        _p++;
+        // CRLF?
+        if ((_p < _end) && (*_p == '\n')) {
+          _p++;
+        }
+        _num_newlines++;
+        _line_start = _p;
+      } else {
+        break;
+      }
+    }
+  }
+
+  bool Expect(const char c) {
+    SkipWhitespaceAndNewline();
+    if ((_p < _end) && (*_p == c)) {
+      _p++;
+      return true;
+    }
+    return false;
+  }
+
+  //
+  // Lex the literal with the grammar of AsciiParser::LexFloat(), then parse
+  // it with `fast_float`. The whole literal must be consumed by `fast_float`.
+  //
+  template <typename S>
+  bool ParseFloatLiteral(S *result) {
+    const char *s = _p;
+    const char *p = _p;
+
+    if ((p < _end) && ((*p == '+') || (*p == '-'))) {
+      p++;
+    }
+
+    bool has_digit = false;
+    while ((p < _end) && IsDigit(*p)) {
+      p++;
+      has_digit = true;
+    }
+
+    if ((p < _end) && (*p == '.')) {
+      p++;
+      while ((p < _end) && IsDigit(*p)) {
+        p++;
+        has_digit = true;
+      }
+    }
+
+    if (!has_digit) {
+      return false;
+    }
+
+    if ((p < _end) && ((*p == 'e') || (*p == 'E'))) {
+      p++;
+      if ((p < _end) && ((*p == '+') || (*p == '-'))) {
+        p++;
+      }
+
+      const char *exp_begin = p;
+      while ((p < _end) && IsDigit(*p)) {
+        p++;
+      }
+
+      if (p == exp_begin) {
+        return false;
+      }
+    }
+
+    auto ans = fast_float::from_chars(s, p, *result);
+    if ((ans.ec != std::errc()) || (ans.ptr != p)) {
+      return false;
+    }
+
+    _p = p;
+    return true;
+  }
+
+  bool ReadScalar(float *result) { return ParseFloatLiteral(result); }
+
+  bool ReadScalar(double *result) { return ParseFloatLiteral(result); }
+
+  // Plain integer literal only. Floating-point literal(e.g. `1e3`, `1.0`)
+  // and zero padded integer are left to the generic parser(See
+  // AsciiParser::ReadBasicType(int *)).
+  bool ReadScalar(int32_t *result) {
+    const char *p = _p;
+
+    bool negative = false;
+    if ((p < _end) && ((*p == '+') || (*p == '-'))) {
+      negative = (*p == '-');
+      p++;
+    }
+
+    const char *digits = p;
+    int64_t v = 0;
+    while ((p < _end) && IsDigit(*p)) {
+      v = v * 10 + int64_t(*p - '0');
+      if (v > int64_t((std::numeric_limits<int32_t>::max)()) + 1) {
+        return false;
+      }
+      p++;
+    }
+
+    if (p == digits) {
+      return false;
+    }
+
+    if (((p - digits) > 1) && (*digits == '0')) {
+      return false;
+    }
+
+    if ((p < _end) && ((*p == '.') || (*p == 'e') || (*p == 'E'))) {
+      return false;
+    }
+
+    if (negative) {
+      v = -v;
+    }
+
+    if (v > int64_t((std::numeric_limits<int32_t>::max)())) {
+      return false;
+    }
+
+    (*result) = int32_t(v);
+    _p = p;
+    return true;
+  }
+
+  template <typename S>
+  bool ReadTuple(const size_t n, S *result) {
+    if (!Expect('(')) {
+      return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      if ((i > 0) && !Expect(',')) {
+        return false;
+      }
+
+      SkipWhitespaceAndNewline();
+      if (!ReadScalar(&result[i])) {
+        return false;
+      }
+    }
+
+    return Expect(')');
+  }
+
+  template <typename S>
+  bool ReadMatrix(const size_t rows, const size_t cols, S *result) {
+    if (!Expect('(')) {
+      return false;
+    }
+
+    for (size_t i = 0; i < rows; i++) {
+      if ((i > 0) && !Expect(',')) {
+        return false;
+      }
+
+      if (!ReadTuple(cols, &result[i * cols])) {
+        return false;
+      }
+    }
+
+    return Expect(')');
+  }
+
+  const char *_p{nullptr};
+  const char *_end{nullptr};
+  const char *_line_start{nullptr};
+  int _num_newlines{0};
+};
+
+template <typename T>
+typename std::enable_if<NumericArrayTraits<T>::supported, bool>::type
+ScanNumericArray(NumericArrayScanner *scanner, std::vector<T> *result) {
+  return scanner->Scan(result);
+}
+
+template <typename T>
+typename std::enable_if<!NumericArrayTraits<T>::supported, bool>::type
+ScanNumericArray(NumericArrayScanner *scanner, std::vector<T> *result) {
+  (void)scanner;
+  (void)result;
+  return false;
+}
+
 }  // namespace
 
 //
@@ -794,14 +1161,13 @@ bool AsciiParser::ReadBasicType(nonstd::optional<bool> *value) {
 }
 
 bool AsciiParser::ReadBasicType(int *value) {
-  std::stringstream ss;
-
   // pxrUSD allow floating-point value to `int` type.
   // so first try fp parsing.
   auto loc = CurrLoc();
-  std::string fp_str;
-  if (LexFloat(&fp_str)) {
-    auto flt = ParseDouble(fp_str);
+  const char *fp_begin{nullptr};
+  const char *fp_end{nullptr};
+  if (LexFloat(&fp_begin, &fp_end)) {
+    auto flt = ParseDouble(fp_begin, fp_end);
     if (!flt) {
       PUSH_ERROR_AND_RETURN("Failed to parse floating value.");
     } else {
@@ -813,6 +1179,8 @@ bool AsciiParser::ReadBasicType(int *value) {
   // revert
   SeekTo(loc);
 
+  std::stringstream ss;
+
   // head character
   bool has_sign = false;
   // bool negative = false;
@@ -1922,6 +2290,26 @@ bool AsciiParser::ParseBasicTypeArray(std::vector<T> *result) {
     Rewind(1);
   }
 
+  // Fast path for plain numeric array(e.g. `point3f[]`, `int[]`). Scan the
+  // input buffer directly and write elements to `result` without going
+  // through ReadBasicType() for each element.
+  {
+    const char *buf = reinterpret_cast<const char *>(_sr->data());
+    const uint64_t start = _sr->tell();
+    NumericArrayScanner scanner(buf + start, buf + _sr->size());
+    if (ScanNumericArray(&scanner, result)) {
+      if (scanner.num_newlines() > 0) {
+        _curr_cursor.row += scanner.num_newlines();
+        _curr_cursor.col = int(scanner.pos() - scanner.line_start());
+      } else {
+        _curr_cursor.col += int(scanner.pos() - (buf + start));
+      }
+      _sr->seek_set(uint64_t(scanner.pos() - buf));
+
+      return Expect(']');
+    }
+  }
+
   if (!SepBy1BasicType<T>(',', ']', result)) {
     return false;
   }
@@ -2303,14 +2691,15 @@ bool AsciiParser::ParseBasicTypeArray(std::vector<Path> *result) {
 
 template <typename T>
 bool AsciiParser::MaybeNonFinite(T *out) {
-  auto loc = CurrLoc();
-
   // "-inf", "inf" or "nan"
-  std::vector<char> buf(4);
-  if (!CharN(3, &buf)) {
+  // Compare on the input buffer directly(no allocation).
+  const uint64_t loc = CurrLoc();
+  const uint64_t len = _sr->size();
+  const char *buf = reinterpret_cast<const char *>(_sr->data()) + loc;
+
+  if ((loc + 3) > len) {
     return false;
   }
-  SeekTo(loc);
 
   if ((buf[0] == 'i') && (buf[1] == 'n') && (buf[2] == 'f')) {
     (*out) = std::numeric_limits<T>::infinity();
@@ -2322,10 +2711,7 @@ bool AsciiParser::MaybeNonFinite(T *out) {
     return true;
   }
 
-  bool ok = CharN(4, &buf);
-  SeekTo(loc);
-
-  if (ok) {
+  if ((loc + 4) <= len) {
     if ((buf[0] == '-') && (buf[1] == 'i') && (buf[2] == 'n') &&
         (buf[3] == 'f')) {
       (*out) = -std::numeric_limits<T>::infinity();
@@ -2822,12 +3208,13 @@ bool AsciiParser::ReadBasicType(float *value) {
     }
   }
 
-  std::string value_str;
-  if (!LexFloat(&value_str)) {
+  const char *value_begin{nullptr};
+  const char *value_end{nullptr};
+  if (!LexFloat(&value_begin, &value_end)) {
     PUSH_ERROR_AND_RETURN("Failed to lex floating value literal.");
   }
 
-  auto flt = ParseFloat(value_str);
+  auto flt = ParseFloat(value_begin, value_end);
   if (flt) {
     (*value) = flt.value();
   } else {
@@ -2862,12 +3249,13 @@ bool AsciiParser::ReadBasicType(double *value) {
     }
   }
 
-  std::string value_str;
-  if (!LexFloat(&value_str)) {
+  const char *value_begin{nullptr};
+  const char *value_end{nullptr};
+  if (!LexFloat(&value_begin, &value_end)) {
     PUSH_ERROR_AND_RETURN("Failed to lex floating value literal.");
   }
 
-  auto flt = ParseDouble(value_str);
+  auto flt = ParseDouble(value_begin, value_end);
   if (!flt) {
     PUSH_ERROR_AND_RETURN("Failed to parse floating value.");
   } else {
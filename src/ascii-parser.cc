@@ -16,6 +16,7 @@
 #include <cstdio>
 //#include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -1076,23 +1077,21 @@ bool AsciiParser::ParseVariants(VariantSelectionMap *out_map) {
 
 // 'None'
 bool AsciiParser::MaybeNone() {
-  std::vector<char> buf;
-
-  auto loc = CurrLoc();
+  // Compare on the input buffer directly(no allocation).
+  const uint64_t loc = CurrLoc();
 
-  if (!CharN(4, &buf)) {
-    SeekTo(loc);
+  if ((loc + 4) > _sr->size()) {
     return false;
   }
 
+  const char *buf = reinterpret_cast<const char *>(_sr->data()) + loc;
+
   if ((buf[0] == 'N') && (buf[1] == 'o') && (buf[2] == 'n') &&
       (buf[3] == 'e')) {
     // got it
-    return true;
+    return SeekTo(loc + 4);
   }
 
-  SeekTo(loc);
-
   return false;
 }
 
@@ -2115,40 +2114,44 @@ bool AsciiParser::PopParserState(ParseState *state) {
 }
 
 bool AsciiParser::SkipWhitespace() {
-  while (!Eof()) {
-    char c;
-    if (!Char1(&c)) {
-      // this should not happen.
-      return false;
-    }
-    _curr_cursor.col++;
-
+  // Scan the input buffer directly.
+  const char *buf = reinterpret_cast<const char *>(_sr->data());
+  const uint64_t len = _sr->size();
+  const uint64_t start = _sr->tell();
+  uint64_t pos = start;
+
+  while ((pos < len) && (buf[pos] != '\0')) {
+    char c = buf[pos];
     if ((c == ' ') || (c == '\t') || (c == '\f')) {
-      // continue
+      pos++;
     } else {
       break;
     }
   }
 
-  // unwind 1 char
-  if (!_sr->seek_from_current(-1)) {
-    return false;
+  _curr_cursor.col += int(pos - start);
+
+  if ((pos >= len) || (buf[pos] == '\0')) {
+    // Reached to the end of the buffer. Unwind 1 char.
+    if (pos == 0) {
+      return false;
+    }
+    pos--;
+    _curr_cursor.col--;
   }
-  _curr_cursor.col--;
 
-  return true;
+  return _sr->seek_set(pos);
 }
 
 bool AsciiParser::SkipWhitespaceAndNewline(const bool allow_semicolon) {
   // USDA also allow C-style ';' as a newline separator.
-  while (!Eof()) {
-    char c;
-    if (!Char1(&c)) {
-      // this should not happen.
-      return false;
-    }
+  // Scan the input buffer directly.
+  const char *buf = reinterpret_cast<const char *>(_sr->data());
+  const uint64_t len = _sr->size();
+  uint64_t pos = _sr->tell();
 
-    // printf("sws c = %c\n", c);
+  while ((pos < len) && (buf[pos] != '\0')) {
+    char c = buf[pos++];
 
     if ((c == ' ') || (c == '\t') || (c == '\f')) {
       _curr_cursor.col++;
@@ -2162,36 +2165,20 @@ bool AsciiParser::SkipWhitespaceAndNewline(const bool allow_semicolon) {
       // continue
     } else if (c == '\r') {
       // CRLF?
-      if (_sr->tell() < (_sr->size() - 1)) {
-        char d;
-        if (!Char1(&d)) {
-          // this should not happen.
-          return false;
-        }
-
-        if (d == '\n') {
-          // CRLF
-        } else {
-          // unwind 1 char
-          if (!_sr->seek_from_current(-1)) {
-            // this should not happen.
-            return false;
-          }
-        }
+      if ((pos < (len - 1)) && (buf[pos] == '\n')) {
+        pos++;
       }
       _curr_cursor.col = 0;
       _curr_cursor.row++;
       // continue
     } else {
       // end loop
-      if (!_sr->seek_from_current(-1)) {
-        return false;
-      }
+      pos--;
       break;
     }
   }
 
-  return true;
+  return _sr->seek_set(pos);
 }
 
 bool AsciiParser::SkipCommentAndWhitespaceAndNewline(
@@ -2792,6 +2779,17 @@ bool AsciiParser::ParseMetaValue(const VariableDef &def, MetaVariable *outvar) {
 }
 
 bool AsciiParser::LexFloat(std::string *result) {
+  const char *s{nullptr};
+  const char *e{nullptr};
+  if (!LexFloat(&s, &e)) {
+    return false;
+  }
+
+  result->assign(s, e);
+  return true;
+}
+
+bool AsciiParser::LexFloat(const char **begin, const char **end) {
   // FLOATVAL : ('+' or '-')? FLOAT
   // FLOAT
   //     :   ('0'..'9')+ '.' ('0'..'9')* EXPONENT?
@@ -2799,100 +2797,84 @@ bool AsciiParser::LexFloat(std::string *result) {
   //     |   ('0'..'9')+ EXPONENT
   //     ;
   // EXPONENT : ('e'|'E') ('+'|'-')? ('0'..'9')+ ;
+  //
+  // Scan the input buffer directly. `pos` is the read position and `tok_end`
+  // is the end of the literal.
 
-  std::stringstream ss;
+  const char *buf = reinterpret_cast<const char *>(_sr->data());
+  const uint64_t len = _sr->size();
+  const uint64_t start = _sr->tell();
+  uint64_t pos = start;
+
+  // end of buffer, or nullchar('\0')
+  auto eof = [&](uint64_t i) { return (i >= len) || (buf[i] == '\0'); };
+  auto is_digit = [](char c) { return (c >= '0') && (c <= '9'); };
+
+  // Move the cursor to `pos` and update the column.
+  auto advance = [&]() {
+    _sr->seek_set(pos);
+    _curr_cursor.col += int(pos - start);
+  };
+
+  if (pos >= len) {
+    return false;
+  }
 
-  bool has_sign{false};
   bool leading_decimal_dots{false};
   {
-    char sc;
-    if (!Char1(&sc)) {
-      return false;
-    }
-    _curr_cursor.col++;
+    char sc = buf[pos++];
 
     // sign, '.' or [0-9]
     if ((sc == '+') || (sc == '-')) {
-      ss << sc;
-      has_sign = true;
-
-      char c;
-      if (!Char1(&c)) {
+      if (pos >= len) {
+        advance();
         return false;
       }
 
-      if (c == '.') {
+      if (buf[pos] == '.') {
         // ok. something like `+.7`, `-.53`
         leading_decimal_dots = true;
-        _curr_cursor.col++;
-        ss << c;
-
-      } else {
-        // unwind and continue
-        _sr->seek_from_current(-1);
+        pos++;
       }
-
-    } else if ((sc >= '0') && (sc <= '9')) {
+    } else if (is_digit(sc)) {
       // ok
-      ss << sc;
     } else if (sc == '.') {
       // ok but rescan again in 2.
       leading_decimal_dots = true;
-      if (!Rewind(1)) {
-        return false;
-      }
-      _curr_cursor.col--;
+      pos--;
     } else {
+      advance();
       PUSH_ERROR_AND_RETURN("Sign or `.` or 0-9 expected.");
     }
   }
 
-  (void)has_sign;
-
   // 1. Read the integer part
-  char curr;
   if (!leading_decimal_dots) {
-    // std::cout << "1 read int part: ss = " << ss.str() << "\n";
-
-    while (!Eof()) {
-      if (!Char1(&curr)) {
-        return false;
-      }
-
-      // std::cout << "1 curr = " << curr << "\n";
-      if ((curr >= '0') && (curr <= '9')) {
-        // continue
-        ss << curr;
-      } else {
-        _sr->seek_from_current(-1);
-        break;
-      }
+    while (!eof(pos) && is_digit(buf[pos])) {
+      pos++;
     }
   }
 
-  if (Eof()) {
-    (*result) = ss.str();
-    return true;
-  }
+  uint64_t tok_end = pos;
 
-  if (!Char1(&curr)) {
-    return false;
+  if (eof(pos)) {
+    advance();
+    (*begin) = buf + start;
+    (*end) = buf + tok_end;
+    return true;
   }
 
-  // std::cout << "before 2: ss = " << ss.str() << ", curr = " << curr <<
-  // "\n";
+  char curr = buf[pos++];
 
   // 2. Read the decimal part
   if (curr == '.') {
-    ss << curr;
+    tok_end = pos;
 
-    while (!Eof()) {
-      if (!Char1(&curr)) {
-        return false;
-      }
+    while (!eof(pos)) {
+      curr = buf[pos++];
 
-      if ((curr >= '0') && (curr <= '9')) {
-        ss << curr;
+      if (is_digit(curr)) {
+        tok_end = pos;
       } else {
         break;
       }
@@ -2902,66 +2884,69 @@ bool AsciiParser::LexFloat(std::string *result) {
     // go to 3.
   } else {
     // end
-    (*result) = ss.str();
-    _sr->seek_from_current(-1);
+    pos--;
+    advance();
+    (*begin) = buf + start;
+    (*end) = buf + tok_end;
     return true;
   }
 
-  if (Eof()) {
-    (*result) = ss.str();
+  if (eof(pos)) {
+    advance();
+    (*begin) = buf + start;
+    (*end) = buf + tok_end;
     return true;
   }
 
   // 3. Read the exponent part
-  bool has_exp_sign{false};
   if ((curr == 'e') || (curr == 'E')) {
-    ss << curr;
-
-    if (!Char1(&curr)) {
+    if (pos >= len) {
+      advance();
       return false;
     }
 
+    bool has_exp_sign{false};
+    curr = buf[pos++];
+
     if ((curr == '+') || (curr == '-')) {
       // exp sign
-      ss << curr;
       has_exp_sign = true;
-
-    } else if ((curr >= '0') && (curr <= '9')) {
+    } else if (is_digit(curr)) {
       // ok
-      ss << curr;
     } else {
+      advance();
       // Empty E is not allowed.
       PUSH_ERROR_AND_RETURN("Empty `E' is not allowed.");
     }
 
-    while (!Eof()) {
-      if (!Char1(&curr)) {
-        return false;
-      }
+    while (!eof(pos)) {
+      curr = buf[pos];
 
-      if ((curr >= '0') && (curr <= '9')) {
+      if (is_digit(curr)) {
         // ok
-        ss << curr;
-
       } else if ((curr == '+') || (curr == '-')) {
         if (has_exp_sign) {
+          pos++;
+          advance();
           // No multiple sign characters
           PUSH_ERROR_AND_RETURN("No multiple exponential sign characters.");
         }
 
-        ss << curr;
         has_exp_sign = true;
       } else {
         // end
-        _sr->seek_from_current(-1);
         break;
       }
+      pos++;
     }
+    tok_end = pos;
   } else {
-    _sr->seek_from_current(-1);
+    pos--;
   }
 
-  (*result) = ss.str();
+  advance();
+  (*begin) = buf + start;
+  (*end) = buf + tok_end;
   return true;
 }
 
@@ -5096,6 +5081,15 @@ bool AsciiParser::ParseBlock(const Specifier spec, const int64_t primIdx,
 ///
 bool AsciiParser::Parse(const uint32_t load_states,
                         const AsciiParserOption &parser_option) {
+  if (!ParseHeaderAndStageMetas(load_states, parser_option)) {
+    return false;
+  }
+
+  return ParseToplevelBlocks(load_states, parser_option);
+}
+
+bool AsciiParser::ParseHeaderAndStageMetas(
+    const uint32_t load_states, const AsciiParserOption &parser_option) {
   _toplevel = (load_states & static_cast<uint32_t>(LoadState::Toplevel));
   _sub_layered = (load_states & static_cast<uint32_t>(LoadState::Sublayer));
   _referenced = (load_states & static_cast<uint32_t>(LoadState::Reference));
@@ -5139,6 +5133,17 @@ bool AsciiParser::Parse(const uint32_t load_states,
     PUSH_WARN("Stage metadata processing callback is not set.");
   }
 
+  return true;
+}
+
+bool AsciiParser::ParseToplevelBlocks(const uint32_t load_states,
+                                      const AsciiParserOption &parser_option) {
+  _toplevel = (load_states & static_cast<uint32_t>(LoadState::Toplevel));
+  _sub_layered = (load_states & static_cast<uint32_t>(LoadState::Sublayer));
+  _referenced = (load_states & static_cast<uint32_t>(LoadState::Reference));
+  _payloaded = (load_states & static_cast<uint32_t>(LoadState::Payload));
+  _option = parser_option;
+
   PushPrimPath("/");
 
   // parse blocks
@@ -5189,6 +5194,164 @@ bool AsciiParser::Parse(const uint32_t load_states,
   return true;
 }
 
+bool AsciiParser::FindToplevelBlocks(
+    std::vector<std::pair<uint64_t, uint64_t>> *ranges) {
+  if (!ranges) {
+    return false;
+  }
+
+  ranges->clear();
+
+  const char *buf = reinterpret_cast<const char *>(_sr->data());
+  const uint64_t len = _sr->size();
+  uint64_t pos = _sr->tell();
+
+  auto match = [&](uint64_t i, const char *s) {
+    const uint64_t n = strlen(s);
+    return ((i + n) <= len) && (memcmp(buf + i, s, n) == 0);
+  };
+
+  auto is_space = [](char c) {
+    return (c == ' ') || (c == '\t') || (c == '\f') || (c == '\n') ||
+           (c == '\r');
+  };
+
+  // Skip comment, string literal, asset path or Path which starts at `pos`.
+  // Returns false when the literal is not terminated.
+  auto skip_literal = [&]() -> bool {
+    const char c = buf[pos];
+
+    if (c == '#') {
+      while ((pos < len) && (buf[pos] != '\n') && (buf[pos] != '\r')) {
+        pos++;
+      }
+      return true;
+    }
+
+    if ((c == '"') || (c == '\'') || (c == '@')) {
+      // Triple-quoted string or `@@@` asset path can contain newlines.
+      const char delim[4] = {c, c, c, '\0'};
+      const bool triple = match(pos, delim);
+      pos += triple ? 3 : 1;
+
+      // No escape character in single `@` asset path.
+      const bool has_escape = (c != '@') || triple;
+
+      while (pos < len) {
+        if (has_escape && (buf[pos] == '\\')) {
+          pos += 2;
+        } else if (triple) {
+          if (match(pos, delim)) {
+            pos += 3;
+            return true;
+          }
+          pos++;
+        } else if (buf[pos] == c) {
+          pos++;
+          return true;
+        } else if ((buf[pos] == '\n') || (buf[pos] == '\r')) {
+          return false;
+        } else {
+          pos++;
+        }
+      }
+
+      return false;
+    }
+
+    // Path `<...>`
+    while (pos < len) {
+      if (buf[pos] == '>') {
+        pos++;
+        return true;
+      } else if ((buf[pos] == '\n') || (buf[pos] == '\r')) {
+        return false;
+      }
+      pos++;
+    }
+
+    return false;
+  };
+
+  while (pos < len) {
+    // Skip whitespaces, newlines, ';' and comments between blocks.
+    const char c = buf[pos];
+    if (c == '\0') {
+      break;
+    } else if (is_space(c) || (c == ';')) {
+      pos++;
+      continue;
+    } else if (c == '#') {
+      skip_literal();
+      continue;
+    }
+
+    const uint64_t begin = pos;
+    if (match(pos, "def")) {
+      pos += 3;
+    } else if (match(pos, "over")) {
+      pos += 4;
+    } else if (match(pos, "class")) {
+      pos += 5;
+    } else {
+      return false;
+    }
+
+    if ((pos >= len) || !is_space(buf[pos])) {
+      return false;
+    }
+
+    // The block ends with `}` which closes the body `{` of the Prim.
+    // `{` and `}` in Prim metas(e.g. dictionary) is enclosed by `(` and `)`.
+    int paren_depth = 0;
+    int brace_depth = 0;
+    bool closed = false;
+    while (pos < len) {
+      const char bc = buf[pos];
+      if ((bc == '#') || (bc == '"') || (bc == '\'') || (bc == '@') ||
+          (bc == '<')) {
+        if (!skip_literal()) {
+          return false;
+        }
+        continue;
+      }
+
+      pos++;
+
+      if ((bc == '(') || (bc == '[')) {
+        paren_depth++;
+      } else if ((bc == ')') || (bc == ']')) {
+        paren_depth--;
+        if (paren_depth < 0) {
+          return false;
+        }
+      } else if (bc == '{') {
+        brace_depth++;
+      } else if (bc == '}') {
+        brace_depth--;
+        if (brace_depth < 0) {
+          return false;
+        }
+
+        if ((brace_depth == 0) && (paren_depth == 0)) {
+          closed = true;
+          break;
+        }
+      } else if (bc == '\0') {
+        return false;
+      }
+    }
+
+    if (!closed) {
+      return false;
+    }
+
+    ranges->push_back(std::make_pair(begin, pos));
+  }
+
+  return true;
+}
+
 bool ParseUnregistredValue(const std::string &_typeName, const std::string &str,
                            value::Value *value, std::string *err) {
   if (!value) {
@@ -326,6 +326,35 @@ class AsciiParser {
       const uint32_t load_states = static_cast<uint32_t>(LoadState::Toplevel),
       const AsciiParserOption &parser_option = AsciiParserOption());
 
+  ///
+  /// Parse magic header and Stage metas only.
+  /// `Parse()` = `ParseHeaderAndStageMetas()` + `ParseToplevelBlocks()`
+  ///
+  bool ParseHeaderAndStageMetas(
+      const uint32_t load_states = static_cast<uint32_t>(LoadState::Toplevel),
+      const AsciiParserOption &parser_option = AsciiParserOption());
+
+  ///
+  /// Parse toplevel Prim blocks(`def`, `over` and `class`) from the current
+  /// location until EOF.
+  /// Also used to parse a chunk of toplevel blocks(no magic header and Stage
+  /// metas) found by `FindToplevelBlocks()`.
+  ///
+  bool ParseToplevelBlocks(
+      const uint32_t load_states = static_cast<uint32_t>(LoadState::Toplevel),
+      const AsciiParserOption &parser_option = AsciiParserOption());
+
+  ///
+  /// Find byte ranges [begin, end) of toplevel Prim blocks(`def`, `over` and
+  /// `class`) from the current location until EOF, without parsing its
+  /// content. Strings, asset paths, Paths and comments are skipped.
+  /// The stream location is not changed.
+  ///
+  /// @return false when the content is not a sequence of toplevel Prim
+  /// blocks(e.g. unbalanced braces).
+  ///
+  bool FindToplevelBlocks(std::vector<std::pair<uint64_t, uint64_t>> *ranges);
+
   ///
   /// Parse TimeSample value with specified array type of
   /// `type_id`(value::TypeId) (You can obrain type_id from string using
@@ -682,6 +711,12 @@ class AsciiParser {
 
   bool LexFloat(std::string *result);
 
+  ///
+  /// Lex floating point literal without allocation.
+  /// [`begin`, `end`) points to the literal in the input buffer.
+  ///
+  bool LexFloat(const char **begin, const char **end);
+
   bool Expect(char expect_c);
 
   bool ReadStringLiteral(
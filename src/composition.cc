@@ -18,6 +18,7 @@
 #include "prim-reconstruct.hh"
 #include "prim-types.hh"
 #include "str-util.hh"
+#include "thread-util.hh"
 #include "tiny-format.hh"
 #include "tinyusdz.hh"
 #include "usdGeom.hh"
@@ -59,6 +60,7 @@ RECONSTRUCT_PRIM_DECL(GeomCylinder);
 RECONSTRUCT_PRIM_DECL(GeomSphere);
 RECONSTRUCT_PRIM_DECL(GeomBasisCurves);
 RECONSTRUCT_PRIM_DECL(GeomCamera);
+RECONSTRUCT_PRIM_DECL(PointInstancer);
 RECONSTRUCT_PRIM_DECL(GeomSubset);
 RECONSTRUCT_PRIM_DECL(SphereLight);
 RECONSTRUCT_PRIM_DECL(DomeLight);
@@ -156,6 +158,49 @@ bool PropagateAssetResolverState(uint32_t depth, PrimSpec &ps,
   return true;
 }
 
+// Find a parsed Layer of `resolved_path` in `layer_cache`, or open the asset
+// when it is not cached(or `layer_cache` is nullptr). `cache_key` is filled
+// when `layer_cache` is given.
+bool OpenAssetOrFindCachedLayer(AssetResolutionResolver &resolver,
+                                const std::string &resolved_path,
+                                const std::string &asset_path,
+                                LayerCache *layer_cache,
+                                LayerCacheKey *cache_key,
+                                std::shared_ptr<const Layer> *shared_layer,
+                                Asset *asset, std::string *warn,
+                                std::string *err) {
+  bool has_cache_key{false};
+
+  if (layer_cache) {
+    cache_key->resolved_path = resolved_path;
+
+    // Use the file's size and mtime when the asset is read from a file, so
+    // that a cached Layer is found without reading the asset.
+    if (!resolver.has_asset_resolution_handler(
+            io::GetFileExtension(resolved_path)) &&
+        io::GetFileStat(resolved_path, &cache_key->size, &cache_key->mtime)) {
+      has_cache_key = true;
+      (*shared_layer) = layer_cache->find(*cache_key);
+      if (*shared_layer) {
+        return true;
+      }
+    }
+  }
+
+  if (!resolver.open_asset(resolved_path, asset_path, asset, warn, err)) {
+    return false;
+  }
+
+  if (layer_cache && !has_cache_key) {
+    cache_key->size = uint64_t(asset->size());
+    cache_key->content_hash =
+        LayerCache::ComputeContentHash(asset->data(), asset->size());
+    (*shared_layer) = layer_cache->find(*cache_key);
+  }
+
+  return true;
+}
+
 // TODO: support loading non-USD asset
 bool LoadAsset(AssetResolutionResolver &resolver,
                const std::string &current_working_path,
@@ -165,8 +210,8 @@ bool LoadAsset(AssetResolutionResolver &resolver,
                Layer *dst_layer, const PrimSpec **dst_primspec_root,
                const bool error_when_no_prims_found,
                const bool error_when_asset_not_found,
-               const bool error_when_unsupported_fileformat, std::string *warn,
-               std::string *err) {
+               const bool error_when_unsupported_fileformat,
+               LayerCache *layer_cache, std::string *warn, std::string *err) {
   if (!dst_layer) {
     PUSH_ERROR_AND_RETURN(
         "[Internal error]. `dst_layer` output arg is nullptr.");
@@ -241,8 +286,15 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     resolver.add_search_path(base_dir);
   }
 
+  // Parsed USD Layer shared through `layer_cache`.
+  std::shared_ptr<const Layer> shared_layer;
+  LayerCacheKey cache_key;
+  const bool use_cache = layer_cache && IsUSDFileFormat(asset_path);
+
   Asset asset;
-  if (!resolver.open_asset(resolved_path, asset_path, &asset, warn, err)) {
+  if (!OpenAssetOrFindCachedLayer(resolver, resolved_path, asset_path,
+                                  use_cache ? layer_cache : nullptr, &cache_key,
+                                  &shared_layer, &asset, warn, err)) {
     PUSH_ERROR_AND_RETURN(
         fmt::format("Failed to open asset `{}`.", resolved_path));
   }
@@ -286,12 +338,20 @@ bool LoadAsset(AssetResolutionResolver &resolver,
   std::string _warn;
   std::string _err;
 
-  if (IsUSDFileFormat(asset_path)) {
+  if (shared_layer) {
+    DCOUT("Use cached Layer: " << resolved_path);
+  } else if (IsUSDFileFormat(asset_path)) {
     if (!LoadLayerFromMemory(asset.data(), asset.size(), asset_path, &layer,
                              &_warn, &_err)) {
       PUSH_ERROR_AND_RETURN(
           fmt::format("Failed to open `{}` as Layer: {}", asset_path, _err));
     }
+
+    if (use_cache) {
+      // Approximate memory usage of the Layer with the asset size.
+      shared_layer = layer_cache->insert(
+          cache_key, std::make_shared<Layer>(std::move(layer)), asset.size());
+    }
   } else if (IsMtlxFileFormat(asset_path)) {
     // primPath must be '</MaterialX>'
     if (primPath.prim_part() != "/MaterialX") {
@@ -331,7 +391,10 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     }
   }
 
-  DCOUT("layer = " << print_layer(layer, 0));
+  // Cached Layer is shared, so it must not be modified.
+  const Layer &src_layer = shared_layer ? *shared_layer : layer;
+
+  DCOUT("layer = " << print_layer(src_layer, 0));
 
   // TODO: Recursively resolve `references`
 
@@ -341,7 +404,7 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     }
   }
 
-  if (layer.primspecs().empty()) {
+  if (src_layer.primspecs().empty()) {
     if (error_when_no_prims_found) {
       PUSH_ERROR_AND_RETURN(fmt::format("No prims in layer `{}`", asset_path));
     }
@@ -350,7 +413,11 @@ bool LoadAsset(AssetResolutionResolver &resolver,
       (*dst_primspec_root) = nullptr;
     }
 
-    (*dst_layer) = std::move(layer);
+    if (shared_layer) {
+      (*dst_layer) = *shared_layer;
+    } else {
+      (*dst_layer) = std::move(layer);
+    }
 
     return true;
   }
@@ -364,17 +431,17 @@ bool LoadAsset(AssetResolutionResolver &resolver,
       DCOUT("primPath = " << default_prim);
     } else {
       // Use `defaultPrim` metadatum
-      if (layer.metas().defaultPrim.valid()) {
-        default_prim = "/" + layer.metas().defaultPrim.str();
+      if (src_layer.metas().defaultPrim.valid()) {
+        default_prim = "/" + src_layer.metas().defaultPrim.str();
         DCOUT("layer.meta.defaultPrim = " << default_prim);
       } else {
         // Use the first Prim in the layer.
-        default_prim = "/" + layer.primspecs().begin()->first;
+        default_prim = "/" + src_layer.primspecs().begin()->first;
         DCOUT("layer.primspecs[0].name = " << default_prim);
       }
     }
 
-    if (!layer.find_primspec_at(Path(default_prim, ""), &src_ps, err)) {
+    if (!src_layer.find_primspec_at(Path(default_prim, ""), &src_ps, err)) {
       PUSH_ERROR_AND_RETURN(fmt::format(
           "Failed to find PrimSpec `{}` in layer `{}`(resolved path: `{}`)",
           default_prim, asset_path, resolved_path));
@@ -384,6 +451,13 @@ bool LoadAsset(AssetResolutionResolver &resolver,
       PUSH_ERROR_AND_RETURN("Internal error: PrimSpec pointer is nullptr.");
     }
 
+    if (shared_layer) {
+      // Copy only the referenced PrimSpec tree from the cached Layer.
+      PrimSpec &ps = layer.primspecs()[src_ps->name()];
+      ps = *src_ps;
+      src_ps = &ps;
+    }
+
     if (!PropagateAssetResolverState(0, *const_cast<PrimSpec *>(src_ps),
                                      resolver.current_working_path(),
                                      resolver.search_paths())) {
@@ -392,6 +466,8 @@ bool LoadAsset(AssetResolutionResolver &resolver,
     }
 
     (*dst_primspec_root) = src_ps;
+  } else if (shared_layer) {
+    layer = *shared_layer;
   }
 
   // FIXME: This may be redundant, since assetresulution state is stored in
@@ -408,6 +484,170 @@ bool LoadAsset(AssetResolutionResolver &resolver,
   return true;
 }
 
+// USD asset to be loaded before merging.
+struct PrefetchAsset {
+  std::string asset_path;
+  std::string current_working_path;
+  std::vector<std::string> search_paths;
+};
+
+void AddPrefetchAsset(const value::AssetPath &assetPath,
+                      const std::string &current_working_path,
+                      const std::vector<std::string> &search_paths,
+                      std::set<std::string> *visited,
+                      std::vector<PrefetchAsset> *assets) {
+  const std::string &asset_path = assetPath.GetAssetPath();
+  if (asset_path.empty() || !IsUSDFileFormat(asset_path)) {
+    return;
+  }
+
+  // The same asset path may be resolved differently with different search
+  // paths.
+  std::string key = asset_path + "\n" + current_working_path;
+  for (const auto &search_path : search_paths) {
+    key += "\n" + search_path;
+  }
+
+  if (!visited->insert(key).second) {
+    return;
+  }
+
+  PrefetchAsset item;
+  item.asset_path = asset_path;
+  item.current_working_path = current_working_path;
+  item.search_paths = search_paths;
+  assets->emplace_back(std::move(item));
+}
+
+void CollectReferenceAssetsRec(uint32_t depth, const PrimSpec &primspec,
+                               uint32_t max_depth,
+                               std::set<std::string> *visited,
+                               std::vector<PrefetchAsset> *assets) {
+  if (depth > max_depth) {
+    return;
+  }
+
+  for (const auto &child : primspec.children()) {
+    CollectReferenceAssetsRec(depth + 1, child, max_depth, visited, assets);
+  }
+
+  if (primspec.metas().references) {
+    for (const auto &reference : primspec.metas().references.value().second) {
+      AddPrefetchAsset(reference.asset_path,
+                       primspec.get_current_working_path(),
+                       primspec.get_asset_search_paths(), visited, assets);
+    }
+  }
+}
+
+void CollectPayloadAssetsRec(uint32_t depth, const PrimSpec &primspec,
+                             uint32_t max_depth, std::set<std::string> *visited,
+                             std::vector<PrefetchAsset> *assets) {
+  if (depth > max_depth) {
+    return;
+  }
+
+  for (const auto &child : primspec.children()) {
+    CollectPayloadAssetsRec(depth + 1, child, max_depth, visited, assets);
+  }
+
+  if (primspec.metas().payload) {
+    for (const auto &pl : primspec.metas().payload.value().second) {
+      AddPrefetchAsset(pl.asset_path, primspec.get_current_working_path(),
+                       primspec.get_asset_search_paths(), visited, assets);
+    }
+  }
+}
+
+// Read and parse an asset, then add the Layer to `layer_cache`.
+bool PrefetchLayer(AssetResolutionResolver &resolver, const PrefetchAsset &item,
+                   LayerCache *layer_cache, const USDLoadOptions &load_options,
+                   std::string *warn, std::string *err) {
+  // Same resolution as LoadAsset().
+  if (item.current_working_path.size()) {
+    resolver.set_current_working_path(item.current_working_path);
+  }
+
+  if (item.search_paths.size()) {
+    resolver.set_search_paths(item.search_paths);
+  }
+
+  std::string resolved_path = resolver.resolve(item.asset_path);
+  if (resolved_path.empty()) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Failed to resolve asset path `{}`", item.asset_path));
+  }
+
+  LayerCacheKey cache_key;
+  std::shared_ptr<const Layer> shared_layer;
+  Asset asset;
+  if (!OpenAssetOrFindCachedLayer(resolver, resolved_path, item.asset_path,
+                                  layer_cache, &cache_key, &shared_layer,
+                                  &asset, warn, err)) {
+    return false;
+  }
+
+  if (shared_layer) {
+    return true;
+  }
+
+  Layer layer;
+  if (!LoadLayerFromMemory(asset.data(), asset.size(), item.asset_path, &layer,
+                           warn, err, load_options)) {
+    return false;
+  }
+
+  layer_cache->insert(cache_key, std::make_shared<Layer>(std::move(layer)),
+                      asset.size());
+
+  return true;
+}
+
+///
+/// Load and parse `assets` concurrently and add them to `layer_cache`, so that
+/// following LoadAsset() calls only merge cached Layers.
+///
+/// Assets which failed to load are not cached. They are loaded again in
+/// LoadAsset(), which reports the error, so errors are reported in the same
+/// order as serial composition. Warnings are appended in the order of
+/// `assets`.
+///
+void PrefetchLayers(const AssetResolutionResolver &resolver,
+                    const std::vector<PrefetchAsset> &assets,
+                    LayerCache *layer_cache, int num_threads,
+                    std::string *warn) {
+  if (!layer_cache || (assets.size() < 2) ||
+      (thread::GetNumThreads(num_threads) <= 1)) {
+    return;
+  }
+
+  // Assets are loaded concurrently, so parse each asset with single thread.
+  USDLoadOptions load_options;
+  load_options.num_threads = 1;
+
+  std::vector<std::string> warns(assets.size());
+
+  thread::ParallelFor(
+      0, assets.size(), num_threads, [&](size_t i, int thread_id) {
+        (void)thread_id;
+
+        // AssetResolutionResolver's state is modified while resolving.
+        AssetResolutionResolver local_resolver = resolver;
+        local_resolver.set_current_working_path(
+            resolver.current_working_path());
+
+        std::string _err;
+        PrefetchLayer(local_resolver, assets[i], layer_cache, load_options,
+                      &warns[i], &_err);
+      });
+
+  if (warn) {
+    for (const auto &w : warns) {
+      (*warn) += w;
+    }
+  }
+}
+
 bool CompositeSublayersRec(AssetResolutionResolver &resolver,
                            const Layer &in_layer,
                            std::vector<std::set<std::string>> layer_names_stack,
@@ -424,6 +664,18 @@ bool CompositeSublayersRec(AssetResolutionResolver &resolver,
   layer_names_stack.emplace_back(std::set<std::string>());
   std::set<std::string> &curr_layer_names = layer_names_stack.back();
 
+  if (options.layer_cache && (thread::GetNumThreads(options.num_threads) > 1)) {
+    std::set<std::string> visited;
+    std::vector<PrefetchAsset> assets;
+    for (const auto &layer : in_layer.metas().subLayers) {
+      AddPrefetchAsset(layer.assetPath, in_layer.get_current_working_path(),
+                       in_layer.get_asset_search_paths(), &visited, &assets);
+    }
+
+    PrefetchLayers(resolver, assets, options.layer_cache, options.num_threads,
+                   warn);
+  }
+
   for (const auto &layer : in_layer.metas().subLayers) {
     // TODO: subLayerOffset
     std::string sublayer_asset_path = layer.assetPath.GetAssetPath();
@@ -451,7 +703,8 @@ bool CompositeSublayersRec(AssetResolutionResolver &resolver,
                    &sublayer, /* primspec_root */ nullptr,
                    options.error_when_no_prims_in_sublayer,
                    options.error_when_asset_not_found,
-                   options.error_when_unsupported_fileformat, warn, err)) {
+                   options.error_when_unsupported_fileformat,
+                   options.layer_cache, warn, err)) {
       PUSH_ERROR_AND_RETURN(
           fmt::format("Load asset in subLayer failed: `{}`", layer.assetPath));
     }
@@ -517,6 +770,13 @@ bool CompositeSublayers(AssetResolutionResolver &resolver,
 
   std::vector<std::set<std::string>> layer_names_stack;
 
+  // Parsed subLayers are shared through LayerCache when loading them in
+  // parallel.
+  LayerCache local_layer_cache;
+  if (!options.layer_cache && (thread::GetNumThreads(options.num_threads) > 1)) {
+    options.layer_cache = &local_layer_cache;
+  }
+
   DCOUT("Resolve subLayers..");
   if (!CompositeSublayersRec(resolver, in_layer, layer_names_stack,
                              composited_layer, warn, err, options)) {
@@ -691,7 +951,8 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
                          reference.asset_path, reference.prim_path, &layer,
                          &src_ps, /* error_when_no_prims_found */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat,
+                         options.layer_cache, warn, err)) {
             PUSH_ERROR_AND_RETURN(
                 fmt::format("Failed to `references` asset `{}`",
                             reference.asset_path.GetAssetPath()));
@@ -753,7 +1014,8 @@ bool CompositeReferencesRec(uint32_t depth, AssetResolutionResolver &resolver,
                          reference.asset_path, reference.prim_path, &layer,
                          &src_ps, /* error_when_no_prims */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat,
+                         options.layer_cache, warn, err)) {
             PUSH_ERROR_AND_RETURN(
                 fmt::format("Failed to `references` asset `{}`",
                             reference.asset_path.GetAssetPath()));
@@ -844,7 +1106,8 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
                          pl.asset_path, pl.prim_path, &layer, &src_ps,
                          /* error_when_no_prims_found */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat,
+                         options.layer_cache, warn, err)) {
             PUSH_ERROR_AND_RETURN(fmt::format("Failed to `references` asset `{}`",
                                               pl.asset_path.GetAssetPath()));
           }
@@ -907,7 +1170,8 @@ bool CompositePayloadRec(uint32_t depth, AssetResolutionResolver &resolver,
                          pl.asset_path, pl.prim_path, &layer, &src_ps,
                          /* error_when_no_prims_found */ true,
                          options.error_when_asset_not_found,
-                         options.error_when_unsupported_fileformat, warn, err)) {
+                         options.error_when_unsupported_fileformat,
+                         options.layer_cache, warn, err)) {
             PUSH_ERROR_AND_RETURN(fmt::format("Failed to `references` asset `{}`",
                                               pl.asset_path.GetAssetPath()));
           }
@@ -1052,6 +1316,25 @@ bool CompositeReferences(AssetResolutionResolver &resolver,
 
   Layer dst = in_layer;  // deep copy
 
+  // 1. Load and parse referenced assets in parallel.
+  LayerCache local_layer_cache;
+  if (thread::GetNumThreads(options.num_threads) > 1) {
+    if (!options.layer_cache) {
+      options.layer_cache = &local_layer_cache;
+    }
+
+    std::set<std::string> visited;
+    std::vector<PrefetchAsset> assets;
+    for (const auto &item : dst.primspecs()) {
+      CollectReferenceAssetsRec(/* depth */ 0, item.second, options.max_depth,
+                                &visited, &assets);
+    }
+
+    PrefetchLayers(resolver, assets, options.layer_cache, options.num_threads,
+                   warn);
+  }
+
+  // 2. Merge referenced Layers in the PrimSpec tree order.
   for (auto &item : dst.primspecs()) {
     if (!CompositeReferencesRec(/* depth */ 0, resolver, search_paths, in_layer,
                                 item.second, warn, err, options)) {
@@ -1074,6 +1357,25 @@ bool CompositePayload(AssetResolutionResolver &resolver, const Layer &in_layer,
 
   Layer dst = in_layer;  // deep copy
 
+  // 1. Load and parse payload assets in parallel.
+  LayerCache local_layer_cache;
+  if (thread::GetNumThreads(options.num_threads) > 1) {
+    if (!options.layer_cache) {
+      options.layer_cache = &local_layer_cache;
+    }
+
+    std::set<std::string> visited;
+    std::vector<PrefetchAsset> assets;
+    for (const auto &item : dst.primspecs()) {
+      CollectPayloadAssetsRec(/* depth */ 0, item.second, options.max_depth,
+                              &visited, &assets);
+    }
+
+    PrefetchLayers(resolver, assets, options.layer_cache, options.num_threads,
+                   warn);
+  }
+
+  // 2. Merge payload Layers in the PrimSpec tree order.
   for (auto &item : dst.primspecs()) {
     if (!CompositePayloadRec(/* depth */ 0, resolver,
                              item.second.get_asset_search_paths(), in_layer, item.second,
@@ -1194,6 +1496,7 @@ static nonstd::optional<Prim> ReconstructPrimFromPrimSpec(
   RECONSTRUCT_PRIM(GeomCapsule)
   RECONSTRUCT_PRIM(GeomBasisCurves)
   RECONSTRUCT_PRIM(GeomCamera)
+  RECONSTRUCT_PRIM(PointInstancer)
   // RECONSTRUCT_PRIM(GeomSubset)
   RECONSTRUCT_PRIM(SphereLight)
   RECONSTRUCT_PRIM(DomeLight)
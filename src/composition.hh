@@ -6,6 +6,7 @@
 #pragma once
 
 #include "asset-resolution.hh"
+#include "layer-cache.hh"
 #include "prim-types.hh"
 
 // TODO
@@ -45,6 +46,15 @@ struct SublayersCompositionOptions {
 
   // File formats
   std::map<std::string, FileFormatHandler> fileformats;
+
+  // Cache of parsed USD Layers(not owned). nullptr = load an asset each time
+  // it appears.
+  LayerCache *layer_cache{nullptr};
+
+  // The number of threads to load and parse USD assets concurrently before
+  // merging them. -1 = use # of system threads. 1 = load assets one by one.
+  // AssetResolutionHandler must be thread-safe when > 1.
+  int num_threads{1};
 };
 
 struct ReferencesCompositionOptions {
@@ -59,6 +69,15 @@ struct ReferencesCompositionOptions {
 
   // File formats
   std::map<std::string, FileFormatHandler> fileformats;
+
+  // Cache of parsed USD Layers(not owned). nullptr = load an asset each time
+  // it appears.
+  LayerCache *layer_cache{nullptr};
+
+  // The number of threads to load and parse USD assets concurrently before
+  // merging them. -1 = use # of system threads. 1 = load assets one by one.
+  // AssetResolutionHandler must be thread-safe when > 1.
+  int num_threads{1};
 };
 
 struct PayloadCompositionOptions {
@@ -73,6 +92,15 @@ struct PayloadCompositionOptions {
 
   // File formats
   std::map<std::string, FileFormatHandler> fileformats;
+
+  // Cache of parsed USD Layers(not owned). nullptr = load an asset each time
+  // it appears.
+  LayerCache *layer_cache{nullptr};
+
+  // The number of threads to load and parse USD assets concurrently before
+  // merging them. -1 = use # of system threads. 1 = load assets one by one.
+  // AssetResolutionHandler must be thread-safe when > 1.
+  int num_threads{1};
 };
 
 ///
@@ -6,6 +6,8 @@
 #include <thread>
 #endif
 
+#include <cstring>
+
 #include "common-macros.inc"
 #include "crate-format.hh"
 #include "external/mapbox/eternal/include/mapbox/eternal.hpp"
@@ -345,6 +347,12 @@ std::string GetCrateDataTypeName(CrateDataTypeId did) {
   return GetCrateDataTypeName(static_cast<int32_t>(did));
 }
 
+Section::Section(char const *_name, int64_t _start, int64_t _size)
+    : start(_start), size(_size) {
+  memset(name, 0, sizeof(name));
+  strncpy(name, _name, kSectionNameMaxLength);
+}
+
 // std::string CrateValue::GetTypeName() const { return value_.type_name(); }
 // uint32_t CrateValue::GetTypeId() const { return value_.type_id(); }
 
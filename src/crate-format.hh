@@ -495,8 +495,29 @@ class CrateValue {
     return value_;
   }
 
+  value::Value &get_raw() {
+    return value_;
+  }
+
+  // Deferred(not yet unpacked) value. See `CrateReaderConfig::lazyValueUnpack`
+  void SetDeferred(const ValueRep &rep) {
+    value_ = nullptr;
+    deferred_rep_ = rep;
+    deferred_ = true;
+  }
+
+  bool is_deferred() const {
+    return deferred_;
+  }
+
+  const ValueRep &get_deferred_rep() const {
+    return deferred_rep_;
+  }
+
  private:
   value::Value value_;
+  ValueRep deferred_rep_{0};
+  bool deferred_{false};
 };
 
 // In-memory storage for a single "spec" -- prim, property, etc.
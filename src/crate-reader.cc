@@ -37,6 +37,7 @@
 #include "value-types.hh"
 #include "tiny-format.hh"
 #include "str-util.hh"
+#include "thread-util.hh"
 
 //
 #ifdef __clang__
@@ -71,13 +72,19 @@ namespace crate {
   } while(0)
 
 #define REDUCE_MEMORY_USAGE(__nbytes) do { \
-  if (_memoryUsage < (__nbytes)) { \
+  if (_memoryUsage >= (__nbytes)) { \
     _memoryUsage -= (__nbytes); \
+  } else { \
+    _memoryUsage = 0; \
   } \
   } while(0)
 
 
 
+// Decode PathIndex tree in parallel when the number of paths exceeds this
+// value.
+constexpr size_t kMinPathsForParallelDecode = 1024 * 32;
+
 #define VERSION_LESS_THAN_0_8_0(__version) ((_version[0] == 0) && (_version[1] < 7))
 
 //
@@ -107,6 +114,25 @@ CrateReader::CrateReader(StreamReader *sr, const CrateReaderConfig &config) : _s
 
 }
 
+CrateReader::CrateReader(const CrateReader &base, const StreamReader *sr,
+                         const CrateReader *tables)
+    : _sr(sr), _tables(tables), _impl(nullptr) {
+  _config = base._config;
+  memcpy(_version, base._version, sizeof(_version));
+  _toc = base._toc;
+  _toc_offset = base._toc_offset;
+  _tokens_index = base._tokens_index;
+  _paths_index = base._paths_index;
+  _strings_index = base._strings_index;
+  _fields_index = base._fields_index;
+  _fieldsets_index = base._fieldsets_index;
+  _specs_index = base._specs_index;
+
+  // Start from the memory usage of `base` so that the memory budget check
+  // accounts for already allocated data.
+  _memoryUsage = base._memoryUsage;
+}
+
 CrateReader::~CrateReader() {
   //delete _impl;
   //_impl = nullptr;
@@ -139,8 +165,9 @@ nonstd::optional<crate::Field> CrateReader::GetField(crate::Index index) const {
 
 const nonstd::optional<value::token> CrateReader::GetToken(
     crate::Index token_index) const {
-  if (token_index.value < _tokens.size()) {
-    return _tokens[token_index.value];
+  const std::vector<value::token> &tokens = tables()._tokens;
+  if (token_index.value < tokens.size()) {
+    return tokens[token_index.value];
   } else {
     return nonstd::nullopt;
   }
@@ -150,8 +177,9 @@ const nonstd::optional<value::token> CrateReader::GetToken(
 const nonstd::optional<value::token> CrateReader::GetStringToken(
     crate::Index string_index) const {
 
-  if (string_index.value < _string_indices.size()) {
-    crate::Index s_idx = _string_indices[string_index.value];
+  const std::vector<crate::Index> &string_indices = tables()._string_indices;
+  if (string_index.value < string_indices.size()) {
+    crate::Index s_idx = string_indices[string_index.value];
     return GetToken(s_idx);
   } else {
     PUSH_ERROR("String index out of range: " +
@@ -161,35 +189,40 @@ const nonstd::optional<value::token> CrateReader::GetStringToken(
 }
 
 nonstd::optional<Path> CrateReader::GetPath(crate::Index index) const {
+  const std::vector<Path> &paths = tables()._paths;
 
-  if (index.value < _paths.size()) {
+  if (index.value < paths.size()) {
     // ok
   } else {
     return nonstd::nullopt;
   }
 
-  return _paths[index.value];
+  return paths[index.value];
 }
 
 nonstd::optional<Path> CrateReader::GetElementPath(crate::Index index) const {
-  if (index.value < _elemPaths.size()) {
+  const std::vector<Path> &elemPaths = tables()._elemPaths;
+
+  if (index.value < elemPaths.size()) {
     // ok
   } else {
     return nonstd::nullopt;
   }
 
-  return _elemPaths[index.value];
+  return elemPaths[index.value];
 }
 
 nonstd::optional<std::string> CrateReader::GetPathString(
     crate::Index index) const {
-  if (index.value < _paths.size()) {
+  const std::vector<Path> &paths = tables()._paths;
+
+  if (index.value < paths.size()) {
     // ok
   } else {
     return nonstd::nullopt;
   }
 
-  const Path &p = _paths[index.value];
+  const Path &p = paths[index.value];
 
   return p.full_path_name();
 }
@@ -296,6 +329,18 @@ bool CrateReader::ReadValueRep(crate::ValueRep *rep) {
   return true;
 }
 
+namespace {
+
+// Grow `buf`(never shrinks) to at least `n` bytes and return its storage.
+inline char *ReserveScratch(std::vector<char> &buf, size_t n) {
+  if (buf.size() < n) {
+    buf.resize(n);
+  }
+  return buf.data();
+}
+
+}  // namespace
+
 template <class Int>
 bool CrateReader::ReadCompressedInts(Int *out,
                                      size_t num_ints) {
@@ -310,7 +355,6 @@ bool CrateReader::ReadCompressedInts(Int *out,
 
   // TODO: Read compressed data from _sr directly
   size_t compBufferSize = Compressor::GetCompressedBufferSize(num_ints);
-  CHECK_MEMORY_USAGE(compBufferSize);
 
   uint64_t compSize;
   if (!_sr->read8(&compSize)) {
@@ -332,17 +376,23 @@ bool CrateReader::ReadCompressedInts(Int *out,
     return false;
   }
 
-  std::vector<char> compBuffer;
-  compBuffer.resize(compBufferSize);
+  size_t workingSpaceSize =
+      Compressor::GetDecompressionWorkingSpaceSize(num_ints);
+  CHECK_MEMORY_USAGE(size_t(compSize) + workingSpaceSize);
+
+  // Scratch buffers are reused across calls.
+  char *compBuffer = ReserveScratch(_comp_scratch, size_t(compSize));
+  char *workingSpace = ReserveScratch(_work_scratch, workingSpaceSize);
+
   if (!_sr->read(size_t(compSize), size_t(compSize),
-                reinterpret_cast<uint8_t *>(compBuffer.data()))) {
+                reinterpret_cast<uint8_t *>(compBuffer))) {
     PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to read compressedInts.");
   }
 
   bool ret = Compressor::DecompressFromBuffer(
-      compBuffer.data(), size_t(compSize), out, num_ints, &_err);
+      compBuffer, size_t(compSize), out, num_ints, &_err, workingSpace);
 
-  REDUCE_MEMORY_USAGE(compBufferSize);
+  REDUCE_MEMORY_USAGE(size_t(compSize) + workingSpaceSize);
 
   return ret;
 }
@@ -863,6 +913,8 @@ bool CrateReader::ReadTimeSamples(value::TimeSamples *d) {
     PUSH_ERROR_AND_RETURN_TAG(kTag, "# of `times` elements and # of values in Crate differs.");
   }
 
+  d->reserve(size_t(num_values));
+
   for (size_t i = 0; i < num_values; i++) {
 
     crate::ValueRep rep;
@@ -872,15 +924,22 @@ bool CrateReader::ReadTimeSamples(value::TimeSamples *d) {
 
     auto next_vrep_loc = _sr->tell();
 
-    ///
-    /// Type check of the content of `value` will be done at ReconstructPrim() in usdc-reader.cc.
-    ///
-    crate::CrateValue value;
-    if (!UnpackValueRep(rep, &value)) {
-      PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to unpack value of TimeSample's value element.");
+    bool handled{false};
+    if (!ReadPODTimeSampleValue(rep, times[i], d, &handled)) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to read value of TimeSample's value element.");
     }
 
-    d->add_sample(times[i], value.get_raw());
+    if (!handled) {
+      ///
+      /// Type check of the content of `value` will be done at ReconstructPrim() in usdc-reader.cc.
+      ///
+      crate::CrateValue value;
+      if (!UnpackValueRep(rep, &value)) {
+        PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to unpack value of TimeSample's value element.");
+      }
+
+      d->add_sample(times[i], value.get_raw());
+    }
 
     // UnpackValueRep() will change StreamReader's read position.
     // Revert to next ValueRep location here.
@@ -898,6 +957,125 @@ bool CrateReader::ReadTimeSamples(value::TimeSamples *d) {
   return true;
 }
 
+template <typename T>
+bool CrateReader::ReadPODTimeSampleValue(const crate::ValueRep &rep, double t,
+                                         value::TimeSamples *d,
+                                         bool *handled) {
+  (*handled) = false;
+
+  if (!rep.IsArray()) {
+    uint8_t *dst = d->alloc_pod_sample<T>(t, /* array */ false, 1);
+    if (!dst) {
+      return true;
+    }
+    (*handled) = true;
+
+    CHECK_MEMORY_USAGE(sizeof(T));
+
+    if (!_sr->seek_set(rep.GetPayload())) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, "Invalid offset.");
+    }
+    if (!_sr->read(sizeof(T), sizeof(T), dst)) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, fmt::format("Failed to read `{}` value.", value::TypeTraits<T>::type_name()));
+    }
+
+    return true;
+  }
+
+  uint64_t n{0};
+  if (rep.GetPayload() != 0) { // 0 = empty array
+    if (!_sr->seek_set(rep.GetPayload())) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, "Invalid offset.");
+    }
+
+    if (VERSION_LESS_THAN_0_8_0(_version)) {
+      uint32_t shapesize; // not used
+      if (!_sr->read4(&shapesize)) {
+        PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to read the number of array elements.");
+      }
+      uint32_t _n;
+      if (!_sr->read4(&_n)) {
+        PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to read the number of array elements.");
+      }
+      n = _n;
+    } else {
+      if (!_sr->read8(&n)) {
+        PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to read the number of array elements.");
+      }
+    }
+
+    if (n > _config.maxArrayElements) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, fmt::format("Array size {} too large. maxArrayElements is set to {}. Please increase maxArrayElements in CrateReaderConfig.", n, _config.maxArrayElements));
+    }
+  }
+
+  uint8_t *dst = d->alloc_pod_sample<T>(t, /* array */ true, size_t(n));
+  if (!dst) {
+    return true;
+  }
+  (*handled) = true;
+
+  if (n == 0) {
+    return true;
+  }
+
+  CHECK_MEMORY_USAGE(size_t(n) * sizeof(T));
+
+  if (!_sr->read(size_t(n) * sizeof(T), size_t(n) * sizeof(T), dst)) {
+    PUSH_ERROR_AND_RETURN_TAG(kTag, fmt::format("Failed to read `{}[]` value.", value::TypeTraits<T>::type_name()));
+  }
+
+  return true;
+}
+
+bool CrateReader::ReadPODTimeSampleValue(const crate::ValueRep &rep, double t,
+                                         value::TimeSamples *d,
+                                         bool *handled) {
+  (*handled) = false;
+
+  // Inlined values are small, and compressed arrays need decompression.
+  if (rep.IsInlined() || rep.IsCompressed()) {
+    return true;
+  }
+
+  auto tyRet = crate::GetCrateDataType(rep.GetType());
+  if (!tyRet) {
+    return true;
+  }
+
+#define READ_POD_TIMESAMPLE(__dtype_id, __ty)                \
+  case crate::CrateDataTypeId::__dtype_id: {                 \
+    return ReadPODTimeSampleValue<__ty>(rep, t, d, handled); \
+  }
+
+  switch (tyRet.value().dtype_id) {
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_MATRIX2D, value::matrix2d)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_MATRIX3D, value::matrix3d)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_MATRIX4D, value::matrix4d)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_QUATD, value::quatd)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_QUATF, value::quatf)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_QUATH, value::quath)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC2D, value::double2)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC2F, value::float2)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC2H, value::half2)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC2I, value::int2)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC3D, value::double3)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC3F, value::float3)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC3H, value::half3)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC3I, value::int3)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC4D, value::double4)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC4F, value::float4)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC4H, value::half4)
+    READ_POD_TIMESAMPLE(CRATE_DATA_TYPE_VEC4I, value::int4)
+    default:
+      break;
+  }
+
+#undef READ_POD_TIMESAMPLE
+
+  return true;
+}
+
 bool CrateReader::ReadStringArray(std::vector<std::string> *d) {
   // array data is not compressed
   auto ReadFn = [this](std::vector<std::string> &result) -> bool {
@@ -1578,7 +1756,7 @@ bool CrateReader::ReadArray(std::vector<T> *d) {
   CHECK_MEMORY_USAGE(sizeof(T) * size_t(n));
 
   d->resize(size_t(n));
-  if (_sr->read(sizeof(T) * n, sizeof(T) * size_t(n), reinterpret_cast<uint8_t *>(d->data()))) {
+  if (!_sr->read(sizeof(T) * n, sizeof(T) * size_t(n), reinterpret_cast<uint8_t *>(d->data()))) {
     return false;
   }
 
@@ -2315,6 +2493,7 @@ bool CrateReader::UnpackValueRep(const crate::ValueRep &rep,
   auto tyRet = crate::GetCrateDataType(rep.GetType());
   if (!tyRet) {
     PUSH_ERROR(tyRet.error());
+    return false;
   }
 
   const auto dty = tyRet.value();
@@ -2546,6 +2725,11 @@ bool CrateReader::UnpackValueRep(const crate::ValueRep &rep,
       COMPRESS_UNSUPPORTED_CHECK(dty)
 
       if (rep.IsArray()) {
+        if (rep.GetPayload() == 0) { // empty array
+          value->Set(std::vector<std::string>());
+          return true;
+        }
+
         uint64_t n;
         if (!_sr->read8(&n)) {
           PUSH_ERROR("Failed to read the number of array elements.");
@@ -2865,7 +3049,7 @@ bool CrateReader::UnpackValueRep(const crate::ValueRep &rep,
 
         CHECK_MEMORY_USAGE(sizeof(value::matrix2d));
 
-        value::matrix4d v;
+        value::matrix2d v;
         if (!_sr->read(sizeof(value::matrix2d), sizeof(value::matrix2d),
                        reinterpret_cast<uint8_t *>(v.m))) {
           _err += "Failed to read value of `matrix2d` type\n";
@@ -5139,6 +5323,225 @@ bool CrateReader::BuildNodeHierarchy(
 }
 #endif
 
+bool CrateReader::BuildPathsAndNodeHierarchyParallel(
+    std::vector<uint32_t> const &pathIndexes,
+    std::vector<int32_t> const &elementTokenIndexes,
+    std::vector<int32_t> const &jumps, int num_threads) {
+
+  const size_t n = pathIndexes.size();
+  if ((n == 0) || (elementTokenIndexes.size() != n) || (jumps.size() != n)) {
+    return false;
+  }
+
+  //
+  // 1. Resolve the parent of each encoded path by traversing `jumps` in
+  //    pre-order. All validity checks(index range, circular referencing
+  //    through `visit_table`, ...) are done here, so following phases can
+  //    run without any locks.
+  //
+  //    jumps[i] = -2 : leaf, no sibling
+  //    jumps[i] = -1 : child(i + 1) only
+  //    jumps[i] =  0 : sibling(i + 1) only
+  //    jumps[i] >  0 : child(i + 1) and sibling(i + jumps[i])
+  //
+  std::vector<int64_t> parents(n, -2);  // -1 = root
+  {
+    std::vector<bool> visit_table(_paths.size(), false);
+
+    // (encoded index, parent encoded index)
+    std::vector<std::pair<size_t, int64_t>> stack;
+    stack.emplace_back(0, -1);
+
+    size_t nvisited = 0;
+    while (!stack.empty()) {
+      size_t i = stack.back().first;
+      int64_t parent = stack.back().second;
+      stack.pop_back();
+
+      // Must be visited in pre-order, so that a subtree occupies a contiguous
+      // index range.
+      if (i != nvisited) {
+        return false;
+      }
+
+      size_t pathIdx = pathIndexes[i];
+      if ((pathIdx >= _paths.size()) || (pathIdx >= _elemPaths.size()) ||
+          (pathIdx >= _nodes.size())) {
+        return false;
+      }
+
+      if (visit_table[pathIdx]) {
+        return false;
+      }
+      visit_table[pathIdx] = true;
+
+      if (parent >= 0) {
+        int32_t _tokenIndex = elementTokenIndexes[i];
+        uint32_t tokenIndex =
+            uint32_t(_tokenIndex < 0 ? -_tokenIndex : _tokenIndex);
+        if (tokenIndex >= _tokens.size()) {
+          return false;
+        }
+      }
+
+      parents[i] = parent;
+      nvisited++;
+
+      bool hasChild = (jumps[i] > 0) || (jumps[i] == -1);
+      bool hasSibling = (jumps[i] >= 0);
+
+      if (hasSibling) {
+        if (parent == -1) {
+          // Multiple root nodes.
+          return false;
+        }
+        size_t siblingIndex = hasChild ? i + size_t(jumps[i]) : i + 1;
+        if (siblingIndex >= n) {
+          return false;
+        }
+        stack.emplace_back(siblingIndex, parent);
+      }
+
+      if (hasChild) {
+        if ((i + 1) >= n) {
+          return false;
+        }
+        stack.emplace_back(i + 1, int64_t(i));
+      }
+    }
+
+    if (nvisited != n) {
+      return false;
+    }
+  }
+
+  // Subtree of i = [i, ends[i])
+  std::vector<size_t> ends(n);
+  for (size_t i = 0; i < n; i++) {
+    ends[i] = i + 1;
+  }
+  for (size_t i = n - 1; i > 0; i--) {
+    size_t p = size_t(parents[i]);
+    ends[p] = (std::max)(ends[p], ends[i]);
+  }
+
+  //
+  // 2. Split the tree into sibling subtrees.
+  //    Nodes of a split subtree(`top_nodes`) are decoded serially, and the
+  //    remaining subtrees(`tasks`) are decoded on worker threads.
+  //    Tasks are dispatched largest first for better load balancing.
+  //
+  const size_t kMinTaskSize = 1024;
+  const size_t threshold =
+      (std::max)(kMinTaskSize, n / (size_t(num_threads) * 8));
+
+  std::vector<size_t> top_nodes;  // parent always comes before its children
+  std::vector<size_t> tasks;
+  {
+    std::vector<size_t> queue;
+    queue.push_back(0);
+    for (size_t q = 0; q < queue.size(); q++) {
+      size_t t = queue[q];
+      if ((ends[t] - t) > threshold) {
+        top_nodes.push_back(t);
+        for (size_t c = t + 1; c < ends[t]; c = ends[c]) {
+          queue.push_back(c);
+        }
+      } else {
+        tasks.push_back(t);
+      }
+    }
+
+    std::stable_sort(tasks.begin(), tasks.end(),
+                     [&ends](const size_t a, const size_t b) {
+                       return (ends[a] - a) > (ends[b] - b);
+                     });
+  }
+
+  auto build_path = [&](size_t i) {
+    size_t idx = pathIndexes[i];
+    if (parents[i] == -1) {
+      _paths[idx] = Path::make_root_path();
+      return;
+    }
+
+    const Path &parentPath = _paths[pathIndexes[size_t(parents[i])]];
+
+    int32_t _tokenIndex = elementTokenIndexes[i];
+    bool isPrimPropertyPath = _tokenIndex < 0;
+    uint32_t tokenIndex =
+        uint32_t(isPrimPropertyPath ? -_tokenIndex : _tokenIndex);
+    auto const &elemToken = _tokens[size_t(tokenIndex)];
+
+    _paths[idx] = isPrimPropertyPath
+                      ? parentPath.AppendProperty(elemToken.str())
+                      : parentPath.AppendElement(elemToken.str());
+    _elemPaths[idx] = Path(elemToken.str(), "");
+  };
+
+  // Node index of the parent is an encoded index(not a path index), as done
+  // in BuildNodeHierarchy.
+  auto build_node = [&](size_t i) {
+    size_t pathIdx = pathIndexes[i];
+    _nodes[pathIdx] = Node(parents[i], _paths[pathIdx]);
+  };
+
+  auto add_child = [&](size_t i) -> bool {
+    size_t pathIdx = pathIndexes[i];
+    std::string name = _elemPaths[pathIdx].full_path_name();
+    return _nodes[pathIndexes[size_t(parents[i])]].AddChildren(name, pathIdx);
+  };
+
+  //
+  // 3. Paths.
+  //
+  for (size_t t : top_nodes) {
+    build_path(t);
+  }
+
+  thread::ParallelFor(0, tasks.size(), num_threads, [&](size_t k, int) {
+    for (size_t i = tasks[k]; i < ends[tasks[k]]; i++) {
+      build_path(i);
+    }
+  });
+
+  //
+  // 4. Node hierarchy.
+  //    Children of a node are added by the thread owning that node, in
+  //    ascending index order, so `Node::GetChildren()` is identical to the
+  //    serial decoder.
+  //
+  for (size_t t : top_nodes) {
+    build_node(t);
+    for (size_t c = t + 1; c < ends[t]; c = ends[c]) {
+      if (!add_child(c)) {
+        return false;
+      }
+    }
+  }
+
+  std::vector<uint8_t> task_ok(tasks.size(), 0);
+  thread::ParallelFor(0, tasks.size(), num_threads, [&](size_t k, int) {
+    size_t r = tasks[k];
+    build_node(r);
+    for (size_t i = r + 1; i < ends[r]; i++) {
+      build_node(i);
+      if (!add_child(i)) {
+        return;
+      }
+    }
+    task_ok[k] = 1;
+  });
+
+  for (size_t k = 0; k < tasks.size(); k++) {
+    if (!task_ok[k]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
   std::vector<uint32_t> pathIndexes;
   std::vector<int32_t> elementTokenIndexes;
@@ -5174,9 +5577,9 @@ bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
   CHECK_MEMORY_USAGE(compBufferSize);
   CHECK_MEMORY_USAGE(workspaceBufferSize);
 
-  // Create temporary space for decompressing.
-  std::vector<char> compBuffer(compBufferSize);
-  std::vector<char> workingSpace(workspaceBufferSize);
+  // Temporary space for decompressing. Reused across calls.
+  char *compBuffer = ReserveScratch(_comp_scratch, compBufferSize);
+  char *workingSpace = ReserveScratch(_work_scratch, workspaceBufferSize);
 
   // pathIndexes.
   {
@@ -5194,18 +5597,18 @@ bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
 
     if (compPathIndexesSize !=
         _sr->read(size_t(compPathIndexesSize), size_t(compPathIndexesSize),
-                  reinterpret_cast<uint8_t *>(compBuffer.data()))) {
+                  reinterpret_cast<uint8_t *>(compBuffer))) {
       _err += "Failed to read compressed pathIndexes data.\n";
       return false;
     }
 
-    DCOUT("comBuffer.size = " << compBuffer.size());
+    DCOUT("comBuffer.size = " << compBufferSize);
     DCOUT("compPathIndexesSize = " << compPathIndexesSize);
 
     std::string err;
     Usd_IntegerCompression::DecompressFromBuffer(
-        compBuffer.data(), size_t(compPathIndexesSize), pathIndexes.data(),
-        size_t(numEncodedPaths), &err, workingSpace.data());
+        compBuffer, size_t(compPathIndexesSize), pathIndexes.data(),
+        size_t(numEncodedPaths), &err, workingSpace);
     if (!err.empty()) {
       _err += "Failed to decode pathIndexes\n" + err;
       return false;
@@ -5229,16 +5632,16 @@ bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
     if (compElementTokenIndexesSize !=
         _sr->read(size_t(compElementTokenIndexesSize),
                   size_t(compElementTokenIndexesSize),
-                  reinterpret_cast<uint8_t *>(compBuffer.data()))) {
+                  reinterpret_cast<uint8_t *>(compBuffer))) {
       PUSH_ERROR("Failed to read elementTokenIndexes data.");
       return false;
     }
 
     std::string err;
     Usd_IntegerCompression::DecompressFromBuffer(
-        compBuffer.data(), size_t(compElementTokenIndexesSize),
+        compBuffer, size_t(compElementTokenIndexesSize),
         elementTokenIndexes.data(), size_t(numEncodedPaths), &err,
-        workingSpace.data());
+        workingSpace);
 
     if (!err.empty()) {
       PUSH_ERROR("Failed to decode elementTokenIndexes.");
@@ -5262,15 +5665,15 @@ bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
 
     if (compJumpsSize !=
         _sr->read(size_t(compJumpsSize), size_t(compJumpsSize),
-                  reinterpret_cast<uint8_t *>(compBuffer.data()))) {
+                  reinterpret_cast<uint8_t *>(compBuffer))) {
       PUSH_ERROR("Failed to read compressed jumps data.");
       return false;
     }
 
     std::string err;
     Usd_IntegerCompression::DecompressFromBuffer(
-        compBuffer.data(), size_t(compJumpsSize), jumps.data(), size_t(numEncodedPaths),
-        &err, workingSpace.data());
+        compBuffer, size_t(compJumpsSize), jumps.data(), size_t(numEncodedPaths),
+        &err, workingSpace);
 
     if (!err.empty()) {
       PUSH_ERROR("Failed to decode jumps.");
@@ -5303,6 +5706,33 @@ bool CrateReader::ReadCompressedPaths(const uint64_t maxNumPaths) {
   }
 #endif
 
+  int num_threads = thread::GetNumThreads(_config.numThreads);
+  if ((num_threads > 1) && (pathIndexes.size() >= kMinPathsForParallelDecode)) {
+    // Working buffers of the parallel decoder(`parents` and `ends`). Released
+    // whether or not the parallel decoding succeeded, so that the serial
+    // fallback starts from the same memory usage.
+    const size_t work_nbytes =
+        pathIndexes.size() * (sizeof(int64_t) + sizeof(size_t));
+    CHECK_MEMORY_USAGE(work_nbytes);
+
+    bool ret = BuildPathsAndNodeHierarchyParallel(
+        pathIndexes, elementTokenIndexes, jumps, num_threads);
+
+    REDUCE_MEMORY_USAGE(work_nbytes);
+
+    if (ret) {
+      return true;
+    }
+
+    // Could not decode the PathIndex tree in parallel(possibly corrupted
+    // data). Decode it again with the serial decoder, which reports the
+    // detailed error.
+    size_t num_paths = _paths.size();
+    _paths.assign(num_paths, Path());
+    _elemPaths.assign(num_paths, Path());
+    _nodes.assign(num_paths, Node());
+  }
+
   // For circular tree check
   std::vector<bool> visit_table;
   CHECK_MEMORY_USAGE(_paths.size()); // TODO: divide by 8?
@@ -5793,8 +6223,8 @@ bool CrateReader::ReadFieldSets() {
 
   CHECK_MEMORY_USAGE(compBufferSize);
 
-  std::vector<char> comp_buffer;
-  comp_buffer.resize(compBufferSize);
+  // Reused across calls.
+  char *comp_buffer = ReserveScratch(_comp_scratch, compBufferSize);
 
   CHECK_MEMORY_USAGE(sizeof(uint32_t) * size_t(num_fieldsets));
   std::vector<uint32_t> tmp;
@@ -5804,8 +6234,7 @@ bool CrateReader::ReadFieldSets() {
           static_cast<size_t>(num_fieldsets));
 
   CHECK_MEMORY_USAGE(workBufferSize);
-  std::vector<char> working_space;
-  working_space.resize(workBufferSize);
+  char *working_space = ReserveScratch(_work_scratch, workBufferSize);
 
   uint64_t fsets_size;
   if (!_sr->read8(&fsets_size)) {
@@ -5813,11 +6242,11 @@ bool CrateReader::ReadFieldSets() {
   }
 
   DCOUT("num_fieldsets = " << num_fieldsets << ", fsets_size = " << fsets_size
-                           << ", comp_buffer.size = " << comp_buffer.size());
+                           << ", comp_buffer.size = " << compBufferSize);
 
-  if (fsets_size > comp_buffer.size()) {
+  if (fsets_size > compBufferSize) {
     // Maybe corrupted?
-    fsets_size = comp_buffer.size();
+    fsets_size = compBufferSize;
   }
 
   if (fsets_size > _sr->size()) {
@@ -5826,14 +6255,14 @@ bool CrateReader::ReadFieldSets() {
 
   if (fsets_size !=
       _sr->read(size_t(fsets_size), size_t(fsets_size),
-                reinterpret_cast<uint8_t *>(comp_buffer.data()))) {
+                reinterpret_cast<uint8_t *>(comp_buffer))) {
     PUSH_ERROR_AND_RETURN_TAG(kTag, "Failed to read fieldsets data at `FIELDSETS` section.");
   }
 
   std::string err;
   Usd_IntegerCompression::DecompressFromBuffer(
-      comp_buffer.data(), size_t(fsets_size), tmp.data(), size_t(num_fieldsets),
-      &err, working_space.data());
+      comp_buffer, size_t(fsets_size), tmp.data(), size_t(num_fieldsets),
+      &err, working_space);
 
   if (!err.empty()) {
     _err += err;
@@ -5851,40 +6280,333 @@ bool CrateReader::ReadFieldSets() {
   return true;
 }
 
+namespace {
+
+// Returns true when the value of the field can be unpacked on demand in lazy
+// value unpacking mode.
+// Limited to large payloads(numeric arrays and TimeSamples) of attribute values,
+// which do not depend on the token/string/path tables.
+bool IsDeferrableValueRep(const std::string &field_name,
+                          const crate::ValueRep &rep) {
+  if ((field_name != "default") && (field_name != "timeSamples")) {
+    return false;
+  }
+
+  if (rep.IsInlined()) {
+    return false;
+  }
+
+  auto ty = static_cast<crate::CrateDataTypeId>(rep.GetType());
+
+  if (ty == crate::CrateDataTypeId::CRATE_DATA_TYPE_TIME_SAMPLES) {
+    return true;
+  }
+
+  if (!rep.IsArray()) {
+    return false;
+  }
+
+  switch (ty) {
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_BOOL:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_UCHAR:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_INT:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_UINT:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_INT64:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_UINT64:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_HALF:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_FLOAT:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_DOUBLE:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_MATRIX2D:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_MATRIX3D:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_MATRIX4D:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_QUATD:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_QUATF:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_QUATH:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC2D:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC2F:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC2H:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC2I:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC3D:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC3F:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC3H:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC3I:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC4D:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC4F:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC4H:
+    case crate::CrateDataTypeId::CRATE_DATA_TYPE_VEC4I:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+bool CrateReader::UnpackDeferredValue(const StreamReader *sr,
+                                      const crate::ValueRep &rep,
+                                      crate::CrateValue *value,
+                                      std::string *err) const {
+  if (!sr || !value) {
+    if (err) {
+      (*err) += "Invalid argument.\n";
+    }
+    return false;
+  }
+
+  // Use a temporary reader so that the cursor and the error of this reader
+  // are not modified.
+  CrateReader worker(*this, sr, &tables());
+
+  // Deferred values are unpacked one by one(possibly from multiple threads),
+  // so lend per-thread scratch buffers to the worker instead of growing new
+  // ones for each value.
+  static thread_local std::vector<char> comp_scratch;
+  static thread_local std::vector<char> work_scratch;
+  worker._comp_scratch.swap(comp_scratch);
+  worker._work_scratch.swap(work_scratch);
+
+  bool ret = worker.UnpackValueRep(rep, value);
+
+  comp_scratch.swap(worker._comp_scratch);
+  work_scratch.swap(worker._work_scratch);
+
+  if (!ret) {
+    if (err) {
+      (*err) += worker.GetError();
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool CrateReader::GetArrayDataLocation(const StreamReader *sr,
+                                       const crate::ValueRep &rep,
+                                       const uint8_t **data, uint64_t *n,
+                                       uint32_t *type_id,
+                                       size_t *element_size) const {
+  if (!sr || !sr->data() || !data || !n || !type_id || !element_size) {
+    return false;
+  }
+
+  // Elements are referenced as is, so they must not need byte swapping.
+  if (sr->swap_endian()) {
+    return false;
+  }
+
+  if (!rep.IsArray() || rep.IsInlined() || rep.IsCompressed()) {
+    return false;
+  }
+
+  auto tyRet = crate::GetCrateDataType(rep.GetType());
+  if (!tyRet) {
+    return false;
+  }
+
+#define ARRAY_ELEMENT_TYPE(__dtype_id, __ty)       \
+  case crate::CrateDataTypeId::__dtype_id: {       \
+    (*type_id) = value::TypeTraits<__ty>::type_id(); \
+    (*element_size) = sizeof(__ty);                \
+    break;                                         \
+  }
+
+  switch (tyRet.value().dtype_id) {
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_UCHAR, uint8_t)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_INT, int32_t)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_UINT, uint32_t)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_INT64, int64_t)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_UINT64, uint64_t)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_HALF, value::half)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_FLOAT, float)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_DOUBLE, double)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_MATRIX2D, value::matrix2d)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_MATRIX3D, value::matrix3d)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_MATRIX4D, value::matrix4d)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_QUATD, value::quatd)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_QUATF, value::quatf)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_QUATH, value::quath)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC2D, value::double2)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC2F, value::float2)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC2H, value::half2)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC2I, value::int2)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC3D, value::double3)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC3F, value::float3)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC3H, value::half3)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC3I, value::int3)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC4D, value::double4)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC4F, value::float4)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC4H, value::half4)
+    ARRAY_ELEMENT_TYPE(CRATE_DATA_TYPE_VEC4I, value::int4)
+    default:
+      return false;
+  }
+
+#undef ARRAY_ELEMENT_TYPE
+
+  if (rep.GetPayload() == 0) {  // empty array
+    (*data) = nullptr;
+    (*n) = 0;
+    return true;
+  }
+
+  // Use a copy so that the cursor of `sr` is not modified.
+  StreamReader reader(sr->data(), sr->size(), sr->swap_endian());
+  if (!reader.seek_set(rep.GetPayload())) {
+    return false;
+  }
+
+  uint64_t count{0};
+  if (VERSION_LESS_THAN_0_8_0(_version)) {
+    uint32_t shapesize;  // not used
+    uint32_t _n;
+    if (!reader.read4(&shapesize) || !reader.read4(&_n)) {
+      return false;
+    }
+    count = _n;
+  } else {
+    if (!reader.read8(&count)) {
+      return false;
+    }
+  }
+
+  if (count > _config.maxArrayElements) {
+    return false;
+  }
+
+  const uint64_t offset = reader.tell();
+  if ((count * uint64_t(*element_size)) > (sr->size() - offset)) {
+    return false;
+  }
+
+  (*data) = sr->data() + offset;
+  (*n) = count;
+  return true;
+}
+
+bool CrateReader::UnpackFieldSet(const crate::Index *fsBegin,
+                                 const crate::Index *fsEnd,
+                                 FieldValuePairVector *pairs) {
+  const std::vector<crate::Field> &fields = tables()._fields;
+
+  pairs->resize(size_t(fsEnd - fsBegin));
+  DCOUT("range size = " << (fsEnd - fsBegin));
+  for (size_t i = 0; fsBegin != fsEnd; ++fsBegin, ++i) {
+    if (fsBegin->value < fields.size()) {
+      // ok
+    } else {
+      PUSH_ERROR("Invalid live field set data.");
+      return false;
+    }
+
+    DCOUT("fieldIndex = " << (fsBegin->value));
+    auto const &field = fields[fsBegin->value];
+    if (auto tokv = GetToken(field.token_index)) {
+      (*pairs)[i].first = tokv.value().str();
+
+      if (_config.lazyValueUnpack &&
+          IsDeferrableValueRep((*pairs)[i].first, field.value_rep)) {
+        (*pairs)[i].second.SetDeferred(field.value_rep);
+        continue;
+      }
+
+      if (!UnpackValueRep(field.value_rep, &(*pairs)[i].second)) {
+        PUSH_ERROR("BuildLiveFieldSets: Failed to unpack ValueRep : "
+                   << field.value_rep.GetStringRepr());
+        return false;
+      }
+    } else {
+      PUSH_ERROR("Invalid token index.");
+    }
+  }
+
+  return true;
+}
+
 bool CrateReader::BuildLiveFieldSets() {
+  // Collect the range of each fieldset first. A fieldset is terminated by
+  // the separator(~0) Index.
+  std::vector<std::pair<size_t, size_t>> ranges;
   for (auto fsBegin = _fieldset_indices.begin(),
             fsEnd = std::find(fsBegin, _fieldset_indices.end(), crate::Index());
        fsBegin != _fieldset_indices.end();
        fsBegin = fsEnd + 1, fsEnd = std::find(fsBegin, _fieldset_indices.end(),
                                               crate::Index())) {
-    auto &pairs = _live_fieldsets[crate::Index(
-        uint32_t(fsBegin - _fieldset_indices.begin()))];
-
-    pairs.resize(size_t(fsEnd - fsBegin));
-    DCOUT("range size = " << (fsEnd - fsBegin));
-    // TODO(syoyo): Parallelize.
-    for (size_t i = 0; fsBegin != fsEnd; ++fsBegin, ++i) {
-      if (fsBegin->value < _fields.size()) {
-        // ok
-      } else {
-        PUSH_ERROR("Invalid live field set data.");
+    ranges.emplace_back(size_t(fsBegin - _fieldset_indices.begin()),
+                        size_t(fsEnd - _fieldset_indices.begin()));
+    if (fsEnd == _fieldset_indices.end()) {
+      break;
+    }
+  }
+
+  int num_threads = thread::GetNumThreads(_config.numThreads);
+  if ((num_threads <= 1) || (ranges.size() < 2)) {
+    for (const auto &range : ranges) {
+      auto &pairs = _live_fieldsets[crate::Index(uint32_t(range.first))];
+      if (!UnpackFieldSet(_fieldset_indices.data() + range.first,
+                          _fieldset_indices.data() + range.second, &pairs)) {
         return false;
       }
+    }
+  } else {
+    // Each worker unpacks ValueReps with its own CrateReader instance(its own
+    // read cursor, error buffer and recursion guard), looking up
+    // tokens/strings/paths through this reader's tables.
+    // Results are stored per fieldset and merged in fieldset order, so the
+    // output is identical to the serial unpack.
+    num_threads = (std::min)(num_threads, int(ranges.size()));
+
+    std::vector<StreamReader> stream_readers;
+    std::vector<std::unique_ptr<CrateReader>> workers;
+    stream_readers.reserve(size_t(num_threads));
+    workers.reserve(size_t(num_threads));
+    for (int t = 0; t < num_threads; t++) {
+      stream_readers.emplace_back(_sr->data(), _sr->size(),
+                                  _sr->swap_endian());
+    }
+    for (int t = 0; t < num_threads; t++) {
+      workers.emplace_back(
+          new CrateReader(*this, &stream_readers[size_t(t)], this));
+    }
+
+    std::vector<FieldValuePairVector> results(ranges.size());
+    std::vector<std::string> errs(ranges.size());
+    std::vector<std::string> warns(ranges.size());
+    std::vector<uint8_t> oks(ranges.size(), 0);
+
+    thread::ParallelFor(
+        0, ranges.size(), num_threads, [&](size_t i, int thread_id) {
+          CrateReader &worker = *workers[size_t(thread_id)];
+          worker._err.clear();
+          worker._warn.clear();
+          worker.unpackRecursionGuard.clear();
+
+          oks[i] = worker.UnpackFieldSet(
+                       _fieldset_indices.data() + ranges[i].first,
+                       _fieldset_indices.data() + ranges[i].second,
+                       &results[i])
+                       ? 1
+                       : 0;
+          errs[i] = worker._err;
+          warns[i] = worker._warn;
+        });
+
+    for (size_t i = 0; i < ranges.size(); i++) {
+      _warn += warns[i];
+      _err += errs[i];
+      if (!oks[i]) {
+        return false;
+      }
+      _live_fieldsets[crate::Index(uint32_t(ranges[i].first))] =
+          std::move(results[i]);
+    }
 
-      DCOUT("fieldIndex = " << (fsBegin->value));
-      auto const &field = _fields[fsBegin->value];
-      if (auto tokv = GetToken(field.token_index)) {
-        pairs[i].first = tokv.value().str();
-
-        if (!UnpackValueRep(field.value_rep, &pairs[i].second)) {
-          PUSH_ERROR("BuildLiveFieldSets: Failed to unpack ValueRep : "
-                     << field.value_rep.GetStringRepr());
-          return false;
-        }
-      } else {
-        PUSH_ERROR("Invalid token index.");
+    uint64_t nbytes = 0;
+    for (const auto &worker : workers) {
+      if (worker->_memoryUsage > _memoryUsage) {
+        nbytes += worker->_memoryUsage - _memoryUsage;
       }
     }
+    CHECK_MEMORY_USAGE(nbytes);
   }
 
   DCOUT("# of live fieldsets = " << _live_fieldsets.size());
@@ -5957,8 +6679,8 @@ bool CrateReader::ReadSpecs() {
 
   CHECK_MEMORY_USAGE(compBufferSize);
 
-  std::vector<char> comp_buffer;
-  comp_buffer.resize(compBufferSize);
+  // Reused across calls.
+  char *comp_buffer = ReserveScratch(_comp_scratch, compBufferSize);
 
   CHECK_MEMORY_USAGE(size_t(num_specs) * sizeof(uint32_t)); // tmp
 
@@ -5968,8 +6690,7 @@ bool CrateReader::ReadSpecs() {
           static_cast<size_t>(num_specs));
 
   CHECK_MEMORY_USAGE(workBufferSize);
-  std::vector<char> working_space;
-  working_space.resize(workBufferSize);
+  char *working_space = ReserveScratch(_work_scratch, workBufferSize);
 
   // path indices
   {
@@ -5979,22 +6700,22 @@ bool CrateReader::ReadSpecs() {
       return false;
     }
 
-    if (path_indexes_size > comp_buffer.size()) {
+    if (path_indexes_size > compBufferSize) {
       // Maybe corrupted?
-      path_indexes_size = comp_buffer.size();
+      path_indexes_size = compBufferSize;
     }
 
     if (path_indexes_size !=
         _sr->read(size_t(path_indexes_size), size_t(path_indexes_size),
-                  reinterpret_cast<uint8_t *>(comp_buffer.data()))) {
+                  reinterpret_cast<uint8_t *>(comp_buffer))) {
       PUSH_ERROR("Failed to read path indexes data at `SPECS` section.");
       return false;
     }
 
     std::string err;  // not used
     if (!Usd_IntegerCompression::DecompressFromBuffer(
-            comp_buffer.data(), size_t(path_indexes_size), tmp.data(),
-            size_t(num_specs), &err, working_space.data())) {
+            comp_buffer, size_t(path_indexes_size), tmp.data(),
+            size_t(num_specs), &err, working_space)) {
       PUSH_ERROR("Failed to decode pathIndexes at `SPECS` section.");
       return false;
     }
@@ -6013,22 +6734,22 @@ bool CrateReader::ReadSpecs() {
       return false;
     }
 
-    if (fset_indexes_size > comp_buffer.size()) {
+    if (fset_indexes_size > compBufferSize) {
       // Maybe corrupted?
-      fset_indexes_size = comp_buffer.size();
+      fset_indexes_size = compBufferSize;
     }
 
     if (fset_indexes_size !=
         _sr->read(size_t(fset_indexes_size), size_t(fset_indexes_size),
-                  reinterpret_cast<uint8_t *>(comp_buffer.data()))) {
+                  reinterpret_cast<uint8_t *>(comp_buffer))) {
       PUSH_ERROR("Failed to read fieldset indexes data at `SPECS` section.");
       return false;
     }
 
     std::string err;  // not used
     if (!Usd_IntegerCompression::DecompressFromBuffer(
-            comp_buffer.data(), size_t(fset_indexes_size), tmp.data(),
-            size_t(num_specs), &err, working_space.data())) {
+            comp_buffer, size_t(fset_indexes_size), tmp.data(),
+            size_t(num_specs), &err, working_space)) {
       PUSH_ERROR("Failed to decode fieldset indices at `SPECS` section.");
       return false;
     }
@@ -6047,22 +6768,22 @@ bool CrateReader::ReadSpecs() {
       return false;
     }
 
-    if (spectype_size > comp_buffer.size()) {
+    if (spectype_size > compBufferSize) {
       // Maybe corrupted?
-      spectype_size = comp_buffer.size();
+      spectype_size = compBufferSize;
     }
 
     if (spectype_size !=
         _sr->read(size_t(spectype_size), size_t(spectype_size),
-                  reinterpret_cast<uint8_t *>(comp_buffer.data()))) {
+                  reinterpret_cast<uint8_t *>(comp_buffer))) {
       PUSH_ERROR("Failed to read spectype data at `SPECS` section.");
       return false;
     }
 
     std::string err;  // not used.
     if (!Usd_IntegerCompression::DecompressFromBuffer(
-            comp_buffer.data(), size_t(spectype_size), tmp.data(),
-            size_t(num_specs), &err, working_space.data())) {
+            comp_buffer, size_t(spectype_size), tmp.data(),
+            size_t(num_specs), &err, working_space)) {
       PUSH_ERROR("Failed to decode fieldset indices at `SPECS` section.\n");
       return false;
     }
@@ -6151,6 +6872,123 @@ bool CrateReader::ReadPaths() {
   return true;
 }
 
+bool CrateReader::ReadKnownSectionsSerial() {
+  if (!ReadTokens()) {
+    return false;
+  }
+
+  if (!ReadStrings()) {
+    return false;
+  }
+
+  if (!ReadFields()) {
+    return false;
+  }
+
+  if (!ReadFieldSets()) {
+    return false;
+  }
+
+  if (!ReadPaths()) {
+    return false;
+  }
+
+  if (!ReadSpecs()) {
+    return false;
+  }
+
+  return true;
+}
+
+bool CrateReader::ReadKnownSections() {
+  int num_threads = thread::GetNumThreads(_config.numThreads);
+  if (num_threads <= 1) {
+    return ReadKnownSectionsSerial();
+  }
+
+  //
+  // Each section is stored in its own byte range, so sections can be decoded
+  // concurrently by worker readers having their own read cursor.
+  // PATHS requires TOKENS, so these two are decoded in the same task.
+  //
+  // Task | Sections
+  // -----+----------------
+  //  0   | TOKENS, PATHS
+  //  1   | STRINGS
+  //  2   | FIELDS
+  //  3   | FIELDSETS
+  //  4   | SPECS
+  //
+  constexpr size_t kNumTasks = 5;
+
+  std::vector<StreamReader> stream_readers;
+  std::vector<std::unique_ptr<CrateReader>> tasks;
+  stream_readers.reserve(kNumTasks);
+  tasks.reserve(kNumTasks);
+  for (size_t i = 0; i < kNumTasks; i++) {
+    stream_readers.emplace_back(_sr->data(), _sr->size(), _sr->swap_endian());
+  }
+  for (size_t i = 0; i < kNumTasks; i++) {
+    tasks.emplace_back(new CrateReader(*this, &stream_readers[i], nullptr));
+  }
+
+  // Result of each Read*() in serial reading order(TOKENS, STRINGS, FIELDS,
+  // FIELDSETS, PATHS, SPECS). -1 = not run.
+  int results[6] = {-1, -1, -1, -1, -1, -1};
+  // Task which reads the section.
+  const size_t section_task[6] = {0, 1, 2, 3, 0, 4};
+
+  thread::ParallelFor(0, kNumTasks, num_threads, [&](size_t i, int) {
+    CrateReader &r = *tasks[i];
+    if (i == 0) {
+      results[0] = r.ReadTokens() ? 1 : 0;
+      if (results[0]) {
+        results[4] = r.ReadPaths() ? 1 : 0;
+      }
+    } else if (i == 1) {
+      results[1] = r.ReadStrings() ? 1 : 0;
+    } else if (i == 2) {
+      results[2] = r.ReadFields() ? 1 : 0;
+    } else if (i == 3) {
+      results[3] = r.ReadFieldSets() ? 1 : 0;
+    } else if (i == 4) {
+      results[5] = r.ReadSpecs() ? 1 : 0;
+    }
+  });
+
+  // Report the failure of the first section in serial reading order so that
+  // the error is the same as ReadKnownSectionsSerial().
+  for (size_t k = 0; k < 6; k++) {
+    if (results[k] != 1) {
+      const CrateReader &r = *tasks[section_task[k]];
+      _warn += r._warn;
+      _err += r._err;
+      return false;
+    }
+  }
+
+  uint64_t nbytes = 0;
+  for (const auto &task : tasks) {
+    _warn += task->_warn;
+    _err += task->_err;
+    if (task->_memoryUsage > _memoryUsage) {
+      nbytes += task->_memoryUsage - _memoryUsage;
+    }
+  }
+  CHECK_MEMORY_USAGE(nbytes);
+
+  _tokens = std::move(tasks[0]->_tokens);
+  _paths = std::move(tasks[0]->_paths);
+  _elemPaths = std::move(tasks[0]->_elemPaths);
+  _nodes = std::move(tasks[0]->_nodes);
+  _string_indices = std::move(tasks[1]->_string_indices);
+  _fields = std::move(tasks[2]->_fields);
+  _fieldset_indices = std::move(tasks[3]->_fieldset_indices);
+  _specs = std::move(tasks[4]->_specs);
+
+  return true;
+}
+
 bool CrateReader::ReadBootStrap() {
   // parse header.
   uint8_t magic[8];
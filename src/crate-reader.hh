@@ -54,6 +54,12 @@ struct CrateReaderConfig {
   // Total memory budget for uncompressed USD data(vertices, `tokens`, ...)` in
   // [bytes].
   size_t maxMemoryBudget = std::numeric_limits<int32_t>::max();  // Default 2GB
+
+  // Do not unpack non-inlined numeric arrays and TimeSamples of `default` and
+  // `timeSamples` fields in BuildLiveFieldSets(). These values are stored as
+  // deferred CrateValue(`CrateValue::is_deferred()`) and can be unpacked
+  // later with `CrateReader::UnpackDeferredValue`.
+  bool lazyValueUnpack = false;
 };
 
 ///
@@ -170,8 +176,45 @@ class CrateReader {
   bool ReadFieldSets();
   bool ReadSpecs();
 
+  ///
+  /// Read all known sections(TOKENS, STRINGS, FIELDS, FIELDSETS, PATHS and
+  /// SPECS).
+  /// Sections which do not depend on each other are decoded concurrently when
+  /// `CrateReaderConfig::numThreads` > 1. The result(and the reported error)
+  /// is identical to calling Read*() serially.
+  ///
+  bool ReadKnownSections();
+
+  ///
+  /// Unpack ValueReps of all fieldsets into `_live_fieldsets`.
+  /// Fieldsets are unpacked in parallel when `CrateReaderConfig::numThreads` >
+  /// 1.
+  ///
   bool BuildLiveFieldSets();
 
+  ///
+  /// Unpack a deferred ValueRep(see `CrateReaderConfig::lazyValueUnpack`).
+  /// Crate data is read through `sr`, which must contain the same Crate data
+  /// as the StreamReader given to the constructor(the original StreamReader
+  /// does not need to be alive).
+  /// Can be called concurrently since the state of this CrateReader is not
+  /// modified.
+  ///
+  bool UnpackDeferredValue(const StreamReader *sr, const crate::ValueRep &rep,
+                           crate::CrateValue *value, std::string *err) const;
+
+  ///
+  /// Get the location of the elements of an uncompressed POD array ValueRep
+  /// in the Crate data of `sr`, so that the array can be referenced without
+  /// copying. `type_id` receives the type id of the element.
+  /// Returns false when the array is compressed, inlined, is not a POD array
+  /// or the Crate data is not little-endian.
+  /// Can be called concurrently.
+  ///
+  bool GetArrayDataLocation(const StreamReader *sr, const crate::ValueRep &rep,
+                            const uint8_t **data, uint64_t *n,
+                            uint32_t *type_id, size_t *element_size) const;
+
   std::string GetError();
   std::string GetWarning();
 
@@ -269,6 +312,25 @@ class CrateReader {
 
  private:
 
+  ///
+  /// Create a worker reader which shares the header state(version, TOC) of
+  /// `base` but has its own read cursor(`sr`), error/warning buffer and memory
+  /// usage counter.
+  /// When `tables` is given, token/string/path lookups refer to the tables of
+  /// `tables`(used for unpacking ValueReps concurrently).
+  ///
+  CrateReader(const CrateReader &base, const StreamReader *sr,
+              const CrateReader *tables);
+
+  // Serial version of ReadKnownSections()
+  bool ReadKnownSectionsSerial();
+
+  // Unpack fields referenced by field indices [fsBegin, fsEnd).
+  bool UnpackFieldSet(const crate::Index *fsBegin, const crate::Index *fsEnd,
+                      FieldValuePairVector *pairs);
+
+  const CrateReader &tables() const { return _tables ? *_tables : *this; }
+
 #if defined(TINYUSDZ_CRATE_USE_FOR_BASED_PATH_INDEX_DECODER)
   // To save stack usage
   struct BuildDecompressedPathsArg {
@@ -309,6 +371,18 @@ class CrateReader {
                                        // circular referencing
       size_t curIndex, int64_t parentNodeIndex);
 
+  //
+  // Multi-threaded version of BuildDecompressedPathsImpl + BuildNodeHierarchy.
+  // Sibling subtrees of the PathIndex tree are decoded on worker threads.
+  // Returns false when the tree cannot be decoded in parallel(e.g. corrupted
+  // data). Caller must then fall back to the serial decoder, which reports
+  // the error.
+  //
+  bool BuildPathsAndNodeHierarchyParallel(
+      std::vector<uint32_t> const &pathIndexes,
+      std::vector<int32_t> const &elementTokenIndexes,
+      std::vector<int32_t> const &jumps, int num_threads);
+
   bool ReadCompressedPaths(const uint64_t ref_num_paths);
 
   template <class Int>
@@ -332,6 +406,17 @@ class CrateReader {
 
   bool ReadTimeSamples(value::TimeSamples *d);
 
+  // Decode a value of TimeSamples directly into SoA storage of `d`, when the
+  // value is an uncompressed vector/quaternion/matrix type(or its array).
+  // `*handled` is set to false when the value must be read with
+  // UnpackValueRep.
+  bool ReadPODTimeSampleValue(const crate::ValueRep &rep, double t,
+                              value::TimeSamples *d, bool *handled);
+
+  template <typename T>
+  bool ReadPODTimeSampleValue(const crate::ValueRep &rep, double t,
+                              value::TimeSamples *d, bool *handled);
+
   // integral array
   template <typename T>
   bool ReadIntArray(bool is_compressed, std::vector<T> *d);
@@ -408,6 +493,9 @@ class CrateReader {
 
   const StreamReader *_sr{};
 
+  // Reader which owns token/string/path tables. nullptr = this reader.
+  const CrateReader *_tables{nullptr};
+
   void PushError(const std::string &s) const { _err += s; }
   void PushWarn(const std::string &s) const { _warn += s; }
   mutable std::string _err;
@@ -421,6 +509,12 @@ class CrateReader {
   // Approximated uncompressed memory usage(vertices, `tokens`, ...) in bytes.
   uint64_t _memoryUsage{0};
 
+  // Scratch buffers for decompressing integers(compressed data and working
+  // space of Usd_IntegerCompression). Grown on demand and reused across
+  // calls.
+  std::vector<char> _comp_scratch;
+  std::vector<char> _work_scratch;
+
   class Impl;
   Impl *_impl;
 };
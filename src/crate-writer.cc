@@ -1,21 +1,13 @@
-#include <limits>
+#include <array>
 #include <cstdint>
 #include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
 
 #include "crate-writer.hh"
-#include "value-types.hh"
-
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Weverything"
-#endif
-
-// TODO: Use std:: version for C++17
-#include "nonstd/optional.hpp"
-
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
+#include "crate-format.hh"
+#include "integerCoding.h"
 
 namespace tinyusdz {
 namespace crate {
@@ -60,8 +52,6 @@ bool Compare(const float &lhs, const float &rhs) {
   return (a.i == b.i);
 }
 
-} // namespace
-
 // IsExactlyRepresented in pxrUSD.
 template<typename Tfrom, typename Tto>
 nonstd::optional<Tto> TryExactlyRepresentable(const Tfrom &from) {
@@ -69,11 +59,8 @@ nonstd::optional<Tto> TryExactlyRepresentable(const Tfrom &from) {
   Tfrom minval = static_cast<Tfrom>(std::numeric_limits<Tto>::lowest());
   Tfrom maxval = static_cast<Tfrom>(std::numeric_limits<Tto>::max());
 
-  if (from < minval) {
-    return nonstd::nullopt;
-  }
-
-  if (from > maxval) {
+  // NOTE: Written as `!(a && b)` to reject NaN.
+  if (!((from >= minval) && (from <= maxval))) {
     return nonstd::nullopt;
   }
 
@@ -86,16 +73,233 @@ nonstd::optional<Tto> TryExactlyRepresentable(const Tfrom &from) {
   return nonstd::nullopt;
 }
 
-// NOTE `Inline` payload is 6bytes.
+// Encode each component as int8.
+template<typename T, size_t N>
+nonstd::optional<uint32_t> TryEncodeInlineVec(const std::array<T, N> &v) {
+  static_assert(N <= 4, "N must be 2, 3 or 4");
+  uint32_t dst{0};
+
+  // Check if each component of the vector can be represented by int8.
+  std::array<int8_t, N> ivec;
+  for (size_t i = 0; i < N; i++) {
+    if (auto f = TryExactlyRepresentable<T, int8_t>(v[i])) {
+      ivec[i] = f.value();
+    } else {
+      return nonstd::nullopt;
+    }
+  }
+
+  memcpy(&dst, &ivec[0], sizeof(ivec));
+  return dst;
+}
+
+// Check if a matrix is a diagonal matrix and its diagonal component can be
+// represented by int8.
+template<size_t N>
+nonstd::optional<uint32_t> TryEncodeInlineDiagMatrix(const double m[N][N]) {
+  uint32_t dst{0};
+
+  std::array<int8_t, N> diag;
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < N; j++) {
+      if (i == j) {
+        // diag
+        if (auto f = TryExactlyRepresentable<double, int8_t>(m[i][j])) {
+          diag[i] = f.value();
+        } else {
+          return nonstd::nullopt;
+        }
+      } else {
+        if (!Compare(m[i][j], 0.0)) {
+          return nonstd::nullopt;
+        }
+      }
+    }
+  }
+
+  memcpy(&dst, &diag[0], sizeof(diag));
+  return dst;
+}
+
+template<typename T>
+void AppendPOD(std::vector<uint8_t> *dst, const T &v) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+  dst->insert(dst->end(), p, p + sizeof(T));
+}
+
+void AppendBytes(std::vector<uint8_t> *dst, const void *data,
+                 const size_t nbytes) {
+  if (nbytes == 0) {
+    return;
+  }
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+  dst->insert(dst->end(), p, p + nbytes);
+}
+
+template<typename Int>
+bool CompressIntsImpl(const Int *data, const size_t n,
+                      std::vector<uint8_t> *dst, std::string *err) {
+  using Compressor =
+      typename std::conditional<sizeof(Int) == 4, Usd_IntegerCompression,
+                                Usd_IntegerCompression64>::type;
+
+  std::vector<char> buf(Compressor::GetCompressedBufferSize(n));
+
+  std::string local_err;
+  size_t sz = Compressor::CompressToBuffer(data, n, buf.data(), &local_err);
+  if ((sz == 0) || !local_err.empty()) {
+    if (err) {
+      (*err) += "Failed to compress integers. " + local_err + "\n";
+    }
+    return false;
+  }
+
+  AppendPOD(dst, uint64_t(sz));
+  AppendBytes(dst, buf.data(), sz);
+
+  return true;
+}
+
+template<typename Int>
+bool EncodeIntArrayImpl(const Int *data, const size_t n, const bool compress,
+                        std::vector<uint8_t> *dst, bool *compressed,
+                        std::string *err) {
+  AppendPOD(dst, uint64_t(n));
+
+  if (!compress || (n < kMinCompressedArraySize)) {
+    AppendBytes(dst, data, sizeof(Int) * n);
+    (*compressed) = false;
+    return true;
+  }
+
+  (*compressed) = true;
+  return CompressIntsImpl(data, n, dst, err);
+}
+
+//
+// Helper functions for floating-point array compression.
 //
-// - Inlineable value
-//   - double as float format
-//   - (u)int64 as (u)int32
-//   - vector as int8 x N (n = 2, 3 or 4)
-//   - Diagonal matrix as int8 x N  (n = 2, 3 or 4)
-//   - empty dictionary
-
-inline nonstd::optional<uint32_t> TryEncodeInline(double v) {
+bool AsExactInt(const value::half v, int32_t *dst) {
+  float f = value::half_to_float(v);
+  if (auto iv = TryExactlyRepresentable<double, int32_t>(double(f))) {
+    // Reader converts int to half through float.
+    if (value::float_to_half_full(float(iv.value())).value == v.value) {
+      (*dst) = iv.value();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AsExactInt(const float v, int32_t *dst) {
+  // float -> double is exact, so test with double to avoid overflow at
+  // float(INT32_MAX)(which is rounded to 2^31).
+  if (auto iv = TryExactlyRepresentable<double, int32_t>(double(v))) {
+    (*dst) = iv.value();
+    return true;
+  }
+  return false;
+}
+
+bool AsExactInt(const double v, int32_t *dst) {
+  if (auto iv = TryExactlyRepresentable<double, int32_t>(v)) {
+    (*dst) = iv.value();
+    return true;
+  }
+  return false;
+}
+
+uint64_t ToBits(const value::half v) { return v.value; }
+
+uint64_t ToBits(const float v) {
+  FltBit b;
+  b.f = v;
+  return b.i;
+}
+
+uint64_t ToBits(const double v) {
+  DblBit b;
+  b.f = v;
+  return b.i;
+}
+
+// Same limit with pxrUSD.
+constexpr size_t kMaxLUTSize = 1024;
+
+template<typename T>
+bool EncodeFloatArrayImpl(const T *data, const size_t n, const bool compress,
+                          std::vector<uint8_t> *dst, bool *compressed,
+                          std::string *err) {
+  AppendPOD(dst, uint64_t(n));
+
+  (*compressed) = false;
+
+  if (!compress || (n < kMinCompressedArraySize)) {
+    AppendBytes(dst, data, sizeof(T) * n);
+    return true;
+  }
+
+  // 1. Every value is an integer.
+  {
+    std::vector<int32_t> ints(n);
+    bool all_ints{true};
+    for (size_t i = 0; i < n; i++) {
+      if (!AsExactInt(data[i], &ints[i])) {
+        all_ints = false;
+        break;
+      }
+    }
+
+    if (all_ints) {
+      dst->push_back(uint8_t('i'));
+      (*compressed) = true;
+      return CompressIntsImpl(ints.data(), n, dst, err);
+    }
+  }
+
+  // 2. A few unique values. Use look-up table.
+  {
+    const size_t max_lut_size = (std::min)(kMaxLUTSize, n / 4);
+
+    std::unordered_map<uint64_t, uint32_t> bits_to_index;
+    std::vector<T> lut;
+    std::vector<uint32_t> indices(n);
+
+    bool use_lut{true};
+    for (size_t i = 0; i < n; i++) {
+      uint64_t bits = ToBits(data[i]);
+      auto it = bits_to_index.find(bits);
+      if (it != bits_to_index.end()) {
+        indices[i] = it->second;
+      } else {
+        if (lut.size() >= max_lut_size) {
+          use_lut = false;
+          break;
+        }
+        uint32_t idx = uint32_t(lut.size());
+        bits_to_index[bits] = idx;
+        lut.push_back(data[i]);
+        indices[i] = idx;
+      }
+    }
+
+    if (use_lut) {
+      dst->push_back(uint8_t('t'));
+      AppendPOD(dst, uint32_t(lut.size()));
+      AppendBytes(dst, lut.data(), sizeof(T) * lut.size());
+      (*compressed) = true;
+      return CompressIntsImpl(indices.data(), n, dst, err);
+    }
+  }
+
+  // 3. Store as is.
+  AppendBytes(dst, data, sizeof(T) * n);
+  return true;
+}
+
+} // namespace
+
+nonstd::optional<uint32_t> TryEncodeInline(const double v) {
   uint32_t dst;
 
   nonstd::optional<float> f = TryExactlyRepresentable<double, float>(v);
@@ -108,7 +312,7 @@ inline nonstd::optional<uint32_t> TryEncodeInline(double v) {
   return nonstd::nullopt;
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(uint64_t v) {
+nonstd::optional<uint32_t> TryEncodeInline(const uint64_t v) {
   uint32_t dst;
 
   nonstd::optional<uint32_t> f = TryExactlyRepresentable<uint64_t, uint32_t>(v);
@@ -121,7 +325,7 @@ inline nonstd::optional<uint32_t> TryEncodeInline(uint64_t v) {
   return nonstd::nullopt;
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(int64_t v) {
+nonstd::optional<uint32_t> TryEncodeInline(const int64_t v) {
   uint32_t dst;
 
   nonstd::optional<int32_t> f = TryExactlyRepresentable<int64_t, int32_t>(v);
@@ -134,164 +338,114 @@ inline nonstd::optional<uint32_t> TryEncodeInline(int64_t v) {
   return nonstd::nullopt;
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::vector3f v) {
-  uint32_t dst;
-
-  // Check if each component of the vector can be represented by int8.
-  std::array<int8_t, 3> ivec;
-  for (size_t i = 0; i < 3; i++) {
-    if (auto f = TryExactlyRepresentable<float, int8_t>(v[i])) {
-      ivec[i] = f.value();
-    } else {
-      return nonstd::nullopt;
-    }
-  }
+nonstd::optional<uint32_t> TryEncodeInline(const value::float2 &v) {
+  return TryEncodeInlineVec(v);
+}
 
-  memcpy(&dst, &ivec[0], sizeof(ivec));
-  return dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::float3 &v) {
+  return TryEncodeInlineVec(v);
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::vector3d v) {
-  uint32_t dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::float4 &v) {
+  return TryEncodeInlineVec(v);
+}
 
-  // Check if each component of the vector can be represented by int8.
-  std::array<int8_t, 3> ivec;
-  for (size_t i = 0; i < 3; i++) {
-    if (auto f = TryExactlyRepresentable<double, int8_t>(v[i])) {
-      ivec[i] = f.value();
-    } else {
-      return nonstd::nullopt;
-    }
-  }
+nonstd::optional<uint32_t> TryEncodeInline(const value::double2 &v) {
+  return TryEncodeInlineVec(v);
+}
 
-  memcpy(&dst, &ivec[0], sizeof(ivec));
-  return dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::double3 &v) {
+  return TryEncodeInlineVec(v);
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::color4f v) {
-  uint32_t dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::double4 &v) {
+  return TryEncodeInlineVec(v);
+}
 
-  // Check if each component of the vector can be represented by int8.
-  std::array<int8_t, 4> ivec;
-  for (size_t i = 0; i < 4; i++) {
-    if (auto f = TryExactlyRepresentable<float, int8_t>(v[i])) {
-      ivec[i] = f.value();
-    } else {
-      return nonstd::nullopt;
-    }
-  }
+nonstd::optional<uint32_t> TryEncodeInline(const value::int2 &v) {
+  return TryEncodeInlineVec(v);
+}
 
-  memcpy(&dst, &ivec[0], sizeof(ivec));
-  return dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::int3 &v) {
+  return TryEncodeInlineVec(v);
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::color4d v) {
-  uint32_t dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::int4 &v) {
+  return TryEncodeInlineVec(v);
+}
 
-  // Check if each component of the vector can be represented by int8.
-  std::array<int8_t, 4> ivec;
-  for (size_t i = 0; i < 4; i++) {
-    if (auto f = TryExactlyRepresentable<double, int8_t>(v[i])) {
-      ivec[i] = f.value();
-    } else {
-      return nonstd::nullopt;
-    }
-  }
+nonstd::optional<uint32_t> TryEncodeInline(const value::matrix2d &v) {
+  return TryEncodeInlineDiagMatrix<2>(v.m);
+}
 
-  memcpy(&dst, &ivec[0], sizeof(ivec));
-  return dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::matrix3d &v) {
+  return TryEncodeInlineDiagMatrix<3>(v.m);
 }
 
-//
-// TODO: Implement more TryEncodeInline for scalar value types
-//
+nonstd::optional<uint32_t> TryEncodeInline(const value::matrix4d &v) {
+  return TryEncodeInlineDiagMatrix<4>(v.m);
+}
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::matrix2d v) {
-  uint32_t dst;
+nonstd::optional<uint32_t> TryEncodeInline(const value::dict &v) {
+  uint32_t dst{0};
 
-  // Check if a matrix is a diagonal matrix and its diagonal component can be represented by int8.
-  std::array<int8_t, 2> diag;
-  for (size_t i = 0; i < 2; i++) {
-    for (size_t j = 0; j < 2; j++) {
-      if (i == j) {
-        // diag
-        if (auto f = TryExactlyRepresentable<double, int8_t>(v.m[i][j])) {
-          diag[i] = f.value();
-        } else {
-          return nonstd::nullopt;
-        }
-      } else {
-        if (!Compare(v.m[i][j], 0.0)) {
-          return nonstd::nullopt;
-        }
-      }
-    }
+  if (v.empty()) {
+    return dst;
   }
 
-  memcpy(&dst, &diag[0], sizeof(diag));
-  return dst;
+  return nonstd::nullopt;
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::matrix3d v) {
-  uint32_t dst;
+bool EncodeIntArray(const int32_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err) {
+  return EncodeIntArrayImpl(data, n, compress, dst, compressed, err);
+}
 
-  // Check if a matrix is a diagonal matrix and its diagonal component can be represented by int8.
-  std::array<int8_t, 3> diag;
-  for (size_t i = 0; i < 3; i++) {
-    for (size_t j = 0; j < 3; j++) {
-      if (i == j) {
-        // diag
-        if (auto f = TryExactlyRepresentable<double, int8_t>(v.m[i][j])) {
-          diag[i] = f.value();
-        } else {
-          return nonstd::nullopt;
-        }
-      } else {
-        if (!Compare(v.m[i][j], 0.0)) {
-          return nonstd::nullopt;
-        }
-      }
-    }
-  }
+bool EncodeIntArray(const uint32_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err) {
+  return EncodeIntArrayImpl(data, n, compress, dst, compressed, err);
+}
 
-  memcpy(&dst, &diag[0], sizeof(diag));
-  return dst;
+bool EncodeIntArray(const int64_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err) {
+  return EncodeIntArrayImpl(data, n, compress, dst, compressed, err);
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::matrix4d v) {
-  uint32_t dst;
+bool EncodeIntArray(const uint64_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err) {
+  return EncodeIntArrayImpl(data, n, compress, dst, compressed, err);
+}
 
-  // Check if a matrix is a diagonal matrix and its diagonal component can be represented by int8.
-  std::array<int8_t, 4> diag;
-  for (size_t i = 0; i < 4; i++) {
-    for (size_t j = 0; j < 4; j++) {
-      if (i == j) {
-        // diag
-        if (auto f = TryExactlyRepresentable<double, int8_t>(v.m[i][j])) {
-          diag[i] = f.value();
-        } else {
-          return nonstd::nullopt;
-        }
-      } else {
-        if (!Compare(v.m[i][j], 0.0)) {
-          return nonstd::nullopt;
-        }
-      }
-    }
-  }
+bool EncodeFloatArray(const value::half *data, const size_t n,
+                      const bool compress, std::vector<uint8_t> *dst,
+                      bool *compressed, std::string *err) {
+  return EncodeFloatArrayImpl(data, n, compress, dst, compressed, err);
+}
 
-  memcpy(&dst, &diag[0], sizeof(diag));
-  return dst;
+bool EncodeFloatArray(const float *data, const size_t n, const bool compress,
+                      std::vector<uint8_t> *dst, bool *compressed,
+                      std::string *err) {
+  return EncodeFloatArrayImpl(data, n, compress, dst, compressed, err);
 }
 
-inline nonstd::optional<uint32_t> TryEncodeInline(value::dict v) {
-  uint32_t dst{0};
+bool EncodeFloatArray(const double *data, const size_t n, const bool compress,
+                      std::vector<uint8_t> *dst, bool *compressed,
+                      std::string *err) {
+  return EncodeFloatArrayImpl(data, n, compress, dst, compressed, err);
+}
 
-  if (v.empty()) {
-    return dst;
-  }
+bool CompressInts(const uint32_t *data, const size_t n,
+                  std::vector<uint8_t> *dst, std::string *err) {
+  return CompressIntsImpl(data, n, dst, err);
+}
 
-  return nonstd::nullopt;
+bool CompressInts(const int32_t *data, const size_t n,
+                  std::vector<uint8_t> *dst, std::string *err) {
+  return CompressIntsImpl(data, n, dst, err);
 }
 
 } // namespace crate 
@@ -3,12 +3,117 @@
 //
 // Crate(binary) writer
 //
+// Low-level encoders for values in Crate format. USDC writer(usdc-writer.cc)
+// builds the file structure(sections, specs, ...) on top of these.
+//
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "value-types.hh"
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#endif
+
+// TODO: Use std:: version for C++17
+#include "nonstd/optional.hpp"
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
 namespace tinyusdz {
 namespace crate {
 
+// NOTE `Inline` payload is 6bytes, but we only use 4 bytes as done in pxrUSD.
+//
+// - Inlineable value
+//   - double as float format
+//   - (u)int64 as (u)int32
+//   - vector as int8 x N (n = 2, 3 or 4)
+//   - Diagonal matrix as int8 x N  (n = 2, 3 or 4)
+//   - empty dictionary
+//
+// Returns nullopt when the value cannot be inlined without loss.
+//
+nonstd::optional<uint32_t> TryEncodeInline(const double v);
+nonstd::optional<uint32_t> TryEncodeInline(const uint64_t v);
+nonstd::optional<uint32_t> TryEncodeInline(const int64_t v);
+
+nonstd::optional<uint32_t> TryEncodeInline(const value::float2 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::float3 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::float4 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::double2 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::double3 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::double4 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::int2 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::int3 &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::int4 &v);
+
+nonstd::optional<uint32_t> TryEncodeInline(const value::matrix2d &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::matrix3d &v);
+nonstd::optional<uint32_t> TryEncodeInline(const value::matrix4d &v);
+
+nonstd::optional<uint32_t> TryEncodeInline(const value::dict &v);
+
+///
+/// Encode int array in Crate format(`# of elements(uint64)` + data) and
+/// append it to `dst`.
+///
+/// When `compress` is true and the array has `kMinCompressedArraySize` or
+/// more elements, data is compressed with Usd_IntegerCompression.
+///
+/// @param[out] compressed true when data is compressed. ValueRep must have the
+/// compressed bit in this case.
+///
+bool EncodeIntArray(const int32_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err);
+bool EncodeIntArray(const uint32_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err);
+bool EncodeIntArray(const int64_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err);
+bool EncodeIntArray(const uint64_t *data, const size_t n, const bool compress,
+                    std::vector<uint8_t> *dst, bool *compressed,
+                    std::string *err);
+
+///
+/// Encode floating-point array in Crate format and append it to `dst`.
+///
+/// When `compress` is true and the array has `kMinCompressedArraySize` or
+/// more elements, data is stored as
+///
+/// - compressed ints('i') when every value is exactly representable by int32
+/// - look-up table + compressed indices('t') when the array has a few unique
+///   values
+///
+/// Otherwise data is stored as is(and `compressed` becomes false).
+///
+bool EncodeFloatArray(const value::half *data, const size_t n,
+                      const bool compress, std::vector<uint8_t> *dst,
+                      bool *compressed, std::string *err);
+bool EncodeFloatArray(const float *data, const size_t n, const bool compress,
+                      std::vector<uint8_t> *dst, bool *compressed,
+                      std::string *err);
+bool EncodeFloatArray(const double *data, const size_t n, const bool compress,
+                      std::vector<uint8_t> *dst, bool *compressed,
+                      std::string *err);
 
-} // namespace crate
-} // namespace tinyusdz
+///
+/// Compress ints with Usd_IntegerCompression and append
+/// `compressed size(uint64)` + compressed data to `dst`.
+/// Used for index tables in `FIELDS`, `FIELDSETS`, `PATHS` and `SPECS` section.
+///
+bool CompressInts(const uint32_t *data, const size_t n,
+                  std::vector<uint8_t> *dst, std::string *err);
+bool CompressInts(const int32_t *data, const size_t n,
+                  std::vector<uint8_t> *dst, std::string *err);
 
+}  // namespace crate
+}  // namespace tinyusdz
@@ -34,8 +34,31 @@
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
+// Vectorized decoding of 32-bit integers. On x86, AVX2/SSSE3 decoders are
+// compiled with the `target` attribute(`-mavx2`, `-mssse3` are not required)
+// and selected at runtime. Scalar decoder is used otherwise.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#if defined(__GNUC__) || defined(__clang__)
+#define TINYUSDZ_INTEGER_CODING_USE_AVX2
+#define TINYUSDZ_INTEGER_CODING_USE_SSSE3
+#define TINYUSDZ_INTEGER_CODING_TARGET_AVX2 __attribute__((target("avx2")))
+#define TINYUSDZ_INTEGER_CODING_TARGET_SSSE3 __attribute__((target("ssse3")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define TINYUSDZ_INTEGER_CODING_USE_AVX2
+#define TINYUSDZ_INTEGER_CODING_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+// vqtbl1q_u8 is only available on AArch64.
+#define TINYUSDZ_INTEGER_CODING_USE_NEON
+#include <arm_neon.h>
+#endif
+
 //PXR_NAMESPACE_OPEN_SCOPE
 namespace tinyusdz {
 
@@ -343,23 +366,385 @@ _EncodeIntegers(Int const *begin, size_t numInts, char *output)
     return vintsOut - output;
 }
 
+// Tables indexed by a byte of 2-bit codes(= 4 integers).
+struct _DecodeTables
+{
+    // # of bytes of the variable length integers for 32-bit/64-bit ints.
+    uint8_t vintsSize32[256];
+    uint8_t vintsSize64[256];
+
+    // pshufb/tbl masks for 32-bit ints. `gather` moves the variable length
+    // integers to the low bytes of each lane(zero filled). `signFill`
+    // replicates the sign byte of Small/Medium integers to the remaining
+    // bytes. Lanes of the most common value are all 0x80 in `gather`.
+    alignas(16) uint8_t gather[256][16];
+    alignas(16) uint8_t signFill[256][16];
+
+    _DecodeTables() {
+        const uint8_t size32[4] = {0, 1, 2, 4};
+        const uint8_t size64[4] = {0, 2, 4, 8};
+        for (int c = 0; c != 256; ++c) {
+            uint8_t offset = 0;
+            uint8_t offset64 = 0;
+            for (int i = 0; i != 4; ++i) {
+                const int code = (c >> (2 * i)) & 3;
+                const uint8_t n = size32[code];
+                for (int b = 0; b != 4; ++b) {
+                    gather[c][4 * i + b] =
+                        (b < n) ? uint8_t(offset + b) : uint8_t(0x80);
+                    signFill[c][4 * i + b] =
+                        (n > 0 && n < 4 && b >= n) ?
+                        uint8_t(4 * i + n - 1) : uint8_t(0x80);
+                }
+                offset = uint8_t(offset + n);
+                offset64 = uint8_t(offset64 + size64[code]);
+            }
+            vintsSize32[c] = offset;
+            vintsSize64[c] = offset64;
+        }
+    }
+};
+
+inline const _DecodeTables &_GetDecodeTables()
+{
+    static const _DecodeTables tables;
+    return tables;
+}
+
+// The _DecodeGroups* functions decode groups of 4 integers while the variable
+// length integers of a whole group are readable without bounds checks(16
+// bytes for 32-bit ints, 32 bytes for 64-bit ints). They return the number of
+// decoded integers and advance `codesIn`, `vintsIn`, `prevVal` and `output`.
+// Remaining integers are decoded by _DecodeNHelper with bounds checks.
+
+// Branchless decoder. Assumes little endian, as _ReadBits does.
 template <class Int>
-size_t _DecodeIntegers(char const *data, size_t numInts, Int *result)
+size_t _DecodeGroupsScalar(
+    char const *&codesIn, char const *&vintsIn, char const *vintsEnd,
+    size_t numGroups, typename std::make_signed<Int>::type commonValue,
+    typename std::make_signed<Int>::type &prevVal, Int *&output)
 {
     using SInt = typename std::make_signed<Int>::type;
+    using UInt = typename std::make_unsigned<Int>::type;
+
+    constexpr int kBits = int(sizeof(Int) * 8);
+    // Bit width for Common, Small, Medium and Large codes.
+    constexpr int kWidths[4] = {0, kBits / 4, kBits / 2, kBits};
+
+    size_t n = 0;
+    while (n < numGroups &&
+           size_t(vintsEnd - vintsIn) >= 4 * sizeof(Int)) {
+        const uint8_t codeByte = uint8_t(*codesIn++);
+        for (int i = 0; i != 4; ++i) {
+            const int code = (codeByte >> (2 * i)) & 3;
+            const int shift = (kBits - kWidths[code]) & (kBits - 1);
+            UInt raw;
+            memcpy(&raw, vintsIn, sizeof(raw));
+            // Sign extend the low `kWidths[code]` bits.
+            const SInt val = SInt(UInt(raw << shift)) >> shift;
+            prevVal = SInt(UInt(prevVal) + UInt(code ? val : commonValue));
+            *output++ = static_cast<Int>(prevVal);
+            vintsIn += kWidths[code] / 8;
+        }
+        ++n;
+    }
 
-    auto commonValue = _ReadBits<SInt>(data);
+    return n * 4;
+}
+
+#if defined(TINYUSDZ_INTEGER_CODING_USE_AVX2)
+
+inline bool _CPUSupportsAVX2()
+{
+#if defined(__AVX2__)
+    return true;
+#else
+    static const bool supported = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+#endif
+}
+
+TINYUSDZ_INTEGER_CODING_TARGET_AVX2
+inline size_t _DecodeGroups32AVX2(
+    char const *&codesIn, char const *&vintsIn, char const *vintsEnd,
+    size_t numGroups, int32_t commonValue, int32_t &prevVal, char *&output)
+{
+    const _DecodeTables &tables = _GetDecodeTables();
+
+    const __m256i common = _mm256_set1_epi32(commonValue);
+    const __m256i commonLanes = _mm256_set1_epi32(int32_t(0x80808080));
+    const __m256i lastLane = _mm256_set1_epi32(7);
+    const __m256i lowLastLane = _mm256_set1_epi32(3);
+    __m256i prev = _mm256_set1_epi32(prevVal);
+
+    size_t n = 0;
+    // 8 integers per iteration. Max 32 bytes of vints are read.
+    while ((numGroups - n) >= 2 && (vintsEnd - vintsIn) >= 32) {
+        const uint8_t c0 = uint8_t(codesIn[0]);
+        const uint8_t c1 = uint8_t(codesIn[1]);
+        const char *vints1 = vintsIn + tables.vintsSize32[c0];
+
+        const __m256i src = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(vintsIn))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(vints1)), 1);
+        const __m256i gather = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_load_si128(
+                reinterpret_cast<const __m128i *>(tables.gather[c0]))),
+            _mm_load_si128(
+                reinterpret_cast<const __m128i *>(tables.gather[c1])), 1);
+        const __m256i signFill = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_load_si128(
+                reinterpret_cast<const __m128i *>(tables.signFill[c0]))),
+            _mm_load_si128(
+                reinterpret_cast<const __m128i *>(tables.signFill[c1])), 1);
+
+        __m256i d = _mm256_shuffle_epi8(src, gather);
+        const __m256i sign = _mm256_cmpgt_epi8(_mm256_setzero_si256(), d);
+        d = _mm256_or_si256(d, _mm256_shuffle_epi8(sign, signFill));
+        d = _mm256_add_epi32(d, _mm256_and_si256(
+            _mm256_cmpeq_epi32(gather, commonLanes), common));
+
+        // Prefix sum of the deltas. Shifts are done in each 128-bit lane, so
+        // the sum of the low half is added to the high half afterwards.
+        d = _mm256_add_epi32(d, _mm256_slli_si256(d, 4));
+        d = _mm256_add_epi32(d, _mm256_slli_si256(d, 8));
+        d = _mm256_add_epi32(d, _mm256_blend_epi32(
+            _mm256_setzero_si256(),
+            _mm256_permutevar8x32_epi32(d, lowLastLane), 0xF0));
+        d = _mm256_add_epi32(d, prev);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), d);
+        prev = _mm256_permutevar8x32_epi32(d, lastLane);
+
+        vintsIn = vints1 + tables.vintsSize32[c1];
+        codesIn += 2;
+        output += 8 * sizeof(int32_t);
+        n += 2;
+    }
+
+    prevVal = _mm256_extract_epi32(prev, 0);
+    return n * 4;
+}
+
+#endif
+
+#if defined(TINYUSDZ_INTEGER_CODING_USE_SSSE3)
+
+inline bool _CPUSupportsSSSE3()
+{
+#if defined(__SSSE3__)
+    return true;
+#else
+    static const bool supported = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3") != 0;
+    }();
+    return supported;
+#endif
+}
+
+TINYUSDZ_INTEGER_CODING_TARGET_SSSE3
+inline size_t _DecodeGroups32SSSE3(
+    char const *&codesIn, char const *&vintsIn, char const *vintsEnd,
+    size_t numGroups, int32_t commonValue, int32_t &prevVal, char *&output)
+{
+    const _DecodeTables &tables = _GetDecodeTables();
+
+    const __m128i common = _mm_set1_epi32(commonValue);
+    const __m128i commonLanes = _mm_set1_epi32(int32_t(0x80808080));
+    __m128i prev = _mm_set1_epi32(prevVal);
+
+    size_t n = 0;
+    while (n < numGroups && (vintsEnd - vintsIn) >= 16) {
+        const uint8_t c = uint8_t(*codesIn);
+
+        const __m128i src =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(vintsIn));
+        const __m128i gather =
+            _mm_load_si128(reinterpret_cast<const __m128i *>(tables.gather[c]));
+        const __m128i signFill = _mm_load_si128(
+            reinterpret_cast<const __m128i *>(tables.signFill[c]));
+
+        __m128i d = _mm_shuffle_epi8(src, gather);
+        const __m128i sign = _mm_cmpgt_epi8(_mm_setzero_si128(), d);
+        d = _mm_or_si128(d, _mm_shuffle_epi8(sign, signFill));
+        d = _mm_add_epi32(d, _mm_and_si128(
+            _mm_cmpeq_epi32(gather, commonLanes), common));
+
+        // Prefix sum of the deltas.
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 4));
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+        d = _mm_add_epi32(d, prev);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output), d);
+        prev = _mm_shuffle_epi32(d, _MM_SHUFFLE(3, 3, 3, 3));
+
+        vintsIn += tables.vintsSize32[c];
+        ++codesIn;
+        output += 4 * sizeof(int32_t);
+        ++n;
+    }
+
+    prevVal = _mm_cvtsi128_si32(prev);
+    return n * 4;
+}
+
+#endif
+
+#if defined(TINYUSDZ_INTEGER_CODING_USE_NEON)
+
+inline size_t _DecodeGroups32NEON(
+    char const *&codesIn, char const *&vintsIn, char const *vintsEnd,
+    size_t numGroups, int32_t commonValue, int32_t &prevVal, char *&output)
+{
+    const _DecodeTables &tables = _GetDecodeTables();
+
+    const int32x4_t common = vdupq_n_s32(commonValue);
+    const uint32x4_t commonLanes = vdupq_n_u32(0x80808080u);
+    const int32x4_t zero = vdupq_n_s32(0);
+    int32x4_t prev = vdupq_n_s32(prevVal);
+
+    size_t n = 0;
+    while (n < numGroups && (vintsEnd - vintsIn) >= 16) {
+        const uint8_t c = uint8_t(*codesIn);
+
+        const uint8x16_t src =
+            vld1q_u8(reinterpret_cast<const uint8_t *>(vintsIn));
+        const uint8x16_t gather = vld1q_u8(tables.gather[c]);
+        const uint8x16_t signFill = vld1q_u8(tables.signFill[c]);
+
+        // Out of range indices(0x80) produce 0.
+        uint8x16_t g = vqtbl1q_u8(src, gather);
+        const uint8x16_t sign = vcltzq_s8(vreinterpretq_s8_u8(g));
+        g = vorrq_u8(g, vqtbl1q_u8(sign, signFill));
+
+        int32x4_t d = vreinterpretq_s32_u8(g);
+        d = vaddq_s32(d, vandq_s32(vreinterpretq_s32_u32(vceqq_u32(
+            vreinterpretq_u32_u8(gather), commonLanes)), common));
+
+        // Prefix sum of the deltas.
+        d = vaddq_s32(d, vextq_s32(zero, d, 3));
+        d = vaddq_s32(d, vextq_s32(zero, d, 2));
+        d = vaddq_s32(d, prev);
+
+        vst1q_s32(reinterpret_cast<int32_t *>(output), d);
+        prev = vdupq_laneq_s32(d, 3);
+
+        vintsIn += tables.vintsSize32[c];
+        ++codesIn;
+        output += 4 * sizeof(int32_t);
+        ++n;
+    }
+
+    prevVal = vgetq_lane_s32(prev, 0);
+    return n * 4;
+}
+
+#endif
+
+template <class Int>
+inline typename std::enable_if<sizeof(Int) == 4, size_t>::type
+_DecodeGroups(char const *&codesIn, char const *&vintsIn,
+              char const *vintsEnd, size_t numGroups, int32_t commonValue,
+              int32_t &prevVal, Int *&output)
+{
+    size_t n = 0;
+    char *p = reinterpret_cast<char *>(output);
+    (void)p;
+
+#if defined(TINYUSDZ_INTEGER_CODING_USE_AVX2)
+    if (_CPUSupportsAVX2()) {
+        n += _DecodeGroups32AVX2(codesIn, vintsIn, vintsEnd, numGroups,
+                                 commonValue, prevVal, p);
+    }
+#endif
+#if defined(TINYUSDZ_INTEGER_CODING_USE_SSSE3)
+    // Also decodes the last odd group left by the AVX2 decoder.
+    if (_CPUSupportsSSSE3()) {
+        n += _DecodeGroups32SSSE3(codesIn, vintsIn, vintsEnd,
+                                  numGroups - n / 4, commonValue, prevVal, p);
+    }
+#endif
+#if defined(TINYUSDZ_INTEGER_CODING_USE_NEON)
+    n += _DecodeGroups32NEON(codesIn, vintsIn, vintsEnd, numGroups,
+                             commonValue, prevVal, p);
+#endif
+    output += n;
+
+    // Groups left by the SIMD decoder(or all groups when SIMD is not
+    // available).
+    return n + _DecodeGroupsScalar(codesIn, vintsIn, vintsEnd,
+                                   numGroups - n / 4, commonValue, prevVal,
+                                   output);
+}
+
+template <class Int>
+inline typename std::enable_if<sizeof(Int) == 8, size_t>::type
+_DecodeGroups(char const *&codesIn, char const *&vintsIn,
+              char const *vintsEnd, size_t numGroups, int64_t commonValue,
+              int64_t &prevVal, Int *&output)
+{
+    // No SIMD decoder for 64-bit ints.
+    return _DecodeGroupsScalar(codesIn, vintsIn, vintsEnd, numGroups,
+                               commonValue, prevVal, output);
+}
+
+// Return the number of decoded integers, or 0 when `data` is too short.
+template <class Int>
+size_t _DecodeIntegers(char const *data, size_t dataSize, size_t numInts,
+                       Int *result, std::string *err)
+{
+    using SInt = typename std::make_signed<Int>::type;
 
     size_t numCodesBytes = (numInts * 2 + 7) / 8;
+    if (dataSize < sizeof(SInt) + numCodesBytes) {
+        if (err) {
+            (*err) += "Encoded integer data is too short.\n";
+        }
+        return 0;
+    }
+
+    char const *dataEnd = data + dataSize;
+    auto commonValue = _ReadBits<SInt>(data);
+
     char const *codesIn = data;
     char const *vintsIn = data + numCodesBytes;
 
     SInt prevVal = 0;
     auto intsLeft = numInts;
+
+    intsLeft -= _DecodeGroups(codesIn, vintsIn, dataEnd, intsLeft / 4,
+                              commonValue, prevVal, result);
+
+    // Remaining integers(or all integers when SIMD is not available).
+    const uint8_t *vintsSizes = (sizeof(Int) == 4) ?
+        _GetDecodeTables().vintsSize32 : _GetDecodeTables().vintsSize64;
+    // NOTE: Codes of the unused integers in the last byte are zero(= Common),
+    // so they do not contribute to the size.
+    auto checkVints = [&]() {
+        if (size_t(dataEnd - vintsIn) < vintsSizes[uint8_t(*codesIn)]) {
+            if (err) {
+                (*err) += "Encoded integer data is corrupted.\n";
+            }
+            return false;
+        }
+        return true;
+    };
+
     while (intsLeft >= 4) {
+        if (!checkVints()) {
+            return 0;
+        }
         _DecodeNHelper<4>(codesIn, vintsIn, commonValue, prevVal, result);
         intsLeft -= 4;
     }
+    if (intsLeft && !checkVints()) {
+        return 0;
+    }
     switch (intsLeft) {
     case 0: default: break;
     case 1: _DecodeNHelper<1>(codesIn, vintsIn, commonValue, prevVal, result);
@@ -394,8 +779,7 @@ size_t _DecompressIntegers(char const *compressed, size_t compressedSize,
                            Int *ints, size_t numInts, std::string *err, char *workingSpace)
 {
     // Working space.
-    size_t workingSpaceSize =
-        Usd_IntegerCompression::GetDecompressionWorkingSpaceSize(numInts);
+    size_t workingSpaceSize = _GetEncodedBufferSize<Int>(numInts);
     std::unique_ptr<char[]> tmpSpace;
     if (!workingSpace) {
         tmpSpace.reset(new char[workingSpaceSize]);
@@ -408,7 +792,7 @@ size_t _DecompressIntegers(char const *compressed, size_t compressedSize,
     if (decompSz == 0)
         return 0;
 
-    return _DecodeIntegers(workingSpace, numInts, ints);
+    return _DecodeIntegers(workingSpace, decompSz, numInts, ints, err);
 }
 
 
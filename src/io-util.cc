@@ -18,6 +18,8 @@
 #endif
 
 #include <io.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 #include <windows.h>  // include API for expanding a file path
 
 #ifndef TINYUSDZ_MMAP_SUPPORTED
@@ -55,6 +57,8 @@
 #include <sys/stat.h>
 #include <wordexp.h>
 
+#define TINYUSDZ_POSIX_STAT_SUPPORTED (1)
+
 #ifndef TINYUSDZ_MMAP_SUPPORTED
 #define TINYUSDZ_MMAP_SUPPORTED (1)
 #endif
@@ -333,6 +337,22 @@ bool UnmapFile(const MMapFileHandle &handle, std::string *err) {
 #endif
 }
 
+std::shared_ptr<MMapFileHandle> MMapFileShared(const std::string &filepath,
+                                               bool writable, std::string *err) {
+  MMapFileHandle handle;
+  if (!MMapFile(filepath, &handle, writable, err)) {
+    return nullptr;
+  }
+
+  return std::shared_ptr<MMapFileHandle>(
+      new MMapFileHandle(handle), [](MMapFileHandle *p) {
+        std::string _err;
+        // Ignore unmap result.
+        UnmapFile(*p, &_err);
+        delete p;
+      });
+}
+
 std::string ExpandFilePath(const std::string &_filepath, void *) {
   std::string filepath = _filepath;
   if (filepath.size() > 2048) {
@@ -894,6 +914,45 @@ bool FileExists(const std::string &filepath, void *userdata) {
   return ret;
 }
 
+bool GetFileStat(const std::string &filepath, uint64_t *size,
+                 uint64_t *mtime) {
+  if (!size || !mtime) {
+    return false;
+  }
+
+#if defined(TINYUSDZ_ANDROID_LOAD_FROM_ASSETS)
+  (void)filepath;
+  return false;
+#elif defined(_WIN32)
+  struct _stat64 st;
+  if (_wstat64(UTF8ToWchar(filepath).c_str(), &st) != 0) {
+    return false;
+  }
+  (*size) = uint64_t(st.st_size);
+  (*mtime) = uint64_t(st.st_mtime);
+  return true;
+#elif defined(TINYUSDZ_POSIX_STAT_SUPPORTED)
+  struct stat st;
+  if (stat(filepath.c_str(), &st) != 0) {
+    return false;
+  }
+  (*size) = uint64_t(st.st_size);
+#if defined(__APPLE__)
+  (*mtime) = uint64_t(st.st_mtimespec.tv_sec) * 1000000000ull +
+             uint64_t(st.st_mtimespec.tv_nsec);
+#elif defined(__linux__)
+  (*mtime) = uint64_t(st.st_mtim.tv_sec) * 1000000000ull +
+             uint64_t(st.st_mtim.tv_nsec);
+#else
+  (*mtime) = uint64_t(st.st_mtime);
+#endif
+  return true;
+#else
+  (void)filepath;
+  return false;
+#endif
+}
+
 std::string FindFile(const std::string &filename,
                      const std::vector<std::string> &search_paths) {
   // TODO: Use ghc filesystem?
@@ -9,6 +9,7 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <cstdint>
 
 #ifdef TINYUSDZ_ANDROID_LOAD_FROM_ASSETS
@@ -102,6 +103,15 @@ std::string ExpandFilePath(const std::string &filepath,
 
 bool FileExists(const std::string &filepath, void *userdata = nullptr);
 
+///
+/// Get the size and the last modification time of a file.
+/// `mtime` is an opaque value which is only meaningful for comparison.
+///
+/// Returns false when the file does not exist or the platform does not
+/// support it(e.g. Android assets, WASM).
+///
+bool GetFileStat(const std::string &filepath, uint64_t *size, uint64_t *mtime);
+
 ///
 /// Find file from search paths.
 /// Returns empty string if a file is not found.
@@ -148,6 +158,15 @@ bool MMapFile(const std::string &filepath, MMapFileHandle *handle, bool writable
 ///
 bool UnmapFile(const MMapFileHandle &handle, std::string *err);
 
+///
+/// memory-map file and return the handle as shared_ptr.
+/// The file is unmapped when the last reference to the handle is released,
+/// so the handle also works as a lifetime handle of the mapped memory.
+/// Returns nullptr when failed.
+///
+std::shared_ptr<MMapFileHandle> MMapFileShared(const std::string &filepath,
+                                               bool writable, std::string *err);
+
 ///
 /// Filepath is treated as WideChar(UNICODE) on Windows.
 ///
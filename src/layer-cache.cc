@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "layer-cache.hh"
+
+#include <iterator>
+
+namespace tinyusdz {
+
+std::shared_ptr<const Layer> LayerCache::find(const LayerCacheKey &key) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it = _entries.find(key.resolved_path);
+  if (it == _entries.end()) {
+    _num_misses++;
+    return nullptr;
+  }
+
+  if (it->second->key != key) {
+    // Asset was modified.
+    erase_entry(it->second);
+    _num_misses++;
+    return nullptr;
+  }
+
+  // Move to front.
+  _lru.splice(_lru.begin(), _lru, it->second);
+  _num_hits++;
+
+  return it->second->layer;
+}
+
+std::shared_ptr<const Layer> LayerCache::insert(
+    const LayerCacheKey &key, std::shared_ptr<const Layer> layer,
+    size_t nbytes) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it = _entries.find(key.resolved_path);
+  if (it != _entries.end()) {
+    if (it->second->key == key) {
+      // Added by another thread.
+      _lru.splice(_lru.begin(), _lru, it->second);
+      return it->second->layer;
+    }
+    erase_entry(it->second);
+  }
+
+  if (_memory_budget && (nbytes > _memory_budget)) {
+    return layer;
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.layer = layer;
+  entry.nbytes = nbytes;
+
+  _lru.emplace_front(std::move(entry));
+  _entries[key.resolved_path] = _lru.begin();
+  _memory_usage += nbytes;
+
+  evict();
+
+  return layer;
+}
+
+void LayerCache::erase(const std::string &resolved_path) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto it = _entries.find(resolved_path);
+  if (it != _entries.end()) {
+    erase_entry(it->second);
+  }
+}
+
+void LayerCache::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  _lru.clear();
+  _entries.clear();
+  _memory_usage = 0;
+}
+
+void LayerCache::set_memory_budget(size_t nbytes) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  _memory_budget = nbytes;
+  evict();
+}
+
+size_t LayerCache::memory_budget() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _memory_budget;
+}
+
+size_t LayerCache::memory_usage() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _memory_usage;
+}
+
+size_t LayerCache::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _lru.size();
+}
+
+uint64_t LayerCache::num_hits() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _num_hits;
+}
+
+uint64_t LayerCache::num_misses() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _num_misses;
+}
+
+uint64_t LayerCache::ComputeContentHash(const uint8_t *data, size_t nbytes) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < nbytes; i++) {
+    hash ^= uint64_t(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+void LayerCache::erase_entry(EntryList::iterator it) {
+  _memory_usage -= it->nbytes;
+  _entries.erase(it->key.resolved_path);
+  _lru.erase(it);
+}
+
+void LayerCache::evict() {
+  if (_memory_budget == 0) {
+    return;
+  }
+
+  while ((_memory_usage > _memory_budget) && !_lru.empty()) {
+    erase_entry(std::prev(_lru.end()));
+  }
+}
+
+}  // namespace tinyusdz
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Cache of parsed Layers for composition.
+//
+// An asset referenced from many PrimSpecs(e.g. a shared prop in a set
+// dressing) is read and parsed only once, and the parsed Layer is shared by
+// `subLayers`, `references` and `payload` composition.
+//
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "prim-types.hh"
+
+namespace tinyusdz {
+
+///
+/// Identifies the content of an asset.
+///
+/// For an asset in a file, the size and the modification time of the file are
+/// used, so a cached Layer can be found without reading the asset. Otherwise
+/// (e.g. an asset read through AssetResolutionHandler), the size and the hash
+/// of the asset data are used.
+///
+struct LayerCacheKey {
+  std::string resolved_path;
+  uint64_t size{0};
+  uint64_t mtime{0};
+  uint64_t content_hash{0};
+
+  bool operator==(const LayerCacheKey &rhs) const {
+    return (resolved_path == rhs.resolved_path) && (size == rhs.size) &&
+           (mtime == rhs.mtime) && (content_hash == rhs.content_hash);
+  }
+
+  bool operator!=(const LayerCacheKey &rhs) const { return !(*this == rhs); }
+};
+
+///
+/// Thread-safe cache of parsed Layers.
+///
+/// Cached Layers are immutable and shared through std::shared_ptr, so a Layer
+/// returned by `find()` stays valid after it is evicted from the cache.
+///
+/// LayerCache is owned by the caller. Set it to `layer_cache` of
+/// SublayersCompositionOptions, ReferencesCompositionOptions and
+/// PayloadCompositionOptions to share parsed Layers among composition passes.
+///
+class LayerCache {
+ public:
+  ///
+  /// @param[in] memory_budget Max memory usage of cached Layers in bytes.
+  /// Least recently used Layers are evicted when exceeded. 0 = unlimited.
+  ///
+  explicit LayerCache(size_t memory_budget = 0)
+      : _memory_budget(memory_budget) {}
+
+  LayerCache(const LayerCache &) = delete;
+  LayerCache &operator=(const LayerCache &) = delete;
+
+  ///
+  /// Find a Layer for `key`.
+  ///
+  /// A cached Layer of the same `resolved_path` but different content(i.e.
+  /// the asset was modified) is removed.
+  ///
+  /// @return nullptr when not found.
+  ///
+  std::shared_ptr<const Layer> find(const LayerCacheKey &key);
+
+  ///
+  /// Add a Layer.
+  ///
+  /// @param[in] key Key of the Layer
+  /// @param[in] layer Parsed Layer
+  /// @param[in] nbytes Approximated memory usage of the Layer(e.g. the size
+  /// of the asset data)
+  ///
+  /// @return Cached Layer. When another thread already added a Layer for the
+  /// same key, that Layer is returned. When `nbytes` exceeds the memory
+  /// budget, `layer` is returned without caching it.
+  ///
+  std::shared_ptr<const Layer> insert(const LayerCacheKey &key,
+                                      std::shared_ptr<const Layer> layer,
+                                      size_t nbytes);
+
+  ///
+  /// Remove the cached Layer of `resolved_path`.
+  ///
+  void erase(const std::string &resolved_path);
+
+  void clear();
+
+  ///
+  /// Set the memory budget in bytes(0 = unlimited). Layers are evicted
+  /// immediately when the current usage exceeds the new budget.
+  ///
+  void set_memory_budget(size_t nbytes);
+
+  size_t memory_budget() const;
+
+  ///
+  /// Sum of `nbytes` of cached Layers.
+  ///
+  size_t memory_usage() const;
+
+  ///
+  /// The number of cached Layers.
+  ///
+  size_t size() const;
+
+  uint64_t num_hits() const;
+  uint64_t num_misses() const;
+
+  ///
+  /// Hash of asset data for LayerCacheKey::content_hash.
+  ///
+  static uint64_t ComputeContentHash(const uint8_t *data, size_t nbytes);
+
+ private:
+  struct Entry {
+    LayerCacheKey key;
+    std::shared_ptr<const Layer> layer;
+    size_t nbytes{0};
+  };
+
+  using EntryList = std::list<Entry>;
+
+  void erase_entry(EntryList::iterator it);
+
+  // Evict least recently used Layers until the usage fits in the budget.
+  void evict();
+
+  mutable std::mutex _mutex;
+
+  // Front is the most recently used.
+  EntryList _lru;
+
+  // resolved_path -> entry in `_lru`. One Layer per resolved path.
+  std::unordered_map<std::string, EntryList::iterator> _entries;
+
+  size_t _memory_budget{0};
+  size_t _memory_usage{0};
+  uint64_t _num_hits{0};
+  uint64_t _num_misses{0};
+};
+
+}  // namespace tinyusdz
@@ -221,29 +221,58 @@ namespace pprint {
 
 static std::string sIndentString = "    ";
 
+// Precomputed indentation for level [0, kMaxCachedIndentLevel]
+constexpr uint32_t kMaxCachedIndentLevel = 32;
+static std::string sIndentCache = [] {
+  std::string s;
+  for (uint32_t i = 0; i < kMaxCachedIndentLevel; i++) {
+    s += sIndentString;
+  }
+  return s;
+}();
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
 
 std::string Indent(uint32_t n) {
-  std::stringstream ss;
+  if (n <= kMaxCachedIndentLevel) {
+    return sIndentCache.substr(0, n * sIndentString.size());
+  }
 
-  for (uint32_t i = 0; i < n; i++) {
-    ss << sIndentString;
+  std::string s = sIndentCache;
+  for (uint32_t i = kMaxCachedIndentLevel; i < n; i++) {
+    s += sIndentString;
   }
 
-  return ss.str();
+  return s;
 }
 
-void SetIndentString(const std::string &s) { sIndentString = s; }
+void WriteIndent(TextSink &w, uint32_t n) {
+  if (n <= kMaxCachedIndentLevel) {
+    w.write(sIndentCache.data(), n * sIndentString.size());
+    return;
+  }
+
+  w.write(sIndentCache);
+  for (uint32_t i = kMaxCachedIndentLevel; i < n; i++) {
+    w.write(sIndentString);
+  }
+}
+
+void SetIndentString(const std::string &s) {
+  sIndentString = s;
+  sIndentCache.clear();
+  for (uint32_t i = 0; i < kMaxCachedIndentLevel; i++) {
+    sIndentCache += sIndentString;
+  }
+}
 
 }  // namespace pprint
 
 template <typename T>
-std::string print_typed_timesamples(const TypedTimeSamples<T> &v,
-                                    const uint32_t indent = 0) {
-  std::stringstream ss;
-
+void print_typed_timesamples(TextSink &ss, const TypedTimeSamples<T> &v,
+                             const uint32_t indent = 0) {
   ss << "{\n";
 
   const auto &samples = v.get_samples();
@@ -259,15 +288,19 @@ std::string print_typed_timesamples(const TypedTimeSamples<T> &v,
   }
 
   ss << pprint::Indent(indent) << "}\n";
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_typed_token_timesamples(const TypedTimeSamples<T> &v,
-                                          const uint32_t indent = 0) {
-  std::stringstream ss;
+std::string print_typed_timesamples(const TypedTimeSamples<T> &v,
+                                    const uint32_t indent = 0) {
+  TextSink ss;
+  print_typed_timesamples(ss, v, indent);
+  return ss.take();
+}
 
+template <typename T>
+void print_typed_token_timesamples(TextSink &ss, const TypedTimeSamples<T> &v,
+                                   const uint32_t indent = 0) {
   ss << "{\n";
 
   const auto &samples = v.get_samples();
@@ -283,14 +316,19 @@ std::string print_typed_token_timesamples(const TypedTimeSamples<T> &v,
   }
 
   ss << pprint::Indent(indent) << "}\n";
-
-  return ss.str();
 }
 
-static std::string print_str_timesamples(const TypedTimeSamples<std::string> &v,
-                                         const uint32_t indent = 0) {
-  std::stringstream ss;
+template <typename T>
+std::string print_typed_token_timesamples(const TypedTimeSamples<T> &v,
+                                          const uint32_t indent = 0) {
+  TextSink ss;
+  print_typed_token_timesamples(ss, v, indent);
+  return ss.take();
+}
 
+static void print_str_timesamples(TextSink &ss,
+                                  const TypedTimeSamples<std::string> &v,
+                                  const uint32_t indent = 0) {
   ss << "{\n";
 
   const auto &samples = v.get_samples();
@@ -306,17 +344,13 @@ static std::string print_str_timesamples(const TypedTimeSamples<std::string> &v,
   }
 
   ss << pprint::Indent(indent) << "}\n";
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_animatable_default(const Animatable<T> &v,
-                             const uint32_t indent = 0) {
+void print_animatable_default(TextSink &ss, const Animatable<T> &v,
+                              const uint32_t indent = 0) {
   (void)indent;
 
-  std::stringstream ss;
-
   if (v.is_blocked()) {
     ss << "None";
   }
@@ -324,24 +358,35 @@ std::string print_animatable_default(const Animatable<T> &v,
   if (v.has_value()) {
     T a;
     if (!v.get_scalar(&a)) {
-      return "[Animatable: InternalError]";
+      ss << "[Animatable: InternalError]";
+      return;
     }
     ss << a;
   }
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_animatable_timesamples(const Animatable<T> &v,
+std::string print_animatable_default(const Animatable<T> &v,
                              const uint32_t indent = 0) {
-  std::stringstream ss;
+  TextSink ss;
+  print_animatable_default(ss, v, indent);
+  return ss.take();
+}
 
+template <typename T>
+void print_animatable_timesamples(TextSink &ss, const Animatable<T> &v,
+                                  const uint32_t indent = 0) {
   if (v.has_timesamples()) {
-    ss << print_typed_timesamples(v.get_timesamples(), indent);
+    print_typed_timesamples(ss, v.get_timesamples(), indent);
   }
+}
 
-  return ss.str();
+template <typename T>
+std::string print_animatable_timesamples(const Animatable<T> &v,
+                             const uint32_t indent = 0) {
+  TextSink ss;
+  print_animatable_timesamples(ss, v, indent);
+  return ss.take();
 }
 
 #if 0
@@ -483,9 +528,8 @@ std::string print_payload(const prim::PayloadList &payload,
   return ss.str();
 }
 
-std::string print_prim_metas(const PrimMeta &meta, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_prim_metas(TextSink &ss, const PrimMeta &meta,
+                      const uint32_t indent) {
   if (meta.active) {
     ss << pprint::Indent(indent)
        << "active = " << to_string(meta.active.value()) << "\n";
@@ -653,13 +697,16 @@ std::string print_prim_metas(const PrimMeta &meta, const uint32_t indent) {
   // for (const auto &item : meta.stringData) {
   //   ss << pprint::Indent(indent) << to_string(item) << "\n";
   // }
-
-  return ss.str();
 }
 
-std::string print_attr_metas(const AttrMeta &meta, const uint32_t indent) {
-  std::stringstream ss;
+std::string print_prim_metas(const PrimMeta &meta, const uint32_t indent) {
+  TextSink ss;
+  print_prim_metas(ss, meta, indent);
+  return ss.take();
+}
 
+void print_attr_metas(TextSink &ss, const AttrMeta &meta,
+                      const uint32_t indent) {
   if (meta.interpolation) {
     ss << pprint::Indent(indent)
        << "interpolation = " << quote(to_string(meta.interpolation.value()))
@@ -731,15 +778,17 @@ std::string print_attr_metas(const AttrMeta &meta, const uint32_t indent) {
   for (const auto &item : meta.stringData) {
     ss << pprint::Indent(indent) << to_string(item) << "\n";
   }
+}
 
-  return ss.str();
+std::string print_attr_metas(const AttrMeta &meta, const uint32_t indent) {
+  TextSink ss;
+  print_attr_metas(ss, meta, indent);
+  return ss.take();
 }
 
 template <typename T>
-std::string print_typed_attr(const TypedAttribute<Animatable<T>> &attr,
-                             const std::string &name, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_typed_attr(TextSink &ss, const TypedAttribute<Animatable<T>> &attr,
+                      const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     bool is_value_empty = attr.is_value_empty();
@@ -787,9 +836,9 @@ std::string print_typed_attr(const TypedAttribute<Animatable<T>> &attr,
       }
 
       if (attr.metas().authored()) {
-        ss << "(\n"
-           << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-           << ")";
+        ss << "(\n";
+        print_attr_metas(ss, attr.metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
       ss << "\n";
     }
@@ -798,8 +847,8 @@ std::string print_typed_attr(const TypedAttribute<Animatable<T>> &attr,
     if (has_timesamples) {
       ss << pprint::Indent(indent);
       ss << value::TypeTraits<T>::type_name() << " " << name;
-      ss << ".timeSamples = "
-         << print_typed_timesamples(pv.value().get_timesamples(), indent);
+      ss << ".timeSamples = ";
+      print_typed_timesamples(ss, pv.value().get_timesamples(), indent);
       ss << "\n";
     }
 
@@ -822,15 +871,19 @@ std::string print_typed_attr(const TypedAttribute<Animatable<T>> &attr,
     }
 
   }
-
-  return ss.str();
 }
 
-static std::string print_str_attr(
-    const TypedAttribute<Animatable<std::string>> &attr,
-    const std::string &name, const uint32_t indent) {
-  std::stringstream ss;
+template <typename T>
+std::string print_typed_attr(const TypedAttribute<Animatable<T>> &attr,
+                             const std::string &name, const uint32_t indent) {
+  TextSink ss;
+  print_typed_attr(ss, attr, name, indent);
+  return ss.take();
+}
 
+static void print_str_attr(TextSink &ss,
+                           const TypedAttribute<Animatable<std::string>> &attr,
+                           const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     bool is_value_empty = attr.is_value_empty();
@@ -866,9 +919,9 @@ static std::string print_str_attr(
       }
 
       if (attr.metas().authored()) {
-        ss << "(\n"
-           << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-           << ")";
+        ss << "(\n";
+        print_attr_metas(ss, attr.metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
       ss << "\n";
     }
@@ -877,8 +930,8 @@ static std::string print_str_attr(
       ss << pprint::Indent(indent);
       ss << value::TypeTraits<std::string>::type_name() << " " << name;
 
-      ss << ".timeSamples = "
-               << print_str_timesamples(pv.value().get_timesamples(), indent);
+      ss << ".timeSamples = ";
+      print_str_timesamples(ss, pv.value().get_timesamples(), indent);
 
       ss << "\n";
     }
@@ -901,8 +954,6 @@ static std::string print_str_attr(
       ss << "\n";
     }
   }
-
-  return ss.str();
 }
 
 #if 0
@@ -939,10 +990,8 @@ std::string print_typed_token_attr(const TypedAttribute<Animatable<T>> &attr, co
 #endif
 
 template <typename T>
-std::string print_typed_attr(const TypedAttribute<T> &attr,
-                             const std::string &name, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_typed_attr(TextSink &ss, const TypedAttribute<T> &attr,
+                      const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     if (attr.metas().authored() || attr.is_blocked() || attr.has_value() || attr.is_value_empty() || (!attr.is_connection())) {
@@ -962,9 +1011,9 @@ std::string print_typed_attr(const TypedAttribute<T> &attr,
       }
 
       if (attr.metas().authored()) {
-        ss << " (\n"
-           << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-           << ")";
+        ss << " (\n";
+        print_attr_metas(ss, attr.metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
       ss << "\n";
     }
@@ -987,8 +1036,14 @@ std::string print_typed_attr(const TypedAttribute<T> &attr,
       ss << "\n";
     }
   }
+}
 
-  return ss.str();
+template <typename T>
+std::string print_typed_attr(const TypedAttribute<T> &attr,
+                             const std::string &name, const uint32_t indent) {
+  TextSink ss;
+  print_typed_attr(ss, attr, name, indent);
+  return ss.take();
 }
 
 #if 0
@@ -1025,11 +1080,9 @@ std::string print_typed_token_attr(const TypedAttribute<T> &attr, const std::str
 #endif
 
 template <typename T>
-std::string print_typed_attr(
-    const TypedAttributeWithFallback<Animatable<T>> &attr,
-    const std::string &name, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_typed_attr(TextSink &ss,
+                      const TypedAttributeWithFallback<Animatable<T>> &attr,
+                      const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     const auto &v = attr.get_value();
@@ -1050,7 +1103,8 @@ std::string print_typed_attr(
       if (has_value) {
         ss << pprint::Indent(indent);
         ss << value::TypeTraits<T>::type_name() << " " << name;
-        ss << " = " << print_animatable_default(v, indent);
+        ss << " = ";
+        print_animatable_default(ss, v, indent);
 
       } else { // attr.is_value_empty()
         // declare only
@@ -1059,9 +1113,9 @@ std::string print_typed_attr(
       }
 
       if (attr.metas().authored()) {
-        ss << " (\n"
-           << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-           << ")";
+        ss << " (\n";
+        print_attr_metas(ss, attr.metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
       ss << "\n";
     }
@@ -1069,7 +1123,8 @@ std::string print_typed_attr(
     if (v.has_timesamples()) {
       ss << pprint::Indent(indent);
       ss << value::TypeTraits<T>::type_name() << " " << name;
-      ss << ".timeSamples = " << print_animatable_timesamples(v, indent);
+      ss << ".timeSamples = ";
+      print_animatable_timesamples(ss, v, indent);
       ss << "\n";
     }
 
@@ -1091,16 +1146,21 @@ std::string print_typed_attr(
     }
 
   }
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_typed_terminal_attr(const TypedTerminalAttribute<T> &attr,
-                                      const std::string &name,
-                                      const uint32_t indent) {
-  std::stringstream ss;
+std::string print_typed_attr(
+    const TypedAttributeWithFallback<Animatable<T>> &attr,
+    const std::string &name, const uint32_t indent) {
+  TextSink ss;
+  print_typed_attr(ss, attr, name, indent);
+  return ss.take();
+}
 
+template <typename T>
+void print_typed_terminal_attr(TextSink &ss,
+                               const TypedTerminalAttribute<T> &attr,
+                               const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
     ss << pprint::Indent(indent);
 
@@ -1111,21 +1171,26 @@ std::string print_typed_terminal_attr(const TypedTerminalAttribute<T> &attr,
     }
 
     if (attr.metas().authored()) {
-      ss << " (\n"
-         << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-         << ")";
+      ss << " (\n";
+      print_attr_metas(ss, attr.metas(), indent + 1);
+      ss << pprint::Indent(indent) << ")";
     }
     ss << "\n";
   }
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_typed_attr(const TypedAttributeWithFallback<T> &attr,
-                             const std::string &name, const uint32_t indent) {
-  std::stringstream ss;
+std::string print_typed_terminal_attr(const TypedTerminalAttribute<T> &attr,
+                                      const std::string &name,
+                                      const uint32_t indent) {
+  TextSink ss;
+  print_typed_terminal_attr(ss, attr, name, indent);
+  return ss.take();
+}
 
+template <typename T>
+void print_typed_attr(TextSink &ss, const TypedAttributeWithFallback<T> &attr,
+                      const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     // default
@@ -1141,9 +1206,9 @@ std::string print_typed_attr(const TypedAttributeWithFallback<T> &attr,
       }
 
       if (attr.metas().authored()) {
-        ss << " (\n"
-           << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-           << ")";
+        ss << " (\n";
+        print_attr_metas(ss, attr.metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
       ss << "\n";
     }
@@ -1164,16 +1229,20 @@ std::string print_typed_attr(const TypedAttributeWithFallback<T> &attr,
       }
     }
   }
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_typed_token_attr(
-    const TypedAttributeWithFallback<Animatable<T>> &attr,
-    const std::string &name, const uint32_t indent) {
-  std::stringstream ss;
+std::string print_typed_attr(const TypedAttributeWithFallback<T> &attr,
+                             const std::string &name, const uint32_t indent) {
+  TextSink ss;
+  print_typed_attr(ss, attr, name, indent);
+  return ss.take();
+}
 
+template <typename T>
+void print_typed_token_attr(TextSink &ss,
+                            const TypedAttributeWithFallback<Animatable<T>> &attr,
+                            const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     const auto &v = attr.get_value();
@@ -1193,9 +1262,9 @@ std::string print_typed_token_attr(
       }
 
       if (attr.metas().authored()) {
-        ss << " (\n"
-           << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-           << ")";
+        ss << " (\n";
+        print_attr_metas(ss, attr.metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
       ss << "\n";
     }
@@ -1205,7 +1274,7 @@ std::string print_typed_token_attr(
       ss << pprint::Indent(indent);
       ss << "token " << name << ".timeSamples = ";
 
-      ss << print_typed_token_timesamples(v.get_timesamples(), indent);
+      print_typed_token_timesamples(ss, v.get_timesamples(), indent);
       ss << "\n";
     }
 
@@ -1229,17 +1298,21 @@ std::string print_typed_token_attr(
     }
 
   }
-
-
-  return ss.str();
 }
 
 template <typename T>
-std::string print_typed_token_attr(const TypedAttributeWithFallback<T> &attr,
-                                   const std::string &name,
-                                   const uint32_t indent) {
-  std::stringstream ss;
+std::string print_typed_token_attr(
+    const TypedAttributeWithFallback<Animatable<T>> &attr,
+    const std::string &name, const uint32_t indent) {
+  TextSink ss;
+  print_typed_token_attr(ss, attr, name, indent);
+  return ss.take();
+}
 
+template <typename T>
+void print_typed_token_attr(TextSink &ss,
+                            const TypedAttributeWithFallback<T> &attr,
+                            const std::string &name, const uint32_t indent) {
   if (attr.authored()) {
 
     ss << pprint::Indent(indent);
@@ -1253,9 +1326,9 @@ std::string print_typed_token_attr(const TypedAttributeWithFallback<T> &attr,
     }
 
     if (attr.metas().authored()) {
-      ss << " (\n"
-         << print_attr_metas(attr.metas(), indent + 1) << pprint::Indent(indent)
-         << ")";
+      ss << " (\n";
+      print_attr_metas(ss, attr.metas(), indent + 1);
+      ss << pprint::Indent(indent) << ")";
     }
     ss << "\n";
 
@@ -1276,33 +1349,41 @@ std::string print_typed_token_attr(const TypedAttributeWithFallback<T> &attr,
       ss << "\n";
     }
   }
-
-  return ss.str();
 }
 
-std::string print_timesamples(const value::TimeSamples &v,
-                              const uint32_t indent) {
-  std::stringstream ss;
+template <typename T>
+std::string print_typed_token_attr(const TypedAttributeWithFallback<T> &attr,
+                                   const std::string &name,
+                                   const uint32_t indent) {
+  TextSink ss;
+  print_typed_token_attr(ss, attr, name, indent);
+  return ss.take();
+}
 
+void print_timesamples(TextSink &ss, const value::TimeSamples &v,
+                       const uint32_t indent) {
   ss << "{\n";
 
   for (size_t i = 0; i < v.size(); i++) {
     ss << pprint::Indent(indent + 1);
-    ss << v.get_samples()[i].t << ": "
-       << value::pprint_value(v.get_samples()[i].value);
+    ss << v.get_time(i).value() << ": ";
+    value::pprint_value(ss.stream(), v.get_value(i).value());
     ss << ",\n";  // USDA allow ',' for the last item
   }
   ss << pprint::Indent(indent) << "}\n";
-
-  return ss.str();
 }
 
-std::string print_rel_prop(const Property &prop, const std::string &name,
-                           uint32_t indent) {
-  std::stringstream ss;
+std::string print_timesamples(const value::TimeSamples &v,
+                              const uint32_t indent) {
+  TextSink ss;
+  print_timesamples(ss, v, indent);
+  return ss.take();
+}
 
+void print_rel_prop(TextSink &ss, const Property &prop, const std::string &name,
+                    uint32_t indent) {
   if (!prop.is_relationship()) {
-    return ss.str();
+    return;
   }
 
   ss << pprint::Indent(indent);
@@ -1322,16 +1403,19 @@ std::string print_rel_prop(const Property &prop, const std::string &name,
   }
 
   ss << print_rel_only(rel, name, indent);
-
-  return ss.str();
 }
 
-std::string print_prop(const Property &prop, const std::string &prop_name,
-                       uint32_t indent) {
-  std::stringstream ss;
+std::string print_rel_prop(const Property &prop, const std::string &name,
+                           uint32_t indent) {
+  TextSink ss;
+  print_rel_prop(ss, prop, name, indent);
+  return ss.take();
+}
 
+void print_prop(TextSink &ss, const Property &prop,
+                const std::string &prop_name, uint32_t indent) {
   if (prop.is_relationship()) {
-    ss << print_rel_prop(prop, prop_name, indent);
+    print_rel_prop(ss, prop, prop_name, indent);
 
     // Attribute or AttributeConnection
   } else if (prop.is_attribute()) {
@@ -1378,14 +1462,14 @@ std::string print_prop(const Property &prop, const std::string &prop_name,
           ss << "None";
         } else {
           // default value
-          ss << value::pprint_value(attr.get_var().value_raw());
+          value::pprint_value(ss.stream(), attr.get_var().value_raw());
         }
       }
 
       if (prop.get_attribute().metas().authored()) {
-        ss << " (\n"
-           << print_attr_metas(prop.get_attribute().metas(), indent + 1)
-           << pprint::Indent(indent) << ")";
+        ss << " (\n";
+        print_attr_metas(ss, prop.get_attribute().metas(), indent + 1);
+        ss << pprint::Indent(indent) << ")";
       }
 
       ss << "\n";
@@ -1408,7 +1492,7 @@ std::string print_prop(const Property &prop, const std::string &prop_name,
 
       ss << " = ";
 
-      ss << print_timesamples(attr.get_var().ts_raw(), indent);
+      print_timesamples(ss, attr.get_var().ts_raw(), indent);
 
       ss << "\n";
     }
@@ -1450,30 +1534,35 @@ std::string print_prop(const Property &prop, const std::string &prop_name,
   } else {
     ss << "[Invalid Property] " << prop_name << "\n";
   }
-
-  return ss.str();
 }
 
-std::string print_props(const std::map<std::string, Property> &props,
-                        uint32_t indent) {
-  std::stringstream ss;
+std::string print_prop(const Property &prop, const std::string &prop_name,
+                       uint32_t indent) {
+  TextSink ss;
+  print_prop(ss, prop, prop_name, indent);
+  return ss.take();
+}
 
+void print_props(TextSink &ss, const std::map<std::string, Property> &props,
+                 uint32_t indent) {
   for (const auto &item : props) {
     const Property &prop = item.second;
 
-    ss << print_prop(prop, item.first, indent);
+    print_prop(ss, prop, item.first, indent);
   }
-
-  return ss.str();
 }
 
-// Print user-defined (custom) properties.
 std::string print_props(const std::map<std::string, Property> &props,
-                        std::set<std::string> &tok_table,
-                        const std::vector<value::token> &propNames,
                         uint32_t indent) {
-  std::stringstream ss;
+  TextSink ss;
+  print_props(ss, props, indent);
+  return ss.take();
+}
 
+// Print user-defined (custom) properties.
+void print_props(TextSink &ss, const std::map<std::string, Property> &props,
+                 std::set<std::string> &tok_table,
+                 const std::vector<value::token> &propNames, uint32_t indent) {
   if (propNames.size()) {
     for (size_t i = 0; i < propNames.size(); i++) {
       if (tok_table.count(propNames[i].str())) {
@@ -1482,16 +1571,23 @@ std::string print_props(const std::map<std::string, Property> &props,
 
       const auto it = props.find(propNames[i].str());
       if (it != props.end()) {
-        ss << print_prop(it->second, it->first, indent);
+        print_prop(ss, it->second, it->first, indent);
 
         tok_table.insert(propNames[i].str());
       }
     }
   } else {
-    ss << print_props(props, indent);
+    print_props(ss, props, indent);
   }
+}
 
-  return ss.str();
+std::string print_props(const std::map<std::string, Property> &props,
+                        std::set<std::string> &tok_table,
+                        const std::vector<value::token> &propNames,
+                        uint32_t indent) {
+  TextSink ss;
+  print_props(ss, props, tok_table, propNames, indent);
+  return ss.take();
 }
 
 std::string print_xformOpOrder(const std::vector<XformOp> &xformOps,
@@ -1522,10 +1618,8 @@ std::string print_xformOpOrder(const std::vector<XformOp> &xformOps,
   return ss.str();
 }
 
-std::string print_xformOps(const std::vector<XformOp> &xformOps,
-                           const uint32_t indent) {
-  std::stringstream ss;
-
+void print_xformOps(TextSink &ss, const std::vector<XformOp> &xformOps,
+                    const uint32_t indent) {
   // To prevent printing xformOp attributes multiple times.
   std::set<std::string> printed_vars;
 
@@ -1562,7 +1656,7 @@ std::string print_xformOps(const std::vector<XformOp> &xformOps,
         if (xformOp.is_blocked()) {
           ss << "None";
         } else if (auto pv = xformOp.get_scalar()) {
-          ss << value::pprint_value(pv.value(), indent);
+          value::pprint_value(ss.stream(), pv.value(), indent);
         } else {
           ss << "[InternalError]";
         }
@@ -1586,7 +1680,7 @@ std::string print_xformOps(const std::vector<XformOp> &xformOps,
         ss << " = ";
 
         if (auto pv = xformOp.get_timesamples()) {
-          ss << print_timesamples(pv.value(), indent);
+          print_timesamples(ss, pv.value(), indent);
         } else {
           ss << "[InternalError]";
         }
@@ -1598,8 +1692,13 @@ std::string print_xformOps(const std::vector<XformOp> &xformOps,
 
   // uniform token[] xformOpOrder
   ss << print_xformOpOrder(xformOps, indent);
+}
 
-  return ss.str();
+std::string print_xformOps(const std::vector<XformOp> &xformOps,
+                           const uint32_t indent) {
+  TextSink ss;
+  print_xformOps(ss, xformOps, indent);
+  return ss.take();
 }
 
 #if 0
@@ -1798,16 +1897,15 @@ std::string print_collection(const Collection *coll, const uint32_t indent) {
 }
 
 template <typename T>
-std::string print_gprim_predefined(const T &gprim, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_gprim_predefined(TextSink &ss, const T &gprim,
+                            const uint32_t indent) {
   // properties
-  ss << print_typed_attr(gprim.doubleSided, "doubleSided", indent);
-  ss << print_typed_token_attr(gprim.orientation, "orientation", indent);
-  ss << print_typed_token_attr(gprim.purpose, "purpose", indent);
-  ss << print_typed_attr(gprim.extent, "extent", indent);
+  print_typed_attr(ss, gprim.doubleSided, "doubleSided", indent);
+  print_typed_token_attr(ss, gprim.orientation, "orientation", indent);
+  print_typed_token_attr(ss, gprim.purpose, "purpose", indent);
+  print_typed_attr(ss, gprim.extent, "extent", indent);
 
-  ss << print_typed_token_attr(gprim.visibility, "visibility", indent);
+  print_typed_token_attr(ss, gprim.visibility, "visibility", indent);
 
   ss << print_material_binding(&gprim, indent);
 
@@ -1819,9 +1917,14 @@ std::string print_gprim_predefined(const T &gprim, const uint32_t indent) {
                              "proxyPrim", indent);
   }
 
-  ss << print_xformOps(gprim.xformOps, indent);
+  print_xformOps(ss, gprim.xformOps, indent);
+}
 
-  return ss.str();
+template <typename T>
+std::string print_gprim_predefined(const T &gprim, const uint32_t indent) {
+  TextSink ss;
+  print_gprim_predefined(ss, gprim, indent);
+  return ss.take();
 }
 
 #if 0
@@ -2738,10 +2841,12 @@ std::string to_string(const tinyusdz::Klass &klass, uint32_t indent, bool closin
 }
 #endif
 
-std::string print_variantSetStmt(
-    const std::map<std::string, VariantSet> &vslist, const uint32_t indent) {
-  std::stringstream ss;
+static void print_prim_data(TextSink &ss, const value::Value &v,
+                            const uint32_t indent, bool closing_brace);
 
+void print_variantSetStmt(TextSink &ss,
+                          const std::map<std::string, VariantSet> &vslist,
+                          const uint32_t indent) {
   // ss << "# variantSet.size = " << std::to_string(vslist.size()) << "\n";
   for (const auto &variantSet : vslist) {
     if (variantSet.second.variantSet.empty()) {
@@ -2756,14 +2861,14 @@ std::string print_variantSetStmt(
 
       if (item.second.metas().authored()) {
         ss << "(\n";
-        ss << print_prim_metas(item.second.metas(), indent + 2);
+        print_prim_metas(ss, item.second.metas(), indent + 2);
         ss << pprint::Indent(indent + 1) << ") ";
       }
 
       ss << "{\n";
 
       // props
-      ss << print_props(item.second.properties(), indent + 2);
+      print_props(ss, item.second.properties(), indent + 2);
 
       // primChildren
       // TODO: print child Prims based on `primChildren` Prim metadata
@@ -2784,16 +2889,16 @@ std::string print_variantSetStmt(
                             nameTok.str()));
           const auto it = primNameTable.find(nameTok.str());
           if (it != primNameTable.end()) {
-            ss << pprint_value(it->second->data(), indent + 2,
-                               /* closing_brace */ true);
+            print_prim_data(ss, it->second->data(), indent + 2,
+                            /* closing_brace */ true);
           } else {
             // TODO: Report warning?
           }
         }
       } else {
         for (const auto &child : variantPrimChildren) {
-          ss << pprint_value(child.data(), indent + 2,
-                             /* closing_brace */ true);
+          print_prim_data(ss, child.data(), indent + 2,
+                          /* closing_brace */ true);
         }
       }
 
@@ -2803,15 +2908,18 @@ std::string print_variantSetStmt(
 
     ss << pprint::Indent(indent) << "}\n";
   }
+}
 
-  return ss.str();
+std::string print_variantSetStmt(
+    const std::map<std::string, VariantSet> &vslist, const uint32_t indent) {
+  TextSink ss;
+  print_variantSetStmt(ss, vslist, indent);
+  return ss.take();
 }
 
-std::string print_variantSetSpecStmt(
-    const std::map<std::string, VariantSetSpec> &vslist,
+void print_variantSetSpecStmt(
+    TextSink &ss, const std::map<std::string, VariantSetSpec> &vslist,
     const uint32_t indent) {
-  std::stringstream ss;
-
   // ss << "# variantSet.size = " << std::to_string(vslist.size()) << "\n";
   for (const auto &variantSet : vslist) {
     if (variantSet.second.variantSet.empty()) {
@@ -2826,14 +2934,14 @@ std::string print_variantSetSpecStmt(
 
       if (item.second.metas().authored()) {
         ss << "(\n";
-        ss << print_prim_metas(item.second.metas(), indent + 2);
+        print_prim_metas(ss, item.second.metas(), indent + 2);
         ss << pprint::Indent(indent + 1) << ") ";
       }
 
       ss << "{\n";
 
       // props
-      ss << print_props(item.second.props(), indent + 2);
+      print_props(ss, item.second.props(), indent + 2);
 
       // primChildren
       // TODO: print child Prims based on `primChildren` Prim metadata
@@ -2871,14 +2979,18 @@ std::string print_variantSetSpecStmt(
 
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const Model &model, const uint32_t indent,
-                      bool closing_brace) {
-  std::stringstream ss;
+std::string print_variantSetSpecStmt(
+    const std::map<std::string, VariantSetSpec> &vslist,
+    const uint32_t indent) {
+  TextSink ss;
+  print_variantSetSpecStmt(ss, vslist, indent);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const Model &model,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(model.spec);
   if (model.prim_type_name.size()) {
     ss << " " << model.prim_type_name;
@@ -2887,48 +2999,54 @@ std::string to_string(const Model &model, const uint32_t indent,
 
   if (model.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(model.meta, indent + 1);
+    print_prim_metas(ss, model.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   std::set<std::string> tokset;
-  ss << print_props(model.props, tokset, model.propertyNames(), indent + 1);
+  print_props(ss, model.props, tokset, model.propertyNames(), indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const Scope &scope, const uint32_t indent,
+std::string to_string(const Model &model, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, model, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const Scope &scope,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(scope.spec) << " Scope \""
      << scope.name << "\"\n";
   if (scope.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(scope.meta, indent + 1);
+    print_prim_metas(ss, scope.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   std::set<std::string> tokset;
-  ss << print_props(scope.props, tokset, scope.propertyNames(), indent + 1);
+  print_props(ss, scope.props, tokset, scope.propertyNames(), indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GPrim &gprim, const uint32_t indent,
+std::string to_string(const Scope &scope, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, scope, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GPrim &gprim,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(gprim.spec) << " GPrim \""
      << gprim.name << "\"\n";
   ss << pprint::Indent(indent) << "(\n";
@@ -2936,83 +3054,93 @@ std::string to_string(const GPrim &gprim, const uint32_t indent,
   ss << pprint::Indent(indent) << ")\n";
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_gprim_predefined(gprim, indent + 1);
+  print_gprim_predefined(ss, gprim, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const Xform &xform, const uint32_t indent,
+std::string to_string(const GPrim &gprim, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, gprim, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const Xform &xform,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(xform.spec) << " Xform \""
      << xform.name << "\"\n";
   if (xform.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(xform.meta, indent + 1);
+    print_prim_metas(ss, xform.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_gprim_predefined(xform, indent + 1);
+  print_gprim_predefined(ss, xform, indent + 1);
 
-  ss << print_props(xform.props, indent + 1);
+  print_props(ss, xform.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomCamera &camera, const uint32_t indent,
+std::string to_string(const Xform &xform, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, xform, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomCamera &camera,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(camera.spec) << " Camera \""
      << camera.name << "\"\n";
   if (camera.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(camera.meta, indent + 1);
+    print_prim_metas(ss, camera.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(camera.clippingRange, "clippingRange", indent + 1);
-  ss << print_typed_attr(camera.clippingPlanes, "clippingPlanes", indent + 1);
-  ss << print_typed_attr(camera.focalLength, "focalLength", indent + 1);
-  ss << print_typed_attr(camera.horizontalAperture, "horizontalAperture",
-                         indent + 1);
-  ss << print_typed_attr(camera.horizontalApertureOffset,
-                         "horizontalApertureOffset", indent + 1);
-  ss << print_typed_attr(camera.verticalAperture, "verticalAperture",
-                         indent + 1);
-  ss << print_typed_attr(camera.verticalApertureOffset,
-                         "verticalApertureOffset", indent + 1);
+  print_typed_attr(ss, camera.clippingRange, "clippingRange", indent + 1);
+  print_typed_attr(ss, camera.clippingPlanes, "clippingPlanes", indent + 1);
+  print_typed_attr(ss, camera.focalLength, "focalLength", indent + 1);
+  print_typed_attr(ss, camera.horizontalAperture, "horizontalAperture",
+                   indent + 1);
+  print_typed_attr(ss, camera.horizontalApertureOffset,
+                   "horizontalApertureOffset", indent + 1);
+  print_typed_attr(ss, camera.verticalAperture, "verticalAperture", indent + 1);
+  print_typed_attr(ss, camera.verticalApertureOffset, "verticalApertureOffset",
+                   indent + 1);
 
-  ss << print_typed_token_attr(camera.projection, "projection", indent + 1);
-  ss << print_typed_token_attr(camera.stereoRole, "stereoRole", indent + 1);
+  print_typed_token_attr(ss, camera.projection, "projection", indent + 1);
+  print_typed_token_attr(ss, camera.stereoRole, "stereoRole", indent + 1);
 
-  ss << print_typed_attr(camera.shutterOpen, "shutter:open", indent + 1);
-  ss << print_typed_attr(camera.shutterClose, "shutter:close", indent + 1);
+  print_typed_attr(ss, camera.shutterOpen, "shutter:open", indent + 1);
+  print_typed_attr(ss, camera.shutterClose, "shutter:close", indent + 1);
 
-  ss << print_gprim_predefined(camera, indent + 1);
+  print_gprim_predefined(ss, camera, indent + 1);
 
-  ss << print_props(camera.props, indent + 1);
+  print_props(ss, camera.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-#if 0
+std::string to_string(const GeomCamera &camera, const uint32_t indent,
+                      bool closing_brace) {
+  TextSink ss;
+  print_prim_data(ss, camera, indent, closing_brace);
+  return ss.take();
+}
+
+#if 0
 #define PRINT_TYPED_ATTR(__table, __propName, __var, __name, __indent) \
   if (__propName == __name) {                                          \
     ss << print_typed_attr(__var, __name, __indent);                   \
@@ -3021,15 +3149,13 @@ std::string to_string(const GeomCamera &camera, const uint32_t indent,
   }
 #endif
 
-std::string to_string(const GeomSphere &sphere, const uint32_t indent,
-                      bool closing_brace) {
-  std::stringstream ss;
-
+static void print_prim_data(TextSink &ss, const GeomSphere &sphere,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(sphere.spec) << " Sphere \""
      << sphere.name << "\"\n";
   if (sphere.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(sphere.meta, indent + 1);
+    print_prim_metas(ss, sphere.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
@@ -3054,7 +3180,7 @@ std::string to_string(const GeomSphere &sphere, const uint32_t indent,
         continue;
       }
       if (sphere.props.count(propName)) {
-        ss << print_prop(sphere.props.at(propName), propName, indent + 1);
+        print_prop(ss, sphere.props.at(propName), propName, indent + 1);
         table.insert(propName);
         continue;
       }
@@ -3066,48 +3192,50 @@ std::string to_string(const GeomSphere &sphere, const uint32_t indent,
     }
   } else {
     // members
-    ss << print_typed_attr(sphere.radius, "radius", indent + 1);
+    print_typed_attr(ss, sphere.radius, "radius", indent + 1);
 
-    ss << print_gprim_predefined(sphere, indent + 1);
+    print_gprim_predefined(ss, sphere, indent + 1);
 
-    ss << print_props(sphere.props, indent + 1);
+    print_props(ss, sphere.props, indent + 1);
   }
 #else
 
-  ss << print_typed_attr(sphere.radius, "radius", indent + 1);
+  print_typed_attr(ss, sphere.radius, "radius", indent + 1);
 
-  ss << print_gprim_predefined(sphere, indent + 1);
+  print_gprim_predefined(ss, sphere, indent + 1);
 
-  ss << print_props(sphere.props, indent + 1);
+  print_props(ss, sphere.props, indent + 1);
 
 #endif
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomMesh &mesh, const uint32_t indent,
+std::string to_string(const GeomSphere &sphere, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, sphere, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomMesh &mesh,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(mesh.spec) << " Mesh \""
      << mesh.name << "\"\n";
   if (mesh.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(mesh.meta, indent + 1);
+    print_prim_metas(ss, mesh.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(mesh.points, "points", indent + 1);
-  ss << print_typed_attr(mesh.normals, "normals", indent + 1);
-  ss << print_typed_attr(mesh.faceVertexIndices, "faceVertexIndices",
-                         indent + 1);
-  ss << print_typed_attr(mesh.faceVertexCounts, "faceVertexCounts", indent + 1);
+  print_typed_attr(ss, mesh.points, "points", indent + 1);
+  print_typed_attr(ss, mesh.normals, "normals", indent + 1);
+  print_typed_attr(ss, mesh.faceVertexIndices, "faceVertexIndices", indent + 1);
+  print_typed_attr(ss, mesh.faceVertexCounts, "faceVertexCounts", indent + 1);
 
   if (mesh.skeleton) {
     ss << print_relationship(mesh.skeleton.value(),
@@ -3115,7 +3243,7 @@ std::string to_string(const GeomMesh &mesh, const uint32_t indent,
                              /* custom */ false, "skel:skeleton", indent + 1);
   }
 
-  ss << print_typed_attr(mesh.blendShapes, "skel:blendShapes", indent + 1);
+  print_typed_attr(ss, mesh.blendShapes, "skel:blendShapes", indent + 1);
   if (mesh.blendShapeTargets) {
     ss << print_relationship(mesh.blendShapeTargets.value(),
                              mesh.blendShapeTargets.value().get_listedit_qual(),
@@ -3130,23 +3258,21 @@ std::string to_string(const GeomMesh &mesh, const uint32_t indent,
   }
 
   // subdiv
-  ss << print_typed_attr(mesh.cornerIndices, "cornerIndices", indent + 1);
-  ss << print_typed_attr(mesh.cornerSharpnesses, "cornerSharpnesses",
+  print_typed_attr(ss, mesh.cornerIndices, "cornerIndices", indent + 1);
+  print_typed_attr(ss, mesh.cornerSharpnesses, "cornerSharpnesses", indent + 1);
+  print_typed_attr(ss, mesh.creaseIndices, "creaseIndices", indent + 1);
+  print_typed_attr(ss, mesh.creaseLengths, "creaseLengths", indent + 1);
+  print_typed_attr(ss, mesh.creaseSharpnesses, "creaseSharpnesses", indent + 1);
+  print_typed_attr(ss, mesh.holeIndices, "holeIndices", indent + 1);
+
+  print_typed_token_attr(ss, mesh.subdivisionScheme, "subdivisonScheme",
                          indent + 1);
-  ss << print_typed_attr(mesh.creaseIndices, "creaseIndices", indent + 1);
-  ss << print_typed_attr(mesh.creaseLengths, "creaseLengths", indent + 1);
-  ss << print_typed_attr(mesh.creaseSharpnesses, "creaseSharpnesses",
+  print_typed_token_attr(ss, mesh.interpolateBoundary, "interpolateBoundary",
                          indent + 1);
-  ss << print_typed_attr(mesh.holeIndices, "holeIndices", indent + 1);
+  print_typed_token_attr(ss, mesh.faceVaryingLinearInterpolation,
+                         "faceVaryingLinearInterpolation", indent + 1);
 
-  ss << print_typed_token_attr(mesh.subdivisionScheme, "subdivisonScheme",
-                               indent + 1);
-  ss << print_typed_token_attr(mesh.interpolateBoundary, "interpolateBoundary",
-                               indent + 1);
-  ss << print_typed_token_attr(mesh.faceVaryingLinearInterpolation,
-                               "faceVaryingLinearInterpolation", indent + 1);
-
-  ss << print_gprim_predefined(mesh, indent + 1);
+  print_gprim_predefined(ss, mesh, indent + 1);
 
 #if 0
   // GeomSubset.
@@ -3155,72 +3281,83 @@ std::string to_string(const GeomMesh &mesh, const uint32_t indent,
   }
 #endif
 
-  ss << print_props(mesh.props, indent + 1);
+  print_props(ss, mesh.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomSubset &subset, const uint32_t indent,
+std::string to_string(const GeomMesh &mesh, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, mesh, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomSubset &subset,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(subset.spec) << " GeomSubset \""
      << subset.name << "\"\n";
   ss << pprint::Indent(indent) << "(\n";
-  ss << print_prim_metas(subset.meta, indent + 1);
+  print_prim_metas(ss, subset.meta, indent + 1);
   ss << pprint::Indent(indent) << ")\n";
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_typed_token_attr(subset.elementType, "elementType", indent + 1);
-  ss << print_typed_attr(subset.familyName, "familyName", indent + 1);
-  ss << print_typed_attr(subset.indices, "indices", indent + 1);
+  print_typed_token_attr(ss, subset.elementType, "elementType", indent + 1);
+  print_typed_attr(ss, subset.familyName, "familyName", indent + 1);
+  print_typed_attr(ss, subset.indices, "indices", indent + 1);
 
   ss << print_material_binding(&subset, indent + 1);
   ss << print_collection(&subset, indent + 1);
 
-  ss << print_props(subset.props, indent + 1);
+  print_props(ss, subset.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomPoints &geom, const uint32_t indent,
+std::string to_string(const GeomSubset &subset, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, subset, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomPoints &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " Points \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(geom.points, "points", indent + 1);
-  ss << print_typed_attr(geom.normals, "normals", indent + 1);
-  ss << print_typed_attr(geom.widths, "widths", indent + 1);
-  ss << print_typed_attr(geom.ids, "ids", indent + 1);
-  ss << print_typed_attr(geom.velocities, "velocities", indent + 1);
-  ss << print_typed_attr(geom.accelerations, "accelerations", indent + 1);
+  print_typed_attr(ss, geom.points, "points", indent + 1);
+  print_typed_attr(ss, geom.normals, "normals", indent + 1);
+  print_typed_attr(ss, geom.widths, "widths", indent + 1);
+  print_typed_attr(ss, geom.ids, "ids", indent + 1);
+  print_typed_attr(ss, geom.velocities, "velocities", indent + 1);
+  print_typed_attr(ss, geom.accelerations, "accelerations", indent + 1);
 
-  ss << print_gprim_predefined(geom, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
 
-  ss << print_props(geom.props, indent + 1);
+  print_props(ss, geom.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
+}
 
-  return ss.str();
+std::string to_string(const GeomPoints &geom, const uint32_t indent,
+                      bool closing_brace) {
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
 }
 
 std::string to_string(const GeomBasisCurves::Type &ty) {
@@ -3282,125 +3419,130 @@ std::string to_string(const GeomBasisCurves::Wrap &ty) {
   return s;
 }
 
-std::string to_string(const GeomBasisCurves &geom, const uint32_t indent,
-                      bool closing_brace) {
-  std::stringstream ss;
-
+static void print_prim_data(TextSink &ss, const GeomBasisCurves &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " BasisCurves \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_token_attr(geom.type, "type", indent + 1);
-  ss << print_typed_token_attr(geom.basis, "basis", indent + 1);
-  ss << print_typed_token_attr(geom.wrap, "wrap", indent + 1);
-
-  ss << print_typed_attr(geom.points, "points", indent + 1);
-  ss << print_typed_attr(geom.normals, "normals", indent + 1);
-  ss << print_typed_attr(geom.widths, "widths", indent + 1);
-  ss << print_typed_attr(geom.velocities, "velocites", indent + 1);
-  ss << print_typed_attr(geom.accelerations, "accelerations", indent + 1);
-  ss << print_typed_attr(geom.curveVertexCounts, "curveVertexCounts",
-                         indent + 1);
+  print_typed_token_attr(ss, geom.type, "type", indent + 1);
+  print_typed_token_attr(ss, geom.basis, "basis", indent + 1);
+  print_typed_token_attr(ss, geom.wrap, "wrap", indent + 1);
+
+  print_typed_attr(ss, geom.points, "points", indent + 1);
+  print_typed_attr(ss, geom.normals, "normals", indent + 1);
+  print_typed_attr(ss, geom.widths, "widths", indent + 1);
+  print_typed_attr(ss, geom.velocities, "velocites", indent + 1);
+  print_typed_attr(ss, geom.accelerations, "accelerations", indent + 1);
+  print_typed_attr(ss, geom.curveVertexCounts, "curveVertexCounts", indent + 1);
 
-  ss << print_gprim_predefined(geom, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
 
-  ss << print_props(geom.props, indent + 1);
+  print_props(ss, geom.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomNurbsCurves &geom, const uint32_t indent,
+std::string to_string(const GeomBasisCurves &geom, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomNurbsCurves &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " NurbsCurves \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(geom.points, "points", indent + 1);
-  ss << print_typed_attr(geom.normals, "normals", indent + 1);
-  ss << print_typed_attr(geom.widths, "widths", indent + 1);
-  ss << print_typed_attr(geom.velocities, "velocites", indent + 1);
-  ss << print_typed_attr(geom.accelerations, "accelerations", indent + 1);
-  ss << print_typed_attr(geom.curveVertexCounts, "curveVertexCounts",
-                         indent + 1);
+  print_typed_attr(ss, geom.points, "points", indent + 1);
+  print_typed_attr(ss, geom.normals, "normals", indent + 1);
+  print_typed_attr(ss, geom.widths, "widths", indent + 1);
+  print_typed_attr(ss, geom.velocities, "velocites", indent + 1);
+  print_typed_attr(ss, geom.accelerations, "accelerations", indent + 1);
+  print_typed_attr(ss, geom.curveVertexCounts, "curveVertexCounts", indent + 1);
 
   //
-  ss << print_typed_attr(geom.order, "order", indent + 1);
-  ss << print_typed_attr(geom.knots, "knots", indent + 1);
-  ss << print_typed_attr(geom.ranges, "ranges", indent + 1);
-  ss << print_typed_attr(geom.pointWeights, "pointWeights", indent + 1);
+  print_typed_attr(ss, geom.order, "order", indent + 1);
+  print_typed_attr(ss, geom.knots, "knots", indent + 1);
+  print_typed_attr(ss, geom.ranges, "ranges", indent + 1);
+  print_typed_attr(ss, geom.pointWeights, "pointWeights", indent + 1);
 
-  ss << print_gprim_predefined(geom, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
 
-  ss << print_props(geom.props, indent + 1);
+  print_props(ss, geom.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomCube &geom, const uint32_t indent,
+std::string to_string(const GeomNurbsCurves &geom, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomCube &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " Cube \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(geom.size, "size", indent + 1);
+  print_typed_attr(ss, geom.size, "size", indent + 1);
 
-  ss << print_gprim_predefined(geom, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
 
-  ss << print_props(geom.props, indent + 1);
+  print_props(ss, geom.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomCone &geom, const uint32_t indent,
+std::string to_string(const GeomCube &geom, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomCone &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " Cone \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(geom.radius, "radius", indent + 1);
-  ss << print_typed_attr(geom.height, "height", indent + 1);
+  print_typed_attr(ss, geom.radius, "radius", indent + 1);
+  print_typed_attr(ss, geom.height, "height", indent + 1);
 
   if (geom.axis.authored()) {
     std::string axis;
@@ -3414,32 +3556,35 @@ std::string to_string(const GeomCone &geom, const uint32_t indent,
     ss << pprint::Indent(indent + 1) << "uniform token axis = " << axis << "\n";
   }
 
-  ss << print_gprim_predefined(geom, indent + 1);
-  ss << print_props(geom.props, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
+  print_props(ss, geom.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomCylinder &geom, const uint32_t indent,
+std::string to_string(const GeomCone &geom, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomCylinder &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " Cylinder \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(geom.radius, "radius", indent + 1);
-  ss << print_typed_attr(geom.height, "height", indent + 1);
+  print_typed_attr(ss, geom.radius, "radius", indent + 1);
+  print_typed_attr(ss, geom.height, "height", indent + 1);
 
   if (geom.axis.authored()) {
     std::string axis;
@@ -3453,31 +3598,34 @@ std::string to_string(const GeomCylinder &geom, const uint32_t indent,
     ss << pprint::Indent(indent + 1) << "uniform token axis = " << axis << "\n";
   }
 
-  ss << print_gprim_predefined(geom, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const GeomCapsule &geom, const uint32_t indent,
+std::string to_string(const GeomCylinder &geom, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const GeomCapsule &geom,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(geom.spec) << " Capsule \""
      << geom.name << "\"\n";
   if (geom.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(geom.meta, indent + 1);
+    print_prim_metas(ss, geom.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(geom.radius, "radius", indent + 1);
-  ss << print_typed_attr(geom.height, "height", indent + 1);
+  print_typed_attr(ss, geom.radius, "radius", indent + 1);
+  print_typed_attr(ss, geom.height, "height", indent + 1);
 
   if (geom.axis.authored()) {
     std::string axis;
@@ -3491,25 +3639,28 @@ std::string to_string(const GeomCapsule &geom, const uint32_t indent,
     ss << pprint::Indent(indent + 1) << "uniform token axis = " << axis << "\n";
   }
 
-  ss << print_gprim_predefined(geom, indent + 1);
-  ss << print_props(geom.props, indent + 1);
+  print_gprim_predefined(ss, geom, indent + 1);
+  print_props(ss, geom.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const PointInstancer &instancer, const uint32_t indent,
+std::string to_string(const GeomCapsule &geom, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, geom, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const PointInstancer &instancer,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(instancer.spec)
      << " PointInstancer \"" << instancer.name << "\"\n";
   if (instancer.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(instancer.meta, indent + 1);
+    print_prim_metas(ss, instancer.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
@@ -3520,44 +3671,47 @@ std::string to_string(const PointInstancer &instancer, const uint32_t indent,
                              instancer.prototypes.value().get_listedit_qual(),
                              /* custom */ false, "prototypes", indent + 1);
   }
-  ss << print_typed_attr(instancer.protoIndices, "protoIndices", indent + 1);
-  ss << print_typed_attr(instancer.ids, "ids", indent + 1);
-  ss << print_typed_attr(instancer.invisibleIds, "invisibleIds", indent + 1);
-  ss << print_typed_attr(instancer.positions, "positions", indent + 1);
-  ss << print_typed_attr(instancer.orientations, "orientations", indent + 1);
-  ss << print_typed_attr(instancer.scales, "scales", indent + 1);
-  ss << print_typed_attr(instancer.velocities, "velocities", indent + 1);
-  ss << print_typed_attr(instancer.accelerations, "accelerations", indent + 1);
-  ss << print_typed_attr(instancer.angularVelocities, "angularVelocities",
-                         indent + 1);
+  print_typed_attr(ss, instancer.protoIndices, "protoIndices", indent + 1);
+  print_typed_attr(ss, instancer.ids, "ids", indent + 1);
+  print_typed_attr(ss, instancer.invisibleIds, "invisibleIds", indent + 1);
+  print_typed_attr(ss, instancer.positions, "positions", indent + 1);
+  print_typed_attr(ss, instancer.orientations, "orientations", indent + 1);
+  print_typed_attr(ss, instancer.scales, "scales", indent + 1);
+  print_typed_attr(ss, instancer.velocities, "velocities", indent + 1);
+  print_typed_attr(ss, instancer.accelerations, "accelerations", indent + 1);
+  print_typed_attr(ss, instancer.angularVelocities, "angularVelocities",
+                   indent + 1);
 
-  ss << print_gprim_predefined(instancer, indent + 1);
+  print_gprim_predefined(ss, instancer, indent + 1);
 
-  ss << print_props(instancer.props, indent + 1);
+  print_props(ss, instancer.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const SkelRoot &root, const uint32_t indent,
+std::string to_string(const PointInstancer &instancer, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, instancer, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const SkelRoot &root,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(root.spec) << " SkelRoot \""
      << root.name << "\"\n";
   if (root.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(root.meta, indent + 1);
+    print_prim_metas(ss, root.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_typed_token_attr(root.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(root.purpose, "purpose", indent + 1);
-  ss << print_typed_attr(root.extent, "extent", indent + 1);
+  print_typed_token_attr(ss, root.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, root.purpose, "purpose", indent + 1);
+  print_typed_attr(ss, root.extent, "extent", indent + 1);
 
   if (root.proxyPrim) {
     ss << print_relationship(root.proxyPrim.value(),
@@ -3569,34 +3723,37 @@ std::string to_string(const SkelRoot &root, const uint32_t indent,
   // Skeleton id
   // ss << pprint::Indent(indent) << "skelroot.skeleton_id << "\n"
 
-  ss << print_xformOps(root.xformOps, indent + 1);
+  print_xformOps(ss, root.xformOps, indent + 1);
 
-  ss << print_props(root.props, indent + 1);
+  print_props(ss, root.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const Skeleton &skel, const uint32_t indent,
+std::string to_string(const SkelRoot &root, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, root, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const Skeleton &skel,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(skel.spec) << " Skeleton \""
      << skel.name << "\"\n";
   if (skel.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(skel.meta, indent + 1);
+    print_prim_metas(ss, skel.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_typed_attr(skel.bindTransforms, "bindTransforms", indent + 1);
-  ss << print_typed_attr(skel.jointNames, "jointNames", indent + 1);
-  ss << print_typed_attr(skel.joints, "joints", indent + 1);
-  ss << print_typed_attr(skel.restTransforms, "restTransforms", indent + 1);
+  print_typed_attr(ss, skel.bindTransforms, "bindTransforms", indent + 1);
+  print_typed_attr(ss, skel.jointNames, "jointNames", indent + 1);
+  print_typed_attr(ss, skel.joints, "joints", indent + 1);
+  print_typed_attr(ss, skel.restTransforms, "restTransforms", indent + 1);
 
   if (skel.animationSource) {
     ss << print_relationship(skel.animationSource.value(),
@@ -3611,86 +3768,95 @@ std::string to_string(const Skeleton &skel, const uint32_t indent,
                              /* custom */ false, "proxyPrim", indent + 1);
   }
 
-  ss << print_xformOps(skel.xformOps, indent + 1);
+  print_xformOps(ss, skel.xformOps, indent + 1);
 
-  ss << print_typed_token_attr(skel.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(skel.purpose, "purpose", indent + 1);
-  ss << print_typed_attr(skel.extent, "extent", indent + 1);
+  print_typed_token_attr(ss, skel.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, skel.purpose, "purpose", indent + 1);
+  print_typed_attr(ss, skel.extent, "extent", indent + 1);
 
-  ss << print_props(skel.props, indent + 1);
+  print_props(ss, skel.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const SkelAnimation &skelanim, const uint32_t indent,
+std::string to_string(const Skeleton &skel, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, skel, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const SkelAnimation &skelanim,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(skelanim.spec)
      << " SkelAnimation \"" << skelanim.name << "\"\n";
   if (skelanim.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(skelanim.meta, indent + 1);
+    print_prim_metas(ss, skelanim.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_typed_attr(skelanim.blendShapes, "blendShapes", indent + 1);
-  ss << print_typed_attr(skelanim.blendShapeWeights, "blendShapeWeights",
-                         indent + 1);
-  ss << print_typed_attr(skelanim.joints, "joints", indent + 1);
-  ss << print_typed_attr(skelanim.rotations, "rotations", indent + 1);
-  ss << print_typed_attr(skelanim.scales, "scales", indent + 1);
-  ss << print_typed_attr(skelanim.translations, "translations", indent + 1);
+  print_typed_attr(ss, skelanim.blendShapes, "blendShapes", indent + 1);
+  print_typed_attr(ss, skelanim.blendShapeWeights, "blendShapeWeights",
+                   indent + 1);
+  print_typed_attr(ss, skelanim.joints, "joints", indent + 1);
+  print_typed_attr(ss, skelanim.rotations, "rotations", indent + 1);
+  print_typed_attr(ss, skelanim.scales, "scales", indent + 1);
+  print_typed_attr(ss, skelanim.translations, "translations", indent + 1);
 
-  ss << print_props(skelanim.props, indent + 1);
+  print_props(ss, skelanim.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const BlendShape &prim, const uint32_t indent,
+std::string to_string(const SkelAnimation &skelanim, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, skelanim, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const BlendShape &prim,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(prim.spec) << " BlendShape \""
      << prim.name << "\"\n";
   if (prim.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(prim.meta, indent + 1);
+    print_prim_metas(ss, prim.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
-  ss << print_typed_attr(prim.offsets, "offsets", indent + 1);
-  ss << print_typed_attr(prim.normalOffsets, "normalOffsets", indent + 1);
-  ss << print_typed_attr(prim.pointIndices, "pointIndices", indent + 1);
+  print_typed_attr(ss, prim.offsets, "offsets", indent + 1);
+  print_typed_attr(ss, prim.normalOffsets, "normalOffsets", indent + 1);
+  print_typed_attr(ss, prim.pointIndices, "pointIndices", indent + 1);
 
-  ss << print_props(prim.props, indent + 1);
+  print_props(ss, prim.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const Material &material, const uint32_t indent,
+std::string to_string(const BlendShape &prim, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, prim, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const Material &material,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(material.spec) << " Material \""
      << material.name << "\"\n";
   if (material.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(material.meta, indent + 1);
+    print_prim_metas(ss, material.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
@@ -3715,9 +3881,9 @@ std::string to_string(const Material &material, const uint32_t indent,
     }
 
     if (material.surface.metas().authored()) {
-      ss << "(\n"
-         << print_attr_metas(material.surface.metas(), indent + 2)
-         << pprint::Indent(indent + 1) << ")";
+      ss << "(\n";
+      print_attr_metas(ss, material.surface.metas(), indent + 2);
+      ss << pprint::Indent(indent + 1) << ")";
     }
     ss << "\n";
   }
@@ -3742,9 +3908,9 @@ std::string to_string(const Material &material, const uint32_t indent,
     }
 
     if (material.displacement.metas().authored()) {
-      ss << "(\n"
-         << print_attr_metas(material.displacement.metas(), indent + 2)
-         << pprint::Indent(indent + 1) << ")";
+      ss << "(\n";
+      print_attr_metas(ss, material.displacement.metas(), indent + 2);
+      ss << pprint::Indent(indent + 1) << ")";
     }
     ss << "\n";
   }
@@ -3769,234 +3935,215 @@ std::string to_string(const Material &material, const uint32_t indent,
     }
 
     if (material.volume.metas().authored()) {
-      ss << "(\n"
-         << print_attr_metas(material.volume.metas(), indent + 2)
-         << pprint::Indent(indent + 1) << ")";
+      ss << "(\n";
+      print_attr_metas(ss, material.volume.metas(), indent + 2);
+      ss << pprint::Indent(indent + 1) << ")";
     }
     ss << "\n";
   }
 
-  ss << print_props(material.props, indent + 1);
+  print_props(ss, material.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-static std::string print_common_shader_params(const ShaderNode &shader,
-                                              const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_props(shader.props, indent);
-
-  return ss.str();
+std::string to_string(const Material &material, const uint32_t indent,
+                      bool closing_brace) {
+  TextSink ss;
+  print_prim_data(ss, material, indent, closing_brace);
+  return ss.take();
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_float &shader,
+static void print_common_shader_params(TextSink &ss, const ShaderNode &shader,
                                        const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
-
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  print_props(ss, shader.props, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_float2 &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_float &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
-
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_float3 &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_float2 &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
-
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_float4 &shader,
+static std::string print_shader_params(const UsdPrimvarReader_float2 &shader,
                                        const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
-
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  TextSink ss;
+  print_shader_params(ss, shader, indent);
+  return ss.take();
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_string &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_float3 &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_normal &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_float4 &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_vector &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_string &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
+  print_common_shader_params(ss, shader, indent);
+}
 
-  ss << print_common_shader_params(shader, indent);
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_normal &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_point &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_vector &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
+  print_common_shader_params(ss, shader, indent);
+}
 
-  ss << print_common_shader_params(shader, indent);
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_point &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdPrimvarReader_matrix &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
+static void print_shader_params(TextSink &ss,
+                                const UsdPrimvarReader_matrix &shader,
+                                const uint32_t indent) {
+  print_str_attr(ss, shader.varname, "inputs:varname", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  ss << print_str_attr(shader.varname, "inputs:varname", indent);
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
+  print_common_shader_params(ss, shader, indent);
+}
 
-  ss << print_common_shader_params(shader, indent);
+static void print_shader_params(TextSink &ss, const UsdTransform2d &shader,
+                                const uint32_t indent) {
+  print_typed_attr(ss, shader.in, "inputs:in", indent);
+  print_typed_attr(ss, shader.rotation, "inputs:rotation", indent);
+  print_typed_attr(ss, shader.scale, "inputs:scale", indent);
+  print_typed_attr(ss, shader.translation, "inputs:translation", indent);
+  print_typed_terminal_attr(ss, shader.result, "outputs:result", indent);
 
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-static std::string print_shader_params(const UsdTransform2d &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
+static void print_shader_params(TextSink &ss, const UsdPreviewSurface &shader,
+                                const uint32_t indent) {
+  print_typed_attr(ss, shader.diffuseColor, "inputs:diffuseColor", indent);
+  print_typed_attr(ss, shader.emissiveColor, "inputs:emissiveColor", indent);
+  print_typed_attr(ss, shader.useSpecularWorkflow, "inputs:useSpecularWorkflow",
+                   indent);
+  print_typed_attr(ss, shader.ior, "inputs:ior", indent);
+  print_typed_attr(ss, shader.specularColor, "inputs:specularColor", indent);
+  print_typed_attr(ss, shader.metallic, "inputs:metallic", indent);
+  print_typed_attr(ss, shader.clearcoat, "inputs:clearcoat", indent);
+  print_typed_attr(ss, shader.clearcoatRoughness, "inputs:clearcoatRoughness",
+                   indent);
+  print_typed_attr(ss, shader.roughness, "inputs:roughness", indent);
+  print_typed_attr(ss, shader.opacity, "inputs:opacity", indent);
+  print_typed_attr(ss, shader.opacityThreshold, "inputs:opacityThreshold",
+                   indent);
+  print_typed_attr(ss, shader.normal, "inputs:normal", indent);
+  print_typed_attr(ss, shader.displacement, "inputs:displacement", indent);
+  print_typed_attr(ss, shader.occlusion, "inputs:occlusion", indent);
 
-  ss << print_typed_attr(shader.in, "inputs:in", indent);
-  ss << print_typed_attr(shader.rotation, "inputs:rotation", indent);
-  ss << print_typed_attr(shader.scale, "inputs:scale", indent);
-  ss << print_typed_attr(shader.translation, "inputs:translation", indent);
-  ss << print_typed_terminal_attr(shader.result, "outputs:result", indent);
+  print_typed_terminal_attr(ss, shader.outputsSurface, "outputs:surface",
+                            indent);
+  print_typed_terminal_attr(ss, shader.outputsDisplacement,
+                            "outputs:displacement", indent);
 
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
 static std::string print_shader_params(const UsdPreviewSurface &shader,
                                        const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_typed_attr(shader.diffuseColor, "inputs:diffuseColor", indent);
-  ss << print_typed_attr(shader.emissiveColor, "inputs:emissiveColor", indent);
-  ss << print_typed_attr(shader.useSpecularWorkflow,
-                         "inputs:useSpecularWorkflow", indent);
-  ss << print_typed_attr(shader.ior, "inputs:ior", indent);
-  ss << print_typed_attr(shader.specularColor, "inputs:specularColor", indent);
-  ss << print_typed_attr(shader.metallic, "inputs:metallic", indent);
-  ss << print_typed_attr(shader.clearcoat, "inputs:clearcoat", indent);
-  ss << print_typed_attr(shader.clearcoatRoughness, "inputs:clearcoatRoughness",
-                         indent);
-  ss << print_typed_attr(shader.roughness, "inputs:roughness", indent);
-  ss << print_typed_attr(shader.opacity, "inputs:opacity", indent);
-  ss << print_typed_attr(shader.opacityThreshold, "inputs:opacityThreshold",
-                         indent);
-  ss << print_typed_attr(shader.normal, "inputs:normal", indent);
-  ss << print_typed_attr(shader.displacement, "inputs:displacement", indent);
-  ss << print_typed_attr(shader.occlusion, "inputs:occlusion", indent);
-
-  ss << print_typed_terminal_attr(shader.outputsSurface, "outputs:surface",
-                                  indent);
-  ss << print_typed_terminal_attr(shader.outputsDisplacement,
-                                  "outputs:displacement", indent);
-
-  ss << print_common_shader_params(shader, indent);
-
-  return ss.str();
+  TextSink ss;
+  print_shader_params(ss, shader, indent);
+  return ss.take();
 }
 
-static std::string print_shader_params(const UsdUVTexture &shader,
-                                       const uint32_t indent) {
-  std::stringstream ss;
-
-  ss << print_typed_attr(shader.file, "inputs:file", indent);
+static void print_shader_params(TextSink &ss, const UsdUVTexture &shader,
+                                const uint32_t indent) {
+  print_typed_attr(ss, shader.file, "inputs:file", indent);
 
-  ss << print_typed_token_attr(shader.sourceColorSpace,
-                               "inputs:sourceColorSpace", indent);
-
-  ss << print_typed_attr(shader.fallback, "inputs:fallback", indent);
+  print_typed_token_attr(ss, shader.sourceColorSpace, "inputs:sourceColorSpace",
+                         indent);
 
-  ss << print_typed_attr(shader.bias, "inputs:bias", indent);
-  ss << print_typed_attr(shader.scale, "inputs:scale", indent);
+  print_typed_attr(ss, shader.fallback, "inputs:fallback", indent);
 
-  ss << print_typed_attr(shader.st, "inputs:st", indent);
-  ss << print_typed_token_attr(shader.wrapS, "inputs:wrapT", indent);
-  ss << print_typed_token_attr(shader.wrapT, "inputs:wrapS", indent);
+  print_typed_attr(ss, shader.bias, "inputs:bias", indent);
+  print_typed_attr(ss, shader.scale, "inputs:scale", indent);
 
-  ss << print_typed_terminal_attr(shader.outputsR, "outputs:r", indent);
-  ss << print_typed_terminal_attr(shader.outputsG, "outputs:g", indent);
-  ss << print_typed_terminal_attr(shader.outputsB, "outputs:b", indent);
-  ss << print_typed_terminal_attr(shader.outputsA, "outputs:a", indent);
-  ss << print_typed_terminal_attr(shader.outputsRGB, "outputs:rgb", indent);
+  print_typed_attr(ss, shader.st, "inputs:st", indent);
+  print_typed_token_attr(ss, shader.wrapS, "inputs:wrapT", indent);
+  print_typed_token_attr(ss, shader.wrapT, "inputs:wrapS", indent);
 
-  ss << print_common_shader_params(shader, indent);
+  print_typed_terminal_attr(ss, shader.outputsR, "outputs:r", indent);
+  print_typed_terminal_attr(ss, shader.outputsG, "outputs:g", indent);
+  print_typed_terminal_attr(ss, shader.outputsB, "outputs:b", indent);
+  print_typed_terminal_attr(ss, shader.outputsA, "outputs:a", indent);
+  print_typed_terminal_attr(ss, shader.outputsRGB, "outputs:rgb", indent);
 
-  return ss.str();
+  print_common_shader_params(ss, shader, indent);
 }
 
-std::string to_string(const Shader &shader, const uint32_t indent,
-                      bool closing_brace) {
-  // generic Shader class
-  std::stringstream ss;
+static std::string print_shader_params(const UsdUVTexture &shader,
+                                       const uint32_t indent) {
+  TextSink ss;
+  print_shader_params(ss, shader, indent);
+  return ss.take();
+}
 
+// generic Shader class
+static void print_prim_data(TextSink &ss, const Shader &shader,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(shader.spec) << " Shader \""
      << shader.name << "\"\n";
   if (shader.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(shader.metas(), indent + 1);
+    print_prim_metas(ss, shader.metas(), indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
@@ -4008,32 +4155,32 @@ std::string to_string(const Shader &shader, const uint32_t indent,
   }
 
   if (auto pvr = shader.value.get_value<UsdPrimvarReader_float>()) {
-    ss << print_shader_params(pvr.value(), indent + 1);
+    print_shader_params(ss, pvr.value(), indent + 1);
   } else if (auto pvr2 = shader.value.get_value<UsdPrimvarReader_float2>()) {
-    ss << print_shader_params(pvr2.value(), indent + 1);
+    print_shader_params(ss, pvr2.value(), indent + 1);
   } else if (auto pvr3 = shader.value.get_value<UsdPrimvarReader_float3>()) {
-    ss << print_shader_params(pvr3.value(), indent + 1);
+    print_shader_params(ss, pvr3.value(), indent + 1);
   } else if (auto pvr4 = shader.value.get_value<UsdPrimvarReader_float4>()) {
-    ss << print_shader_params(pvr4.value(), indent + 1);
+    print_shader_params(ss, pvr4.value(), indent + 1);
   } else if (auto pvrs = shader.value.get_value<UsdPrimvarReader_string>()) {
-    ss << print_shader_params(pvrs.value(), indent + 1);
+    print_shader_params(ss, pvrs.value(), indent + 1);
   } else if (auto pvrn = shader.value.get_value<UsdPrimvarReader_normal>()) {
-    ss << print_shader_params(pvrn.value(), indent + 1);
+    print_shader_params(ss, pvrn.value(), indent + 1);
   } else if (auto pvrv = shader.value.get_value<UsdPrimvarReader_vector>()) {
-    ss << print_shader_params(pvrv.value(), indent + 1);
+    print_shader_params(ss, pvrv.value(), indent + 1);
   } else if (auto pvrp = shader.value.get_value<UsdPrimvarReader_point>()) {
-    ss << print_shader_params(pvrp.value(), indent + 1);
+    print_shader_params(ss, pvrp.value(), indent + 1);
   } else if (auto pvrm = shader.value.get_value<UsdPrimvarReader_matrix>()) {
-    ss << print_shader_params(pvrm.value(), indent + 1);
+    print_shader_params(ss, pvrm.value(), indent + 1);
   } else if (auto pvtex = shader.value.get_value<UsdUVTexture>()) {
-    ss << print_shader_params(pvtex.value(), indent + 1);
+    print_shader_params(ss, pvtex.value(), indent + 1);
   } else if (auto pvtx2d = shader.value.get_value<UsdTransform2d>()) {
-    ss << print_shader_params(pvtx2d.value(), indent + 1);
+    print_shader_params(ss, pvtx2d.value(), indent + 1);
   } else if (auto pvs = shader.value.get_value<UsdPreviewSurface>()) {
-    ss << print_shader_params(pvs.value(), indent + 1);
+    print_shader_params(ss, pvs.value(), indent + 1);
   } else if (auto pvsn = shader.value.get_value<ShaderNode>()) {
     // Generic ShaderNode
-    ss << print_common_shader_params(pvsn.value(), indent + 1);
+    print_common_shader_params(ss, pvsn.value(), indent + 1);
   } else {
     ss << pprint::Indent(indent + 1)
        << "[???] Invalid ShaderNode in Shader Prim\n";
@@ -4042,8 +4189,13 @@ std::string to_string(const Shader &shader, const uint32_t indent,
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
+}
 
-  return ss.str();
+std::string to_string(const Shader &shader, const uint32_t indent,
+                      bool closing_brace) {
+  TextSink ss;
+  print_prim_data(ss, shader, indent, closing_brace);
+  return ss.take();
 }
 
 std::string to_string(const UsdPreviewSurface &surf, const uint32_t indent,
@@ -4088,258 +4240,276 @@ std::string to_string(const UsdPrimvarReader_float2 &preader,
   return ss.str();
 }
 
-std::string to_string(const SphereLight &light, const uint32_t indent,
-                      bool closing_brace) {
-  std::stringstream ss;
-
+static void print_prim_data(TextSink &ss, const SphereLight &light,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(light.spec) << " SphereLight \""
      << light.name << "\"\n";
   if (light.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(light.meta, indent + 1);
+    print_prim_metas(ss, light.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(light.color, "inputs:color", indent + 1);
-  ss << print_typed_attr(light.colorTemperature, "inputs:colorTemperature",
-                         indent + 1);
-  ss << print_typed_attr(light.diffuse, "inputs:diffuse", indent + 1);
-  ss << print_typed_attr(light.enableColorTemperature,
-                         "inputs:enableColorTemperature", indent + 1);
-  ss << print_typed_attr(light.exposure, "inputs:exposure", indent + 1);
-  ss << print_typed_attr(light.intensity, "inputs:intensity", indent + 1);
-  ss << print_typed_attr(light.normalize, "inputs:normalize", indent + 1);
-  ss << print_typed_attr(light.specular, "inputs:specular", indent + 1);
-
-  ss << print_typed_attr(light.radius, "inputs:radius", indent + 1);
-
-  ss << print_typed_attr(light.extent, "extent", indent + 1);
-  ss << print_typed_token_attr(light.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(light.purpose, "purpose", indent + 1);
-
-  ss << print_xformOps(light.xformOps, indent + 1);
-  ss << print_props(light.props, indent + 1);
+  print_typed_attr(ss, light.color, "inputs:color", indent + 1);
+  print_typed_attr(ss, light.colorTemperature, "inputs:colorTemperature",
+                   indent + 1);
+  print_typed_attr(ss, light.diffuse, "inputs:diffuse", indent + 1);
+  print_typed_attr(ss, light.enableColorTemperature,
+                   "inputs:enableColorTemperature", indent + 1);
+  print_typed_attr(ss, light.exposure, "inputs:exposure", indent + 1);
+  print_typed_attr(ss, light.intensity, "inputs:intensity", indent + 1);
+  print_typed_attr(ss, light.normalize, "inputs:normalize", indent + 1);
+  print_typed_attr(ss, light.specular, "inputs:specular", indent + 1);
+
+  print_typed_attr(ss, light.radius, "inputs:radius", indent + 1);
+
+  print_typed_attr(ss, light.extent, "extent", indent + 1);
+  print_typed_token_attr(ss, light.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, light.purpose, "purpose", indent + 1);
+
+  print_xformOps(ss, light.xformOps, indent + 1);
+  print_props(ss, light.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const DistantLight &light, const uint32_t indent,
+std::string to_string(const SphereLight &light, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, light, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const DistantLight &light,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(light.spec) << " DistantLight \""
      << light.name << "\"\n";
   if (light.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(light.meta, indent + 1);
+    print_prim_metas(ss, light.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(light.color, "inputs:color", indent + 1);
-  ss << print_typed_attr(light.colorTemperature, "inputs:colorTemperature",
-                         indent + 1);
-  ss << print_typed_attr(light.diffuse, "inputs:diffuse", indent + 1);
-  ss << print_typed_attr(light.enableColorTemperature,
-                         "inputs:enableColorTemperature", indent + 1);
-  ss << print_typed_attr(light.exposure, "inputs:exposure", indent + 1);
-  ss << print_typed_attr(light.intensity, "inputs:intensity", indent + 1);
-  ss << print_typed_attr(light.normalize, "inputs:normalize", indent + 1);
-  ss << print_typed_attr(light.specular, "inputs:specular", indent + 1);
-
-  ss << print_typed_attr(light.angle, "inputs:angle", indent + 1);
+  print_typed_attr(ss, light.color, "inputs:color", indent + 1);
+  print_typed_attr(ss, light.colorTemperature, "inputs:colorTemperature",
+                   indent + 1);
+  print_typed_attr(ss, light.diffuse, "inputs:diffuse", indent + 1);
+  print_typed_attr(ss, light.enableColorTemperature,
+                   "inputs:enableColorTemperature", indent + 1);
+  print_typed_attr(ss, light.exposure, "inputs:exposure", indent + 1);
+  print_typed_attr(ss, light.intensity, "inputs:intensity", indent + 1);
+  print_typed_attr(ss, light.normalize, "inputs:normalize", indent + 1);
+  print_typed_attr(ss, light.specular, "inputs:specular", indent + 1);
+
+  print_typed_attr(ss, light.angle, "inputs:angle", indent + 1);
 
   //ss << print_typed_attr(light.extent, "extent", indent + 1);
-  ss << print_typed_token_attr(light.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(light.purpose, "purpose", indent + 1);
+  print_typed_token_attr(ss, light.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, light.purpose, "purpose", indent + 1);
 
-  ss << print_xformOps(light.xformOps, indent + 1);
-  ss << print_props(light.props, indent + 1);
+  print_xformOps(ss, light.xformOps, indent + 1);
+  print_props(ss, light.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const CylinderLight &light, const uint32_t indent,
+std::string to_string(const DistantLight &light, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, light, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const CylinderLight &light,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(light.spec) << " CylinderLight \""
      << light.name << "\"\n";
   if (light.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(light.meta, indent + 1);
+    print_prim_metas(ss, light.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(light.color, "inputs:color", indent + 1);
-  ss << print_typed_attr(light.colorTemperature, "inputs:colorTemperature",
-                         indent + 1);
-  ss << print_typed_attr(light.diffuse, "inputs:diffuse", indent + 1);
-  ss << print_typed_attr(light.enableColorTemperature,
-                         "inputs:enableColorTemperature", indent + 1);
-  ss << print_typed_attr(light.exposure, "inputs:exposure", indent + 1);
-  ss << print_typed_attr(light.intensity, "inputs:intensity", indent + 1);
-  ss << print_typed_attr(light.normalize, "inputs:normalize", indent + 1);
-  ss << print_typed_attr(light.specular, "inputs:specular", indent + 1);
-
-  ss << print_typed_attr(light.length, "inputs:length", indent + 1);
-  ss << print_typed_attr(light.radius, "inputs:radius", indent + 1);
-
-  ss << print_typed_attr(light.extent, "extent", indent + 1);
-  ss << print_typed_token_attr(light.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(light.purpose, "purpose", indent + 1);
-
-  ss << print_xformOps(light.xformOps, indent + 1);
-  ss << print_props(light.props, indent + 1);
+  print_typed_attr(ss, light.color, "inputs:color", indent + 1);
+  print_typed_attr(ss, light.colorTemperature, "inputs:colorTemperature",
+                   indent + 1);
+  print_typed_attr(ss, light.diffuse, "inputs:diffuse", indent + 1);
+  print_typed_attr(ss, light.enableColorTemperature,
+                   "inputs:enableColorTemperature", indent + 1);
+  print_typed_attr(ss, light.exposure, "inputs:exposure", indent + 1);
+  print_typed_attr(ss, light.intensity, "inputs:intensity", indent + 1);
+  print_typed_attr(ss, light.normalize, "inputs:normalize", indent + 1);
+  print_typed_attr(ss, light.specular, "inputs:specular", indent + 1);
+
+  print_typed_attr(ss, light.length, "inputs:length", indent + 1);
+  print_typed_attr(ss, light.radius, "inputs:radius", indent + 1);
+
+  print_typed_attr(ss, light.extent, "extent", indent + 1);
+  print_typed_token_attr(ss, light.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, light.purpose, "purpose", indent + 1);
+
+  print_xformOps(ss, light.xformOps, indent + 1);
+  print_props(ss, light.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const DiskLight &light, const uint32_t indent,
+std::string to_string(const CylinderLight &light, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, light, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const DiskLight &light,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(light.spec) << " DiskLight \""
      << light.name << "\"\n";
   if (light.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(light.meta, indent + 1);
+    print_prim_metas(ss, light.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(light.color, "inputs:color", indent + 1);
-  ss << print_typed_attr(light.colorTemperature, "inputs:colorTemperature",
-                         indent + 1);
-  ss << print_typed_attr(light.diffuse, "inputs:diffuse", indent + 1);
-  ss << print_typed_attr(light.enableColorTemperature,
-                         "inputs:enableColorTemperature", indent + 1);
-  ss << print_typed_attr(light.exposure, "inputs:exposure", indent + 1);
-  ss << print_typed_attr(light.intensity, "inputs:intensity", indent + 1);
-  ss << print_typed_attr(light.normalize, "inputs:normalize", indent + 1);
-  ss << print_typed_attr(light.specular, "inputs:specular", indent + 1);
-
-  ss << print_typed_attr(light.radius, "inputs:radius", indent + 1);
-
-  ss << print_typed_attr(light.extent, "extent", indent + 1);
-  ss << print_typed_token_attr(light.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(light.purpose, "purpose", indent + 1);
-
-  ss << print_xformOps(light.xformOps, indent + 1);
-  ss << print_props(light.props, indent + 1);
+  print_typed_attr(ss, light.color, "inputs:color", indent + 1);
+  print_typed_attr(ss, light.colorTemperature, "inputs:colorTemperature",
+                   indent + 1);
+  print_typed_attr(ss, light.diffuse, "inputs:diffuse", indent + 1);
+  print_typed_attr(ss, light.enableColorTemperature,
+                   "inputs:enableColorTemperature", indent + 1);
+  print_typed_attr(ss, light.exposure, "inputs:exposure", indent + 1);
+  print_typed_attr(ss, light.intensity, "inputs:intensity", indent + 1);
+  print_typed_attr(ss, light.normalize, "inputs:normalize", indent + 1);
+  print_typed_attr(ss, light.specular, "inputs:specular", indent + 1);
+
+  print_typed_attr(ss, light.radius, "inputs:radius", indent + 1);
+
+  print_typed_attr(ss, light.extent, "extent", indent + 1);
+  print_typed_token_attr(ss, light.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, light.purpose, "purpose", indent + 1);
+
+  print_xformOps(ss, light.xformOps, indent + 1);
+  print_props(ss, light.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const DomeLight &light, const uint32_t indent,
+std::string to_string(const DiskLight &light, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, light, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const DomeLight &light,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(light.spec) << " DomeLight \""
      << light.name << "\"\n";
   if (light.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(light.meta, indent + 1);
+    print_prim_metas(ss, light.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(light.color, "inputs:color", indent + 1);
-  ss << print_typed_attr(light.colorTemperature, "inputs:colorTemperature",
+  print_typed_attr(ss, light.color, "inputs:color", indent + 1);
+  print_typed_attr(ss, light.colorTemperature, "inputs:colorTemperature",
+                   indent + 1);
+  print_typed_attr(ss, light.diffuse, "inputs:diffuse", indent + 1);
+  print_typed_attr(ss, light.enableColorTemperature,
+                   "inputs:enableColorTemperature", indent + 1);
+  print_typed_attr(ss, light.exposure, "inputs:exposure", indent + 1);
+  print_typed_attr(ss, light.intensity, "inputs:intensity", indent + 1);
+  print_typed_attr(ss, light.normalize, "inputs:normalize", indent + 1);
+  print_typed_attr(ss, light.specular, "inputs:specular", indent + 1);
+
+  print_typed_attr(ss, light.guideRadius, "inputs:guideRadius", indent + 1);
+  print_typed_attr(ss, light.file, "inputs:file", indent + 1);
+  print_typed_token_attr(ss, light.textureFormat, "inputs:textureFormat",
                          indent + 1);
-  ss << print_typed_attr(light.diffuse, "inputs:diffuse", indent + 1);
-  ss << print_typed_attr(light.enableColorTemperature,
-                         "inputs:enableColorTemperature", indent + 1);
-  ss << print_typed_attr(light.exposure, "inputs:exposure", indent + 1);
-  ss << print_typed_attr(light.intensity, "inputs:intensity", indent + 1);
-  ss << print_typed_attr(light.normalize, "inputs:normalize", indent + 1);
-  ss << print_typed_attr(light.specular, "inputs:specular", indent + 1);
-
-  ss << print_typed_attr(light.guideRadius, "inputs:guideRadius", indent + 1);
-  ss << print_typed_attr(light.file, "inputs:file", indent + 1);
-  ss << print_typed_token_attr(light.textureFormat, "inputs:textureFormat",
-                               indent + 1);
 
   //ss << print_typed_attr(light.extent, "extent", indent + 1);
-  ss << print_typed_token_attr(light.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(light.purpose, "purpose", indent + 1);
+  print_typed_token_attr(ss, light.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, light.purpose, "purpose", indent + 1);
 
-  ss << print_xformOps(light.xformOps, indent + 1);
+  print_xformOps(ss, light.xformOps, indent + 1);
 
-  ss << print_props(light.props, indent + 1);
+  print_props(ss, light.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
-
-  return ss.str();
 }
 
-std::string to_string(const RectLight &light, const uint32_t indent,
+std::string to_string(const DomeLight &light, const uint32_t indent,
                       bool closing_brace) {
-  std::stringstream ss;
+  TextSink ss;
+  print_prim_data(ss, light, indent, closing_brace);
+  return ss.take();
+}
 
+static void print_prim_data(TextSink &ss, const RectLight &light,
+                            const uint32_t indent, bool closing_brace) {
   ss << pprint::Indent(indent) << to_string(light.spec) << " RectLight \""
      << light.name << "\"\n";
   if (light.meta.authored()) {
     ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(light.meta, indent + 1);
+    print_prim_metas(ss, light.meta, indent + 1);
     ss << pprint::Indent(indent) << ")\n";
   }
   ss << pprint::Indent(indent) << "{\n";
 
   // members
-  ss << print_typed_attr(light.color, "inputs:color", indent + 1);
-  ss << print_typed_attr(light.colorTemperature, "inputs:colorTemperature",
-                         indent + 1);
-  ss << print_typed_attr(light.diffuse, "inputs:diffuse", indent + 1);
-  ss << print_typed_attr(light.enableColorTemperature,
-                         "inputs:enableColorTemperature", indent + 1);
-  ss << print_typed_attr(light.exposure, "inputs:exposure", indent + 1);
-  ss << print_typed_attr(light.intensity, "inputs:intensity", indent + 1);
-  ss << print_typed_attr(light.normalize, "inputs:normalize", indent + 1);
-  ss << print_typed_attr(light.specular, "inputs:specular", indent + 1);
-
-  ss << print_typed_attr(light.file, "inputs:file", indent + 1);
-  ss << print_typed_attr(light.height, "inputs:height", indent + 1);
-  ss << print_typed_attr(light.width, "inputs:width", indent + 1);
-  ss << print_typed_attr(light.height, "inputs:height", indent + 1);
-
-  ss << print_typed_attr(light.extent, "extent", indent + 1);
-  ss << print_typed_token_attr(light.visibility, "visibility", indent + 1);
-  ss << print_typed_token_attr(light.purpose, "purpose", indent + 1);
-
-  ss << print_xformOps(light.xformOps, indent + 1);
-  ss << print_props(light.props, indent + 1);
+  print_typed_attr(ss, light.color, "inputs:color", indent + 1);
+  print_typed_attr(ss, light.colorTemperature, "inputs:colorTemperature",
+                   indent + 1);
+  print_typed_attr(ss, light.diffuse, "inputs:diffuse", indent + 1);
+  print_typed_attr(ss, light.enableColorTemperature,
+                   "inputs:enableColorTemperature", indent + 1);
+  print_typed_attr(ss, light.exposure, "inputs:exposure", indent + 1);
+  print_typed_attr(ss, light.intensity, "inputs:intensity", indent + 1);
+  print_typed_attr(ss, light.normalize, "inputs:normalize", indent + 1);
+  print_typed_attr(ss, light.specular, "inputs:specular", indent + 1);
+
+  print_typed_attr(ss, light.file, "inputs:file", indent + 1);
+  print_typed_attr(ss, light.height, "inputs:height", indent + 1);
+  print_typed_attr(ss, light.width, "inputs:width", indent + 1);
+  print_typed_attr(ss, light.height, "inputs:height", indent + 1);
+
+  print_typed_attr(ss, light.extent, "extent", indent + 1);
+  print_typed_token_attr(ss, light.visibility, "visibility", indent + 1);
+  print_typed_token_attr(ss, light.purpose, "purpose", indent + 1);
+
+  print_xformOps(ss, light.xformOps, indent + 1);
+  print_props(ss, light.props, indent + 1);
 
   if (closing_brace) {
     ss << pprint::Indent(indent) << "}\n";
   }
+}
 
-  return ss.str();
+std::string to_string(const RectLight &light, const uint32_t indent,
+                      bool closing_brace) {
+  TextSink ss;
+  print_prim_data(ss, light, indent, closing_brace);
+  return ss.take();
 }
 
 std::string to_string(const GeomCamera::Projection &proj) {
@@ -4574,22 +4744,20 @@ std::string print_layer_metas(const LayerMetas &metas, const uint32_t indent) {
   return meta_ss.str();
 }
 
-std::string print_layer(const Layer &layer, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_layer(TextSink &w, const Layer &layer, const uint32_t indent) {
   // FIXME: print magic-header outside of this function?
-  ss << pprint::Indent(indent) << "#usda 1.0\n";
+  pprint::WriteIndent(w, indent);
+  w << "#usda 1.0\n";
 
-  std::stringstream meta_ss;
-  meta_ss << print_layer_metas(layer.metas(), indent + 1);
+  std::string meta_str = print_layer_metas(layer.metas(), indent + 1);
 
-  if (meta_ss.str().size()) {
-    ss << "(\n";
-    ss << meta_ss.str();
-    ss << ")\n";
+  if (meta_str.size()) {
+    w << "(\n";
+    w << meta_str;
+    w << ")\n";
   }
 
-  ss << "\n";
+  w << "\n";
 
   if (layer.metas().primChildren.size() == layer.primspecs().size()) {
     std::map<std::string, const PrimSpec *> primNameTable;
@@ -4603,9 +4771,9 @@ std::string print_layer(const Layer &layer, const uint32_t indent) {
       //                   layer.metas().primChildren.size(), nameTok.str()));
       const auto it = primNameTable.find(nameTok.str());
       if (it != primNameTable.end()) {
-        ss << prim::print_primspec((*it->second), indent);
+        prim::print_primspec(w, (*it->second), indent);
         if (i != (layer.metas().primChildren.size() - 1)) {
-          ss << "\n";
+          w << "\n";
         }
       } else {
         // TODO: Report warning?
@@ -4614,46 +4782,89 @@ std::string print_layer(const Layer &layer, const uint32_t indent) {
   } else {
     size_t i = 0;
     for (const auto &item : layer.primspecs()) {
-      ss << prim::print_primspec(item.second, indent);
+      prim::print_primspec(w, item.second, indent);
       if (i != (layer.primspecs().size() - 1)) {
-        ss << "\n";
+        w << "\n";
       }
+      i++;
     }
   }
+}
 
-  return ss.str();
+std::string print_layer(const Layer &layer, const uint32_t indent) {
+  TextSink w;
+  print_layer(w, layer, indent);
+  return w.take();
+}
+
+// Print concrete Prim data in `v` to `ss`(same output as `pprint_value`).
+static void print_prim_data(TextSink &ss, const value::Value &v,
+                            const uint32_t indent, bool closing_brace) {
+#define PRIM_DATA_CASE(__ty)                              \
+  case value::TypeTraits<__ty>::type_id(): {              \
+    if (auto p = v.as<__ty>()) {                          \
+      print_prim_data(ss, *p, indent, closing_brace);     \
+      return;                                             \
+    }                                                     \
+    break;                                                \
+  }
+
+  switch (v.type_id()) {
+    PRIM_DATA_CASE(Model)
+    PRIM_DATA_CASE(Scope)
+    PRIM_DATA_CASE(Xform)
+    PRIM_DATA_CASE(GeomMesh)
+    PRIM_DATA_CASE(GeomSphere)
+    PRIM_DATA_CASE(GeomSubset)
+    PRIM_DATA_CASE(GeomPoints)
+    PRIM_DATA_CASE(GeomCube)
+    PRIM_DATA_CASE(GeomCylinder)
+    PRIM_DATA_CASE(GeomCapsule)
+    PRIM_DATA_CASE(GeomCone)
+    PRIM_DATA_CASE(GeomBasisCurves)
+    PRIM_DATA_CASE(GeomNurbsCurves)
+    PRIM_DATA_CASE(GeomCamera)
+    PRIM_DATA_CASE(PointInstancer)
+    PRIM_DATA_CASE(SphereLight)
+    PRIM_DATA_CASE(DomeLight)
+    PRIM_DATA_CASE(DiskLight)
+    PRIM_DATA_CASE(DistantLight)
+    PRIM_DATA_CASE(CylinderLight)
+    PRIM_DATA_CASE(SkelRoot)
+    PRIM_DATA_CASE(Skeleton)
+    PRIM_DATA_CASE(SkelAnimation)
+    PRIM_DATA_CASE(BlendShape)
+    PRIM_DATA_CASE(Material)
+    PRIM_DATA_CASE(Shader)
+    default:
+      break;
+  }
+
+#undef PRIM_DATA_CASE
+
+  value::pprint_value(ss.stream(), v, indent, closing_brace);
 }
 
 // prim-pprint.hh
 namespace prim {
 
-std::string print_prim(const Prim &prim, const uint32_t indent) {
-  std::stringstream ss;
-
+void print_prim(TextSink &w, const Prim &prim, const uint32_t indent) {
   // Currently, Prim's elementName is read from name variable in concrete Prim
   // class(e.g. Xform::name).
   // TODO: use prim.elementPath for elementName.
-  std::string s = pprint_value(prim.data(), indent, /* closing_brace */ false);
-
-  bool require_newline = true;
+  print_prim_data(w, prim.data(), indent, /* closing_brace */ false);
 
   // Check last 2 chars.
   // if it ends with '{\n', no properties are authored so do not emit blank line
   // before printing VariantSet or child Prims.
-  if (s.size() > 2) {
-    if ((s[s.size() - 2] == '{') && (s[s.size() - 1] == '\n')) {
-      require_newline = false;
-    }
-  }
-
-  ss << s;
+  bool require_newline = !w.ends_with('{', '\n');
 
   //
   // print variant
   //
   if (prim.variantSets().size()) {
     if (require_newline) {
-      ss << "\n";
+      w << "\n";
     }
 
     // need to add blank line after VariantSet stmt and before child Prims,
@@ -4661,23 +4872,25 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
     require_newline = true;
 
     for (const auto &variantSet : prim.variantSets()) {
-      ss << pprint::Indent(indent + 1) << "variantSet "
-         << quote(variantSet.first) << " = {\n";
+      pprint::WriteIndent(w, indent + 1);
+      w << "variantSet " << quote(variantSet.first) << " = {\n";
 
       for (const auto &variantItem : variantSet.second.variantSet) {
-        ss << pprint::Indent(indent + 2) << quote(variantItem.first);
+        pprint::WriteIndent(w, indent + 2);
+        w << quote(variantItem.first);
 
         const Variant &variant = variantItem.second;
 
         if (variant.metas().authored()) {
-          ss << " (\n";
-          ss << print_prim_metas(variant.metas(), indent + 3);
-          ss << pprint::Indent(indent + 2) << ")";
+          w << " (\n";
+          print_prim_metas(w, variant.metas(), indent + 3);
+          pprint::WriteIndent(w, indent + 2);
+          w << ")";
         }
 
-        ss << " {\n";
+        w << " {\n";
 
-        ss << print_props(variant.properties(), indent + 3);
+        print_props(w, variant.properties(), indent + 3);
 
         if (variant.metas().variantChildren.has_value() &&
             (variant.metas().variantChildren.value().size() ==
@@ -4693,9 +4906,9 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
             value::token nameTok = variant.metas().variantChildren.value()[i];
             const auto it = primNameTable.find(nameTok.str());
             if (it != primNameTable.end()) {
-              ss << print_prim(*(it->second), indent + 3);
+              print_prim(w, *(it->second), indent + 3);
               if (i != (variant.primChildren().size() - 1)) {
-                ss << "\n";
+                w << "\n";
               }
             } else {
               // TODO: Report warning?
@@ -4704,17 +4917,19 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
 
         } else {
           for (size_t i = 0; i < variant.primChildren().size(); i++) {
-            ss << print_prim(variant.primChildren()[i], indent + 3);
+            print_prim(w, variant.primChildren()[i], indent + 3);
             if (i != (variant.primChildren().size() - 1)) {
-              ss << "\n";
+              w << "\n";
             }
           }
         }
 
-        ss << pprint::Indent(indent + 2) << "}\n";
+        pprint::WriteIndent(w, indent + 2);
+        w << "}\n";
       }
 
-      ss << pprint::Indent(indent + 1) << "}\n";
+      pprint::WriteIndent(w, indent + 1);
+      w << "}\n";
     }
   }
 
@@ -4723,7 +4938,7 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
   //
   if (prim.children().size()) {
     if (require_newline) {
-      ss << "\n";
+      w << "\n";
       require_newline = false;
     }
     if (prim.metas().primChildren.size() == prim.children().size()) {
@@ -4737,14 +4952,14 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
 
       for (size_t i = 0; i < prim.metas().primChildren.size(); i++) {
         if (i > 0) {
-          ss << "\n";
+          w << "\n";
         }
         value::token nameTok = prim.metas().primChildren[i];
         DCOUT(fmt::format("primChildren  {}/{} = {}", i,
                           prim.metas().primChildren.size(), nameTok.str()));
         const auto it = primNameTable.find(nameTok.str());
         if (it != primNameTable.end()) {
-          ss << print_prim(*(it->second), indent + 1);
+          print_prim(w, *(it->second), indent + 1);
         } else {
           // TODO: Report warning?
         }
@@ -4753,53 +4968,67 @@ std::string print_prim(const Prim &prim, const uint32_t indent) {
     } else {
       for (size_t i = 0; i < prim.children().size(); i++) {
         if (i > 0) {
-          ss << "\n";
+          w << "\n";
         }
-        ss << print_prim(prim.children()[i], indent + 1);
+        print_prim(w, prim.children()[i], indent + 1);
       }
     }
   }
 
-  ss << pprint::Indent(indent) << "}\n";
-
-  return ss.str();
+  pprint::WriteIndent(w, indent);
+  w << "}\n";
 }
 
-std::string print_primspec(const PrimSpec &primspec, const uint32_t indent) {
-  std::stringstream ss;
+std::string print_prim(const Prim &prim, const uint32_t indent) {
+  TextSink w;
+  print_prim(w, prim, indent);
+  return w.take();
+}
 
-  ss << pprint::Indent(indent) << to_string(primspec.specifier()) << " ";
+void print_primspec(TextSink &w, const PrimSpec &primspec,
+                    const uint32_t indent) {
+  pprint::WriteIndent(w, indent);
+  w << to_string(primspec.specifier()) << " ";
   if (primspec.typeName().empty() || primspec.typeName() == "Model") {
     // do not emit typeName
   } else {
-    ss << primspec.typeName() << " ";
+    w << primspec.typeName() << " ";
   }
 
-  ss << "\"" << primspec.name() << "\"\n";
+  w << "\"" << primspec.name() << "\"\n";
 
   if (primspec.metas().authored()) {
-    ss << pprint::Indent(indent) << "(\n";
-    ss << print_prim_metas(primspec.metas(), indent + 1);
-    ss << pprint::Indent(indent) << ")\n";
+    pprint::WriteIndent(w, indent);
+    w << "(\n";
+    print_prim_metas(w, primspec.metas(), indent + 1);
+    pprint::WriteIndent(w, indent);
+    w << ")\n";
   }
-  ss << pprint::Indent(indent) << "{\n";
+  pprint::WriteIndent(w, indent);
+  w << "{\n";
 
-  ss << print_props(primspec.props(), indent + 1);
+  print_props(w, primspec.props(), indent + 1);
 
   // TODO: print according to primChildren metadatum
   for (size_t i = 0; i < primspec.children().size(); i++) {
     if (i > 0) {
-      ss << pprint::Indent(indent) << "\n";
+      pprint::WriteIndent(w, indent);
+      w << "\n";
     }
-    ss << print_primspec(primspec.children()[i], indent + 1);
+    print_primspec(w, primspec.children()[i], indent + 1);
   }
 
-  // ss << "# variant \n";
-  ss << print_variantSetSpecStmt(primspec.variantSets(), indent + 1);
+  // w << "# variant \n";
+  print_variantSetSpecStmt(w, primspec.variantSets(), indent + 1);
 
-  ss << pprint::Indent(indent) << "}\n";
+  pprint::WriteIndent(w, indent);
+  w << "}\n";
+}
 
-  return ss.str();
+std::string print_primspec(const PrimSpec &primspec, const uint32_t indent) {
+  TextSink w;
+  print_primspec(w, primspec, indent);
+  return w.take();
 }
 
 }  // namespace prim
@@ -12,6 +12,7 @@
 #include <string>
 
 #include "prim-types.hh"
+#include "text-sink.hh"
 #include "usdGeom.hh"
 #include "usdLux.hh"
 #include "usdShade.hh"
@@ -25,6 +26,9 @@ namespace pprint {
 void SetIndentString(const std::string &s);
 std::string Indent(uint32_t level);
 
+// Write indentation to `w` without creating a temporary string.
+void WriteIndent(TextSink &w, uint32_t level);
+
 }  // namespace pprint
 
 std::string to_string(Visibility v);
@@ -230,34 +234,54 @@ std::string print_xformOpOrder(const std::vector<XformOp> &xformOps,
                                const uint32_t indent);
 std::string print_xformOps(const std::vector<XformOp> &xformOps,
                            const uint32_t indent);
+void print_xformOps(TextSink &ss, const std::vector<XformOp> &xformOps,
+                    const uint32_t indent);
 std::string print_attr_metas(const AttrMeta &meta, const uint32_t indent);
+void print_attr_metas(TextSink &ss, const AttrMeta &meta,
+                      const uint32_t indent);
 
 // varname = optional variable name which is used when meta.get_name() is empty.
 std::string print_meta(const MetaVariable &meta, const uint32_t indent, bool emit_type_name,
                        const std::string &varname = std::string());
 std::string print_prim_metas(const PrimMeta &meta, const uint32_t indent);
+void print_prim_metas(TextSink &ss, const PrimMeta &meta,
+                      const uint32_t indent);
 std::string print_customData(const CustomDataType &customData,
                              const std::string &name, const uint32_t indent);
 std::string print_variantSelectionMap(const VariantSelectionMap &m,
                                       const uint32_t indent);
 std::string print_variantSetStmt(
     const std::map<std::string, VariantSet> &vslist, const uint32_t indent);
+void print_variantSetStmt(TextSink &ss,
+                          const std::map<std::string, VariantSet> &vslist,
+                          const uint32_t indent);
 std::string print_variantSetSpecStmt(
     const std::map<std::string, VariantSetSpec> &vslist, const uint32_t indent);
+void print_variantSetSpecStmt(
+    TextSink &ss, const std::map<std::string, VariantSetSpec> &vslist,
+    const uint32_t indent);
 std::string print_payload(const prim::PayloadList &payload,
                           const uint32_t indent);
 std::string print_timesamples(const value::TimeSamples &v,
                               const uint32_t indent);
+void print_timesamples(TextSink &ss, const value::TimeSamples &v,
+                       const uint32_t indent);
 std::string print_rel_prop(const Property &prop, const std::string &name,
                            uint32_t indent);
+void print_rel_prop(TextSink &ss, const Property &prop,
+                    const std::string &name, uint32_t indent);
 
 std::string print_prop(const Property &prop, const std::string &prop_name,
                        uint32_t indent);
+void print_prop(TextSink &ss, const Property &prop,
+                const std::string &prop_name, uint32_t indent);
 
 // Print properties.
 // TODO: Deprecate this function.
 std::string print_props(const std::map<std::string, Property> &props,
                         uint32_t indent);
+void print_props(TextSink &ss, const std::map<std::string, Property> &props,
+                 uint32_t indent);
 
 // tok_table: Manages property is already printed(built-in props) or not.
 // propNames: Specify the order of property to print
@@ -266,9 +290,13 @@ std::string print_props(const std::map<std::string, Property> &props,
                         /* input */ std::set<std::string> &tok_table,
                         const std::vector<value::token> &propNames,
                         uint32_t indent);
+void print_props(TextSink &ss, const std::map<std::string, Property> &props,
+                 /* input */ std::set<std::string> &tok_table,
+                 const std::vector<value::token> &propNames, uint32_t indent);
 
 std::string print_layer_metas(const LayerMetas &metas, const uint32_t indent);
 std::string print_layer(const Layer &layer, const uint32_t indent);
+void print_layer(TextSink &w, const Layer &layer, const uint32_t indent);
 
 std::string print_material_binding(const MaterialBinding *mb, const uint32_t indent);
 std::string print_collection(const Collection *coll, const uint32_t indent);
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "prim-path-index.hh"
+
+#include <cstring>
+#include <limits>
+
+#include "prim-types.hh"
+
+namespace tinyusdz {
+
+namespace {
+
+constexpr size_t kMinTableSize = 16;
+
+inline uint64_t Mix64(uint64_t x) {
+  // splitmix64 finalizer. Prim ids and node indices are usually sequential,
+  // so scramble bits to avoid long probe sequences.
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+inline size_t HashPrimId(int64_t prim_id) {
+  return size_t(Mix64(uint64_t(prim_id)));
+}
+
+inline size_t HashChild(uint32_t parent, uint32_t name) {
+  return size_t(Mix64((uint64_t(parent) << 32) | uint64_t(name)));
+}
+
+// FNV-1a. Hashes a range of the path string so that path elements can be
+// looked up without allocating a std::string for each element.
+inline size_t HashName(const char *s, size_t len) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < len; i++) {
+    h ^= uint64_t(uint8_t(s[i]));
+    h *= 0x100000001b3ull;
+  }
+  return size_t(h);
+}
+
+}  // namespace
+
+void PrimPathIndex::clear() {
+  _nodes.clear();
+  _names.clear();
+  _name_hashes.clear();
+  _node_table.clear();
+  _id_table.clear();
+  _name_table.clear();
+  _num_ids = 0;
+}
+
+void PrimPathIndex::reserve(size_t n) {
+  _nodes.reserve(n);
+  if ((2 * n) > _node_table.size()) {
+    rehash(n);
+  }
+}
+
+void PrimPathIndex::rehash(size_t n) {
+  size_t table_size = kMinTableSize;
+  while (table_size < (2 * n)) {
+    table_size *= 2;
+  }
+
+  _node_table.assign(table_size, 0);
+  _id_table.assign(table_size, 0);
+
+  for (size_t i = 0; i < _nodes.size(); i++) {
+    insert_node(uint32_t(i));
+    if (_nodes[i].prim_id > 0) {
+      insert_prim_id(uint32_t(i));
+    }
+  }
+}
+
+void PrimPathIndex::rehash_names(size_t n) {
+  size_t table_size = kMinTableSize;
+  while (table_size < (2 * n)) {
+    table_size *= 2;
+  }
+
+  _name_table.assign(table_size, 0);
+
+  for (size_t i = 0; i < _names.size(); i++) {
+    insert_name(uint32_t(i));
+  }
+}
+
+void PrimPathIndex::insert_node(uint32_t idx) {
+  const size_t mask = _node_table.size() - 1;
+  size_t slot = HashChild(_nodes[idx].parent, _nodes[idx].name) & mask;
+  while (_node_table[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  _node_table[slot] = idx + 1;
+}
+
+void PrimPathIndex::insert_prim_id(uint32_t idx) {
+  const size_t mask = _id_table.size() - 1;
+  size_t slot = HashPrimId(_nodes[idx].prim_id) & mask;
+  while (_id_table[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  _id_table[slot] = idx + 1;
+}
+
+void PrimPathIndex::insert_name(uint32_t name) {
+  const size_t mask = _name_table.size() - 1;
+  size_t slot = _name_hashes[name] & mask;
+  while (_name_table[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  _name_table[slot] = name + 1;
+}
+
+uint32_t PrimPathIndex::find_name(const char *s, size_t len,
+                                  size_t hash) const {
+  if (_name_table.empty()) {
+    return kInvalidIndex;
+  }
+
+  const size_t mask = _name_table.size() - 1;
+  size_t slot = hash & mask;
+  while (_name_table[slot] != 0) {
+    const uint32_t name = _name_table[slot] - 1;
+    const std::string &str = _names[name];
+    if ((_name_hashes[name] == hash) && (str.size() == len) &&
+        (std::memcmp(str.data(), s, len) == 0)) {
+      return name;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  return kInvalidIndex;
+}
+
+uint32_t PrimPathIndex::find_child(uint32_t parent, uint32_t name) const {
+  if (_node_table.empty()) {
+    return kInvalidIndex;
+  }
+
+  const size_t mask = _node_table.size() - 1;
+  size_t slot = HashChild(parent, name) & mask;
+  while (_node_table[slot] != 0) {
+    const uint32_t idx = _node_table[slot] - 1;
+    if ((_nodes[idx].parent == parent) && (_nodes[idx].name == name)) {
+      return idx;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  return kInvalidIndex;
+}
+
+uint32_t PrimPathIndex::add(const std::string &element_name, const Prim *prim,
+                            uint32_t parent) {
+  if (_nodes.size() >= size_t((std::numeric_limits<uint32_t>::max)() - 1)) {
+    return kInvalidIndex;
+  }
+
+  // Intern the element name.
+  const size_t name_hash = HashName(element_name.data(), element_name.size());
+  uint32_t name = find_name(element_name.data(), element_name.size(), name_hash);
+  if (name == kInvalidIndex) {
+    name = uint32_t(_names.size());
+    _names.push_back(element_name);
+    _name_hashes.push_back(name_hash);
+    if ((2 * _names.size()) > _name_table.size()) {
+      // Also inserts the new name.
+      rehash_names(_names.size());
+    } else {
+      insert_name(name);
+    }
+  }
+
+  const uint32_t idx = uint32_t(_nodes.size());
+
+  Node node;
+  node.prim = prim;
+  node.prim_id = prim ? prim->prim_id() : -1;
+  node.parent = parent;
+  node.name = name;
+  node.subtree_end = idx + 1;
+  _nodes.push_back(node);
+
+  // Extend the subtree range of ancestors.
+  uint32_t p = parent;
+  while (p != kInvalidIndex) {
+    _nodes[p].subtree_end = idx + 1;
+    p = _nodes[p].parent;
+  }
+
+  if (_nodes[idx].prim_id > 0) {
+    _num_ids++;
+  }
+
+  if ((2 * _nodes.size()) > _node_table.size()) {
+    // Also inserts the new node.
+    rehash(_nodes.size());
+    return idx;
+  }
+
+  insert_node(idx);
+  if (_nodes[idx].prim_id > 0) {
+    insert_prim_id(idx);
+  }
+
+  return idx;
+}
+
+uint32_t PrimPathIndex::find(const std::string &path) const {
+  if (_nodes.empty() || path.empty() || (path[0] != '/')) {
+    return kInvalidIndex;
+  }
+
+  // Walk the path elements from the root.
+  uint32_t idx = kInvalidIndex;
+  size_t s = 1;
+  while (s <= path.size()) {
+    size_t e = path.find('/', s);
+    if (e == std::string::npos) {
+      e = path.size();
+    }
+
+    const size_t len = e - s;
+    if (len == 0) {
+      // "/", "//" or trailing '/'
+      return kInvalidIndex;
+    }
+
+    const uint32_t name =
+        find_name(path.data() + s, len, HashName(path.data() + s, len));
+    if (name == kInvalidIndex) {
+      return kInvalidIndex;
+    }
+
+    idx = find_child(idx, name);
+    if (idx == kInvalidIndex) {
+      return kInvalidIndex;
+    }
+
+    s = e + 1;
+  }
+
+  return idx;
+}
+
+uint32_t PrimPathIndex::find_by_prim_id(int64_t prim_id) const {
+  if ((prim_id < 1) || (_num_ids == 0)) {
+    return kInvalidIndex;
+  }
+
+  const size_t mask = _id_table.size() - 1;
+  size_t slot = HashPrimId(prim_id) & mask;
+  while (_id_table[slot] != 0) {
+    const uint32_t idx = _id_table[slot] - 1;
+    if (_nodes[idx].prim_id == prim_id) {
+      return idx;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  return kInvalidIndex;
+}
+
+}  // namespace tinyusdz
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Hashed Prim path index for Stage.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tinyusdz {
+
+class Prim;
+
+///
+/// Flat index of Prims in a Stage.
+///
+/// - Prims are keyed on (index of the parent Prim, id of the element name),
+///   like the path nodes of pxrUSD. Element names are interned in the index
+///   (`Token` is not interned unless TINYUSDZ_USE_STRING_ID_FOR_TOKEN_TYPE is
+///   defined), so no path string is stored per Prim.
+/// - Lookups use open-addressing hash tables(linear probing) over flat arrays.
+///   A Prim path lookup is a hash and a few probes per path element instead
+///   of O(log n) string compares of `std::map`.
+/// - Nodes are added in depth-first(pre-order) order, so the Prims in the
+///   subtree of a Prim are the contiguous range [idx, subtree_end(idx)).
+///
+/// The index holds raw pointers to Prims. It must be rebuilt when the Prim
+/// hierarchy(and therefore Prim addresses) changes.
+///
+/// Copying an index yields an empty index, since the copied pointers would
+/// still point to Prims of the source Stage. Moving keeps the content(moving a
+/// Stage does not relocate its Prims).
+///
+class PrimPathIndex {
+ public:
+  static constexpr uint32_t kInvalidIndex = ~0u;
+
+  PrimPathIndex() = default;
+  PrimPathIndex(const PrimPathIndex &) {}
+  PrimPathIndex(PrimPathIndex &&) = default;
+
+  PrimPathIndex &operator=(const PrimPathIndex &rhs) {
+    if (this != &rhs) {
+      clear();
+    }
+    return *this;
+  }
+  PrimPathIndex &operator=(PrimPathIndex &&) = default;
+
+  void clear();
+
+  void reserve(size_t n);
+
+  ///
+  /// Add Prim to the index. Prims must be added in depth-first order(parent
+  /// first).
+  ///
+  /// @param[in] element_name Element name of the Prim(e.g. "xform").
+  /// @param[in] prim Prim.
+  /// @param[in] parent Index of the parent Prim. kInvalidIndex for root Prim.
+  ///
+  /// @return Index of the added Prim. kInvalidIndex when the index is full.
+  ///
+  uint32_t add(const std::string &element_name, const Prim *prim,
+               uint32_t parent);
+
+  ///
+  /// @param[in] path Absolute Prim path(e.g. "/root/xform").
+  /// @return Index of the Prim at `path`. kInvalidIndex when not found.
+  ///
+  uint32_t find(const std::string &path) const;
+
+  ///
+  /// @return Index of the Prim whose prim_id is `prim_id`. kInvalidIndex when
+  /// not found.
+  ///
+  uint32_t find_by_prim_id(int64_t prim_id) const;
+
+  const Prim *prim(uint32_t idx) const { return _nodes[idx].prim; }
+
+  const std::string &element_name(uint32_t idx) const {
+    return _names[_nodes[idx].name];
+  }
+
+  uint32_t parent(uint32_t idx) const { return _nodes[idx].parent; }
+
+  ///
+  /// @return One past the index of the last Prim in the subtree of `idx`.
+  ///
+  uint32_t subtree_end(uint32_t idx) const { return _nodes[idx].subtree_end; }
+
+  size_t size() const { return _nodes.size(); }
+
+  bool empty() const { return _nodes.empty(); }
+
+ private:
+  struct Node {
+    const Prim *prim{nullptr};
+    int64_t prim_id{-1};
+    uint32_t parent{kInvalidIndex};
+    uint32_t name{kInvalidIndex};  // Index to `_names`
+    uint32_t subtree_end{0};
+  };
+
+  // Resize hash tables of nodes to hold `n` items with load factor <= 0.5
+  void rehash(size_t n);
+
+  // Resize hash table of names to hold `n` items with load factor <= 0.5
+  void rehash_names(size_t n);
+
+  void insert_node(uint32_t idx);
+  void insert_prim_id(uint32_t idx);
+  void insert_name(uint32_t name);
+
+  // Returns the id of the interned name. kInvalidIndex when not found.
+  uint32_t find_name(const char *s, size_t len, size_t hash) const;
+  uint32_t find_child(uint32_t parent, uint32_t name) const;
+
+  std::vector<Node> _nodes;
+
+  // Interned element names and their hashes.
+  std::vector<std::string> _names;
+  std::vector<size_t> _name_hashes;
+
+  // Open-addressing tables. Slot value = node(or name) index + 1(0 = empty
+  // slot). Table size is always power of two.
+  std::vector<uint32_t> _node_table;  // (parent, name) -> node
+  std::vector<uint32_t> _id_table;    // prim_id -> node
+  std::vector<uint32_t> _name_table;  // element name -> name
+  size_t _num_ids{0};
+};
+
+}  // namespace tinyusdz
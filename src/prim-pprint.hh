@@ -8,6 +8,7 @@
 #include <cstdint>
 
 #include "prim-types.hh"
+#include "text-sink.hh"
 
 namespace tinyusdz {
 namespace prim {
@@ -22,6 +23,10 @@ std::string print_layeroffset(const LayerOffset &layeroffset, const uint32_t ind
 std::string print_prim(const Prim &prim, const uint32_t indent=0);
 std::string print_primspec(const PrimSpec &primspec, const uint32_t indent=0);
 
+// Write Prim(PrimSpec) tree to `w` directly.
+void print_prim(TextSink &w, const Prim &prim, const uint32_t indent=0);
+void print_primspec(TextSink &w, const PrimSpec &primspec, const uint32_t indent=0);
+
 } // namespace prim
 
 inline std::string to_string(const Prim &prim) {
@@ -137,17 +137,19 @@ static nonstd::optional<Animatable<T>> ConvertToAnimatable(const primvar::PrimVa
   }
 
   if (var.has_timesamples()) {
-    for (size_t i = 0; i < var.ts_raw().size(); i++) {
-      const value::TimeSamples::Sample &s = var.ts_raw().get_samples()[i];
+    const value::TimeSamples &ts = var.ts_raw();
+    for (size_t i = 0; i < ts.size(); i++) {
+      const double t = ts.get_time(i).value();
+      T v;
 
       // Attribute Block?
-      if (s.blocked) {
-        dst.add_blocked_sample(s.t);
-      } else if (auto pv = s.value.get_value<T>()) {
-        dst.add_sample(s.t, pv.value());
+      if (ts.is_value_block(i)) {
+        dst.add_blocked_sample(t);
+      } else if (ts.get_value(i, &v)) {
+        dst.add_sample(t, v);
       } else {
         // Type mismatch
-        DCOUT(i << "/" << var.ts_raw().size() << " type mismatch.");
+        DCOUT(i << "/" << ts.size() << " type mismatch.");
         return nonstd::nullopt;
       }
     }
@@ -196,25 +198,27 @@ nonstd::optional<Animatable<Extent>> ConvertToAnimatable(const primvar::PrimVar
   }
 
   if (var.has_timesamples()) {
-    for (size_t i = 0; i < var.ts_raw().size(); i++) {
-      const value::TimeSamples::Sample &s = var.ts_raw().get_samples()[i];
+    const value::TimeSamples &ts = var.ts_raw();
+    for (size_t i = 0; i < ts.size(); i++) {
+      const double t = ts.get_time(i).value();
+      std::vector<value::float3> v;
 
       // Attribute Block?
-      if (s.blocked) {
-        dst.add_blocked_sample(s.t);
-      } else if (auto pv = s.value.get_value<std::vector<value::float3>>()) {
-        if (pv.value().size() == 2) {
+      if (ts.is_value_block(i)) {
+        dst.add_blocked_sample(t);
+      } else if (ts.get_value(i, &v)) {
+        if (v.size() == 2) {
           Extent ext;
-          ext.lower = pv.value()[0];
-          ext.upper = pv.value()[1];
-          dst.add_sample(s.t, ext);
+          ext.lower = v[0];
+          ext.upper = v[1];
+          dst.add_sample(t, ext);
         } else {
-          DCOUT(i << "/" << var.ts_raw().size() << " array size mismatch.");
+          DCOUT(i << "/" << ts.size() << " array size mismatch.");
           return nonstd::nullopt;
         }
       } else {
         // Type mismatch
-        DCOUT(i << "/" << var.ts_raw().size() << " type mismatch.");
+        DCOUT(i << "/" << ts.size() << " type mismatch.");
         return nonstd::nullopt;
       }
     }
@@ -4924,6 +4928,7 @@ RECONSTRUCT_PRIM_PRIMSPEC_IMPL(GeomSphere)
 RECONSTRUCT_PRIM_PRIMSPEC_IMPL(GeomCapsule)
 RECONSTRUCT_PRIM_PRIMSPEC_IMPL(GeomBasisCurves)
 RECONSTRUCT_PRIM_PRIMSPEC_IMPL(GeomCamera)
+RECONSTRUCT_PRIM_PRIMSPEC_IMPL(PointInstancer)
 RECONSTRUCT_PRIM_PRIMSPEC_IMPL(GeomSubset)
 RECONSTRUCT_PRIM_PRIMSPEC_IMPL(SphereLight)
 RECONSTRUCT_PRIM_PRIMSPEC_IMPL(DomeLight)
@@ -725,6 +725,7 @@ const PrimMeta *GetPrimMeta(const value::Value &v) {
   GET_PRIM_META(GeomSubset)
   GET_PRIM_META(GeomCamera)
   GET_PRIM_META(GeomBasisCurves)
+  GET_PRIM_META(PointInstancer)
   GET_PRIM_META(DomeLight)
   GET_PRIM_META(SphereLight)
   GET_PRIM_META(CylinderLight)
@@ -771,6 +772,7 @@ PrimMeta *GetPrimMeta(value::Value &v) {
   GET_PRIM_META(GeomSubset)
   GET_PRIM_META(GeomCamera)
   GET_PRIM_META(GeomBasisCurves)
+  GET_PRIM_META(PointInstancer)
   GET_PRIM_META(DomeLight)
   GET_PRIM_META(SphereLight)
   GET_PRIM_META(CylinderLight)
@@ -897,6 +899,7 @@ nonstd::optional<std::string> GetPrimElementName(const value::Value &v) {
   EXTRACT_NAME_AND_RETURN_PATH(GeomSubset)
   EXTRACT_NAME_AND_RETURN_PATH(GeomCamera)
   EXTRACT_NAME_AND_RETURN_PATH(GeomBasisCurves)
+  EXTRACT_NAME_AND_RETURN_PATH(PointInstancer)
   EXTRACT_NAME_AND_RETURN_PATH(DomeLight)
   EXTRACT_NAME_AND_RETURN_PATH(SphereLight)
   EXTRACT_NAME_AND_RETURN_PATH(CylinderLight)
@@ -952,6 +955,7 @@ bool SetPrimElementName(value::Value &v, const std::string &elementName) {
   SET_ELEMENT_NAME(elementName, GeomSubset)
   SET_ELEMENT_NAME(elementName, GeomCamera)
   SET_ELEMENT_NAME(elementName, GeomBasisCurves)
+  SET_ELEMENT_NAME(elementName, PointInstancer)
   SET_ELEMENT_NAME(elementName, DomeLight)
   SET_ELEMENT_NAME(elementName, SphereLight)
   SET_ELEMENT_NAME(elementName, CylinderLight)
@@ -1741,7 +1745,7 @@ bool CastToXformable(const Prim &prim, const Xformable **xformable) {
   TRY_CAST(GeomCone)
   TRY_CAST(GeomCapsule)
   TRY_CAST(GeomPoints)
-  // TRY_CAST(GeomPointInstancer)
+  TRY_CAST(PointInstancer)
   TRY_CAST(GeomCamera)
   TRY_CAST(SkelRoot)
   TRY_CAST(Skeleton)
@@ -2160,7 +2164,8 @@ bool Layer::find_primspec_at(const Path &path, const PrimSpec **ps,
     auto ret = _primspec_path_cache.find(path.prim_part());
     if (ret != _primspec_path_cache.end()) {
       DCOUT("Found cache.");
-      return ret->second;
+      (*ps) = ret->second;
+      return true;
     }
   }
 
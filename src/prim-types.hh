@@ -50,6 +50,21 @@
 
 namespace tinyusdz {
 
+#if defined(TINYUSDZ_ENABLE_THREAD)
+///
+/// std::mutex which can be copied/moved, so that a class holding a lock(e.g.
+/// Prim, Layer, Stage) keeps its copy/move semantics.
+/// The lock state is not copied: A copied object always gets a fresh
+/// (unlocked) mutex.
+///
+class CopyableMutex : public std::mutex {
+ public:
+  CopyableMutex() = default;
+  CopyableMutex(const CopyableMutex &) : std::mutex() {}
+  CopyableMutex &operator=(const CopyableMutex &) { return *this; }
+};
+#endif
+
 // Simple Python-like OrderedDict
 template <typename T>
 class ordered_dict {
@@ -1146,15 +1161,6 @@ struct TypedTimeSamples {
 
   bool empty() const { return _samples.empty(); }
 
-  void update() const {
-    std::sort(_samples.begin(), _samples.end(),
-              [](const Sample &a, const Sample &b) { return a.t < b.t; });
-
-    _dirty = false;
-
-    return;
-  }
-
   // Get value at specified time.
   // For non-interpolatable types(includes enums and unknown types)
   //
@@ -1175,10 +1181,6 @@ struct TypedTimeSamples {
       return false;
     }
 
-    if (_dirty) {
-      update();
-    }
-
     if (value::TimeCode(t).is_default()) {
       // FIXME: Use the first item for now.
       // TODO: Handle bloked
@@ -1230,10 +1232,6 @@ struct TypedTimeSamples {
       return false;
     }
 
-    if (_dirty) {
-      update();
-    }
-
     if (value::TimeCode(t).is_default()) {
       // FIXME: Use the first item for now.
       // TODO: Handle bloked
@@ -1312,32 +1310,91 @@ struct TypedTimeSamples {
     return false;
   }
 
+  ///
+  /// Get values at multiple times in one pass.
+  ///
+  /// `times` should be sorted in ascending order. Samples are then looked up
+  /// with a forward-moving cursor, so the cost is O(N + M)(N = # of samples,
+  /// M = # of times) instead of O(M log N) for calling `get` M times.
+  /// Unsorted `times` falls back to calling `get` for each time.
+  ///
+  /// `(*dst)[i]` is the same value as `get` returns for `times[i]`.
+  /// Returns false when `get` would fail for any of `times`.
+  ///
+  bool get(const std::vector<double> &times, std::vector<T> *dst,
+           value::TimeSampleInterpolationType interp =
+               value::TimeSampleInterpolationType::Linear) const {
+    if (!dst) {
+      return false;
+    }
+
+    if (empty()) {
+      return false;
+    }
+
+    dst->resize(times.size());
+
+    if (!std::is_sorted(times.begin(), times.end())) {
+      for (size_t i = 0; i < times.size(); i++) {
+        T v;
+        if (!get(&v, times[i], interp)) {
+          return false;
+        }
+        (*dst)[i] = std::move(v);
+      }
+      return true;
+    }
+
+    const size_t n = _samples.size();
+
+    size_t lb = 0;  // The first sample whose time >= t(lower_bound)
+    size_t ub = 0;  // The first sample whose time > t(upper_bound)
+
+    for (size_t i = 0; i < times.size(); i++) {
+      const double t = times[i];
+
+      if (value::TimeCode(t).is_default() || (n == 1)) {
+        // FIXME: Use the first item for now.
+        (*dst)[i] = _samples[0].value;
+        continue;
+      }
+
+      while ((lb < n) && (_samples[lb].t < t)) {
+        lb++;
+      }
+
+      while ((ub < n) && (_samples[ub].t <= t)) {
+        ub++;
+      }
+
+      if (!get_at_cursor(lb, ub, t, interp, dst, i)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Samples are kept sorted by time. Appending samples in time order is O(1).
   void add_sample(const Sample &s) {
-    _samples.push_back(s);
-    _dirty = true;
+    insert_sample(s);
   }
 
   void add_sample(const double t, const T &v) {
     Sample s;
     s.t = t;
     s.value = v;
-    _samples.emplace_back(s);
-    _dirty = true;
+    insert_sample(std::move(s));
   }
 
   void add_blocked_sample(const double t) {
     Sample s;
     s.t = t;
     s.blocked = true;
-    _samples.emplace_back(s);
-    _dirty = true;
+    insert_sample(std::move(s));
   }
 
   bool has_sample_at(const double t) const {
-    if (_dirty) {
-      update();
-    }
-
     const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &s) {
       return tinyusdz::math::is_close(t, s.t);
     });
@@ -1350,10 +1407,6 @@ struct TypedTimeSamples {
       return false;
     }
 
-    if (_dirty) {
-      update();
-    }
-
     const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &sample) {
       return math::is_close(t, sample.t);
     });
@@ -1365,24 +1418,43 @@ struct TypedTimeSamples {
   }
 
   const std::vector<Sample> &get_samples() const {
-    if (_dirty) {
-      update();
-    }
-
     return _samples;
   }
 
+  // Samples must be kept sorted by time when they are modified through the
+  // returned reference.
   std::vector<Sample> &samples() {
-    if (_dirty) {
-      update();
-    }
-
     return _samples;
   }
 
   // From typeless timesamples.
   bool from_timesamples(const value::TimeSamples &ts) {
     std::vector<Sample> buf;
+    buf.reserve(ts.size());
+
+    if (ts.is_pod_storage()) {
+      // Samples in SoA storage have the same type, so check the type once and
+      // copy values without `value::Value`.
+      if (ts.size() && (ts.type_id() != value::TypeTraits<T>::type_id())) {
+        return false;
+      }
+
+      for (size_t i = 0; i < ts.size(); i++) {
+        Sample s;
+        s.t = ts.get_time(i).value();
+        s.blocked = false;
+        if (!ts.get_value(i, &s.value)) {
+          return false;
+        }
+
+        buf.push_back(std::move(s));
+      }
+
+      _samples = std::move(buf);
+
+      return true;
+    }
+
     for (size_t i = 0; i < ts.size(); i++) {
       if (ts.get_samples()[i].value.type_id() != value::TypeTraits<T>::type_id()) {
         return false;
@@ -1400,23 +1472,86 @@ struct TypedTimeSamples {
     }
 
 
+    // Samples of `ts` are already sorted.
     _samples = std::move(buf);
-    _dirty = true;
 
     return true;
   }
 
   size_t size() const {
-    if (_dirty) {
-      update();
-    }
     return _samples.size();
   }
 
  private:
-  // Need to be sorted when looking up the value.
-  mutable std::vector<Sample> _samples;
-  mutable bool _dirty{false};
+  // Insert `s` after the samples whose time <= `s.t`.
+  void insert_sample(Sample s) {
+    if (_samples.empty() || (_samples.back().t <= s.t)) {
+      _samples.emplace_back(std::move(s));
+      return;
+    }
+
+    const auto it = std::upper_bound(
+        _samples.begin(), _samples.end(), s.t,
+        [](double tval, const Sample &a) { return tval < a.t; });
+    _samples.insert(it, std::move(s));
+  }
+
+  // Write the value at time `t` to `(*dst)[i]` for batched `get`.
+  // `lb` and `ub` are the lower_bound and upper_bound index of `t`.
+  template<typename V = T, std::enable_if_t<!value::LerpTraits<V>::supported(), std::nullptr_t> = nullptr>
+  bool get_at_cursor(const size_t lb, const size_t ub, const double t,
+                     const value::TimeSampleInterpolationType interp,
+                     std::vector<T> *dst, const size_t i) const {
+    (void)lb;
+    (void)t;
+    (void)interp;
+
+    // Held
+    (*dst)[i] = _samples[(ub == 0) ? 0 : (ub - 1)].value;
+    return true;
+  }
+
+  template<typename V = T, std::enable_if_t<value::LerpTraits<V>::supported(), std::nullptr_t> = nullptr>
+  bool get_at_cursor(const size_t lb, const size_t ub, const double t,
+                     const value::TimeSampleInterpolationType interp,
+                     std::vector<T> *dst, const size_t i) const {
+    (void)ub;
+
+    const size_t n = _samples.size();
+
+    if (interp == value::TimeSampleInterpolationType::Linear) {
+      size_t idx0 = (std::min)(n - 1, (lb == 0) ? size_t(0) : (lb - 1));
+      size_t idx1 = (std::min)(n - 1, idx0 + 1);
+
+      double tl = _samples[idx0].t;
+      double tu = _samples[idx1].t;
+
+      double dt = (t - tl);
+      if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
+        // slope is zero.
+        dt = 0.0;
+      } else {
+        dt /= (tu - tl);
+      }
+
+      // Just in case.
+      dt = (std::max)(0.0, (std::min)(1.0, dt));
+
+      lerp_to(_samples[idx0].value, _samples[idx1].value, dt, &(*dst)[i]);
+      return true;
+    }
+
+    // Same behavior with `get`
+    if (lb == n) {
+      return false;
+    }
+
+    (*dst)[i] = _samples[lb].value;
+    return true;
+  }
+
+  // Sorted by time.
+  std::vector<Sample> _samples;
 };
 
 //
@@ -1479,6 +1614,45 @@ struct Animatable {
     return false;
   }
 
+  ///
+  /// Get values at multiple times.
+  /// `times` should be sorted in ascending order to evaluate timesamples in one
+  /// pass(See `TypedTimeSamples::get` for details).
+  ///
+  bool get(const std::vector<double> &times, std::vector<T> *values,
+           const value::TimeSampleInterpolationType tinerp =
+               value::TimeSampleInterpolationType::Linear) const {
+    if (!values) {
+      return false;
+    }
+
+    if (is_blocked()) {
+      return false;
+    }
+
+    if (has_timesamples()) {
+      if (!_ts.get(times, values, tinerp)) {
+        return false;
+      }
+
+      if (has_value()) {
+        for (size_t i = 0; i < times.size(); i++) {
+          if (value::TimeCode(times[i]).is_default()) {
+            (*values)[i] = _value;
+          }
+        }
+      }
+      return true;
+    }
+
+    if (has_default()) {
+      values->assign(times.size(), _value);
+      return true;
+    }
+
+    return false;
+  }
+
   ///
   /// Get scalar(default) value.
   ///
@@ -1613,6 +1787,11 @@ class TypedAttribute {
   void set_value(const T &v) { _attrib = v; }
   bool has_value() const { return _attrib.has_value(); }
 
+  // T = Animatable only. Does not copy the value.
+  bool has_timesamples() const {
+    return _attrib.has_value() && _attrib.value().has_timesamples();
+  }
+
   const nonstd::optional<T> get_value() const {
     return _attrib;
   }
@@ -2990,6 +3169,17 @@ struct XformOp {
     return _var.get_value<T>();
   }
 
+  // Get value at time `t`. timeSamples are interpolated with `tinterp`.
+  template <class T>
+  nonstd::optional<T> get_value(
+      double t, value::TimeSampleInterpolationType tinterp) const {
+    T v;
+    if (_var.get_interpolated_value(t, tinterp, &v)) {
+      return v;
+    }
+    return nonstd::nullopt;
+  }
+
   const primvar::PrimVar &get_var() const { return _var; }
 
   primvar::PrimVar &var() { return _var; }
@@ -3821,7 +4011,7 @@ class Prim {
   std::map<std::string, VariantSet> _variantSets;
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
-  mutable std::mutex _mutex;
+  mutable CopyableMutex _mutex;
 #endif
 };
 
@@ -4475,7 +4665,7 @@ class Layer {
   LayerMetas _metas;
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
-  mutable std::mutex _mutex;
+  mutable CopyableMutex _mutex;
 #endif
 
   // Cached primspec path.
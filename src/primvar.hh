@@ -11,11 +11,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstring>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 #include <vector>
 #include <cmath>
@@ -37,16 +39,205 @@
 namespace tinyusdz {
 namespace primvar {
 
+///
+/// Loader functions for a deferred(not yet decoded) value.
+/// Used by USDC reader's lazy value unpacking(see `USDLoadOptions::lazy_value_unpack`).
+/// Return false and set `err` when failed to load the value.
+///
+using ValueLoader = std::function<bool(value::Value *dst, std::string *err)>;
+using TimeSamplesLoader =
+    std::function<bool(value::TimeSamples *dst, std::string *err)>;
+
+///
+/// Location of a POD array in memory which is kept alive by `owner`(e.g. the
+/// handle of a memory-mapped USDC file).
+///
+struct RawArrayView {
+  const uint8_t *data{nullptr};
+  size_t size{0};  // The number of elements
+  uint32_t type_id{value::TYPE_ID_INVALID};  // Underlying type of the element
+  size_t element_size{0};  // in bytes
+  std::shared_ptr<const void> owner;
+};
+
+///
+/// Returns the location of a deferred array value without decoding it.
+/// Returns false when the array cannot be referenced directly(e.g. compressed
+/// array). Used by USDC reader's lazy value unpacking.
+///
+using ArrayViewProvider = std::function<bool(RawArrayView *dst)>;
+
+///
+/// Read-only view of an array value(see `PrimVar::get_array_view`).
+/// The view holds the owner of the memory, so it stays valid after the
+/// PrimVar(or the Stage/Layer) is destroyed.
+///
+template <typename T>
+class ArrayView {
+ public:
+  ArrayView() = default;
+  ArrayView(const T *data, size_t n, std::shared_ptr<const void> owner)
+      : _data(data), _size(n), _owner(std::move(owner)) {}
+
+  const T *data() const { return _data; }
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  const T *begin() const { return _data; }
+  const T *end() const { return _data + _size; }
+
+  const T &operator[](size_t idx) const { return _data[idx]; }
+
+ private:
+  const T *_data{nullptr};
+  size_t _size{0};
+  std::shared_ptr<const void> _owner;
+};
+
+///
+/// Holds deferred loaders of a PrimVar and serializes their invocation, so
+/// that concurrent const accessors materialize the value exactly once.
+///
+class DeferredLoader {
+ public:
+  DeferredLoader() = default;
+
+  DeferredLoader(const DeferredLoader &rhs) { copy_from(rhs); }
+
+  DeferredLoader &operator=(const DeferredLoader &rhs) {
+    if (this != &rhs) {
+      copy_from(rhs);
+    }
+    return *this;
+  }
+
+  // True while any loader has not been invoked yet.
+  bool pending() const { return _pending.load(std::memory_order_acquire); }
+
+  bool value_pending() const { return pending() && _has_value_loader; }
+  bool ts_pending() const { return pending() && _has_ts_loader; }
+
+  // `view` is optional. It stays available after the value is loaded.
+  void set_value_loader(ValueLoader loader, ArrayViewProvider view = nullptr) {
+    _value_loader = std::move(loader);
+    _view_provider = std::move(view);
+    update_pending();
+  }
+
+  ///
+  /// Get the location of the deferred array value without loading it.
+  /// Returns false when no ArrayViewProvider is set or the array cannot be
+  /// referenced directly. Thread-safe.
+  ///
+  bool get_array_view(RawArrayView *dst) const {
+    if (!_view_provider) {
+      return false;
+    }
+    return _view_provider(dst);
+  }
+
+  void set_ts_loader(TimeSamplesLoader loader) {
+    _ts_loader = std::move(loader);
+    update_pending();
+  }
+
+  ///
+  /// Invoke loaders(at most once). Thread-safe.
+  ///
+  bool load(value::Value *value, value::TimeSamples *ts, std::string *err) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_pending.load(std::memory_order_relaxed)) {
+      return true;
+    }
+
+    bool ok = true;
+    if (_value_loader) {
+      if (!_value_loader(value, err)) {
+        (*value) = nullptr;
+        ok = false;
+      }
+      _value_loader = nullptr;
+    }
+    if (_ts_loader) {
+      if (!_ts_loader(ts, err)) {
+        ts->clear();
+        ok = false;
+      }
+      _ts_loader = nullptr;
+    }
+
+    // Publish loaded `value` and `ts` to lock-free readers of `pending()`.
+    _pending.store(false, std::memory_order_release);
+    return ok;
+  }
+
+ private:
+  void update_pending() {
+    // Loaders invoked by `load()` are cleared, so derive the flags from the
+    // loaders(not from the previous flags) to forget already loaded ones.
+    _has_value_loader = bool(_value_loader);
+    _has_ts_loader = bool(_ts_loader);
+    _pending.store(_has_value_loader || _has_ts_loader,
+                   std::memory_order_release);
+  }
+
+  void copy_from(const DeferredLoader &rhs) {
+    std::lock_guard<std::mutex> lock(rhs._mutex);
+    _value_loader = rhs._value_loader;
+    _ts_loader = rhs._ts_loader;
+    _view_provider = rhs._view_provider;
+    _has_value_loader = rhs._has_value_loader;
+    _has_ts_loader = rhs._has_ts_loader;
+    _pending.store(rhs._pending.load(std::memory_order_relaxed),
+                   std::memory_order_release);
+  }
+
+  mutable std::mutex _mutex;
+  std::atomic<bool> _pending{false};
+  // Only modified by non-const setters, so they can be read without a lock.
+  bool _has_value_loader{false};
+  bool _has_ts_loader{false};
+  ValueLoader _value_loader;
+  TimeSamplesLoader _ts_loader;
+  // Only modified by non-const setters.
+  ArrayViewProvider _view_provider;
+};
+
 struct PrimVar {
-  value::Value _value{nullptr}; // For scalar(default) value
+  // `mutable` since deferred value is materialized in const accessors.
+  mutable value::Value _value{nullptr}; // For scalar(default) value
   bool _blocked{false}; // ValueBlocked.
-  value::TimeSamples _ts; // For TimeSamples value.
+  mutable value::TimeSamples _ts; // For TimeSamples value.
+
+  // Deferred default value and TimeSamples. Loaded on the first access to the
+  // value(or by calling `materialize()`). Materialization is thread-safe, but
+  // modifying the PrimVar concurrently with readers is not.
+  mutable DeferredLoader _deferred;
+
+  bool has_deferred() const {
+    return _deferred.pending();
+  }
+
+  ///
+  /// Load deferred default value and TimeSamples(if exists).
+  /// Loader is called at most once. When the loading failed, the value becomes
+  /// empty.
+  ///
+  bool materialize(std::string *err = nullptr) const {
+    if (!_deferred.pending()) {
+      return true;
+    }
+    return _deferred.load(&_value, &_ts, err);
+  }
 
   bool has_value() const {
     // ValueBlock is treated as having a value.
     if (_blocked) {
       return true;
     }
+    if (_deferred.value_pending()) {
+      return true;
+    }
     return (_value.type_id() != value::TypeId::TYPE_ID_INVALID) && (_value.type_id() != value::TypeId::TYPE_ID_NULL);
   }
 
@@ -55,15 +246,18 @@ struct PrimVar {
   }
 
   bool has_timesamples() const {
+    if (_deferred.ts_pending()) {
+      return true;
+    }
     return _ts.size() > 0;
   }
 
   bool is_scalar() const {
-    return has_value() && _ts.empty();
+    return has_value() && !has_timesamples();
   }
 
   bool is_timesamples() const {
-    return !has_value() && _ts.size();
+    return !has_value() && has_timesamples();
   }
 
   bool is_blocked() const {
@@ -80,6 +274,8 @@ struct PrimVar {
   }
 
   bool is_valid() const {
+    materialize();
+
     if (has_timesamples()) {
       if ((_ts.type_id() == value::TypeId::TYPE_ID_INVALID) || (_ts.type_id() == value::TypeId::TYPE_ID_NULL)) {
         return false;
@@ -95,6 +291,8 @@ struct PrimVar {
   }
 
   std::string type_name() const {
+    materialize();
+
     if (has_default()) {
       return _value.type_name();
     }
@@ -139,6 +337,7 @@ struct PrimVar {
       return nonstd::nullopt;
     }
 
+    materialize();
     return _value.get_value<T>();
   }
 
@@ -153,6 +352,7 @@ struct PrimVar {
       return nonstd::nullopt;
     }
 
+    materialize();
     if (idx >= _ts.size()) {
       return nonstd::nullopt;
     }
@@ -161,10 +361,16 @@ struct PrimVar {
   }
 
   nonstd::optional<value::TimeSamples::Sample> get_timesample(size_t idx) const {
-    if (idx < _ts.get_samples().size()) {
-      return _ts.get_samples()[idx];
+    materialize();
+    if (idx >= _ts.size()) {
+      return nonstd::nullopt;
     }
-    return nonstd::nullopt;
+
+    value::TimeSamples::Sample s;
+    s.t = _ts.get_time(idx).value();
+    s.value = _ts.get_value(idx).value();
+    s.blocked = _ts.is_value_block(idx);
+    return s;
   }
 
   // Type-safe way to get concrete value for timesampled variable.
@@ -176,12 +382,13 @@ struct PrimVar {
       return nonstd::nullopt;
     }
 
-    nonstd::optional<value::Value> pv = _ts.get_value(idx);
-    if (!pv) {
+    materialize();
+    T v;
+    if (!_ts.get_value(idx, &v)) {
       return nonstd::nullopt;
     }
 
-    return pv.value().get_value<T>();
+    return v;
   }
 
   // Check if specific TimeSample value for a specified index is ValueBlock or not.
@@ -191,11 +398,12 @@ struct PrimVar {
       return nonstd::nullopt;
     }
 
-    if (idx >= _ts.get_samples().size()) {
+    materialize();
+    if (idx >= _ts.size()) {
       return nonstd::nullopt;
     }
 
-    return _ts.get_samples()[idx].blocked;
+    return _ts.is_value_block(idx);
   }
 
   // For Scalar only
@@ -207,36 +415,107 @@ struct PrimVar {
       return nullptr;
     }
 
+    materialize();
     return _value.as<T>();
   }
 
   template <class T>
   void set_value(const T &v) {
+    _deferred.set_value_loader(nullptr);
     _value = v;
   }
 
   void clear_value() {
+    _deferred.set_value_loader(nullptr);
+    _value = nullptr;
+  }
+
+  ///
+  /// Set deferred default value. `loader` is called on the first access to
+  /// the value.
+  ///
+  /// `view` optionally provides the location of the array value, so that
+  /// `get_array_view` can reference the array without loading it.
+  ///
+  void set_deferred_value(ValueLoader loader,
+                          ArrayViewProvider view = nullptr) {
     _value = nullptr;
+    _deferred.set_value_loader(std::move(loader), std::move(view));
+  }
+
+  ///
+  /// Get a read-only view of the default value of array type(`std::vector<T>`).
+  /// Role types of the same underlying type are accepted(e.g. `point3f` for
+  /// `float3[]`) like `get_value`.
+  ///
+  /// When the value is a deferred value of a memory-mapped USDC file(see
+  /// `USDLoadOptions::lazy_value_unpack`) and the array is stored
+  /// uncompressed and aligned for `T`, the view references the mapped file
+  /// directly and the value is not decoded. Otherwise the view holds a copy
+  /// of the value.
+  ///
+  /// Returns false when the default value is not an array of `T`.
+  ///
+  template <class T>
+  bool get_array_view(ArrayView<T> *dst) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ArrayView requires POD type.");
+    if (!dst || is_blocked()) {
+      return false;
+    }
+
+    RawArrayView raw;
+    if (_deferred.get_array_view(&raw) &&
+        (raw.type_id == value::TypeTraits<T>::underlying_type_id()) &&
+        (raw.element_size == sizeof(T)) &&
+        ((reinterpret_cast<uintptr_t>(raw.data) % alignof(T)) == 0)) {
+      (*dst) = ArrayView<T>(reinterpret_cast<const T *>(raw.data), raw.size,
+                            std::move(raw.owner));
+      return true;
+    }
+
+    auto pv = get_value<std::vector<T>>();
+    if (!pv) {
+      return false;
+    }
+
+    auto copy = std::make_shared<std::vector<T>>(std::move(pv.value()));
+    (*dst) = ArrayView<T>(copy->data(), copy->size(), copy);
+    return true;
   }
 
   void set_timesamples(const value::TimeSamples &v) {
+    _deferred.set_ts_loader(nullptr);
     _ts = v;
   }
 
   void set_timesamples(value::TimeSamples &&v) {
+    _deferred.set_ts_loader(nullptr);
     _ts = std::move(v);
   }
 
+  ///
+  /// Set deferred TimeSamples. `loader` is called on the first access to
+  /// TimeSamples.
+  ///
+  void set_deferred_timesamples(TimeSamplesLoader loader) {
+    _ts.clear();
+    _deferred.set_ts_loader(std::move(loader));
+  }
+
   void clear_timesamples() {
+    _deferred.set_ts_loader(nullptr);
     _ts.clear();
   }
 
   template <typename T>
   void set_timesample(double t, const T &v) {
+    materialize();
     _ts.add_sample(t, v);
   }
 
   void set_timesample(double t, value::Value &v) {
+    materialize();
     _ts.add_sample(t, v);
   }
 
@@ -291,6 +570,8 @@ struct PrimVar {
       return false;
     }
 
+    materialize();
+
     if (value::TimeCode(t).is_default()) {
 
       if (auto pv = get_default_value<T>()) {
@@ -318,6 +599,7 @@ struct PrimVar {
   }
 
   size_t num_timesamples() const {
+    materialize();
     if (has_timesamples()) {
       return _ts.size();
     }
@@ -325,18 +607,22 @@ struct PrimVar {
   }
 
   const value::TimeSamples &ts_raw() const {
+    materialize();
     return _ts;
   }
   
   value::Value &value_raw() {
+    materialize();
     return _value;
   }
 
   const value::Value &value_raw() const {
+    materialize();
     return _value;
   }
   
   value::TimeSamples &ts_raw() {
+    materialize();
     return _ts;
   }
 };
@@ -26,6 +26,7 @@
 #include "pprinter.hh"
 #include "prim-pprint.hh"
 #include "str-util.hh"
+#include "text-sink.hh"
 #include "tiny-format.hh"
 #include "tinyusdz.hh"
 #include "usdLux.hh"
@@ -113,29 +114,31 @@ nonstd::expected<const Prim *, std::string> Stage::GetPrimAtPath(
         "Path is not absolute. Non-absolute Path is TODO.\n");
   }
 
-  if (_dirty) {
-    DCOUT("clear cache.");
-    // Clear cache.
-    _prim_path_cache.clear();
+  // Index is empty after the Stage is copied.
+  if (_dirty || _prim_index.empty()) {
+    DCOUT("rebuild Prim index.");
+    build_prim_index();
+  }
 
-    _dirty = false;
-  } else {
-    // First find from a cache.
-    auto ret = _prim_path_cache.find(path.prim_part());
-    if (ret != _prim_path_cache.end()) {
-      DCOUT("Found cache.");
-      return ret->second;
-    }
+  // First find from the index.
+  uint32_t idx = _prim_index.find(path.prim_part());
+  if (idx != PrimPathIndex::kInvalidIndex) {
+    DCOUT("Found in the index.");
+    return _prim_index.prim(idx);
   }
 
+  // The index is up to date, so the Prim does not exist.
+  if (!_dirty) {
+    DCOUT("Not found.");
+    return nonstd::make_unexpected("Cannot find path <" +
+                                   path.full_path_name() + "> in the Stage.\n");
+  }
 
   // Brute-force search.
+  // (the index could not be built for all Prims)
   for (const auto &parent : _root_nodes) {
     if (auto pv =
             GetPrimAtPathRec(&parent, /* root */ "", path, /* depth */ 0)) {
-      // Add to cache.
-      // Assume pointer address does not change unless dirty state.
-      _prim_path_cache[path.prim_part()] = pv.value();
       return pv.value();
     }
   }
@@ -219,26 +222,28 @@ bool Stage::find_prim_by_prim_id(const uint64_t prim_id, const Prim *&prim,
     return false;
   }
 
-  if (_prim_id_dirty) {
-    DCOUT("clear prim_id cache.");
-    // Clear cache.
-    _prim_id_cache.clear();
+  // Index is empty after the Stage is copied.
+  if (_dirty || _prim_index.empty()) {
+    DCOUT("rebuild Prim index.");
+    build_prim_index();
+  }
 
-    _prim_id_dirty = false;
-  } else {
-    // First find from a cache.
-    auto ret = _prim_id_cache.find(prim_id);
-    if (ret != _prim_id_cache.end()) {
-      DCOUT("Found cache.");
-      prim = ret->second;
-      return true;
-    }
+  // First find from the index.
+  uint32_t idx = _prim_index.find_by_prim_id(int64_t(prim_id));
+  if (idx != PrimPathIndex::kInvalidIndex) {
+    DCOUT("Found in the index.");
+    prim = _prim_index.prim(idx);
+    return true;
+  }
+
+  // The index is up to date, so no Prim has `prim_id`.
+  if (!_dirty) {
+    return false;
   }
 
   const Prim *p{nullptr};
   for (const auto &root : root_prims()) {
     if (FindPrimByPrimIdRec(prim_id, &root, &p, 0, err)) {
-      _prim_id_cache[prim_id] = p;
       prim = p;
       return true;
     }
@@ -260,6 +265,94 @@ bool Stage::find_prim_by_prim_id(const uint64_t prim_id, Prim *&prim,
   return true;
 }
 
+bool Stage::find_prims_in_subtree(const Path &path,
+                                  std::vector<const Prim *> *prims,
+                                  std::string *err) const {
+  if (!prims) {
+    if (err) {
+      (*err) = "`prims` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  nonstd::expected<const Prim *, std::string> ret = GetPrimAtPath(path);
+  if (!ret) {
+    if (err) {
+      (*err) = ret.error();
+    }
+    return false;
+  }
+
+  prims->clear();
+
+  uint32_t idx = _prim_index.find(path.prim_part());
+  if ((idx != PrimPathIndex::kInvalidIndex) &&
+      (_prim_index.prim(idx) == ret.value())) {
+    uint32_t end = _prim_index.subtree_end(idx);
+    prims->reserve(end - idx);
+    for (uint32_t i = idx; i < end; i++) {
+      prims->push_back(_prim_index.prim(i));
+    }
+    return true;
+  }
+
+  // Prim is not in the index. Traverse children.
+  std::vector<const Prim *> stack;
+  stack.push_back(ret.value());
+  while (!stack.empty()) {
+    const Prim *p = stack.back();
+    stack.pop_back();
+    prims->push_back(p);
+
+    const auto &children = p->children();
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+      stack.push_back(&(*it));
+    }
+  }
+
+  return true;
+}
+
+namespace {
+
+bool BuildPrimIndexRec(const Prim &prim, uint32_t parent_idx, uint32_t depth,
+                       PrimPathIndex *index) {
+  if (depth > 1024 * 1024 * 128) {
+    // too deep node.
+    return false;
+  }
+
+  uint32_t idx = index->add(prim.element_name(), &prim, parent_idx);
+  if (idx == PrimPathIndex::kInvalidIndex) {
+    return false;
+  }
+
+  for (const Prim &child : prim.children()) {
+    if (!BuildPrimIndexRec(child, idx, depth + 1, index)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+void Stage::build_prim_index() const {
+  _prim_index.clear();
+
+  for (const Prim &root : _root_nodes) {
+    if (!BuildPrimIndexRec(root, PrimPathIndex::kInvalidIndex, /* depth */ 1,
+                           &_prim_index)) {
+      // Incomplete index. Lookups fall back to traversal.
+      _dirty = true;
+      return;
+    }
+  }
+
+  _dirty = false;
+}
+
 nonstd::expected<const Prim *, std::string> Stage::GetPrimFromRelativePath(
     const Prim &root, const Path &path) const {
   // TODO: Resolve "../"
@@ -460,22 +553,19 @@ void PrimPrintRec(std::stringstream &ss, const Prim &prim, uint32_t indent) {
 
 }  // namespace
 
-std::string Stage::ExportToString(bool relative_path) const {
+void Stage::ExportTo(TextSink &w, bool relative_path) const {
   (void)relative_path; // TODO
 
-  std::stringstream ss;
-
-  ss << "#usda 1.0\n";
+  w << "#usda 1.0\n";
 
-  std::stringstream meta_ss;
-  meta_ss << print_layer_metas(stage_metas, /* indent */1);
-  if (meta_ss.str().size()) {
-    ss << "(\n";
-    ss << meta_ss.str();
-    ss << ")\n";
+  std::string meta_str = print_layer_metas(stage_metas, /* indent */1);
+  if (meta_str.size()) {
+    w << "(\n";
+    w << meta_str;
+    w << ")\n";
   }
 
-  ss << "\n";
+  w << "\n";
 
   if (stage_metas.primChildren.size() == _root_nodes.size()) {
     std::map<std::string, const Prim *> primNameTable;
@@ -489,10 +579,9 @@ std::string Stage::ExportToString(bool relative_path) const {
                         stage_metas.primChildren.size(), nameTok.str()));
       const auto it = primNameTable.find(nameTok.str());
       if (it != primNameTable.end()) {
-        //PrimPrintRec(ss, *(it->second), 0);
-        ss << prim::print_prim(*(it->second), 0);
+        prim::print_prim(w, *(it->second), 0);
         if (i != (stage_metas.primChildren.size() - 1)) {
-          ss << "\n";
+          w << "\n";
         }
       } else {
         // TODO: Report warning?
@@ -500,16 +589,19 @@ std::string Stage::ExportToString(bool relative_path) const {
     }
   } else {
     for (size_t i = 0; i < _root_nodes.size(); i++) {
-      //PrimPrintRec(ss, _root_nodes[i], 0);
-      ss << prim::print_prim(_root_nodes[i], 0);
+      prim::print_prim(w, _root_nodes[i], 0);
 
       if (i != (_root_nodes.size() - 1)) {
-        ss << "\n";
+        w << "\n";
       }
     }
   }
+}
 
-  return ss.str();
+std::string Stage::ExportToString(bool relative_path) const {
+  TextSink w;
+  ExportTo(w, relative_path);
+  return w.take();
 }
 
 bool Stage::allocate_prim_id(uint64_t *prim_id) const {
@@ -539,7 +631,9 @@ namespace {
 bool ComputeAbsPathAndAssignPrimIdRec(const Stage &stage, Prim &prim,
                                       const Path &parentPath, uint32_t depth,
                                       bool assign_prim_id,
-                                      bool force_assign_prim_id = true,
+                                      bool force_assign_prim_id,
+                                      PrimPathIndex *index,
+                                      uint32_t parent_idx,
                                       std::string *err = nullptr) {
   if (depth > 1024 * 1024 * 128) {
     // too deep node.
@@ -574,10 +668,18 @@ bool ComputeAbsPathAndAssignPrimIdRec(const Stage &stage, Prim &prim,
     }
   }
 
+  uint32_t idx = index->add(prim.element_name(), &prim, parent_idx);
+  if (idx == PrimPathIndex::kInvalidIndex) {
+    if (err) {
+      (*err) += "Too many Prims in the Stage.\n";
+    }
+    return false;
+  }
+
   for (Prim &child : prim.children()) {
     if (!ComputeAbsPathAndAssignPrimIdRec(stage, child, abs_path, depth + 1,
                                           assign_prim_id, force_assign_prim_id,
-                                          err)) {
+                                          index, idx, err)) {
       return false;
     }
   }
@@ -590,30 +692,39 @@ bool ComputeAbsPathAndAssignPrimIdRec(const Stage &stage, Prim &prim,
 bool Stage::compute_absolute_prim_path_and_assign_prim_id(
     bool force_assign_prim_id) {
   Path rootPath("/", "");
+  _prim_index.clear();
   for (Prim &root : root_prims()) {
     if (!ComputeAbsPathAndAssignPrimIdRec(*this, root, rootPath, 1,
                                           /* assign_prim_id */ true,
-                                          force_assign_prim_id, &_err)) {
+                                          force_assign_prim_id, &_prim_index,
+                                          PrimPathIndex::kInvalidIndex,
+                                          &_err)) {
+      _dirty = true;
       return false;
     }
   }
 
-  // TODO: Only set dirty when prim_id changed.
-  _prim_id_dirty = true;
+  // Prim index is built incrementally in the traversal above.
+  _dirty = false;
 
   return true;
 }
 
 bool Stage::compute_absolute_prim_path() {
   Path rootPath("/", "");
+  _prim_index.clear();
   for (Prim &root : root_prims()) {
     if (!ComputeAbsPathAndAssignPrimIdRec(
             *this, root, rootPath, 1, /* assign prim_id */ false,
-            /* force_assign_prim_id */ true, &_err)) {
+            /* force_assign_prim_id */ true, &_prim_index,
+            PrimPathIndex::kInvalidIndex, &_err)) {
+      _dirty = true;
       return false;
     }
   }
 
+  _dirty = false;
+
   return true;
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "composition.hh"
+#include "prim-path-index.hh"
 #include "prim-types.hh"
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
@@ -17,6 +18,7 @@ namespace tinyusdz {
 using StageMetas = LayerMetas;
 
 class PrimRange;
+class TextSink;
 
 // Similar to UsdStage, but much more something like a Scene(scene graph)
 class Stage {
@@ -53,6 +55,12 @@ class Stage {
   ///
   std::string ExportToString(bool relative_path = false) const;
 
+  ///
+  /// Write ASCII(USDA) representation of Stage to `w`(buffer or FILE*).
+  /// Prims are streamed to `w` one by one, so use this for huge Stage.
+  ///
+  void ExportTo(TextSink &w, bool relative_path = false) const;
+
   // pxrUSD compat API end -------------------------------------
 
   ///
@@ -87,6 +95,18 @@ class Stage {
   bool find_prim_at_path(const Path &path, int64_t *prim_id,
                          std::string *err = nullptr) const;
 
+  /// Find(Get) Prims in the subtree of a Prim at a Path.
+  /// Path must be absolute Path.
+  ///
+  /// @param[in] path Absolute path(e.g. `/bora/dora`)
+  /// @param[out] prims Prims in the subtree(including the Prim at `path`) in
+  /// depth-first order.
+  /// @param[out] err Error message(filled when false is returned)
+  ///
+  /// @returns true if found a Prim at `path`.
+  bool find_prims_in_subtree(const Path &path, std::vector<const Prim *> *prims,
+                             std::string *err = nullptr) const;
+
   /// Find(Get) Prim from a relative Path.
   /// Path must be relative Path.
   ///
@@ -112,6 +132,8 @@ class Stage {
                             std::string *err = nullptr) const;
 
   // non-const version
+  // NOTE: Call `commit()` after adding or removing children of the returned
+  // Prim, so that the Prim lookup index is rebuilt.
   bool find_prim_by_prim_id(const uint64_t prim_id, Prim *&prim,
                             std::string *err = nullptr);
 
@@ -127,8 +149,14 @@ class Stage {
   ///
   /// @return Array of Root Prims.
   /// TODO: Deprecate non-const `root_prims()` API and use `add_root_prim()` instead.
+  /// NOTE: Prim lookup index is rebuilt on the next lookup(or `commit()`).
+  /// Call `commit()` when the Prim hierarchy is modified through the returned
+  /// reference after a lookup.
   ///
-  std::vector<Prim> &root_prims() { return _root_nodes; }
+  std::vector<Prim> &root_prims() {
+    _dirty = true;
+    return _root_nodes;
+  }
 
   ///
   /// Add Prim to root.
@@ -245,7 +273,7 @@ class Stage {
  private:
 
 #if defined(TINYUSDZ_ENABLE_THREAD)
-  mutable std::mutex _mutex;
+  mutable CopyableMutex _mutex;
 #endif
 
 #if 0 // Deprecated. remove.
@@ -295,17 +323,18 @@ class Stage {
   mutable std::string _err;
   mutable std::string _warn;
 
-  // Cached prim path.
-  // key : prim_part string (e.g. "/path/bora")
-  mutable std::map<std::string, const Prim *> _prim_path_cache;
-
-  // Cached prim_id -> Prim lookup
-  // key : prim_id
-  mutable std::map<uint64_t, const Prim *> _prim_id_cache;
+  ///
+  /// Rebuild `_prim_index` by traversing Prims(when `_dirty`).
+  ///
+  void build_prim_index() const;
 
-  mutable bool _dirty{true}; // True when Stage content changes(addition, deletion, composition/flatten, etc.)
+  // Prim path -> Prim and prim_id -> Prim lookup.
+  // Built in `compute_absolute_prim_path_and_assign_prim_id`, or lazily
+  // rebuilt on lookup when `_dirty`. A miss in the index is authoritative
+  // unless `_dirty`(e.g. the index could not be built for all Prims).
+  mutable PrimPathIndex _prim_index;
 
-  mutable bool _prim_id_dirty{true}; // True when Prim Id assignent changed(TODO: Unify with `_dirty` flag)
+  mutable bool _dirty{true}; // True when Stage content or Prim Id assignment changes(addition, deletion, composition/flatten, etc.)
 
   mutable HandleAllocator<uint64_t> _prim_id_allocator;
 };
@@ -293,11 +293,14 @@ class StreamReader {
       return false;
     }
 
-    float value{};
-    if (!read4(reinterpret_cast<int *>(&value))) {
+    uint32_t bits{0};
+    if (!read4(&bits)) {
       return false;
     }
 
+    // Do not write float through an integer pointer(strict aliasing).
+    float value;
+    memcpy(&value, &bits, sizeof(float));
     (*ret) = value;
 
     return true;
@@ -308,11 +311,13 @@ class StreamReader {
       return false;
     }
 
-    double value{};
-    if (!read8(reinterpret_cast<uint64_t *>(&value))) {
+    uint64_t bits{0};
+    if (!read8(&bits)) {
       return false;
     }
 
+    double value;
+    memcpy(&value, &bits, sizeof(double));
     (*ret) = value;
 
     return true;
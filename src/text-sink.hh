@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Simple text sink for serializers(e.g. USDA writer).
+//
+// Output is appended to a growable buffer, or to a FILE* through a fixed-size
+// buffer, so large documents can be written without building nested
+// temporary strings.
+//
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace tinyusdz {
+
+class TextSink {
+ public:
+  // Flush FILE* output when the buffer exceeds this size.
+  static constexpr size_t kDefaultFileBufferSize = 1024 * 1024;
+
+  ///
+  /// Write to the internal growable buffer. Use `str()` or `take()` to get
+  /// the result.
+  ///
+  TextSink() = default;
+
+  ///
+  /// Write to `fp`. `fp` is not closed by TextSink.
+  ///
+  explicit TextSink(FILE *fp,
+                    size_t buffer_size = kDefaultFileBufferSize)
+      : _fp(fp), _buffer_size(buffer_size) {
+    _buf.reserve(_buffer_size);
+  }
+
+  ~TextSink() { flush(); }
+
+  TextSink(const TextSink &) = delete;
+  TextSink &operator=(const TextSink &) = delete;
+
+  void write(const char *s, size_t n) {
+    if (n == 0) {
+      return;
+    }
+    _tail[0] = (n > 1) ? s[n - 2] : _tail[1];
+    _tail[1] = s[n - 1];
+
+    if (_fp && ((_buf.size() + n) > _buffer_size)) {
+      flush();
+      if (n > _buffer_size) {
+        // Write large data directly.
+        write_file(s, n);
+        return;
+      }
+    }
+    _buf.append(s, n);
+  }
+
+  void write(const std::string &s) { write(s.data(), s.size()); }
+
+  void write(const char *s) { write(s, strlen(s)); }
+
+  void write(const char c) { write(&c, 1); }
+
+  TextSink &operator<<(const std::string &s) {
+    write(s);
+    return *this;
+  }
+
+  TextSink &operator<<(const char *s) {
+    write(s);
+    return *this;
+  }
+
+  TextSink &operator<<(const char c) {
+    write(c);
+    return *this;
+  }
+
+  ///
+  /// Write other values(e.g. numbers, arrays) with their `operator<<` for
+  /// std::ostream. Formatted text goes to the sink directly.
+  ///
+  template <typename T>
+  TextSink &operator<<(const T &v) {
+    _os << v;
+    return *this;
+  }
+
+  ///
+  /// std::ostream which writes to this sink. Use it for printers which take
+  /// std::ostream.
+  ///
+  std::ostream &stream() { return _os; }
+
+  ///
+  /// @return true when the last two characters written are `c0` and `c1`.
+  ///
+  bool ends_with(const char c0, const char c1) const {
+    return (size() >= 2) && (_tail[0] == c0) && (_tail[1] == c1);
+  }
+
+  ///
+  /// Write buffered data to FILE*. No-op for buffer output.
+  ///
+  /// @return false when writing to FILE* failed(also reported by `ok()`).
+  ///
+  bool flush() {
+    if (_fp && _buf.size()) {
+      write_file(_buf.data(), _buf.size());
+      _buf.clear();
+    }
+    return _ok;
+  }
+
+  ///
+  /// @return false when any write to FILE* failed.
+  ///
+  bool ok() const { return _ok; }
+
+  ///
+  /// The number of bytes written so far.
+  ///
+  size_t size() const { return _fp ? (_written + _buf.size()) : _buf.size(); }
+
+  ///
+  /// Content of the buffer output.
+  ///
+  const std::string &str() const { return _buf; }
+
+  ///
+  /// Move the content of the buffer output out of TextSink.
+  ///
+  std::string take() {
+    std::string s;
+    s.swap(_buf);
+    return s;
+  }
+
+ private:
+  void write_file(const char *s, size_t n) {
+    if (!_ok) {
+      return;
+    }
+    size_t written = fwrite(s, /* size */ 1, /* count */ n, _fp);
+    _written += written;
+    if (written < n) {
+      _ok = false;
+    }
+  }
+
+  // Forwards std::ostream output to TextSink::write.
+  class Buf : public std::streambuf {
+   public:
+    explicit Buf(TextSink *w) : _w(w) {}
+
+   protected:
+    int_type overflow(int_type c) override {
+      if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        _w->write(traits_type::to_char_type(c));
+      }
+      return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+      _w->write(s, size_t(n));
+      return n;
+    }
+
+   private:
+    TextSink *_w;
+  };
+
+  FILE *_fp{nullptr};
+  size_t _buffer_size{0};
+  size_t _written{0};
+  bool _ok{true};
+  std::string _buf;
+  char _tail[2]{'\0', '\0'};
+  Buf _sbuf{this};
+  std::ostream _os{&_sbuf};
+};
+
+}  // namespace tinyusdz
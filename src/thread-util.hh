@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Simple threading utility.
+//
+// Worker threads are spawned only when TinyUSDZ is built with
+// `TINYUSDZ_ENABLE_THREAD`. Otherwise(and for WASI build) every function here
+// runs its work serially on the calling thread, so callers can use these
+// functions unconditionally.
+//
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(TINYUSDZ_ENABLE_THREAD) && !defined(__wasi__)
+#define TINYUSDZ_THREAD_UTIL_USE_STD_THREAD
+#include <thread>
+#endif
+
+namespace tinyusdz {
+namespace thread {
+
+// Limit to 1024 threads(same limit with CrateReaderConfig).
+constexpr int kMaxThreads = 1024;
+
+///
+/// Returns true when this build can spawn worker threads.
+///
+inline bool IsThreadingEnabled() {
+#if defined(TINYUSDZ_THREAD_UTIL_USE_STD_THREAD)
+  return true;
+#else
+  return false;
+#endif
+}
+
+///
+/// Resolve the number of threads to use.
+///
+/// @param[in] num_threads Requested number of threads. <= 0 = use system's #
+/// of threads.
+/// @return The number of threads in [1, kMaxThreads]. Always 1 when threading
+/// is disabled.
+///
+inline int GetNumThreads(int num_threads) {
+#if defined(TINYUSDZ_THREAD_UTIL_USE_STD_THREAD)
+  if (num_threads <= 0) {
+    num_threads = int(std::thread::hardware_concurrency());
+  }
+  return (std::max)(1, (std::min)(kMaxThreads, num_threads));
+#else
+  (void)num_threads;
+  return 1;
+#endif
+}
+
+///
+/// Call `func(i, thread_id)` for each i in [begin, end).
+///
+/// Items are handed out one at a time through an atomic counter, so `func` must
+/// not depend on the visiting order. `thread_id` is in [0, num_threads) and can
+/// be used to index per-thread scratch data. Write results to a preallocated
+/// slot indexed by `i` to get a deterministic output.
+///
+template <typename Func>
+void ParallelFor(size_t begin, size_t end, int num_threads, Func &&func) {
+  if (begin >= end) {
+    return;
+  }
+
+  size_t n = end - begin;
+  int nthreads = (std::min)(GetNumThreads(num_threads), int((std::min)(
+                                                       n, size_t(kMaxThreads))));
+
+  if (nthreads <= 1) {
+    for (size_t i = begin; i < end; i++) {
+      func(i, 0);
+    }
+    return;
+  }
+
+#if defined(TINYUSDZ_THREAD_UTIL_USE_STD_THREAD)
+  std::atomic<size_t> counter(begin);
+
+  auto worker = [&](int thread_id) {
+    size_t i;
+    while ((i = counter.fetch_add(1)) < end) {
+      func(i, thread_id);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(size_t(nthreads - 1));
+  for (int t = 1; t < nthreads; t++) {
+    workers.emplace_back(worker, t);
+  }
+
+  // Calling thread also works as thread 0.
+  worker(0);
+
+  for (auto &th : workers) {
+    th.join();
+  }
+#endif
+}
+
+///
+/// Split [begin, end) into contiguous ranges of `grain_size` items and call
+/// `func(range_begin, range_end, thread_id)` for each range.
+/// Useful when per-item work is too small to be dispatched one by one.
+///
+template <typename Func>
+void ParallelForRange(size_t begin, size_t end, size_t grain_size,
+                      int num_threads, Func &&func) {
+  if (begin >= end) {
+    return;
+  }
+
+  grain_size = (std::max)(size_t(1), grain_size);
+  size_t num_ranges = (end - begin + grain_size - 1) / grain_size;
+
+  ParallelFor(0, num_ranges, num_threads, [&](size_t r, int thread_id) {
+    size_t s = begin + r * grain_size;
+    size_t e = (std::min)(end, s + grain_size);
+    func(s, e, thread_id);
+  });
+}
+
+}  // namespace thread
+}  // namespace tinyusdz
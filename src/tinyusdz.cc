@@ -78,10 +78,15 @@ namespace tinyusdz {
   }
 //#define PushWarn(s) if (warn) { (*warn) += s; }
 
-bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
+namespace {
+
+// `data_owner` keeps the memory of `addr` alive for deferred values(can be
+// nullptr).
+bool LoadUSDCFromMemoryImpl(const uint8_t *addr, const size_t length,
                         const std::string &filename, Stage *stage,
                         std::string *warn, std::string *err,
-                        const USDLoadOptions &options) {
+                        const USDLoadOptions &options,
+                        const std::shared_ptr<const void> &data_owner) {
   if (stage == nullptr) {
     if (err) {
       (*err) = "null pointer for `stage` argument.\n";
@@ -125,7 +130,9 @@ bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
   usdc::USDCReaderConfig config;
   config.numThreads = options.num_threads;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
+  config.lazy_value_unpack = options.lazy_value_unpack;
   usdc::USDCReader reader(&sr, config);
+  reader.set_data_owner(data_owner);
 
   if (!reader.ReadUSDC()) {
     if (warn) {
@@ -171,51 +178,50 @@ bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
   return true;
 }
 
+}  // namespace
+
+bool LoadUSDCFromMemory(const uint8_t *addr, const size_t length,
+                        const std::string &filename, Stage *stage,
+                        std::string *warn, std::string *err,
+                        const USDLoadOptions &options) {
+  return LoadUSDCFromMemoryImpl(addr, length, filename, stage, warn, err,
+                                options, /* data_owner */ nullptr);
+}
+
 bool LoadUSDCFromFile(const std::string &_filename, Stage *stage,
                       std::string *warn, std::string *err,
                       const USDLoadOptions &options) {
   std::string filepath = io::ExpandFilePath(_filename, /* userdata */ nullptr);
 
   if (io::IsMMapSupported()) {
-    io::MMapFileHandle handle;
-    
-    {
-      std::string _err;
-      if (!io::MMapFile(filepath, &handle, /* writable */false, &_err)) {
-        if (err) {
-          (*err) += _err + "\n";
-        }
-        return false; 
-      }
-
-      if (_err.size()) {
-        if (warn) {
-          (*warn) += _err + "\n";
-        }
+    // Deferred values(`USDLoadOptions::lazy_value_unpack`) reference the
+    // memory-mapped file directly. The mapping is released when the last of
+    // them is materialized or destroyed(or just after loading when no
+    // deferred value exists).
+    std::string _err;
+    std::shared_ptr<io::MMapFileHandle> handle =
+        io::MMapFileShared(filepath, /* writable */ false, &_err);
+    if (!handle) {
+      if (err) {
+        (*err) += _err + "\n";
       }
+      return false;
     }
 
-    bool ret = LoadUSDCFromMemory(handle.addr, size_t(handle.size), filepath, stage, warn,
-                              err, options);
-
-    {
-      std::string _err;
-      // Ignore unmap result for now.
-      io::UnmapFile(handle, &_err);
-
-      if (_err.size()) {
-        if (warn) {
-          (*warn) += _err + "\n";
-        }
+    if (_err.size()) {
+      if (warn) {
+        (*warn) += _err + "\n";
       }
     }
 
-    return ret;
+    return LoadUSDCFromMemoryImpl(handle->addr, size_t(handle->size), filepath,
+                                  stage, warn, err, options, handle);
 
   } else {
-    std::vector<uint8_t> data;
+    // Deferred values keep the file content alive in lazy value unpacking mode.
+    auto data = std::make_shared<std::vector<uint8_t>>();
     size_t max_bytes = 1024 * 1024 * size_t(options.max_memory_limit_in_mb);
-    if (!io::ReadWholeFile(&data, err, filepath, max_bytes,
+    if (!io::ReadWholeFile(data.get(), err, filepath, max_bytes,
                            /* userdata */ nullptr)) {
       if (err) {
         (*err) += "File not found or failed to read : \"" + filepath + "\"\n";
@@ -224,9 +230,9 @@ bool LoadUSDCFromFile(const std::string &_filename, Stage *stage,
       return false;
     }
 
-    DCOUT("File size: " + std::to_string(data.size()) + " bytes.");
+    DCOUT("File size: " + std::to_string(data->size()) + " bytes.");
 
-    if (data.size() < (11 * 8)) {
+    if (data->size() < (11 * 8)) {
       // ???
       if (err) {
         (*err) += "File size too short. Looks like this file is not a USDC : \"" +
@@ -235,8 +241,8 @@ bool LoadUSDCFromFile(const std::string &_filename, Stage *stage,
       return false;
     }
 
-    return LoadUSDCFromMemory(data.data(), data.size(), filepath, stage, warn,
-                              err, options);
+    return LoadUSDCFromMemoryImpl(data->data(), data->size(), filepath, stage,
+                                  warn, err, options, data);
   }
 }
 
@@ -821,6 +827,37 @@ bool LoadUSDAFromFile(const std::string &_filename, Stage *stage,
   }
 }
 
+namespace {
+
+// `data_owner` keeps the memory of `addr` alive for deferred values of USDC
+// (can be nullptr).
+bool LoadUSDFromMemoryImpl(const uint8_t *addr, const size_t length,
+                           const std::string &base_dir, Stage *stage,
+                           std::string *warn, std::string *err,
+                           const USDLoadOptions &options,
+                           const std::shared_ptr<const void> &data_owner) {
+  if (IsUSDC(addr, length)) {
+    DCOUT("Detected as USDC.");
+    return LoadUSDCFromMemoryImpl(addr, length, base_dir, stage, warn, err,
+                                  options, data_owner);
+  } else if (IsUSDA(addr, length)) {
+    DCOUT("Detected as USDA.");
+    return LoadUSDAFromMemory(addr, length, base_dir, stage, warn, err,
+                              options);
+  } else if (IsUSDZ(addr, length)) {
+    DCOUT("Detected as USDZ.");
+    return LoadUSDZFromMemory(addr, length, base_dir, stage, warn, err,
+                              options);
+  } else {
+    if (err) {
+      (*err) += "Couldn't determine USD format(USDA/USDC/USDZ).\n";
+    }
+    return false;
+  }
+}
+
+}  // namespace
+
 bool LoadUSDFromFile(const std::string &_filename, Stage *stage,
                      std::string *warn, std::string *err,
                      const USDLoadOptions &options) {
@@ -828,50 +865,35 @@ bool LoadUSDFromFile(const std::string &_filename, Stage *stage,
   std::string base_dir = io::GetBaseDir(_filename);
 
   if (io::IsMMapSupported()) {
-    io::MMapFileHandle handle;
-    
-    {
-      std::string _err;
-      if (!io::MMapFile(filepath, &handle, /* writable */false, &_err)) {
-        if (err) {
-          (*err) += _err + "\n";
-        }
-        return false; 
-      }
-
-      if (_err.size()) {
-        if (warn) {
-          (*warn) += _err + "\n";
-        }
+    // See LoadUSDCFromFile.
+    std::string _err;
+    std::shared_ptr<io::MMapFileHandle> handle =
+        io::MMapFileShared(filepath, /* writable */ false, &_err);
+    if (!handle) {
+      if (err) {
+        (*err) += _err + "\n";
       }
+      return false;
     }
 
-    bool ret = LoadUSDFromMemory(handle.addr, size_t(handle.size), filepath, stage, warn,
-                              err, options);
-
-    {
-      std::string _err;
-      // Ignore unmap result for now.
-      io::UnmapFile(handle, &_err);
-
-      if (_err.size()) {
-        if (warn) {
-          (*warn) += _err + "\n";
-        }
+    if (_err.size()) {
+      if (warn) {
+        (*warn) += _err + "\n";
       }
     }
 
-    return ret;
+    return LoadUSDFromMemoryImpl(handle->addr, size_t(handle->size), filepath,
+                                 stage, warn, err, options, handle);
   } else {
-    std::vector<uint8_t> data;
+    auto data = std::make_shared<std::vector<uint8_t>>();
     size_t max_bytes = 1024 * 1024 * size_t(options.max_memory_limit_in_mb);
-    if (!io::ReadWholeFile(&data, err, filepath, max_bytes,
+    if (!io::ReadWholeFile(data.get(), err, filepath, max_bytes,
                            /* userdata */ nullptr)) {
       return false;
     }
 
-    return LoadUSDFromMemory(data.data(), data.size(), base_dir, stage, warn, err,
-                             options);
+    return LoadUSDFromMemoryImpl(data->data(), data->size(), base_dir, stage,
+                                 warn, err, options, data);
   }
 }
 
@@ -879,24 +901,8 @@ bool LoadUSDFromMemory(const uint8_t *addr, const size_t length,
                        const std::string &base_dir, Stage *stage,
                        std::string *warn, std::string *err,
                        const USDLoadOptions &options) {
-  if (IsUSDC(addr, length)) {
-    DCOUT("Detected as USDC.");
-    return LoadUSDCFromMemory(addr, length, base_dir, stage, warn, err,
-                              options);
-  } else if (IsUSDA(addr, length)) {
-    DCOUT("Detected as USDA.");
-    return LoadUSDAFromMemory(addr, length, base_dir, stage, warn, err,
-                              options);
-  } else if (IsUSDZ(addr, length)) {
-    DCOUT("Detected as USDZ.");
-    return LoadUSDZFromMemory(addr, length, base_dir, stage, warn, err,
-                              options);
-  } else {
-    if (err) {
-      (*err) += "Couldn't determine USD format(USDA/USDC/USDZ).\n";
-    }
-    return false;
-  }
+  return LoadUSDFromMemoryImpl(addr, length, base_dir, stage, warn, err,
+                               options, /* data_owner */ nullptr);
 }
 
 bool ReadUSDZAssetInfoFromMemory(const uint8_t *addr, const size_t length, const bool asset_on_memory, USDZAsset *asset,
@@ -1091,10 +1097,15 @@ bool IsUSD(const uint8_t *addr, const size_t length, std::string *detected_forma
   return false;
 }
 
-bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
+namespace {
+
+// `data_owner` keeps the memory of `addr` alive for deferred values(can be
+// nullptr).
+bool LoadUSDCLayerFromMemoryImpl(const uint8_t *addr, const size_t length,
                         const std::string &filename, Layer *layer,
                         std::string *warn, std::string *err,
-                        const USDLoadOptions &options) {
+                        const USDLoadOptions &options,
+                        const std::shared_ptr<const void> &data_owner) {
   if (layer == nullptr) {
     if (err) {
       (*err) = "null pointer for `layer` argument.\n";
@@ -1139,7 +1150,9 @@ bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
   config.numThreads = options.num_threads;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
   config.allow_unknown_apiSchemas = !options.strict_apiSchema_check;
+  config.lazy_value_unpack = options.lazy_value_unpack;
   usdc::USDCReader reader(&sr, config);
+  reader.set_data_owner(data_owner);
 
   if (!reader.ReadUSDC()) {
     if (warn) {
@@ -1184,6 +1197,16 @@ bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
   return true;
 }
 
+}  // namespace
+
+bool LoadUSDCLayerFromMemory(const uint8_t *addr, const size_t length,
+                        const std::string &filename, Layer *layer,
+                        std::string *warn, std::string *err,
+                        const USDLoadOptions &options) {
+  return LoadUSDCLayerFromMemoryImpl(addr, length, filename, layer, warn, err,
+                                     options, /* data_owner */ nullptr);
+}
+
 bool LoadUSDALayerFromMemory(const uint8_t *addr, const size_t length,
                        const std::string &asset_name, Layer *dst_layer,
                        std::string *warn, std::string *err,
@@ -1218,6 +1241,7 @@ bool LoadUSDALayerFromMemory(const uint8_t *addr, const size_t length,
 
   tinyusdz::usda::USDAReaderConfig config;
   config.strict_allowedToken_check = options.strict_allowedToken_check;
+  config.num_threads = options.num_threads;
   reader.set_reader_config(config);
 
   uint32_t load_states = static_cast<uint32_t>(tinyusdz::LoadState::Toplevel);
@@ -1280,18 +1304,21 @@ static bool PropagateAssetResolverState(uint32_t depth, PrimSpec &ps,
     return true;
 }
 
-bool LoadLayerFromMemory(const uint8_t *addr, const size_t length,
+namespace {
+
+bool LoadLayerFromMemoryImpl(const uint8_t *addr, const size_t length,
                        const std::string &asset_name, Layer *layer,
                        std::string *warn, std::string *err,
-                       const USDLoadOptions &options) {
+                       const USDLoadOptions &options,
+                       const std::shared_ptr<const void> &data_owner) {
 
   bool ret{false};
 
   if (IsUSDC(addr, length)) {
     DCOUT("Detected as USDC.");
 #if 1
-    ret = LoadUSDCLayerFromMemory(addr, length, asset_name, layer, warn, err,
-                              options);
+    ret = LoadUSDCLayerFromMemoryImpl(addr, length, asset_name, layer, warn,
+                                      err, options, data_owner);
 #else
     if (err) {
       (*err) += "TODO: Load USDC as Layer is not implemented yet.\n";
@@ -1333,6 +1360,16 @@ bool LoadLayerFromMemory(const uint8_t *addr, const size_t length,
   return ret;
 }
 
+}  // namespace
+
+bool LoadLayerFromMemory(const uint8_t *addr, const size_t length,
+                       const std::string &asset_name, Layer *layer,
+                       std::string *warn, std::string *err,
+                       const USDLoadOptions &options) {
+  return LoadLayerFromMemoryImpl(addr, length, asset_name, layer, warn, err,
+                                 options, /* data_owner */ nullptr);
+}
+
 bool LoadLayerFromFile(const std::string &_filename, Layer *stage,
                      std::string *warn, std::string *err,
                      const USDLoadOptions &options) {
@@ -1345,15 +1382,50 @@ bool LoadLayerFromFile(const std::string &_filename, Layer *stage,
   std::string filepath = io::ExpandFilePath(_filename, /* userdata */ nullptr);
   std::string base_dir = io::GetBaseDir(_filename);
 
-  std::vector<uint8_t> data;
   size_t max_bytes = 1024 * 1024 * size_t(options.max_memory_limit_in_mb);
-  if (!io::ReadWholeFile(&data, err, filepath, max_bytes,
+
+  if (options.lazy_value_unpack && io::IsMMapSupported()) {
+    // Deferred values reference the memory-mapped file directly. The mapping
+    // is kept alive by the deferred values and released when all of them are
+    // materialized or destroyed.
+    std::string _err;
+    std::shared_ptr<io::MMapFileHandle> handle =
+        io::MMapFileShared(filepath, /* writable */ false, &_err);
+    if (!handle) {
+      if (err) {
+        (*err) += _err + "\n";
+      }
+      return false;
+    }
+
+    if (_err.size()) {
+      if (warn) {
+        (*warn) += _err + "\n";
+      }
+    }
+
+    // Apply the same limit as reading the whole file into memory.
+    if ((max_bytes > 0) && (handle->size > uint64_t(max_bytes))) {
+      PUSH_ERROR_AND_RETURN("File size is too large : " + filepath +
+                            " sz = " + std::to_string(handle->size) +
+                            ", allowed max filesize = " +
+                            std::to_string(max_bytes));
+    }
+
+    return LoadLayerFromMemoryImpl(handle->addr, size_t(handle->size),
+                                   filepath, stage, warn, err, options,
+                                   handle);
+  }
+
+  // Deferred values keep the file content alive in lazy value unpacking mode.
+  auto data = std::make_shared<std::vector<uint8_t>>();
+  if (!io::ReadWholeFile(data.get(), err, filepath, max_bytes,
                          /* userdata */ nullptr)) {
     return false;
   }
 
-  return LoadLayerFromMemory(data.data(), data.size(), filepath, stage, warn, err,
-                           options);
+  return LoadLayerFromMemoryImpl(data->data(), data->size(), filepath, stage,
+                                 warn, err, options, data);
 }
 
 bool LoadLayerFromAsset(AssetResolutionResolver &resolver, const std::string &resolved_asset_name, Layer *layer,
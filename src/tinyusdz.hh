@@ -111,6 +111,24 @@ struct USDLoadOptions {
   /// apiSchema
   ///
   bool strict_apiSchema_check{false}; // Make parse error when unknown apiSchema
+
+  ///
+  /// Lazy value unpacking for USDC.
+  /// When true, large attribute values(numeric arrays and timeSamples) are not
+  /// decoded at load time. They are decoded on the first access to the value of
+  /// Attribute(PrimVar).
+  /// Effective for `LoadLayerFromFile`, `LoadUSDCFromFile` and
+  /// `LoadUSDFromFile`(for USDC). Deferred values reference the
+  /// (memory-mapped) file content, so it is kept in memory until all of them
+  /// are materialized or destroyed. `Load***FromMemory` does not own the
+  /// input memory and decodes values eagerly.
+  /// Use `PrimVar::get_array_view` to reference uncompressed array values in
+  /// the file without decoding them.
+  /// NOTE: Attributes of known Prim schemas(e.g. `points` of GeomMesh) are
+  /// decoded when reconstructing a Stage. Other attributes(e.g. primvars)
+  /// stay deferred.
+  ///
+  bool lazy_value_unpack{false};
   
   ///
   /// User-defined fileformat hander.
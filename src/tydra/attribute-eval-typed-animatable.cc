@@ -270,6 +270,48 @@ bool EvaluateTypedAnimatableAttribute(
 }
 
 
+template<typename T>
+bool EvaluateTypedAnimatableAttribute(
+    const tinyusdz::Stage &stage, const TypedAttribute<Animatable<T>> &tattr,
+    const std::string &attr_name,
+    const std::vector<double> &times,
+    std::vector<T> *values_out,
+    std::string *err,
+    const value::TimeSampleInterpolationType tinterp) {
+
+  if (!values_out) {
+    PUSH_ERROR_AND_RETURN("`values_out` param is nullptr.");
+  }
+
+  if (!tattr.is_blocked() && tattr.has_value()) {
+    Animatable<T> value;
+    if (tattr.get_value(&value)) {
+      if (value.get(times, values_out, tinterp)) {
+        return true;
+      } else {
+        if (err) {
+          (*err) += fmt::format("Failed to get TypedAnimatableAttribute value: {} \n", attr_name);
+        }
+        return false;
+      }
+    }
+  }
+
+  // Blocked, connection, etc. Evaluate each time.
+  values_out->resize(times.size());
+  for (size_t i = 0; i < times.size(); i++) {
+    T v;
+    if (!EvaluateTypedAnimatableAttribute(stage, tattr, attr_name, &v, err,
+                                          times[i], tinterp)) {
+      return false;
+    }
+    (*values_out)[i] = std::move(v);
+  }
+
+  return true;
+}
+
+
 // template instanciations
 #define EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE(__ty) \
 template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttribute<Animatable<__ty>> &attr, const std::string &attr_name, __ty *value, std::string *err, const double t, const value::TimeSampleInterpolationType tinterp);
@@ -278,6 +320,14 @@ APPLY_FUNC_TO_VALUE_TYPES_NO_STRING(EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE)
 
 #undef EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE
 
+#define EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE(__ty) \
+template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttribute<Animatable<__ty>> &attr, const std::string &attr_name, const std::vector<double> &times, std::vector<__ty> *values, std::string *err, const value::TimeSampleInterpolationType tinterp);
+
+APPLY_FUNC_TO_VALUE_TYPES_NO_STRING(EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE)
+EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE(std::string)
+
+#undef EVALUATE_TYPED_ATTRIBUTE_INSTANCIATE
+
 
 
 }  // namespace tydra
@@ -210,6 +210,33 @@ template<> bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, c
 
 #undef EXTERN_EVALUATE_TYPED_ATTRIBUTE
 
+///
+/// Evaluate Attribute at multiple times.
+///
+/// When the attribute has timesamples and `times` is sorted in ascending
+/// order, all values are evaluated in one pass over the timesamples.
+/// `values[i]` is the same value as the single-time version returns for
+/// `times[i]`.
+///
+template<typename T>
+bool EvaluateTypedAnimatableAttribute(
+    const tinyusdz::Stage &stage,
+    const TypedAttribute<Animatable<T>> &attr,
+    const std::string &attr_name,
+    const std::vector<double> &times,
+    std::vector<T> *values,
+    std::string *err,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp =
+        tinyusdz::value::TimeSampleInterpolationType::Linear);
+
+#define EXTERN_EVALUATE_TYPED_ATTRIBUTE(__ty) \
+extern template bool EvaluateTypedAnimatableAttribute(const tinyusdz::Stage &stage, const TypedAttribute<Animatable<__ty>> &attr, const std::string &attr_name, const std::vector<double> &times, std::vector<__ty> *values, std::string *err, const value::TimeSampleInterpolationType tinter);
+
+APPLY_FUNC_TO_VALUE_TYPES_NO_STRING(EXTERN_EVALUATE_TYPED_ATTRIBUTE)
+EXTERN_EVALUATE_TYPED_ATTRIBUTE(std::string)
+
+#undef EXTERN_EVALUATE_TYPED_ATTRIBUTE
+
 template<typename T>
 bool EvaluateTypedAttribute(
     const tinyusdz::Stage &stage,
@@ -0,0 +1,858 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "bbox-cache.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "common-macros.inc"
+#include "prim-types.hh"
+#include "thread-util.hh"
+#include "tiny-format.hh"
+#include "usdGeom.hh"
+#include "xform.hh"
+
+// src/tydra
+#include "attribute-eval.hh"
+#include "mesh-util.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+// For PUSH_ERROR_AND_RETURN
+#define PushError(msg) \
+  if (err) {           \
+    (*err) += msg;     \
+  }
+
+namespace {
+
+// The number of Prims processed by a thread at once.
+constexpr size_t kPrimGrainSize = 64;
+
+const GPrim *AsGPrim(const Prim &prim) {
+#define TRY_CAST(__ty)             \
+  if (auto pv = prim.as<__ty>()) { \
+    return pv;                     \
+  }
+
+  TRY_CAST(GPrim)
+  TRY_CAST(Xform)
+  TRY_CAST(GeomMesh)
+  TRY_CAST(GeomBasisCurves)
+  TRY_CAST(GeomNurbsCurves)
+  TRY_CAST(GeomCube)
+  TRY_CAST(GeomSphere)
+  TRY_CAST(GeomCylinder)
+  TRY_CAST(GeomCone)
+  TRY_CAST(GeomCapsule)
+  TRY_CAST(GeomPoints)
+  TRY_CAST(PointInstancer)
+  TRY_CAST(GeomCamera)
+
+#undef TRY_CAST
+
+  return nullptr;
+}
+
+bool HasGeometry(const Prim &prim) {
+  return prim.as<GeomMesh>() || prim.as<GeomBasisCurves>() ||
+         prim.as<GeomNurbsCurves>() || prim.as<GeomCube>() ||
+         prim.as<GeomSphere>() || prim.as<GeomCylinder>() ||
+         prim.as<GeomCone>() || prim.as<GeomCapsule>() ||
+         prim.as<GeomPoints>();
+}
+
+template <typename T>
+bool IsTimeVarying(const TypedAttributeWithFallback<Animatable<T>> &attr) {
+  return attr.get_value().has_timesamples();
+}
+
+// Geometry of the Prim is time-varying.
+bool IsGeometryTimeVarying(const Prim &prim, const bool use_extent) {
+  if (const GPrim *gprim = AsGPrim(prim)) {
+    if (use_extent && gprim->extent.has_timesamples()) {
+      return true;
+    }
+  }
+
+  if (auto pv = prim.as<GeomMesh>()) {
+    return pv->points.has_timesamples();
+  } else if (auto pv = prim.as<GeomPoints>()) {
+    return pv->points.has_timesamples() || pv->widths.has_timesamples();
+  } else if (auto pv = prim.as<GeomBasisCurves>()) {
+    return pv->points.has_timesamples() || pv->widths.has_timesamples();
+  } else if (auto pv = prim.as<GeomNurbsCurves>()) {
+    return pv->points.has_timesamples() || pv->widths.has_timesamples();
+  } else if (auto pv = prim.as<GeomCube>()) {
+    return IsTimeVarying(pv->size);
+  } else if (auto pv = prim.as<GeomSphere>()) {
+    return IsTimeVarying(pv->radius);
+  } else if (auto pv = prim.as<GeomCylinder>()) {
+    return IsTimeVarying(pv->radius) || IsTimeVarying(pv->height);
+  } else if (auto pv = prim.as<GeomCone>()) {
+    return IsTimeVarying(pv->radius) || IsTimeVarying(pv->height);
+  } else if (auto pv = prim.as<GeomCapsule>()) {
+    return IsTimeVarying(pv->radius) || IsTimeVarying(pv->height);
+  } else if (auto pv = prim.as<PointInstancer>()) {
+    return pv->protoIndices.has_timesamples() ||
+           pv->positions.has_timesamples() ||
+           pv->orientations.has_timesamples() ||
+           pv->scales.has_timesamples() || pv->ids.has_timesamples() ||
+           pv->invisibleIds.has_timesamples();
+  }
+
+  return false;
+}
+
+std::vector<std::string> GetPrototypePaths(const PointInstancer &instancer) {
+  std::vector<std::string> paths;
+  if (instancer.prototypes.has_value()) {
+    const Relationship &rel = instancer.prototypes.value();
+    if (rel.is_path()) {
+      paths.push_back(rel.targetPath.full_path_name());
+    } else if (rel.is_pathvector()) {
+      for (const auto &path : rel.targetPathVector) {
+        paths.push_back(path.full_path_name());
+      }
+    }
+  }
+  return paths;
+}
+
+AABB PointsBound(const std::vector<value::point3f> &points,
+                 const float max_width) {
+  static_assert(sizeof(value::point3f) == sizeof(value::float3),
+                "point3f must be tightly packed.");
+
+  value::float3 lower, upper;
+  ComputePointsBounds(reinterpret_cast<const value::float3 *>(points.data()),
+                      points.size(), &lower, &upper);
+
+  AABB bound;
+  if (points.empty()) {
+    return bound;
+  }
+
+  const double r = 0.5 * double(max_width);
+  for (size_t i = 0; i < 3; i++) {
+    bound.lower[i] = double(lower[i]) - r;
+    bound.upper[i] = double(upper[i]) + r;
+  }
+  return bound;
+}
+
+// Bounds of Cylinder, Cone and Capsule. `cap` = extra length at both ends
+// along the axis.
+AABB AxisShapeBound(const Axis axis, const double radius, const double height,
+                    const double cap) {
+  AABB bound;
+  const double h = 0.5 * height + cap;
+  const size_t ax = (axis == Axis::X) ? 0 : ((axis == Axis::Y) ? 1 : 2);
+  for (size_t i = 0; i < 3; i++) {
+    const double e = (i == ax) ? h : radius;
+    bound.lower[i] = -std::fabs(e);
+    bound.upper[i] = std::fabs(e);
+  }
+  return bound;
+}
+
+template <typename T>
+bool EvalFallback(const TypedAttributeWithFallback<Animatable<T>> &attr,
+                  const double t,
+                  const value::TimeSampleInterpolationType tinterp, T *v) {
+  if (attr.get_value().get(t, v, tinterp)) {
+    return true;
+  }
+  return false;
+}
+
+float MaxWidth(const tinyusdz::Stage &stage,
+               const TypedAttribute<Animatable<std::vector<float>>> &widths,
+               const double t,
+               const value::TimeSampleInterpolationType tinterp) {
+  if (!widths.authored()) {
+    return 0.0f;
+  }
+
+  std::vector<float> values;
+  if (!EvaluateTypedAnimatableAttribute(stage, widths, "widths", &values,
+                                        /* err */ nullptr, t, tinterp)) {
+    return 0.0f;
+  }
+
+  float w = 0.0f;
+  for (const auto &v : values) {
+    w = (std::max)(w, v);
+  }
+  return w;
+}
+
+}  // namespace
+
+void AABB::extend(const value::double3 &p) {
+  for (size_t i = 0; i < 3; i++) {
+    lower[i] = (std::min)(lower[i], p[i]);
+    upper[i] = (std::max)(upper[i], p[i]);
+  }
+}
+
+void AABB::extend(const AABB &b) {
+  if (b.is_empty()) {
+    return;
+  }
+  extend(b.lower);
+  extend(b.upper);
+}
+
+AABB AABB::transform(const value::matrix4d &m) const {
+  if (is_empty()) {
+    return AABB();
+  }
+
+  // Arvo's method: accumulate min/max of each matrix element contribution.
+  AABB ret;
+  for (size_t j = 0; j < 3; j++) {
+    ret.lower[j] = m.m[3][j];
+    ret.upper[j] = m.m[3][j];
+    for (size_t i = 0; i < 3; i++) {
+      const double a = m.m[i][j] * lower[i];
+      const double b = m.m[i][j] * upper[i];
+      ret.lower[j] += (std::min)(a, b);
+      ret.upper[j] += (std::max)(a, b);
+    }
+  }
+  return ret;
+}
+
+value::double3 AABB::center() const {
+  return {0.5 * (lower[0] + upper[0]), 0.5 * (lower[1] + upper[1]),
+          0.5 * (lower[2] + upper[2])};
+}
+
+value::double3 AABB::size() const {
+  if (is_empty()) {
+    return {0.0, 0.0, 0.0};
+  }
+  return {upper[0] - lower[0], upper[1] - lower[1], upper[2] - lower[2]};
+}
+
+bool BBoxCache::BuildRec(const Prim &prim, const std::string &parent_abs_path,
+                         const int64_t parent, const bool excluded,
+                         const bool instanced, std::string *err) {
+  const size_t idx = _entries.size();
+
+  {
+    Entry entry;
+    entry.prim = &prim;
+    entry.abs_path = parent_abs_path + "/" + prim.element_name();
+    entry.parent = parent;
+    entry.excluded = excluded;
+    entry.instanced = instanced;
+
+    if (const GPrim *gprim = AsGPrim(prim)) {
+      const Purpose purpose = gprim->purpose.get_value();
+      // `default` purpose inherits the purpose of the parent.
+      if ((purpose != Purpose::Default) &&
+          (std::find(_config.purposes.begin(), _config.purposes.end(),
+                     purpose) == _config.purposes.end())) {
+        entry.excluded = true;
+      }
+      entry.visibility_varying = IsTimeVarying(gprim->visibility);
+    }
+
+    if (!UpdateVisibility(entry, err)) {
+      return false;
+    }
+
+    if (HasGeometry(prim)) {
+      entry.geom_type = GeomType::Gprim;
+    } else if (prim.as<PointInstancer>()) {
+      entry.geom_type = GeomType::Instancer;
+    }
+
+    if (entry.geom_type != GeomType::None) {
+      entry.geom_varying = IsGeometryTimeVarying(prim, _config.use_extent);
+    }
+
+    _path_to_entry[entry.abs_path] = idx;
+    _entries.emplace_back(std::move(entry));
+  }
+
+  // Take a copy since `_entries` may be reallocated.
+  const std::string abs_path = _entries[idx].abs_path;
+  const bool child_excluded = _entries[idx].excluded;
+  const bool child_instanced =
+      instanced || (_entries[idx].geom_type == GeomType::Instancer);
+
+  for (const auto &child : prim.children()) {
+    if (!BuildRec(child, abs_path, int64_t(idx), child_excluded,
+                  child_instanced, err)) {
+      return false;
+    }
+  }
+
+  _entries[idx].subtree_end = _entries.size();
+
+  return true;
+}
+
+bool BBoxCache::UpdateVisibility(Entry &entry, std::string *err) const {
+  (void)err;
+
+  entry.invisible = false;
+
+  if (const GPrim *gprim = AsGPrim(*entry.prim)) {
+    Visibility vis{Visibility::Inherited};
+    if (EvalFallback(gprim->visibility, GetTime(), _xform_cache.GetInterpolationType(), &vis)) {
+      entry.invisible = (vis == Visibility::Invisible);
+    }
+  }
+
+  return true;
+}
+
+bool BBoxCache::ComputeGprimBound(Entry &entry, std::string *err) const {
+  const Prim &prim = *entry.prim;
+  const double t = GetTime();
+  const value::TimeSampleInterpolationType tinterp = _xform_cache.GetInterpolationType();
+
+  AABB bound;
+
+  // Authored extent
+  const GPrim *gprim = AsGPrim(prim);
+  if (_config.use_extent && gprim && gprim->extent.authored()) {
+    Extent extent;
+    const auto ext = gprim->extent.get_value();
+    if (ext && ext.value().get(t, &extent, tinterp)) {
+      for (size_t i = 0; i < 3; i++) {
+        bound.lower[i] = double(extent.lower[i]);
+        bound.upper[i] = double(extent.upper[i]);
+      }
+      entry.local_bound = bound;
+      return true;
+    }
+  }
+
+  if (auto pv = prim.as<GeomMesh>()) {
+    std::vector<value::point3f> points;
+    if (pv->points.authored()) {
+      if (!EvaluateTypedAnimatableAttribute(*_stage, pv->points, "points",
+                                            &points, err, t, tinterp)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to evaluate `points` of {}", entry.abs_path));
+      }
+    }
+    bound = PointsBound(points, 0.0f);
+  } else if (auto pv = prim.as<GeomPoints>()) {
+    std::vector<value::point3f> points;
+    if (pv->points.authored()) {
+      if (!EvaluateTypedAnimatableAttribute(*_stage, pv->points, "points",
+                                            &points, err, t, tinterp)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to evaluate `points` of {}", entry.abs_path));
+      }
+    }
+    bound = PointsBound(points, MaxWidth(*_stage, pv->widths, t, tinterp));
+  } else if (auto pv = prim.as<GeomBasisCurves>()) {
+    std::vector<value::point3f> points;
+    if (pv->points.authored()) {
+      if (!EvaluateTypedAnimatableAttribute(*_stage, pv->points, "points",
+                                            &points, err, t, tinterp)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to evaluate `points` of {}", entry.abs_path));
+      }
+    }
+    // Control points of cubic curves bound the curve(convex hull property).
+    bound = PointsBound(points, MaxWidth(*_stage, pv->widths, t, tinterp));
+  } else if (auto pv = prim.as<GeomNurbsCurves>()) {
+    std::vector<value::point3f> points;
+    if (pv->points.authored()) {
+      if (!EvaluateTypedAnimatableAttribute(*_stage, pv->points, "points",
+                                            &points, err, t, tinterp)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to evaluate `points` of {}", entry.abs_path));
+      }
+    }
+    bound = PointsBound(points, MaxWidth(*_stage, pv->widths, t, tinterp));
+  } else if (auto pv = prim.as<GeomCube>()) {
+    double size{2.0};
+    EvalFallback(pv->size, t, tinterp, &size);
+    const double h = 0.5 * std::fabs(size);
+    bound.lower = {-h, -h, -h};
+    bound.upper = {h, h, h};
+  } else if (auto pv = prim.as<GeomSphere>()) {
+    double radius{1.0};
+    EvalFallback(pv->radius, t, tinterp, &radius);
+    const double r = std::fabs(radius);
+    bound.lower = {-r, -r, -r};
+    bound.upper = {r, r, r};
+  } else if (auto pv = prim.as<GeomCylinder>()) {
+    double radius{1.0}, height{2.0};
+    EvalFallback(pv->radius, t, tinterp, &radius);
+    EvalFallback(pv->height, t, tinterp, &height);
+    bound = AxisShapeBound(pv->axis.get_value(), radius, height, 0.0);
+  } else if (auto pv = prim.as<GeomCone>()) {
+    double radius{1.0}, height{2.0};
+    EvalFallback(pv->radius, t, tinterp, &radius);
+    EvalFallback(pv->height, t, tinterp, &height);
+    bound = AxisShapeBound(pv->axis.get_value(), radius, height, 0.0);
+  } else if (auto pv = prim.as<GeomCapsule>()) {
+    double radius{0.5}, height{1.0};
+    EvalFallback(pv->radius, t, tinterp, &radius);
+    EvalFallback(pv->height, t, tinterp, &height);
+    bound = AxisShapeBound(pv->axis.get_value(), radius, height,
+                           std::fabs(radius));
+  }
+
+  entry.local_bound = bound;
+
+  return true;
+}
+
+void BBoxCache::ComputePrototypeBoundRec(const size_t idx,
+                                         const value::matrix4d &parent_matrix,
+                                         AABB *bound) const {
+  const Entry &entry = _entries[idx];
+  if (entry.excluded || entry.invisible) {
+    return;
+  }
+
+  value::matrix4d local;
+  bool resetXformStack{false};
+  if (!_xform_cache.GetLocalMatrix(entry.abs_path, &local, &resetXformStack)) {
+    return;
+  }
+
+  const value::matrix4d m =
+      resetXformStack ? local : (local * parent_matrix);
+
+  // NOTE: Nested PointInstancer in the prototype is not supported.
+  if (entry.geom_type == GeomType::Gprim) {
+    bound->extend(entry.local_bound.transform(m));
+  }
+
+  size_t child = idx + 1;
+  while (child < entry.subtree_end) {
+    ComputePrototypeBoundRec(child, m, bound);
+    child = _entries[child].subtree_end;
+  }
+}
+
+bool BBoxCache::ComputeInstancerBound(Entry &entry, std::string *err) const {
+  const PointInstancer *instancer = entry.prim->as<PointInstancer>();
+  if (!instancer) {
+    return true;
+  }
+
+  entry.own_bound = AABB();
+
+  const double t = GetTime();
+  const value::TimeSampleInterpolationType tinterp = _xform_cache.GetInterpolationType();
+
+  //
+  // Bounds of prototypes(relative to the PointInstancer).
+  //
+  const std::vector<std::string> proto_paths = GetPrototypePaths(*instancer);
+  std::vector<AABB> proto_bounds(proto_paths.size());
+  for (size_t p = 0; p < proto_paths.size(); p++) {
+    const auto it = _path_to_entry.find(proto_paths[p]);
+    if (it != _path_to_entry.end()) {
+      ComputePrototypeBoundRec(it->second, value::matrix4d::identity(),
+                               &proto_bounds[p]);
+    }
+  }
+
+  if (proto_bounds.empty() || !instancer->protoIndices.authored()) {
+    return true;
+  }
+
+  std::vector<int32_t> protoIndices;
+  if (!EvaluateTypedAnimatableAttribute(*_stage, instancer->protoIndices,
+                                        "protoIndices", &protoIndices, err, t,
+                                        tinterp)) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "Failed to evaluate `protoIndices` of {}", entry.abs_path));
+  }
+
+  const size_t num_instances = protoIndices.size();
+
+  std::vector<value::point3f> positions;
+  if (instancer->positions.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(*_stage, instancer->positions,
+                                          "positions", &positions, err, t,
+                                          tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `positions` of {}", entry.abs_path));
+    }
+  }
+
+  if (positions.size() != num_instances) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "`positions`.size {} must be equal to `protoIndices`.size {} : {}",
+        positions.size(), num_instances, entry.abs_path));
+  }
+
+  std::vector<value::quath> orientations;
+  if (instancer->orientations.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(*_stage, instancer->orientations,
+                                          "orientations", &orientations, err,
+                                          t, tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `orientations` of {}", entry.abs_path));
+    }
+    if (orientations.size() != num_instances) {
+      orientations.clear();
+    }
+  }
+
+  std::vector<value::float3> scales;
+  if (instancer->scales.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(*_stage, instancer->scales, "scales",
+                                          &scales, err, t, tinterp)) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Failed to evaluate `scales` of {}", entry.abs_path));
+    }
+    if (scales.size() != num_instances) {
+      scales.clear();
+    }
+  }
+
+  // `invisibleIds` refers `ids`, or the instance index when `ids` is not
+  // authored.
+  std::vector<int64_t> invisibleIds;
+  std::vector<int64_t> ids;
+  if (instancer->invisibleIds.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(*_stage, instancer->invisibleIds,
+                                          "invisibleIds", &invisibleIds, err,
+                                          t, tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `invisibleIds` of {}", entry.abs_path));
+    }
+    std::sort(invisibleIds.begin(), invisibleIds.end());
+
+    if (invisibleIds.size() && instancer->ids.authored()) {
+      if (!EvaluateTypedAnimatableAttribute(*_stage, instancer->ids, "ids",
+                                            &ids, err, t, tinterp)) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Failed to evaluate `ids` of {}", entry.abs_path));
+      }
+      if (ids.size() != num_instances) {
+        ids.clear();
+      }
+    }
+  }
+
+  value::matrix4d world;
+  if (!_xform_cache.GetWorldMatrix(entry.abs_path, &world)) {
+    return true;
+  }
+
+  for (size_t i = 0; i < num_instances; i++) {
+    const int32_t proto_id = protoIndices[i];
+    if ((proto_id < 0) || (size_t(proto_id) >= proto_bounds.size()) ||
+        proto_bounds[size_t(proto_id)].is_empty()) {
+      continue;
+    }
+
+    if (invisibleIds.size()) {
+      const int64_t id = ids.empty() ? int64_t(i) : ids[i];
+      if (std::binary_search(invisibleIds.begin(), invisibleIds.end(), id)) {
+        continue;
+      }
+    }
+
+    // M = scale * orientation * translate(row-major)
+    const value::float3 s =
+        scales.empty() ? value::float3{1.0f, 1.0f, 1.0f} : scales[i];
+
+    value::matrix3d r = value::matrix3d::identity();
+    if (orientations.size()) {
+      r = to_matrix3x3(orientations[i]);
+    }
+
+    value::matrix4d m = value::matrix4d::identity();
+    for (size_t row = 0; row < 3; row++) {
+      for (size_t col = 0; col < 3; col++) {
+        m.m[row][col] = double(s[row]) * r.m[row][col];
+      }
+    }
+    m.m[3][0] = double(positions[i][0]);
+    m.m[3][1] = double(positions[i][1]);
+    m.m[3][2] = double(positions[i][2]);
+
+    entry.own_bound.extend(
+        proto_bounds[size_t(proto_id)].transform(m * world));
+  }
+
+  return true;
+}
+
+bool BBoxCache::ComputeOwnBounds(const std::vector<size_t> &gprims,
+                                 const std::vector<size_t> &instancers,
+                                 std::string *err) {
+  const int nthreads = thread::GetNumThreads(_config.num_threads);
+
+  // Build Prim index of Stage before spawning threads, since Prim lookup(e.g.
+  // for attribute connection) lazily (re)builds it.
+  if ((nthreads > 1) && !_entries.empty()) {
+    (void)_stage->GetPrimAtPath(Path(_entries[0].abs_path, ""));
+  }
+
+  // Error of each thread.
+  std::vector<std::string> errs(size_t((std::max)(1, nthreads)));
+
+  // Geometries first, since prototypes of PointInstancers refer them.
+  thread::ParallelForRange(
+      0, gprims.size(), kPrimGrainSize, nthreads,
+      [&](size_t begin, size_t end, int thread_id) {
+        std::string *thread_err = &errs[size_t(thread_id)];
+        for (size_t i = begin; i < end; i++) {
+          Entry &entry = _entries[gprims[i]];
+          if (!ComputeGprimBound(entry, thread_err)) {
+            return;
+          }
+
+          value::matrix4d world;
+          if (_xform_cache.GetWorldMatrix(entry.abs_path, &world)) {
+            entry.own_bound = entry.local_bound.transform(world);
+          }
+        }
+      });
+
+  thread::ParallelForRange(
+      0, instancers.size(), 1, nthreads,
+      [&](size_t begin, size_t end, int thread_id) {
+        std::string *thread_err = &errs[size_t(thread_id)];
+        for (size_t i = begin; i < end; i++) {
+          if (!ComputeInstancerBound(_entries[instancers[i]], thread_err)) {
+            return;
+          }
+        }
+      });
+
+  bool ok = true;
+  for (const auto &e : errs) {
+    if (e.size()) {
+      PushError(e);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+void BBoxCache::UpdateSubtreeBound(const size_t idx) {
+  Entry &entry = _entries[idx];
+  entry.subtree_bound = AABB();
+
+  if (entry.excluded || entry.invisible || entry.instanced) {
+    return;
+  }
+
+  entry.subtree_bound = entry.own_bound;
+
+  size_t child = idx + 1;
+  while (child < entry.subtree_end) {
+    entry.subtree_bound.extend(_entries[child].subtree_bound);
+    child = _entries[child].subtree_end;
+  }
+}
+
+bool BBoxCache::Build(const tinyusdz::Stage &stage,
+                      const BBoxCacheConfig &config, const double t,
+                      const tinyusdz::value::TimeSampleInterpolationType tinterp,
+                      std::string *err) {
+  _stage = &stage;
+  _config = config;
+  _entries.clear();
+  _path_to_entry.clear();
+  _varying_entries.clear();
+  _stage_bound = AABB();
+
+  if (!_xform_cache.Build(stage, t, tinterp, err)) {
+    return false;
+  }
+
+  for (const auto &root : stage.root_prims()) {
+    if (!BuildRec(root, /* parent_abs_path */ "", /* parent */ -1,
+                  /* excluded */ false, /* instanced */ false, err)) {
+      return false;
+    }
+  }
+
+  std::vector<size_t> gprims;
+  std::vector<size_t> instancers;
+  for (size_t i = 0; i < _entries.size(); i++) {
+    const Entry &entry = _entries[i];
+    if (entry.excluded) {
+      continue;
+    }
+
+    if (entry.geom_type == GeomType::Gprim) {
+      gprims.push_back(i);
+    } else if (entry.geom_type == GeomType::Instancer) {
+      instancers.push_back(i);
+    }
+
+    if (entry.visibility_varying || entry.geom_varying ||
+        _xform_cache.IsTimeVarying(entry.abs_path)) {
+      _varying_entries.push_back(i);
+    }
+  }
+
+  // PointInstancer whose prototypes change over time.
+  for (const size_t idx : instancers) {
+    Entry &entry = _entries[idx];
+    for (const auto &proto_path :
+         GetPrototypePaths(*entry.prim->as<PointInstancer>())) {
+      const auto it = _path_to_entry.find(proto_path);
+      if (it == _path_to_entry.end()) {
+        continue;
+      }
+      for (size_t i = it->second; i < _entries[it->second].subtree_end; i++) {
+        if (_entries[i].geom_varying || _entries[i].visibility_varying ||
+            _xform_cache.IsTimeVarying(_entries[i].abs_path)) {
+          entry.geom_varying = true;
+        }
+      }
+    }
+
+    if (entry.geom_varying && !std::binary_search(_varying_entries.begin(),
+                                                  _varying_entries.end(),
+                                                  idx)) {
+      _varying_entries.insert(std::upper_bound(_varying_entries.begin(),
+                                               _varying_entries.end(), idx),
+                              idx);
+    }
+  }
+
+  if (!ComputeOwnBounds(gprims, instancers, err)) {
+    return false;
+  }
+
+  for (size_t i = _entries.size(); i > 0; i--) {
+    UpdateSubtreeBound(i - 1);
+  }
+
+  size_t idx = 0;
+  while (idx < _entries.size()) {
+    _stage_bound.extend(_entries[idx].subtree_bound);
+    idx = _entries[idx].subtree_end;
+  }
+
+  _dirty.assign(_entries.size(), 0);
+
+  return true;
+}
+
+bool BBoxCache::SetTime(
+    const double t, const tinyusdz::value::TimeSampleInterpolationType tinterp,
+    std::string *err) {
+  const double prev_t = _xform_cache.GetTime();
+  const value::TimeSampleInterpolationType prev_tinterp =
+      _xform_cache.GetInterpolationType();
+
+  const bool same_time = (value::TimeCode(t).is_default() &&
+                          value::TimeCode(prev_t).is_default()) ||
+                         (t == prev_t);
+  if (same_time && (tinterp == prev_tinterp)) {
+    return true;
+  }
+
+  if (!_xform_cache.SetTime(t, tinterp, err)) {
+    return false;
+  }
+
+  std::vector<size_t> gprims;
+  std::vector<size_t> instancers;
+  std::vector<size_t> dirty;
+
+  for (const size_t idx : _varying_entries) {
+    Entry &entry = _entries[idx];
+
+    if (entry.visibility_varying) {
+      if (!UpdateVisibility(entry, err)) {
+        return false;
+      }
+    }
+
+    if (entry.geom_type == GeomType::Gprim) {
+      if (entry.geom_varying) {
+        gprims.push_back(idx);
+      } else {
+        // Only the transform(or visibility) changes. Reuse the local bound.
+        value::matrix4d world;
+        if (_xform_cache.GetWorldMatrix(entry.abs_path, &world)) {
+          entry.own_bound = entry.local_bound.transform(world);
+        }
+      }
+    } else if (entry.geom_type == GeomType::Instancer) {
+      instancers.push_back(idx);
+    }
+
+    dirty.push_back(idx);
+  }
+
+  if (!ComputeOwnBounds(gprims, instancers, err)) {
+    return false;
+  }
+
+  // Mark ancestors of updated entries.
+  for (size_t i = 0; i < dirty.size(); i++) {
+    int64_t idx = int64_t(dirty[i]);
+    while ((idx >= 0) && !_dirty[size_t(idx)]) {
+      _dirty[size_t(idx)] = 1;
+      if (size_t(idx) != dirty[i]) {
+        dirty.push_back(size_t(idx));
+      }
+      idx = _entries[size_t(idx)].parent;
+    }
+  }
+
+  // Children are placed after their parent in DFS pre-order.
+  std::sort(dirty.begin(), dirty.end(), std::greater<size_t>());
+  for (const size_t idx : dirty) {
+    UpdateSubtreeBound(idx);
+    _dirty[idx] = 0;
+  }
+
+  _stage_bound = AABB();
+  size_t idx = 0;
+  while (idx < _entries.size()) {
+    _stage_bound.extend(_entries[idx].subtree_bound);
+    idx = _entries[idx].subtree_end;
+  }
+
+  return true;
+}
+
+bool BBoxCache::ComputeWorldBound(const std::string &abs_path,
+                                  AABB *bound) const {
+  const auto it = _path_to_entry.find(abs_path);
+  if ((it == _path_to_entry.end()) || !bound) {
+    return false;
+  }
+
+  (*bound) = _entries[it->second].subtree_bound;
+
+  return true;
+}
+
+bool BBoxCache::ComputeLocalBound(const std::string &abs_path,
+                                  AABB *bound) const {
+  const auto it = _path_to_entry.find(abs_path);
+  if ((it == _path_to_entry.end()) || !bound) {
+    return false;
+  }
+
+  (*bound) = _entries[it->second].local_bound;
+
+  return true;
+}
+
+#undef PushError
+
+}  // namespace tydra
+}  // namespace tinyusdz
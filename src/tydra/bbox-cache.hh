@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Bounding box computation of Prims at a timecode(similar to
+// UsdGeomBBoxCache in pxrUSD).
+//
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "scene-access.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+///
+/// Axis-aligned bounding box(double precision).
+/// Default constructed box is empty.
+///
+struct AABB {
+  value::double3 lower{{std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity()}};
+  value::double3 upper{{-std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity()}};
+
+  bool is_empty() const {
+    return (lower[0] > upper[0]) || (lower[1] > upper[1]) ||
+           (lower[2] > upper[2]);
+  }
+
+  void extend(const value::double3 &p);
+  void extend(const AABB &b);
+
+  ///
+  /// @return Bounding box of this box transformed by `m`(row-major).
+  ///
+  AABB transform(const value::matrix4d &m) const;
+
+  value::double3 center() const;
+  value::double3 size() const;
+};
+
+struct BBoxCacheConfig {
+  // Use authored `extent` of Gprims. When false(or `extent` is not authored),
+  // bounds are computed from `points`(+ `widths`) or shape parameters(e.g.
+  // `radius` of Sphere).
+  bool use_extent{true};
+
+  // Prims whose `purpose` is not in this list are ignored(with their
+  // descendants).
+  std::vector<Purpose> purposes{Purpose::Default};
+
+  // The number of threads to compute bounds. -1 = use # of system threads.
+  // Worker threads are only spawned when TinyUSDZ is built with
+  // `TINYUSDZ_ENABLE_THREAD`.
+  int num_threads{-1};
+};
+
+///
+/// Cache of world-space bounding boxes of Prims and their subtrees.
+///
+/// - Invisible Prims(`visibility = invisible`) are ignored with their
+///   descendants.
+/// - Instances of PointInstancer are included in the bounds of the
+///   PointInstancer. Prims under the PointInstancer(i.e. prototypes) are only
+///   counted through instances.
+/// - Bounds of geometries are computed in parallel in `Build`. `SetTime`
+///   only recomputes time-varying geometries(Prims whose world matrix
+///   changed just transform their cached local bounds), then updates the
+///   subtree bounds of their ancestors.
+///
+/// Like XformNode, the cache holds pointers to Prims. Please call `Build`
+/// again when the content of Stage is changed.
+///
+class BBoxCache {
+ public:
+  bool Build(const tinyusdz::Stage &stage,
+             const BBoxCacheConfig &config = BBoxCacheConfig(),
+             const double t = tinyusdz::value::TimeCode::Default(),
+             const tinyusdz::value::TimeSampleInterpolationType tinterp =
+                 tinyusdz::value::TimeSampleInterpolationType::Linear,
+             std::string *err = nullptr);
+
+  ///
+  /// Update bounds to time `t`.
+  ///
+  bool SetTime(const double t,
+               const tinyusdz::value::TimeSampleInterpolationType tinterp =
+                   tinyusdz::value::TimeSampleInterpolationType::Linear,
+               std::string *err = nullptr);
+
+  double GetTime() const { return _xform_cache.GetTime(); }
+
+  ///
+  /// World-space bounds of the Prim and its descendants.
+  ///
+  /// @param[in] abs_path Absolute Prim path(e.g. "/xform/geom0")
+  /// @param[out] bound Bounds. Empty when there is no geometry.
+  ///
+  /// @return false when Prim is not found.
+  ///
+  bool ComputeWorldBound(const std::string &abs_path, AABB *bound) const;
+
+  ///
+  /// Bounds of the Prim's own geometry in its local space(`xformOps` are not
+  /// applied). Descendants are not included.
+  ///
+  /// @return false when Prim is not found.
+  ///
+  bool ComputeLocalBound(const std::string &abs_path, AABB *bound) const;
+
+  ///
+  /// @return World-space bounds of all Prims in Stage.
+  ///
+  const AABB &GetStageBound() const { return _stage_bound; }
+
+  const XformCache &GetXformCache() const { return _xform_cache; }
+
+ private:
+  enum class GeomType {
+    None,
+    Gprim,     // Prim with geometry
+    Instancer  // PointInstancer
+  };
+
+  // Prim in DFS pre-order.
+  struct Entry {
+    const Prim *prim{nullptr};
+    std::string abs_path;
+    int64_t parent{-1};     // index to `_entries`. -1 = root Prim
+    size_t subtree_end{0};  // (the index of the last descendant) + 1
+
+    GeomType geom_type{GeomType::None};
+    bool excluded{false};   // excluded by purpose
+    bool instanced{false};  // under PointInstancer
+    bool invisible{false};
+    bool visibility_varying{false};
+    bool geom_varying{false};  // geometry(or instances) changes over time
+
+    AABB local_bound;    // Own geometry in local space.
+    AABB own_bound;      // Own geometry(or instances) in world space.
+    AABB subtree_bound;  // Memoized world bounds of the subtree.
+  };
+
+  bool BuildRec(const Prim &prim, const std::string &parent_abs_path,
+                const int64_t parent, const bool excluded,
+                const bool instanced, std::string *err);
+
+  bool UpdateVisibility(Entry &entry, std::string *err) const;
+  bool ComputeGprimBound(Entry &entry, std::string *err) const;
+  bool ComputeInstancerBound(Entry &entry, std::string *err) const;
+
+  // Bounds of the prototype subtree in the space of the prototype's parent.
+  void ComputePrototypeBoundRec(const size_t idx,
+                                const value::matrix4d &parent_matrix,
+                                AABB *bound) const;
+
+  bool ComputeOwnBounds(const std::vector<size_t> &gprims,
+                        const std::vector<size_t> &instancers,
+                        std::string *err);
+
+  void UpdateSubtreeBound(const size_t idx);
+
+  const tinyusdz::Stage *_stage{nullptr};
+  BBoxCacheConfig _config;
+  XformCache _xform_cache;
+
+  std::vector<Entry> _entries;
+  std::map<std::string, size_t> _path_to_entry;
+
+  // Entries re-evaluated in `SetTime`.
+  std::vector<size_t> _varying_entries;
+
+  std::vector<uint8_t> _dirty;  // scratch for `SetTime`
+  AABB _stage_bound;
+};
+
+}  // namespace tydra
+}  // namespace tinyusdz
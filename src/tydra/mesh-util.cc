@@ -0,0 +1,1163 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "mesh-util.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <sstream>
+
+#include "common-macros.inc"
+#include "thread-util.hh"
+#include "tiny-format.hh"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TINYUSDZ_MESH_UTIL_USE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// AVX2 kernels are compiled with the `target` attribute(`-mavx2` is not
+// required) and selected at runtime.
+// NOTE: FMA is not enabled, since the compiler contracts `a * b - c` into FMA
+// and results would differ from the SSE2/scalar code.
+#define TINYUSDZ_MESH_UTIL_USE_AVX2
+#define TINYUSDZ_MESH_UTIL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define TINYUSDZ_MESH_UTIL_USE_AVX2
+#define TINYUSDZ_MESH_UTIL_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+// vsqrtq_f32/vdivq_f32 are only available on AArch64.
+#define TINYUSDZ_MESH_UTIL_USE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace tinyusdz {
+namespace tydra {
+
+// For PUSH_ERROR_AND_RETURN
+#define PushError(msg) \
+  if (err) {           \
+    (*err) += msg;     \
+  }
+
+namespace {
+
+// Use threads when the mesh has this number of faces or more. Spawning threads
+// does not pay off for smaller meshes.
+constexpr size_t kParallelMinFaces = 1024 * 32;
+constexpr size_t kFaceGrainSize = 1024 * 8;
+
+// Squared length threshold of NormalizeVectors.
+constexpr float kMinSquaredLength = (std::numeric_limits<float>::min)();
+
+//
+// Unnormalized face normal(= cross product of the first two edges, in CCW
+// manner). Its length is twice the area of the triangle, so accumulating it
+// gives an area-weighted normal without computing the area.
+//
+inline void FaceNormal(const value::float3 *points, const uint32_t *fv,
+                       float *nx, float *ny, float *nz) {
+  const value::float3 &p0 = points[fv[0]];
+  const value::float3 &p1 = points[fv[1]];
+  const value::float3 &p2 = points[fv[2]];
+
+  const float e1x = p1[0] - p0[0];
+  const float e1y = p1[1] - p0[1];
+  const float e1z = p1[2] - p0[2];
+
+  const float e2x = p2[0] - p0[0];
+  const float e2y = p2[1] - p0[1];
+  const float e2z = p2[2] - p0[2];
+
+  (*nx) = e1y * e2z - e1z * e2y;
+  (*ny) = e1z * e2x - e1x * e2z;
+  (*nz) = e1x * e2y - e1y * e2x;
+}
+
+inline void NormalizeVector(float *x, float *y, float *z) {
+  const float d2 = (*x) * (*x) + (*y) * (*y) + (*z) * (*z);
+  if (d2 > kMinSquaredLength) {
+    const float len = std::sqrt(d2);
+    (*x) = (*x) / len;
+    (*y) = (*y) / len;
+    (*z) = (*z) / len;
+  } else {
+    (*x) = 0.0f;
+    (*y) = 0.0f;
+    (*z) = 0.0f;
+  }
+}
+
+#if defined(TINYUSDZ_MESH_UTIL_USE_AVX2)
+
+constexpr size_t kAVX2Width = 8;
+
+// Gather offsets(point index * 3) must fit in int32.
+constexpr size_t kAVX2MaxPoints =
+    size_t((std::numeric_limits<int32_t>::max)()) / 3;
+
+bool CPUSupportsAVX2() {
+#if defined(__AVX2__)
+  return true;
+#elif defined(__GNUC__) || defined(__clang__)
+  static const bool supported = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return supported;
+#else
+  return false;
+#endif
+}
+
+//
+// Face normals of 8 faces at once from [begin, end). Returns the index of the
+// first face not processed.
+//
+TINYUSDZ_MESH_UTIL_TARGET_AVX2
+size_t FaceNormalsAVX2(const value::float3 *points, const uint32_t *indices,
+                       const size_t *offsets, size_t begin, size_t end,
+                       float *nx, float *ny, float *nz) {
+  const float *xyz = reinterpret_cast<const float *>(points);
+
+  size_t f = begin;
+  for (; (f + kAVX2Width) <= end; f += kAVX2Width) {
+    // [vertex][component] of the first three vertices of 8 faces.
+    __m256 p[3][3];
+    for (size_t k = 0; k < 3; k++) {
+      const __m256i vidx = _mm256_setr_epi32(
+          int(indices[offsets[f + 0] + k]), int(indices[offsets[f + 1] + k]),
+          int(indices[offsets[f + 2] + k]), int(indices[offsets[f + 3] + k]),
+          int(indices[offsets[f + 4] + k]), int(indices[offsets[f + 5] + k]),
+          int(indices[offsets[f + 6] + k]), int(indices[offsets[f + 7] + k]));
+      const __m256i idx = _mm256_add_epi32(_mm256_slli_epi32(vidx, 1), vidx);
+      p[k][0] = _mm256_i32gather_ps(xyz + 0, idx, 4);
+      p[k][1] = _mm256_i32gather_ps(xyz + 1, idx, 4);
+      p[k][2] = _mm256_i32gather_ps(xyz + 2, idx, 4);
+    }
+
+    const __m256 e1x = _mm256_sub_ps(p[1][0], p[0][0]);
+    const __m256 e1y = _mm256_sub_ps(p[1][1], p[0][1]);
+    const __m256 e1z = _mm256_sub_ps(p[1][2], p[0][2]);
+
+    const __m256 e2x = _mm256_sub_ps(p[2][0], p[0][0]);
+    const __m256 e2y = _mm256_sub_ps(p[2][1], p[0][1]);
+    const __m256 e2z = _mm256_sub_ps(p[2][2], p[0][2]);
+
+    _mm256_storeu_ps(nx + f, _mm256_sub_ps(_mm256_mul_ps(e1y, e2z),
+                                           _mm256_mul_ps(e1z, e2y)));
+    _mm256_storeu_ps(ny + f, _mm256_sub_ps(_mm256_mul_ps(e1z, e2x),
+                                           _mm256_mul_ps(e1x, e2z)));
+    _mm256_storeu_ps(nz + f, _mm256_sub_ps(_mm256_mul_ps(e1x, e2y),
+                                           _mm256_mul_ps(e1y, e2x)));
+  }
+
+  return f;
+}
+
+// Normalize 8 vectors at once. Returns the number of vectors processed.
+TINYUSDZ_MESH_UTIL_TARGET_AVX2
+size_t NormalizeAVX2(float *x, float *y, float *z, size_t n) {
+  size_t i = 0;
+  for (; (i + kAVX2Width) <= n; i += kAVX2Width) {
+    const __m256 vx = _mm256_loadu_ps(x + i);
+    const __m256 vy = _mm256_loadu_ps(y + i);
+    const __m256 vz = _mm256_loadu_ps(z + i);
+
+    const __m256 d2 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)),
+        _mm256_mul_ps(vz, vz));
+    const __m256 mask =
+        _mm256_cmp_ps(d2, _mm256_set1_ps(kMinSquaredLength), _CMP_GT_OQ);
+    const __m256 len = _mm256_sqrt_ps(d2);
+
+    // NaN of masked-out lanes(0/0) is cleared by `and`.
+    _mm256_storeu_ps(x + i, _mm256_and_ps(mask, _mm256_div_ps(vx, len)));
+    _mm256_storeu_ps(y + i, _mm256_and_ps(mask, _mm256_div_ps(vy, len)));
+    _mm256_storeu_ps(z + i, _mm256_and_ps(mask, _mm256_div_ps(vz, len)));
+  }
+
+  return i;
+}
+
+// Min/max of `num_blocks` * 8 points. 8 points(24 floats) are loaded into 3
+// registers, so lane `i` of `lower/upper`(24 floats) holds the component
+// (i % 3).
+TINYUSDZ_MESH_UTIL_TARGET_AVX2
+void PointsBoundsAVX2(const float *xyz, size_t num_blocks, float *lower,
+                      float *upper) {
+  __m256 mn0 = _mm256_loadu_ps(xyz + 0);
+  __m256 mn1 = _mm256_loadu_ps(xyz + 8);
+  __m256 mn2 = _mm256_loadu_ps(xyz + 16);
+  __m256 mx0 = mn0;
+  __m256 mx1 = mn1;
+  __m256 mx2 = mn2;
+
+  for (size_t b = 1; b < num_blocks; b++) {
+    const float *p = xyz + 24 * b;
+    const __m256 v0 = _mm256_loadu_ps(p + 0);
+    const __m256 v1 = _mm256_loadu_ps(p + 8);
+    const __m256 v2 = _mm256_loadu_ps(p + 16);
+    mn0 = _mm256_min_ps(mn0, v0);
+    mn1 = _mm256_min_ps(mn1, v1);
+    mn2 = _mm256_min_ps(mn2, v2);
+    mx0 = _mm256_max_ps(mx0, v0);
+    mx1 = _mm256_max_ps(mx1, v1);
+    mx2 = _mm256_max_ps(mx2, v2);
+  }
+
+  _mm256_storeu_ps(lower + 0, mn0);
+  _mm256_storeu_ps(lower + 8, mn1);
+  _mm256_storeu_ps(lower + 16, mn2);
+  _mm256_storeu_ps(upper + 0, mx0);
+  _mm256_storeu_ps(upper + 8, mx1);
+  _mm256_storeu_ps(upper + 16, mx2);
+}
+
+#endif
+
+#if defined(TINYUSDZ_MESH_UTIL_USE_SSE2)
+
+constexpr size_t kSIMDWidth = 4;
+
+#define GATHER4(__k, __c)                                                  \
+  _mm_setr_ps(points[fv[0][__k]][__c], points[fv[1][__k]][__c],            \
+              points[fv[2][__k]][__c], points[fv[3][__k]][__c])
+
+inline void FaceNormalsSIMD(const value::float3 *points,
+                            const uint32_t *indices, const size_t *offsets,
+                            size_t f, float *nx, float *ny, float *nz) {
+  const uint32_t *fv[kSIMDWidth];
+  for (size_t k = 0; k < kSIMDWidth; k++) {
+    fv[k] = indices + offsets[f + k];
+  }
+
+  const __m128 p0x = GATHER4(0, 0);
+  const __m128 p0y = GATHER4(0, 1);
+  const __m128 p0z = GATHER4(0, 2);
+
+  const __m128 e1x = _mm_sub_ps(GATHER4(1, 0), p0x);
+  const __m128 e1y = _mm_sub_ps(GATHER4(1, 1), p0y);
+  const __m128 e1z = _mm_sub_ps(GATHER4(1, 2), p0z);
+
+  const __m128 e2x = _mm_sub_ps(GATHER4(2, 0), p0x);
+  const __m128 e2y = _mm_sub_ps(GATHER4(2, 1), p0y);
+  const __m128 e2z = _mm_sub_ps(GATHER4(2, 2), p0z);
+
+  _mm_storeu_ps(nx + f,
+                _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y)));
+  _mm_storeu_ps(ny + f,
+                _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z)));
+  _mm_storeu_ps(nz + f,
+                _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x)));
+}
+
+#undef GATHER4
+
+inline void NormalizeSIMD(float *x, float *y, float *z) {
+  const __m128 vx = _mm_loadu_ps(x);
+  const __m128 vy = _mm_loadu_ps(y);
+  const __m128 vz = _mm_loadu_ps(z);
+
+  const __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+                               _mm_mul_ps(vz, vz));
+  const __m128 mask = _mm_cmpgt_ps(d2, _mm_set1_ps(kMinSquaredLength));
+  const __m128 len = _mm_sqrt_ps(d2);
+
+  // NaN of masked-out lanes(0/0) is cleared by `and`.
+  _mm_storeu_ps(x, _mm_and_ps(mask, _mm_div_ps(vx, len)));
+  _mm_storeu_ps(y, _mm_and_ps(mask, _mm_div_ps(vy, len)));
+  _mm_storeu_ps(z, _mm_and_ps(mask, _mm_div_ps(vz, len)));
+}
+
+// Min/max of `num_blocks` * 4 points. 4 points(12 floats) are loaded into 3
+// registers, so lane `i` of `lower/upper`(12 floats) holds the component
+// (i % 3).
+inline void PointsBoundsSIMD(const float *xyz, size_t num_blocks,
+                             float *lower, float *upper) {
+  __m128 mn0 = _mm_loadu_ps(xyz + 0);
+  __m128 mn1 = _mm_loadu_ps(xyz + 4);
+  __m128 mn2 = _mm_loadu_ps(xyz + 8);
+  __m128 mx0 = mn0;
+  __m128 mx1 = mn1;
+  __m128 mx2 = mn2;
+
+  for (size_t b = 1; b < num_blocks; b++) {
+    const float *p = xyz + 12 * b;
+    const __m128 v0 = _mm_loadu_ps(p + 0);
+    const __m128 v1 = _mm_loadu_ps(p + 4);
+    const __m128 v2 = _mm_loadu_ps(p + 8);
+    mn0 = _mm_min_ps(mn0, v0);
+    mn1 = _mm_min_ps(mn1, v1);
+    mn2 = _mm_min_ps(mn2, v2);
+    mx0 = _mm_max_ps(mx0, v0);
+    mx1 = _mm_max_ps(mx1, v1);
+    mx2 = _mm_max_ps(mx2, v2);
+  }
+
+  _mm_storeu_ps(lower + 0, mn0);
+  _mm_storeu_ps(lower + 4, mn1);
+  _mm_storeu_ps(lower + 8, mn2);
+  _mm_storeu_ps(upper + 0, mx0);
+  _mm_storeu_ps(upper + 4, mx1);
+  _mm_storeu_ps(upper + 8, mx2);
+}
+
+#elif defined(TINYUSDZ_MESH_UTIL_USE_NEON)
+
+constexpr size_t kSIMDWidth = 4;
+
+inline float32x4_t Gather4(const value::float3 *points,
+                           const uint32_t *const *fv, int k, int c) {
+  const float v[4] = {points[fv[0][k]][size_t(c)], points[fv[1][k]][size_t(c)],
+                      points[fv[2][k]][size_t(c)], points[fv[3][k]][size_t(c)]};
+  return vld1q_f32(v);
+}
+
+inline void FaceNormalsSIMD(const value::float3 *points,
+                            const uint32_t *indices, const size_t *offsets,
+                            size_t f, float *nx, float *ny, float *nz) {
+  const uint32_t *fv[kSIMDWidth];
+  for (size_t k = 0; k < kSIMDWidth; k++) {
+    fv[k] = indices + offsets[f + k];
+  }
+
+  const float32x4_t p0x = Gather4(points, fv, 0, 0);
+  const float32x4_t p0y = Gather4(points, fv, 0, 1);
+  const float32x4_t p0z = Gather4(points, fv, 0, 2);
+
+  const float32x4_t e1x = vsubq_f32(Gather4(points, fv, 1, 0), p0x);
+  const float32x4_t e1y = vsubq_f32(Gather4(points, fv, 1, 1), p0y);
+  const float32x4_t e1z = vsubq_f32(Gather4(points, fv, 1, 2), p0z);
+
+  const float32x4_t e2x = vsubq_f32(Gather4(points, fv, 2, 0), p0x);
+  const float32x4_t e2y = vsubq_f32(Gather4(points, fv, 2, 1), p0y);
+  const float32x4_t e2z = vsubq_f32(Gather4(points, fv, 2, 2), p0z);
+
+  // Do not use vfmsq_f32, to get the same result with the scalar code.
+  vst1q_f32(nx + f, vsubq_f32(vmulq_f32(e1y, e2z), vmulq_f32(e1z, e2y)));
+  vst1q_f32(ny + f, vsubq_f32(vmulq_f32(e1z, e2x), vmulq_f32(e1x, e2z)));
+  vst1q_f32(nz + f, vsubq_f32(vmulq_f32(e1x, e2y), vmulq_f32(e1y, e2x)));
+}
+
+inline void NormalizeSIMD(float *x, float *y, float *z) {
+  const float32x4_t vx = vld1q_f32(x);
+  const float32x4_t vy = vld1q_f32(y);
+  const float32x4_t vz = vld1q_f32(z);
+
+  const float32x4_t d2 =
+      vaddq_f32(vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy)),
+                vmulq_f32(vz, vz));
+  const uint32x4_t mask = vcgtq_f32(d2, vdupq_n_f32(kMinSquaredLength));
+  const float32x4_t len = vsqrtq_f32(d2);
+
+  // NaN of masked-out lanes(0/0) is cleared by `and`.
+  vst1q_f32(x, vreinterpretq_f32_u32(vandq_u32(
+                   mask, vreinterpretq_u32_f32(vdivq_f32(vx, len)))));
+  vst1q_f32(y, vreinterpretq_f32_u32(vandq_u32(
+                   mask, vreinterpretq_u32_f32(vdivq_f32(vy, len)))));
+  vst1q_f32(z, vreinterpretq_f32_u32(vandq_u32(
+                   mask, vreinterpretq_u32_f32(vdivq_f32(vz, len)))));
+}
+
+// Min/max of `num_blocks` * 4 points. 4 points(12 floats) are loaded into 3
+// registers, so lane `i` of `lower/upper`(12 floats) holds the component
+// (i % 3).
+inline void PointsBoundsSIMD(const float *xyz, size_t num_blocks,
+                             float *lower, float *upper) {
+  float32x4_t mn0 = vld1q_f32(xyz + 0);
+  float32x4_t mn1 = vld1q_f32(xyz + 4);
+  float32x4_t mn2 = vld1q_f32(xyz + 8);
+  float32x4_t mx0 = mn0;
+  float32x4_t mx1 = mn1;
+  float32x4_t mx2 = mn2;
+
+  for (size_t b = 1; b < num_blocks; b++) {
+    const float *p = xyz + 12 * b;
+    const float32x4_t v0 = vld1q_f32(p + 0);
+    const float32x4_t v1 = vld1q_f32(p + 4);
+    const float32x4_t v2 = vld1q_f32(p + 8);
+    mn0 = vminq_f32(mn0, v0);
+    mn1 = vminq_f32(mn1, v1);
+    mn2 = vminq_f32(mn2, v2);
+    mx0 = vmaxq_f32(mx0, v0);
+    mx1 = vmaxq_f32(mx1, v1);
+    mx2 = vmaxq_f32(mx2, v2);
+  }
+
+  vst1q_f32(lower + 0, mn0);
+  vst1q_f32(lower + 4, mn1);
+  vst1q_f32(lower + 8, mn2);
+  vst1q_f32(upper + 0, mx0);
+  vst1q_f32(upper + 4, mx1);
+  vst1q_f32(upper + 8, mx2);
+}
+
+#endif
+
+// Compute face normals of faces [begin, end).
+void FaceNormals(const value::float3 *points, size_t num_points,
+                 const uint32_t *indices, const size_t *offsets, size_t begin,
+                 size_t end, float *nx, float *ny, float *nz) {
+  size_t f = begin;
+#if defined(TINYUSDZ_MESH_UTIL_USE_AVX2)
+  if ((num_points <= kAVX2MaxPoints) && CPUSupportsAVX2()) {
+    f = FaceNormalsAVX2(points, indices, offsets, f, end, nx, ny, nz);
+  }
+#else
+  (void)num_points;
+#endif
+#if defined(TINYUSDZ_MESH_UTIL_USE_SSE2) || \
+    defined(TINYUSDZ_MESH_UTIL_USE_NEON)
+  for (; (f + kSIMDWidth) <= end; f += kSIMDWidth) {
+    FaceNormalsSIMD(points, indices, offsets, f, nx, ny, nz);
+  }
+#endif
+  for (; f < end; f++) {
+    FaceNormal(points, indices + offsets[f], nx + f, ny + f, nz + f);
+  }
+}
+
+}  // namespace
+
+void NormalizeVectors(float *x, float *y, float *z, size_t n) {
+  size_t i = 0;
+#if defined(TINYUSDZ_MESH_UTIL_USE_AVX2)
+  if (CPUSupportsAVX2()) {
+    i = NormalizeAVX2(x, y, z, n);
+  }
+#endif
+#if defined(TINYUSDZ_MESH_UTIL_USE_SSE2) || \
+    defined(TINYUSDZ_MESH_UTIL_USE_NEON)
+  for (; (i + kSIMDWidth) <= n; i += kSIMDWidth) {
+    NormalizeSIMD(x + i, y + i, z + i);
+  }
+#endif
+  for (; i < n; i++) {
+    NormalizeVector(x + i, y + i, z + i);
+  }
+}
+
+void ComputePointsBounds(const value::float3 *points, size_t n,
+                         value::float3 *lower, value::float3 *upper) {
+  const float kInf = std::numeric_limits<float>::infinity();
+  value::float3 bmin{kInf, kInf, kInf};
+  value::float3 bmax{-kInf, -kInf, -kInf};
+
+  size_t i = 0;
+#if defined(TINYUSDZ_MESH_UTIL_USE_AVX2)
+  if (CPUSupportsAVX2() && (n >= kAVX2Width)) {
+    const size_t num_blocks = n / kAVX2Width;
+    float lane_min[3 * kAVX2Width];
+    float lane_max[3 * kAVX2Width];
+    PointsBoundsAVX2(reinterpret_cast<const float *>(points), num_blocks,
+                     lane_min, lane_max);
+    for (size_t k = 0; k < 3 * kAVX2Width; k++) {
+      bmin[k % 3] = (std::min)(bmin[k % 3], lane_min[k]);
+      bmax[k % 3] = (std::max)(bmax[k % 3], lane_max[k]);
+    }
+    i = num_blocks * kAVX2Width;
+  }
+#endif
+#if defined(TINYUSDZ_MESH_UTIL_USE_SSE2) || \
+    defined(TINYUSDZ_MESH_UTIL_USE_NEON)
+  static_assert(sizeof(value::float3) == sizeof(float) * 3,
+                "float3 must be tightly packed.");
+  const size_t num_blocks = (n - i) / kSIMDWidth;
+  if (num_blocks) {
+    float lane_min[3 * kSIMDWidth];
+    float lane_max[3 * kSIMDWidth];
+    PointsBoundsSIMD(reinterpret_cast<const float *>(points + i), num_blocks,
+                     lane_min, lane_max);
+    for (size_t k = 0; k < 3 * kSIMDWidth; k++) {
+      bmin[k % 3] = (std::min)(bmin[k % 3], lane_min[k]);
+      bmax[k % 3] = (std::max)(bmax[k % 3], lane_max[k]);
+    }
+    i += num_blocks * kSIMDWidth;
+  }
+#endif
+  for (; i < n; i++) {
+    for (size_t c = 0; c < 3; c++) {
+      bmin[c] = (std::min)(bmin[c], points[i][c]);
+      bmax[c] = (std::max)(bmax[c], points[i][c]);
+    }
+  }
+
+  if (lower) {
+    (*lower) = bmin;
+  }
+  if (upper) {
+    (*upper) = bmax;
+  }
+}
+
+const char *GetMeshUtilSIMDName() {
+#if defined(TINYUSDZ_MESH_UTIL_USE_AVX2)
+  if (CPUSupportsAVX2()) {
+    return "avx2";
+  }
+#endif
+#if defined(TINYUSDZ_MESH_UTIL_USE_SSE2)
+  return "sse2";
+#elif defined(TINYUSDZ_MESH_UTIL_USE_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+bool ComputeVertexNormals(const std::vector<value::float3> &points,
+                          const std::vector<uint32_t> &faceVertexCounts,
+                          const std::vector<uint32_t> &faceVertexIndices,
+                          std::vector<value::float3> *normals,
+                          std::string *err, int num_threads) {
+  if (!normals) {
+    PUSH_ERROR_AND_RETURN("`normals` arg is nullptr.");
+  }
+
+  const size_t num_points = points.size();
+  const size_t num_faces = faceVertexCounts.size();
+
+  //
+  // 1. Validate topology and compute the offset to faceVertexIndices for each
+  //    face.
+  //
+  std::vector<size_t> offsets(num_faces);
+  size_t faceVertexIndexOffset{0};
+  for (size_t f = 0; f < num_faces; f++) {
+    size_t nv = faceVertexCounts[f];
+
+    if (nv < 3) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Invalid face num {} at faceVertexCounts[{}]", nv, f));
+    }
+
+    if ((faceVertexIndexOffset + nv) > faceVertexIndices.size()) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "faceVertexIndices.size {} is too short for faceVertexCounts.",
+          faceVertexIndices.size()));
+    }
+
+    offsets[f] = faceVertexIndexOffset;
+    faceVertexIndexOffset += nv;
+  }
+
+  for (size_t i = 0; i < faceVertexIndexOffset; i++) {
+    if (faceVertexIndices[i] >= num_points) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("faceVertexIndices[{}] {} exceeds points.size {}", i,
+                      faceVertexIndices[i], num_points));
+    }
+  }
+
+  const int nthreads =
+      (num_faces >= kParallelMinFaces) ? thread::GetNumThreads(num_threads) : 1;
+
+  //
+  // 2. Face normals(SoA)
+  //
+  std::vector<float> fnx(num_faces);
+  std::vector<float> fny(num_faces);
+  std::vector<float> fnz(num_faces);
+
+  thread::ParallelForRange(
+      0, num_faces, kFaceGrainSize, nthreads,
+      [&](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        FaceNormals(points.data(), num_points, faceVertexIndices.data(),
+                    offsets.data(), begin, end, fnx.data(), fny.data(),
+                    fnz.data());
+      });
+
+  //
+  // 3. Accumulate face normals to vertices.
+  //
+  std::vector<float> nx(num_points, 0.0f);
+  std::vector<float> ny(num_points, 0.0f);
+  std::vector<float> nz(num_points, 0.0f);
+
+  if (nthreads > 1) {
+    // Build vertex -> face table and gather face normals for each vertex, so
+    // that each vertex is written by one thread only. Faces are stored in
+    // ascending order, so the sum is identical to the serial scatter below.
+    std::vector<uint32_t> vertex_face_offsets(num_points + 1, 0);
+    for (size_t i = 0; i < faceVertexIndexOffset; i++) {
+      vertex_face_offsets[faceVertexIndices[i] + 1]++;
+    }
+    for (size_t v = 0; v < num_points; v++) {
+      vertex_face_offsets[v + 1] += vertex_face_offsets[v];
+    }
+
+    std::vector<uint32_t> vertex_faces(faceVertexIndexOffset);
+    {
+      std::vector<uint32_t> cursor(vertex_face_offsets.begin(),
+                                   vertex_face_offsets.end() - 1);
+      for (size_t f = 0; f < num_faces; f++) {
+        for (size_t v = 0; v < faceVertexCounts[f]; v++) {
+          uint32_t vidx = faceVertexIndices[offsets[f] + v];
+          vertex_faces[cursor[vidx]++] = uint32_t(f);
+        }
+      }
+    }
+
+    thread::ParallelForRange(
+        0, num_points, kFaceGrainSize, nthreads,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          for (size_t v = begin; v < end; v++) {
+            float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+            for (uint32_t k = vertex_face_offsets[v];
+                 k < vertex_face_offsets[v + 1]; k++) {
+              sx += fnx[vertex_faces[k]];
+              sy += fny[vertex_faces[k]];
+              sz += fnz[vertex_faces[k]];
+            }
+            nx[v] = sx;
+            ny[v] = sy;
+            nz[v] = sz;
+          }
+        });
+  } else {
+    for (size_t f = 0; f < num_faces; f++) {
+      for (size_t v = 0; v < faceVertexCounts[f]; v++) {
+        uint32_t vidx = faceVertexIndices[offsets[f] + v];
+        nx[vidx] += fnx[f];
+        ny[vidx] += fny[f];
+        nz[vidx] += fnz[f];
+      }
+    }
+  }
+
+  //
+  // 4. Normalize
+  //
+  thread::ParallelForRange(
+      0, num_points, kFaceGrainSize, nthreads,
+      [&](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        NormalizeVectors(nx.data() + begin, ny.data() + begin,
+                         nz.data() + begin, end - begin);
+      });
+
+  normals->resize(num_points);
+  for (size_t v = 0; v < num_points; v++) {
+    (*normals)[v] = {nx[v], ny[v], nz[v]};
+  }
+
+  return true;
+}
+
+namespace {
+
+//
+// Symmetric 4x4 quadric matrix(upper triangle) of the squared distance to
+// planes, with the sum of plane weights(areas).
+//
+struct Quadric {
+  double a00{0.0}, a01{0.0}, a02{0.0}, a03{0.0};
+  double a11{0.0}, a12{0.0}, a13{0.0};
+  double a22{0.0}, a23{0.0};
+  double a33{0.0};
+  double w{0.0};
+
+  // Add the plane `n.p + d = 0`(`n` is unit length) weighted by `weight`.
+  void add_plane(const double n[3], const double d, const double weight) {
+    a00 += weight * n[0] * n[0];
+    a01 += weight * n[0] * n[1];
+    a02 += weight * n[0] * n[2];
+    a03 += weight * n[0] * d;
+    a11 += weight * n[1] * n[1];
+    a12 += weight * n[1] * n[2];
+    a13 += weight * n[1] * d;
+    a22 += weight * n[2] * n[2];
+    a23 += weight * n[2] * d;
+    a33 += weight * d * d;
+    w += weight;
+  }
+
+  void add(const Quadric &q) {
+    a00 += q.a00;
+    a01 += q.a01;
+    a02 += q.a02;
+    a03 += q.a03;
+    a11 += q.a11;
+    a12 += q.a12;
+    a13 += q.a13;
+    a22 += q.a22;
+    a23 += q.a23;
+    a33 += q.a33;
+    w += q.w;
+  }
+
+  // Weighted RMS distance from `p` to the planes.
+  double eval(const value::float3 &p) const {
+    if (w <= 0.0) {
+      return 0.0;
+    }
+
+    const double x = double(p[0]);
+    const double y = double(p[1]);
+    const double z = double(p[2]);
+
+    const double e = a00 * x * x + a11 * y * y + a22 * z * z + a33 +
+                     2.0 * (a01 * x * y + a02 * x * z + a12 * y * z +
+                            a03 * x + a13 * y + a23 * z);
+
+    return std::sqrt((std::max)(0.0, e) / w);
+  }
+};
+
+// Collapse `from` vertex onto `to` vertex.
+struct Collapse {
+  float error;
+  uint32_t from;
+  uint32_t to;
+
+  // Versions of the vertices when the collapse was evaluated. The collapse is
+  // stale when any of them changed.
+  uint32_t from_version;
+  uint32_t to_version;
+
+  // Ties are broken by vertex ids so that the result is deterministic.
+  bool operator>(const Collapse &rhs) const {
+    if (error != rhs.error) {
+      return error > rhs.error;
+    }
+    if (from != rhs.from) {
+      return from > rhs.from;
+    }
+    return to > rhs.to;
+  }
+};
+
+inline void TriangleNormal(const value::float3 &p0, const value::float3 &p1,
+                           const value::float3 &p2, double n[3]) {
+  const double e1[3] = {double(p1[0]) - double(p0[0]),
+                        double(p1[1]) - double(p0[1]),
+                        double(p1[2]) - double(p0[2])};
+  const double e2[3] = {double(p2[0]) - double(p0[0]),
+                        double(p2[1]) - double(p0[1]),
+                        double(p2[2]) - double(p0[2])};
+  n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+  n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+  n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+// Reject collapses which make the angle between the face normal before and
+// after the collapse larger than ~90 degrees(i.e. fold-over) or make the face
+// degenerated.
+constexpr double kMinFlipCosine = 1.0e-3;
+
+}  // namespace
+
+bool SimplifyTriangleMesh(const std::vector<value::float3> &points,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<uint32_t> &face_groups,
+                          const std::vector<size_t> &target_face_counts,
+                          const float max_error,
+                          std::vector<SimplifiedMesh> *lods,
+                          std::string *err) {
+  if (!lods) {
+    PUSH_ERROR_AND_RETURN("`lods` arg is nullptr.");
+  }
+
+  if ((indices.size() % 3) != 0) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "indices.size {} must be the multiple of 3.", indices.size()));
+  }
+
+  const size_t num_points = points.size();
+  const size_t num_faces = indices.size() / 3;
+
+  if (face_groups.size() && (face_groups.size() != num_faces)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("face_groups.size {} must be equal to # of triangles {}.",
+                    face_groups.size(), num_faces));
+  }
+
+  if (num_points > size_t((std::numeric_limits<uint32_t>::max)())) {
+    PUSH_ERROR_AND_RETURN("Too many points.");
+  }
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (indices[i] >= num_points) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "indices[{}] {} exceeds points.size {}", i, indices[i], num_points));
+    }
+  }
+
+  for (size_t i = 1; i < target_face_counts.size(); i++) {
+    if (target_face_counts[i] > target_face_counts[i - 1]) {
+      PUSH_ERROR_AND_RETURN(
+          "target_face_counts must be sorted in descending order.");
+    }
+  }
+
+  //
+  // 1. Weld vertices by position. Vertices sharing the position with others
+  //    are seams, so they are locked.
+  //
+  std::vector<uint8_t> locked(num_points, 0);
+  std::vector<uint32_t> weld(num_points);
+  {
+    std::vector<uint32_t> order(num_points);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      if (points[a] != points[b]) {
+        return points[a] < points[b];
+      }
+      return a < b;
+    });
+
+    size_t i = 0;
+    while (i < num_points) {
+      size_t j = i + 1;
+      while ((j < num_points) && (points[order[j]] == points[order[i]])) {
+        j++;
+      }
+      for (size_t k = i; k < j; k++) {
+        weld[order[k]] = order[i];
+        if ((j - i) > 1) {
+          locked[order[k]] = 1;
+        }
+      }
+      i = j;
+    }
+  }
+
+  // Working copy of triangles. Triangles with duplicated indices are
+  // degenerated and removed from the beginning.
+  std::vector<uint32_t> tris(indices);
+  std::vector<uint8_t> face_alive(num_faces, 1);
+  size_t num_alive{0};
+  for (size_t f = 0; f < num_faces; f++) {
+    const uint32_t *t = &tris[3 * f];
+    if ((t[0] == t[1]) || (t[1] == t[2]) || (t[2] == t[0])) {
+      face_alive[f] = 0;
+    } else {
+      num_alive++;
+    }
+  }
+
+  //
+  // 2. Lock vertices on open borders and non-manifold edges(edges not shared
+  //    by exactly two triangles).
+  //
+  {
+    std::vector<uint64_t> edges;
+    edges.reserve(num_alive * 3);
+    for (size_t f = 0; f < num_faces; f++) {
+      if (!face_alive[f]) {
+        continue;
+      }
+      for (size_t k = 0; k < 3; k++) {
+        uint32_t a = weld[tris[3 * f + k]];
+        uint32_t b = weld[tris[3 * f + ((k + 1) % 3)]];
+        if (a == b) {
+          continue;
+        }
+        if (a > b) {
+          std::swap(a, b);
+        }
+        edges.push_back((uint64_t(a) << 32) | uint64_t(b));
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<uint8_t> locked_weld(num_points, 0);
+    size_t i = 0;
+    while (i < edges.size()) {
+      size_t j = i + 1;
+      while ((j < edges.size()) && (edges[j] == edges[i])) {
+        j++;
+      }
+      if ((j - i) != 2) {
+        locked_weld[size_t(edges[i] >> 32)] = 1;
+        locked_weld[size_t(edges[i] & 0xffffffffull)] = 1;
+      }
+      i = j;
+    }
+
+    for (size_t v = 0; v < num_points; v++) {
+      if (locked_weld[weld[v]]) {
+        locked[v] = 1;
+      }
+    }
+  }
+
+  //
+  // 3. Lock vertices on the boundary of face groups.
+  //
+  if (face_groups.size()) {
+    std::vector<uint32_t> vertex_groups(num_points, 0);
+    std::vector<uint8_t> has_group(num_points, 0);
+    for (size_t f = 0; f < num_faces; f++) {
+      if (!face_alive[f]) {
+        continue;
+      }
+      for (size_t k = 0; k < 3; k++) {
+        const uint32_t v = tris[3 * f + k];
+        if (!has_group[v]) {
+          has_group[v] = 1;
+          vertex_groups[v] = face_groups[f];
+        } else if (vertex_groups[v] != face_groups[f]) {
+          locked[v] = 1;
+        }
+      }
+    }
+  }
+
+  //
+  // 4. Quadrics(area weighted) and vertex -> face table.
+  //
+  std::vector<Quadric> quadrics(num_points);
+  std::vector<std::vector<uint32_t>> vertex_faces(num_points);
+  for (size_t f = 0; f < num_faces; f++) {
+    if (!face_alive[f]) {
+      continue;
+    }
+    const uint32_t *t = &tris[3 * f];
+
+    double n[3];
+    TriangleNormal(points[t[0]], points[t[1]], points[t[2]], n);
+    const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (len > 0.0) {
+      n[0] /= len;
+      n[1] /= len;
+      n[2] /= len;
+      const double d = -(n[0] * double(points[t[0]][0]) +
+                         n[1] * double(points[t[0]][1]) +
+                         n[2] * double(points[t[0]][2]));
+      for (size_t k = 0; k < 3; k++) {
+        quadrics[t[k]].add_plane(n, d, 0.5 * len);
+      }
+    }
+
+    for (size_t k = 0; k < 3; k++) {
+      vertex_faces[t[k]].push_back(uint32_t(f));
+    }
+  }
+
+  //
+  // 5. Collapse edges in the order of the error.
+  //
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+      heap;
+  std::vector<uint32_t> versions(num_points, 0);
+  std::vector<uint8_t> removed(num_points, 0);
+
+  auto push_collapse = [&](uint32_t from, uint32_t to) {
+    if (locked[from] || (from == to)) {
+      return;
+    }
+    Quadric q = quadrics[from];
+    q.add(quadrics[to]);
+    heap.push({float(q.eval(points[to])), from, to, versions[from],
+               versions[to]});
+  };
+
+  auto gather_neighbors = [&](uint32_t v, std::vector<uint32_t> *dst) {
+    dst->clear();
+    for (uint32_t f : vertex_faces[v]) {
+      if (!face_alive[f]) {
+        continue;
+      }
+      for (size_t k = 0; k < 3; k++) {
+        if (tris[3 * f + k] != v) {
+          dst->push_back(tris[3 * f + k]);
+        }
+      }
+    }
+    std::sort(dst->begin(), dst->end());
+    dst->erase(std::unique(dst->begin(), dst->end()), dst->end());
+  };
+
+  auto has_vertex = [&](uint32_t f, uint32_t v) {
+    return (tris[3 * f] == v) || (tris[3 * f + 1] == v) ||
+           (tris[3 * f + 2] == v);
+  };
+
+  std::vector<uint32_t> from_neighbors;
+  std::vector<uint32_t> to_neighbors;
+
+  auto can_collapse = [&](const Collapse &c) {
+    // Link condition: vertices adjacent to both ends must be the opposite
+    // vertices of the faces sharing the edge. Otherwise the collapse makes
+    // the surface non-manifold.
+    size_t num_shared_faces{0};
+    for (uint32_t f : vertex_faces[c.from]) {
+      if (face_alive[f] && has_vertex(f, c.to)) {
+        num_shared_faces++;
+      }
+    }
+    if (num_shared_faces == 0) {
+      return false;
+    }
+
+    gather_neighbors(c.from, &from_neighbors);
+    gather_neighbors(c.to, &to_neighbors);
+    size_t num_common{0};
+    {
+      size_t i = 0, j = 0;
+      while ((i < from_neighbors.size()) && (j < to_neighbors.size())) {
+        if (from_neighbors[i] < to_neighbors[j]) {
+          i++;
+        } else if (from_neighbors[i] > to_neighbors[j]) {
+          j++;
+        } else {
+          num_common++;
+          i++;
+          j++;
+        }
+      }
+    }
+    if (num_common > num_shared_faces) {
+      return false;
+    }
+
+    // Fold-over check of the remaining faces.
+    for (uint32_t f : vertex_faces[c.from]) {
+      if (!face_alive[f] || has_vertex(f, c.to)) {
+        continue;
+      }
+
+      value::float3 p[3];
+      for (size_t k = 0; k < 3; k++) {
+        p[k] = points[tris[3 * f + k]];
+      }
+
+      double nb[3];
+      TriangleNormal(p[0], p[1], p[2], nb);
+
+      for (size_t k = 0; k < 3; k++) {
+        if (tris[3 * f + k] == c.from) {
+          p[k] = points[c.to];
+        }
+      }
+
+      double na[3];
+      TriangleNormal(p[0], p[1], p[2], na);
+
+      const double lb = std::sqrt(nb[0] * nb[0] + nb[1] * nb[1] + nb[2] * nb[2]);
+      const double la = std::sqrt(na[0] * na[0] + na[1] * na[1] + na[2] * na[2]);
+      if (lb <= 0.0) {
+        continue;
+      }
+      if ((la <= 0.0) || ((na[0] * nb[0] + na[1] * nb[1] + na[2] * nb[2]) <
+                          kMinFlipCosine * la * lb)) {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  for (size_t f = 0; f < num_faces; f++) {
+    if (!face_alive[f]) {
+      continue;
+    }
+    for (size_t k = 0; k < 3; k++) {
+      const uint32_t a = tris[3 * f + k];
+      const uint32_t b = tris[3 * f + ((k + 1) % 3)];
+      push_collapse(a, b);
+      push_collapse(b, a);
+    }
+  }
+
+  lods->clear();
+  lods->resize(target_face_counts.size());
+
+  float error{0.0f};
+  bool exhausted{false};
+  std::vector<uint32_t> neighbors;
+
+  for (size_t lod = 0; lod < target_face_counts.size(); lod++) {
+    while (!exhausted && (num_alive > target_face_counts[lod])) {
+      if (heap.empty()) {
+        exhausted = true;
+        break;
+      }
+
+      const Collapse c = heap.top();
+      heap.pop();
+
+      if (removed[c.from] || removed[c.to] ||
+          (versions[c.from] != c.from_version) ||
+          (versions[c.to] != c.to_version)) {
+        continue;
+      }
+
+      // Errors of valid collapses in the heap are up to date, so no
+      // remaining collapse is under `max_error`.
+      if (c.error > max_error) {
+        exhausted = true;
+        break;
+      }
+
+      if (!can_collapse(c)) {
+        continue;
+      }
+
+      for (uint32_t f : vertex_faces[c.from]) {
+        if (!face_alive[f]) {
+          continue;
+        }
+        if (has_vertex(f, c.to)) {
+          face_alive[f] = 0;
+          num_alive--;
+          continue;
+        }
+        for (size_t k = 0; k < 3; k++) {
+          if (tris[3 * f + k] == c.from) {
+            tris[3 * f + k] = c.to;
+          }
+        }
+        vertex_faces[c.to].push_back(f);
+      }
+
+      std::vector<uint32_t> &to_faces = vertex_faces[c.to];
+      to_faces.erase(std::remove_if(to_faces.begin(), to_faces.end(),
+                                    [&](uint32_t f) { return !face_alive[f]; }),
+                     to_faces.end());
+
+      quadrics[c.to].add(quadrics[c.from]);
+      vertex_faces[c.from].clear();
+      removed[c.from] = 1;
+      versions[c.to]++;
+      error = (std::max)(error, c.error);
+
+      gather_neighbors(c.to, &neighbors);
+      for (uint32_t w : neighbors) {
+        push_collapse(w, c.to);
+        push_collapse(c.to, w);
+      }
+    }
+
+    SimplifiedMesh &dst = (*lods)[lod];
+    dst.indices.reserve(num_alive * 3);
+    dst.face_remap.reserve(num_alive);
+    for (size_t f = 0; f < num_faces; f++) {
+      if (!face_alive[f]) {
+        continue;
+      }
+      dst.indices.push_back(tris[3 * f + 0]);
+      dst.indices.push_back(tris[3 * f + 1]);
+      dst.indices.push_back(tris[3 * f + 2]);
+      dst.face_remap.push_back(uint32_t(f));
+    }
+    dst.error = error;
+  }
+
+  return true;
+}
+
+#undef PushError
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// Mesh processing utility(vertex normals, bounds, simplification, ...).
+//
+// Kernels work on SoA(Structure of Arrays) buffers and use SSE2/AVX(x86) or
+// NEON(AArch64) intrinsics when the compiler targets them. Otherwise portable
+// scalar code is used.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "value-types.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+///
+/// Compute smooth normals for each vertex('vertex' variability) of a polygon
+/// mesh.
+///
+/// Normal of the face is weighted by its area. For quad/polygon, first three
+/// vertices are used to compute the face normal(assume the face is planar).
+/// Vertices not referenced by any face get zero normal.
+///
+/// Face normals are computed in parallel over face ranges for large meshes.
+/// The result does not depend on `num_threads`.
+///
+/// @param[in] points Vertex positions.
+/// @param[in] faceVertexCounts The number of vertices for each face.
+/// @param[in] faceVertexIndices Vertex indices.
+/// @param[out] normals Vertex normals. Same length with `points`.
+/// @param[out] err Error message.
+/// @param[in] num_threads The number of threads. <= 0 = use system's # of
+/// threads.
+///
+/// @return false when the face topology is invalid.
+///
+bool ComputeVertexNormals(const std::vector<value::float3> &points,
+                          const std::vector<uint32_t> &faceVertexCounts,
+                          const std::vector<uint32_t> &faceVertexIndices,
+                          std::vector<value::float3> *normals,
+                          std::string *err = nullptr, int num_threads = 1);
+
+///
+/// Normalize `n` vectors given as SoA arrays in place.
+/// Zero(or denormal-length) vectors become zero vector.
+///
+void NormalizeVectors(float *x, float *y, float *z, size_t n);
+
+///
+/// Compute the axis-aligned bounding box of `n` points.
+/// `lower` = +inf and `upper` = -inf when `n` is 0.
+///
+void ComputePointsBounds(const value::float3 *points, size_t n,
+                         value::float3 *lower, value::float3 *upper);
+
+///
+/// Simplified triangle mesh. Indices refer to `points` of the source mesh.
+///
+struct SimplifiedMesh {
+  std::vector<uint32_t> indices;  // Triangle vertex indices.
+
+  // Index to the source triangle for each triangle in `indices`.
+  std::vector<uint32_t> face_remap;
+
+  // Max geometric error(distance) of the collapses applied so far, in the
+  // unit of `points`.
+  float error{0.0f};
+};
+
+///
+/// Generate a chain of simplified triangle meshes(LODs) with quadric-error
+/// edge collapse(Garland and Heckbert 1997).
+///
+/// A vertex is always collapsed onto one of its neighbor vertices, so no vertex
+/// is moved or created and vertex attributes of the source mesh can be
+/// shared by all LODs.
+///
+/// Following vertices are never removed:
+///
+/// - Vertices sharing the position with other vertices(UV/normal seams of a
+///   single-indexable mesh).
+/// - Vertices on open borders or non-manifold edges.
+/// - Vertices shared by triangles of different `face_groups`(e.g. GeomSubset
+///   material boundaries).
+///
+/// @param[in] points Vertex positions.
+/// @param[in] indices Triangle vertex indices.
+/// @param[in] face_groups Group id for each triangle. Can be empty.
+/// @param[in] target_face_counts Target number of triangles for each LOD in
+/// descending order.
+/// @param[in] max_error Collapses whose error exceeds this distance are not
+/// applied.
+/// @param[out] lods Simplified meshes. Same length with `target_face_counts`.
+/// LOD may have more triangles than its target when limited by `max_error` or
+/// locked vertices.
+/// @param[out] err Error message.
+///
+bool SimplifyTriangleMesh(const std::vector<value::float3> &points,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<uint32_t> &face_groups,
+                          const std::vector<size_t> &target_face_counts,
+                          const float max_error,
+                          std::vector<SimplifiedMesh> *lods,
+                          std::string *err = nullptr);
+
+///
+/// @return Name of the SIMD instruction set used by the kernels in this file:
+/// "avx2", "sse2", "neon" or "scalar". On x86, AVX2 kernels are selected at
+/// runtime when the CPU supports AVX2.
+///
+const char *GetMeshUtilSIMDName();
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -145,6 +145,7 @@ bool ApplyToXformable(
   APPLY_FUN(GeomPoints)
   APPLY_FUN(GeomCylinder)
   APPLY_FUN(GeomBasisCurves)
+  APPLY_FUN(PointInstancer)
   APPLY_FUN(SkelRoot)
 
 #undef APPLY_FUN
@@ -15,7 +15,7 @@
 //   - [x] Support SkelAnimation
 //     - [x] joint animation
 //     - [x] blendshape animation
-//   - [ ] Support Inbetween BlendShape
+//   - [x] Support Inbetween BlendShape
 //   - [ ] Support material binding collection(Collection API)
 //   - [ ] Support multiple skel animation
 //   https://github.com/PixarAnimationStudios/OpenUSD/issues/2246
@@ -33,14 +33,17 @@
 #include "image-types.hh"
 #include "linear-algebra.hh"
 #include "math-util.inc"
+#include "mesh-util.hh"
 #include "pprinter.hh"
 #include "prim-types.hh"
 #include "str-util.hh"
+#include "thread-util.hh"
 #include "tiny-format.hh"
 #include "tinyusdz.hh"
 #include "usdGeom.hh"
 #include "usdShade.hh"
 #include "value-pprint.hh"
+#include "xform.hh"
 
 #if defined(TINYUSDZ_WITH_COLORIO)
 #include "external/tiny-color-io.h"
@@ -60,7 +63,10 @@
 #include "external/mapbox/earcut/earcut.hpp"
 
 // For kNN point search
-// #include "external/nanoflann.hpp"
+// nanoflann uses std::thread, which is not available on WASI.
+#if !defined(__wasi__)
+#include "external/nanoflann.hpp"
+#endif
 
 #ifdef __clang__
 #pragma clang diagnostic pop
@@ -1008,9 +1014,11 @@ static bool TriangulateVertexAttribute(
     }
 
     size_t num_vs = vattr.vertex_count();
-    std::vector<uint8_t> buf;
+    const size_t stride = vattr.stride_bytes();
+    const uint8_t *src = vattr.get_data().data();
+    std::vector<uint8_t> buf(triangulatedFaceVertexIndices.size() * stride);
 
-    for (uint32_t f = 0; f < triangulatedFaceVertexIndices.size(); f++) {
+    for (size_t f = 0; f < triangulatedFaceVertexIndices.size(); f++) {
       // Array index to faceVertexIndices(before triangulation).
       size_t src_fvIdx = triangulatedToOrigFaceVertexIndexMap[f];
 
@@ -1019,9 +1027,7 @@ static bool TriangulateVertexAttribute(
             fmt::format("triangulatedToOrigFaceVertexIndexMap[{}] {} exceeds num_vs {}.", f, src_fvIdx, num_vs));
       }
 
-      buf.insert(
-          buf.end(), vattr.get_data().data() + src_fvIdx * vattr.stride_bytes(),
-          vattr.get_data().data() + (1 + src_fvIdx) * vattr.stride_bytes());
+      memcpy(buf.data() + f * stride, src + src_fvIdx * stride, stride);
     }
 
     vattr.data = std::move(buf);
@@ -1471,6 +1477,117 @@ nonstd::expected<VertexAttribute, std::string> TriangulateGeomPrimvar(
 #endif
 
 #if 1
+//
+// Polygon classification for TriangulatePolygon.
+//
+enum class PolygonClass {
+  Convex,      // Triangulate with fan.
+  Concave,     // Need earcut.
+  Degenerated  // Zero area.
+};
+
+//
+// Compute the normal of polygon using Newell's method.
+// Use double for accuracy. `float` precision may classify small-area polygon
+// as degenerated.
+//
+template <typename T>
+value::double3 PolygonNormal(const std::vector<T> &points,
+                             const uint32_t *indices, size_t nv) {
+  value::double3 n = {0, 0, 0};
+
+  for (size_t k = 0; k < nv; ++k) {
+    const T &v0 = points[indices[k]];
+    const T &v1 = points[indices[(k + 1) % nv]];
+
+    T a = {v0[0] - v1[0], v0[1] - v1[1], v0[2] - v1[2]};
+    T b = {v0[0] + v1[0], v0[1] + v1[1], v0[2] + v1[2]};
+
+    n[0] += double(a[1] * b[2]);
+    n[1] += double(a[2] * b[0]);
+    n[2] += double(a[0] * b[1]);
+  }
+
+  return n;
+}
+
+//
+// Classify polygon by projecting it to the plane of the dominant axis of its
+// normal `n`.
+// Convex when all turns have the same orientation with `n` and edges go
+// around only once(the sign of edge direction changes at most twice, which
+// rejects self-intersecting star polygons).
+//
+// `reflex` receives the corner index of a reflex vertex for concave polygon.
+//
+template <typename T>
+PolygonClass ClassifyPolygon(const std::vector<T> &points,
+                             const uint32_t *indices, size_t nv,
+                             const value::double3 &n, size_t *reflex) {
+  if (vlength(n) < std::numeric_limits<double>::epsilon()) {
+    return PolygonClass::Degenerated;
+  }
+
+  // Projection axes (ax, ay) so that the 2D cross product has the same sign
+  // as n[az].
+  size_t az = 2;
+  if ((std::fabs(n[0]) >= std::fabs(n[1])) &&
+      (std::fabs(n[0]) >= std::fabs(n[2]))) {
+    az = 0;
+  } else if (std::fabs(n[1]) >= std::fabs(n[2])) {
+    az = 1;
+  }
+  const size_t ax = (az + 1) % 3;
+  const size_t ay = (az + 2) % 3;
+  const double orientation = (n[az] > 0.0) ? 1.0 : -1.0;
+
+  int num_sign_changes = 0;
+  int first_sign = 0;
+  int prev_sign = 0;
+
+  for (size_t k = 0; k < nv; k++) {
+    const T &p0 = points[indices[(k + nv - 1) % nv]];
+    const T &p1 = points[indices[k]];
+    const T &p2 = points[indices[(k + 1) % nv]];
+
+    const double e0x = double(p1[ax]) - double(p0[ax]);
+    const double e0y = double(p1[ay]) - double(p0[ay]);
+    const double e1x = double(p2[ax]) - double(p1[ax]);
+    const double e1y = double(p2[ay]) - double(p1[ay]);
+
+    if (orientation * (e0x * e1y - e0y * e1x) < 0.0) {
+      if (reflex) {
+        (*reflex) = k;
+      }
+      return PolygonClass::Concave;
+    }
+
+    const int sign = (e1x > 0.0) ? 1 : ((e1x < 0.0) ? -1 : 0);
+    if (sign != 0) {
+      if (first_sign == 0) {
+        first_sign = sign;
+      } else if (sign != prev_sign) {
+        num_sign_changes++;
+      }
+      prev_sign = sign;
+    }
+  }
+
+  // Wrap around.
+  if ((first_sign != 0) && (prev_sign != first_sign)) {
+    num_sign_changes++;
+  }
+
+  if (num_sign_changes > 2) {
+    if (reflex) {
+      (*reflex) = 0;
+    }
+    return PolygonClass::Concave;
+  }
+
+  return PolygonClass::Convex;
+}
+
 ///
 /// Input: points, faceVertexCounts, faceVertexIndices
 /// Output: triangulated faceVertexCounts(all filled with 3), triangulated
@@ -1485,7 +1602,11 @@ nonstd::expected<VertexAttribute, std::string> TriangulateGeomPrimvar(
 ///
 /// triangulated*** output is generated even when input mesh is fully composed
 /// from triangles(`faceVertexCounts` are all filled with 3) Return false when a
-/// polygon is degenerated. No overlap check at the moment
+/// polygon(5 or more vertices) is degenerated. No overlap check at the moment
+///
+/// Triangles are passed through. Quads are split at the shorter diagonal(or
+/// at the reflex vertex when concave). Convex polygons are fan-triangulated.
+/// Only concave polygons are triangulated with earcut.
 ///
 /// Example:
 ///   - faceVertexCounts = [4]
@@ -1505,128 +1626,137 @@ bool TriangulatePolygon(
     std::vector<uint32_t> &triangulatedFaceVertexIndices,
     std::vector<size_t> &triangulatedToOrigFaceVertexIndexMap,
     std::vector<uint32_t> &triangulatedFaceCounts, std::string &err) {
-  triangulatedFaceVertexCounts.clear();
-  triangulatedFaceVertexIndices.clear();
 
-  triangulatedToOrigFaceVertexIndexMap.clear();
+  //
+  // 1. Validate and count triangles. A simple polygon with N vertices has
+  //    N - 2 triangles, so the outputs can be allocated at once.
+  //
+  size_t num_tris = 0;
+  {
+    size_t faceIndexOffset = 0;
+    for (size_t i = 0; i < faceVertexCounts.size(); i++) {
+      uint32_t npolys = faceVertexCounts[i];
+
+      if (npolys < 3) {
+        err = fmt::format(
+            "faceVertex count must be 3(triangle) or "
+            "more(polygon), but got faceVertexCounts[{}] = {}\n",
+            i, npolys);
+        return false;
+      }
 
-  size_t faceIndexOffset = 0;
+      if (faceIndexOffset + npolys > faceVertexIndices.size()) {
+        err = fmt::format(
+            "Invalid faceVertexIndices or faceVertexCounts. faceVertex index "
+            "exceeds faceVertexIndices.size() at [{}]\n",
+            i);
+        return false;
+      }
 
-  // For each polygon(face)
-  for (size_t i = 0; i < faceVertexCounts.size(); i++) {
-    uint32_t npolys = faceVertexCounts[i];
+      if (npolys > 3) {
+        for (size_t k = 0; k < npolys; k++) {
+          if (faceVertexIndices[faceIndexOffset + k] >= points.size()) {
+            err = fmt::format("Invalid vertex index.\n");
+            return false;
+          }
+        }
+      }
 
-    if (npolys < 3) {
-      err = fmt::format(
-          "faceVertex count must be 3(triangle) or "
-          "more(polygon), but got faceVertexCounts[{}] = {}\n",
-          i, npolys);
-      return false;
+      num_tris += npolys - 2;
+      faceIndexOffset += npolys;
     }
+  }
 
-    if (faceIndexOffset + npolys > faceVertexIndices.size()) {
-      err = fmt::format(
-          "Invalid faceVertexIndices or faceVertexCounts. faceVertex index "
-          "exceeds faceVertexIndices.size() at [{}]\n",
-          i);
-      return false;
-    }
+  // Up to 2GB tris.
+  if (num_tris > size_t((std::numeric_limits<int32_t>::max)())) {
+    err = "Too many triangles are generated.\n";
+    return false;
+  }
 
-    if (npolys == 3) {
-      // No need for triangulation.
-      triangulatedFaceVertexCounts.push_back(3);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 1]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 1);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedFaceCounts.push_back(1);
-#if 1
-    } else if (npolys == 4) {
-      // Use simple split
-      // TODO: Split at shortest edge for better triangulation.
-      triangulatedFaceVertexCounts.push_back(3);
-      triangulatedFaceVertexCounts.push_back(3);
-
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 1]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 0]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 2]);
-      triangulatedFaceVertexIndices.push_back(
-          faceVertexIndices[faceIndexOffset + 3]);
-
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 1);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 0);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 2);
-      triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset + 3);
-      triangulatedFaceCounts.push_back(2);
-#endif
-    } else {
-      // Use double for accuracy. `float` precision may classify small-are polygon as degenerated.
-      // Find the normal axis of the polygon using Newell's method
-      value::double3 n = {0, 0, 0};
+  triangulatedFaceVertexCounts.assign(num_tris, 3);
+  triangulatedFaceVertexIndices.resize(3 * num_tris);
+  triangulatedToOrigFaceVertexIndexMap.resize(3 * num_tris);
+  triangulatedFaceCounts.resize(faceVertexCounts.size());
 
-      size_t vi0;
-      size_t vi0_2;
+  //
+  // 2. Triangulate.
+  //
+  uint32_t *dst_indices = triangulatedFaceVertexIndices.data();
+  size_t *dst_map = triangulatedToOrigFaceVertexIndexMap.data();
+  size_t tri_offset = 0;
+
+  // Emit triangle (c0, c1, c2). c* = corner index in the face.
+  auto emit = [&](size_t faceIndexOffset, size_t c0, size_t c1, size_t c2) {
+    dst_indices[3 * tri_offset + 0] = faceVertexIndices[faceIndexOffset + c0];
+    dst_indices[3 * tri_offset + 1] = faceVertexIndices[faceIndexOffset + c1];
+    dst_indices[3 * tri_offset + 2] = faceVertexIndices[faceIndexOffset + c2];
+    dst_map[3 * tri_offset + 0] = faceIndexOffset + c0;
+    dst_map[3 * tri_offset + 1] = faceIndexOffset + c1;
+    dst_map[3 * tri_offset + 2] = faceIndexOffset + c2;
+    tri_offset++;
+  };
 
-      for (size_t k = 0; k < npolys; ++k) {
-        vi0 = faceVertexIndices[faceIndexOffset + k];
+  // Buffers for earcut. Reused over concave polygons.
+  using Point3D = std::array<BaseTy, 3>;
+  using Point2D = std::array<BaseTy, 2>;
+  std::vector<std::vector<Point2D>> polygon_2d(1);
+  mapbox::detail::Earcut<uint32_t> earcut;
 
-        size_t j = (k + 1) % npolys;
-        vi0_2 = faceVertexIndices[faceIndexOffset + j];
+  size_t faceIndexOffset = 0;
 
-        if (vi0 >= points.size()) {
-          err = fmt::format("Invalid vertex index.\n");
-          return false;
-        }
+  // For each polygon(face)
+  for (size_t i = 0; i < faceVertexCounts.size(); i++) {
+    const uint32_t npolys = faceVertexCounts[i];
+    const uint32_t *face = faceVertexIndices.data() + faceIndexOffset;
 
-        if (vi0_2 >= points.size()) {
-          err = fmt::format("Invalid vertex index.\n");
-          return false;
+    if (npolys == 3) {
+      // No need for triangulation.
+      emit(faceIndexOffset, 0, 1, 2);
+      triangulatedFaceCounts[i] = 1;
+    } else if (npolys == 4) {
+      value::double3 n = PolygonNormal(points, face, 4);
+      size_t reflex = 0;
+      PolygonClass pc = ClassifyPolygon(points, face, 4, n, &reflex);
+
+      size_t c = 0;  // Split at diagonal (c, c + 2)
+      if (pc == PolygonClass::Convex) {
+        const T &p0 = points[face[0]];
+        const T &p1 = points[face[1]];
+        const T &p2 = points[face[2]];
+        const T &p3 = points[face[3]];
+        const T d02 = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        const T d13 = {p3[0] - p1[0], p3[1] - p1[1], p3[2] - p1[2]};
+        if (vdot(d13, d13) < vdot(d02, d02)) {
+          c = 1;
         }
-
-        T v0 = points[vi0];
-        T v1 = points[vi0_2];
-
-        const T point1 = {v0[0], v0[1], v0[2]};
-        const T point2 = {v1[0], v1[1], v1[2]};
-
-        T a = {point1[0] - point2[0], point1[1] - point2[1],
-               point1[2] - point2[2]};
-        T b = {point1[0] + point2[0], point1[1] + point2[1],
-               point1[2] + point2[2]};
-
-        n[0] += double(a[1] * b[2]);
-        n[1] += double(a[2] * b[0]);
-        n[2] += double(a[0] * b[1]);
-        DCOUT("v0 " << v0);
-        DCOUT("v1 " << v1);
-        DCOUT("n " << n);
+      } else if (pc == PolygonClass::Concave) {
+        // The diagonal from the reflex vertex is always inside of the quad.
+        c = reflex % 2;
       }
-      //BaseTy length_n = vlength(n);
-      double length_n = vlength(n);
+      // Degenerated quad: Use diagonal (0, 2)
+
+      emit(faceIndexOffset, c, c + 1, (c + 2) % 4);
+      emit(faceIndexOffset, c, (c + 2) % 4, (c + 3) % 4);
+      triangulatedFaceCounts[i] = 2;
+    } else {
+      value::double3 n = PolygonNormal(points, face, npolys);
+      PolygonClass pc = ClassifyPolygon(points, face, npolys, n, nullptr);
 
-      // Check if zero length normal
-      if (std::fabs(length_n) < std::numeric_limits<double>::epsilon()) {
-        DCOUT("length_n " << length_n);
+      if (pc == PolygonClass::Degenerated) {
+        DCOUT("length_n " << vlength(n));
         err = "Degenerated polygon found.\n";
         return false;
       }
 
-      // Negative is to flip the normal to the correct direction
+      if (pc == PolygonClass::Convex) {
+        for (size_t k = 1; (k + 1) < npolys; k++) {
+          emit(faceIndexOffset, 0, k, k + 1);
+        }
+        triangulatedFaceCounts[i] = npolys - 2;
+        faceIndexOffset += npolys;
+        continue;
+      }
+
       n = vnormalize(n);
 
       T axis_w, axis_v, axis_u;
@@ -1642,20 +1772,15 @@ bool TriangulatePolygon(
       axis_v = vnormalize(vcross(axis_w, a));
       axis_u = vcross(axis_w, axis_v);
 
-      using Point3D = std::array<BaseTy, 3>;
-      using Point2D = std::array<BaseTy, 2>;
-      std::vector<Point2D> polyline;
-
       // TMW change: Find best normal and project v0x and v0y to those
       // coordinates, instead of picking a plane aligned with an axis (which
       // can flip polygons).
 
-      // Fill polygon data.
+      // Fill polygon data. Single polygon only(no holes)
+      std::vector<Point2D> &polyline = polygon_2d[0];
+      polyline.clear();
       for (size_t k = 0; k < npolys; k++) {
-        size_t vidx = faceVertexIndices[faceIndexOffset + k];
-
-        value::float3 v = points[vidx];
-        // Point3 polypoint = {v0[0],v0[1],v0[2]};
+        const T &v = points[face[k]];
 
         // world to local
         Point3D loc = {vdot(v, axis_u), vdot(v, axis_v), vdot(v, axis_w)};
@@ -1663,10 +1788,8 @@ bool TriangulatePolygon(
         polyline.push_back({loc[0], loc[1]});
       }
 
-      std::vector<std::vector<Point2D>> polygon_2d;
-      // Single polygon only(no holes)
-
-      std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon_2d);
+      earcut(polygon_2d);
+      const std::vector<uint32_t> &indices = earcut.indices;
       //  => result = 3 * faces, clockwise
 
       if ((indices.size() % 3) != 0) {
@@ -1675,36 +1798,25 @@ bool TriangulatePolygon(
         return false;
       }
 
-      size_t ntris = indices.size() / 3;
-
-      // Up to 2GB tris.
-      if (ntris > size_t((std::numeric_limits<int32_t>::max)())) {
-        err = "Too many triangles are generated.\n";
-        return false;
-      }
+      // earcut may drop degenerated(zero-area) triangles.
+      size_t ntris = (std::min)(indices.size() / 3, size_t(npolys - 2));
 
       for (size_t k = 0; k < ntris; k++) {
-        triangulatedFaceVertexCounts.push_back(3);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 0]]);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 1]]);
-        triangulatedFaceVertexIndices.push_back(
-            faceVertexIndices[faceIndexOffset + indices[3 * k + 2]]);
-
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 0]);
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 1]);
-        triangulatedToOrigFaceVertexIndexMap.push_back(faceIndexOffset +
-                                                       indices[3 * k + 2]);
+        emit(faceIndexOffset, indices[3 * k + 0], indices[3 * k + 1],
+             indices[3 * k + 2]);
       }
-      triangulatedFaceCounts.push_back(uint32_t(ntris));
+      triangulatedFaceCounts[i] = uint32_t(ntris);
     }
 
     faceIndexOffset += npolys;
   }
 
+  if (tri_offset != num_tris) {
+    triangulatedFaceVertexCounts.resize(tri_offset);
+    triangulatedFaceVertexIndices.resize(3 * tri_offset);
+    triangulatedToOrigFaceVertexIndexMap.resize(3 * tri_offset);
+  }
+
   return true;
 }
 #endif
@@ -1745,21 +1857,9 @@ struct ComputeTangentPackedVertexData {
 
 struct ComputeTangentPackedVertexDataHasher {
   inline size_t operator()(const ComputeTangentPackedVertexData &v) const {
-    // Simple hasher using FNV1 32bit
-    // TODO: Use 64bit FNV1?
     // TODO: Use spatial hash or LSH(LocallySensitiveHash) for position value.
-    static constexpr uint32_t kFNV_Prime = 0x01000193;
-    static constexpr uint32_t kFNV_Offset_Basis = 0x811c9dc5;
-
-    const uint8_t *ptr = reinterpret_cast<const uint8_t *>(&v);
-    size_t n = sizeof(DefaultPackedVertexData);
-
-    uint32_t hash = kFNV_Offset_Basis;
-    for (size_t i = 0; i < n; i++) {
-      hash = (kFNV_Prime * hash) ^ (ptr[i]);
-    }
-
-    return size_t(hash);
+    return size_t(
+        HashPackedVertex(&v, sizeof(ComputeTangentPackedVertexData)));
   }
 };
 
@@ -2125,56 +2225,55 @@ static bool ComputeTangentsAndBinormals(
     // We only need indices. Discard vertex_output and vertrex_point_indices
   }
 
-  const uint32_t num_verts =
-      *std::max_element(vertex_indices.begin(), vertex_indices.end());
+  const size_t num_verts =
+      size_t(*std::max_element(vertex_indices.begin(), vertex_indices.end())) +
+      1;
 
   //
   // 3. normalize * orthogonalize;
   //
 
-  // per-vertex tangents/binormals
-  std::vector<value::normal3f> v_tn;
-  v_tn.assign(num_verts, {0.0f, 0.0f, 0.0f});
+  // per-vertex tangents/binormals(SoA)
+  std::vector<float> v_tx(num_verts, 0.0f);
+  std::vector<float> v_ty(num_verts, 0.0f);
+  std::vector<float> v_tz(num_verts, 0.0f);
 
-  std::vector<value::normal3f> v_bn;
-  v_bn.assign(num_verts, {0.0f, 0.0f, 0.0f});
+  std::vector<float> v_bx(num_verts, 0.0f);
+  std::vector<float> v_by(num_verts, 0.0f);
+  std::vector<float> v_bz(num_verts, 0.0f);
 
   for (size_t i = 0; i < vertex_indices.size(); i++) {
-    value::normal3f Tn = tn[vertex_indices[i]];
-    value::normal3f Bn = bn[vertex_indices[i]];
+    const uint32_t vidx = vertex_indices[i];
+    const value::normal3f &Tn = tn[vidx];
+    const value::normal3f &Bn = bn[vidx];
 
-    v_tn[vertex_indices[i]][0] += Tn[0];
-    v_tn[vertex_indices[i]][1] += Tn[1];
-    v_tn[vertex_indices[i]][2] += Tn[2];
+    v_tx[vidx] += Tn[0];
+    v_ty[vidx] += Tn[1];
+    v_tz[vidx] += Tn[2];
 
-    v_bn[vertex_indices[i]][0] += Bn[0];
-    v_bn[vertex_indices[i]][1] += Bn[1];
-    v_bn[vertex_indices[i]][2] += Bn[2];
+    v_bx[vidx] += Bn[0];
+    v_by[vidx] += Bn[1];
+    v_bz[vidx] += Bn[2];
   }
 
-  for (size_t i = 0; i < size_t(num_verts); i++) {
-    if (vlength(v_tn[i]) > 0.0f) {
-      v_tn[i] = vnormalize(v_tn[i]);
-    }
-    if (vlength(v_bn[i]) > 0.0f) {
-      v_bn[i] = vnormalize(v_bn[i]);
-    }
-  }
+  NormalizeVectors(v_tx.data(), v_ty.data(), v_tz.data(), num_verts);
+  NormalizeVectors(v_bx.data(), v_by.data(), v_bz.data(), num_verts);
 
   tangents->assign(num_verts, {0.0f, 0.0f, 0.0f});
   binormals->assign(num_verts, {0.0f, 0.0f, 0.0f});
 
   for (size_t i = 0; i < vertex_indices.size(); i++) {
+    const uint32_t vidx = vertex_indices[i];
     value::normal3f n;
 
     // http://www.terathon.com/code/tangent.html
 
-    n[0] = normals[vertex_indices[i]][0];
-    n[1] = normals[vertex_indices[i]][1];
-    n[2] = normals[vertex_indices[i]][2];
+    n[0] = normals[vidx][0];
+    n[1] = normals[vidx][1];
+    n[2] = normals[vidx][2];
 
-    value::normal3f Tn = v_tn[vertex_indices[i]];
-    value::normal3f Bn = v_bn[vertex_indices[i]];
+    value::normal3f Tn{v_tx[vidx], v_ty[vidx], v_tz[vidx]};
+    value::normal3f Bn{v_bx[vidx], v_by[vidx], v_bz[vidx]};
 
     // Gram-Schmidt orthogonalize
     Tn = (Tn - n * vdot(n, Tn));
@@ -2201,90 +2300,6 @@ static bool ComputeTangentsAndBinormals(
   return true;
 }
 
-//
-// Compute geometric normal in CCW(Counter Clock-Wise) manner
-// Also computes the area of the input triangle.
-//
-inline static value::float3 GeometricNormal(const value::float3 v0,
-                                            const value::float3 v1,
-                                            const value::float3 v2,
-                                            float &area) {
-  const value::float3 v10 = v1 - v0;
-  const value::float3 v20 = v2 - v0;
-
-  value::float3 Nf = vcross(v10, v20);  // CCW
-  area = 0.5f * vlength(Nf);
-  Nf = vnormalize(Nf);
-
-  return Nf;
-}
-
-//
-// Compute a normal for vertices.
-// Normal vector is computed as weighted(by the area of the triangle) vector.
-//
-// TODO: Implement better normal calculation. ref.
-// http://www.bytehazard.com/articles/vertnorm.html
-//
-static bool ComputeNormals(const std::vector<vec3> &vertices,
-                           const std::vector<uint32_t> &faceVertexCounts,
-                           const std::vector<uint32_t> &faceVertexIndices,
-                           std::vector<vec3> &normals, std::string *err) {
-  normals.assign(vertices.size(), {0.0f, 0.0f, 0.0f});
-
-  size_t faceVertexIndexOffset{0};
-  for (size_t f = 0; f < faceVertexCounts.size(); f++) {
-    size_t nv = faceVertexCounts[f];
-
-    if (nv < 3) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("Invalid face num {} at faceVertexCounts[{}]", nv, f));
-    }
-
-    // For quad/polygon, first three vertices are used to compute face normal
-    // (Assume quad/polygon plane is co-planar)
-    uint32_t vidx0 = faceVertexIndices[faceVertexIndexOffset + 0];
-    uint32_t vidx1 = faceVertexIndices[faceVertexIndexOffset + 1];
-    uint32_t vidx2 = faceVertexIndices[faceVertexIndexOffset + 2];
-
-    if (vidx0 >= vertices.size()) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("vertexIndex0 {} exceeds vertices.size {}", vidx0, vertices.size()));
-    }
-
-    if (vidx1 >= vertices.size()) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("vertexIndex1 {} exceeds vertices.size {}", vidx1, vertices.size()));
-    }
-
-    if (vidx2 >= vertices.size()) {
-      PUSH_ERROR_AND_RETURN(
-          fmt::format("vertexIndex2 {} exceeds vertices.size {}", vidx2, vertices.size()));
-    }
-
-    float area{0.0f};
-    value::float3 Nf = GeometricNormal(vertices[vidx0], vertices[vidx1],
-                                       vertices[vidx2], area);
-
-    for (size_t v = 0; v < nv; v++) {
-      uint32_t vidx = faceVertexIndices[faceVertexIndexOffset + v];
-      if (vidx >= vertices.size()) {
-        PUSH_ERROR_AND_RETURN(fmt::format(
-            "vertexIndex exceeds vertices.size {}", vertices.size()));
-      }
-      normals[vidx] += area * Nf;
-    }
-
-    faceVertexIndexOffset += nv;
-  }
-
-  for (size_t v = 0; v < normals.size(); v++) {
-    normals[v] = vnormalize(normals[v]);
-  }
-
-  return true;
-}
-
 }  // namespace
 
 #if 0
@@ -2473,7 +2488,153 @@ bool RenderSceneConverter::ConvertVertexVariabilityImpl(
   return true;
 }
 
-bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
+namespace {
+
+#if !defined(__wasi__)
+// nanoflann dataset adaptor for FindSimilarVertices.
+// Coordinate 0 is the point index, so that vertices of different points are
+// far apart.
+struct SimilarVertexDataset {
+  const std::vector<uint32_t> *point_indices{nullptr};
+  const std::vector<float> *attribs{nullptr};
+  size_t dim{0};  // # of attribute floats per vertex.
+
+  size_t kdtree_get_point_count() const { return point_indices->size(); }
+
+  float kdtree_get_pt(const size_t idx, const size_t d) const {
+    if (d == 0) {
+      return float((*point_indices)[idx]);
+    }
+    return (*attribs)[idx * dim + d - 1];
+  }
+
+  template <class BBOX>
+  bool kdtree_get_bbox(BBOX &) const {
+    return false;
+  }
+};
+#endif
+
+}  // namespace
+
+bool FindSimilarVertices(const std::vector<uint32_t> &point_indices,
+                         const std::vector<float> &attribs, const size_t dim,
+                         const float eps,
+                         std::vector<uint32_t> *similar_vertices) {
+  if (!similar_vertices) {
+    return false;
+  }
+
+  const size_t n = point_indices.size();
+  if ((dim == 0) || (attribs.size() != (n * dim))) {
+    return false;
+  }
+
+  if (n >= size_t((std::numeric_limits<uint32_t>::max)())) {
+    return false;
+  }
+
+  constexpr uint32_t kUnassigned = ~0u;
+  similar_vertices->assign(n, kUnassigned);
+
+  const float eps_sq = eps * eps;
+
+#if !defined(__wasi__)
+  using KDTree = nanoflann::KDTreeSingleIndexAdaptor<
+      nanoflann::L2_Simple_Adaptor<float, SimilarVertexDataset>,
+      SimilarVertexDataset, /* dim */ -1, uint32_t>;
+
+  SimilarVertexDataset dataset;
+  dataset.point_indices = &point_indices;
+  dataset.attribs = &attribs;
+  dataset.dim = dim;
+
+  // Build the tree in the calling thread.
+  KDTree tree(int(dim + 1), dataset,
+              nanoflann::KDTreeSingleIndexAdaptorParams(
+                  /* leaf_max_size */ 16,
+                  nanoflann::KDTreeSingleIndexAdaptorFlags::None,
+                  /* n_thread_build */ 1));
+
+  nanoflann::SearchParameters search_params;
+  search_params.sorted = false;
+
+  std::vector<float> query(dim + 1);
+  std::vector<nanoflann::ResultItem<uint32_t, float>> matches;
+
+  for (size_t i = 0; i < n; i++) {
+    if ((*similar_vertices)[i] != kUnassigned) {
+      continue;
+    }
+    (*similar_vertices)[i] = uint32_t(i);
+
+    query[0] = float(point_indices[i]);
+    memcpy(&query[1], &attribs[i * dim], sizeof(float) * dim);
+
+    // L2 metric in nanoflann uses squared distance.
+    matches.clear();
+    tree.radiusSearch(query.data(), eps_sq, matches, search_params);
+
+    for (const auto &m : matches) {
+      const size_t j = m.first;
+      // Point index in float loses precision for >= 2^24, so compare it
+      // exactly.
+      if ((j > i) && ((*similar_vertices)[j] == kUnassigned) &&
+          (point_indices[j] == point_indices[i])) {
+        (*similar_vertices)[j] = uint32_t(i);
+      }
+    }
+  }
+#else
+  // Compare vertices of the same point.
+  std::vector<uint32_t> order(n);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+                   [&point_indices](const uint32_t a, const uint32_t b) {
+                     return point_indices[a] < point_indices[b];
+                   });
+
+  size_t group_begin = 0;
+  while (group_begin < n) {
+    size_t group_end = group_begin + 1;
+    while ((group_end < n) && (point_indices[order[group_end]] ==
+                               point_indices[order[group_begin]])) {
+      group_end++;
+    }
+
+    for (size_t a = group_begin; a < group_end; a++) {
+      const uint32_t i = order[a];
+      if ((*similar_vertices)[i] != kUnassigned) {
+        continue;
+      }
+      (*similar_vertices)[i] = i;
+
+      for (size_t b = a + 1; b < group_end; b++) {
+        const uint32_t j = order[b];
+        if ((*similar_vertices)[j] != kUnassigned) {
+          continue;
+        }
+
+        float dist_sq = 0.0f;
+        for (size_t d = 0; d < dim; d++) {
+          const float diff = attribs[i * dim + d] - attribs[j * dim + d];
+          dist_sq += diff * diff;
+        }
+        if (dist_sq < eps_sq) {
+          (*similar_vertices)[j] = i;
+        }
+      }
+    }
+
+    group_begin = group_end;
+  }
+#endif
+
+  return true;
+}
+
+bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh,
+                                                  const float eps) {
   //
   // - If mesh is triangulated, use triangulatedFaceVertexIndices, otherwise use
   // faceVertxIndices.
@@ -2651,7 +2812,8 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
                DefaultVertexOutput<DefaultPackedVertexData>,
                DefaultPackedVertexData, DefaultPackedVertexDataHasher,
                DefaultPackedVertexDataEqual>(vertex_input, vertex_output,
-                                             out_indices, out_point_indices);
+                                             out_indices, out_point_indices,
+                                             eps);
 
   if (out_indices.size() != out_point_indices.size()) {
     PUSH_ERROR_AND_RETURN(
@@ -2687,6 +2849,18 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
         tmp_points[out_indices[i]] = mesh.points[out_point_indices[i]];
       }
       mesh.points.swap(tmp_points);
+
+      if (_points_cache) {
+        // Compose with the mapping of the previous reorder.
+        const std::vector<uint32_t> prev_remap = _points_cache->point_remap;
+        std::vector<uint32_t> &remap = _points_cache->point_remap;
+        remap.assign(numPoints, 0);
+        for (size_t i = 0; i < out_point_indices.size(); i++) {
+          remap[out_indices[i]] = prev_remap.empty()
+                                      ? out_point_indices[i]
+                                      : prev_remap[out_point_indices[i]];
+        }
+      }
     }
 
     if (mesh.joint_and_weights.jointIndices.size()) {
@@ -2742,6 +2916,7 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
         std::vector<value::float3> tmpPointOffsets;
         std::vector<value::float3> tmpNormalOffsets;
         std::vector<uint32_t> tmpPointIndices;
+        std::unordered_map<float, InbetweenShapeTarget> tmpInbetweens;
 
         for (size_t i = 0; i < target.second.pointIndices.size(); i++) {
 
@@ -2765,6 +2940,23 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
               tmpNormalOffsets.push_back(target.second.normalOffsets[i]);
             }
 
+            for (const auto &ib : target.second.inbetweens) {
+              InbetweenShapeTarget &dst_ib = tmpInbetweens[ib.first];
+              dst_ib.weight = ib.second.weight;
+              if (ib.second.pointOffsets.size()) {
+                if (i >= ib.second.pointOffsets.size()) {
+                  PUSH_ERROR_AND_RETURN("Invalid inbetween pointOffsets.size.");
+                }
+                dst_ib.pointOffsets.push_back(ib.second.pointOffsets[i]);
+              }
+              if (ib.second.normalOffsets.size()) {
+                if (i >= ib.second.normalOffsets.size()) {
+                  PUSH_ERROR_AND_RETURN("Invalid inbetween normalOffsets.size.");
+                }
+                dst_ib.normalOffsets.push_back(ib.second.normalOffsets[i]);
+              }
+            }
+
             tmpPointIndices.push_back(dstPointIndices[k]);
           }
         }
@@ -2772,11 +2964,10 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
         target.second.pointIndices.swap(tmpPointIndices);
         target.second.pointOffsets.swap(tmpPointOffsets);
         target.second.normalOffsets.swap(tmpNormalOffsets);
+        target.second.inbetweens.swap(tmpInbetweens);
 
       }
 
-      // TODO: Inbetween BlendShapes
-
     }
 
   }
@@ -2834,6 +3025,107 @@ bool RenderSceneConverter::BuildVertexIndicesImpl(RenderMesh &mesh) {
   return true;
 }
 
+bool RenderSceneConverter::GenerateLODsImpl(RenderMesh &mesh,
+                                            const MeshConverterConfig &config) {
+  mesh.lods.clear();
+
+  if (config.num_lods == 0) {
+    return true;
+  }
+
+  if (!mesh.is_single_indexable) {
+    PUSH_WARN("LODs are not generated for `"
+              << mesh.abs_path
+              << "` since its vertex attributes are not single-indexable.");
+    return true;
+  }
+
+  const std::vector<uint32_t> &counts = mesh.faceVertexCounts();
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+  for (size_t i = 0; i < counts.size(); i++) {
+    if (counts[i] != 3) {
+      PUSH_WARN("LODs are not generated for `"
+                << mesh.abs_path << "` since it is not a triangle mesh.");
+      return true;
+    }
+  }
+
+  if ((config.lod_reduction_ratio <= 0.0f) ||
+      (config.lod_reduction_ratio >= 1.0f)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("lod_reduction_ratio must be in (0, 1), but got {}",
+                    config.lod_reduction_ratio));
+  }
+
+  const size_t num_faces = counts.size();
+
+  // Group id = 1 + (index of GeomSubset). 0 = no GeomSubset.
+  std::vector<uint32_t> face_groups;
+  std::vector<const std::string *> subset_names;
+  if (mesh.material_subsetMap.size()) {
+    face_groups.assign(num_faces, 0);
+    for (const auto &it : mesh.material_subsetMap) {
+      subset_names.push_back(&it.first);
+      const uint32_t group_id = uint32_t(subset_names.size());
+      for (int fid : it.second.indices()) {
+        if ((fid >= 0) && (size_t(fid) < num_faces)) {
+          face_groups[size_t(fid)] = group_id;
+        }
+      }
+    }
+  }
+
+  std::vector<size_t> target_face_counts;
+  double ratio = 1.0;
+  for (uint32_t i = 0; i < config.num_lods; i++) {
+    ratio *= double(config.lod_reduction_ratio);
+    target_face_counts.push_back(size_t(double(num_faces) * ratio));
+  }
+
+  float max_error = (std::numeric_limits<float>::max)();
+  if (config.lod_max_error > 0.0f) {
+    value::float3 lower, upper;
+    ComputePointsBounds(mesh.points.data(), mesh.points.size(), &lower,
+                        &upper);
+    float diag{0.0f};
+    if (mesh.points.size()) {
+      const float dx = upper[0] - lower[0];
+      const float dy = upper[1] - lower[1];
+      const float dz = upper[2] - lower[2];
+      diag = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    max_error = config.lod_max_error * diag;
+  }
+
+  std::vector<SimplifiedMesh> simplified;
+  if (!SimplifyTriangleMesh(mesh.points, indices, face_groups,
+                            target_face_counts, max_error, &simplified,
+                            &_err)) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Failed to simplify mesh `{}`", mesh.abs_path));
+  }
+
+  for (auto &src : simplified) {
+    RenderMeshLOD lod;
+    lod.faceVertexIndices = std::move(src.indices);
+    lod.faceRemap = std::move(src.face_remap);
+    lod.error = src.error;
+
+    if (face_groups.size()) {
+      for (size_t f = 0; f < lod.faceRemap.size(); f++) {
+        const uint32_t group_id = face_groups[lod.faceRemap[f]];
+        if (group_id > 0) {
+          lod.subsetIndices[*subset_names[group_id - 1]].push_back(int(f));
+        }
+      }
+    }
+
+    mesh.lods.emplace_back(std::move(lod));
+  }
+
+  return true;
+}
+
 bool RenderSceneConverter::ConvertMesh(
     const RenderSceneConverterEnv &env, const Path &abs_prim_path,
     const GeomMesh &mesh, const MaterialPath &material_path,
@@ -2897,6 +3189,11 @@ bool RenderSceneConverter::ConvertMesh(
     dst.points.resize(points.size());
     memcpy(dst.points.data(), points.data(),
            sizeof(value::float3) * points.size());
+
+    if (_points_cache) {
+      (*_points_cache) = RenderMeshPointsCache();
+      _points_cache->num_points = points.size();
+    }
   }
 
   {
@@ -3684,7 +3981,7 @@ bool RenderSceneConverter::ConvertMesh(
     dst.joint_and_weights.jointWeights = jointWeightsArray;
     dst.joint_and_weights.elementSize = int(jointIndicesElementSize);
 
-    if (mesh.skeleton.has_value()) {
+    if (_convert_skeletons && mesh.skeleton.has_value()) {
       DCOUT("Convert Skeleton");
       Path skelPath;
 
@@ -3702,6 +3999,12 @@ bool RenderSceneConverter::ConvertMesh(
       }
 
       if (skelPath.is_valid()) {
+#if defined(TINYUSDZ_ENABLE_THREAD)
+        std::unique_lock<std::mutex> skel_lock;
+        if (_skel_mutex) {
+          skel_lock = std::unique_lock<std::mutex>(*_skel_mutex);
+        }
+#endif
         SkelHierarchy skel;
         nonstd::optional<Animation> anim;
         if (!ConvertSkeletonImpl(env, mesh, &skel, &anim)) {
@@ -3777,10 +4080,6 @@ bool RenderSceneConverter::ConvertMesh(
       continue;
     }
 
-    //
-    // TODO: in-between attribs
-    //
-
     std::vector<int> vertex_indices;
     std::vector<value::vector3f> normal_offsets;
     std::vector<value::vector3f> vertex_offsets;
@@ -3836,8 +4135,57 @@ bool RenderSceneConverter::ConvertMesh(
              sizeof(value::normal3f) * normal_offsets.size());
     }
 
-    // TODO inbetweens
-
+    //
+    // Inbetween shapes: `inbetweens:NAME` attribute with `weight` metadatum
+    // and optional `inbetweens:NAME:normalOffsets`.
+    //
+    for (const auto &prop : bs->props) {
+      const std::string &prop_name = prop.first;
+      if (!startsWith(prop_name, "inbetweens:") ||
+          endsWith(prop_name, ":normalOffsets") ||
+          !prop.second.is_attribute()) {
+        continue;
+      }
+
+      const Attribute &attr = prop.second.get_attribute();
+      if (!attr.metas().weight) {
+        PUSH_WARN(fmt::format(
+            "`weight` is not authored for inbetween `{}` in BlendShape `{}`. "
+            "Skipping.",
+            prop_name, bs_path));
+        continue;
+      }
+
+      std::vector<value::vector3f> ib_offsets;
+      if (!attr.get_value(&ib_offsets) ||
+          (ib_offsets.size() != vertex_indices.size())) {
+        PUSH_WARN(fmt::format(
+            "Inbetween `{}` in BlendShape `{}` must be `vector3f[]` with the "
+            "same length as `pointIndices`. Skipping.",
+            prop_name, bs_path));
+        continue;
+      }
+
+      InbetweenShapeTarget inbetween;
+      inbetween.weight = float(attr.metas().weight.value());
+      inbetween.pointOffsets.resize(ib_offsets.size());
+      memcpy(inbetween.pointOffsets.data(), ib_offsets.data(),
+             sizeof(value::vector3f) * ib_offsets.size());
+
+      const auto nit = bs->props.find(prop_name + ":normalOffsets");
+      if ((nit != bs->props.end()) && nit->second.is_attribute()) {
+        std::vector<value::vector3f> ib_normal_offsets;
+        if (nit->second.get_attribute().get_value(&ib_normal_offsets) &&
+            (ib_normal_offsets.size() == vertex_indices.size())) {
+          inbetween.normalOffsets.resize(ib_normal_offsets.size());
+          memcpy(inbetween.normalOffsets.data(), ib_normal_offsets.data(),
+                 sizeof(value::vector3f) * ib_normal_offsets.size());
+        }
+      }
+
+      shapeTarget.inbetweens[inbetween.weight] = std::move(inbetween);
+    }
+
     // TODO: key duplicate check
     dst.targets[bs->name] = shapeTarget;
     DCOUT("Converted blendshape target: " << bs->name);
@@ -3861,12 +4209,18 @@ bool RenderSceneConverter::ConvertMesh(
   if (compute_normals || (compute_tangents && dst.normals.empty())) {
     DCOUT("Compute normals");
     std::vector<vec3> normals;
-    if (!ComputeNormals(dst.points, dst.faceVertexCounts(),
-                       dst.faceVertexIndices(), normals, &_err)) {
+    if (!ComputeVertexNormals(dst.points, dst.faceVertexCounts(),
+                              dst.faceVertexIndices(), &normals, &_err,
+                              _mesh_num_threads)) {
       DCOUT("compute normals failed.");
       return false;
     }
 
+    if (_points_cache) {
+      _points_cache->normals_faceVertexCounts = dst.faceVertexCounts();
+      _points_cache->normals_faceVertexIndices = dst.faceVertexIndices();
+    }
+
     dst.normals.set_buffer(reinterpret_cast<const uint8_t *>(normals.data()),
                            normals.size() * sizeof(vec3));
     dst.normals.elementSize = 1;
@@ -3896,7 +4250,8 @@ bool RenderSceneConverter::ConvertMesh(
   if (env.mesh_config.build_vertex_indices && (!is_single_indexable)) {
     DCOUT("Build vertex indices");
 
-    if (!BuildVertexIndicesImpl(dst)) {
+    if (!BuildVertexIndicesImpl(dst,
+                                env.mesh_config.build_vertex_indices_eps)) {
       return false;
     }
 
@@ -3968,7 +4323,8 @@ bool RenderSceneConverter::ConvertMesh(
 
     // 2. Build single vertex indices if `build_vertex_indices` is true.
     if (env.mesh_config.build_vertex_indices) {
-      if (!BuildVertexIndicesImpl(dst)) {
+      if (!BuildVertexIndicesImpl(dst,
+                                  env.mesh_config.build_vertex_indices_eps)) {
         return false;
       }
       is_single_indexable = true;
@@ -3981,6 +4337,22 @@ bool RenderSceneConverter::ConvertMesh(
   dst.abs_path = abs_prim_path.full_path_name();
   dst.display_name = mesh.metas().displayName.value_or("");
 
+  //
+  // 9. Generate LODs
+  //
+  if (!GenerateLODsImpl(dst, env.mesh_config)) {
+    return false;
+  }
+
+  if (_points_cache) {
+    // Computed normals are gathered with `point_remap`, so they must be
+    // 'vertex' varying. Tangents and LODs are not updated from points.
+    _points_cache->valid =
+        !compute_tangents && dst.lods.empty() &&
+        (_points_cache->normals_faceVertexIndices.empty() ||
+         (dst.normals.variability == VertexVariability::Vertex));
+  }
+
   (*dstMesh) = std::move(dst);
 
   return true;
@@ -5053,11 +5425,69 @@ bool RenderSceneConverter::ConvertMaterial(const RenderSceneConverterEnv &env,
 
 namespace {
 
+// GeomMesh to be converted by ConvertMesh. Bound Materials are already
+// converted.
+struct MeshConversionTask : public RenderMeshSource {
+  // The number of RenderMaterials converted when this GeomMesh is visited.
+  // ConvertMesh only sees these Materials, so the result is identical to the
+  // serial conversion.
+  size_t num_materials{0};
+};
+
+struct MeshConversionResult {
+  bool ok{false};
+  std::string err;
+  std::string warn;
+  int worker_id{-1};
+};
+
 struct MeshVisitorEnv {
   RenderSceneConverter *converter{nullptr};
   const RenderSceneConverterEnv *env{nullptr};
+
+  // When non-null, collect GeomMeshes to `tasks` and defer ConvertMesh.
+  std::vector<MeshConversionTask> *tasks{nullptr};
+
+  // Time-varying GeomMeshes converted in MeshVisitor.
+  std::vector<RenderMeshSource> *timevarying_meshes{nullptr};
 };
 
+bool IsTimeVaryingMesh(const GeomMesh &mesh) {
+  if (mesh.points.has_timesamples() || mesh.normals.has_timesamples() ||
+      mesh.faceVertexCounts.has_timesamples() ||
+      mesh.faceVertexIndices.has_timesamples()) {
+    return true;
+  }
+
+  // primvars
+  for (const auto &prop : mesh.props) {
+    if (prop.second.is_attribute() &&
+        prop.second.get_attribute().has_timesamples()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool IsTimeVaryingXformable(const Prim &prim) {
+  const Xformable *xformable{nullptr};
+  if (!CastToXformable(prim, &xformable) || !xformable) {
+    return false;
+  }
+
+  return xformable->is_time_varying();
+}
+
+bool IsTimeVaryingPointInstancer(const PointInstancer &instancer) {
+  return instancer.protoIndices.has_timesamples() ||
+         instancer.ids.has_timesamples() ||
+         instancer.positions.has_timesamples() ||
+         instancer.orientations.has_timesamples() ||
+         instancer.scales.has_timesamples() ||
+         instancer.invisibleIds.has_timesamples();
+}
+
 bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
                  const int32_t level, void *userdata, std::string *err) {
   if (!userdata) {
@@ -5321,6 +5751,20 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
       }
       DCOUT("# of blendshapes : " << blendshapes.size());
 
+      if (visitorEnv->tasks) {
+        MeshConversionTask task;
+        task.abs_path = abs_path;
+        task.mesh = pmesh;
+        task.material_path = material_path;
+        task.subset_material_path_map = std::move(subset_material_path_map);
+        task.material_subsets = std::move(material_subsets);
+        task.blendshapes = std::move(blendshapes);
+        task.num_materials = visitorEnv->converter->materials.size();
+
+        visitorEnv->tasks->emplace_back(std::move(task));
+        return true;
+      }
+
       RenderMesh rmesh;
 
       if (!visitorEnv->converter->ConvertMesh(
@@ -5346,6 +5790,18 @@ bool MeshVisitor(const tinyusdz::Path &abs_path, const tinyusdz::Prim &prim,
       visitorEnv->converter->meshMap.add(abs_path.full_path_name(), mesh_id);
 
       visitorEnv->converter->meshes.emplace_back(std::move(rmesh));
+
+      if (visitorEnv->timevarying_meshes && IsTimeVaryingMesh(*pmesh)) {
+        RenderMeshSource src;
+        src.mesh_id = int32_t(mesh_id);
+        src.abs_path = abs_path;
+        src.mesh = pmesh;
+        src.material_path = material_path;
+        src.subset_material_path_map = std::move(subset_material_path_map);
+        src.material_subsets = std::move(material_subsets);
+        src.blendshapes = std::move(blendshapes);
+        visitorEnv->timevarying_meshes->emplace_back(std::move(src));
+      }
     }
   }
 
@@ -5384,7 +5840,8 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
     }
   }
 
-  // TODO: inbetweens BlendShape
+  // NOTE: Inbetween shapes are driven by the weight of their BlendShape, so
+  // no extra channel is required for them.
   std::vector<value::token> blendShapes;
   if (skelAnim.blendShapes.authored()) {
     if (!EvaluateTypedAttribute(env.stage, skelAnim.blendShapes, "blendShapes", &blendShapes, &_err)) {
@@ -5724,6 +6181,301 @@ bool RenderSceneConverter::ConvertSkelAnimation(const RenderSceneConverterEnv &e
   return true;
 }
 
+namespace {
+
+void CollectPointInstancerNodes(const XformNode &node,
+                                std::vector<const XformNode *> *out) {
+  if (node.prim &&
+      (node.prim->type_id() == value::TYPE_ID_GEOM_POINT_INSTANCER)) {
+    out->push_back(&node);
+  }
+
+  for (const auto &child : node.children) {
+    CollectPointInstancerNodes(child, out);
+  }
+}
+
+const XformNode *FindXformNode(const XformNode &node,
+                               const std::string &abs_path) {
+  for (const auto &child : node.children) {
+    const std::string child_path = child.absolute_path.full_path_name();
+    if (child_path == abs_path) {
+      return &child;
+    }
+
+    // Descend only when `child` is an ancestor of `abs_path`.
+    if ((abs_path.size() > child_path.size()) &&
+        (abs_path.compare(0, child_path.size(), child_path) == 0) &&
+        (abs_path[child_path.size()] == '/')) {
+      return FindXformNode(child, abs_path);
+    }
+  }
+
+  return nullptr;
+}
+
+//
+// Collect converted meshes in the prototype subtree with their transform
+// relative to the prototype root.
+//
+void CollectPrototypeMeshes(const XformNode &node,
+                            const value::matrix4d &parent_matrix,
+                            const StringAndIdMap &meshMap,
+                            InstancePrototype *proto) {
+  value::matrix4d m;
+  if (node.has_resetXformStack()) {
+    m = node.get_local_matrix();
+  } else {
+    m = node.get_local_matrix() * parent_matrix;
+  }
+
+  const std::string path = node.absolute_path.full_path_name();
+  if (meshMap.count(path)) {
+    proto->mesh_ids.push_back(int32_t(meshMap.at(path)));
+    proto->mesh_local_matrices.push_back(m);
+  }
+
+  for (const auto &child : node.children) {
+    CollectPrototypeMeshes(child, m, meshMap, proto);
+  }
+}
+
+}  // namespace
+
+bool RenderSceneConverter::ConvertPointInstancer(
+    const RenderSceneConverterEnv &env, const XformNode &root,
+    const Path &abs_path, const PointInstancer &instancer,
+    RenderPointInstancer *dst) {
+  if (!dst) {
+    PUSH_ERROR_AND_RETURN("`dst` argument is nullptr.");
+  }
+
+  dst->abs_path = abs_path.full_path_name();
+  dst->prim_name = instancer.name;
+  dst->display_name = instancer.metas().displayName.value_or("");
+
+  std::vector<Path> proto_paths;
+  if (instancer.prototypes.has_value()) {
+    const Relationship &rel = instancer.prototypes.value();
+    if (rel.is_path()) {
+      proto_paths.push_back(rel.targetPath);
+    } else if (rel.is_pathvector()) {
+      proto_paths = rel.targetPathVector;
+    }
+  }
+
+  if (proto_paths.empty()) {
+    PUSH_WARN(fmt::format("PointInstancer {} has no `prototypes`.",
+                          dst->abs_path));
+    return true;
+  }
+
+  //
+  // Prototypes. Look up meshes converted from the prototype subtree.
+  //
+  dst->prototypes.resize(proto_paths.size());
+  for (size_t p = 0; p < proto_paths.size(); p++) {
+    InstancePrototype &proto = dst->prototypes[p];
+    proto.abs_path = proto_paths[p].prim_part();
+
+    const XformNode *proto_node = FindXformNode(root, proto.abs_path);
+    if (!proto_node) {
+      PUSH_WARN(fmt::format("Prototype Prim {} not found. PointInstancer {}",
+                            proto.abs_path, dst->abs_path));
+      continue;
+    }
+
+    // The prototype's own xform is applied, but not its ancestors'.
+    CollectPrototypeMeshes(*proto_node, value::matrix4d::identity(), meshMap,
+                           &proto);
+
+    if (proto.mesh_ids.empty()) {
+      // e.g. GeomPoints, GeomBasisCurves
+      PUSH_WARN(fmt::format(
+          "Prototype {} has no GeomMesh. Only GeomMesh is supported as an "
+          "instance for now. PointInstancer {}",
+          proto.abs_path, dst->abs_path));
+    }
+  }
+
+  return EvaluatePointInstances(env, instancer, dst);
+}
+
+bool RenderSceneConverter::EvaluatePointInstances(
+    const RenderSceneConverterEnv &env, const PointInstancer &instancer,
+    RenderPointInstancer *dst) {
+  if (!dst) {
+    PUSH_ERROR_AND_RETURN("`dst` argument is nullptr.");
+  }
+
+  for (auto &proto : dst->prototypes) {
+    proto.instance_transforms.clear();
+    proto.instance_indices.clear();
+  }
+  dst->num_instances = 0;
+
+  if (dst->prototypes.empty()) {
+    return true;
+  }
+
+  if (!instancer.protoIndices.authored()) {
+    PUSH_WARN(fmt::format("PointInstancer {} has no `protoIndices`.",
+                          dst->abs_path));
+    return true;
+  }
+
+  std::vector<int32_t> protoIndices;
+  if (!EvaluateTypedAnimatableAttribute(env.stage, instancer.protoIndices,
+                                        "protoIndices", &protoIndices, &_err,
+                                        env.timecode, env.tinterp)) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "Failed to evaluate `protoIndices` of PointInstancer {}.",
+        dst->abs_path));
+  }
+
+  const size_t num_instances = protoIndices.size();
+
+  // `positions` is required. `orientations` and `scales` are optional.
+  std::vector<value::point3f> positions;
+  if (instancer.positions.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(env.stage, instancer.positions,
+                                          "positions", &positions, &_err,
+                                          env.timecode, env.tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `positions` of PointInstancer {}.",
+          dst->abs_path));
+    }
+  }
+
+  if (positions.size() != num_instances) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "`positions`.size {} must be equal to `protoIndices`.size {} : {}",
+        positions.size(), num_instances, dst->abs_path));
+  }
+
+  std::vector<value::quath> orientations;
+  if (instancer.orientations.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(env.stage, instancer.orientations,
+                                          "orientations", &orientations, &_err,
+                                          env.timecode, env.tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `orientations` of PointInstancer {}.",
+          dst->abs_path));
+    }
+
+    if (orientations.size() != num_instances) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "`orientations`.size {} must be equal to `protoIndices`.size {} : "
+          "{}",
+          orientations.size(), num_instances, dst->abs_path));
+    }
+  }
+
+  std::vector<value::float3> scales;
+  if (instancer.scales.authored()) {
+    if (!EvaluateTypedAnimatableAttribute(env.stage, instancer.scales,
+                                          "scales", &scales, &_err,
+                                          env.timecode, env.tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `scales` of PointInstancer {}.", dst->abs_path));
+    }
+
+    if (scales.size() != num_instances) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "`scales`.size {} must be equal to `protoIndices`.size {} : {}",
+          scales.size(), num_instances, dst->abs_path));
+    }
+  }
+
+  //
+  // Instance visibility.
+  // `invisibleIds` refers `ids`, or the instance index when `ids` is not
+  // authored.
+  //
+  std::vector<bool> visible(num_instances, true);
+  if (instancer.invisibleIds.authored()) {
+    std::vector<int64_t> invisibleIds;
+    if (!EvaluateTypedAnimatableAttribute(env.stage, instancer.invisibleIds,
+                                          "invisibleIds", &invisibleIds, &_err,
+                                          env.timecode, env.tinterp)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Failed to evaluate `invisibleIds` of PointInstancer {}.",
+          dst->abs_path));
+    }
+
+    if (invisibleIds.size()) {
+      std::vector<int64_t> ids;
+      if (instancer.ids.authored()) {
+        if (!EvaluateTypedAnimatableAttribute(env.stage, instancer.ids, "ids",
+                                              &ids, &_err, env.timecode,
+                                              env.tinterp)) {
+          PUSH_ERROR_AND_RETURN(fmt::format(
+              "Failed to evaluate `ids` of PointInstancer {}.",
+              dst->abs_path));
+        }
+
+        if (ids.size() != num_instances) {
+          PUSH_ERROR_AND_RETURN(fmt::format(
+              "`ids`.size {} must be equal to `protoIndices`.size {} : {}",
+              ids.size(), num_instances, dst->abs_path));
+        }
+      }
+
+      std::sort(invisibleIds.begin(), invisibleIds.end());
+
+      for (size_t i = 0; i < num_instances; i++) {
+        const int64_t id = ids.empty() ? int64_t(i) : ids[i];
+        if (std::binary_search(invisibleIds.begin(), invisibleIds.end(), id)) {
+          visible[i] = false;
+        }
+      }
+    }
+  }
+
+  //
+  // Bucket instances by prototype.
+  //
+  for (size_t i = 0; i < num_instances; i++) {
+    if (!visible[i]) {
+      continue;
+    }
+
+    const int32_t proto_id = protoIndices[i];
+    if ((proto_id < 0) || (size_t(proto_id) >= dst->prototypes.size())) {
+      PUSH_WARN(fmt::format(
+          "protoIndices[{}] {} is out-of-range. PointInstancer {}", i,
+          proto_id, dst->abs_path));
+      continue;
+    }
+
+    // M = scale * orientation * translate(row-major)
+    const value::float3 s =
+        scales.empty() ? value::float3{1.0f, 1.0f, 1.0f} : scales[i];
+
+    value::matrix3d r = value::matrix3d::identity();
+    if (orientations.size()) {
+      r = to_matrix3x3(orientations[i]);
+    }
+
+    value::matrix4f m;
+    for (size_t row = 0; row < 3; row++) {
+      for (size_t col = 0; col < 3; col++) {
+        m.m[row][col] = float(double(s[row]) * r.m[row][col]);
+      }
+    }
+    m.m[3][0] = positions[i][0];
+    m.m[3][1] = positions[i][1];
+    m.m[3][2] = positions[i][2];
+
+    InstancePrototype &proto = dst->prototypes[size_t(proto_id)];
+    proto.instance_transforms.push_back(m);
+    proto.instance_indices.push_back(uint32_t(i));
+    dst->num_instances++;
+  }
+
+  return true;
+}
+
 bool RenderSceneConverter::BuildNodeHierarchyImpl(
     const RenderSceneConverterEnv &env, const std::string &parentPrimPath,
     const XformNode &node, Node &out_rnode) {
@@ -5742,6 +6494,10 @@ bool RenderSceneConverter::BuildNodeHierarchyImpl(
     rnode.abs_path = primPath;
     rnode.display_name = prim->metas().displayName.value_or("");
 
+    if (IsTimeVaryingXformable(*prim)) {
+      _timevarying_xforms[primPath] = prim;
+    }
+
     DCOUT("rnode.prim_name " << rnode.prim_name);
     DCOUT("node.local_mat " << node.get_local_matrix());
     DCOUT("node.has_resetXform " << node.has_resetXformStack());
@@ -5761,6 +6517,22 @@ bool RenderSceneConverter::BuildNodeHierarchyImpl(
       } else {
         rnode.id = -1;
       }
+    } else if (prim->type_id() == value::TYPE_ID_GEOM_POINT_INSTANCER) {
+      rnode.local_matrix = node.get_local_matrix();
+      rnode.global_matrix = node.get_world_matrix();
+      rnode.has_resetXform = node.has_resetXformStack();
+      rnode.nodeType = NodeType::PointInstancer;
+
+      if (instancerMap.count(primPath)) {
+        rnode.id = int32_t(instancerMap.at(primPath));
+      } else {
+        rnode.id = -1;
+      }
+
+      // Prototypes are drawn only through instances, so do not traverse
+      // descendants of PointInstancer(as done in UsdImaging).
+      out_rnode = std::move(rnode);
+      return true;
     } else if (prim->type_id() == value::TYPE_ID_GEOM_CAMERA) {
       rnode.local_matrix = node.get_local_matrix();
       rnode.global_matrix = node.get_world_matrix();
@@ -5855,6 +6627,43 @@ bool RenderSceneConverter::BuildNodeHierarchy(
   return true;
 }
 
+int RenderSceneConverter::MergeSkeleton(const RenderSceneConverter &worker,
+                                        int worker_skel_id) {
+  const SkelHierarchy &src = worker.skeletons[size_t(worker_skel_id)];
+
+  auto skel_it = std::find_if(
+      skeletons.begin(), skeletons.end(),
+      [&src](const SkelHierarchy &sk) { return sk.abs_path == src.abs_path; });
+
+  SkelHierarchy skel = src;
+
+  // Add Animation first to keep the order of `animations` same with the
+  // serial conversion.
+  if ((src.anim_id > -1) && (size_t(src.anim_id) < worker.animations.size())) {
+    const Animation &anim = worker.animations[size_t(src.anim_id)];
+
+    auto anim_it = std::find_if(
+        animations.begin(), animations.end(),
+        [&anim](const Animation &a) { return a.abs_path == anim.abs_path; });
+
+    if (anim_it != animations.end()) {
+      skel.anim_id = int(std::distance(animations.begin(), anim_it));
+    } else {
+      skel.anim_id = int(animations.size());
+      animations.push_back(anim);
+    }
+  }
+
+  if (skel_it != skeletons.end()) {
+    return int(std::distance(skeletons.begin(), skel_it));
+  }
+
+  int skel_id = int(skeletons.size());
+  skeletons.emplace_back(std::move(skel));
+
+  return skel_id;
+}
+
 bool RenderSceneConverter::ConvertToRenderScene(
     const RenderSceneConverterEnv &env, RenderScene *scene) {
   if (!scene) {
@@ -5886,9 +6695,24 @@ bool RenderSceneConverter::ConvertToRenderScene(
   //
   // Material conversion will be done in MeshVisitor.
   //
+  // With multiple threads, MeshVisitor only converts Materials and collects
+  // GeomMeshes, then GeomMeshes are converted in parallel.
+  //
+  const int num_threads = thread::GetNumThreads(env.scene_config.num_threads);
+
+  std::vector<MeshConversionTask> mesh_tasks;
+
+  _timevarying_xforms.clear();
+  _timevarying_meshes.clear();
+  _timevarying_instancers.clear();
+
+  _mesh_num_threads = num_threads;
+
   MeshVisitorEnv menv;
   menv.env = &env;
   menv.converter = this;
+  menv.tasks = (num_threads > 1) ? &mesh_tasks : nullptr;
+  menv.timevarying_meshes = &_timevarying_meshes;
 
   bool ret = tydra::VisitPrims(env.stage, MeshVisitor, &menv, &err);
 
@@ -5896,6 +6720,132 @@ bool RenderSceneConverter::ConvertToRenderScene(
     PUSH_ERROR_AND_RETURN(err);
   }
 
+  if (!mesh_tasks.empty()) {
+    // Build Prim index of Stage before spawning threads, since Prim lookup
+    // lazily (re)builds it.
+    (void)env.stage.GetPrimAtPath(mesh_tasks[0].abs_path);
+
+    // Each thread has its own converter so that `_err`, `_warn`, `skeletons`
+    // and `animations` are not shared.
+    const size_t num_workers =
+        (std::min)(size_t(num_threads), mesh_tasks.size());
+    std::vector<RenderSceneConverter> workers(num_workers);
+#if defined(TINYUSDZ_ENABLE_THREAD)
+    std::mutex skel_mutex;
+#endif
+    // Split remaining threads among workers for per-mesh processing(e.g.
+    // normal computation of a large mesh).
+    const int mesh_num_threads =
+        (std::max)(1, num_threads / int(mesh_tasks.size()));
+    for (auto &worker : workers) {
+      worker.textures = textures;
+      worker._mesh_num_threads = mesh_num_threads;
+#if defined(TINYUSDZ_ENABLE_THREAD)
+      worker._skel_mutex = &skel_mutex;
+#endif
+    }
+
+    const StringAndIdMap &all_material_map = materialMap;
+    const StringAndIdMap no_material_map;
+
+    std::vector<RenderMesh> rmeshes(mesh_tasks.size());
+    std::vector<MeshConversionResult> results(mesh_tasks.size());
+
+    thread::ParallelFor(
+        0, mesh_tasks.size(), int(num_workers),
+        [&](size_t i, int thread_id) {
+          const MeshConversionTask &task = mesh_tasks[i];
+          RenderSceneConverter &worker = workers[size_t(thread_id)];
+
+          // Expose Materials converted up to the visit of this GeomMesh.
+          if (worker.materials.size() > task.num_materials) {
+            worker.materials.resize(task.num_materials);
+          }
+          worker.materials.insert(
+              worker.materials.end(),
+              materials.begin() + std::ptrdiff_t(worker.materials.size()),
+              materials.begin() + std::ptrdiff_t(task.num_materials));
+
+          const size_t err_pos = worker._err.size();
+          const size_t warn_pos = worker._warn.size();
+
+          MeshConversionResult &result = results[i];
+          result.ok = worker.ConvertMesh(
+              env, task.abs_path, *task.mesh, task.material_path,
+              task.subset_material_path_map,
+              (task.num_materials > 0) ? all_material_map : no_material_map,
+              task.material_subsets, task.blendshapes, &rmeshes[i]);
+          result.err = worker._err.substr(err_pos);
+          result.warn = worker._warn.substr(warn_pos);
+          result.worker_id = thread_id;
+        });
+
+    // Merge results in the visit order.
+    for (size_t i = 0; i < mesh_tasks.size(); i++) {
+      const MeshConversionResult &result = results[i];
+
+      _warn += result.warn;
+
+      if (!result.ok) {
+        PUSH_ERROR_AND_RETURN(
+            fmt::format("Mesh conversion failed: {}\n{}\n",
+                        mesh_tasks[i].abs_path.full_path_name(), result.err));
+      }
+      _err += result.err;
+
+      RenderMesh &rmesh = rmeshes[i];
+      if (rmesh.skel_id > -1) {
+        rmesh.skel_id =
+            MergeSkeleton(workers[size_t(result.worker_id)], rmesh.skel_id);
+      }
+
+      uint64_t mesh_id = uint64_t(meshes.size());
+      if (mesh_id >= size_t((std::numeric_limits<int32_t>::max)())) {
+        PUSH_ERROR_AND_RETURN("Mesh index too large.\n");
+      }
+      meshMap.add(mesh_tasks[i].abs_path.full_path_name(), mesh_id);
+
+      meshes.emplace_back(std::move(rmesh));
+
+      if (IsTimeVaryingMesh(*mesh_tasks[i].mesh)) {
+        RenderMeshSource src = std::move(mesh_tasks[i]);
+        src.mesh_id = int32_t(mesh_id);
+        _timevarying_meshes.emplace_back(std::move(src));
+      }
+    }
+  }
+
+  //
+  // 4.5. Convert PointInstancer.
+  //      Meshes in prototypes are already converted above.
+  //
+  {
+    std::vector<const XformNode *> instancer_nodes;
+    CollectPointInstancerNodes(xform_node, &instancer_nodes);
+
+    for (const XformNode *node : instancer_nodes) {
+      const PointInstancer *pinstancer = node->prim->as<PointInstancer>();
+      if (!pinstancer) {
+        continue;
+      }
+
+      RenderPointInstancer rinstancer;
+      if (!ConvertPointInstancer(env, xform_node, node->absolute_path,
+                                 *pinstancer, &rinstancer)) {
+        return false;
+      }
+
+      if (IsTimeVaryingPointInstancer(*pinstancer)) {
+        _timevarying_instancers.emplace_back(int32_t(instancers.size()),
+                                             pinstancer);
+      }
+
+      instancerMap.add(node->absolute_path.full_path_name(),
+                       uint64_t(instancers.size()));
+      instancers.emplace_back(std::move(rinstancer));
+    }
+  }
+
   //
   // 5. Build node hierarchy from XformNode and meshes, materials, skeletons,
   // etc.
@@ -5928,11 +6878,357 @@ bool RenderSceneConverter::ConvertToRenderScene(
   render_scene.materials = std::move(materials);
   render_scene.skeletons = std::move(skeletons);
   render_scene.animations = std::move(animations);
+  render_scene.instancers = std::move(instancers);
 
   (*scene) = std::move(render_scene);
   return true;
 }
 
+namespace {
+
+//
+// Re-evaluate time-varying xformOps and propagate world matrix to
+// descendants.
+//
+bool UpdateNodeTransformRec(
+    const std::map<std::string, const Prim *> &timevarying_xforms,
+    const double t, const value::TimeSampleInterpolationType tinterp,
+    const value::matrix4d &parent_matrix, const bool parent_dirty,
+    Node &node, std::vector<std::string> *dirty_nodes, std::string *err) {
+  bool dirty = parent_dirty;
+
+  const auto it = timevarying_xforms.find(node.abs_path);
+  if (it != timevarying_xforms.end()) {
+    const Xformable *xformable{nullptr};
+    if (CastToXformable(*it->second, &xformable) && xformable) {
+      value::matrix4d m;
+      bool resetXformStack{false};
+      std::string local_err;
+      // NOTE: Do not use Xformable::GetLocalMatrix. It overwrites the matrix
+      // cached in the Prim(mutable members) for each new (t, tinterp), i.e.
+      // mutates the Stage which may be read by others.
+      if (!xformable->EvaluateXformOps(t, tinterp, &m, &resetXformStack,
+                                       &local_err)) {
+        if (err) {
+          (*err) += fmt::format("Failed to evaluate xformOps of {}: {}\n",
+                                node.abs_path, local_err);
+        }
+        return false;
+      }
+
+      if (!is_close(m, node.local_matrix, /* exact */ 0.0) ||
+          (resetXformStack != node.has_resetXform)) {
+        node.local_matrix = m;
+        node.has_resetXform = resetXformStack;
+        dirty = true;
+      }
+    }
+  }
+
+  if (dirty) {
+    const value::matrix4d global_matrix =
+        node.has_resetXform ? node.local_matrix
+                            : node.local_matrix * parent_matrix;
+    if (is_close(global_matrix, node.global_matrix, /* exact */ 0.0)) {
+      dirty = false;
+    } else {
+      node.global_matrix = global_matrix;
+      dirty_nodes->push_back(node.abs_path);
+    }
+  }
+
+  for (auto &child : node.children) {
+    if (!UpdateNodeTransformRec(timevarying_xforms, t, tinterp,
+                                node.global_matrix, dirty, child, dirty_nodes,
+                                err)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//
+// True when `points` is the only time-varying attribute of GeomMesh.
+//
+bool IsPointsOnlyTimeVaryingMesh(const GeomMesh &mesh) {
+  if (!mesh.points.has_timesamples() || mesh.normals.has_timesamples() ||
+      mesh.faceVertexCounts.has_timesamples() ||
+      mesh.faceVertexIndices.has_timesamples()) {
+    return false;
+  }
+
+  for (const auto &prop : mesh.props) {
+    if (prop.second.is_attribute() &&
+        prop.second.get_attribute().has_timesamples()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Gather `src` with `remap`(empty = identity).
+bool GatherVec3(const std::vector<value::float3> &src,
+                const std::vector<uint32_t> &remap,
+                std::vector<value::float3> *dst) {
+  if (remap.empty()) {
+    (*dst) = src;
+    return true;
+  }
+
+  dst->resize(remap.size());
+  for (size_t i = 0; i < remap.size(); i++) {
+    if (remap[i] >= src.size()) {
+      return false;
+    }
+    (*dst)[i] = src[remap[i]];
+  }
+
+  return true;
+}
+
+bool IsSameVertexAttribute(const VertexAttribute &a,
+                           const VertexAttribute &b) {
+  return (a.variability == b.variability) && (a.format == b.format) &&
+         (a.data == b.data) && (a.indices == b.indices);
+}
+
+//
+// Compare vertex data of RenderMesh(re)converted from the same GeomMesh.
+//
+bool IsSameMeshData(const RenderMesh &a, const RenderMesh &b) {
+  if ((a.points != b.points) ||
+      (a.usdFaceVertexCounts != b.usdFaceVertexCounts) ||
+      (a.usdFaceVertexIndices != b.usdFaceVertexIndices) ||
+      (a.faceVertexIndices() != b.faceVertexIndices()) ||
+      !IsSameVertexAttribute(a.normals, b.normals) ||
+      !IsSameVertexAttribute(a.tangents, b.tangents) ||
+      !IsSameVertexAttribute(a.binormals, b.binormals) ||
+      !IsSameVertexAttribute(a.vertex_colors, b.vertex_colors) ||
+      !IsSameVertexAttribute(a.vertex_opacities, b.vertex_opacities) ||
+      (a.joint_and_weights.jointIndices != b.joint_and_weights.jointIndices) ||
+      (a.joint_and_weights.jointWeights != b.joint_and_weights.jointWeights) ||
+      (a.texcoords.size() != b.texcoords.size())) {
+    return false;
+  }
+
+  for (const auto &it : a.texcoords) {
+    const auto bit = b.texcoords.find(it.first);
+    if ((bit == b.texcoords.end()) ||
+        !IsSameVertexAttribute(it.second, bit->second)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//
+// Update `points`(and normals computed from them) of RenderMesh with the
+// cached point index mapping. `cache->valid` is cleared when the number of
+// points is changed(the whole mesh must be reconverted).
+//
+bool UpdateMeshPoints(const RenderSceneConverterEnv &env, const GeomMesh &mesh,
+                      const int num_threads, RenderMeshPointsCache *cache,
+                      RenderMesh *dst, bool *changed, std::string *err) {
+  (*changed) = false;
+
+  std::vector<value::point3f> points;
+  if (!EvaluateTypedAnimatableAttribute(
+          env.stage, mesh.points, "points", &points, err, env.timecode,
+          value::TimeSampleInterpolationType::Linear)) {
+    return false;
+  }
+
+  if (points.size() != cache->num_points) {
+    cache->valid = false;
+    return true;
+  }
+
+  std::vector<value::float3> src_points(points.size());
+  memcpy(src_points.data(), points.data(),
+         sizeof(value::float3) * points.size());
+
+  std::vector<value::float3> new_points;
+  if (!GatherVec3(src_points, cache->point_remap, &new_points)) {
+    if (err) {
+      (*err) += "Internal error. Invalid point index mapping.\n";
+    }
+    return false;
+  }
+
+  std::vector<value::float3> new_normals;
+  if (!cache->normals_faceVertexIndices.empty()) {
+    std::vector<value::float3> normals;
+    if (!ComputeVertexNormals(src_points, cache->normals_faceVertexCounts,
+                              cache->normals_faceVertexIndices, &normals, err,
+                              num_threads)) {
+      return false;
+    }
+
+    if (!GatherVec3(normals, cache->point_remap, &new_normals)) {
+      if (err) {
+        (*err) += "Internal error. Invalid point index mapping.\n";
+      }
+      return false;
+    }
+  }
+
+  const size_t normals_bytes = new_normals.size() * sizeof(value::float3);
+  const bool normals_changed =
+      !new_normals.empty() &&
+      ((dst->normals.data.size() != normals_bytes) ||
+       (memcmp(dst->normals.data.data(), new_normals.data(), normals_bytes) !=
+        0));
+
+  if ((new_points == dst->points) && !normals_changed) {
+    return true;
+  }
+
+  dst->points.swap(new_points);
+  if (normals_changed) {
+    dst->normals.set_buffer(
+        reinterpret_cast<const uint8_t *>(new_normals.data()), normals_bytes);
+  }
+  (*changed) = true;
+
+  return true;
+}
+
+}  // namespace
+
+bool RenderSceneConverter::UpdateToTime(const RenderSceneConverterEnv &env,
+                                        const double t, RenderScene *scene,
+                                        RenderSceneDirtyList *dirty) {
+  if (!scene) {
+    PUSH_ERROR_AND_RETURN("nullptr for RenderScene argument.");
+  }
+
+  if (!dirty) {
+    PUSH_ERROR_AND_RETURN("nullptr for RenderSceneDirtyList argument.");
+  }
+
+  dirty->clear();
+
+  RenderSceneConverterEnv tenv(env);
+  tenv.timecode = t;
+
+  //
+  // Node transforms
+  //
+  if (!_timevarying_xforms.empty()) {
+    for (auto &node : scene->nodes) {
+      if (!UpdateNodeTransformRec(_timevarying_xforms, t, env.tinterp,
+                                  value::matrix4d::identity(),
+                                  /* parent_dirty */ false, node,
+                                  &dirty->nodes, &_err)) {
+        return false;
+      }
+    }
+  }
+
+  //
+  // Meshes. Reconvert GeomMesh with its bound Materials resolved in the
+  // first conversion, or just update `points` with the cached topology.
+  //
+  if (!_timevarying_meshes.empty()) {
+    // ConvertMesh refers converted Materials and Textures.
+    materials.swap(scene->materials);
+    textures.swap(scene->textures);
+
+    _mesh_num_threads = thread::GetNumThreads(env.scene_config.num_threads);
+
+    bool ok = true;
+    for (auto &src : _timevarying_meshes) {
+      if ((src.mesh_id < 0) || (size_t(src.mesh_id) >= scene->meshes.size())) {
+        PushError(fmt::format("Invalid mesh id {}. RenderScene is not the one "
+                              "converted by this converter?\n",
+                              src.mesh_id));
+        ok = false;
+        break;
+      }
+
+      RenderMesh &dst = scene->meshes[size_t(src.mesh_id)];
+
+      if (src.points_cache.valid) {
+        bool changed{false};
+        if (!UpdateMeshPoints(tenv, *src.mesh, _mesh_num_threads,
+                              &src.points_cache, &dst, &changed, &_err)) {
+          PushError(fmt::format("Failed to update points: {}\n",
+                                src.abs_path.full_path_name()));
+          ok = false;
+          break;
+        }
+
+        if (src.points_cache.valid) {
+          if (changed) {
+            dirty->meshes.push_back(src.mesh_id);
+          }
+          continue;
+        }
+        // The number of points is changed. Reconvert the whole mesh.
+      }
+
+      // Skeleton binding is not time-varying, so Skeletons(and SkelAnimations)
+      // are not converted again.
+      _points_cache =
+          IsPointsOnlyTimeVaryingMesh(*src.mesh) ? &src.points_cache : nullptr;
+      _convert_skeletons = false;
+
+      RenderMesh rmesh;
+      const bool converted =
+          ConvertMesh(tenv, src.abs_path, *src.mesh, src.material_path,
+                      src.subset_material_path_map, materialMap,
+                      src.material_subsets, src.blendshapes, &rmesh);
+
+      _points_cache = nullptr;
+      _convert_skeletons = true;
+
+      if (!converted) {
+        PushError(fmt::format("Mesh conversion failed: {}\n",
+                              src.abs_path.full_path_name()));
+        ok = false;
+        break;
+      }
+
+      rmesh.skel_id = dst.skel_id;
+
+      if (!IsSameMeshData(rmesh, dst)) {
+        dst = std::move(rmesh);
+        dirty->meshes.push_back(src.mesh_id);
+      }
+    }
+
+    materials.swap(scene->materials);
+    textures.swap(scene->textures);
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  //
+  // PointInstancer instances
+  //
+  for (const auto &item : _timevarying_instancers) {
+    if ((item.first < 0) || (size_t(item.first) >= scene->instancers.size())) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Invalid instancer id {}. RenderScene is not the one converted by "
+          "this converter?",
+          item.first));
+    }
+
+    if (!EvaluatePointInstances(tenv, *item.second,
+                                &scene->instancers[size_t(item.first)])) {
+      return false;
+    }
+    dirty->instancers.push_back(item.first);
+  }
+
+  return true;
+}
+
 bool RenderSceneConverter::ConvertSkeletonImpl(const RenderSceneConverterEnv &env, const tinyusdz::GeomMesh &mesh,
                        SkelHierarchy *out_skel, nonstd::optional<Animation> *out_anim) {
 
@@ -6644,6 +7940,8 @@ inline std::string to_string(NodeType ntype) {
     return "directionalLight";
   } else if (ntype == NodeType::Skeleton) {
     return "skeleton";
+  } else if (ntype == NodeType::PointInstancer) {
+    return "pointInstancer";
   }
   return "???";
 }
@@ -6780,6 +8078,18 @@ std::string DumpMesh(const RenderMesh &mesh, uint32_t indent) {
     }
     ss << pprint::Indent(indent + 1) << "}\n";
   }
+  if (mesh.lods.size()) {
+    ss << pprint::Indent(indent + 1) << "lods {\n";
+    for (size_t i = 0; i < mesh.lods.size(); i++) {
+      ss << pprint::Indent(indent + 2) << "lod" << (i + 1) << " {\n";
+      ss << pprint::Indent(indent + 3) << "num_faceVertexIndices "
+         << std::to_string(mesh.lods[i].faceVertexIndices.size()) << "\n";
+      ss << pprint::Indent(indent + 3) << "error "
+         << std::to_string(mesh.lods[i].error) << "\n";
+      ss << pprint::Indent(indent + 2) << "}\n";
+    }
+    ss << pprint::Indent(indent + 1) << "}\n";
+  }
 
   // TODO: primvars
 
@@ -6876,6 +8186,43 @@ void DumpAnimChannel(std::stringstream &ss, const std::string &name, const std::
 
 } // namespace detail
 
+std::string DumpPointInstancer(const RenderPointInstancer &instancer,
+                               uint32_t indent) {
+  std::stringstream ss;
+
+  ss << pprint::Indent(indent) << "instancer {\n";
+
+  ss << pprint::Indent(indent + 1) << "name " << quote(instancer.prim_name)
+     << "\n";
+  ss << pprint::Indent(indent + 1) << "abs_path " << quote(instancer.abs_path)
+     << "\n";
+  ss << pprint::Indent(indent + 1) << "display_name "
+     << quote(instancer.display_name) << "\n";
+  ss << pprint::Indent(indent + 1) << "num_instances "
+     << instancer.num_instances << "\n";
+
+  for (const auto &proto : instancer.prototypes) {
+    ss << pprint::Indent(indent + 1) << "prototype {\n";
+    ss << pprint::Indent(indent + 2) << "abs_path " << quote(proto.abs_path)
+       << "\n";
+    ss << pprint::Indent(indent + 2) << "mesh_ids "
+       << quote(value::print_array_snipped(proto.mesh_ids)) << "\n";
+    ss << pprint::Indent(indent + 2) << "mesh_local_matrices "
+       << quote(value::print_array_snipped(proto.mesh_local_matrices))
+       << "\n";
+    ss << pprint::Indent(indent + 2) << "instance_indices "
+       << quote(value::print_array_snipped(proto.instance_indices)) << "\n";
+    ss << pprint::Indent(indent + 2) << "instance_transforms "
+       << quote(value::print_array_snipped(proto.instance_transforms))
+       << "\n";
+    ss << pprint::Indent(indent + 1) << "}\n";
+  }
+
+  ss << pprint::Indent(indent) << "}\n";
+
+  return ss.str();
+}
+
 std::string DumpAnimation(const Animation &anim, uint32_t indent) {
   std::stringstream ss;
 
@@ -7148,6 +8495,7 @@ std::string DumpRenderScene(const RenderScene &scene,
   ss << "// # of Meshes : " << scene.meshes.size() << "\n";
   ss << "// # of Skeletons : " << scene.skeletons.size() << "\n";
   ss << "// # of Animations : " << scene.animations.size() << "\n";
+  ss << "// # of PointInstancers : " << scene.instancers.size() << "\n";
   ss << "// # of Cameras : " << scene.cameras.size() << "\n";
   ss << "// # of Materials : " << scene.materials.size() << "\n";
   ss << "// # of UVTextures : " << scene.textures.size() << "\n";
@@ -7180,6 +8528,12 @@ std::string DumpRenderScene(const RenderScene &scene,
   }
   ss << "}\n";
 
+  ss << "instancers {\n";
+  for (size_t i = 0; i < scene.instancers.size(); i++) {
+    ss << "[" << i << "] " << DumpPointInstancer(scene.instancers[i], 1);
+  }
+  ss << "}\n";
+
   ss << "cameras {\n";
   for (size_t i = 0; i < scene.cameras.size(); i++) {
     ss << "[" << i << "] " << DumpCamera(scene.cameras[i], 1);
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <unordered_map>
 
 #include "asset-resolution.hh"
@@ -20,6 +21,10 @@
 // tydra
 #include "scene-access.hh"
 
+#if defined(TINYUSDZ_ENABLE_THREAD)
+#include <mutex>
+#endif
+
 namespace tinyusdz {
 
 // forward decl
@@ -144,6 +149,7 @@ enum class NodeType {
   PointLight,
   DirectionalLight,
   EnvmapLight, // DomeLight in USD
+  PointInstancer, // RenderPointInstancer
   // TODO(more lights)...
 };
 
@@ -810,6 +816,26 @@ struct MaterialSubset {
 
 };
 
+//
+// Simplified mesh of RenderMesh. Vertices are not modified in simplification,
+// so LOD shares `points` and vertex attributes with RenderMesh.
+//
+struct RenderMeshLOD {
+  // Triangle vertex indices. Index to RenderMesh::points.
+  std::vector<uint32_t> faceVertexIndices;
+
+  // Index to the triangle of RenderMesh::faceVertexIndices() for each
+  // triangle.
+  std::vector<uint32_t> faceRemap;
+
+  // Key = GeomSubset name(same with RenderMesh::material_subsetMap). Value =
+  // triangle indices of this LOD.
+  std::map<std::string, std::vector<int>> subsetIndices;
+
+  // Max geometric error from RenderMesh in the local space of the mesh.
+  float error{0.0f};
+};
+
 // Currently normals and texcoords are converted as facevarying attribute.
 struct RenderMesh {
 #if 0 // deprecated.
@@ -947,6 +973,10 @@ struct RenderMesh {
   std::map<std::string, MaterialSubset>
       material_subsetMap;  // GeomSubset whose famiyName is 'materialBind'
 
+  // Simplified meshes(LOD1, LOD2, ...) in descending order of the number of
+  // triangles. Filled when `MeshConverterConfig::num_lods` > 0.
+  std::vector<RenderMeshLOD> lods;
+
   // If you want to access user-defined primvars or custom property,
   // Plese look into corresponding Prim( stage::find_prim_at_path(abs_path) )
 
@@ -1186,6 +1216,48 @@ struct RenderLight
   // TODO..
 };
 
+//
+// Instances of a prototype of PointInstancer.
+//
+// The world matrix of j'th mesh of i'th instance is
+//
+//   mesh_local_matrices[j] * instance_transforms[i] * global_matrix of the
+//   PointInstancer Node
+//
+struct InstancePrototype {
+  std::string abs_path;  // Prototype Prim path(e.g. "/instancer/protos/tree")
+
+  // Meshes in the prototype subtree. Index to `meshes`.
+  std::vector<int32_t> mesh_ids;
+
+  // Transform of each mesh relative to the prototype(includes the xform of
+  // the prototype Prim itself). Same length with `mesh_ids`.
+  std::vector<value::matrix4d> mesh_local_matrices;
+
+  // Per-instance transform relative to the PointInstancer
+  // (= scale * orientation * translate(positions). row-major).
+  // Stored as a packed float array so that it can be uploaded to the GPU
+  // instance buffer as is.
+  std::vector<value::matrix4f> instance_transforms;
+
+  // Index to `protoIndices`(instance index in USD) of each instance.
+  std::vector<uint32_t> instance_indices;
+};
+
+// PointInstancer evaluated at specified timecode.
+// Instances are bucketed by prototype. Invisible instances(`invisibleIds`)
+// are not included.
+struct RenderPointInstancer {
+  std::string prim_name;  // elementName in USD
+  std::string abs_path;   // Absolute PointInstancer Prim path in USD
+  std::string display_name;
+
+  // Same order with the targets of `prototypes` relationship.
+  std::vector<InstancePrototype> prototypes;
+
+  uint64_t num_instances{0};  // Total number of visible instances.
+};
+
 struct SceneMetadata
 {
   std::string copyright;
@@ -1221,6 +1293,7 @@ class RenderScene {
   std::vector<RenderMesh> meshes;
   std::vector<Animation> animations;
   std::vector<SkelHierarchy> skeletons;
+  std::vector<RenderPointInstancer> instancers;
   std::vector<BufferData>
       buffers;  // Various data storage(e.g. texel/image data).
 
@@ -1305,6 +1378,16 @@ struct MeshConverterConfig {
   //
   bool build_vertex_indices{true};
 
+  //
+  // Tolerance to merge similar vertices in `build_vertex_indices`.
+  //
+  // 0 = Merge bitwise-identical vertices only.
+  // > 0 = Also merge vertices of the same point whose vertex attributes
+  // (normal, texcoords, colors, ...) are within this distance. Uses kd-tree
+  // search, so slower than the exact merge.
+  //
+  float build_vertex_indices_eps{0.0f};
+
   //
   // Compute normals if not present in the mesh.
   // The algorithm computes smoothed normal for shared vertex.
@@ -1330,6 +1413,29 @@ struct MeshConverterConfig {
   // ConvertMesh. Only effective to floating-point vertex data.
   //
   float facevarying_to_vertex_eps = std::numeric_limits<float>::epsilon();
+
+  //
+  // The number of LODs(Level of Detail) generated for each mesh with
+  // quadric-error edge collapse. Stored in RenderMesh::lods. 0 = disabled.
+  //
+  // Vertices on UV/normal seams, open borders and GeomSubset(material)
+  // boundaries are kept. LODs are only generated for triangle meshes whose
+  // vertex attributes are single-indexable(See `build_vertex_indices`).
+  //
+  uint32_t num_lods{0};
+
+  //
+  // Target number of triangles of LOD i(i = 1, 2, ...) is
+  // `lod_reduction_ratio^i` of the mesh.
+  //
+  float lod_reduction_ratio{0.5f};
+
+  //
+  // Max geometric error of LODs relative to the diagonal length of the mesh
+  // bounds. Simplification stops when no more edge can be collapsed under
+  // this error, so LOD may have more triangles than its target.
+  //
+  float lod_max_error{0.01f};
 };
 
 struct MaterialConverterConfig {
@@ -1395,6 +1501,11 @@ struct RenderSceneConverterConfig {
   // false: no actual texture file/asset access.
   // App/User must setup TextureImage manually after the conversion.
   bool load_texture_assets{true};
+
+  // The number of threads to convert meshes concurrently in
+  // ConvertToRenderScene. -1 = use # of system threads. Worker threads are
+  // only spawned when TinyUSDZ is built with `TINYUSDZ_ENABLE_THREAD`.
+  int num_threads{-1};
 };
 
 //
@@ -1427,23 +1538,37 @@ struct DefaultPackedVertexData {
   }
 };
 
-struct DefaultPackedVertexDataHasher {
-  inline size_t operator()(const DefaultPackedVertexData &v) const {
-    // Simple hasher using FNV1 32bit
-    // TODO: Use 64bit FNV1?
-    // TODO: Use spatial hash or LSH(LocallySensitiveHash) for position value.
-    static constexpr uint32_t kFNV_Prime = 0x01000193;
-    static constexpr uint32_t kFNV_Offset_Basis = 0x811c9dc5;
+//
+// Hash packed vertex data 4 bytes at a time(FNV1a over 32bit words +
+// murmur3 finalizer so that lower bits are usable as a hash table slot).
+// `n` must be a multiple of 4.
+//
+inline uint32_t HashPackedVertex(const void *data, const size_t n) {
+  static constexpr uint32_t kFNV_Prime = 0x01000193;
+  static constexpr uint32_t kFNV_Offset_Basis = 0x811c9dc5;
 
-    const uint8_t *ptr = reinterpret_cast<const uint8_t *>(&v);
-    size_t n = sizeof(DefaultPackedVertexData);
+  const uint8_t *ptr = reinterpret_cast<const uint8_t *>(data);
 
-    uint32_t hash = kFNV_Offset_Basis;
-    for (size_t i = 0; i < n; i++) {
-      hash = (kFNV_Prime * hash) ^ (ptr[i]);
-    }
+  uint32_t hash = kFNV_Offset_Basis;
+  for (size_t i = 0; (i + 4) <= n; i += 4) {
+    uint32_t w;
+    memcpy(&w, ptr + i, 4);
+    hash = (hash ^ w) * kFNV_Prime;
+  }
 
-    return size_t(hash);
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+
+  return hash;
+}
+
+struct DefaultPackedVertexDataHasher {
+  inline size_t operator()(const DefaultPackedVertexData &v) const {
+    // TODO: Use spatial hash or LSH(LocallySensitiveHash) for position value.
+    return size_t(HashPackedVertex(&v, sizeof(DefaultPackedVertexData)));
   }
 };
 
@@ -1540,42 +1665,133 @@ struct DefaultVertexOutput {
   }
 };
 
+///
+/// Find vertices which can be merged within `eps` tolerance using kd-tree.
+///
+/// Vertices are merged only when they have the same point index and the
+/// Euclidean distance of their attributes is less than `eps`.
+///
+/// @param[in] point_indices Point index of each vertex.
+/// @param[in] attribs Vertex attributes. `point_indices.size() * dim` floats.
+/// @param[in] dim The number of attribute floats per vertex.
+/// @param[in] eps Tolerance.
+/// @param[out] similar_vertices Index of the vertex each vertex is merged into.
+/// Always the first vertex(in input order) of the group, so
+/// `similar_vertices[i] <= i`.
+///
+/// @return false when the input is invalid.
+///
+bool FindSimilarVertices(const std::vector<uint32_t> &point_indices,
+                         const std::vector<float> &attribs, const size_t dim,
+                         const float eps,
+                         std::vector<uint32_t> *similar_vertices);
+
 //
 // out_vertex_indices_remap: corresponding vertexIndex in input.
 //
+// Identical vertices are found with a flat open-addressing hash table(linear
+// probing) sized up front, so no allocation happens per vertex.
+// Output vertices are ordered by their first appearance in the input.
+//
+// When `eps` > 0, vertices whose attributes are within `eps` are merged using
+// FindSimilarVertices. PackedVert must be `uint32_t point_index` followed by
+// float attributes in this case.
+//
 template <class VertexInput, class VertexOutput, class PackedVert,
           class PackedVertHasher, class PackedVertEqual>
 void BuildIndices(const VertexInput &input, VertexOutput &output,
-                  std::vector<uint32_t> &out_indices, std::vector<uint32_t> &out_point_indices)
+                  std::vector<uint32_t> &out_indices, std::vector<uint32_t> &out_point_indices,
+                  const float eps = 0.0f)
 {
-  // TODO: Use LSH(locally sensitive hashing) or BVH for kNN point query.
-  std::unordered_map<PackedVert, uint32_t, PackedVertHasher, PackedVertEqual>
-      vertexToIndexMap;
-
-  auto GetSimilarVertex = [&](const PackedVert &v, uint32_t &out_idx) -> bool {
-    auto it = vertexToIndexMap.find(v);
-    if (it == vertexToIndexMap.end()) {
-      return false;
+  const size_t n = input.size();
+
+  out_indices.reserve(out_indices.size() + n);
+  out_point_indices.reserve(out_point_indices.size() + n);
+
+  if (eps > 0.0f) {
+    constexpr size_t kDim =
+        (sizeof(PackedVert) - sizeof(uint32_t)) / sizeof(float);
+    static_assert(
+        sizeof(PackedVert) == (sizeof(uint32_t) + kDim * sizeof(float)),
+        "PackedVert must be uint32_t point_index followed by float "
+        "attributes.");
+
+    std::vector<PackedVert> verts(n);
+    std::vector<uint32_t> point_indices(n);
+    std::vector<float> attribs(n * kDim);
+    for (size_t i = 0; i < n; i++) {
+      input.get(i, verts[i]);
+      point_indices[i] = verts[i].point_index;
+      memcpy(&attribs[i * kDim],
+             reinterpret_cast<const uint8_t *>(&verts[i]) + sizeof(uint32_t),
+             kDim * sizeof(float));
+    }
+
+    std::vector<uint32_t> similar_vertices;
+    if (FindSimilarVertices(point_indices, attribs, kDim, eps,
+                            &similar_vertices)) {
+      // input vertex index -> output vertex index
+      std::vector<uint32_t> remap(n, ~0u);
+      for (size_t i = 0; i < n; i++) {
+        const uint32_t rep = similar_vertices[i];
+        if (rep == uint32_t(i)) {
+          remap[i] = uint32_t(output.size());
+          output.push_back(verts[i]);
+        }
+        out_indices.push_back(remap[rep]);
+        out_point_indices.push_back(verts[i].point_index);
+      }
+      return;
     }
 
-    out_idx = it->second;
-    return true;
+    // Fall back to the exact merge.
+  }
+
+  constexpr uint32_t kEmpty = ~0u;
+
+  struct Slot {
+    uint32_t hash;
+    uint32_t index;  // Index to `verts`. kEmpty = empty slot.
   };
 
-  for (size_t i = 0; i < input.size(); i++) {
+  // Load factor <= 0.5
+  size_t table_size = 16;
+  while (table_size < (2 * n)) {
+    table_size *= 2;
+  }
+  const size_t mask = table_size - 1;
+
+  std::vector<Slot> table(table_size, Slot{0, kEmpty});
+
+  // Unique vertices. verts[k] is output vertex `base + k`.
+  std::vector<PackedVert> verts;
+  const uint32_t base = uint32_t(output.size());
+
+  PackedVertHasher hasher;
+  PackedVertEqual equal;
+
+  for (size_t i = 0; i < n; i++) {
     PackedVert v;
     input.get(i, v);
 
-    uint32_t index{0};
-    bool found = GetSimilarVertex(v, index);
-    if (found) {
-      out_indices.push_back(index);
-    } else {
-      uint32_t new_index = uint32_t(output.size());
-      out_indices.push_back(new_index);
+    const uint32_t hash = uint32_t(hasher(v));
+
+    size_t slot = hash & mask;
+    while (table[slot].index != kEmpty) {
+      if ((table[slot].hash == hash) && equal(verts[table[slot].index], v)) {
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    if (table[slot].index == kEmpty) {
+      table[slot].hash = hash;
+      table[slot].index = uint32_t(verts.size());
+      verts.push_back(v);
       output.push_back(v);
-      vertexToIndexMap[v] = new_index;
     }
+
+    out_indices.push_back(base + table[slot].index);
     out_point_indices.push_back(v.point_index);
   }
 }
@@ -1604,6 +1820,61 @@ class RenderSceneConverterEnv {
 
 };
 
+//
+// Recorded when a GeomMesh whose only time-varying attribute is `points` is
+// reconverted in UpdateToTime. Following updates just gather `points`(and
+// recompute normals) instead of reconverting the whole mesh.
+//
+struct RenderMeshPointsCache {
+  bool valid{false};
+  size_t num_points{0};  // The number of `points` in GeomMesh.
+
+  // RenderMesh point index -> GeomMesh point index. empty = identity.
+  std::vector<uint32_t> point_remap;
+
+  // Topology to compute 'vertex' normals with(empty = normals are not
+  // computed).
+  std::vector<uint32_t> normals_faceVertexCounts;
+  std::vector<uint32_t> normals_faceVertexIndices;
+};
+
+//
+// GeomMesh and its bound Materials resolved in the conversion.
+// Used to reconvert a time-varying GeomMesh in UpdateToTime.
+//
+// NOTE: Holds pointers to Prims in Stage.
+//
+struct RenderMeshSource {
+  int32_t mesh_id{-1};  // Index to `meshes`
+  Path abs_path;
+  const GeomMesh *mesh{nullptr};
+  MaterialPath material_path;
+  std::map<std::string, MaterialPath> subset_material_path_map;
+  std::vector<const GeomSubset *> material_subsets;
+  std::vector<std::pair<std::string, const BlendShape *>> blendshapes;
+
+  RenderMeshPointsCache points_cache;
+};
+
+//
+// Contents of RenderScene updated by RenderSceneConverter::UpdateToTime.
+//
+struct RenderSceneDirtyList {
+  std::vector<std::string> nodes;   // abs_path of Nodes whose matrix changed.
+  std::vector<int32_t> meshes;      // Index to `meshes`(vertex data changed).
+  std::vector<int32_t> instancers;  // Index to `instancers`.
+
+  bool empty() const {
+    return nodes.empty() && meshes.empty() && instancers.empty();
+  }
+
+  void clear() {
+    nodes.clear();
+    meshes.clear();
+    instancers.clear();
+  }
+};
+
 //
 // Convert USD scenegraph at specified time
 // TODO: Use RenderSceneConverterEnv(RenderSceneConverterEnv::timecode)
@@ -1622,6 +1893,41 @@ class RenderSceneConverter {
   ///
   bool ConvertToRenderScene(const RenderSceneConverterEnv &env, RenderScene *scene);
 
+  ///
+  /// Incrementally update RenderScene converted by ConvertToRenderScene to
+  /// time `t`.
+  ///
+  /// Only time-varying xformOps, GeomMeshes(points, normals, primvars, ...)
+  /// and PointInstancers recorded in ConvertToRenderScene are re-evaluated.
+  /// Materials and textures are not updated. SkelAnimation is already
+  /// converted to timesampled Animation, so Skeletons are not updated.
+  ///
+  /// When only `points` of a GeomMesh is time-varying, the topology and the
+  /// point index mapping are cached at the first update, then only `points`
+  /// (and computed normals) are gathered. Meshes and Nodes whose values are
+  /// not changed are not reported in `dirty`.
+  ///
+  /// `env.stage` must be the Stage(unmodified) used in ConvertToRenderScene.
+  ///
+  /// @param[in] env
+  /// @param[in] t Timecode
+  /// @param[inout] scene RenderScene converted by ConvertToRenderScene.
+  /// @param[out] dirty Updated Nodes, meshes and instancers.
+  ///
+  /// @return true upon success.
+  ///
+  bool UpdateToTime(const RenderSceneConverterEnv &env, const double t,
+                    RenderScene *scene, RenderSceneDirtyList *dirty);
+
+  ///
+  /// @return true when the converted scene has time-varying content, i.e.
+  /// UpdateToTime has something to update.
+  ///
+  bool HasTimeVaryingContent() const {
+    return !_timevarying_xforms.empty() || !_timevarying_meshes.empty() ||
+           !_timevarying_instancers.empty();
+  }
+
   const std::string &GetInfo() const { return _info; }
   const std::string &GetWarning() const { return _warn; }
   const std::string &GetError() const { return _err; }
@@ -1639,6 +1945,7 @@ class RenderSceneConverter {
   StringAndIdMap imageMap;
   StringAndIdMap bufferMap;
   StringAndIdMap animationMap;
+  StringAndIdMap instancerMap;
 
   int default_node{-1};
 
@@ -1652,6 +1959,7 @@ class RenderSceneConverter {
   std::vector<BufferData> buffers;
   std::vector<SkelHierarchy> skeletons;
   std::vector<Animation> animations;
+  std::vector<RenderPointInstancer> instancers;
 
   ///
   /// Convert GeomMesh to renderer-friendly mesh.
@@ -1773,6 +2081,31 @@ class RenderSceneConverter {
                         const Path &abs_path, const SkelAnimation &skelAnim,
                         Animation *anim_out);
 
+  ///
+  /// Convert PointInstancer to RenderPointInstancer.
+  /// GeomMeshes in prototypes must be converted before calling this(meshes
+  /// are looked up from `meshMap`), so each prototype is converted only once
+  /// regardless of the number of instances.
+  ///
+  /// @param[in] env
+  /// @param[in] root Root XformNode of the Stage.
+  /// @param[in] abs_path USD Path to PointInstancer Prim
+  /// @param[in] instancer PointInstancer
+  /// @param[out] dst RenderPointInstancer
+  ///
+  bool ConvertPointInstancer(const RenderSceneConverterEnv &env,
+                             const XformNode &root, const Path &abs_path,
+                             const PointInstancer &instancer,
+                             RenderPointInstancer *dst);
+
+  ///
+  /// Evaluate instances of PointInstancer at `env.timecode` and fill
+  /// instance arrays of `dst->prototypes`(prototypes must be set up).
+  ///
+  bool EvaluatePointInstances(const RenderSceneConverterEnv &env,
+                              const PointInstancer &instancer,
+                              RenderPointInstancer *dst);
+
   ///
   /// @param[in] env
   /// @param[in] root XformNode
@@ -1811,7 +2144,13 @@ class RenderSceneConverter {
   ///
   /// @param[inout] mesh
   ///
-  bool BuildVertexIndicesImpl(RenderMesh &mesh);
+  bool BuildVertexIndicesImpl(RenderMesh &mesh, const float eps);
+
+  ///
+  /// Generate LODs of the mesh to `mesh.lods`. Mesh which is not
+  /// single-indexable or not a triangle mesh is skipped with a warning.
+  ///
+  bool GenerateLODsImpl(RenderMesh &mesh, const MeshConverterConfig &config);
 
   //
   // Get Skeleton assigned to the GeomMesh Prim and convert it to SkelHierarchy.
@@ -1826,6 +2165,14 @@ class RenderSceneConverter {
     const XformNode &node,
     Node &out_rnode);
 
+  ///
+  /// Add SkelHierarchy(and its Animation) converted by `worker` converter to
+  /// this converter, if the Skeleton of the same Prim path is not added yet.
+  ///
+  /// @return Index to `skeletons`.
+  ///
+  int MergeSkeleton(const RenderSceneConverter &worker, int worker_skel_id);
+
   void PushInfo(const std::string &msg) { _info += msg; }
   void PushWarn(const std::string &msg) { _warn += msg; }
   void PushError(const std::string &msg) { _err += msg; }
@@ -1833,6 +2180,30 @@ class RenderSceneConverter {
   std::string _info;
   std::string _err;
   std::string _warn;
+
+  // Time-varying contents recorded in ConvertToRenderScene for UpdateToTime.
+  // key = Prim path
+  std::map<std::string, const Prim *> _timevarying_xforms;
+  std::vector<RenderMeshSource> _timevarying_meshes;
+  // Index to `instancers` and PointInstancer Prim.
+  std::vector<std::pair<int32_t, const PointInstancer *>>
+      _timevarying_instancers;
+
+  // The number of threads to use inside ConvertMesh(e.g. normal computation
+  // of a large mesh).
+  int _mesh_num_threads{1};
+
+  // Used by UpdateToTime.
+  // Filled by ConvertMesh when not nullptr.
+  RenderMeshPointsCache *_points_cache{nullptr};
+  // Skeleton/SkelAnimation are not converted in ConvertMesh when false.
+  bool _convert_skeletons{true};
+
+#if defined(TINYUSDZ_ENABLE_THREAD)
+  // Skeleton/SkelAnimation Prims are shared among meshes, so their conversion
+  // is serialized when meshes are converted by worker converters in parallel.
+  std::mutex *_skel_mutex{nullptr};
+#endif
 };
 
 // For debug
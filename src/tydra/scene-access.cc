@@ -15,6 +15,7 @@
 #include "usdShade.hh"
 #include "usdSkel.hh"
 #include "value-pprint.hh"
+#include "xform.hh"
 
 // src/tydra
 #include "attribute-eval.hh"
@@ -42,7 +43,11 @@ value::TimeSamples ToTypelessTimeSamples(const TypedTimeSamples<T> &ts) {
   value::TimeSamples dst;
 
   for (size_t i = 0; i < samples.size(); i++) {
-    dst.add_sample(samples[i].t, samples[i].value);
+    if (samples[i].blocked) {
+      dst.add_blocked_sample(samples[i].t, samples[i].value);
+    } else {
+      dst.add_sample(samples[i].t, samples[i].value);
+    }
   }
 
   return dst;
@@ -60,7 +65,11 @@ value::TimeSamples EnumTimeSamplesToTypelessTimeSamples(
   for (size_t i = 0; i < samples.size(); i++) {
     // to token
     value::token tok(to_string(samples[i].value));
-    dst.add_sample(samples[i].t, tok);
+    if (samples[i].blocked) {
+      dst.add_blocked_sample(samples[i].t, tok);
+    } else {
+      dst.add_sample(samples[i].t, tok);
+    }
   }
 
   return dst;
@@ -641,7 +650,8 @@ bool ToProperty(const TypedAttributeWithFallback<Animatable<T>> &input,
     attr.set_connections(input.get_connections());
   }
 
-  {
+  // `has_value() == false` : declaration only(e.g. `float inputs:a`)
+  if (input.has_value()) {
     // Includes !authored()
     // FIXME: Currently scalar only.
     Animatable<T> v = input.get_value();
@@ -650,6 +660,10 @@ bool ToProperty(const TypedAttributeWithFallback<Animatable<T>> &input,
     DCOUT("has_timesamples " << v.has_timesamples());
     DCOUT("has_value " << v.has_value());
 
+    if (v.is_blocked()) {
+      attr.set_blocked(true);
+    }
+
     if (v.has_timesamples()) {
       value::TimeSamples ts = ToTypelessTimeSamples(v.get_timesamples());
       pvar.set_timesamples(ts);
@@ -669,7 +683,9 @@ bool ToProperty(const TypedAttributeWithFallback<Animatable<T>> &input,
       }
     }
 
-    attr.set_var(std::move(pvar));
+    if (v.has_value() || v.has_timesamples()) {
+      attr.set_var(std::move(pvar));
+    }
   }
 
   attr.metas() = input.metas();
@@ -953,6 +969,135 @@ nonstd::optional<Property> TypedTerminalAttributeToProperty(
   return output;
 }
 
+// Uniform attribute with fallback value.
+template <typename T>
+bool ToProperty(const TypedAttributeWithFallback<T> &input, Property &output,
+                std::string *err) {
+  (void)err;
+
+  Attribute attr;
+  attr.variability() = Variability::Uniform;
+  attr.set_type_name(value::TypeTraits<T>::type_name());
+
+  if (input.is_blocked()) {
+    attr.set_blocked(true);
+  } else if (input.has_value()) {
+    // Includes !authored()
+    primvar::PrimVar pvar;
+    pvar.set_value(value::Value(input.get_value()));
+    attr.set_var(std::move(pvar));
+  }
+
+  if (input.has_connections()) {
+    attr.set_connections(input.get_connections());
+  }
+
+  attr.metas() = input.metas();
+
+  output = Property(std::move(attr), /* custom */ false);
+
+  return true;
+}
+
+// Extent is authored as `float3[]`(lower, upper) in USD.
+bool ToProperty(const TypedAttribute<Animatable<Extent>> &input,
+                Property &output, std::string *err) {
+  (void)err;
+
+  Attribute attr;
+  attr.variability() = Variability::Varying;
+  attr.set_type_name(value::TypeTraits<Extent>::type_name());
+
+  if (input.is_blocked()) {
+    attr.set_blocked(true);
+  }
+
+  if (input.has_connections()) {
+    attr.set_connections(input.get_connections());
+  }
+
+  if (auto aval = input.get_value()) {
+    const Animatable<Extent> &v = aval.value();
+
+    primvar::PrimVar pvar;
+
+    if (v.is_blocked()) {
+      attr.set_blocked(true);
+    }
+
+    Extent ext;
+    if (v.has_value() && v.get_default(&ext)) {
+      std::vector<value::float3> a{ext.lower, ext.upper};
+      pvar.set_value(a);
+    }
+
+    if (v.has_timesamples()) {
+      value::TimeSamples ts;
+      for (const auto &sample : v.get_timesamples().get_samples()) {
+        std::vector<value::float3> a{sample.value.lower, sample.value.upper};
+        if (sample.blocked) {
+          ts.add_blocked_sample(sample.t, a);
+        } else {
+          ts.add_sample(sample.t, a);
+        }
+      }
+      pvar.set_timesamples(ts);
+    }
+
+    if (v.has_value() || v.has_timesamples()) {
+      attr.set_var(std::move(pvar));
+    }
+  }
+
+  attr.metas() = input.metas();
+
+  output = Property(std::move(attr), /* custom */ false);
+
+  return true;
+}
+
+// Connection-only attribute(e.g. `token outputs:surface.connect`)
+template <typename T>
+bool ToProperty(const TypedConnection<T> &input, Property &output,
+                std::string *err) {
+  (void)err;
+
+  Attribute attr;
+  attr.variability() = Variability::Varying;
+  attr.set_type_name(value::TypeTraits<T>::type_name());
+
+  if (input.is_blocked()) {
+    attr.set_blocked(true);
+  }
+
+  if (input.has_value()) {
+    attr.set_connections(input.get_connections());
+  }
+
+  attr.metas() = input.metas();
+
+  output = Property(std::move(attr), /* custom */ false);
+
+  return true;
+}
+
+template <typename T>
+bool ToProperty(const TypedTerminalAttribute<T> &input, Property &output,
+                std::string *err) {
+  auto pv = TypedTerminalAttributeToProperty(input);
+  if (!pv) {
+    if (err) {
+      (*err) += "[InternalError] TypedTerminalAttribute is not authored.";
+    }
+    return false;
+  }
+
+  output = std::move(pv.value());
+  output.attribute().metas() = input.metas();
+
+  return true;
+}
+
 bool XformOpToProperty(const XformOp &x, Property &prop) {
   primvar::PrimVar pv;
 
@@ -981,6 +1126,11 @@ bool XformOpToProperty(const XformOp &x, Property &prop) {
   }
 
   attr.set_var(std::move(pv));
+  if (x.is_blocked()) {
+    attr.set_blocked(true);
+  } else {
+    attr.set_type_name(x.get_value_type_name());
+  }
   // TODO: attribute meta
 
   prop = Property(attr, /* custom */ false);
@@ -2228,221 +2378,1233 @@ std::string DumpXformNode(const XformNode &node) {
   return DumpXformNodeRec(node, 0);
 }
 
-template <typename T>
-bool PrimToPrimSpecImpl(const T &p, PrimSpec &ps, std::string *err);
-
-template <>
-bool PrimToPrimSpecImpl(const Model &p, PrimSpec &ps, std::string *err) {
-  (void)err;
-
-  ps.name() = p.name;
-  ps.specifier() = p.spec;
 
-  ps.props() = p.props;
-  ps.metas() = p.meta;
+bool XformCache::EvaluateLocalMatrix(
+    const Entry &entry, const double t,
+    const tinyusdz::value::TimeSampleInterpolationType tinterp,
+    value::matrix4d *m, bool *resetXformStack, std::string *err) const {
+  const Xformable *xformable{nullptr};
+  if (!CastToXformable(*entry.prim, &xformable) || !xformable) {
+    (*m) = value::matrix4d::identity();
+    (*resetXformStack) = false;
+    return true;
+  }
 
-  // TODO: variantSet
-  // ps.variantSets
+  // NOTE: Do not use Xformable::GetLocalMatrix, which mutates the matrix
+  // cached in the Prim.
+  std::string local_err;
+  if (!xformable->EvaluateXformOps(t, tinterp, m, resetXformStack,
+                                   &local_err)) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Failed to evaluate xformOps of {}: {}",
+                                      entry.abs_path, local_err));
+  }
 
   return true;
 }
 
-template <>
-bool PrimToPrimSpecImpl(const Xform &p, PrimSpec &ps, std::string *err) {
-  (void)err;
+bool XformCache::BuildRec(const Prim &prim, const std::string &parent_abs_path,
+                          const int64_t parent, std::string *err) {
+  const size_t idx = _entries.size();
 
-  ps.name() = p.name;
-  ps.specifier() = p.spec;
+  {
+    Entry entry;
+    entry.prim = &prim;
+    entry.abs_path = parent_abs_path + "/" + prim.element_name();
+    entry.parent = parent;
+    entry.has_xform = IsXformablePrim(prim);
+
+    if (entry.has_xform) {
+      const Xformable *xformable{nullptr};
+      if (CastToXformable(prim, &xformable) && xformable) {
+        entry.time_varying = xformable->is_time_varying();
+      }
 
-  ps.props() = p.props;
+      if (!EvaluateLocalMatrix(entry, _t, _tinterp, &entry.local_matrix,
+                               &entry.has_resetXformStack, err)) {
+        return false;
+      }
+    }
 
-  // TODO..
-  std::vector<value::token> toks;
-  Attribute xformOpOrderAttr;
-  xformOpOrderAttr.set_value(toks);
-  ps.props().emplace("xformOpOrder",
-                     Property(xformOpOrderAttr, /* custom */ false));
+    const Entry *parent_entry =
+        (parent < 0) ? nullptr : &_entries[size_t(parent)];
+    const value::matrix4d parent_world =
+        parent_entry ? parent_entry->world_matrix
+                     : value::matrix4d::identity();
 
-  ps.metas() = p.meta;
+    if (entry.has_resetXformStack) {
+      entry.world_matrix = entry.local_matrix;
+    } else {
+      // matrix is row-major, so local first
+      entry.world_matrix = entry.local_matrix * parent_world;
+    }
 
-  // TODO: variantSet
-  // ps.variantSets
+    entry.dynamic =
+        entry.time_varying || (parent_entry && parent_entry->dynamic &&
+                               !entry.has_resetXformStack);
 
-  return true;
-}
+    if (entry.dynamic) {
+      _dynamic_entries.push_back(idx);
+    }
 
-bool PrimToPrimSpec(const Prim &prim, PrimSpec &ps, std::string *err) {
-#define TO_PRIMSPEC(__ty)                                   \
-  if (prim.as<__ty>()) {                                    \
-    return PrimToPrimSpecImpl(*(prim.as<__ty>()), ps, err); \
-  } else
+    _path_to_entry[entry.abs_path] = idx;
+    _entries.emplace_back(std::move(entry));
+  }
 
-  TO_PRIMSPEC(Model) {
-    if (err) {
-      (*err) +=
-          "Unsupported/unimplemented Prim type: " + prim.prim_type_name() +
-          "\n";
+  // Take a copy since `_entries` may be reallocated.
+  const std::string abs_path = _entries[idx].abs_path;
+
+  for (const auto &child : prim.children()) {
+    if (!BuildRec(child, abs_path, int64_t(idx), err)) {
+      return false;
     }
-    return false;
   }
 
-#undef TO_PRIMSPEC
+  _entries[idx].subtree_end = _entries.size();
+
+  return true;
 }
 
-bool ShaderToPrimSpec(const UsdTransform2d &node, PrimSpec &ps,
-                      std::string *warn, std::string *err) {
-  (void)warn;
+bool XformCache::Build(const tinyusdz::Stage &stage, const double t,
+                       const tinyusdz::value::TimeSampleInterpolationType tinterp,
+                       std::string *err) {
+  _entries.clear();
+  _path_to_entry.clear();
+  _dynamic_entries.clear();
+  _updated_paths.clear();
+  _local_matrix_cache.clear();
+  _cached_times.clear();
+  _t = t;
+  _tinterp = tinterp;
 
-#define TO_PROPERTY(__prop_name, __v)                                    \
-  {                                                                      \
-    Property prop;                                                       \
-    if (!ToProperty(__v, prop, err)) {                                   \
-      PUSH_ERROR_AND_RETURN(                                             \
-          fmt::format("Convert {} to Property failed.\n", __prop_name)); \
-    }                                                                    \
-    ps.props()[__prop_name] = prop;                                      \
+  for (const auto &root : stage.root_prims()) {
+    if (!BuildRec(root, /* parent_abs_path */ "", /* parent */ -1, err)) {
+      return false;
+    }
   }
 
-  // inputs
-  TO_PROPERTY("inputs:in", node.in)
-  TO_PROPERTY("inputs:rotation", node.rotation)
-  TO_PROPERTY("inputs:scale", node.scale)
-  TO_PROPERTY("inputs:translation", node.translation)
+  _changed.assign(_entries.size(), 0);
 
-  // outputs
-  if (auto pv = TypedTerminalAttributeToProperty(node.result)) {
-    ps.props()["outputs:result"] = pv.value();
+  StoreLocalMatrices();
+
+  return true;
+}
+
+void XformCache::SetMaxCachedTimeCodes(const size_t n) {
+  _max_cached_times = n;
+
+  while (_cached_times.size() > _max_cached_times) {
+    _local_matrix_cache.erase(_cached_times.front());
+    _cached_times.pop_front();
   }
+}
 
-  for (auto prop : node.props) {
-    ps.props()[prop.first] = prop.second;
+void XformCache::StoreLocalMatrices() {
+  // TimeCode::Default() is not cached.
+  if ((_max_cached_times == 0) || value::TimeCode(_t).is_default() ||
+      _local_matrix_cache.count(_t)) {
+    return;
   }
 
-  ps.props()[kInfoId] =
-      Property(Attribute::Uniform(value::token(kUsdTransform2d)));
-  ps.metas() = node.metas();
-  ps.name() = node.name;
-  ps.specifier() = node.spec;
+  while (_cached_times.size() >= _max_cached_times) {
+    _local_matrix_cache.erase(_cached_times.front());
+    _cached_times.pop_front();
+  }
 
-  return true;
+  std::vector<value::matrix4d> &matrices = _local_matrix_cache[_t];
+  for (const size_t idx : _dynamic_entries) {
+    if (_entries[idx].time_varying) {
+      matrices.push_back(_entries[idx].local_matrix);
+    }
+  }
+  _cached_times.push_back(_t);
 }
 
-std::vector<const GeomSubset *> GetGeomSubsets(
-    const tinyusdz::Stage &stage, const tinyusdz::Path &prim_path,
-    const tinyusdz::value::token &familyName, bool prim_must_be_geommesh) {
-  std::vector<const GeomSubset *> result;
+bool XformCache::SetTime(
+    const double t, const tinyusdz::value::TimeSampleInterpolationType tinterp,
+    std::string *err) {
+  _updated_paths.clear();
 
-  const Prim *pprim{nullptr};
-  if (!stage.find_prim_at_path(prim_path, pprim)) {
-    return result;
+  const bool same_time =
+      (value::TimeCode(t).is_default() && value::TimeCode(_t).is_default()) ||
+      (t == _t);
+  if (same_time && (tinterp == _tinterp)) {
+    return true;
   }
 
-  if (!pprim) {
-    return result;
+  if (tinterp != _tinterp) {
+    // Cached matrices are evaluated with the other interpolation type.
+    _local_matrix_cache.clear();
+    _cached_times.clear();
   }
 
-  if (prim_must_be_geommesh && !pprim->is<GeomMesh>()) {
-    return result;
+  _t = t;
+  _tinterp = tinterp;
+
+  const std::vector<value::matrix4d> *cached{nullptr};
+  if (!value::TimeCode(t).is_default()) {
+    const auto it = _local_matrix_cache.find(t);
+    if (it != _local_matrix_cache.end()) {
+      cached = &it->second;
+    }
   }
+  size_t num_time_varying = 0;
 
-  // Only account for child Prims.
-  for (const auto &p : pprim->children()) {
-    if (auto pv = p.as<GeomSubset>()) {
-      if (familyName.valid()) {
-        if (pv->familyName.authored()) {
-          if (pv->familyName.get_value().has_value()) {
-            const value::token &tok = pv->familyName.get_value().value();
-            if (familyName.str() == tok.str()) {
-              result.push_back(pv);
-            }
-          } else {
-            // connection attr or value block?
-            // skip adding this GeomSubset.
-          }
-        } else {
-          result.push_back(pv);
-        }
+  // Parents precede their children in `_dynamic_entries`, and world matrices
+  // of non-dynamic entries never change.
+  for (const size_t idx : _dynamic_entries) {
+    Entry &entry = _entries[idx];
+    bool changed = false;
+
+    if (entry.time_varying) {
+      value::matrix4d m;
+      if (cached) {
+        m = (*cached)[num_time_varying++];
       } else {
-        result.push_back(pv);
+        bool resetXformStack{false};
+        if (!EvaluateLocalMatrix(entry, t, tinterp, &m, &resetXformStack,
+                                 err)) {
+          return false;
+        }
       }
-    }
-  }
 
-  return result;
-}
+      if (!is_close(m, entry.local_matrix, /* exact */ 0.0)) {
+        entry.local_matrix = m;
+        changed = true;
+      }
+    }
 
-std::vector<const GeomSubset *> GetGeomSubsetChildren(
-    const tinyusdz::Prim &prim, const tinyusdz::value::token &familyName,
-    bool prim_must_be_geommesh) {
-  std::vector<const GeomSubset *> result;
+    const bool parent_changed =
+        (entry.parent >= 0) && _changed[size_t(entry.parent)];
+    if (parent_changed && !entry.has_resetXformStack) {
+      changed = true;
+    }
 
-  if (prim_must_be_geommesh && !prim.is<GeomMesh>()) {
-    return result;
-  }
+    if (changed) {
+      value::matrix4d world;
+      if (entry.has_resetXformStack || (entry.parent < 0)) {
+        world = entry.local_matrix;
+      } else {
+        world = entry.local_matrix * _entries[size_t(entry.parent)].world_matrix;
+      }
 
-  // Only account for child Prims.
-  for (const auto &p : prim.children()) {
-    if (auto pv = p.as<GeomSubset>()) {
-      if (familyName.valid()) {
-        if (pv->familyName.authored()) {
-          if (pv->familyName.get_value().has_value()) {
-            const value::token &tok = pv->familyName.get_value().value();
-            if (familyName.str() == tok.str()) {
-              result.push_back(pv);
-            }
-          } else {
-            // connection attr or value block?
-            // skip adding this GeomSubset.
-          }
-        } else {
-          result.push_back(pv);
-        }
+      if (is_close(world, entry.world_matrix, /* exact */ 0.0)) {
+        changed = false;
       } else {
-        result.push_back(pv);
+        entry.world_matrix = world;
+        _updated_paths.push_back(entry.abs_path);
       }
     }
+
+    _changed[idx] = changed ? 1 : 0;
   }
 
-  return result;
+  if (!cached) {
+    StoreLocalMatrices();
+  }
+
+  return true;
 }
 
-#if 0
-bool ShaderToPrimSpec(const UsdUVTexture &node, PrimSpec &ps, std::string *warn, std::string *err)
-{
-  (void)warn;
+bool XformCache::GetLocalMatrix(const std::string &abs_path,
+                                value::matrix4d *m,
+                                bool *resetXformStack) const {
+  const auto it = _path_to_entry.find(abs_path);
+  if ((it == _path_to_entry.end()) || !m) {
+    return false;
+  }
 
-#define TO_PROPERTY(__prop_name, __v)                                    \
-  {                                                                      \
-    Property prop;                                                       \
-    if (!ToProperty(__v, prop, err)) {                                   \
-      PUSH_ERROR_AND_RETURN(                                             \
-          fmt::format("Convert {} to Property failed.\n", __prop_name)); \
-    }                                                                    \
-    ps.props()[__prop_name] = prop;                                      \
+  const Entry &entry = _entries[it->second];
+  (*m) = entry.local_matrix;
+  if (resetXformStack) {
+    (*resetXformStack) = entry.has_resetXformStack;
   }
 
-  // inputs
-  TO_PROPERTY("inputs:in", node.in)
-  TO_PROPERTY("inputs:rotation", node.rotation)
-  TO_PROPERTY("inputs:scale", node.scale)
-  TO_PROPERTY("inputs:translation", node.translation)
+  return true;
+}
 
-  // outputs
-  if (auto pv = TypedTerminalAttributeToProperty(node.result)) {
-    ps.props()["outputs:result"] = pv.value();
+bool XformCache::GetWorldMatrix(const std::string &abs_path,
+                                value::matrix4d *m) const {
+  const auto it = _path_to_entry.find(abs_path);
+  if ((it == _path_to_entry.end()) || !m) {
+    return false;
   }
 
-  for (auto prop : node.props) {
-    ps.props()[prop.first] = prop.second;
-  }
+  (*m) = _entries[it->second].world_matrix;
+
+  return true;
+}
+
+bool XformCache::IsTimeVarying(const std::string &abs_path) const {
+  const auto it = _path_to_entry.find(abs_path);
+  if (it == _path_to_entry.end()) {
+    return false;
+  }
+
+  return _entries[it->second].dynamic;
+}
+
+void XformCache::BuildXformNodeRec(const size_t idx,
+                                   const Path &parent_abs_path,
+                                   const value::matrix4d &parent_world,
+                                   XformNode *node) const {
+  const Entry &entry = _entries[idx];
+
+  node->element_name = entry.prim->element_name();
+  node->absolute_path = parent_abs_path.AppendPrim(node->element_name);
+  node->prim_id = entry.prim->prim_id();
+  node->prim = entry.prim;
+  node->has_xform() = entry.has_xform;
+  node->has_resetXformStack() = entry.has_resetXformStack;
+  node->set_parent_world_matrix(parent_world);
+  node->set_local_matrix(entry.local_matrix);
+  node->set_world_matrix(entry.world_matrix);
+
+  size_t child = idx + 1;
+  while (child < entry.subtree_end) {
+    XformNode child_node;
+    BuildXformNodeRec(child, node->absolute_path, entry.world_matrix,
+                      &child_node);
+    child_node.parent = node;
+    node->children.emplace_back(std::move(child_node));
+
+    child = _entries[child].subtree_end;
+  }
+}
+
+bool XformCache::BuildXformNode(XformNode *root) const {
+  if (!root) {
+    return false;
+  }
+
+  XformNode stage_root;
+  stage_root.element_name = "";  // Stage root element name is empty.
+  stage_root.absolute_path = Path("/", "");
+  stage_root.has_xform() = false;
+  stage_root.parent = nullptr;
+  stage_root.prim = nullptr;  // No prim for stage root.
+  stage_root.prim_id = -1;
+  stage_root.has_resetXformStack() = false;
+
+  size_t idx = 0;
+  while (idx < _entries.size()) {
+    XformNode node;
+    BuildXformNodeRec(idx, stage_root.absolute_path,
+                      value::matrix4d::identity(), &node);
+    stage_root.children.emplace_back(std::move(node));
+
+    idx = _entries[idx].subtree_end;
+  }
+
+  (*root) = std::move(stage_root);
+
+  return true;
+}
+
+namespace {
+
+//
+// Helpers to convert schema properties of concrete Prim to PrimSpec
+// properties. Only authored properties are emitted.
+//
+
+#define PS_PROPERTY(__prop_name, __v)                                      \
+  if ((__v).authored()) {                                                  \
+    Property prop;                                                         \
+    if (!ToProperty(__v, prop, err)) {                                     \
+      PUSH_ERROR_AND_RETURN(                                               \
+          fmt::format("Convert {} to Property failed.\n", __prop_name));   \
+    }                                                                      \
+    ps.props()[__prop_name] = std::move(prop);                             \
+  }
+
+#define PS_TOKEN_PROPERTY(__prop_name, __v)                                \
+  if ((__v).authored()) {                                                  \
+    Property prop;                                                         \
+    if (!ToTokenProperty(__v, prop, err)) {                                \
+      PUSH_ERROR_AND_RETURN(                                               \
+          fmt::format("Convert {} to Property failed.\n", __prop_name));   \
+    }                                                                      \
+    ps.props()[__prop_name] = std::move(prop);                             \
+  }
+
+#define PS_RELATIONSHIP(__prop_name, __v)                                  \
+  if (__v) {                                                               \
+    ps.props()[__prop_name] = Property((__v).value(), /* custom */ false); \
+  }
+
+void RelationshipToPrimSpec(const std::string &name,
+                            const RelationshipProperty &rel, PrimSpec &ps) {
+  if (rel.authored()) {
+    ps.props()[name] = Property(rel.relationship(), /* custom */ false);
+  }
+}
+
+bool XformOpsToPrimSpec(const std::vector<XformOp> &xformOps, PrimSpec &ps,
+                        std::string *err) {
+  if (xformOps.empty()) {
+    return true;
+  }
+
+  std::vector<value::token> xformOpOrder;
+
+  for (const auto &xformOp : xformOps) {
+    std::string varname = to_string(xformOp.op_type);
+    if (!xformOp.suffix.empty()) {
+      varname += ":" + xformOp.suffix;
+    }
+
+    xformOpOrder.push_back(
+        value::token(xformOp.inverted ? "!invert!" + varname : varname));
+
+    if (xformOp.op_type == XformOp::OpType::ResetXformStack) {
+      // No attribute for `!resetXformStack!`
+      continue;
+    }
+
+    if (ps.props().count(varname)) {
+      // Inverted op refers the same attribute.
+      continue;
+    }
+
+    Property prop;
+    if (!XformOpToProperty(xformOp, prop)) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Convert {} to Property failed.\n", varname));
+    }
+    ps.props()[varname] = std::move(prop);
+  }
+
+  Attribute xformOpOrderAttr;
+  xformOpOrderAttr.set_value(xformOpOrder);
+  xformOpOrderAttr.variability() = Variability::Uniform;
+  ps.props()["xformOpOrder"] =
+      Property(std::move(xformOpOrderAttr), /* custom */ false);
+
+  return true;
+}
+
+bool MaterialBindingToPrimSpec(const MaterialBinding &mb, PrimSpec &ps) {
+  PS_RELATIONSHIP(kMaterialBinding, mb.materialBinding)
+  PS_RELATIONSHIP(kMaterialBindingPreview, mb.materialBindingPreview)
+  PS_RELATIONSHIP(kMaterialBindingFull, mb.materialBindingFull)
+
+  for (const auto &matb : mb.materialBindingMap()) {
+    if (matb.first.empty()) {
+      continue;
+    }
+
+    ps.props()[kMaterialBinding + std::string(":") + matb.first] =
+        Property(matb.second, /* custom */ false);
+  }
+
+  for (const auto &collection : mb.materialBindingCollectionMap()) {
+    std::string purpose_name;
+    if (!collection.first.empty()) {
+      purpose_name = std::string(":") + collection.first;
+    }
+
+    for (size_t i = 0; i < collection.second.size(); i++) {
+      const std::string &coll_name = collection.second.keys()[i];
+
+      const Relationship *rel{nullptr};
+      if (!collection.second.at(i, &rel)) {
+        continue;
+      }
+
+      std::string rel_name;
+      if (coll_name.empty()) {
+        rel_name = kMaterialBindingCollection + purpose_name;
+      } else {
+        rel_name = kMaterialBindingCollection + std::string(":") + coll_name +
+                   purpose_name;
+      }
+
+      ps.props()[rel_name] = Property(*rel, /* custom */ false);
+    }
+  }
+
+  return true;
+}
+
+bool CollectionToPrimSpec(const Collection &coll, PrimSpec &ps,
+                          std::string *err) {
+  const auto &instances = coll.instances();
+
+  for (size_t i = 0; i < instances.size(); i++) {
+    const std::string &name = instances.keys()[i];
+
+    CollectionInstance instance;
+    if (!instances.at(i, &instance)) {
+      continue;
+    }
+
+    std::string prefix = "collection";
+    if (name.size()) {
+      prefix += ":" + name;
+    }
+
+    PS_TOKEN_PROPERTY(prefix + ":expansionRule", instance.expansionRule)
+    PS_PROPERTY(prefix + ":includeRoot", instance.includeRoot)
+    PS_RELATIONSHIP(prefix + ":includes", instance.includes)
+    PS_RELATIONSHIP(prefix + ":excludes", instance.excludes)
+  }
+
+  return true;
+}
+
+// Common part of GPrim and GPrim-derived Prims.
+bool GPrimToPrimSpec(const GPrim &gprim, PrimSpec &ps, std::string *err) {
+  PS_PROPERTY("doubleSided", gprim.doubleSided)
+  PS_TOKEN_PROPERTY("orientation", gprim.orientation)
+  PS_TOKEN_PROPERTY("purpose", gprim.purpose)
+  PS_PROPERTY("extent", gprim.extent)
+  PS_TOKEN_PROPERTY("visibility", gprim.visibility)
+
+  if (!MaterialBindingToPrimSpec(gprim, ps)) {
+    return false;
+  }
+
+  if (!CollectionToPrimSpec(gprim, ps, err)) {
+    return false;
+  }
+
+  RelationshipToPrimSpec("proxyPrim", gprim.proxyPrim, ps);
+
+  return XformOpsToPrimSpec(gprim.xformOps, ps, err);
+}
+
+// Common part of UsdLux lights.
+template <typename T>
+bool LightToPrimSpec(const T &light, PrimSpec &ps, std::string *err) {
+  PS_PROPERTY("inputs:color", light.color)
+  PS_PROPERTY("inputs:colorTemperature", light.colorTemperature)
+  PS_PROPERTY("inputs:diffuse", light.diffuse)
+  PS_PROPERTY("inputs:enableColorTemperature", light.enableColorTemperature)
+  PS_PROPERTY("inputs:exposure", light.exposure)
+  PS_PROPERTY("inputs:intensity", light.intensity)
+  PS_PROPERTY("inputs:normalize", light.normalize)
+  PS_PROPERTY("inputs:specular", light.specular)
+  PS_TOKEN_PROPERTY("visibility", light.visibility)
+  PS_TOKEN_PROPERTY("purpose", light.purpose)
+
+  if (!CollectionToPrimSpec(light, ps, err)) {
+    return false;
+  }
+
+  return XformOpsToPrimSpec(light.xformOps, ps, err);
+}
+
+template <typename T>
+bool ShaderParamsToPrimSpec(const UsdPrimvarReader<T> &node, PrimSpec &ps,
+                            std::string *err) {
+  PS_PROPERTY("inputs:fallback", node.fallback)
+  PS_PROPERTY("inputs:varname", node.varname)
+  PS_PROPERTY("outputs:result", node.result)
+
+  return true;
+}
+
+bool ShaderParamsToPrimSpec(const UsdTransform2d &node, PrimSpec &ps,
+                            std::string *err) {
+  PS_PROPERTY("inputs:in", node.in)
+  PS_PROPERTY("inputs:rotation", node.rotation)
+  PS_PROPERTY("inputs:scale", node.scale)
+  PS_PROPERTY("inputs:translation", node.translation)
+  PS_PROPERTY("outputs:result", node.result)
+
+  return true;
+}
+
+bool ShaderParamsToPrimSpec(const UsdUVTexture &node, PrimSpec &ps,
+                            std::string *err) {
+  PS_PROPERTY("inputs:file", node.file)
+  PS_PROPERTY("inputs:st", node.st)
+  PS_TOKEN_PROPERTY("inputs:wrapS", node.wrapS)
+  PS_TOKEN_PROPERTY("inputs:wrapT", node.wrapT)
+  PS_PROPERTY("inputs:fallback", node.fallback)
+  PS_TOKEN_PROPERTY("inputs:sourceColorSpace", node.sourceColorSpace)
+  PS_PROPERTY("inputs:scale", node.scale)
+  PS_PROPERTY("inputs:bias", node.bias)
+  PS_PROPERTY("outputs:r", node.outputsR)
+  PS_PROPERTY("outputs:g", node.outputsG)
+  PS_PROPERTY("outputs:b", node.outputsB)
+  PS_PROPERTY("outputs:a", node.outputsA)
+  PS_PROPERTY("outputs:rgb", node.outputsRGB)
+
+  return true;
+}
+
+bool ShaderParamsToPrimSpec(const UsdPreviewSurface &node, PrimSpec &ps,
+                            std::string *err) {
+  PS_PROPERTY("inputs:diffuseColor", node.diffuseColor)
+  PS_PROPERTY("inputs:emissiveColor", node.emissiveColor)
+  PS_PROPERTY("inputs:useSpecularWorkflow", node.useSpecularWorkflow)
+  PS_PROPERTY("inputs:specularColor", node.specularColor)
+  PS_PROPERTY("inputs:metallic", node.metallic)
+  PS_PROPERTY("inputs:clearcoat", node.clearcoat)
+  PS_PROPERTY("inputs:clearcoatRoughness", node.clearcoatRoughness)
+  PS_PROPERTY("inputs:roughness", node.roughness)
+  PS_PROPERTY("inputs:opacity", node.opacity)
+  PS_PROPERTY("inputs:opacityThreshold", node.opacityThreshold)
+  PS_PROPERTY("inputs:ior", node.ior)
+  PS_PROPERTY("inputs:normal", node.normal)
+  PS_PROPERTY("inputs:displacement", node.displacement)
+  PS_PROPERTY("inputs:occlusion", node.occlusion)
+  PS_PROPERTY("outputs:surface", node.outputsSurface)
+  PS_PROPERTY("outputs:displacement", node.outputsDisplacement)
+
+  return true;
+}
+
+bool ShaderParamsToPrimSpec(const ShaderNode &node, PrimSpec &ps,
+                            std::string *err) {
+  // Generic ShaderNode has no predefined parameters.
+  (void)node;
+  (void)ps;
+  (void)err;
+
+  return true;
+}
+
+template <typename T>
+bool ShaderNodeToPrimSpec(const T &node, const std::string &info_id,
+                          PrimSpec &ps, std::string *err) {
+  ps.props() = node.props;
+
+  if (!ShaderParamsToPrimSpec(node, ps, err)) {
+    return false;
+  }
+
+  if (info_id.size()) {
+    ps.props()[kInfoId] =
+        Property(Attribute::Uniform(value::token(info_id)), /* custom */ false);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+//
+// Name, specifier, typeName, Prim metas and custom properties are common to
+// all concrete Prims. Schema properties are handled by each PrimToPrimSpecImpl.
+//
+template <typename T>
+void PrimToPrimSpecCommon(const T &p, PrimSpec &ps) {
+  ps.name() = p.name;
+  ps.specifier() = p.spec;
+  ps.typeName() = value::TypeTraits<T>::type_name();
+  ps.metas() = p.meta;
+  ps.props() = p.props;
+}
+
+template <typename T>
+bool PrimToPrimSpecImpl(const T &p, PrimSpec &ps, std::string *err);
+
+template <>
+bool PrimToPrimSpecImpl(const Model &p, PrimSpec &ps, std::string *err) {
+  (void)err;
+
+  PrimToPrimSpecCommon(p, ps);
+  // Model is a typeless Prim or a Prim with unknown type.
+  ps.typeName() = p.prim_type_name;
+
+  return true;
+}
+
+template <>
+bool PrimToPrimSpecImpl(const Scope &p, PrimSpec &ps, std::string *err) {
+  (void)err;
+
+  PrimToPrimSpecCommon(p, ps);
+
+  return true;
+}
+
+template <>
+bool PrimToPrimSpecImpl(const Xform &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomMesh &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("points", p.points)
+  PS_PROPERTY("normals", p.normals)
+  PS_PROPERTY("faceVertexIndices", p.faceVertexIndices)
+  PS_PROPERTY("faceVertexCounts", p.faceVertexCounts)
+
+  PS_RELATIONSHIP("skel:skeleton", p.skeleton)
+  PS_PROPERTY("skel:blendShapes", p.blendShapes)
+  PS_RELATIONSHIP("skel:blendShapeTargets", p.blendShapeTargets)
+
+  for (const auto &item : p.subsetFamilyTypeMap) {
+    std::string attr_name = "subsetFamily:" + item.first.str() + ":familyType";
+    ps.props()[attr_name] =
+        Property(Attribute::Uniform(value::token(to_string(item.second))),
+                 /* custom */ false);
+  }
+
+  // subdiv
+  PS_PROPERTY("cornerIndices", p.cornerIndices)
+  PS_PROPERTY("cornerSharpnesses", p.cornerSharpnesses)
+  PS_PROPERTY("creaseIndices", p.creaseIndices)
+  PS_PROPERTY("creaseLengths", p.creaseLengths)
+  PS_PROPERTY("creaseSharpnesses", p.creaseSharpnesses)
+  PS_PROPERTY("holeIndices", p.holeIndices)
+  PS_TOKEN_PROPERTY("subdivisionScheme", p.subdivisionScheme)
+  PS_TOKEN_PROPERTY("interpolateBoundary", p.interpolateBoundary)
+  PS_TOKEN_PROPERTY("faceVaryingLinearInterpolation",
+                    p.faceVaryingLinearInterpolation)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomSubset &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_TOKEN_PROPERTY("elementType", p.elementType)
+  PS_PROPERTY("familyName", p.familyName)
+  PS_PROPERTY("indices", p.indices)
+
+  if (!MaterialBindingToPrimSpec(p, ps)) {
+    return false;
+  }
+
+  return CollectionToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomCamera &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("clippingRange", p.clippingRange)
+  PS_PROPERTY("clippingPlanes", p.clippingPlanes)
+  PS_PROPERTY("exposure", p.exposure)
+  PS_PROPERTY("focalLength", p.focalLength)
+  PS_PROPERTY("focusDistance", p.focusDistance)
+  PS_PROPERTY("fStop", p.fStop)
+  PS_PROPERTY("horizontalAperture", p.horizontalAperture)
+  PS_PROPERTY("horizontalApertureOffset", p.horizontalApertureOffset)
+  PS_PROPERTY("verticalAperture", p.verticalAperture)
+  PS_PROPERTY("verticalApertureOffset", p.verticalApertureOffset)
+  PS_TOKEN_PROPERTY("projection", p.projection)
+  PS_TOKEN_PROPERTY("stereoRole", p.stereoRole)
+  PS_PROPERTY("shutter:open", p.shutterOpen)
+  PS_PROPERTY("shutter:close", p.shutterClose)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomSphere &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("radius", p.radius)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomCube &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("size", p.size)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomCone &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("radius", p.radius)
+  PS_PROPERTY("height", p.height)
+  PS_TOKEN_PROPERTY("axis", p.axis)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomCylinder &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("radius", p.radius)
+  PS_PROPERTY("height", p.height)
+  PS_TOKEN_PROPERTY("axis", p.axis)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomCapsule &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("radius", p.radius)
+  PS_PROPERTY("height", p.height)
+  PS_TOKEN_PROPERTY("axis", p.axis)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomPoints &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("points", p.points)
+  PS_PROPERTY("normals", p.normals)
+  PS_PROPERTY("widths", p.widths)
+  PS_PROPERTY("ids", p.ids)
+  PS_PROPERTY("velocities", p.velocities)
+  PS_PROPERTY("accelerations", p.accelerations)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomBasisCurves &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_TOKEN_PROPERTY("type", p.type)
+  PS_TOKEN_PROPERTY("basis", p.basis)
+  PS_TOKEN_PROPERTY("wrap", p.wrap)
+
+  PS_PROPERTY("points", p.points)
+  PS_PROPERTY("normals", p.normals)
+  PS_PROPERTY("widths", p.widths)
+  PS_PROPERTY("velocities", p.velocities)
+  PS_PROPERTY("accelerations", p.accelerations)
+  PS_PROPERTY("curveVertexCounts", p.curveVertexCounts)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const GeomNurbsCurves &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("points", p.points)
+  PS_PROPERTY("normals", p.normals)
+  PS_PROPERTY("widths", p.widths)
+  PS_PROPERTY("velocities", p.velocities)
+  PS_PROPERTY("accelerations", p.accelerations)
+  PS_PROPERTY("curveVertexCounts", p.curveVertexCounts)
+
+  PS_PROPERTY("order", p.order)
+  PS_PROPERTY("knots", p.knots)
+  PS_PROPERTY("ranges", p.ranges)
+  PS_PROPERTY("pointWeights", p.pointWeights)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const PointInstancer &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_RELATIONSHIP("prototypes", p.prototypes)
+  PS_PROPERTY("protoIndices", p.protoIndices)
+  PS_PROPERTY("ids", p.ids)
+  PS_PROPERTY("invisibleIds", p.invisibleIds)
+  PS_PROPERTY("positions", p.positions)
+  PS_PROPERTY("orientations", p.orientations)
+  PS_PROPERTY("scales", p.scales)
+  PS_PROPERTY("velocities", p.velocities)
+  PS_PROPERTY("accelerations", p.accelerations)
+  PS_PROPERTY("angularVelocities", p.angularVelocities)
+
+  return GPrimToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const SkelRoot &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_TOKEN_PROPERTY("visibility", p.visibility)
+  PS_TOKEN_PROPERTY("purpose", p.purpose)
+  PS_PROPERTY("extent", p.extent)
+  PS_RELATIONSHIP("proxyPrim", p.proxyPrim)
+
+  return XformOpsToPrimSpec(p.xformOps, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const Skeleton &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("bindTransforms", p.bindTransforms)
+  PS_PROPERTY("jointNames", p.jointNames)
+  PS_PROPERTY("joints", p.joints)
+  PS_PROPERTY("restTransforms", p.restTransforms)
+  PS_RELATIONSHIP("skel:animationSource", p.animationSource)
+  PS_RELATIONSHIP("proxyPrim", p.proxyPrim)
+  PS_TOKEN_PROPERTY("visibility", p.visibility)
+  PS_TOKEN_PROPERTY("purpose", p.purpose)
+  PS_PROPERTY("extent", p.extent)
+
+  return XformOpsToPrimSpec(p.xformOps, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const SkelAnimation &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("blendShapes", p.blendShapes)
+  PS_PROPERTY("blendShapeWeights", p.blendShapeWeights)
+  PS_PROPERTY("joints", p.joints)
+  PS_PROPERTY("rotations", p.rotations)
+  PS_PROPERTY("scales", p.scales)
+  PS_PROPERTY("translations", p.translations)
+
+  return true;
+}
+
+template <>
+bool PrimToPrimSpecImpl(const BlendShape &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("offsets", p.offsets)
+  PS_PROPERTY("normalOffsets", p.normalOffsets)
+  PS_PROPERTY("pointIndices", p.pointIndices)
+
+  return true;
+}
+
+template <>
+bool PrimToPrimSpecImpl(const Material &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("outputs:surface", p.surface)
+  PS_PROPERTY("outputs:displacement", p.displacement)
+  PS_PROPERTY("outputs:volume", p.volume)
+
+  return true;
+}
+
+template <>
+bool PrimToPrimSpecImpl(const Shader &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+#define SHADER_TO_PRIMSPEC(__ty)                                 \
+  if (auto pv = p.value.get_value<__ty>()) {                     \
+    return ShaderNodeToPrimSpec(pv.value(), p.info_id, ps, err); \
+  } else
+
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_int)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_float)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_float2)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_float3)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_float4)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_string)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_normal)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_vector)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_point)
+  SHADER_TO_PRIMSPEC(UsdPrimvarReader_matrix)
+  SHADER_TO_PRIMSPEC(UsdUVTexture)
+  SHADER_TO_PRIMSPEC(UsdTransform2d)
+  SHADER_TO_PRIMSPEC(UsdPreviewSurface)
+  SHADER_TO_PRIMSPEC(ShaderNode) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid ShaderNode in Shader Prim `{}`.\n", p.name));
+  }
+
+#undef SHADER_TO_PRIMSPEC
+}
+
+template <>
+bool PrimToPrimSpecImpl(const SphereLight &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("inputs:radius", p.radius)
+  PS_PROPERTY("extent", p.extent)
+
+  return LightToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const DistantLight &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("inputs:angle", p.angle)
+
+  return LightToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const CylinderLight &p, PrimSpec &ps,
+                        std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("inputs:length", p.length)
+  PS_PROPERTY("inputs:radius", p.radius)
+  PS_PROPERTY("extent", p.extent)
+
+  return LightToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const DiskLight &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("inputs:radius", p.radius)
+  PS_PROPERTY("extent", p.extent)
+
+  return LightToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const DomeLight &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("inputs:guideRadius", p.guideRadius)
+  PS_PROPERTY("inputs:texture:file", p.file)
+  PS_TOKEN_PROPERTY("inputs:texture:format", p.textureFormat)
+
+  return LightToPrimSpec(p, ps, err);
+}
+
+template <>
+bool PrimToPrimSpecImpl(const RectLight &p, PrimSpec &ps, std::string *err) {
+  PrimToPrimSpecCommon(p, ps);
+
+  PS_PROPERTY("inputs:texture:file", p.file)
+  PS_PROPERTY("inputs:width", p.width)
+  PS_PROPERTY("inputs:height", p.height)
+  PS_PROPERTY("extent", p.extent)
+
+  return LightToPrimSpec(p, ps, err);
+}
+
+#undef PS_PROPERTY
+#undef PS_TOKEN_PROPERTY
+#undef PS_RELATIONSHIP
+
+bool PrimToPrimSpec(const Prim &prim, PrimSpec &ps, std::string *err) {
+#define TO_PRIMSPEC(__ty)                                   \
+  if (auto pv = prim.as<__ty>()) {                          \
+    if (!PrimToPrimSpecImpl(*pv, ps, err)) {                \
+      return false;                                         \
+    }                                                       \
+  } else
+
+  TO_PRIMSPEC(Model)
+  TO_PRIMSPEC(Scope)
+  TO_PRIMSPEC(Xform)
+  TO_PRIMSPEC(GeomMesh)
+  TO_PRIMSPEC(GeomSubset)
+  TO_PRIMSPEC(GeomCamera)
+  TO_PRIMSPEC(GeomSphere)
+  TO_PRIMSPEC(GeomCube)
+  TO_PRIMSPEC(GeomCone)
+  TO_PRIMSPEC(GeomCylinder)
+  TO_PRIMSPEC(GeomCapsule)
+  TO_PRIMSPEC(GeomPoints)
+  TO_PRIMSPEC(GeomBasisCurves)
+  TO_PRIMSPEC(GeomNurbsCurves)
+  TO_PRIMSPEC(PointInstancer)
+  TO_PRIMSPEC(SkelRoot)
+  TO_PRIMSPEC(Skeleton)
+  TO_PRIMSPEC(SkelAnimation)
+  TO_PRIMSPEC(BlendShape)
+  TO_PRIMSPEC(Material)
+  TO_PRIMSPEC(Shader)
+  TO_PRIMSPEC(SphereLight)
+  TO_PRIMSPEC(DistantLight)
+  TO_PRIMSPEC(CylinderLight)
+  TO_PRIMSPEC(DiskLight)
+  TO_PRIMSPEC(DomeLight)
+  TO_PRIMSPEC(RectLight) {
+    if (err) {
+      (*err) +=
+          "Unsupported/unimplemented Prim type: " + prim.prim_type_name() +
+          "\n";
+    }
+    return false;
+  }
+
+#undef TO_PRIMSPEC
+
+  // variantSet
+  for (const auto &vs : prim.variantSets()) {
+    VariantSetSpec vss;
+    vss.name = vs.first;
+
+    for (const auto &item : vs.second.variantSet) {
+      const Variant &variant = item.second;
+
+      PrimSpec variant_ps;
+      variant_ps.name() = item.first;
+      variant_ps.metas() = variant.metas();
+      variant_ps.props() = variant.properties();
+
+      for (const auto &child : variant.primChildren()) {
+        PrimSpec child_ps;
+        if (!PrimToPrimSpec(child, child_ps, err)) {
+          return false;
+        }
+        variant_ps.children().emplace_back(std::move(child_ps));
+      }
+
+      vss.variantSet.emplace(item.first, std::move(variant_ps));
+    }
+
+    ps.variantSets().emplace(vs.first, std::move(vss));
+  }
+
+  // Use `primChildren` to determine the order of child Prims when available.
+  std::vector<const Prim *> children;
+  if (prim.metas().primChildren.size() == prim.children().size()) {
+    std::map<std::string, const Prim *> primNameTable;
+    for (const auto &child : prim.children()) {
+      primNameTable.emplace(child.element_name(), &child);
+    }
+
+    for (const auto &nameTok : prim.metas().primChildren) {
+      const auto it = primNameTable.find(nameTok.str());
+      if (it != primNameTable.end()) {
+        children.push_back(it->second);
+      }
+    }
+  }
+
+  if (children.size() != prim.children().size()) {
+    children.clear();
+    for (const auto &child : prim.children()) {
+      children.push_back(&child);
+    }
+  }
+
+  for (const Prim *child : children) {
+    PrimSpec child_ps;
+    if (!PrimToPrimSpec(*child, child_ps, err)) {
+      return false;
+    }
+    ps.children().emplace_back(std::move(child_ps));
+  }
+
+  return true;
+}
+
+bool ShaderToPrimSpec(const UsdTransform2d &node, PrimSpec &ps,
+                      std::string *warn, std::string *err) {
+  (void)warn;
+
+  if (!ShaderNodeToPrimSpec(node, kUsdTransform2d, ps, err)) {
+    return false;
+  }
 
   ps.metas() = node.metas();
   ps.name() = node.name;
   ps.specifier() = node.spec;
+  ps.typeName() = kShader;
 
   return true;
 }
-#endif
+
+bool ShaderToPrimSpec(const UsdUVTexture &node, PrimSpec &ps,
+                      std::string *warn, std::string *err) {
+  (void)warn;
+
+  if (!ShaderNodeToPrimSpec(node, kUsdUVTexture, ps, err)) {
+    return false;
+  }
+
+  ps.metas() = node.metas();
+  ps.name() = node.name;
+  ps.specifier() = node.spec;
+  ps.typeName() = kShader;
+
+  return true;
+}
+
+std::vector<const GeomSubset *> GetGeomSubsets(
+    const tinyusdz::Stage &stage, const tinyusdz::Path &prim_path,
+    const tinyusdz::value::token &familyName, bool prim_must_be_geommesh) {
+  std::vector<const GeomSubset *> result;
+
+  const Prim *pprim{nullptr};
+  if (!stage.find_prim_at_path(prim_path, pprim)) {
+    return result;
+  }
+
+  if (!pprim) {
+    return result;
+  }
+
+  if (prim_must_be_geommesh && !pprim->is<GeomMesh>()) {
+    return result;
+  }
+
+  // Only account for child Prims.
+  for (const auto &p : pprim->children()) {
+    if (auto pv = p.as<GeomSubset>()) {
+      if (familyName.valid()) {
+        if (pv->familyName.authored()) {
+          if (pv->familyName.get_value().has_value()) {
+            const value::token &tok = pv->familyName.get_value().value();
+            if (familyName.str() == tok.str()) {
+              result.push_back(pv);
+            }
+          } else {
+            // connection attr or value block?
+            // skip adding this GeomSubset.
+          }
+        } else {
+          result.push_back(pv);
+        }
+      } else {
+        result.push_back(pv);
+      }
+    }
+  }
+
+  return result;
+}
+
+std::vector<const GeomSubset *> GetGeomSubsetChildren(
+    const tinyusdz::Prim &prim, const tinyusdz::value::token &familyName,
+    bool prim_must_be_geommesh) {
+  std::vector<const GeomSubset *> result;
+
+  if (prim_must_be_geommesh && !prim.is<GeomMesh>()) {
+    return result;
+  }
+
+  // Only account for child Prims.
+  for (const auto &p : prim.children()) {
+    if (auto pv = p.as<GeomSubset>()) {
+      if (familyName.valid()) {
+        if (pv->familyName.authored()) {
+          if (pv->familyName.get_value().has_value()) {
+            const value::token &tok = pv->familyName.get_value().value();
+            if (familyName.str() == tok.str()) {
+              result.push_back(pv);
+            }
+          } else {
+            // connection attr or value block?
+            // skip adding this GeomSubset.
+          }
+        } else {
+          result.push_back(pv);
+        }
+      } else {
+        result.push_back(pv);
+      }
+    }
+  }
+
+  return result;
+}
 
 bool GetCollection(const Prim &prim, const Collection **dst) {
   if (!dst) {
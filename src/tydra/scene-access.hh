@@ -8,6 +8,7 @@
 //
 #pragma once
 
+#include <deque>
 #include <map>
 
 #include "prim-type-macros.inc"
@@ -299,6 +300,8 @@ struct XformNode {
 /// Xform value is evaluated at specified time and timeSample interpolation
 /// type.
 ///
+/// All xformOps in Stage are evaluated in each call. Use XformCache to
+/// evaluate the hierarchy at many timecodes.
 ///
 bool BuildXformNodeFromStage(
     const tinyusdz::Stage &stage, XformNode *root, /* out */
@@ -308,6 +311,148 @@ bool BuildXformNodeFromStage(
 
 std::string DumpXformNode(const XformNode &root);
 
+///
+/// Cache of local and world matrices of Prims in Stage at a time.
+///
+/// xformOps without timeSamples are evaluated only once in `Build`. `SetTime`
+/// re-evaluates time-varying xformOps and updates world matrices of their
+/// descendants only(`!resetXformStack!` stops the propagation), so the cost of
+/// per-frame evaluation is proportional to the number of animated Prims(and
+/// their descendants), not the number of Prims in Stage.
+///
+/// Local matrices of time-varying Prims are also cached per timecode(keyed by
+/// (Prim, time)), so revisiting a timecode(e.g. scrubbing) only propagates
+/// world matrices without evaluating xformOps. The number of cached timecodes
+/// is limited by `SetMaxCachedTimeCodes`.
+///
+/// Like XformNode, the cache holds pointers to Prims. Please call `Build`
+/// again when the content of Stage is changed.
+///
+class XformCache {
+ public:
+  ///
+  /// Build the cache from Stage and evaluate matrices at time `t`.
+  ///
+  bool Build(const tinyusdz::Stage &stage,
+             const double t = tinyusdz::value::TimeCode::Default(),
+             const tinyusdz::value::TimeSampleInterpolationType tinterp =
+                 tinyusdz::value::TimeSampleInterpolationType::Linear,
+             std::string *err = nullptr);
+
+  ///
+  /// Update matrices to time `t`. Does nothing when `t` and `tinterp` are
+  /// the same as the ones of the last evaluation.
+  ///
+  bool SetTime(const double t,
+               const tinyusdz::value::TimeSampleInterpolationType tinterp =
+                   tinyusdz::value::TimeSampleInterpolationType::Linear,
+               std::string *err = nullptr);
+
+  double GetTime() const { return _t; }
+
+  ///
+  /// Set the max number of timecodes to cache local matrices of time-varying
+  /// Prims. The oldest one is evicted first. 0 = disable the cache.
+  ///
+  void SetMaxCachedTimeCodes(const size_t n);
+
+  size_t GetNumCachedTimeCodes() const { return _cached_times.size(); }
+
+  tinyusdz::value::TimeSampleInterpolationType GetInterpolationType() const {
+    return _tinterp;
+  }
+
+  ///
+  /// @param[in] abs_path Absolute Prim path(e.g. "/xform/geom0")
+  /// @param[out] m Local matrix. identity for non-Xformable Prim.
+  /// @param[out] resetXformStack Optional. true when Prim has
+  /// `!resetXformStack!`
+  ///
+  /// @return false when Prim is not found.
+  ///
+  bool GetLocalMatrix(const std::string &abs_path, value::matrix4d *m,
+                      bool *resetXformStack = nullptr) const;
+
+  ///
+  /// world matrix = local matrix x parent's world matrix
+  ///
+  /// @return false when Prim is not found.
+  ///
+  bool GetWorldMatrix(const std::string &abs_path, value::matrix4d *m) const;
+
+  ///
+  /// @return true when the world matrix of the Prim may change over time(Prim
+  /// or its ancestor has time-varying xformOps).
+  ///
+  bool IsTimeVarying(const std::string &abs_path) const;
+
+  ///
+  /// @return Prim paths whose world matrix was changed by the last `SetTime`.
+  ///
+  const std::vector<std::string> &GetUpdatedPaths() const {
+    return _updated_paths;
+  }
+
+  ///
+  /// @return The number of Prims re-evaluated in `SetTime`.
+  ///
+  size_t GetNumTimeVaryingPrims() const { return _dynamic_entries.size(); }
+
+  ///
+  /// Build XformNode hierarchy with cached matrices. Same result with
+  /// `BuildXformNodeFromStage` at `GetTime()`, but no xformOps are evaluated.
+  ///
+  bool BuildXformNode(XformNode *root) const;
+
+ private:
+  // Prim in DFS pre-order.
+  struct Entry {
+    const Prim *prim{nullptr};
+    std::string abs_path;
+    int64_t parent{-1};     // index to `_entries`. -1 = root Prim
+    size_t subtree_end{0};  // (the index of the last descendant) + 1
+
+    bool has_xform{false};
+    bool has_resetXformStack{false};
+    bool time_varying{false};  // xformOps have timeSamples
+    bool dynamic{false};  // world matrix depends on time
+
+    value::matrix4d local_matrix{value::matrix4d::identity()};
+    value::matrix4d world_matrix{value::matrix4d::identity()};
+  };
+
+  bool BuildRec(const Prim &prim, const std::string &parent_abs_path,
+                const int64_t parent, std::string *err);
+
+  bool EvaluateLocalMatrix(const Entry &entry, const double t,
+                           const tinyusdz::value::TimeSampleInterpolationType tinterp,
+                           value::matrix4d *m, bool *resetXformStack,
+                           std::string *err) const;
+
+  void BuildXformNodeRec(const size_t idx, const Path &parent_abs_path,
+                         const value::matrix4d &parent_world,
+                         XformNode *node) const;
+
+  // Cache local matrices of time-varying entries at the current time.
+  void StoreLocalMatrices();
+
+  std::vector<Entry> _entries;
+  std::map<std::string, size_t> _path_to_entry;
+  std::vector<size_t> _dynamic_entries;  // in DFS pre-order
+  std::vector<uint8_t> _changed;         // scratch for `SetTime`
+  std::vector<std::string> _updated_paths;
+
+  // Local matrices of time-varying entries(in `_dynamic_entries` order) for
+  // each timecode. `_cached_times` holds timecodes in insertion order.
+  std::map<double, std::vector<value::matrix4d>> _local_matrix_cache;
+  std::deque<double> _cached_times;
+  size_t _max_cached_times{16};
+
+  double _t{tinyusdz::value::TimeCode::Default()};
+  tinyusdz::value::TimeSampleInterpolationType _tinterp{
+      tinyusdz::value::TimeSampleInterpolationType::Linear};
+};
+
 ///
 /// Get GeomSubset children of the given Prim path
 ///
@@ -369,8 +514,9 @@ std::vector<const PrimSpec *> GetGeomSubsetChildren(const tinyusdz::Path &prim_p
 #endif
 
 ///
-/// For composition. Convert Concrete Prim(Xform, GeomMesh, ...) to PrimSpec,
-/// generic Prim container.
+/// For composition and USDC export. Convert Concrete Prim(Xform, GeomMesh,
+/// ...) to PrimSpec, generic Prim container. Only authored properties are
+/// converted. Child Prims and variantSets are converted recursively.
 /// TODO: Move to *core* module?
 ///
 bool PrimToPrimSpec(const Prim &prim, PrimSpec &ps, std::string *err);
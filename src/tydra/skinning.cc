@@ -0,0 +1,996 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+#include "skinning.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "common-macros.inc"
+#include "linear-algebra.hh"
+#include "thread-util.hh"
+#include "tiny-format.hh"
+#include "xform.hh"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TINYUSDZ_SKINNING_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define TINYUSDZ_SKINNING_USE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace tinyusdz {
+namespace tydra {
+
+// For PUSH_ERROR_AND_RETURN
+#define PushError(msg) \
+  if (err) {           \
+    (*err) += msg;     \
+  }
+
+namespace {
+
+// The number of vertices processed by a thread at once.
+constexpr size_t kVertexGrainSize = 1024 * 4;
+
+// BlendShape with smaller weight than this is skipped.
+constexpr float kMinBlendShapeWeight = 1.0e-6f;
+
+inline float Lerp(const float a, const float b, const float s) {
+  return a + s * (b - a);
+}
+
+inline vec3 Lerp(const vec3 &a, const vec3 &b, const float s) {
+  return {Lerp(a[0], b[0], s), Lerp(a[1], b[1], s), Lerp(a[2], b[2], s)};
+}
+
+inline quat Lerp(const quat &a, const quat &b, const float s) {
+  value::quatf qa, qb;
+  qa.imag = {a[0], a[1], a[2]};
+  qa.real = a[3];
+  qb.imag = {b[0], b[1], b[2]};
+  qb.real = b[3];
+
+  value::quatf q = slerp(qa, qb, s);
+  return {q.imag[0], q.imag[1], q.imag[2], q.real};
+}
+
+///
+/// Sample AnimationSampler at time `t`.
+/// Return false when the sampler has no value.
+///
+template <typename T>
+bool SampleAnimation(const AnimationSampler<T> &sampler, const double t,
+                     T *out) {
+  const std::vector<AnimationSample<T>> &samples = sampler.samples;
+
+  if (samples.empty() || (std::isnan(t) && sampler.static_value)) {
+    if (sampler.static_value) {
+      (*out) = sampler.static_value.value();
+      return true;
+    }
+    return false;
+  }
+
+  if (std::isnan(t) || (float(t) <= samples.front().t)) {
+    (*out) = samples.front().value;
+    return true;
+  }
+
+  if (float(t) >= samples.back().t) {
+    (*out) = samples.back().value;
+    return true;
+  }
+
+  auto it = std::upper_bound(
+      samples.begin(), samples.end(), float(t),
+      [](const float tc, const AnimationSample<T> &s) { return tc < s.t; });
+  const AnimationSample<T> &s1 = *it;
+  const AnimationSample<T> &s0 = *(it - 1);
+
+  if (sampler.interpolation == AnimationSampler<T>::Interpolation::Step) {
+    (*out) = s0.value;
+    return true;
+  }
+
+  const float dt = s1.t - s0.t;
+  const float s = (dt > 0.0f) ? ((float(t) - s0.t) / dt) : 0.0f;
+  (*out) = Lerp(s0.value, s1.value, s);
+
+  return true;
+}
+
+///
+/// Compose joint local matrix from animation channels(S * R * T in row-major).
+/// Missing channels use identity.
+///
+value::matrix4d JointLocalMatrix(
+    const std::map<AnimationChannel::ChannelType, AnimationChannel> &channels,
+    const double t) {
+  vec3 translation{0.0f, 0.0f, 0.0f};
+  quat rotation{0.0f, 0.0f, 0.0f, 1.0f};
+  vec3 scale{1.0f, 1.0f, 1.0f};
+
+  auto it = channels.find(AnimationChannel::ChannelType::Translation);
+  if (it != channels.end()) {
+    SampleAnimation(it->second.translations, t, &translation);
+  }
+
+  it = channels.find(AnimationChannel::ChannelType::Rotation);
+  if (it != channels.end()) {
+    SampleAnimation(it->second.rotations, t, &rotation);
+  }
+
+  it = channels.find(AnimationChannel::ChannelType::Scale);
+  if (it != channels.end()) {
+    SampleAnimation(it->second.scales, t, &scale);
+  }
+
+  value::quatf q;
+  q.imag = {rotation[0], rotation[1], rotation[2]};
+  q.real = rotation[3];
+
+  value::matrix4d m = to_matrix(q);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      m.m[i][j] *= double(scale[i]);
+    }
+  }
+  m.m[3][0] = double(translation[0]);
+  m.m[3][1] = double(translation[1]);
+  m.m[3][2] = double(translation[2]);
+
+  return m;
+}
+
+void CountJoints(const SkelNode &node, int *max_joint_id) {
+  (*max_joint_id) = (std::max)(*max_joint_id, node.joint_id);
+  for (const auto &child : node.children) {
+    CountJoints(child, max_joint_id);
+  }
+}
+
+bool ComputeSkinningMatricesRec(const SkelNode &node,
+                                const value::matrix4d &parent_world,
+                                const Animation *anim, const double t,
+                                std::vector<value::matrix4d> *dst,
+                                std::string *err) {
+  if ((node.joint_id < 0) || (size_t(node.joint_id) >= dst->size())) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Invalid joint id {} for joint `{}`.", node.joint_id,
+                    node.joint_path));
+  }
+
+  value::matrix4d local = node.rest_transform;
+  if (anim) {
+    auto it = anim->channels_map.find(node.joint_path);
+    if (it != anim->channels_map.end()) {
+      local = JointLocalMatrix(it->second, t);
+    }
+  }
+
+  // row-major
+  value::matrix4d world = local * parent_world;
+
+  value::matrix4d inv_bind;
+  if (!inverse(node.bind_transform, inv_bind)) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "bindTransform of joint `{}` is not invertible.", node.joint_path));
+  }
+
+  (*dst)[size_t(node.joint_id)] = inv_bind * world;
+
+  for (const auto &child : node.children) {
+    if (!ComputeSkinningMatricesRec(child, world, anim, t, dst, err)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+inline void ToFloatMatrix(const value::matrix4d &m, float *dst) {
+  for (size_t i = 0; i < 4; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      dst[4 * i + j] = float(m.m[i][j]);
+    }
+  }
+}
+
+// dst += s * v
+inline void AddScaled(vec3 &dst, const float s, const vec3 &v) {
+  dst[0] += s * v[0];
+  dst[1] += s * v[1];
+  dst[2] += s * v[2];
+}
+
+inline void NormalizeVec3(vec3 &v) {
+  const float d2 = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+  if (d2 > 0.0f) {
+    const float len = std::sqrt(d2);
+    v[0] /= len;
+    v[1] /= len;
+    v[2] /= len;
+  }
+}
+
+//
+// Linear blend skinning.
+//
+// Blend rows of joint matrices(float4x4 row-major) by weights, then transform
+// point `p`(and normal `n` when not nullptr). Blended upper-left 3x3 is stored
+// to `rows`(12 floats) when not nullptr.
+//
+// NOTE: Normal is transformed by the blended 3x3 matrix(not
+// inverse-transpose), which is exact for rigid and uniform-scale joints.
+//
+#if defined(TINYUSDZ_SKINNING_USE_SSE2)
+
+inline void SkinVertexLBS(const float *mats, const uint32_t *indices,
+                          const float *weights, const uint32_t num_influences,
+                          vec3 &p, vec3 *n, float *rows) {
+  __m128 r0 = _mm_setzero_ps();
+  __m128 r1 = _mm_setzero_ps();
+  __m128 r2 = _mm_setzero_ps();
+  __m128 r3 = _mm_setzero_ps();
+
+  for (uint32_t k = 0; k < num_influences; k++) {
+    if (weights[k] == 0.0f) {
+      continue;
+    }
+    const float *m = mats + 16 * indices[k];
+    const __m128 w = _mm_set1_ps(weights[k]);
+    r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_loadu_ps(m + 0)));
+    r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_loadu_ps(m + 4)));
+    r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_loadu_ps(m + 8)));
+    r3 = _mm_add_ps(r3, _mm_mul_ps(w, _mm_loadu_ps(m + 12)));
+  }
+
+  float tmp[4];
+
+  __m128 v = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0]), r0),
+                 _mm_mul_ps(_mm_set1_ps(p[1]), r1)),
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[2]), r2), r3));
+  _mm_storeu_ps(tmp, v);
+  p = {tmp[0], tmp[1], tmp[2]};
+
+  if (n) {
+    v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps((*n)[0]), r0),
+                              _mm_mul_ps(_mm_set1_ps((*n)[1]), r1)),
+                   _mm_mul_ps(_mm_set1_ps((*n)[2]), r2));
+    _mm_storeu_ps(tmp, v);
+    (*n) = {tmp[0], tmp[1], tmp[2]};
+    NormalizeVec3(*n);
+  }
+
+  if (rows) {
+    _mm_storeu_ps(rows + 0, r0);
+    _mm_storeu_ps(rows + 4, r1);
+    _mm_storeu_ps(rows + 8, r2);
+  }
+}
+
+#elif defined(TINYUSDZ_SKINNING_USE_NEON)
+
+inline void SkinVertexLBS(const float *mats, const uint32_t *indices,
+                          const float *weights, const uint32_t num_influences,
+                          vec3 &p, vec3 *n, float *rows) {
+  float32x4_t r0 = vdupq_n_f32(0.0f);
+  float32x4_t r1 = vdupq_n_f32(0.0f);
+  float32x4_t r2 = vdupq_n_f32(0.0f);
+  float32x4_t r3 = vdupq_n_f32(0.0f);
+
+  for (uint32_t k = 0; k < num_influences; k++) {
+    if (weights[k] == 0.0f) {
+      continue;
+    }
+    const float *m = mats + 16 * indices[k];
+    const float w = weights[k];
+    r0 = vaddq_f32(r0, vmulq_n_f32(vld1q_f32(m + 0), w));
+    r1 = vaddq_f32(r1, vmulq_n_f32(vld1q_f32(m + 4), w));
+    r2 = vaddq_f32(r2, vmulq_n_f32(vld1q_f32(m + 8), w));
+    r3 = vaddq_f32(r3, vmulq_n_f32(vld1q_f32(m + 12), w));
+  }
+
+  float tmp[4];
+
+  float32x4_t v =
+      vaddq_f32(vaddq_f32(vmulq_n_f32(r0, p[0]), vmulq_n_f32(r1, p[1])),
+                vaddq_f32(vmulq_n_f32(r2, p[2]), r3));
+  vst1q_f32(tmp, v);
+  p = {tmp[0], tmp[1], tmp[2]};
+
+  if (n) {
+    v = vaddq_f32(vaddq_f32(vmulq_n_f32(r0, (*n)[0]), vmulq_n_f32(r1, (*n)[1])),
+                  vmulq_n_f32(r2, (*n)[2]));
+    vst1q_f32(tmp, v);
+    (*n) = {tmp[0], tmp[1], tmp[2]};
+    NormalizeVec3(*n);
+  }
+
+  if (rows) {
+    vst1q_f32(rows + 0, r0);
+    vst1q_f32(rows + 4, r1);
+    vst1q_f32(rows + 8, r2);
+  }
+}
+
+#else
+
+inline void SkinVertexLBS(const float *mats, const uint32_t *indices,
+                          const float *weights, const uint32_t num_influences,
+                          vec3 &p, vec3 *n, float *rows) {
+  float r[16] = {};
+
+  for (uint32_t k = 0; k < num_influences; k++) {
+    if (weights[k] == 0.0f) {
+      continue;
+    }
+    const float *m = mats + 16 * indices[k];
+    for (size_t i = 0; i < 16; i++) {
+      r[i] += weights[k] * m[i];
+    }
+  }
+
+  const vec3 q = p;
+  for (size_t i = 0; i < 3; i++) {
+    p[i] = (q[0] * r[i] + q[1] * r[4 + i]) + (q[2] * r[8 + i] + r[12 + i]);
+  }
+
+  if (n) {
+    const vec3 m = (*n);
+    for (size_t i = 0; i < 3; i++) {
+      (*n)[i] = (m[0] * r[i] + m[1] * r[4 + i]) + m[2] * r[8 + i];
+    }
+    NormalizeVec3(*n);
+  }
+
+  if (rows) {
+    memcpy(rows, r, sizeof(float) * 12);
+  }
+}
+
+#endif
+
+inline vec3 TransformDir(const float *rows, const vec3 &n) {
+  vec3 r;
+  for (size_t i = 0; i < 3; i++) {
+    r[i] = (n[0] * rows[i] + n[1] * rows[4 + i]) + n[2] * rows[8 + i];
+  }
+  return r;
+}
+
+//
+// Dual quaternion. 8 floats: real(x, y, z, w), dual(x, y, z, w)
+//
+
+inline void QuatMul(const float *a, const float *b, float *dst) {
+  dst[0] = a[3] * b[0] + b[3] * a[0] + (a[1] * b[2] - a[2] * b[1]);
+  dst[1] = a[3] * b[1] + b[3] * a[1] + (a[2] * b[0] - a[0] * b[2]);
+  dst[2] = a[3] * b[2] + b[3] * a[2] + (a[0] * b[1] - a[1] * b[0]);
+  dst[3] = a[3] * b[3] - (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]);
+}
+
+// Rigid part of row-major matrix to dual quaternion. Scale is removed.
+void ToDualQuat(const value::matrix4d &m, float *dq) {
+  // Rotation matrix for column vector(= transpose of row-major rotation).
+  double c[3][3];
+  for (size_t i = 0; i < 3; i++) {
+    double len = std::sqrt(m.m[i][0] * m.m[i][0] + m.m[i][1] * m.m[i][1] +
+                           m.m[i][2] * m.m[i][2]);
+    len = (len > 0.0) ? len : 1.0;
+    for (size_t j = 0; j < 3; j++) {
+      c[j][i] = m.m[i][j] / len;
+    }
+  }
+
+  double x, y, z, w;
+  const double trace = c[0][0] + c[1][1] + c[2][2];
+  if (trace > 0.0) {
+    double s = 0.5 / std::sqrt(trace + 1.0);
+    w = 0.25 / s;
+    x = (c[2][1] - c[1][2]) * s;
+    y = (c[0][2] - c[2][0]) * s;
+    z = (c[1][0] - c[0][1]) * s;
+  } else if ((c[0][0] > c[1][1]) && (c[0][0] > c[2][2])) {
+    double s = 2.0 * std::sqrt(1.0 + c[0][0] - c[1][1] - c[2][2]);
+    w = (c[2][1] - c[1][2]) / s;
+    x = 0.25 * s;
+    y = (c[0][1] + c[1][0]) / s;
+    z = (c[0][2] + c[2][0]) / s;
+  } else if (c[1][1] > c[2][2]) {
+    double s = 2.0 * std::sqrt(1.0 + c[1][1] - c[0][0] - c[2][2]);
+    w = (c[0][2] - c[2][0]) / s;
+    x = (c[0][1] + c[1][0]) / s;
+    y = 0.25 * s;
+    z = (c[1][2] + c[2][1]) / s;
+  } else {
+    double s = 2.0 * std::sqrt(1.0 + c[2][2] - c[0][0] - c[1][1]);
+    w = (c[1][0] - c[0][1]) / s;
+    x = (c[0][2] + c[2][0]) / s;
+    y = (c[1][2] + c[2][1]) / s;
+    z = 0.25 * s;
+  }
+
+  dq[0] = float(x);
+  dq[1] = float(y);
+  dq[2] = float(z);
+  dq[3] = float(w);
+
+  // dual = 0.5 * translation * real
+  const float t[4] = {0.5f * float(m.m[3][0]), 0.5f * float(m.m[3][1]),
+                      0.5f * float(m.m[3][2]), 0.0f};
+  QuatMul(t, dq, dq + 4);
+}
+
+// Rotate `v` by unit quaternion `q`.
+inline vec3 QuatRotate(const float *q, const vec3 &v) {
+  // t = 2 * cross(q.xyz, v)
+  const float tx = 2.0f * (q[1] * v[2] - q[2] * v[1]);
+  const float ty = 2.0f * (q[2] * v[0] - q[0] * v[2]);
+  const float tz = 2.0f * (q[0] * v[1] - q[1] * v[0]);
+
+  // v + w * t + cross(q.xyz, t)
+  return {v[0] + q[3] * tx + (q[1] * tz - q[2] * ty),
+          v[1] + q[3] * ty + (q[2] * tx - q[0] * tz),
+          v[2] + q[3] * tz + (q[0] * ty - q[1] * tx)};
+}
+
+//
+// Dual quaternion skinning. `p` and `n` must be transformed by
+// geomBindTransform in advance.
+//
+void SkinVertexDQS(const float *dual_quats, const uint32_t *indices,
+                   const float *weights, const uint32_t num_influences,
+                   vec3 &p, vec3 *n) {
+  float b[8] = {};
+  const float *pivot = nullptr;
+
+  for (uint32_t k = 0; k < num_influences; k++) {
+    if (weights[k] == 0.0f) {
+      continue;
+    }
+    const float *dq = dual_quats + 8 * indices[k];
+    if (!pivot) {
+      pivot = dq;
+    }
+
+    // Blend in the same hemisphere with the first influence.
+    const float d =
+        pivot[0] * dq[0] + pivot[1] * dq[1] + pivot[2] * dq[2] + pivot[3] * dq[3];
+    const float w = (d < 0.0f) ? -weights[k] : weights[k];
+    for (size_t i = 0; i < 8; i++) {
+      b[i] += w * dq[i];
+    }
+  }
+
+  const float len = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+  if (len <= 0.0f) {
+    return;
+  }
+  for (size_t i = 0; i < 8; i++) {
+    b[i] /= len;
+  }
+
+  // translation = 2 * dual * conjugate(real)
+  const float conj[4] = {-b[0], -b[1], -b[2], b[3]};
+  float t[4];
+  QuatMul(b + 4, conj, t);
+
+  const vec3 r = QuatRotate(b, p);
+  p = {r[0] + 2.0f * t[0], r[1] + 2.0f * t[1], r[2] + 2.0f * t[2]};
+
+  if (n) {
+    (*n) = QuatRotate(b, *n);
+    NormalizeVec3(*n);
+  }
+}
+
+}  // namespace
+
+bool ComputeSkinningMatrices(const SkelHierarchy &skel, const Animation *anim,
+                             const double t,
+                             std::vector<value::matrix4d> *skinning_matrices,
+                             std::string *err) {
+  if (!skinning_matrices) {
+    PUSH_ERROR_AND_RETURN("`skinning_matrices` arg is nullptr.");
+  }
+
+  int max_joint_id = -1;
+  CountJoints(skel.root_node, &max_joint_id);
+  if (max_joint_id < 0) {
+    PUSH_ERROR_AND_RETURN(
+        fmt::format("Skeleton `{}` has no valid joint.", skel.abs_path));
+  }
+
+  skinning_matrices->assign(size_t(max_joint_id) + 1,
+                            value::matrix4d::identity());
+
+  return ComputeSkinningMatricesRec(skel.root_node,
+                                    value::matrix4d::identity(), anim, t,
+                                    skinning_matrices, err);
+}
+
+bool SkinningEvaluator::Setup(const RenderMesh &mesh,
+                              const SkelHierarchy *skel,
+                              const SkinningConfig &config, std::string *err) {
+  _mesh = &mesh;
+  _skel = skel;
+  _config = config;
+
+  _normal_point_indices.clear();
+  _has_normals = false;
+  _num_influences = 0;
+  _num_joints = 0;
+  _joint_indices.clear();
+  _joint_weights.clear();
+  _targets.clear();
+  _influence_offsets.clear();
+  _influences.clear();
+  _blendshape_points.clear();
+
+  const size_t num_points = mesh.points.size();
+
+  //
+  // Normals
+  //
+  const VertexAttribute &normals = mesh.normals;
+  if (config.deform_normals && normals.vertex_count() &&
+      (normals.format == VertexAttributeFormat::Vec3) &&
+      (normals.stride_bytes() == sizeof(vec3))) {
+    if (normals.is_vertex() && (normals.vertex_count() == num_points)) {
+      _has_normals = true;
+    } else if (normals.is_facevarying() &&
+               (normals.vertex_count() == mesh.faceVertexIndices().size())) {
+      _normal_point_indices = mesh.faceVertexIndices();
+      for (const auto &vidx : _normal_point_indices) {
+        if (vidx >= num_points) {
+          PUSH_ERROR_AND_RETURN(fmt::format(
+              "faceVertexIndex {} exceeds the number of points {}: {}", vidx,
+              num_points, mesh.abs_path));
+        }
+      }
+      _has_normals = true;
+    }
+  }
+
+  //
+  // Joint influences
+  //
+  if (skel) {
+    int max_joint_id = -1;
+    CountJoints(skel->root_node, &max_joint_id);
+    if (max_joint_id < 0) {
+      PUSH_ERROR_AND_RETURN(
+          fmt::format("Skeleton `{}` has no valid joint.", skel->abs_path));
+    }
+    _num_joints = uint32_t(max_joint_id) + 1;
+
+    const JointAndWeight &jw = mesh.joint_and_weights;
+    if (jw.elementSize < 1) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "Invalid elementSize {} of jointIndices: {}", jw.elementSize,
+          mesh.abs_path));
+    }
+    _num_influences = uint32_t(jw.elementSize);
+
+    const size_t n = num_points * _num_influences;
+    if ((jw.jointIndices.size() != n) || (jw.jointWeights.size() != n)) {
+      PUSH_ERROR_AND_RETURN(fmt::format(
+          "jointIndices.size {} and jointWeights.size {} must be equal to "
+          "points.size * elementSize {}: {}",
+          jw.jointIndices.size(), jw.jointWeights.size(), n, mesh.abs_path));
+    }
+
+    _joint_indices.resize(n);
+    _joint_weights.resize(n);
+
+    for (size_t v = 0; v < num_points; v++) {
+      float sum = 0.0f;
+      for (size_t k = 0; k < _num_influences; k++) {
+        const size_t i = v * _num_influences + k;
+        const int j = jw.jointIndices[i];
+        if ((j < 0) || (uint32_t(j) >= _num_joints)) {
+          PUSH_ERROR_AND_RETURN(
+              fmt::format("jointIndices[{}] {} is out of range. # of joints = "
+                          "{}: {}",
+                          i, j, _num_joints, mesh.abs_path));
+        }
+        _joint_indices[i] = uint32_t(j);
+        _joint_weights[i] = jw.jointWeights[i];
+        sum += jw.jointWeights[i];
+      }
+
+      const size_t base = v * _num_influences;
+      if (sum == 0.0f) {
+        // No influence. Transformed by geomBindTransform only.
+        _joint_indices[base] = _num_joints;
+        _joint_weights[base] = 1.0f;
+      } else if (config.normalize_weights) {
+        for (size_t k = 0; k < _num_influences; k++) {
+          _joint_weights[base + k] /= sum;
+        }
+      }
+    }
+  }
+
+  //
+  // BlendShapes
+  //
+  if (config.apply_blendshapes) {
+    for (const auto &it : mesh.targets) {
+      const ShapeTarget &target = it.second;
+      if (target.pointIndices.empty()) {
+        continue;
+      }
+
+      for (const auto &vidx : target.pointIndices) {
+        if (vidx >= num_points) {
+          PUSH_ERROR_AND_RETURN(fmt::format(
+              "pointIndex {} of BlendShape `{}` exceeds the number of points "
+              "{}: {}",
+              vidx, it.first, num_points, mesh.abs_path));
+        }
+      }
+
+      const size_t num_indices = target.pointIndices.size();
+      auto offsets_or_null = [num_indices](const std::vector<vec3> &v) {
+        return (v.size() == num_indices) ? &v : nullptr;
+      };
+
+      Target dst;
+      dst.name = it.first;
+      dst.point_indices = &target.pointIndices;
+
+      // rest shape
+      dst.shapes.push_back(Shape());
+
+      Shape primary;
+      primary.weight = 1.0f;
+      primary.point_offsets = offsets_or_null(target.pointOffsets);
+      primary.normal_offsets = offsets_or_null(target.normalOffsets);
+      dst.shapes.push_back(primary);
+
+      for (const auto &ib : target.inbetweens) {
+        Shape shape;
+        shape.weight = ib.first;
+        shape.point_offsets = offsets_or_null(ib.second.pointOffsets);
+        shape.normal_offsets = offsets_or_null(ib.second.normalOffsets);
+        dst.shapes.push_back(shape);
+      }
+
+      std::sort(dst.shapes.begin(), dst.shapes.end(),
+                [](const Shape &a, const Shape &b) {
+                  return a.weight < b.weight;
+                });
+
+      _targets.emplace_back(std::move(dst));
+    }
+
+    // Build per-point influences, so that BlendShapes are applied by
+    // gathering offsets for each point(no per-thread delta buffers).
+    if (!_targets.empty()) {
+      _influence_offsets.assign(num_points + 1, 0);
+      for (const auto &target : _targets) {
+        for (const auto &vidx : *target.point_indices) {
+          _influence_offsets[vidx + 1]++;
+        }
+      }
+      for (size_t v = 0; v < num_points; v++) {
+        if (_influence_offsets[v + 1]) {
+          _blendshape_points.push_back(uint32_t(v));
+        }
+        _influence_offsets[v + 1] += _influence_offsets[v];
+      }
+
+      _influences.resize(_influence_offsets[num_points]);
+      std::vector<size_t> cursor(_influence_offsets.begin(),
+                                 _influence_offsets.end() - 1);
+      for (size_t i = 0; i < _targets.size(); i++) {
+        const std::vector<uint32_t> &indices = *_targets[i].point_indices;
+        for (size_t k = 0; k < indices.size(); k++) {
+          TargetInfluence &inf = _influences[cursor[indices[k]]++];
+          inf.target_id = uint32_t(i);
+          inf.k = uint32_t(k);
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+void SkinningEvaluator::ApplyBlendShapes(const Animation *anim, const double t,
+                                         int nthreads, DeformedMesh *dst) {
+  // Shapes to blend: segment [a, b] which contains the weight, and the
+  // interpolation factor. Weights out of the range of shapes are
+  // extrapolated with the first/last segment.
+  _blend_states.assign(_targets.size(), BlendState());
+
+  bool has_active = false;
+  bool has_normal_offsets = false;
+
+  for (size_t i = 0; i < _targets.size(); i++) {
+    const Target &target = _targets[i];
+    auto it = anim->blendshape_weights_map.find(target.name);
+    if (it == anim->blendshape_weights_map.end()) {
+      continue;
+    }
+
+    float w = 0.0f;
+    if (!SampleAnimation(it->second, t, &w) ||
+        (std::fabs(w) < kMinBlendShapeWeight)) {
+      continue;
+    }
+
+    const std::vector<Shape> &shapes = target.shapes;
+    size_t seg = 0;
+    while (((seg + 2) < shapes.size()) && (w > shapes[seg + 1].weight)) {
+      seg++;
+    }
+
+    const Shape &a = shapes[seg];
+    const Shape &b = shapes[seg + 1];
+    const float dw = b.weight - a.weight;
+    const float s = (dw > 0.0f) ? ((w - a.weight) / dw) : 1.0f;
+
+    BlendState &state = _blend_states[i];
+    state.a = &a;
+    state.b = &b;
+    state.sa = 1.0f - s;
+    state.sb = s;
+    has_active = true;
+
+    has_normal_offsets |= (a.normal_offsets || b.normal_offsets);
+  }
+
+  if (!has_active) {
+    return;
+  }
+
+  has_normal_offsets &= _has_normals;
+
+  // Gather offsets of active Targets for each point. Offsets are summed up in
+  // the Target order, so the result does not depend on the number of threads.
+  auto gather = [this](const size_t v, const bool normal) {
+    vec3 d{0.0f, 0.0f, 0.0f};
+    for (size_t j = _influence_offsets[v]; j < _influence_offsets[v + 1];
+         j++) {
+      const TargetInfluence &inf = _influences[j];
+      const BlendState &state = _blend_states[inf.target_id];
+      if (!state.a) {
+        continue;
+      }
+
+      const std::vector<vec3> *oa =
+          normal ? state.a->normal_offsets : state.a->point_offsets;
+      const std::vector<vec3> *ob =
+          normal ? state.b->normal_offsets : state.b->point_offsets;
+      if (oa) {
+        AddScaled(d, state.sa, (*oa)[inf.k]);
+      }
+      if (ob) {
+        AddScaled(d, state.sb, (*ob)[inf.k]);
+      }
+    }
+    return d;
+  };
+
+  thread::ParallelForRange(
+      0, _blendshape_points.size(), kVertexGrainSize, nthreads,
+      [&](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        for (size_t i = begin; i < end; i++) {
+          const size_t v = _blendshape_points[i];
+          AddScaled(dst->points[v], 1.0f, gather(v, /* normal */ false));
+        }
+      });
+
+  if (has_normal_offsets) {
+    const size_t num_normals = dst->normals.size();
+    thread::ParallelForRange(
+        0, num_normals, kVertexGrainSize, nthreads,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          for (size_t i = begin; i < end; i++) {
+            const size_t v =
+                _normal_point_indices.empty() ? i : _normal_point_indices[i];
+            AddScaled(dst->normals[i], 1.0f, gather(v, /* normal */ true));
+            NormalizeVec3(dst->normals[i]);
+          }
+        });
+  }
+}
+
+bool SkinningEvaluator::Evaluate(const Animation *anim, const double t,
+                                 DeformedMesh *dst, std::string *err) {
+  if (!_mesh) {
+    PUSH_ERROR_AND_RETURN("SkinningEvaluator is not setup.");
+  }
+
+  if (!dst) {
+    PUSH_ERROR_AND_RETURN("`dst` arg is nullptr.");
+  }
+
+  const RenderMesh &mesh = *_mesh;
+  const int nthreads = thread::GetNumThreads(_config.num_threads);
+
+  dst->points = mesh.points;
+
+  if (_has_normals) {
+    dst->normals.resize(mesh.normals.vertex_count());
+    memcpy(dst->normals.data(), mesh.normals.get_data().data(),
+           sizeof(vec3) * dst->normals.size());
+  } else {
+    dst->normals.clear();
+  }
+
+  //
+  // 1. BlendShapes
+  //
+  if (anim && !_targets.empty()) {
+    ApplyBlendShapes(anim, t, nthreads, dst);
+  }
+
+  if (!_skel) {
+    return true;
+  }
+
+  //
+  // 2. Skinning
+  //
+  if (!ComputeSkinningMatrices(*_skel, anim, t, &_skin_matrices, err)) {
+    return false;
+  }
+
+  if (_skin_matrices.size() != _num_joints) {
+    PUSH_ERROR_AND_RETURN(fmt::format(
+        "The number of joints in Skeleton `{}` has been changed after Setup.",
+        _skel->abs_path));
+  }
+
+  const value::matrix4d &geom_bind = mesh.joint_and_weights.geomBindTransform;
+  const size_t num_points = dst->points.size();
+  const bool vertex_normals = _has_normals && _normal_point_indices.empty();
+  const bool facevarying_normals =
+      _has_normals && !_normal_point_indices.empty();
+
+  if (_config.method == SkinningMethod::DualQuaternion) {
+    // The last entry(for points without influence) is identity.
+    _dual_quats.assign(8 * (size_t(_num_joints) + 1), 0.0f);
+    for (size_t j = 0; j < _num_joints; j++) {
+      ToDualQuat(_skin_matrices[j], &_dual_quats[8 * j]);
+    }
+    _dual_quats[8 * _num_joints + 3] = 1.0f;
+
+    float geom_bind_m[16];
+    ToFloatMatrix(geom_bind, geom_bind_m);
+
+    // Skin facevarying normals with the blended dual quaternion of the
+    // point, by skinning (point, normal) pairs of each facevertex.
+    thread::ParallelForRange(
+        0, num_points, kVertexGrainSize, nthreads,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          const uint32_t identity = 0;
+          const float one = 1.0f;
+          for (size_t v = begin; v < end; v++) {
+            vec3 &p = dst->points[v];
+            vec3 *n = vertex_normals ? &dst->normals[v] : nullptr;
+            // geomBindTransform
+            SkinVertexLBS(geom_bind_m, &identity, &one, 1, p, n, nullptr);
+            SkinVertexDQS(_dual_quats.data(),
+                          &_joint_indices[v * _num_influences],
+                          &_joint_weights[v * _num_influences],
+                          _num_influences, p, n);
+          }
+        });
+
+    if (facevarying_normals) {
+      thread::ParallelForRange(
+          0, dst->normals.size(), kVertexGrainSize, nthreads,
+          [&](size_t begin, size_t end, int thread_id) {
+            (void)thread_id;
+            const uint32_t identity = 0;
+            const float one = 1.0f;
+            for (size_t i = begin; i < end; i++) {
+              const size_t v = _normal_point_indices[i];
+              vec3 p{0.0f, 0.0f, 0.0f};
+              SkinVertexLBS(geom_bind_m, &identity, &one, 1, p,
+                            &dst->normals[i], nullptr);
+              SkinVertexDQS(_dual_quats.data(),
+                            &_joint_indices[v * _num_influences],
+                            &_joint_weights[v * _num_influences],
+                            _num_influences, p, &dst->normals[i]);
+            }
+          });
+    }
+
+    return true;
+  }
+
+  // LBS: matrix = geomBindTransform * skinning matrix. The last entry(for
+  // points without influence) is geomBindTransform.
+  _matrices.resize(16 * (size_t(_num_joints) + 1));
+  for (size_t j = 0; j < _num_joints; j++) {
+    ToFloatMatrix(geom_bind * _skin_matrices[j], &_matrices[16 * j]);
+  }
+  ToFloatMatrix(geom_bind, &_matrices[16 * _num_joints]);
+
+  if (facevarying_normals) {
+    _blend_rows.resize(12 * num_points);
+  }
+
+  thread::ParallelForRange(
+      0, num_points, kVertexGrainSize, nthreads,
+      [&](size_t begin, size_t end, int thread_id) {
+        (void)thread_id;
+        for (size_t v = begin; v < end; v++) {
+          SkinVertexLBS(_matrices.data(), &_joint_indices[v * _num_influences],
+                        &_joint_weights[v * _num_influences], _num_influences,
+                        dst->points[v],
+                        vertex_normals ? &dst->normals[v] : nullptr,
+                        facevarying_normals ? &_blend_rows[12 * v] : nullptr);
+        }
+      });
+
+  if (facevarying_normals) {
+    thread::ParallelForRange(
+        0, dst->normals.size(), kVertexGrainSize, nthreads,
+        [&](size_t begin, size_t end, int thread_id) {
+          (void)thread_id;
+          for (size_t i = begin; i < end; i++) {
+            const size_t v = _normal_point_indices[i];
+            dst->normals[i] = TransformDir(&_blend_rows[12 * v], dst->normals[i]);
+            NormalizeVec3(dst->normals[i]);
+          }
+        });
+  }
+
+  return true;
+}
+
+bool DeformRenderMesh(const RenderScene &scene, const size_t mesh_id,
+                      const double t, const SkinningConfig &config,
+                      DeformedMesh *dst, std::string *err) {
+  if (mesh_id >= scene.meshes.size()) {
+    PUSH_ERROR_AND_RETURN(fmt::format("Invalid mesh_id {}. # of meshes = {}",
+                                      mesh_id, scene.meshes.size()));
+  }
+
+  const RenderMesh &mesh = scene.meshes[mesh_id];
+
+  const SkelHierarchy *skel = nullptr;
+  if (mesh.skel_id >= 0) {
+    if (size_t(mesh.skel_id) >= scene.skeletons.size()) {
+      PUSH_ERROR_AND_RETURN(fmt::format("Invalid skel_id {}: {}", mesh.skel_id,
+                                        mesh.abs_path));
+    }
+    skel = &scene.skeletons[size_t(mesh.skel_id)];
+  }
+
+  const Animation *anim = nullptr;
+  if (skel && (skel->anim_id >= 0)) {
+    if (size_t(skel->anim_id) >= scene.animations.size()) {
+      PUSH_ERROR_AND_RETURN(fmt::format("Invalid anim_id {}: {}",
+                                        skel->anim_id, skel->abs_path));
+    }
+    anim = &scene.animations[size_t(skel->anim_id)];
+  }
+
+  SkinningEvaluator evaluator;
+  if (!evaluator.Setup(mesh, skel, config, err)) {
+    return false;
+  }
+
+  return evaluator.Evaluate(anim, t, dst, err);
+}
+
+#undef PushError
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache 2.0
+// Copyright 2024 - Present, Light Transport Entertainment Inc.
+//
+// CPU skinning and blendshape evaluation for RenderMesh.
+//
+// Points(and normals) are deformed in the following order(same as UsdSkel):
+//
+// 1. Add BlendShape offsets(with inbetweens) to rest points.
+// 2. Transform by `geomBindTransform`.
+// 3. Skin with joint matrices(inverse(bindTransform) * jointWorldTransform).
+//
+// Deformed points are in Skeleton space.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "render-data.hh"
+
+namespace tinyusdz {
+namespace tydra {
+
+enum class SkinningMethod {
+  LinearBlend,     // Linear blend skinning(LBS)
+  DualQuaternion,  // Dual quaternion skinning(DQS). Scale of joint matrices
+                   // is ignored.
+};
+
+struct SkinningConfig {
+  SkinningMethod method{SkinningMethod::LinearBlend};
+
+  bool apply_blendshapes{true};
+
+  // Deform RenderMesh::normals. Only 'vertex' or 'facevarying' normals are
+  // supported.
+  bool deform_normals{true};
+
+  // Normalize jointWeights of each vertex so that the sum is 1.
+  bool normalize_weights{true};
+
+  // The number of threads to deform vertices. -1 = use # of system threads.
+  // Worker threads are only spawned when TinyUSDZ is built with
+  // `TINYUSDZ_ENABLE_THREAD`.
+  int num_threads{-1};
+};
+
+struct DeformedMesh {
+  std::vector<vec3> points;  // Same length with RenderMesh::points
+
+  // Same length and variability with RenderMesh::normals. Empty when normals
+  // are not deformed.
+  std::vector<vec3> normals;
+};
+
+///
+/// Compute skinning matrices of joints in `skel` at time `t`.
+///
+/// skinning_matrix = inverse(bindTransform) * jointWorldTransform
+///
+/// Joints which do not have channels in `anim` use restTransforms.
+///
+/// @param[in] skel Skeleton.
+/// @param[in] anim SkelAnimation. Can be nullptr(rest pose).
+/// @param[in] t Timecode.
+/// @param[out] skinning_matrices Skinning matrices indexed by joint id.
+///
+bool ComputeSkinningMatrices(const SkelHierarchy &skel, const Animation *anim,
+                             const double t,
+                             std::vector<value::matrix4d> *skinning_matrices,
+                             std::string *err = nullptr);
+
+///
+/// Deform RenderMesh with its skeleton and BlendShapes.
+///
+/// Per-mesh data(normalized weights, sorted inbetweens, ...) is prepared in
+/// `Setup`, so evaluating many timecodes(e.g. baking a deformed cache) only
+/// costs `Evaluate`.
+///
+/// RenderMesh and SkelHierarchy given to `Setup` must outlive the evaluator.
+///
+class SkinningEvaluator {
+ public:
+  ///
+  /// @param[in] mesh RenderMesh.
+  /// @param[in] skel Skeleton bound to the mesh. nullptr = BlendShapes only.
+  /// @param[in] config Config.
+  ///
+  bool Setup(const RenderMesh &mesh, const SkelHierarchy *skel,
+             const SkinningConfig &config, std::string *err = nullptr);
+
+  ///
+  /// @param[in] anim Animation for joints and BlendShape weights. Can be
+  /// nullptr(rest pose).
+  /// @param[in] t Timecode.
+  /// @param[out] dst Deformed mesh.
+  ///
+  bool Evaluate(const Animation *anim, const double t, DeformedMesh *dst,
+                std::string *err = nullptr);
+
+ private:
+  // Weight(sorted) of BlendShape including the rest shape(weight 0, no
+  // offsets) and the primary shape(weight 1).
+  struct Shape {
+    float weight{0.0f};
+    const std::vector<vec3> *point_offsets{nullptr};
+    const std::vector<vec3> *normal_offsets{nullptr};
+  };
+
+  struct Target {
+    std::string name;  // key in RenderMesh::targets
+    const std::vector<uint32_t> *point_indices{nullptr};
+    std::vector<Shape> shapes;
+  };
+
+  // `k`th offset of `target_id`th Target.
+  struct TargetInfluence {
+    uint32_t target_id;
+    uint32_t k;
+  };
+
+  // Shapes to blend for the weight at the evaluation time: segment [a, b]
+  // which contains the weight and their scales. a = nullptr when the Target
+  // is not active.
+  struct BlendState {
+    const Shape *a{nullptr};
+    const Shape *b{nullptr};
+    float sa{0.0f};
+    float sb{0.0f};
+  };
+
+  void ApplyBlendShapes(const Animation *anim, const double t, int nthreads,
+                        DeformedMesh *dst);
+
+  const RenderMesh *_mesh{nullptr};
+  const SkelHierarchy *_skel{nullptr};
+  SkinningConfig _config;
+
+  // Point index of each normal. Empty for 'vertex' normals.
+  std::vector<uint32_t> _normal_point_indices;
+  bool _has_normals{false};
+
+  // Joint influences. len = num_points * _num_influences.
+  // Vertex with no influence refers `_num_joints`(geomBindTransform only).
+  uint32_t _num_influences{0};
+  uint32_t _num_joints{0};
+  std::vector<uint32_t> _joint_indices;
+  std::vector<float> _joint_weights;
+
+  std::vector<Target> _targets;
+
+  // BlendShape influences of each point(CSR). Influences of point `v` are
+  // [_influence_offsets[v], _influence_offsets[v + 1]) in `_influences`,
+  // ordered by Target, so offsets are summed up in the fixed order.
+  std::vector<size_t> _influence_offsets;
+  std::vector<TargetInfluence> _influences;
+  std::vector<uint32_t> _blendshape_points;  // points with influences
+
+  // Scratch buffers reused across `Evaluate` calls.
+  std::vector<value::matrix4d> _skin_matrices;
+  std::vector<float> _matrices;  // float4x4 * (_num_joints + 1)
+  std::vector<float> _dual_quats;  // (real, dual) * (_num_joints + 1)
+  std::vector<float> _blend_rows;  // Blended 3x3 for facevarying normals.
+  std::vector<BlendState> _blend_states;  // per Target
+};
+
+///
+/// Deform `scene.meshes[mesh_id]` with its Skeleton and the Animation of
+/// the Skeleton at time `t`. Convenient API for SkinningEvaluator.
+///
+bool DeformRenderMesh(const RenderScene &scene, const size_t mesh_id,
+                      const double t, const SkinningConfig &config,
+                      DeformedMesh *dst, std::string *err = nullptr);
+
+}  // namespace tydra
+}  // namespace tinyusdz
@@ -501,8 +501,7 @@ bool GeomPrimvar::get_value(T *dest, std::string *err) const {
       return false;
     }
     
-    if (auto pv =ts.get_samples().at(0).value.as<T>()) {
-      (*dest) = (*pv);
+    if (ts.get_value(0, dest)) {
       return true;
     }
   }
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <stack>
@@ -67,6 +68,7 @@
 #include "primvar.hh"
 #include "str-util.hh"
 #include "stream-reader.hh"
+#include "thread-util.hh"
 #include "tinyusdz.hh"
 #include "usdObj.hh"
 #include "usdShade.hh"
@@ -121,6 +123,9 @@ namespace usda {
 
 constexpr auto kTag = "[USDA]";
 
+// Minimum byte size of a chunk of toplevel Prim blocks parsed by a thread.
+constexpr uint64_t kMinParallelParseChunkSize = 64 * 1024;
+
 namespace {
 
 // intermediate data structure for VariantSet stmt
@@ -290,7 +295,7 @@ class USDAReader::Impl {
   Stage _stage;
 
  public:
-  Impl(StreamReader *sr) { _parser.SetStream(sr); }
+  Impl(StreamReader *sr) : _sr(sr) { _parser.SetStream(sr); }
 
 #if 0 // TODO: Remove
   // Return the flag if the .usda is read from `references`
@@ -1166,6 +1171,19 @@ class USDAReader::Impl {
   ///
   bool Read(const uint32_t state_flags, bool as_primspec);
 
+  ///
+  /// Parse toplevel Prim blocks concurrently as PrimSpec. Must be called after
+  /// magic header and Stage metas are parsed.
+  ///
+  /// Returns false when parallel parsing is not applicable(small input, single
+  /// block, ...) or any chunk reported an error or a warning. The state of
+  /// this reader is not modified in that case, so the caller can continue
+  /// with the serial parser, which also reports diagnostics.
+  ///
+  bool ParseToplevelBlocksParallel(
+      const uint32_t state_flags,
+      const ascii::AsciiParserOption &parser_option);
+
   // std::vector<GPrim> GetGPrims() { return _gprims; }
 
   std::string GetDefaultPrimName() const { return _defaultPrim; }
@@ -1286,6 +1304,14 @@ class USDAReader::Impl {
 
   ascii::AsciiParser _parser;
 
+  StreamReader *_sr{nullptr};
+
+  ///
+  /// Move PrimSpec nodes parsed by `chunk` to this reader, as if they were
+  /// parsed by this reader's parser(Prim indices are offset).
+  ///
+  void AppendPrimSpecNodes(Impl &chunk);
+
 };  // namespace usda
 
 namespace {
@@ -1667,6 +1693,7 @@ bool USDAReader::Impl::Read(const uint32_t state_flags, bool as_primspec) {
   RegisterReconstructCallback<GeomBasisCurves>();
   RegisterReconstructCallback<GeomNurbsCurves>();
   RegisterReconstructCallback<GeomCamera>();
+  RegisterReconstructCallback<PointInstancer>();
 
   RegisterReconstructCallback<Material>();
   RegisterReconstructCallback<Shader>();
@@ -1686,7 +1713,18 @@ bool USDAReader::Impl::Read(const uint32_t state_flags, bool as_primspec) {
 
   _parser.set_primspec_mode(as_primspec);
 
-  bool ret = _parser.Parse(state_flags, ascii_parser_option);
+  bool ret = _parser.ParseHeaderAndStageMetas(state_flags, ascii_parser_option);
+
+  if (ret) {
+    bool parsed{false};
+    if (as_primspec) {
+      parsed = ParseToplevelBlocksParallel(state_flags, ascii_parser_option);
+    }
+
+    if (!parsed) {
+      ret = _parser.ParseToplevelBlocks(state_flags, ascii_parser_option);
+    }
+  }
 
   std::string warn = _parser.GetWarning();
   if (!warn.empty()) {
@@ -1701,6 +1739,127 @@ bool USDAReader::Impl::Read(const uint32_t state_flags, bool as_primspec) {
   return true;
 }
 
+void USDAReader::Impl::AppendPrimSpecNodes(Impl &chunk) {
+  const size_t offset = _prim_nodes.size();
+
+  _prim_nodes.resize(offset + chunk._prim_nodes.size());
+  if (_primspec_nodes.size() < offset) {
+    _primspec_nodes.resize(offset);
+  }
+
+  for (auto &node : chunk._primspec_nodes) {
+    if (node.parent >= 0) {
+      node.parent += int64_t(offset);
+    }
+
+    for (auto &child : node.children) {
+      child += offset;
+    }
+
+    for (auto &variantSet : node.variantNodeMap) {
+      for (auto &variant : variantSet.second) {
+        for (auto &child : variant.second.primChildren) {
+          child += int64_t(offset);
+        }
+      }
+    }
+
+    _primspec_nodes.emplace_back(std::move(node));
+  }
+
+  for (const auto &idx : chunk._toplevel_primspecs) {
+    _toplevel_primspecs.push_back(idx + offset);
+  }
+
+  chunk._primspec_nodes.clear();
+  chunk._toplevel_primspecs.clear();
+}
+
+bool USDAReader::Impl::ParseToplevelBlocksParallel(
+    const uint32_t state_flags, const ascii::AsciiParserOption &parser_option) {
+  const int num_threads = thread::GetNumThreads(_config.num_threads);
+  if ((num_threads <= 1) || !_sr) {
+    return false;
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> blocks;
+  if (!_parser.FindToplevelBlocks(&blocks)) {
+    return false;
+  }
+
+  if (blocks.size() < 2) {
+    return false;
+  }
+
+  // Group contiguous blocks into chunks of similar byte size.
+  const uint64_t total_size = blocks.back().second - blocks.front().first;
+  const size_t num_chunks = size_t((std::min)(
+      uint64_t((std::min)(blocks.size(), size_t(num_threads) * 4)),
+      total_size / kMinParallelParseChunkSize));
+  if (num_chunks < 2) {
+    return false;
+  }
+
+  const uint64_t chunk_size = total_size / num_chunks;
+
+  std::vector<std::pair<uint64_t, uint64_t>> chunks;
+  uint64_t chunk_begin = blocks[0].first;
+  for (size_t i = 0; i < blocks.size(); i++) {
+    if (((blocks[i].second - chunk_begin) >= chunk_size) ||
+        ((i + 1) == blocks.size())) {
+      chunks.push_back(std::make_pair(chunk_begin, blocks[i].second));
+      if ((i + 1) < blocks.size()) {
+        chunk_begin = blocks[i + 1].first;
+      }
+    }
+  }
+
+  DCOUT("Parse " << blocks.size() << " toplevel blocks in " << chunks.size()
+                 << " chunks.");
+
+  std::vector<std::unique_ptr<StreamReader>> chunk_srs(chunks.size());
+  std::vector<std::unique_ptr<Impl>> chunk_readers(chunks.size());
+  std::vector<uint8_t> chunk_ok(chunks.size(), 0);
+
+  thread::ParallelFor(
+      0, chunks.size(), num_threads, [&](size_t i, int thread_id) {
+        (void)thread_id;
+
+        chunk_srs[i].reset(new StreamReader(_sr->data() + chunks[i].first,
+                                            chunks[i].second - chunks[i].first,
+                                            _sr->swap_endian()));
+        chunk_readers[i].reset(new Impl(chunk_srs[i].get()));
+
+        Impl &reader = *chunk_readers[i];
+        reader._config = _config;
+        reader._base_dir = _base_dir;
+        reader.RegisterPrimIdxAssignCallback();
+        reader.RegisterPrimSpecHandler();
+        reader._parser.set_primspec_mode(true);
+
+        bool ret =
+            reader._parser.ParseToplevelBlocks(state_flags, parser_option);
+
+        // Let the serial parser report diagnostics.
+        chunk_ok[i] = ret && reader._parser.GetWarning().empty() &&
+                      reader._warn.empty() && reader._err.empty();
+      });
+
+  for (size_t i = 0; i < chunks.size(); i++) {
+    if (!chunk_ok[i]) {
+      DCOUT("Failed to parse chunk " << i << ". Fallback to serial parsing.");
+      return false;
+    }
+  }
+
+  // Merge in the original order.
+  for (size_t i = 0; i < chunks.size(); i++) {
+    AppendPrimSpecNodes(*chunk_readers[i]);
+  }
+
+  return true;
+}
+
 //
 // --
 //
@@ -18,6 +18,11 @@ struct USDAReaderConfig {
   bool allow_unknown_shader{true};
   bool allow_unknown_apiSchema{true};
   bool strict_allowedToken_check{false};
+
+  // The number of threads to parse toplevel Prim blocks concurrently.
+  // -1 = use # of system threads. Only effective when reading USDA as
+  // PrimSpec(Layer).
+  int num_threads{-1};
 };
 
 ///
@@ -9,20 +9,62 @@
 
 #if !defined(TINYUSDZ_DISABLE_MODULE_USDA_WRITER)
 
-#include <fstream>
+#include <cstdio>
 #include <iostream>
-#include <sstream>
 
 #include "pprinter.hh"
 #include "value-pprint.hh"
 #include "tinyusdz.hh"
 #include "io-util.hh"
+#include "text-sink.hh"
 
 namespace tinyusdz {
 namespace usda {
 
 namespace {
 
+#ifdef _WIN32
+FILE *OpenFileForWrite(const std::wstring &filename) {
+  FILE *fp = nullptr;
+  errno_t fperr = _wfopen_s(&fp, filename.c_str(), L"wb");
+  if (fperr != 0) {
+    return nullptr;
+  }
+  return fp;
+}
+#endif
+
+FILE *OpenFileForWrite(const std::string &filename) {
+#ifdef _WIN32
+  return OpenFileForWrite(io::UTF8ToWchar(filename));
+#else
+  return fopen(filename.c_str(), "wb");
+#endif
+}
+
+// Stream USDA to `fp` without materializing the whole content in memory.
+bool WriteStage(FILE *fp, const Stage &stage, const std::string &filename,
+                std::string *err) {
+  bool ok{false};
+  {
+    TextSink w(fp);
+    stage.ExportTo(w);
+    ok = w.flush();
+  }
+
+  if (fclose(fp) != 0) {
+    ok = false;
+  }
+
+  if (!ok) {
+    if (err) {
+      (*err) += "File write error: " + filename + "\n";
+    }
+    return false;
+  }
+
+  return true;
+}
 
 }  // namespace
 
@@ -31,10 +73,16 @@ bool SaveAsUSDA(const std::string &filename, const Stage &stage,
 
   (void)warn;
 
-  // TODO: Handle warn and err on export.
-  std::string s = stage.ExportToString();
+  FILE *fp = OpenFileForWrite(filename);
+  if (!fp) {
+    if (err) {
+      (*err) += "File open error for writing : " + filename + "\n";
+    }
+    return false;
+  }
 
-  if (!io::WriteWholeFile(filename, reinterpret_cast<const unsigned char *>(s.data()), s.size(), err)) {
+  // TODO: Handle warn and err on export.
+  if (!WriteStage(fp, stage, filename, err)) {
     return false;
   }
 
@@ -49,10 +97,16 @@ bool SaveAsUSDA(const std::wstring &filename, const Stage &stage,
 
   (void)warn;
 
-  // TODO: Handle warn and err on export.
-  std::string s = stage.ExportToString();
+  FILE *fp = OpenFileForWrite(filename);
+  if (!fp) {
+    if (err) {
+      (*err) += "File open error for writing : " + io::WcharToUTF8(filename) + "\n";
+    }
+    return false;
+  }
 
-  if (!io::WriteWholeFile(filename, reinterpret_cast<const unsigned char *>(s.data()), s.size(), err)) {
+  // TODO: Handle warn and err on export.
+  if (!WriteStage(fp, stage, io::WcharToUTF8(filename), err)) {
     return false;
   }
 
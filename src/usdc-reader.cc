@@ -218,6 +218,36 @@ static bool IsUnregisteredValueType(const std::string &typeName)
 
 }
 
+// Cast the type of `default` value to the type specified by `typeName` as
+// much as possible.
+static void CastToTypeName(const std::string &reqTy, value::Value &value) {
+  if (value.type_id() == value::TypeTraits<value::ValueBlock>::type_id()) {
+    // nothing to do
+    return;
+  }
+
+  std::string scalarTy = value.type_name();
+
+  if (reqTy.compare(scalarTy) != 0) {
+
+    // Some inlined? value uses less accuracy type(e.g. `half3`) than
+    // typeName(e.g. `float3`) Use type specified in `typeName` as much as
+    // possible.
+    bool ret = value::UpcastType(reqTy, value);
+    if (ret) {
+      DCOUT(fmt::format("Upcast type from {} to {}.", scalarTy, reqTy));
+    }
+
+    // Optionally, cast to role type(in crate data, `typeName` uses role typename(e.g. `color3f`), whereas stored data uses base typename(e.g. VEC3F)
+    scalarTy = value.type_name();
+    if (value::RoleTypeCast(value::GetTypeId(reqTy), value)) {
+      DCOUT(fmt::format("Casted to Role type {} from type {}.", reqTy, scalarTy));
+    } else {
+      // Its ok.
+    }
+  }
+}
+
 class USDCReader::Impl {
  public:
   Impl(StreamReader *sr, const USDCReaderConfig &config) : _sr(sr) {
@@ -226,8 +256,12 @@ class USDCReader::Impl {
   }
 
   ~Impl() {
-    delete crate_reader;
-    crate_reader = nullptr;
+    // Deferred values may still hold `crate_reader`.
+    crate_reader.reset();
+  }
+
+  void set_data_owner(const std::shared_ptr<const void> &owner) {
+    _data_owner = owner;
   }
 
   void set_reader_config(const USDCReaderConfig &config) {
@@ -260,6 +294,22 @@ class USDCReader::Impl {
   bool ParseProperty(const SpecType specType,
                      const crate::FieldValuePairVector &fvs, Property *prop);
 
+  ///
+  /// Create loaders for deferred `default` value and `timeSamples`
+  /// (lazy value unpacking).
+  ///
+  primvar::ValueLoader MakeDeferredValueLoader(const crate::ValueRep &rep,
+                                               const std::string &reqTy);
+  primvar::TimeSamplesLoader MakeDeferredTimeSamplesLoader(
+      const crate::ValueRep &rep);
+
+  ///
+  /// Create the provider of the location of deferred array `default` value
+  /// in the input memory(see `PrimVar::get_array_view`).
+  ///
+  primvar::ArrayViewProvider MakeDeferredArrayViewProvider(
+      const crate::ValueRep &rep);
+
   ///
   /// Parse Prim spec from FieldValuePairs
   ///
@@ -390,7 +440,18 @@ class USDCReader::Impl {
 
   bool AddVariantToPrimNode(int32_t prim_idx, const value::Value &variant);
 
-  crate::CrateReader *crate_reader{nullptr};
+  // Shared with deferred value loaders when `lazy_value_unpack` is enabled.
+  std::shared_ptr<crate::CrateReader> crate_reader;
+
+  // Owner of the memory of `_sr`(optional). See USDCReader::set_data_owner.
+  std::shared_ptr<const void> _data_owner;
+
+  // Crate data referenced by deferred value loaders(lazy value unpacking).
+  // Loaders may outlive the StreamReader passed to USDCReader, so the memory
+  // is kept alive through `_lazy_data_owner`(= `_data_owner`).
+  std::shared_ptr<const void> _lazy_data_owner;
+  const uint8_t *_lazy_data_addr{nullptr};
+  uint64_t _lazy_data_size{0};
 
   StreamReader *_sr = nullptr;
   std::string _err;
@@ -892,6 +953,105 @@ bool USDCReader::Impl::BuildPropertyMap(const std::vector<size_t> &pathIndices,
 }
 
 
+primvar::ValueLoader USDCReader::Impl::MakeDeferredValueLoader(
+    const crate::ValueRep &rep, const std::string &reqTy) {
+  std::shared_ptr<const crate::CrateReader> reader = crate_reader;
+  std::shared_ptr<const void> owner = _lazy_data_owner;
+  const uint8_t *addr = _lazy_data_addr;
+  uint64_t size = _lazy_data_size;
+  bool swap_endian = _sr->swap_endian();
+
+  return [reader, owner, addr, size, swap_endian, rep, reqTy](
+             value::Value *dst, std::string *err) {
+    if (!reader || !owner || !addr) {
+      if (err) {
+        (*err) += "Crate data for the deferred value is not available.\n";
+      }
+      return false;
+    }
+
+    StreamReader sr(addr, size, swap_endian);
+    crate::CrateValue cv;
+    if (!reader->UnpackDeferredValue(&sr, rep, &cv, err)) {
+      return false;
+    }
+
+    (*dst) = std::move(cv.get_raw());
+    if (!reqTy.empty()) {
+      CastToTypeName(reqTy, *dst);
+    }
+    return true;
+  };
+}
+
+primvar::TimeSamplesLoader USDCReader::Impl::MakeDeferredTimeSamplesLoader(
+    const crate::ValueRep &rep) {
+  std::shared_ptr<const crate::CrateReader> reader = crate_reader;
+  std::shared_ptr<const void> owner = _lazy_data_owner;
+  const uint8_t *addr = _lazy_data_addr;
+  uint64_t size = _lazy_data_size;
+  bool swap_endian = _sr->swap_endian();
+
+  return [reader, owner, addr, size, swap_endian, rep](
+             value::TimeSamples *dst, std::string *err) {
+    if (!reader || !owner || !addr) {
+      if (err) {
+        (*err) += "Crate data for the deferred TimeSamples is not available.\n";
+      }
+      return false;
+    }
+
+    StreamReader sr(addr, size, swap_endian);
+    crate::CrateValue cv;
+    if (!reader->UnpackDeferredValue(&sr, rep, &cv, err)) {
+      return false;
+    }
+
+    if (auto pv = cv.get_raw().as<value::TimeSamples>()) {
+      (*dst) = std::move(*pv);
+      return true;
+    }
+
+    if (err) {
+      (*err) += "`timeSamples` is not TimeSamples data.\n";
+    }
+    return false;
+  };
+}
+
+primvar::ArrayViewProvider USDCReader::Impl::MakeDeferredArrayViewProvider(
+    const crate::ValueRep &rep) {
+  std::shared_ptr<const crate::CrateReader> reader = crate_reader;
+  std::shared_ptr<const void> owner = _lazy_data_owner;
+  const uint8_t *addr = _lazy_data_addr;
+  uint64_t size = _lazy_data_size;
+  bool swap_endian = _sr->swap_endian();
+
+  return [reader, owner, addr, size, swap_endian,
+          rep](primvar::RawArrayView *dst) {
+    if (!reader || !owner || !addr || !dst) {
+      return false;
+    }
+
+    StreamReader sr(addr, size, swap_endian);
+    const uint8_t *data{nullptr};
+    uint64_t n{0};
+    uint32_t type_id{value::TYPE_ID_INVALID};
+    size_t element_size{0};
+    if (!reader->GetArrayDataLocation(&sr, rep, &data, &n, &type_id,
+                                      &element_size)) {
+      return false;
+    }
+
+    dst->data = data;
+    dst->size = size_t(n);
+    dst->type_id = type_id;
+    dst->element_size = element_size;
+    dst->owner = owner;
+    return true;
+  };
+}
+
 /// Property fieldSet example
 ///
 ///   specTyppe = SpecTypeAttribute
@@ -935,6 +1095,7 @@ bool USDCReader::Impl::ParseProperty(const SpecType spec_type,
   Attribute attr;
 
   value::Value defaultValue;
+  nonstd::optional<crate::ValueRep> deferredDefault;
   Relationship rel;
 
   // for attribute
@@ -997,9 +1158,16 @@ bool USDCReader::Impl::ParseProperty(const SpecType spec_type,
       //propType = Property::Type::Attrib;
 
       // Set scalar(non-timesampled) value
+      hasDefault = true;
+
+      if (fv.second.is_deferred()) {
+        // Unpacked on demand.
+        deferredDefault = fv.second.get_deferred_rep();
+        continue;
+      }
+
       // TODO: Easier CrateValue to Attribute.var conversion
       defaultValue = fv.second.get_raw();
-      hasDefault = true;
 
       // TODO: Handle UnregisteredValue in crate-reader.cc
       // UnregisteredValue is represented as string.
@@ -1022,7 +1190,10 @@ bool USDCReader::Impl::ParseProperty(const SpecType spec_type,
 
       hasTimeSamples = true;
 
-      if (auto pv = fv.second.get_value<value::TimeSamples>()) {
+      if (fv.second.is_deferred()) {
+        var.set_deferred_timesamples(
+            MakeDeferredTimeSamplesLoader(fv.second.get_deferred_rep()));
+      } else if (auto pv = fv.second.get_value<value::TimeSamples>()) {
         var.set_timesamples(pv.value());
       } else {
         PUSH_ERROR_AND_RETURN_TAG(kTag,
@@ -1097,7 +1268,10 @@ bool USDCReader::Impl::ParseProperty(const SpecType spec_type,
         auto qual = std::get<0>(ps[0]);
         auto items = std::get<1>(ps[0]);
 
-        if (items.size() == 1) {
+        if (items.empty() && p.IsExplicit()) {
+          // `rel myrel = None` is encoded as explicit empty ListOp.
+          rel.set_blocked();
+        } else if (items.size() == 1) {
           // Single
           const Path path = items[0];
 
@@ -1254,6 +1428,14 @@ bool USDCReader::Impl::ParseProperty(const SpecType spec_type,
             kTag, "`comment` must be type `string`, but got type `"
                       << fv.second.type_name() << "`");
       }
+    } else if (fv.first == "displayName") {
+      if (auto pv = fv.second.get_value<std::string>()) {
+        meta.displayName = pv.value();
+      } else {
+        PUSH_ERROR_AND_RETURN_TAG(
+            kTag, "`displayName` must be type `string`, but got type `"
+                      << fv.second.type_name() << "`");
+      }
 
     } else if (fv.first == "colorSpace") {
       if (auto pv = fv.second.get_value<value::token>()) {
@@ -1305,33 +1487,15 @@ bool USDCReader::Impl::ParseProperty(const SpecType spec_type,
 
   // Do role type cast for default value.
   // (TODO: do role type cast for timeSamples?)
-  if (hasDefault) {
+  if (hasDefault && deferredDefault) {
+    // Type cast is done in the loader.
+    var.set_deferred_value(
+        MakeDeferredValueLoader(deferredDefault.value(),
+                                typeName ? typeName.value().str() : ""),
+        MakeDeferredArrayViewProvider(deferredDefault.value()));
+  } else if (hasDefault) {
     if (typeName) {
-      if (defaultValue.type_id() == value::TypeTraits<value::ValueBlock>::type_id()) {
-        // nothing to do
-      } else {
-        std::string reqTy = typeName.value().str();
-        std::string scalarTy = defaultValue.type_name();
-
-        if (reqTy.compare(scalarTy) != 0) {
-
-          // Some inlined? value uses less accuracy type(e.g. `half3`) than
-          // typeName(e.g. `float3`) Use type specified in `typeName` as much as
-          // possible.
-          bool ret = value::UpcastType(reqTy, defaultValue);
-          if (ret) {
-            DCOUT(fmt::format("Upcast type from {} to {}.", scalarTy, reqTy));
-          }
-
-          // Optionally, cast to role type(in crate data, `typeName` uses role typename(e.g. `color3f`), whereas stored data uses base typename(e.g. VEC3F)
-          scalarTy = defaultValue.type_name();
-          if (value::RoleTypeCast(value::GetTypeId(reqTy), defaultValue)) {
-            DCOUT(fmt::format("Casted to Role type {} from type {}.", reqTy, scalarTy));
-          } else {
-            // Its ok.
-          }
-        }
-      }
+      CastToTypeName(typeName.value().str(), defaultValue);
     }
     var.set_value(defaultValue);
 
@@ -2795,9 +2959,10 @@ bool USDCReader::Impl::ReconstructPrimSpecNode(int parent, int current, int leve
 
   if ((spec.spec_type == SpecType::Attribute) ||
       (spec.spec_type == SpecType::Relationship)) {
-    if (_prim_table.count(parent)) {
+    if (_prim_table.count(parent) || _variantPrimSpecs.count(parent)) {
       // This node is a Properties node. These are processed in
-      // ReconstructPrim(), so nothing to do here.
+      // BuildPropertyMap() of the parent PrimSpec(or Variant), so nothing to
+      // do here.
       return true;
     }
   }
@@ -2950,6 +3115,7 @@ bool USDCReader::Impl::ReconstructPrimSpecNode(int parent, int current, int leve
 #else
         primspec.typeName() = primTypeName;
         primspec.name() = prim_name;
+        primspec.specifier() = specifier.value();
 
         prim::PropertyMap props;
         if (!BuildPropertyMap(node.GetChildren(), psmap, &props)) {
@@ -3170,6 +3336,7 @@ bool USDCReader::Impl::ReconstructPrimSpecNode(int parent, int current, int leve
         PrimSpec variantPrimSpec;
         variantPrimSpec.typeName() = primTypeName;
         variantPrimSpec.name() = prim_name;
+        variantPrimSpec.specifier() = specifier.value();
 
         prim::PropertyMap props;
         if (!BuildPropertyMap(node.GetChildren(), psmap, &props)) {
@@ -3660,7 +3827,9 @@ bool USDCReader::Impl::ReconstructPrimSpecRecursively(
       if (vs.name.empty()) {
         vs.name = variantSetName;
       }
+      vs.variantSet[variantName].specifier() = vp.specifier();
       vs.variantSet[variantName].metas() = vp.metas();
+      vs.variantSet[variantName].props() = vp.props();
       DCOUT("# of primChildren = " << vp.children().size());
       vs.variantSet[variantName].children() = std::move(vp.children());
 
@@ -3753,15 +3922,23 @@ bool USDCReader::Impl::ToLayer(Layer *layer) {
 }
 
 bool USDCReader::Impl::ReadUSDC() {
-  if (crate_reader) {
-    delete crate_reader;
-  }
+  crate_reader.reset();
+  _lazy_data_owner.reset();
+  _lazy_data_addr = nullptr;
+  _lazy_data_size = 0;
 
   // TODO: Setup CrateReaderConfig.
   crate::CrateReaderConfig config;
 
   // Transfer settings
   config.numThreads = _config.numThreads;
+  // Deferred values must keep the input memory alive, so lazy value unpacking
+  // requires the data owner. Fall back to eager unpacking without copying the
+  // whole input.
+  config.lazyValueUnpack = _config.lazy_value_unpack && bool(_data_owner);
+  if (_config.lazy_value_unpack && !_data_owner) {
+    DCOUT("Data owner is not set. Disable lazy value unpacking.");
+  }
 
   size_t sz_mb = _config.kMaxAllowedMemoryInMB;
   if (sizeof(size_t) == 4) {
@@ -3774,7 +3951,18 @@ bool USDCReader::Impl::ReadUSDC() {
     config.maxMemoryBudget = _config.kMaxAllowedMemoryInMB * 1024ull * 1024ull;
   }
 
-  crate_reader = new crate::CrateReader(_sr, config);
+  crate_reader = std::make_shared<crate::CrateReader>(_sr, config);
+
+  if (config.lazyValueUnpack) {
+    if (!_sr || !_sr->data()) {
+      PUSH_ERROR_AND_RETURN_TAG(kTag, "Invalid StreamReader.");
+    }
+
+    // Reference the memory directly(e.g. memory-mapped file).
+    _lazy_data_owner = _data_owner;
+    _lazy_data_addr = _sr->data();
+    _lazy_data_size = _sr->size();
+  }
 
   _warn.clear();
   _err.clear();
@@ -3792,38 +3980,8 @@ bool USDCReader::Impl::ReadUSDC() {
   }
 
   // Read known sections
-
-  if (!crate_reader->ReadTokens()) {
-    _warn = crate_reader->GetWarning();
-    _err = crate_reader->GetError();
-    return false;
-  }
-
-  if (!crate_reader->ReadStrings()) {
-    _warn = crate_reader->GetWarning();
-    _err = crate_reader->GetError();
-    return false;
-  }
-
-  if (!crate_reader->ReadFields()) {
-    _warn = crate_reader->GetWarning();
-    _err = crate_reader->GetError();
-    return false;
-  }
-
-  if (!crate_reader->ReadFieldSets()) {
-    _warn = crate_reader->GetWarning();
-    _err = crate_reader->GetError();
-    return false;
-  }
-
-  if (!crate_reader->ReadPaths()) {
-    _warn = crate_reader->GetWarning();
-    _err = crate_reader->GetError();
-    return false;
-  }
-
-  if (!crate_reader->ReadSpecs()) {
+  // (independent sections are decoded concurrently when numThreads > 1)
+  if (!crate_reader->ReadKnownSections()) {
     _warn = crate_reader->GetWarning();
     _err = crate_reader->GetError();
     return false;
@@ -3870,6 +4028,10 @@ const USDCReaderConfig USDCReader::get_reader_config() const {
   return impl_->get_reader_config();
 }
 
+void USDCReader::set_data_owner(const std::shared_ptr<const void> &owner) {
+  impl_->set_data_owner(owner);
+}
+
 bool USDCReader::ReconstructStage(Stage *stage) {
   DCOUT("Reconstruct Stage.");
   return impl_->ReconstructStage(stage);
@@ -3911,6 +4073,10 @@ const USDCReaderConfig USDCReader::get_reader_config() const {
   return USDCReaderConfig();
 }
 
+void USDCReader::set_data_owner(const std::shared_ptr<const void> &owner) {
+  (void)owner;
+}
+
 bool USDCReader::ReconstructStage(Stage *stage) {
   (void)scene;
   DCOUT("Reconstruct Stage.");
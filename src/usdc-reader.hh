@@ -4,6 +4,8 @@
 //
 #pragma once
 
+#include <memory>
+
 #include "stream-reader.hh"
 #include "tinyusdz.hh"
 
@@ -27,6 +29,13 @@ struct USDCReaderConfig {
   bool allow_unknown_apiSchemas = true;
 
   bool strict_allowedToken_check = false;
+
+  // Keep large attribute values(numeric arrays and timeSamples) packed and
+  // decode them on the first access to the value(lazy value unpacking).
+  // Deferred values reference the input memory, so this requires the data
+  // owner given with `USDCReader::set_data_owner`. Values are decoded eagerly
+  // when the data owner is not set.
+  bool lazy_value_unpack = false;
 };
 
 class USDCReader {
@@ -38,6 +47,14 @@ class USDCReader {
   void set_reader_config(const USDCReaderConfig &config);
   const USDCReaderConfig get_reader_config() const;
 
+  ///
+  /// Set the object which owns the memory of StreamReader(e.g. memory-mapped
+  /// file handle).
+  /// Required for lazy value unpacking: deferred values reference the memory
+  /// directly and keep it alive through `owner`.
+  ///
+  void set_data_owner(const std::shared_ptr<const void> &owner);
+
   bool ReadUSDC();
 
   bool ReconstructStage(Stage *stage);
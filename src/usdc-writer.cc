@@ -33,16 +33,24 @@
 
 #endif
 
-
-#include <fstream>
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_map>
 
 #include "crate-format.hh"
+#include "crate-writer.hh"
 #include "io-util.hh"
 #include "lz4-compression.hh"
+#include "pprinter.hh"
+#include "prim-types.hh"
+#include "thread-util.hh"
 #include "token-type.hh"
 
+#if defined(TINYUSDZ_WITH_TYDRA)
+#include "tydra/scene-access.hh"
+#endif
+
 #include "common-macros.inc"
 
 namespace tinyusdz {
@@ -50,8 +58,6 @@ namespace usdc {
 
 namespace {
 
-constexpr size_t kSectionNameMaxLength = 15;
-
 #ifdef _WIN32
 std::wstring UTF8ToWchar(const std::string &str) {
   int wstr_size =
@@ -61,417 +67,1889 @@ std::wstring UTF8ToWchar(const std::string &str) {
                       int(wstr.size()));
   return wstr;
 }
+#endif
+
+using CrateTypeId = crate::CrateDataTypeId;
+
+// Payload of ValueRep is 48bit.
+constexpr uint64_t kMaxValueRepPayload = (1ull << 48) - 1;
+
+// Header(magic + version + TOC offset) is 88 bytes.
+constexpr size_t kHeaderSize = 88;
 
-#if 0
-std::string WcharToUTF8(const std::wstring &wstr) {
-  int str_size = WideCharToMultiByte(CP_UTF8, 0, wstr.data(), int(wstr.size()),
-                                     nullptr, 0, nullptr, nullptr);
-  std::string str(size_t(str_size), 0);
-  WideCharToMultiByte(CP_UTF8, 0, wstr.data(), int(wstr.size()), &str[0],
-                      int(str.size()), nullptr, nullptr);
-  return str;
+void AppendBytes(const void *src, const size_t n, std::vector<uint8_t> *dst) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(src);
+  dst->insert(dst->end(), p, p + n);
 }
-#endif
-#endif
 
-struct Section {
-  Section() { memset(this, 0, sizeof(*this)); }
-  Section(char const *name, int64_t start, int64_t size);
-  char name[kSectionNameMaxLength + 1];
-  int64_t start, size;  // byte offset to section info and its data size
-};
+void AppendU32(const uint32_t v, std::vector<uint8_t> *dst) {
+  AppendBytes(&v, sizeof(uint32_t), dst);
+}
 
-//
-// TOC = list of sections.
-//
-struct TableOfContents {
-  // Section const *GetSection(SectionName) const;
-  // int64_t GetMinimumSectionStart() const;
-  std::vector<Section> sections;
-};
+void AppendU64(const uint64_t v, std::vector<uint8_t> *dst) {
+  AppendBytes(&v, sizeof(uint64_t), dst);
+}
 
-//struct Field {
-//  // FIXME(syoyo): Do we need 4 bytes padding as done in pxrUSD?
-//  // uint32_t padding_;
-//
-//  crate::TokenIndex token_index;
-//  crate::ValueRep value_rep;
-//};
-
-#if 0
-// For unordered_map
-
-// https://stackoverflow.com/questions/8513911/how-to-create-a-good-hash-combine-with-64-bit-output-inspired-by-boosthash-co
-// From CityHash code.
-template <class T>
-inline void hash_combine(std::size_t &seed, const T &v) {
-#ifdef __wasi__  // 32bit platform
-  // Use boost version.
-  std::hash<T> hasher;
-  seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-#else
-  std::hash<T> hasher;
-  const uint64_t kMul = 0x9ddfea08eb382d69ULL;
-  std::size_t a = (hasher(v) ^ seed) * kMul;
-  a ^= (a >> 47);
-  std::size_t b = (seed ^ a) * kMul;
-  b ^= (b >> 47);
-  seed = b * kMul;
-#endif
+void AppendI64(const int64_t v, std::vector<uint8_t> *dst) {
+  AppendBytes(&v, sizeof(int64_t), dst);
 }
 
-struct PathHasher {
-  size_t operator()(const Path &path) const {
-    size_t seed = std::hash<std::string>()(path.GetPrimPart());
-    hash_combine(seed, std::hash<std::string>()(path.GetPropPart()));
-    hash_combine(seed, std::hash<std::string>()(path.GetLocalPart()));
-    hash_combine(seed, std::hash<bool>()(path.IsValid()));
+// `# of elements(uint64)` + raw data
+template <typename T>
+void AppendRawArray(const std::vector<T> &v, std::vector<uint8_t> *dst) {
+  AppendU64(uint64_t(v.size()), dst);
+  if (v.size()) {
+    AppendBytes(v.data(), sizeof(T) * v.size(), dst);
+  }
+}
 
-    return seed;
+uint64_t HashBytes(const uint8_t *data, const size_t n) {
+  // FNV-1a
+  uint64_t h = 14695981039346656037ull;
+  for (size_t i = 0; i < n; i++) {
+    h ^= data[i];
+    h *= 1099511628211ull;
   }
-};
+  return h;
+}
 
-struct PathKeyEqual {
-  bool operator()(const Path &lhs, const Path &rhs) const {
-    bool ret = lhs.GetPrimPart() == rhs.GetPrimPart();
-    ret &= lhs.GetPropPart() == rhs.GetPropPart();
-    ret &= lhs.GetLocalPart() == rhs.GetLocalPart();
-    ret &= lhs.IsValid() == rhs.IsValid();
+template <typename T>
+const std::vector<T> *AsArray(const value::Value &v) {
+  return v.as<std::vector<T>>();
+}
 
-    return ret;
+///
+/// Encode numeric array(int, uint, int64, uint64, half, float, double and
+/// timecode) in Crate format. Does not touch the state of Writer, so can be
+/// called from worker threads.
+///
+/// @param[out] crate_type Crate data type of the array.
+/// @return false when `v` is not a numeric array or failed to encode.
+///
+bool EncodeNumericArray(const value::Value &v, const bool compress,
+                        std::vector<uint8_t> *dst, int32_t *crate_type,
+                        bool *compressed, std::string *err) {
+  const uint32_t tyid = v.underlying_type_id();
+  if (!(tyid & value::TYPE_ID_1D_ARRAY_BIT)) {
+    return false;
   }
-};
 
-struct FieldHasher {
-  size_t operator()(const Field &field) const {
-    size_t seed = std::hash<uint32_t>()(field.token_index.value);
-    hash_combine(seed, std::hash<uint64_t>()(field.value_rep.GetData()));
+  switch (tyid & (~value::TYPE_ID_1D_ARRAY_BIT)) {
+    case value::TYPE_ID_INT32: {
+      const std::vector<int32_t> *pv = AsArray<int32_t>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_INT);
+      return crate::EncodeIntArray(pv->data(), pv->size(), compress, dst,
+                                   compressed, err);
+    }
+    case value::TYPE_ID_UINT32: {
+      const std::vector<uint32_t> *pv = AsArray<uint32_t>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_UINT);
+      return crate::EncodeIntArray(pv->data(), pv->size(), compress, dst,
+                                   compressed, err);
+    }
+    case value::TYPE_ID_INT64: {
+      const std::vector<int64_t> *pv = AsArray<int64_t>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_INT64);
+      return crate::EncodeIntArray(pv->data(), pv->size(), compress, dst,
+                                   compressed, err);
+    }
+    case value::TYPE_ID_UINT64: {
+      const std::vector<uint64_t> *pv = AsArray<uint64_t>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_UINT64);
+      return crate::EncodeIntArray(pv->data(), pv->size(), compress, dst,
+                                   compressed, err);
+    }
+    case value::TYPE_ID_HALF: {
+      const std::vector<value::half> *pv = AsArray<value::half>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_HALF);
+      return crate::EncodeFloatArray(pv->data(), pv->size(), compress, dst,
+                                     compressed, err);
+    }
+    case value::TYPE_ID_FLOAT: {
+      const std::vector<float> *pv = AsArray<float>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_FLOAT);
+      return crate::EncodeFloatArray(pv->data(), pv->size(), compress, dst,
+                                     compressed, err);
+    }
+    case value::TYPE_ID_DOUBLE: {
+      const std::vector<double> *pv = AsArray<double>(v);
+      if (!pv) return false;
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_DOUBLE);
+      return crate::EncodeFloatArray(pv->data(), pv->size(), compress, dst,
+                                     compressed, err);
+    }
+    case value::TYPE_ID_TIMECODE: {
+      // No TimeCode type support in CrateReader. Store as double[].
+      const std::vector<value::timecode> *pv = AsArray<value::timecode>(v);
+      if (!pv) return false;
+      std::vector<double> dv(pv->size());
+      for (size_t i = 0; i < pv->size(); i++) {
+        dv[i] = (*pv)[i].value;
+      }
+      (*crate_type) = int32_t(CrateTypeId::CRATE_DATA_TYPE_DOUBLE);
+      return crate::EncodeFloatArray(dv.data(), dv.size(), compress, dst,
+                                     compressed, err);
+    }
+    default:
+      break;
+  }
+
+  return false;
+}
 
-    return seed;
+// # of elements of numeric array. 0 for non numeric array.
+size_t NumericArraySize(const value::Value &v) {
+  const uint32_t tyid = v.underlying_type_id();
+  if (!(tyid & value::TYPE_ID_1D_ARRAY_BIT)) {
+    return 0;
   }
-};
 
-struct FieldKeyEqual {
-  bool operator()(const Field &lhs, const Field &rhs) const {
-    bool ret = lhs.token_index == rhs.token_index;
-    ret &= lhs.value_rep == rhs.value_rep;
+#define NUMERIC_ARRAY_SIZE(__tyid, __ty)  \
+  case value::__tyid: {                   \
+    const std::vector<__ty> *pv = AsArray<__ty>(v); \
+    return pv ? pv->size() : 0;           \
+  }
 
-    return ret;
+  switch (tyid & (~value::TYPE_ID_1D_ARRAY_BIT)) {
+    NUMERIC_ARRAY_SIZE(TYPE_ID_INT32, int32_t)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_UINT32, uint32_t)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_INT64, int64_t)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_UINT64, uint64_t)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_HALF, value::half)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_FLOAT, float)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_DOUBLE, double)
+    NUMERIC_ARRAY_SIZE(TYPE_ID_TIMECODE, value::timecode)
+    default:
+      break;
   }
-};
 
-struct FieldSetHasher {
-  size_t operator()(const std::vector<crate::FieldIndex> &fieldset) const {
-    if (fieldset.empty()) {
-      return 0;
-    }
+#undef NUMERIC_ARRAY_SIZE
 
-    size_t seed = std::hash<uint32_t>()(fieldset[0].value);
-    for (size_t i = 1; i < fieldset.size(); i++) {
-      hash_combine(seed, std::hash<uint32_t>()(fieldset[i].value));
+  return 0;
+}
+
+// Split Prim part of an absolute Path into elements.
+// e.g. "/A/B{vs=var}C" -> ["A", "B", "{vs=var}", "C"]
+bool SplitPrimPart(const std::string &prim_part,
+                   std::vector<std::string> *elems) {
+  if (prim_part.empty() || (prim_part[0] != '/')) {
+    return false;
+  }
+
+  std::string cur;
+  for (size_t i = 1; i < prim_part.size(); i++) {
+    const char c = prim_part[i];
+    if (c == '/') {
+      if (cur.size()) {
+        elems->push_back(cur);
+        cur.clear();
+      }
+    } else if (c == '{') {
+      if (cur.size()) {
+        elems->push_back(cur);
+        cur.clear();
+      }
+      size_t end = prim_part.find('}', i);
+      if (end == std::string::npos) {
+        return false;
+      }
+      elems->push_back(prim_part.substr(i, end - i + 1));
+      i = end;
+    } else {
+      cur += c;
     }
+  }
 
-    return seed;
+  if (cur.size()) {
+    elems->push_back(cur);
   }
-};
-#endif
 
-class Packer {
+  return true;
+}
+
+class Writer {
  public:
-  crate::TokenIndex AddToken(const Token &token);
-  crate::StringIndex AddString(const std::string &str);
-  crate::PathIndex AddPath(const Path &path);
-  crate::FieldIndex AddField(const crate::Field &field);
-  crate::FieldSetIndex AddFieldSet(
-      const std::vector<crate::FieldIndex> &field_indices);
+  Writer(const Layer &layer, const USDCWriterConfig &config)
+      : layer_(layer), config_(config) {}
 
-  const std::vector<Token> &GetTokens() const { return tokens_; }
+  const std::string &GetError() const { return err_; }
+  const std::string &GetWarning() const { return warn_; }
 
- private:
-  std::unordered_map<Token, crate::TokenIndex, TokenHasher, TokenKeyEqual>
-      token_to_index_map;
-  std::unordered_map<std::string, crate::StringIndex> string_to_index_map;
-  std::unordered_map<Path, crate::PathIndex, crate::PathHasher, crate::PathKeyEqual>
-      path_to_index_map;
-  std::unordered_map<crate::Field, crate::FieldIndex, crate::FieldHasher, crate::FieldKeyEqual>
-      field_to_index_map;
-  std::unordered_map<std::vector<crate::FieldIndex>, crate::FieldSetIndex,
-                     crate::FieldSetHasher>
-      fieldset_to_index_map;
-
-  std::vector<Token> tokens_;
-  std::vector<std::string> strings_;
-  std::vector<Path> paths_;
-  std::vector<crate::Field> fields_;
-  std::vector<crate::FieldIndex>
-      fieldsets_;  // flattened 1D array of FieldSets. Each span is terminated
-                   // by Index()(= ~0)
-};
+  bool Write(std::vector<uint8_t> *output) {
+    out_.assign(kHeaderSize, 0);
+
+    // Token 0 is reserved(as done in pxrUSD), so that an element token of
+    // property path never becomes 0(property path uses negative token index).
+    AddToken(";-)");
+
+    if (!CollectSpecs()) {
+      return false;
+    }
 
-#if 0 // not used atm.
-crate::TokenIndex Packer::AddToken(const Token &token) {
-  if (token_to_index_map.count(token)) {
-    return token_to_index_map[token];
+    if (!EncodeLargeArrays()) {
+      return false;
+    }
+
+    for (const SpecEntry &spec : specs_) {
+      std::vector<uint32_t> fields;
+      if (!BuildFields(spec, &fields)) {
+        return false;
+      }
+      spec_fieldsets_.push_back(AddFieldSet(fields));
+    }
+
+    // Value data is done. Write structural sections.
+    std::vector<crate::Section> sections;
+
+#define WRITE_SECTION(__name, __fn)                             \
+  {                                                             \
+    int64_t start = int64_t(out_.size());                       \
+    if (!__fn()) {                                              \
+      PUSH_ERROR_AND_RETURN("Failed to write " __name " section."); \
+    }                                                           \
+    sections.emplace_back(crate::Section(                       \
+        __name, start, int64_t(out_.size()) - start));          \
   }
 
-  // index = size of umap
-  token_to_index_map[token] = crate::TokenIndex(uint32_t(tokens_.size()));
-  tokens_.emplace_back(token);
+    WRITE_SECTION("TOKENS", WriteTokens)
+    WRITE_SECTION("STRINGS", WriteStrings)
+    WRITE_SECTION("FIELDS", WriteFields)
+    WRITE_SECTION("FIELDSETS", WriteFieldSets)
+    WRITE_SECTION("PATHS", WritePaths)
+    WRITE_SECTION("SPECS", WriteSpecs)
+
+#undef WRITE_SECTION
+
+    // TOC
+    const uint64_t toc_offset = uint64_t(out_.size());
+    AppendU64(uint64_t(sections.size()), &out_);
+    for (const auto &s : sections) {
+      AppendBytes(s.name, crate::kSectionNameMaxLength + 1, &out_);
+      AppendI64(s.start, &out_);
+      AppendI64(s.size, &out_);
+    }
 
-  return token_to_index_map[token];
-}
+    // Header
+    const char magic[8] = {'P', 'X', 'R', '-', 'U', 'S', 'D', 'C'};
+    const uint8_t version[8] = {0, 8, 0, 0, 0, 0, 0, 0};
+    memcpy(&out_[0], magic, 8);
+    memcpy(&out_[8], version, 8);
+    memcpy(&out_[16], &toc_offset, 8);
 
-crate::StringIndex Packer::AddString(const std::string &str) {
-  if (string_to_index_map.count(str)) {
-    return string_to_index_map[str];
+    (*output) = std::move(out_);
+    out_.clear();
+
+    return true;
   }
 
-  // index = size of umap
-  string_to_index_map[str] = crate::StringIndex(uint32_t(strings_.size()));
-  strings_.emplace_back(str);
+ private:
+  Writer() = delete;
+  Writer(const Writer &) = delete;
+
+  void PushError(const std::string &s) { err_ += s; }
+
+  void PushWarn(const std::string &s) { warn_ += s; }
+
+  struct SpecEntry {
+    uint32_t path_index{0};
+    SpecType spec_type{SpecType::Unknown};
+
+    // Prim or Variant
+    const PrimSpec *prim{nullptr};
+    // Attribute or Relationship
+    const Property *prop{nullptr};
+    // VariantSet
+    const VariantSetSpec *variant_set{nullptr};
+
+    // primChildren, variantChildren(VariantSet)
+    std::vector<value::token> children;
+    std::vector<value::token> properties;
+    std::vector<value::token> variant_set_children;
+  };
+
+  struct PathNode {
+    uint32_t parent{0};
+    int32_t element{0};  // token index. negative for property element.
+    bool encoded{true};  // false for the empty Path slot
+    std::vector<uint32_t> children;
+  };
+
+  // Out-of-line encoded large array.
+  struct EncodedArray {
+    std::vector<uint8_t> data;
+    int32_t crate_type{0};
+    bool compressed{false};
+    std::string err;
+  };
 
-  return string_to_index_map[str];
-}
+  //
+  // Tables
+  //
 
-crate::PathIndex Packer::AddPath(const Path &path) {
-  if (path_to_index_map.count(path)) {
-    return path_to_index_map[path];
+  uint32_t AddToken(const std::string &tok) {
+    const auto it = token_map_.find(tok);
+    if (it != token_map_.end()) {
+      return it->second;
+    }
+    uint32_t idx = uint32_t(tokens_.size());
+    tokens_.push_back(tok);
+    token_map_.emplace(tok, idx);
+    return idx;
   }
 
-  // index = size of umap
-  path_to_index_map[path] = crate::PathIndex(uint32_t(paths_.size()));
-  paths_.emplace_back(path);
+  uint32_t AddString(const std::string &str) {
+    const auto it = string_map_.find(str);
+    if (it != string_map_.end()) {
+      return it->second;
+    }
+    uint32_t idx = uint32_t(strings_.size());
+    strings_.push_back(AddToken(str));
+    string_map_.emplace(str, idx);
+    return idx;
+  }
 
-  return path_to_index_map[path];
-}
+  uint32_t AddPathElement(const uint32_t parent, const std::string &elem,
+                          const bool is_property) {
+    const int32_t tok = int32_t(AddToken(elem));
+    const std::pair<uint32_t, int32_t> key(parent, is_property ? -tok : tok);
+    const auto it = path_child_map_.find(key);
+    if (it != path_child_map_.end()) {
+      return it->second;
+    }
 
-crate::FieldIndex Packer::AddField(const crate::Field &field) {
-  if (field_to_index_map.count(field)) {
-    return field_to_index_map[field];
+    uint32_t idx = uint32_t(path_nodes_.size());
+    PathNode node;
+    node.parent = parent;
+    node.element = key.second;
+    path_nodes_.push_back(node);
+    path_nodes_[parent].children.push_back(idx);
+    path_child_map_.emplace(key, idx);
+    return idx;
   }
 
-  // index = size of umap
-  field_to_index_map[field] = crate::FieldIndex(uint32_t(fields_.size()));
-  fields_.emplace_back(field);
+  bool AddPath(const Path &path, uint32_t *idx) {
+    if (!path.is_valid() ||
+        (path.prim_part().empty() && path.prop_part().empty())) {
+      // Empty Path. e.g. Reference without Prim path.
+      if (!empty_path_index_) {
+        PathNode node;
+        node.encoded = false;
+        empty_path_index_ = uint32_t(path_nodes_.size());
+        path_nodes_.push_back(node);
+      }
+      (*idx) = empty_path_index_.value();
+      return true;
+    }
+
+    std::vector<std::string> elems;
+    if (!SplitPrimPart(path.prim_part(), &elems)) {
+      PUSH_ERROR_AND_RETURN("Path must be an absolute path: " +
+                            path.full_path_name());
+    }
 
-  return field_to_index_map[field];
-}
+    uint32_t cur = 0;  // root
+    for (const auto &elem : elems) {
+      cur = AddPathElement(cur, elem, /* is_property */ false);
+    }
+
+    if (path.prop_part().size()) {
+      cur = AddPathElement(cur, path.prop_part(), /* is_property */ true);
+    }
 
-crate::FieldSetIndex Packer::AddFieldSet(
-    const std::vector<crate::FieldIndex> &fieldset) {
-  if (fieldset_to_index_map.count(fieldset)) {
-    return fieldset_to_index_map[fieldset];
+    (*idx) = cur;
+    return true;
   }
 
-  // index = size of umap = star index of FieldSet span.
-  fieldset_to_index_map[fieldset] =
-      crate::FieldSetIndex(uint32_t(fieldsets_.size()));
+  uint32_t AddField(const std::string &name, const crate::ValueRep &rep) {
+    const std::pair<uint32_t, uint64_t> key(AddToken(name), rep.GetData());
+    const auto it = field_map_.find(key);
+    if (it != field_map_.end()) {
+      return it->second;
+    }
+    uint32_t idx = uint32_t(fields_.size());
+    fields_.push_back(key);
+    field_map_.emplace(key, idx);
+    return idx;
+  }
 
-  fieldsets_.insert(fieldsets_.end(), fieldset.begin(), fieldset.end());
-  fieldsets_.push_back(crate::FieldIndex());  // terminator(~0)
+  uint32_t AddFieldSet(const std::vector<uint32_t> &fields) {
+    const auto it = fieldset_map_.find(fields);
+    if (it != fieldset_map_.end()) {
+      return it->second;
+    }
+    // FieldSet index = the index to the first field in the flattened array.
+    uint32_t idx = uint32_t(fieldsets_.size());
+    fieldsets_.insert(fieldsets_.end(), fields.begin(), fields.end());
+    fieldsets_.push_back(~0u);  // terminator
+    fieldset_map_.emplace(fields, idx);
+    return idx;
+  }
 
-  return fieldset_to_index_map[fieldset];
-}
-#endif
+  //
+  // Append(possibly deduplicated) value data and return its offset.
+  //
+  bool AppendData(const std::vector<uint8_t> &data, uint64_t *offset) {
+    uint64_t h = 0;
+    if (config_.deduplicate_values) {
+      h = HashBytes(data.data(), data.size());
+      const auto range = data_map_.equal_range(h);
+      for (auto it = range.first; it != range.second; it++) {
+        if ((it->second.second == data.size()) &&
+            (memcmp(&out_[size_t(it->second.first)], data.data(),
+                    data.size()) == 0)) {
+          (*offset) = it->second.first;
+          return true;
+        }
+      }
+    }
 
-class Writer {
- public:
-  Writer(const Stage &stage) : stage_(stage) {}
+    const uint64_t offt = uint64_t(out_.size());
+    if ((offt + data.size()) > kMaxValueRepPayload) {
+      PUSH_ERROR_AND_RETURN("USDC data too large(exceeds 48bit offset).");
+    }
+    out_.insert(out_.end(), data.begin(), data.end());
+    if (config_.deduplicate_values) {
+      data_map_.emplace(h, std::make_pair(offt, uint64_t(data.size())));
+    }
 
-  const Stage &stage_;
+    (*offset) = offt;
+    return true;
+  }
 
-  const std::string &GetError() const { return err_; }
-  const std::string &GetWarning() const { return warn_; }
+  bool MakeRep(const CrateTypeId ty, const bool is_array,
+               const std::vector<uint8_t> &data, crate::ValueRep *rep) {
+    uint64_t offset{0};
+    if (!AppendData(data, &offset)) {
+      return false;
+    }
+    (*rep) = crate::ValueRep(int32_t(ty), /* inlined */ false, is_array,
+                             offset);
+    return true;
+  }
 
-  void PushError(const std::string &s) {
-    err_ += s;
+  static crate::ValueRep InlineRep(const CrateTypeId ty,
+                                   const uint32_t payload) {
+    return crate::ValueRep(int32_t(ty), /* inlined */ true,
+                           /* array */ false, uint64_t(payload));
   }
 
-  void PushWarn(const std::string &s) {
-    warn_ += s;
+  crate::ValueRep TokenRep(const std::string &tok) {
+    return InlineRep(CrateTypeId::CRATE_DATA_TYPE_TOKEN, AddToken(tok));
   }
 
-  bool WriteHeader(uint64_t toc_offset) {
-    char magic[8];
-    magic[0] = 'P';
-    magic[1] = 'X';
-    magic[2] = 'R';
-    magic[3] = '-';
-    magic[4] = 'U';
-    magic[5] = 'S';
-    magic[6] = 'D';
-    magic[7] = 'C';
+  crate::ValueRep StringRep(const std::string &str) {
+    return InlineRep(CrateTypeId::CRATE_DATA_TYPE_STRING, AddString(str));
+  }
 
-    uint8_t version[8];  // Only first 3 bytes are used.
-    version[0] = 0;
-    version[1] = 8;
-    version[2] = 0;
+  static crate::ValueRep BoolRep(const bool b) {
+    return InlineRep(CrateTypeId::CRATE_DATA_TYPE_BOOL, b ? 1 : 0);
+  }
 
-    std::array<uint8_t, 88> header;
-    memset(&header, 0, 88);
+  static crate::ValueRep ValueBlockRep() {
+    return InlineRep(CrateTypeId::CRATE_DATA_TYPE_VALUE_BLOCK, 0);
+  }
 
-    memcpy(&header[0], magic, 8);
-    memcpy(&header[8], version, 8);
-    memcpy(&header[16], &toc_offset, 8);
+  //
+  // Value encoders
+  //
 
-    oss_.write(reinterpret_cast<const char *>(&header[0]), 88);
+  // Scalar which may be inlined.
+  template <typename T>
+  bool PackInlineable(const T &v, const CrateTypeId ty, crate::ValueRep *rep) {
+    if (auto inl = crate::TryEncodeInline(v)) {
+      (*rep) = InlineRep(ty, inl.value());
+      return true;
+    }
+    std::vector<uint8_t> data;
+    AppendBytes(&v, sizeof(T), &data);
+    return MakeRep(ty, false, data, rep);
+  }
 
-    return true;
+  template <typename T>
+  bool PackRaw(const T &v, const CrateTypeId ty, crate::ValueRep *rep) {
+    std::vector<uint8_t> data;
+    AppendBytes(&v, sizeof(T), &data);
+    return MakeRep(ty, false, data, rep);
   }
 
-  bool WriteTokens() {
-    // Build single string separated by '\0', then compress it with lz4
-    std::ostringstream oss;
+  template <typename T>
+  bool PackRawArray(const std::vector<T> &v, const CrateTypeId ty,
+                    crate::ValueRep *rep) {
+    if (v.empty()) {
+      (*rep) = crate::ValueRep(int32_t(ty), false, true, 0);
+      return true;
+    }
+    std::vector<uint8_t> data;
+    AppendRawArray(v, &data);
+    return MakeRep(ty, true, data, rep);
+  }
 
-    auto tokens = packer_.GetTokens();
+  bool PackIndexArray(const std::vector<uint32_t> &indices,
+                      const CrateTypeId ty, const bool is_array,
+                      crate::ValueRep *rep) {
+    if (is_array && indices.empty()) {
+      (*rep) = crate::ValueRep(int32_t(ty), false, true, 0);
+      return true;
+    }
+    std::vector<uint8_t> data;
+    AppendRawArray(indices, &data);
+    return MakeRep(ty, is_array, data, rep);
+  }
 
-    for (size_t i = 0; i < tokens.size(); i++) {
-      oss << tokens[i].str();
+  bool PackNumericArray(const value::Value &v, crate::ValueRep *rep) {
+    const auto it = encoded_arrays_.find(&v);
+
+    EncodedArray local;
+    const EncodedArray *enc = &local;
+    if (it != encoded_arrays_.end()) {
+      enc = &encoded_arrays_jobs_[it->second];
+    } else {
+      if (NumericArraySize(v) == 0) {
+        // Empty array. Encode it to get the Crate type.
+        std::vector<uint8_t> dummy;
+        bool compressed{false};
+        if (!EncodeNumericArray(v, false, &dummy, &local.crate_type,
+                                &compressed, &local.err)) {
+          PUSH_ERROR_AND_RETURN("Failed to encode array: " + local.err);
+        }
+        (*rep) = crate::ValueRep(local.crate_type, false, true, 0);
+        return true;
+      }
 
-      if (i != (tokens.size() - 1)) {
-        oss.put('\0');  // separator
+      if (!EncodeNumericArray(v, config_.compress_arrays, &local.data,
+                              &local.crate_type, &local.compressed,
+                              &local.err)) {
+        PUSH_ERROR_AND_RETURN("Failed to encode array: " + local.err);
       }
     }
-    // Last string does not terminated with `\0'
 
-    // compress
-    size_t input_bytes = oss.str().size();
-    if (input_bytes == 0) {
-      PUSH_ERROR("Invalid data size.");
+    if (!enc->err.empty()) {
+      PUSH_ERROR_AND_RETURN("Failed to encode array: " + enc->err);
+    }
+
+    uint64_t offset{0};
+    if (!AppendData(enc->data, &offset)) {
       return false;
     }
+    (*rep) = crate::ValueRep(enc->crate_type, false, true, offset);
+    if (enc->compressed) {
+      rep->SetIsCompressed();
+    }
+    return true;
+  }
 
-    std::vector<char> buf;
-    buf.resize(LZ4Compression::GetCompressedBufferSize(input_bytes));
+  bool PackArray(const value::Value &v, crate::ValueRep *rep) {
+    const uint32_t tyid =
+        v.underlying_type_id() & (~value::TYPE_ID_1D_ARRAY_BIT);
 
-    std::string err;
-    size_t n = LZ4Compression::CompressToBuffer(oss.str().data(), buf.data(),
-                                                input_bytes, &err);
+#define PACK_RAW_ARRAY(__tyid, __ty, __crate_ty)               \
+  case value::__tyid: {                                        \
+    if (auto pv = AsArray<__ty>(v)) {                          \
+      return PackRawArray(*pv, CrateTypeId::__crate_ty, rep);  \
+    }                                                          \
+    break;                                                     \
+  }
+
+    switch (tyid) {
+      case value::TYPE_ID_INT32:
+      case value::TYPE_ID_UINT32:
+      case value::TYPE_ID_INT64:
+      case value::TYPE_ID_UINT64:
+      case value::TYPE_ID_HALF:
+      case value::TYPE_ID_FLOAT:
+      case value::TYPE_ID_DOUBLE:
+      case value::TYPE_ID_TIMECODE:
+        return PackNumericArray(v, rep);
+      case value::TYPE_ID_BOOL: {
+        if (auto pv = AsArray<bool>(v)) {
+          // bool is stored as 8bit value.
+          std::vector<uint8_t> bv(pv->size());
+          for (size_t i = 0; i < pv->size(); i++) {
+            bv[i] = (*pv)[i] ? 1 : 0;
+          }
+          return PackRawArray(bv, CrateTypeId::CRATE_DATA_TYPE_BOOL, rep);
+        }
+        break;
+      }
+      case value::TYPE_ID_STRING: {
+        if (auto pv = AsArray<std::string>(v)) {
+          std::vector<uint32_t> indices;
+          for (const auto &s : *pv) {
+            indices.push_back(AddString(s));
+          }
+          return PackIndexArray(indices, CrateTypeId::CRATE_DATA_TYPE_STRING,
+                                true, rep);
+        }
+        break;
+      }
+      case value::TYPE_ID_ASSET_PATH: {
+        // AssetPath array is stored as StringIndex array.
+        if (auto pv = AsArray<value::AssetPath>(v)) {
+          std::vector<uint32_t> indices;
+          for (const auto &s : *pv) {
+            indices.push_back(AddString(s.GetAssetPath()));
+          }
+          return PackIndexArray(indices,
+                                CrateTypeId::CRATE_DATA_TYPE_ASSET_PATH, true,
+                                rep);
+        }
+        break;
+      }
+      PACK_RAW_ARRAY(TYPE_ID_HALF2, value::half2, CRATE_DATA_TYPE_VEC2H)
+      PACK_RAW_ARRAY(TYPE_ID_HALF3, value::half3, CRATE_DATA_TYPE_VEC3H)
+      PACK_RAW_ARRAY(TYPE_ID_HALF4, value::half4, CRATE_DATA_TYPE_VEC4H)
+      PACK_RAW_ARRAY(TYPE_ID_FLOAT2, value::float2, CRATE_DATA_TYPE_VEC2F)
+      PACK_RAW_ARRAY(TYPE_ID_FLOAT3, value::float3, CRATE_DATA_TYPE_VEC3F)
+      PACK_RAW_ARRAY(TYPE_ID_FLOAT4, value::float4, CRATE_DATA_TYPE_VEC4F)
+      PACK_RAW_ARRAY(TYPE_ID_DOUBLE2, value::double2, CRATE_DATA_TYPE_VEC2D)
+      PACK_RAW_ARRAY(TYPE_ID_DOUBLE3, value::double3, CRATE_DATA_TYPE_VEC3D)
+      PACK_RAW_ARRAY(TYPE_ID_DOUBLE4, value::double4, CRATE_DATA_TYPE_VEC4D)
+      PACK_RAW_ARRAY(TYPE_ID_INT2, value::int2, CRATE_DATA_TYPE_VEC2I)
+      PACK_RAW_ARRAY(TYPE_ID_INT3, value::int3, CRATE_DATA_TYPE_VEC3I)
+      PACK_RAW_ARRAY(TYPE_ID_INT4, value::int4, CRATE_DATA_TYPE_VEC4I)
+      PACK_RAW_ARRAY(TYPE_ID_QUATH, value::quath, CRATE_DATA_TYPE_QUATH)
+      PACK_RAW_ARRAY(TYPE_ID_QUATF, value::quatf, CRATE_DATA_TYPE_QUATF)
+      PACK_RAW_ARRAY(TYPE_ID_QUATD, value::quatd, CRATE_DATA_TYPE_QUATD)
+      PACK_RAW_ARRAY(TYPE_ID_MATRIX2D, value::matrix2d,
+                     CRATE_DATA_TYPE_MATRIX2D)
+      PACK_RAW_ARRAY(TYPE_ID_MATRIX3D, value::matrix3d,
+                     CRATE_DATA_TYPE_MATRIX3D)
+      PACK_RAW_ARRAY(TYPE_ID_MATRIX4D, value::matrix4d,
+                     CRATE_DATA_TYPE_MATRIX4D)
+      default:
+        break;
+    }
+
+#undef PACK_RAW_ARRAY
+
+    PUSH_ERROR_AND_RETURN("Unsupported array type for USDC: " +
+                          v.type_name());
+  }
 
-    (void)n;
+  bool PackDictionary(const CustomDataType &dict, crate::ValueRep *rep) {
+    if (dict.empty()) {
+      (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_DICTIONARY, 0);
+      return true;
+    }
 
-    if (!err.empty()) {
-      PUSH_ERROR(err);
+    std::vector<uint8_t> data;
+    if (!EncodeDictionary(dict, &data)) {
       return false;
     }
+    return MakeRep(CrateTypeId::CRATE_DATA_TYPE_DICTIONARY, false, data, rep);
+  }
+
+  // `# of items` + (key(StringIndex), offset to ValueRep, ValueRep) * N
+  // Values are written before the dictionary data.
+  bool EncodeDictionary(const CustomDataType &dict,
+                        std::vector<uint8_t> *data) {
+    std::vector<std::pair<uint32_t, uint64_t>> items;
+    for (const auto &item : dict) {
+      crate::ValueRep rep;
+      if (!PackValue(item.second.get_raw_value(), &rep)) {
+        PUSH_ERROR_AND_RETURN("Failed to encode dictionary value `" +
+                              item.first + "`");
+      }
+      items.push_back(std::make_pair(AddString(item.first), rep.GetData()));
+    }
+
+    AppendU64(uint64_t(items.size()), data);
+    for (const auto &item : items) {
+      AppendU32(item.first, data);
+      // Offset from the beginning of this offset value. ValueRep immediately
+      // follows.
+      AppendI64(int64_t(sizeof(int64_t)), data);
+      AppendU64(item.second, data);
+    }
 
     return true;
   }
 
-  bool WriteStrings() { return false; }
+  bool PackTimeSamples(const value::TimeSamples &ts, crate::ValueRep *rep) {
+    const std::vector<value::TimeSamples::Sample> &samples = ts.get_samples();
+
+    std::vector<double> times;
+    std::vector<uint64_t> reps;
+    for (const auto &s : samples) {
+      times.push_back(s.t);
+      crate::ValueRep r = ValueBlockRep();
+      if (!s.blocked) {
+        if (!PackValue(s.value, &r)) {
+          PUSH_ERROR_AND_RETURN("Failed to encode TimeSamples value at time " +
+                                std::to_string(s.t));
+        }
+      }
+      reps.push_back(r.GetData());
+    }
+
+    crate::ValueRep times_rep;
+    if (!PackValue(value::Value(times), &times_rep)) {
+      return false;
+    }
+
+    std::vector<uint8_t> data;
+    AppendI64(int64_t(sizeof(int64_t)), &data);
+    AppendU64(times_rep.GetData(), &data);
+    AppendI64(int64_t(sizeof(int64_t)), &data);
+    AppendU64(uint64_t(reps.size()), &data);
+    for (const uint64_t r : reps) {
+      AppendU64(r, &data);
+    }
+
+    return MakeRep(CrateTypeId::CRATE_DATA_TYPE_TIME_SAMPLES, false, data,
+                   rep);
+  }
+
+  bool PackValue(const value::Value &v, crate::ValueRep *rep) {
+    const uint32_t tyid = v.type_id();
+
+    // Types without role types.
+    switch (tyid) {
+      case value::TYPE_ID_VALUEBLOCK:
+        (*rep) = ValueBlockRep();
+        return true;
+      case value::TYPE_ID_TOKEN:
+        (*rep) = TokenRep(v.as<value::token>()->str());
+        return true;
+      case value::TYPE_ID_TOKEN_VECTOR:
+        // `token[]`(std::vector<value::token> is registered as TokenVector
+        // type)
+        if (auto pv = v.as<std::vector<value::token>>()) {
+          std::vector<uint32_t> indices;
+          for (const auto &tok : *pv) {
+            indices.push_back(AddToken(tok.str()));
+          }
+          return PackIndexArray(indices, CrateTypeId::CRATE_DATA_TYPE_TOKEN,
+                                true, rep);
+        }
+        break;
+      case value::TYPE_ID_STRING:
+        (*rep) = StringRep(*v.as<std::string>());
+        return true;
+      case value::TYPE_ID_STRING_DATA:
+        (*rep) = StringRep(v.as<value::StringData>()->value);
+        return true;
+      case value::TYPE_ID_ASSET_PATH:
+        // Inlined AssetPath uses TokenIndex.
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_ASSET_PATH,
+                           AddToken(v.as<value::AssetPath>()->GetAssetPath()));
+        return true;
+      case value::TYPE_ID_CUSTOMDATA:
+        return PackDictionary(*v.as<CustomDataType>(), rep);
+      case value::TYPE_ID_TIMECODE:
+        // No TimeCode type support in CrateReader. Store as double.
+        return PackInlineable(v.as<value::timecode>()->value,
+                              CrateTypeId::CRATE_DATA_TYPE_DOUBLE, rep);
+      case value::TYPE_ID_SPECIFIER:
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_SPECIFIER,
+                           uint32_t(*v.as<Specifier>()));
+        return true;
+      case value::TYPE_ID_PERMISSION:
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_PERMISSION,
+                           uint32_t(*v.as<Permission>()));
+        return true;
+      case value::TYPE_ID_VARIABILITY:
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_VARIABILITY,
+                           uint32_t(*v.as<Variability>()));
+        return true;
+      default:
+        break;
+    }
+
+    if (v.underlying_type_id() & value::TYPE_ID_1D_ARRAY_BIT) {
+      return PackArray(v, rep);
+    }
+
+#define PACK_INLINEABLE(__tyid, __ty, __crate_ty)                      \
+  case value::__tyid: {                                                \
+    if (auto pv = v.as<__ty>()) {                                      \
+      return PackInlineable(*pv, CrateTypeId::__crate_ty, rep);        \
+    }                                                                  \
+    break;                                                             \
+  }
+
+#define PACK_RAW(__tyid, __ty, __crate_ty)                             \
+  case value::__tyid: {                                                \
+    if (auto pv = v.as<__ty>()) {                                      \
+      return PackRaw(*pv, CrateTypeId::__crate_ty, rep);               \
+    }                                                                  \
+    break;                                                             \
+  }
+
+    switch (v.underlying_type_id()) {
+      case value::TYPE_ID_BOOL:
+        (*rep) = BoolRep(*v.as<bool>());
+        return true;
+      case value::TYPE_ID_UCHAR:
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_UCHAR,
+                           uint32_t(*v.as<uint8_t>()));
+        return true;
+      case value::TYPE_ID_INT32:
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_INT,
+                           uint32_t(*v.as<int32_t>()));
+        return true;
+      case value::TYPE_ID_UINT32:
+        (*rep) =
+            InlineRep(CrateTypeId::CRATE_DATA_TYPE_UINT, *v.as<uint32_t>());
+        return true;
+      case value::TYPE_ID_HALF:
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_HALF,
+                           uint32_t(v.as<value::half>()->value));
+        return true;
+      case value::TYPE_ID_FLOAT: {
+        // float is always inlined.
+        uint32_t bits;
+        memcpy(&bits, v.as<float>(), sizeof(float));
+        (*rep) = InlineRep(CrateTypeId::CRATE_DATA_TYPE_FLOAT, bits);
+        return true;
+      }
+      PACK_INLINEABLE(TYPE_ID_INT64, int64_t, CRATE_DATA_TYPE_INT64)
+      PACK_INLINEABLE(TYPE_ID_UINT64, uint64_t, CRATE_DATA_TYPE_UINT64)
+      PACK_INLINEABLE(TYPE_ID_DOUBLE, double, CRATE_DATA_TYPE_DOUBLE)
+      PACK_INLINEABLE(TYPE_ID_FLOAT2, value::float2, CRATE_DATA_TYPE_VEC2F)
+      PACK_INLINEABLE(TYPE_ID_FLOAT3, value::float3, CRATE_DATA_TYPE_VEC3F)
+      PACK_INLINEABLE(TYPE_ID_FLOAT4, value::float4, CRATE_DATA_TYPE_VEC4F)
+      PACK_INLINEABLE(TYPE_ID_DOUBLE2, value::double2, CRATE_DATA_TYPE_VEC2D)
+      PACK_INLINEABLE(TYPE_ID_DOUBLE3, value::double3, CRATE_DATA_TYPE_VEC3D)
+      PACK_INLINEABLE(TYPE_ID_DOUBLE4, value::double4, CRATE_DATA_TYPE_VEC4D)
+      PACK_INLINEABLE(TYPE_ID_INT2, value::int2, CRATE_DATA_TYPE_VEC2I)
+      PACK_INLINEABLE(TYPE_ID_INT3, value::int3, CRATE_DATA_TYPE_VEC3I)
+      PACK_INLINEABLE(TYPE_ID_INT4, value::int4, CRATE_DATA_TYPE_VEC4I)
+      PACK_INLINEABLE(TYPE_ID_MATRIX2D, value::matrix2d,
+                      CRATE_DATA_TYPE_MATRIX2D)
+      PACK_INLINEABLE(TYPE_ID_MATRIX3D, value::matrix3d,
+                      CRATE_DATA_TYPE_MATRIX3D)
+      PACK_INLINEABLE(TYPE_ID_MATRIX4D, value::matrix4d,
+                      CRATE_DATA_TYPE_MATRIX4D)
+      // Half vectors and quaternions are not inlined in pxrUSD.
+      PACK_RAW(TYPE_ID_HALF2, value::half2, CRATE_DATA_TYPE_VEC2H)
+      PACK_RAW(TYPE_ID_HALF3, value::half3, CRATE_DATA_TYPE_VEC3H)
+      PACK_RAW(TYPE_ID_HALF4, value::half4, CRATE_DATA_TYPE_VEC4H)
+      PACK_RAW(TYPE_ID_QUATH, value::quath, CRATE_DATA_TYPE_QUATH)
+      PACK_RAW(TYPE_ID_QUATF, value::quatf, CRATE_DATA_TYPE_QUATF)
+      PACK_RAW(TYPE_ID_QUATD, value::quatd, CRATE_DATA_TYPE_QUATD)
+      default:
+        break;
+    }
+
+#undef PACK_INLINEABLE
+#undef PACK_RAW
+
+    PUSH_ERROR_AND_RETURN("Unsupported value type for USDC: " + v.type_name());
+  }
+
+  bool PackTokenVector(const std::vector<value::token> &toks,
+                       crate::ValueRep *rep) {
+    std::vector<uint32_t> indices;
+    for (const auto &tok : toks) {
+      indices.push_back(AddToken(tok.str()));
+    }
+    return PackIndexArray(indices, CrateTypeId::CRATE_DATA_TYPE_TOKEN_VECTOR,
+                          false, rep);
+  }
+
+  //
+  // ListOp
+  //
+  // TinyUSDZ represents ListOp as (ListEditQual, items) pair.
+  //
+  template <typename T, class EncodeItemFn>
+  bool PackListOp(const ListEditQual qual, const std::vector<T> &items,
+                  const CrateTypeId ty, EncodeItemFn &&encode_item,
+                  crate::ValueRep *rep) {
+    uint8_t bits{0};
+    switch (qual) {
+      case ListEditQual::ResetToExplicit:
+        bits = ListOpHeader::IsExplicitBit;
+        if (items.size()) {
+          bits |= ListOpHeader::HasExplicitItemsBit;
+        }
+        break;
+      case ListEditQual::Add:
+        bits = ListOpHeader::HasAddedItemsBit;
+        break;
+      case ListEditQual::Prepend:
+        bits = ListOpHeader::HasPrependedItemsBit;
+        break;
+      case ListEditQual::Append:
+        bits = ListOpHeader::HasAppendedItemsBit;
+        break;
+      case ListEditQual::Delete:
+        bits = ListOpHeader::HasDeletedItemsBit;
+        break;
+      case ListEditQual::Order:
+        bits = ListOpHeader::HasOrderedItemsBit;
+        break;
+      case ListEditQual::Invalid:
+        PUSH_ERROR_AND_RETURN("Invalid ListEdit qualifier.");
+    }
+
+    std::vector<uint8_t> data;
+    data.push_back(bits);
+    if (items.size()) {
+      AppendU64(uint64_t(items.size()), &data);
+      for (const auto &item : items) {
+        if (!encode_item(item, &data)) {
+          return false;
+        }
+      }
+    }
+
+    return MakeRep(ty, false, data, rep);
+  }
 
-  bool WriteFields() { return false; }
+  bool PackPathListOp(const ListEditQual qual, const std::vector<Path> &paths,
+                      crate::ValueRep *rep) {
+    return PackListOp(qual, paths, CrateTypeId::CRATE_DATA_TYPE_PATH_LIST_OP,
+                      [this](const Path &p, std::vector<uint8_t> *dst) {
+                        uint32_t idx;
+                        if (!AddPath(p, &idx)) {
+                          return false;
+                        }
+                        AppendU32(idx, dst);
+                        return true;
+                      },
+                      rep);
+  }
 
-  bool WriteFieldSets() { return false; }
+  bool PackReferenceListOp(const ListEditQual qual,
+                           const std::vector<Reference> &refs,
+                           crate::ValueRep *rep) {
+    // Encode customData of References first.
+    std::vector<std::vector<uint8_t>> dicts(refs.size());
+    for (size_t i = 0; i < refs.size(); i++) {
+      if (!EncodeDictionary(refs[i].customData, &dicts[i])) {
+        return false;
+      }
+    }
 
-  bool WritePaths() { return false; }
+    size_t n = 0;
+    return PackListOp(
+        qual, refs, CrateTypeId::CRATE_DATA_TYPE_REFERENCE_LIST_OP,
+        [this, &dicts, &n](const Reference &ref, std::vector<uint8_t> *dst) {
+          uint32_t path_idx;
+          if (!AddPath(ref.prim_path, &path_idx)) {
+            return false;
+          }
+          AppendU32(AddString(ref.asset_path.GetAssetPath()), dst);
+          AppendU32(path_idx, dst);
+          AppendBytes(&ref.layerOffset._offset, sizeof(double), dst);
+          AppendBytes(&ref.layerOffset._scale, sizeof(double), dst);
+          AppendBytes(dicts[n].data(), dicts[n].size(), dst);
+          n++;
+          return true;
+        },
+        rep);
+  }
 
-  bool WriteSpecs() { return false; }
+  bool PackPayloadListOp(const ListEditQual qual,
+                         const std::vector<Payload> &payloads,
+                         crate::ValueRep *rep) {
+    return PackListOp(
+        qual, payloads, CrateTypeId::CRATE_DATA_TYPE_PAYLOAD_LIST_OP,
+        [this](const Payload &pl, std::vector<uint8_t> *dst) {
+          uint32_t path_idx;
+          if (!AddPath(pl.prim_path, &path_idx)) {
+            return false;
+          }
+          AppendU32(AddString(pl.asset_path.GetAssetPath()), dst);
+          AppendU32(path_idx, dst);
+          AppendBytes(&pl.layerOffset._offset, sizeof(double), dst);
+          AppendBytes(&pl.layerOffset._scale, sizeof(double), dst);
+          return true;
+        },
+        rep);
+  }
 
-  bool WriteTOC() {
-    uint64_t num_sections = toc_.sections.size();
+  bool PackTokenListOp(const ListEditQual qual,
+                       const std::vector<value::token> &toks,
+                       crate::ValueRep *rep) {
+    return PackListOp(qual, toks, CrateTypeId::CRATE_DATA_TYPE_TOKEN_LIST_OP,
+                      [this](const value::token &tok,
+                             std::vector<uint8_t> *dst) {
+                        AppendU32(AddToken(tok.str()), dst);
+                        return true;
+                      },
+                      rep);
+  }
 
-    DCOUT("# of sections = " << std::to_string(num_sections));
+  bool PackStringListOp(const ListEditQual qual,
+                        const std::vector<std::string> &strs,
+                        crate::ValueRep *rep) {
+    return PackListOp(qual, strs, CrateTypeId::CRATE_DATA_TYPE_STRING_LIST_OP,
+                      [this](const std::string &s, std::vector<uint8_t> *dst) {
+                        AppendU32(AddString(s), dst);
+                        return true;
+                      },
+                      rep);
+  }
 
-    if (num_sections == 0) {
-      err_ += "Zero sections in TOC.\n";
+  // ListOp with no items is only valid for explicit ListOp.
+  template <typename T>
+  bool IsEncodableListOp(const std::string &name, const ListEditQual qual,
+                         const std::vector<T> &items) {
+    if (items.empty() && (qual != ListEditQual::ResetToExplicit)) {
+      PUSH_WARN("`" << name << "` with `" << to_string(qual)
+                    << "` qualifier and no items is not written.");
       return false;
     }
+    return true;
+  }
+
+  //
+  // Specs
+  //
+
+  // Children in authored order when the order list is complete, otherwise in
+  // the order of `items`.
+  template <typename Map>
+  static std::vector<std::string> OrderedNames(
+      const std::vector<value::token> &order, const Map &items) {
+    std::vector<std::string> names;
+    bool complete = (order.size() == items.size());
+    if (complete) {
+      for (const auto &tok : order) {
+        if (!items.count(tok.str())) {
+          complete = false;
+          break;
+        }
+        names.push_back(tok.str());
+      }
+    }
 
-    // # of sections
-    oss_.write(reinterpret_cast<const char *>(&num_sections), 8);
+    if (!complete) {
+      names.clear();
+      for (const auto &item : items) {
+        names.push_back(item.first);
+      }
+    }
+    return names;
+  }
+
+  void CollectValue(const value::Value &v) {
+    if (config_.compress_arrays &&
+        (NumericArraySize(v) >= crate::kMinCompressedArraySize)) {
+      if (!encoded_arrays_.count(&v)) {
+        encoded_arrays_.emplace(&v, large_arrays_.size());
+        large_arrays_.push_back(&v);
+      }
+    }
+  }
+
+  bool CollectProperty(const uint32_t parent, const std::string &name,
+                       const Property &prop) {
+    SpecEntry spec;
+    spec.path_index = AddPathElement(parent, name, /* is_property */ true);
+    spec.prop = &prop;
+
+    if (prop.is_relationship()) {
+      spec.spec_type = SpecType::Relationship;
+    } else if (prop.is_attribute()) {
+      spec.spec_type = SpecType::Attribute;
+
+      const primvar::PrimVar &var = prop.get_attribute().get_var();
+      std::string err;
+      if (!var.materialize(&err)) {
+        PUSH_ERROR_AND_RETURN("Failed to load the value of property `" +
+                              name + "`: " + err);
+      }
+      if (var.has_value() && !var.is_blocked()) {
+        CollectValue(var.value_raw());
+      }
+      if (var.has_timesamples()) {
+        for (const auto &s : var.ts_raw().get_samples()) {
+          if (!s.blocked) {
+            CollectValue(s.value);
+          }
+        }
+      }
+    } else {
+      PUSH_ERROR_AND_RETURN("Unsupported property type: " << name);
+    }
 
+    specs_.emplace_back(std::move(spec));
     return true;
   }
 
-  bool Write() {
-    //
-    //  - TOC
-    //  - Tokens
-    //  - Strings
-    //  - Fields
-    //  - FieldSets
-    //  - Paths
-    //  - Specs
-    //
+  bool CollectPrimSpec(const uint32_t path_index, const SpecType spec_type,
+                       const PrimSpec &ps) {
+    size_t spec_idx = specs_.size();
+    {
+      SpecEntry spec;
+      spec.path_index = path_index;
+      spec.spec_type = spec_type;
+      spec.prim = &ps;
+      specs_.emplace_back(std::move(spec));
+    }
 
-    if (!WriteTokens()) {
-      PUSH_ERROR("Failed to write Tokens.");
-      return false;
+    std::vector<value::token> properties;
+    for (const auto &name : OrderedNames(ps.propertyNames(), ps.props())) {
+      if (!CollectProperty(path_index, name, ps.props().at(name))) {
+        return false;
+      }
+      properties.push_back(value::token(name));
     }
 
-    if (!WriteStrings()) {
-      PUSH_ERROR("Failed to write Strings.");
-      return false;
+    std::vector<value::token> children;
+    for (const auto &child : ps.children()) {
+      if (!ValidatePrimElementName(child.name())) {
+        PUSH_ERROR_AND_RETURN("Invalid Prim name: " << child.name());
+      }
+      uint32_t idx = AddPathElement(path_index, child.name(), false);
+      if (!CollectPrimSpec(idx, SpecType::Prim, child)) {
+        return false;
+      }
+      children.push_back(value::token(child.name()));
     }
 
-    if (!WriteFields()) {
-      PUSH_ERROR("Failed to write Fields.");
-      return false;
+    std::vector<value::token> variant_sets;
+    for (const auto &vs : ps.variantSets()) {
+      const std::string &vsname = vs.first;
+      // `{vsname=}`
+      uint32_t vs_idx =
+          AddPathElement(path_index, "{" + vsname + "=}", false);
+
+      size_t vs_spec_idx = specs_.size();
+      {
+        SpecEntry spec;
+        spec.path_index = vs_idx;
+        spec.spec_type = SpecType::VariantSet;
+        spec.variant_set = &vs.second;
+        specs_.emplace_back(std::move(spec));
+      }
+
+      std::vector<value::token> variants;
+      for (const auto &variant : vs.second.variantSet) {
+        // `{vsname=variantname}`
+        uint32_t v_idx = AddPathElement(
+            path_index, "{" + vsname + "=" + variant.first + "}", false);
+        if (!CollectPrimSpec(v_idx, SpecType::Variant, variant.second)) {
+          return false;
+        }
+        variants.push_back(value::token(variant.first));
+      }
+
+      specs_[vs_spec_idx].children = std::move(variants);
+      variant_sets.push_back(value::token(vsname));
     }
 
-    if (!WriteFieldSets()) {
-      PUSH_ERROR("Failed to write FieldSets.");
-      return false;
+    specs_[spec_idx].children = std::move(children);
+    specs_[spec_idx].properties = std::move(properties);
+    specs_[spec_idx].variant_set_children = std::move(variant_sets);
+
+    return true;
+  }
+
+  bool CollectSpecs() {
+    // root
+    path_nodes_.push_back(PathNode());
+
+    {
+      SpecEntry spec;
+      spec.path_index = 0;
+      spec.spec_type = SpecType::PseudoRoot;
+      specs_.emplace_back(std::move(spec));
     }
 
-    if (!WritePaths()) {
-      PUSH_ERROR("Failed to write Paths.");
-      return false;
+    // Use std::map to sort root Prims by name when `primChildren` is not
+    // available.
+    std::map<std::string, const PrimSpec *> root_prims;
+    for (const auto &item : layer_.primspecs()) {
+      root_prims.emplace(item.first, &item.second);
     }
 
-    if (!WriteSpecs()) {
-      PUSH_ERROR("Failed to write Specs.");
-      return false;
+    std::vector<value::token> children;
+    for (const auto &name :
+         OrderedNames(layer_.metas().primChildren, root_prims)) {
+      if (!ValidatePrimElementName(name)) {
+        PUSH_ERROR_AND_RETURN("Invalid Prim name: " << name);
+      }
+      uint32_t idx = AddPathElement(0, name, false);
+      if (!CollectPrimSpec(idx, SpecType::Prim, *root_prims.at(name))) {
+        return false;
+      }
+      children.push_back(value::token(name));
     }
+    specs_[0].children = std::move(children);
+
+    return true;
+  }
+
+  // Encode large numeric arrays in parallel.
+  bool EncodeLargeArrays() {
+    encoded_arrays_jobs_.resize(large_arrays_.size());
+
+    thread::ParallelFor(
+        0, large_arrays_.size(), config_.num_threads,
+        [this](size_t i, int thread_id) {
+          (void)thread_id;
+          EncodedArray &dst = encoded_arrays_jobs_[i];
+          if (!EncodeNumericArray(*large_arrays_[i], /* compress */ true,
+                                  &dst.data, &dst.crate_type, &dst.compressed,
+                                  &dst.err)) {
+            if (dst.err.empty()) {
+              dst.err = "Unsupported array type.";
+            }
+          }
+        });
+
+    return true;
+  }
+
+  //
+  // Fields
+  //
+
+  bool AddDictField(const std::string &name, const CustomDataType &dict,
+                    std::vector<uint32_t> *fields) {
+    crate::ValueRep rep;
+    if (!PackDictionary(dict, &rep)) {
+      PUSH_ERROR_AND_RETURN("Failed to encode `" << name << "`");
+    }
+    fields->push_back(AddField(name, rep));
+    return true;
+  }
 
-    // TODO(syoyo): Add feature to support writing unknown section(custom user
-    // data)
-    // if (!WriteUnknownSections()) {
-    //  PUSH_ERROR("Failed to write custom sections.");
-    //  return false;
-    //}
+  bool AddValueField(const std::string &name, const value::Value &v,
+                     std::vector<uint32_t> *fields) {
+    crate::ValueRep rep;
+    if (!PackValue(v, &rep)) {
+      PUSH_ERROR_AND_RETURN("Failed to encode `" << name << "`");
+    }
+    fields->push_back(AddField(name, rep));
+    return true;
+  }
 
-    const uint64_t toc_offset = static_cast<uint64_t>(oss_.tellp());
-    if (!WriteTOC()) {
-      PUSH_ERROR("Failed to write TOC.");
+  bool AddTokenVectorField(const std::string &name,
+                           const std::vector<value::token> &toks,
+                           std::vector<uint32_t> *fields) {
+    if (toks.empty()) {
+      return true;
+    }
+    crate::ValueRep rep;
+    if (!PackTokenVector(toks, &rep)) {
       return false;
     }
+    fields->push_back(AddField(name, rep));
+    return true;
+  }
+
+  bool BuildPseudoRootFields(const SpecEntry &spec,
+                             std::vector<uint32_t> *fields) {
+    const LayerMetas &metas = layer_.metas();
+
+    if (metas.upAxis.authored()) {
+      fields->push_back(
+          AddField("upAxis", TokenRep(to_string(metas.upAxis.get_value()))));
+    }
+
+#define ADD_DOUBLE_META(__name)                                         \
+  if (metas.__name.authored()) {                                        \
+    if (!AddValueField(#__name, value::Value(metas.__name.get_value()), \
+                       fields)) {                                       \
+      return false;                                                     \
+    }                                                                   \
+  }
+
+    ADD_DOUBLE_META(metersPerUnit)
+    ADD_DOUBLE_META(timeCodesPerSecond)
+    ADD_DOUBLE_META(framesPerSecond)
+    ADD_DOUBLE_META(startTimeCode)
+    ADD_DOUBLE_META(endTimeCode)
+
+#undef ADD_DOUBLE_META
+
+    if (metas.subLayers.size()) {
+      std::vector<uint32_t> paths;
+      std::vector<LayerOffset> offsets;
+      for (const auto &sublayer : metas.subLayers) {
+        paths.push_back(AddString(sublayer.assetPath.GetAssetPath()));
+        offsets.push_back(sublayer.layerOffset);
+      }
+      crate::ValueRep rep;
+      if (!PackIndexArray(paths, CrateTypeId::CRATE_DATA_TYPE_STRING_VECTOR,
+                          false, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("subLayers", rep));
+
+      std::vector<uint8_t> data;
+      AppendRawArray(offsets, &data);
+      if (!MakeRep(CrateTypeId::CRATE_DATA_TYPE_LAYER_OFFSET_VECTOR, false,
+                   data, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("subLayerOffsets", rep));
+    }
+
+    if (metas.autoPlay.authored()) {
+      fields->push_back(AddField("autoPlay", BoolRep(metas.autoPlay.get_value())));
+    }
+
+    if (metas.playbackMode.authored()) {
+      const std::string mode =
+          (metas.playbackMode.get_value() ==
+           LayerMetas::PlaybackMode::PlaybackModeNone)
+              ? "none"
+              : "loop";
+      fields->push_back(AddField("playbackMode", TokenRep(mode)));
+    }
+
+    if (metas.defaultPrim.str().size()) {
+      fields->push_back(
+          AddField("defaultPrim", TokenRep(metas.defaultPrim.str())));
+    }
+
+    if (metas.customLayerData.size()) {
+      if (!AddDictField("customLayerData", metas.customLayerData, fields)) {
+        return false;
+      }
+    }
+
+    if (metas.doc.value.size()) {
+      fields->push_back(AddField("documentation", StringRep(metas.doc.value)));
+    }
+
+    if (metas.comment.value.size()) {
+      fields->push_back(AddField("comment", StringRep(metas.comment.value)));
+    }
+
+    return AddTokenVectorField("primChildren", spec.children, fields);
+  }
+
+  bool BuildPrimFields(const SpecEntry &spec, std::vector<uint32_t> *fields) {
+    const PrimSpec &ps = *spec.prim;
+    const PrimMetas &metas = ps.metas();
+
+    fields->push_back(
+        AddField("specifier", InlineRep(CrateTypeId::CRATE_DATA_TYPE_SPECIFIER,
+                                        uint32_t(ps.specifier()))));
+
+    if (ps.typeName().size()) {
+      fields->push_back(AddField("typeName", TokenRep(ps.typeName())));
+    }
+
+    if (metas.active) {
+      fields->push_back(AddField("active", BoolRep(metas.active.value())));
+    }
+    if (metas.hidden) {
+      fields->push_back(AddField("hidden", BoolRep(metas.hidden.value())));
+    }
+    if (metas.instanceable) {
+      fields->push_back(
+          AddField("instanceable", BoolRep(metas.instanceable.value())));
+    }
+    if (metas.kind) {
+      fields->push_back(AddField("kind", TokenRep(metas.get_kind())));
+    }
+
+#define ADD_DICT_META(__name)                                          \
+  if (metas.__name) {                                                  \
+    if (!AddDictField(#__name, metas.__name.value(), fields)) {        \
+      return false;                                                    \
+    }                                                                  \
+  }
+
+    ADD_DICT_META(assetInfo)
+    ADD_DICT_META(customData)
+    ADD_DICT_META(sdrMetadata)
+    ADD_DICT_META(clips)
+
+#undef ADD_DICT_META
+
+    if (metas.doc) {
+      fields->push_back(
+          AddField("documentation", StringRep(metas.doc.value().value)));
+    }
+    if (metas.comment) {
+      fields->push_back(
+          AddField("comment", StringRep(metas.comment.value().value)));
+    }
+    if (metas.sceneName) {
+      fields->push_back(
+          AddField("sceneName", StringRep(metas.sceneName.value())));
+    }
+    if (metas.displayName) {
+      fields->push_back(
+          AddField("displayName", StringRep(metas.displayName.value())));
+    }
+
+    if (metas.apiSchemas && metas.apiSchemas.value().names.size()) {
+      std::vector<value::token> names;
+      for (const auto &item : metas.apiSchemas.value().names) {
+        std::string name = to_string(item.first);
+        if (item.second.size()) {
+          name += ":" + item.second;
+        }
+        names.push_back(value::token(name));
+      }
+      crate::ValueRep rep;
+      if (!PackTokenListOp(metas.apiSchemas.value().listOpQual, names, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("apiSchemas", rep));
+    }
+
+    if (metas.variants) {
+      std::vector<uint8_t> data;
+      AppendU64(uint64_t(metas.variants.value().size()), &data);
+      for (const auto &item : metas.variants.value()) {
+        AppendU32(AddString(item.first), &data);
+        AppendU32(AddString(item.second), &data);
+      }
+      crate::ValueRep rep;
+      if (!MakeRep(CrateTypeId::CRATE_DATA_TYPE_VARIANT_SELECTION_MAP, false,
+                   data, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("variantSelection", rep));
+    }
+
+    if (metas.variantSets &&
+        IsEncodableListOp("variantSets", metas.variantSets.value().first,
+                          metas.variantSets.value().second)) {
+      crate::ValueRep rep;
+      if (!PackStringListOp(metas.variantSets.value().first,
+                            metas.variantSets.value().second, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("variantSetNames", rep));
+    }
 
-    // write header
-    oss_.seekp(0, std::ios::beg);
-    if (!WriteHeader(toc_offset)) {
-      PUSH_ERROR("Failed to write Header.");
+    // Path ListOps
+    {
+      const std::pair<const char *,
+                      const nonstd::optional<
+                          std::pair<ListEditQual, std::vector<Path>>> *>
+          path_listops[] = {{"inherits", &metas.inherits},
+                            {"specializes", &metas.specializes},
+                            {"inheritPaths", &metas.inheritPaths}};
+      for (const auto &item : path_listops) {
+        const auto &listop = *item.second;
+        if (!listop ||
+            !IsEncodableListOp(item.first, listop.value().first,
+                               listop.value().second)) {
+          continue;
+        }
+        crate::ValueRep rep;
+        if (listop.value().second.empty() &&
+            (std::string(item.first) == "inherits")) {
+          // `inherits = None`
+          rep = ValueBlockRep();
+        } else if (!PackPathListOp(listop.value().first,
+                                   listop.value().second, &rep)) {
+          return false;
+        }
+        fields->push_back(AddField(item.first, rep));
+      }
+    }
+
+    if (metas.references &&
+        IsEncodableListOp("references", metas.references.value().first,
+                          metas.references.value().second)) {
+      crate::ValueRep rep;
+      if (metas.references.value().second.empty()) {
+        // `references = None`
+        rep = ValueBlockRep();
+      } else if (!PackReferenceListOp(metas.references.value().first,
+                                      metas.references.value().second, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("references", rep));
+    }
+
+    if (metas.payload &&
+        IsEncodableListOp("payload", metas.payload.value().first,
+                          metas.payload.value().second)) {
+      crate::ValueRep rep;
+      if (metas.payload.value().second.empty()) {
+        // `payload = None`
+        rep = ValueBlockRep();
+      } else if (!PackPayloadListOp(metas.payload.value().first,
+                                    metas.payload.value().second, &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("payload", rep));
+    }
+
+    for (const auto &item : metas.unregisteredMetas) {
+      fields->push_back(AddField(item.first, StringRep(item.second)));
+    }
+
+    for (const auto &item : metas.meta) {
+      if (!AddValueField(item.first, item.second.get_raw_value(), fields)) {
+        return false;
+      }
+    }
+
+    if (!AddTokenVectorField("primChildren", spec.children, fields)) {
+      return false;
+    }
+    if (!AddTokenVectorField("properties", spec.properties, fields)) {
+      return false;
+    }
+    if (!AddTokenVectorField("variantSetChildren", spec.variant_set_children,
+                             fields)) {
       return false;
     }
 
     return true;
   }
 
-  // Get serialized USDC binary data
-  bool GetOutput(std::vector<uint8_t> *output) {
-    if (!err_.empty()) {
-      return false;
+  bool BuildPropertyMetaFields(const AttrMeta &metas,
+                               std::vector<uint32_t> *fields) {
+    if (metas.interpolation) {
+      fields->push_back(AddField(
+          "interpolation", TokenRep(to_string(metas.interpolation.value()))));
+    }
+    if (metas.elementSize) {
+      fields->push_back(AddField(
+          "elementSize", InlineRep(CrateTypeId::CRATE_DATA_TYPE_INT,
+                                   metas.elementSize.value())));
+    }
+    if (metas.hidden) {
+      fields->push_back(AddField("hidden", BoolRep(metas.hidden.value())));
+    }
+    if (metas.comment) {
+      fields->push_back(
+          AddField("comment", StringRep(metas.comment.value().value)));
+    } else if (metas.stringData.size()) {
+      // Unnamed string metadatum is `comment` in pxrUSD.
+      fields->push_back(
+          AddField("comment", StringRep(metas.stringData[0].value)));
+    }
+    if (metas.displayName) {
+      fields->push_back(
+          AddField("displayName", StringRep(metas.displayName.value())));
+    }
+    if (metas.customData) {
+      if (!AddDictField("customData", metas.customData.value(), fields)) {
+        return false;
+      }
+    }
+    if (metas.sdrMetadata) {
+      if (!AddDictField("sdrMetadata", metas.sdrMetadata.value(), fields)) {
+        return false;
+      }
+    }
+    if (metas.weight) {
+      // pxrUSD uses float for `weight`.
+      if (!AddValueField("weight", value::Value(float(metas.weight.value())),
+                         fields)) {
+        return false;
+      }
     }
 
-    (void)output;
+#define ADD_TOKEN_META(__name)                                          \
+  if (metas.__name) {                                                   \
+    fields->push_back(AddField(#__name, TokenRep(metas.__name.value().str()))); \
+  }
+
+    ADD_TOKEN_META(connectability)
+    ADD_TOKEN_META(outputName)
+    ADD_TOKEN_META(renderType)
+    ADD_TOKEN_META(bindMaterialAs)
 
-    // TODO
-    return false;
+#undef ADD_TOKEN_META
+
+    // Other metadata(e.g. `colorSpace`)
+    for (const auto &item : metas.meta) {
+      if (!AddValueField(item.first, item.second.get_raw_value(), fields)) {
+        return false;
+      }
+    }
+
+    return true;
   }
 
- private:
-  Writer() = delete;
-  Writer(const Writer &) = delete;
+  bool BuildAttributeFields(const SpecEntry &spec,
+                            std::vector<uint32_t> *fields) {
+    const Property &prop = *spec.prop;
+    const Attribute &attr = prop.get_attribute();
+    const primvar::PrimVar &var = attr.get_var();
+
+    const std::string type_name = attr.type_name();
+    if (type_name.empty()) {
+      PUSH_ERROR_AND_RETURN("Attribute has no type name.");
+    }
+    fields->push_back(AddField("typeName", TokenRep(type_name)));
+
+    if (prop.has_custom()) {
+      fields->push_back(AddField("custom", BoolRep(true)));
+    }
+
+    if ((attr.variability() != Variability::Varying) ||
+        attr.is_varying_authored()) {
+      fields->push_back(AddField(
+          "variability", InlineRep(CrateTypeId::CRATE_DATA_TYPE_VARIABILITY,
+                                   uint32_t(attr.variability()))));
+    }
+
+    if (var.is_blocked()) {
+      fields->push_back(AddField("default", ValueBlockRep()));
+    } else if (var.has_value()) {
+      crate::ValueRep rep;
+      if (!PackValue(var.value_raw(), &rep)) {
+        PUSH_ERROR_AND_RETURN("Failed to encode `default` value.");
+      }
+      fields->push_back(AddField("default", rep));
+    }
+
+    if (var.has_timesamples()) {
+      crate::ValueRep rep;
+      if (!PackTimeSamples(var.ts_raw(), &rep)) {
+        PUSH_ERROR_AND_RETURN("Failed to encode `timeSamples`.");
+      }
+      fields->push_back(AddField("timeSamples", rep));
+    }
+
+    if (attr.connections().size()) {
+      crate::ValueRep rep;
+      if (!PackPathListOp(ListEditQual::ResetToExplicit, attr.connections(),
+                          &rep)) {
+        return false;
+      }
+      fields->push_back(AddField("connectionPaths", rep));
+    }
+
+    return BuildPropertyMetaFields(attr.metas(), fields);
+  }
+
+  bool BuildRelationshipFields(const SpecEntry &spec,
+                               std::vector<uint32_t> *fields) {
+    const Property &prop = *spec.prop;
+    const Relationship &rel = prop.get_relationship();
+
+    if (prop.has_custom()) {
+      fields->push_back(AddField("custom", BoolRep(true)));
+    }
+
+    if (rel.is_varying_authored()) {
+      fields->push_back(AddField(
+          "variability", InlineRep(CrateTypeId::CRATE_DATA_TYPE_VARIABILITY,
+                                   uint32_t(Variability::Varying))));
+    }
+
+    if (prop.get_property_type() != Property::Type::NoTargetsRelation &&
+        rel.has_value()) {
+      std::vector<Path> targets;
+      ListEditQual qual = prop.get_listedit_qual();
+      if (rel.is_blocked()) {
+        // `rel myrel = None` is encoded as explicit empty ListOp.
+        qual = ListEditQual::ResetToExplicit;
+      } else if (rel.is_path()) {
+        targets.push_back(rel.targetPath);
+      } else {
+        targets = rel.targetPathVector;
+      }
+
+      if (IsEncodableListOp("targetPaths", qual, targets)) {
+        crate::ValueRep rep;
+        if (!PackPathListOp(qual, targets, &rep)) {
+          return false;
+        }
+        fields->push_back(AddField("targetPaths", rep));
+      }
+    }
 
-  TableOfContents toc_;
+    return BuildPropertyMetaFields(rel.metas(), fields);
+  }
+
+  bool BuildFields(const SpecEntry &spec, std::vector<uint32_t> *fields) {
+    switch (spec.spec_type) {
+      case SpecType::PseudoRoot:
+        return BuildPseudoRootFields(spec, fields);
+      case SpecType::Prim:
+      case SpecType::Variant:
+        if (!BuildPrimFields(spec, fields)) {
+          PUSH_ERROR_AND_RETURN("Failed to encode Prim `" << spec.prim->name()
+                                                          << "`");
+        }
+        return true;
+      case SpecType::VariantSet:
+        return AddTokenVectorField("variantChildren", spec.children, fields);
+      case SpecType::Attribute:
+        return BuildAttributeFields(spec, fields);
+      case SpecType::Relationship:
+        return BuildRelationshipFields(spec, fields);
+      default:
+        break;
+    }
 
-  Packer packer_;
+    PUSH_ERROR_AND_RETURN("Unsupported spec type: " << to_string(spec.spec_type));
+  }
 
   //
-  // Serialized data
+  // Sections
   //
-  std::ostringstream oss_;
+
+  bool WriteCompressedInts(const std::vector<uint32_t> &ints) {
+    std::string err;
+    if (!crate::CompressInts(ints.data(), ints.size(), &out_, &err)) {
+      PUSH_ERROR_AND_RETURN(err);
+    }
+    return true;
+  }
+
+  bool WriteCompressedInts(const std::vector<int32_t> &ints) {
+    std::string err;
+    if (!crate::CompressInts(ints.data(), ints.size(), &out_, &err)) {
+      PUSH_ERROR_AND_RETURN(err);
+    }
+    return true;
+  }
+
+  bool WriteLZ4(const std::vector<char> &src) {
+    std::vector<char> buf(LZ4Compression::GetCompressedBufferSize(src.size()));
+    std::string err;
+    size_t n = LZ4Compression::CompressToBuffer(src.data(), buf.data(),
+                                                src.size(), &err);
+    if ((n == ~size_t(0)) || !err.empty()) {
+      PUSH_ERROR_AND_RETURN("LZ4 compression failed: " + err);
+    }
+    AppendU64(uint64_t(n), &out_);
+    AppendBytes(buf.data(), n, &out_);
+    return true;
+  }
+
+  bool WriteTokens() {
+    // Tokens are '\0' terminated, then compressed with LZ4.
+    std::vector<char> buf;
+    for (const auto &tok : tokens_) {
+      buf.insert(buf.end(), tok.begin(), tok.end());
+      buf.push_back('\0');
+    }
+
+    AppendU64(uint64_t(tokens_.size()), &out_);
+    AppendU64(uint64_t(buf.size()), &out_);
+    return WriteLZ4(buf);
+  }
+
+  bool WriteStrings() {
+    AppendRawArray(strings_, &out_);
+    return true;
+  }
+
+  bool WriteFields() {
+    AppendU64(uint64_t(fields_.size()), &out_);
+    if (fields_.empty()) {
+      return true;
+    }
+
+    std::vector<uint32_t> tokens(fields_.size());
+    std::vector<char> reps(fields_.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < fields_.size(); i++) {
+      tokens[i] = fields_[i].first;
+      memcpy(&reps[i * sizeof(uint64_t)], &fields_[i].second,
+             sizeof(uint64_t));
+    }
+
+    if (!WriteCompressedInts(tokens)) {
+      return false;
+    }
+    return WriteLZ4(reps);
+  }
+
+  bool WriteFieldSets() {
+    AppendU64(uint64_t(fieldsets_.size()), &out_);
+    return WriteCompressedInts(fieldsets_);
+  }
+
+  // DFS pre-order. `jumps` tells the reader where the sibling is.
+  void EncodePathTree(const std::vector<uint32_t> &siblings,
+                      std::vector<uint32_t> *path_indices,
+                      std::vector<int32_t> *elem_tokens,
+                      std::vector<int32_t> *jumps) const {
+    for (size_t i = 0; i < siblings.size(); i++) {
+      const PathNode &node = path_nodes_[siblings[i]];
+      const size_t pos = path_indices->size();
+      path_indices->push_back(siblings[i]);
+      elem_tokens->push_back(node.element);
+      jumps->push_back(0);
+
+      const bool has_child = node.children.size();
+      const bool has_sibling = (i + 1) < siblings.size();
+      if (has_child) {
+        EncodePathTree(node.children, path_indices, elem_tokens, jumps);
+      }
+
+      if (has_child && has_sibling) {
+        (*jumps)[pos] = int32_t(path_indices->size() - pos);
+      } else if (has_sibling) {
+        (*jumps)[pos] = 0;
+      } else if (has_child) {
+        (*jumps)[pos] = -1;
+      } else {
+        (*jumps)[pos] = -2;
+      }
+    }
+  }
+
+  bool WritePaths() {
+    std::vector<uint32_t> path_indices;
+    std::vector<int32_t> elem_tokens;
+    std::vector<int32_t> jumps;
+    EncodePathTree({0}, &path_indices, &elem_tokens, &jumps);
+
+    AppendU64(uint64_t(path_nodes_.size()), &out_);
+    AppendU64(uint64_t(path_indices.size()), &out_);
+
+    return WriteCompressedInts(path_indices) &&
+           WriteCompressedInts(elem_tokens) && WriteCompressedInts(jumps);
+  }
+
+  bool WriteSpecs() {
+    std::vector<uint32_t> path_indices(specs_.size());
+    std::vector<uint32_t> spec_types(specs_.size());
+    for (size_t i = 0; i < specs_.size(); i++) {
+      path_indices[i] = specs_[i].path_index;
+      spec_types[i] = uint32_t(specs_[i].spec_type);
+    }
+
+    AppendU64(uint64_t(specs_.size()), &out_);
+    return WriteCompressedInts(path_indices) &&
+           WriteCompressedInts(spec_fieldsets_) &&
+           WriteCompressedInts(spec_types);
+  }
+
+  const Layer &layer_;
+  const USDCWriterConfig config_;
+
+  std::vector<std::string> tokens_;
+  std::unordered_map<std::string, uint32_t> token_map_;
+
+  std::vector<uint32_t> strings_;  // TokenIndex
+  std::unordered_map<std::string, uint32_t> string_map_;
+
+  std::vector<PathNode> path_nodes_;  // [0] = root
+  std::map<std::pair<uint32_t, int32_t>, uint32_t> path_child_map_;
+  nonstd::optional<uint32_t> empty_path_index_;
+
+  std::vector<std::pair<uint32_t, uint64_t>> fields_;  // (TokenIndex, ValueRep)
+  std::map<std::pair<uint32_t, uint64_t>, uint32_t> field_map_;
+
+  std::vector<uint32_t> fieldsets_;  // FieldIndex. ~0 = terminator
+  std::map<std::vector<uint32_t>, uint32_t> fieldset_map_;
+
+  std::vector<SpecEntry> specs_;
+  std::vector<uint32_t> spec_fieldsets_;
+
+  // Large numeric arrays encoded in `EncodeLargeArrays`.
+  std::vector<const value::Value *> large_arrays_;
+  std::vector<EncodedArray> encoded_arrays_jobs_;
+  std::unordered_map<const value::Value *, size_t> encoded_arrays_;
+
+  // hash -> (offset, size) of written value data.
+  std::unordered_multimap<uint64_t, std::pair<uint64_t, uint64_t>> data_map_;
+
+  // Serialized data
+  std::vector<uint8_t> out_;
 
   std::string err_;
   std::string warn_;
@@ -479,12 +1957,87 @@ class Writer {
 
 }  // namespace
 
+bool SaveAsUSDCToMemory(const Layer &layer, std::vector<uint8_t> *output,
+                        std::string *warn, std::string *err,
+                        const USDCWriterConfig &config) {
+  if (!output) {
+    if (err) {
+      (*err) += "`output` argument is nullptr.\n";
+    }
+    return false;
+  }
+
+  Writer writer(layer, config);
+  bool ret = writer.Write(output);
+
+  if (warn && writer.GetWarning().size()) {
+    (*warn) += writer.GetWarning();
+  }
+
+  if (!ret) {
+    if (err) {
+      (*err) += writer.GetError();
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool SaveAsUSDCToMemory(const Stage &stage, std::vector<uint8_t> *output,
+                        std::string *warn, std::string *err,
+                        const USDCWriterConfig &config) {
+#if defined(TINYUSDZ_WITH_TYDRA)
+  // Stage(Prim tree) -> Layer(PrimSpec tree).
+  Layer layer;
+  layer.metas() = stage.metas();
+
+  // Keep the order of root Prims.
+  std::vector<value::token> root_names;
+  for (const auto &prim : stage.root_prims()) {
+    PrimSpec ps;
+    std::string ps_err;
+    if (!tydra::PrimToPrimSpec(prim, ps, &ps_err)) {
+      if (err) {
+        (*err) += "Failed to convert Prim `" + prim.element_name() +
+                  "` to PrimSpec: " + ps_err + "\n";
+      }
+      return false;
+    }
+
+    const std::string name = ps.name();
+    if (!layer.emplace_primspec(name, std::move(ps))) {
+      if (err) {
+        (*err) += "Invalid or duplicated root Prim name: `" + name + "`\n";
+      }
+      return false;
+    }
+    root_names.push_back(value::token(name));
+  }
+  layer.metas().primChildren = root_names;
+
+  return SaveAsUSDCToMemory(layer, output, warn, err, config);
+#else
+  (void)stage;
+  (void)output;
+  (void)warn;
+  (void)config;
+
+  if (err) {
+    (*err) += "Saving Stage as USDC requires Tydra module(TINYUSDZ_WITH_TYDRA).\n";
+  }
+  return false;
+#endif
+}
+
 bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
-                      std::string *warn, std::string *err) {
+                      std::string *warn, std::string *err,
+                      const USDCWriterConfig &config) {
 #ifdef __ANDROID__
   (void)filename;
   (void)stage;
   (void)warn;
+  (void)config;
 
   if (err) {
     (*err) += "Saving USDC to a file is not supported for Android platform(at the moment).\n";
@@ -494,7 +2047,7 @@ bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
 
   std::vector<uint8_t> output;
 
-  if (!SaveAsUSDCToMemory(stage, &output, warn, err)) {
+  if (!SaveAsUSDCToMemory(stage, &output, warn, err, config)) {
     return false;
   }
 
@@ -531,6 +2084,7 @@ bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
 #endif
 
   size_t n = fwrite(output.data(), /* size */ 1, /* count */ output.size(), fp);
+  fclose(fp);
   if (n < output.size()) {
     // TODO: Retry writing data when n < output.size()
 
@@ -544,21 +2098,6 @@ bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
 #endif
 }
 
-bool SaveAsUSDCToMemory(const Stage &stage, std::vector<uint8_t> *output,
-                        std::string *warn, std::string *err) {
-  (void)warn;
-  (void)output;
-
-  // TODO
-  Writer writer(stage);
-
-  if (err) {
-    (*err) += "USDC writer is not yet implemented.\n";
-  }
-
-  return false;
-}
-
 }  // namespace usdc
 }  // namespace tinyusdz
 
@@ -568,10 +2107,12 @@ namespace tinyusdz {
 namespace usdc {
 
 bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
-                      std::string *warn, std::string *err) {
+                      std::string *warn, std::string *err,
+                      const USDCWriterConfig &config) {
   (void)filename;
   (void)stage;
   (void)warn;
+  (void)config;
 
   if (err) {
     (*err) = "USDC writer feature is disabled in this build.\n";
@@ -581,10 +2122,27 @@ bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
 }
 
 bool SaveAsUSDCToMemory(const Stage &stage, std::vector<uint8_t> *output,
-                        std::string *warn, std::string *err) {
+                        std::string *warn, std::string *err,
+                        const USDCWriterConfig &config) {
   (void)stage;
   (void)output;
   (void)warn;
+  (void)config;
+
+  if (err) {
+    (*err) = "USDC writer feature is disabled in this build.\n";
+  }
+
+  return false;
+}
+
+bool SaveAsUSDCToMemory(const Layer &layer, std::vector<uint8_t> *output,
+                        std::string *warn, std::string *err,
+                        const USDCWriterConfig &config) {
+  (void)layer;
+  (void)output;
+  (void)warn;
+  (void)config;
 
   if (err) {
     (*err) = "USDC writer feature is disabled in this build.\n";
@@ -8,6 +8,22 @@
 namespace tinyusdz {
 namespace usdc {
 
+struct USDCWriterConfig {
+  // The number of threads to compress large arrays. -1 = use system's # of
+  // threads. Worker threads are only spawned when TinyUSDZ is built with
+  // `TINYUSDZ_ENABLE_THREAD`.
+  int32_t num_threads = -1;
+
+  // Compress int/float arrays(Usd_IntegerCompression, float-as-int and
+  // look-up table encoding). Index tables(fields, paths, specs, ...) are
+  // always compressed.
+  bool compress_arrays = true;
+
+  // Share the serialized data of identical values(e.g. same `points` in many
+  // Prims).
+  bool deduplicate_values = true;
+};
+
 ///
 /// Save scene as USDC(binary) to a file
 ///
@@ -15,24 +31,48 @@ namespace usdc {
 /// @param[in] stage Stage
 /// @param[out] warn Warning message
 /// @param[out] err Error message
+/// @param[in] config Writer config
 ///
 /// @return true upon success.
 ///
 bool SaveAsUSDCToFile(const std::string &filename, const Stage &stage,
-                      std::string *warn, std::string *err);
+                      std::string *warn, std::string *err,
+                      const USDCWriterConfig &config = USDCWriterConfig());
 
 ///
 /// Save scene as USDC(binary) to a memory
 ///
+/// Stage is converted to Layer(PrimSpec tree) before writing. Requires Tydra
+/// module(`TINYUSDZ_WITH_TYDRA`).
+///
 /// @param[in] stage Stage
 /// @param[out] output Binary data
 /// @param[out] warn Warning message
 /// @param[out] err Error message
+/// @param[in] config Writer config
 ///
 /// @return true upon success.
 ///
 bool SaveAsUSDCToMemory(const Stage &stage, std::vector<uint8_t> *output,
-                        std::string *warn, std::string *err);
+                        std::string *warn, std::string *err,
+                        const USDCWriterConfig &config = USDCWriterConfig());
+
+///
+/// Save Layer as USDC(binary) to a memory
+///
+/// Output can be read with `LoadUSDCLayerFromMemory`(or `LoadUSDCFromMemory`).
+///
+/// @param[in] layer Layer
+/// @param[out] output Binary data
+/// @param[out] warn Warning message
+/// @param[out] err Error message
+/// @param[in] config Writer config
+///
+/// @return true upon success.
+///
+bool SaveAsUSDCToMemory(const Layer &layer, std::vector<uint8_t> *output,
+                        std::string *warn, std::string *err,
+                        const USDCWriterConfig &config = USDCWriterConfig());
 
 }  // namespace usdc
 }  // namespace tinyusdz
@@ -1885,6 +1885,120 @@ inline std::vector<T> lerp(const std::vector<T> &a, const std::vector<T> &b,
   return dst;
 }
 
+//
+// Types whose lerp is a component-wise lerp of a flat float/double array.
+// Arrays of these types are interpolated with `lerp_flat`, which the compiler
+// can auto-vectorize.
+//
+template <typename T>
+struct FlatLerpTraits {
+  using component_type = void;
+  static constexpr bool supported() { return false; }
+};
+
+#define TUSD_FLAT_LERP_TRAIT(__ty, __comp_ty)                       \
+  template <>                                                      \
+  struct FlatLerpTraits<__ty> {                                    \
+    using component_type = __comp_ty;                              \
+    static constexpr bool supported() { return true; }            \
+    static constexpr size_t ncomps() {                             \
+      return sizeof(__ty) / sizeof(__comp_ty);                     \
+    }                                                              \
+  };
+
+TUSD_FLAT_LERP_TRAIT(float, float)
+TUSD_FLAT_LERP_TRAIT(value::float2, float)
+TUSD_FLAT_LERP_TRAIT(value::float3, float)
+TUSD_FLAT_LERP_TRAIT(value::float4, float)
+TUSD_FLAT_LERP_TRAIT(double, double)
+TUSD_FLAT_LERP_TRAIT(value::double2, double)
+TUSD_FLAT_LERP_TRAIT(value::double3, double)
+TUSD_FLAT_LERP_TRAIT(value::double4, double)
+TUSD_FLAT_LERP_TRAIT(value::normal3f, float)
+TUSD_FLAT_LERP_TRAIT(value::normal3d, double)
+TUSD_FLAT_LERP_TRAIT(value::vector3f, float)
+TUSD_FLAT_LERP_TRAIT(value::vector3d, double)
+TUSD_FLAT_LERP_TRAIT(value::point3f, float)
+TUSD_FLAT_LERP_TRAIT(value::point3d, double)
+TUSD_FLAT_LERP_TRAIT(value::color3f, float)
+TUSD_FLAT_LERP_TRAIT(value::color3d, double)
+TUSD_FLAT_LERP_TRAIT(value::color4f, float)
+TUSD_FLAT_LERP_TRAIT(value::color4d, double)
+TUSD_FLAT_LERP_TRAIT(value::texcoord2f, float)
+TUSD_FLAT_LERP_TRAIT(value::texcoord2d, double)
+TUSD_FLAT_LERP_TRAIT(value::texcoord3f, float)
+TUSD_FLAT_LERP_TRAIT(value::texcoord3d, double)
+TUSD_FLAT_LERP_TRAIT(value::matrix2d, double)
+TUSD_FLAT_LERP_TRAIT(value::matrix3d, double)
+TUSD_FLAT_LERP_TRAIT(value::matrix4d, double)
+
+#undef TUSD_FLAT_LERP_TRAIT
+
+///
+/// dst[i] = (1 - t) * a[i] + t * b[i] for i in [0, n)
+/// Gives the same result as the inlined `lerp` of each component.
+///
+template <typename C>
+inline void lerp_flat(const C *a, const C *b, const size_t n, const double t,
+                      C *dst) {
+  const C t0 = C(1.0 - t);
+  const C t1 = C(t);
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = t0 * a[i] + t1 * b[i];
+  }
+}
+
+namespace detail {
+
+template <typename T>
+inline void lerp_array(const T *a, const T *b, const size_t n, const double t,
+                       T *dst, std::true_type) {
+  using C = typename FlatLerpTraits<T>::component_type;
+  lerp_flat(reinterpret_cast<const C *>(a), reinterpret_cast<const C *>(b),
+            n * FlatLerpTraits<T>::ncomps(), t, reinterpret_cast<C *>(dst));
+}
+
+template <typename T>
+inline void lerp_array(const T *a, const T *b, const size_t n, const double t,
+                       T *dst, std::false_type) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = lerp(a[i], b[i], t);
+  }
+}
+
+}  // namespace detail
+
+///
+/// Interpolate values and write the result to `dst`.
+/// Same result as `(*dst) = lerp(a, b, t)`, but the storage of `dst` is
+/// reused for array types, so this is suited for evaluating many time samples.
+///
+template <typename T>
+inline void lerp_to(const T &a, const T &b, const double t, T *dst) {
+  (*dst) = lerp(a, b, t);
+}
+
+template <typename T>
+inline void lerp_to(const std::vector<T> &a, const std::vector<T> &b,
+                    const double t, std::vector<T> *dst) {
+  // Choose shorter one(same as `lerp`)
+  size_t n = (std::min)(a.size(), b.size());
+
+  if (a.size() != b.size()) {
+    dst->assign(n, T());
+    return;
+  }
+
+  dst->resize(n);
+  if (n == 0) {
+    return;
+  }
+
+  detail::lerp_array(
+      a.data(), b.data(), n, t, dst->data(),
+      std::integral_constant<bool, FlatLerpTraits<T>::supported()>());
+}
+
 template <>
 inline value::quath lerp(const value::quath &a, const value::quath &b, const double t) {
   // to float.
@@ -9,6 +9,7 @@
 #include "pprinter.hh"
 #include "prim-types.hh"
 #include "str-util.hh"
+#include "thread-util.hh"
 #include "usdGeom.hh"
 #include "usdLux.hh"
 #include "value-types.hh"
@@ -551,21 +552,22 @@ std::ostream &operator<<(std::ostream &ofs,
 
 template <>
 std::ostream &operator<<(std::ostream &ofs, const std::vector<double> &v) {
-  // Not sure what is the HARD-LIMT buffer length for dtoa_milo,
-  // but according to std::numeric_limits<double>::digits10(=15),
-  // 32 should be sufficient, but allocate 128 just in case
-  char buf[128];
-
-  // TODO: multi-threading for further performance gain?
-
   ofs << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i > 0) {
-      ofs << ", ";
-    }
-    dtoa_milo(v[i], buf);
-    ofs << std::string(buf);
-  }
+  tinyusdz::value::print_array_elements(
+      ofs, v.size(), [&v](size_t begin, size_t end, std::ostream &dst) {
+        // Not sure what is the HARD-LIMT buffer length for dtoa_milo,
+        // but according to std::numeric_limits<double>::digits10(=15),
+        // 32 should be sufficient, but allocate 128 just in case
+        char buf[128];
+
+        for (size_t i = begin; i < end; i++) {
+          if (i > 0) {
+            dst << ", ";
+          }
+          dtoa_milo(v[i], buf);
+          dst << buf;
+        }
+      });
   ofs << "]";
 
   return ofs;
@@ -573,116 +575,80 @@ std::ostream &operator<<(std::ostream &ofs, const std::vector<double> &v) {
 
 template <>
 std::ostream &operator<<(std::ostream &ofs, const std::vector<float> &v) {
-  // Use floaxie
-  char buf[128];
-
-  // TODO: multi-threading for further performance gain?
-
   ofs << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i > 0) {
-      ofs << ", ";
-    }
-    floaxie::ftoa(v[i], buf);
-    ofs << std::string(buf);
-  }
+  tinyusdz::value::print_array_elements(
+      ofs, v.size(), [&v](size_t begin, size_t end, std::ostream &dst) {
+        // Use floaxie
+        char buf[128];
+
+        for (size_t i = begin; i < end; i++) {
+          if (i > 0) {
+            dst << ", ";
+          }
+          floaxie::ftoa(v[i], buf);
+          dst << buf;
+        }
+      });
   ofs << "]";
 
   return ofs;
 }
 
-template <>
-std::ostream &operator<<(std::ostream &ofs, const std::vector<int32_t> &v) {
+}  // namespace std
+
+namespace tinyusdz {
+namespace {
+
+template <typename T>
+std::ostream &print_int_array(std::ostream &ofs, const std::vector<T> &v) {
+  ofs << "[";
+  value::print_array_elements(
+      ofs, v.size(), [&v](size_t begin, size_t end, std::ostream &dst) {
 #if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-  // numeric_limits<uint64_t>::digits10 is 19, so 32 should suffice.
-  char buf[32];
+        // numeric_limits<uint64_t>::digits10 is 19, so 32 should suffice.
+        char buf[32];
 #endif
 
-  ofs << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i > 0) {
-      ofs << ", ";
-    }
+        for (size_t i = begin; i < end; i++) {
+          if (i > 0) {
+            dst << ", ";
+          }
 #if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-    tinyusdz::itoa(v[i], buf);
-    ofs << buf;
+          tinyusdz::itoa(v[i], buf);
+          dst << buf;
 #else
-    ofs << v[i];
+          dst << v[i];
 #endif
-  }
+        }
+      });
   ofs << "]";
 
   return ofs;
 }
 
-template <>
-std::ostream &operator<<(std::ostream &ofs, const std::vector<uint32_t> &v) {
-#if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-  char buf[32];
-#endif
+}  // namespace
+}  // namespace tinyusdz
 
-  ofs << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i > 0) {
-      ofs << ", ";
-    }
-#if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-    tinyusdz::itoa(v[i], buf);
-    ofs << buf;
-#else
-    ofs << v[i];
-#endif
-  }
-  ofs << "]";
+namespace std {
 
-  return ofs;
+template <>
+std::ostream &operator<<(std::ostream &ofs, const std::vector<int32_t> &v) {
+  return tinyusdz::print_int_array(ofs, v);
 }
 
 template <>
-std::ostream &operator<<(std::ostream &ofs, const std::vector<int64_t> &v) {
-#if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-  // numeric_limits<uint64_t>::digits10 is 19, so 32 should suffice.
-  char buf[32];
-#endif
-
-  ofs << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i > 0) {
-      ofs << ", ";
-    }
-#if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-    tinyusdz::itoa(v[i], buf);
-    ofs << buf;
-#else
-    ofs << v[i];
-#endif
-  }
-  ofs << "]";
+std::ostream &operator<<(std::ostream &ofs, const std::vector<uint32_t> &v) {
+  return tinyusdz::print_int_array(ofs, v);
+}
 
-  return ofs;
+template <>
+std::ostream &operator<<(std::ostream &ofs, const std::vector<int64_t> &v) {
+  return tinyusdz::print_int_array(ofs, v);
 }
 
 template <>
 std::ostream &operator<<(std::ostream &ofs, const std::vector<uint64_t> &v) {
-#if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-  char buf[32];
-#endif
-
-  ofs << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    if (i > 0) {
-      ofs << ", ";
-    }
-#if defined(TINYUSDZ_LOCAL_USE_JEAIII_ITOA)
-    tinyusdz::itoa(v[i], buf);
-    ofs << buf;
-#else
-    ofs << v[i];
-#endif
-  }
-  ofs << "]";
-
-  return ofs;
+  return tinyusdz::print_int_array(ofs, v);
 }
 
 }  // namespace std
@@ -690,6 +656,37 @@ std::ostream &operator<<(std::ostream &ofs, const std::vector<uint64_t> &v) {
 namespace tinyusdz {
 namespace value {
 
+void print_array_elements(
+    std::ostream &os, const size_t n,
+    const std::function<void(size_t begin, size_t end, std::ostream &dst)>
+        &fn) {
+  // Elements per chunk.
+  constexpr size_t kChunkSize = 16 * 1024;
+
+  if ((n < kParallelPrintArraySize) || !thread::IsThreadingEnabled()) {
+    fn(0, n, os);
+    return;
+  }
+
+  const size_t num_chunks = (n + kChunkSize - 1) / kChunkSize;
+  std::vector<std::string> chunks(num_chunks);
+
+  thread::ParallelFor(0, num_chunks, /* num_threads */ -1,
+                      [&](size_t c, int thread_id) {
+                        (void)thread_id;
+                        std::ostringstream ss;
+                        // Inherit formatting flags(e.g. precision).
+                        ss.copyfmt(os);
+                        const size_t begin = c * kChunkSize;
+                        fn(begin, (std::min)(n, begin + kChunkSize), ss);
+                        chunks[c] = ss.str();
+                      });
+
+  for (const auto &chunk : chunks) {
+    os.write(chunk.data(), std::streamsize(chunk.size()));
+  }
+}
+
 // Simple brute-force way..
 // TODO: Use std::function or some template technique?
 // NOTE: Use dedicated path for `float` and `double`
@@ -866,8 +863,8 @@ std::string pprint_any(const linb::any &v, const uint32_t indent,
 }
 #endif
 
-std::string pprint_value(const value::Value &v, const uint32_t indent,
-                         bool closing_brace) {
+void pprint_value(std::ostream &os, const value::Value &v,
+                  const uint32_t indent, bool closing_brace) {
 #define BASETYPE_CASE_EXPR(__ty)                           \
   case TypeTraits<__ty>::type_id(): {                      \
     auto p = v.as<__ty>();                                 \
@@ -901,8 +898,6 @@ std::string pprint_value(const value::Value &v, const uint32_t indent,
     break;                                               \
   }
 
-  std::stringstream os;
-
   switch (v.type_id()) {
     // base type
     CASE_EXPR_LIST(BASETYPE_CASE_EXPR)
@@ -1067,7 +1062,12 @@ std::string pprint_value(const value::Value &v, const uint32_t indent,
 #undef PRIMTYPE_CASE_EXPR
 #undef ARRAY1DTYPE_CASE_EXPR
 #undef ARRAY2DTYPE_CASE_EXPR
+}
 
+std::string pprint_value(const value::Value &v, const uint32_t indent,
+                         bool closing_brace) {
+  std::stringstream os;
+  pprint_value(os, v, indent, closing_brace);
   return os.str();
 }
 
@@ -5,8 +5,10 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 #include "value-types.hh"
 
@@ -21,6 +23,25 @@ struct LayerOffset;
 struct SubLayer;
 class Collection;
 
+namespace value {
+
+// Arrays with this or more elements are formatted in parallel chunks(when
+// TinyUSDZ is built with `TINYUSDZ_ENABLE_THREAD`).
+constexpr size_t kParallelPrintArraySize = 64 * 1024;
+
+///
+/// Write `n` array elements to `os`. `fn(begin, end, dst)` prints the
+/// elements in [begin, end) to `dst`, emitting ", " before every element but
+/// the first one of the array. Large arrays are split into chunks which are
+/// formatted in parallel, then written to `os` in order.
+///
+void print_array_elements(
+    std::ostream &os, const size_t n,
+    const std::function<void(size_t begin, size_t end, std::ostream &dst)>
+        &fn);
+
+}  // namespace value
+
 }  // namespace tinyusdz
 
 namespace std {
@@ -130,12 +151,21 @@ std::ostream &operator<<(std::ostream &os, const tinyusdz::Collection &v);
 // 1D array
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
-  os << "[";
-  for (size_t i = 0; i < v.size(); i++) {
-    os << v[i];
-    if (i != (v.size() - 1)) {
-      os << ", ";
+  auto fn = [&v](size_t begin, size_t end, std::ostream &dst) {
+    for (size_t i = begin; i < end; i++) {
+      if (i > 0) {
+        dst << ", ";
+      }
+      dst << v[i];
     }
+  };
+
+  os << "[";
+  if (std::is_trivially_copyable<T>::value) {
+    // POD value types(e.g. float3) can be formatted concurrently.
+    tinyusdz::value::print_array_elements(os, v.size(), fn);
+  } else {
+    fn(0, v.size(), os);
   }
   os << "]";
   return os;
@@ -231,6 +261,10 @@ namespace value {
 std::string pprint_value(const tinyusdz::value::Value &v,
                          const uint32_t indent = 0, bool closing_brace = true);
 
+// Print `v` to `os` directly(no temporary string for large arrays).
+void pprint_value(std::ostream &os, const tinyusdz::value::Value &v,
+                  const uint32_t indent = 0, bool closing_brace = true);
+
 // Print first N and last N items.
 // 0 = print all items.
 // Callee must ensure access to `vals` does not trigger out-of-bounds error.
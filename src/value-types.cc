@@ -1076,9 +1076,452 @@ bool FlexibleTypeCast(const value::Value &src, value::Value &dst) {
 }
 #endif
 
+// POD types which can be stored in SoA storage of TimeSamples.
+#define APPLY_FUNC_TO_POD_TYPES(__FUNC) \
+  __FUNC(value::half)                   \
+  __FUNC(value::half2)                  \
+  __FUNC(value::half3)                  \
+  __FUNC(value::half4)                  \
+  __FUNC(int32_t)                       \
+  __FUNC(uint32_t)                      \
+  __FUNC(value::int2)                   \
+  __FUNC(value::int3)                   \
+  __FUNC(value::int4)                   \
+  __FUNC(value::uint2)                  \
+  __FUNC(value::uint3)                  \
+  __FUNC(value::uint4)                  \
+  __FUNC(int64_t)                       \
+  __FUNC(uint64_t)                      \
+  __FUNC(float)                         \
+  __FUNC(value::float2)                 \
+  __FUNC(value::float3)                 \
+  __FUNC(value::float4)                 \
+  __FUNC(double)                        \
+  __FUNC(value::double2)                \
+  __FUNC(value::double3)                \
+  __FUNC(value::double4)                \
+  __FUNC(value::quath)                  \
+  __FUNC(value::quatf)                  \
+  __FUNC(value::quatd)                  \
+  __FUNC(value::matrix2f)               \
+  __FUNC(value::matrix3f)               \
+  __FUNC(value::matrix4f)               \
+  __FUNC(value::matrix2d)               \
+  __FUNC(value::matrix3d)               \
+  __FUNC(value::matrix4d)               \
+  __FUNC(value::frame4d)                \
+  __FUNC(value::normal3h)               \
+  __FUNC(value::normal3f)               \
+  __FUNC(value::normal3d)               \
+  __FUNC(value::vector3h)               \
+  __FUNC(value::vector3f)               \
+  __FUNC(value::vector3d)               \
+  __FUNC(value::point3h)                \
+  __FUNC(value::point3f)                \
+  __FUNC(value::point3d)                \
+  __FUNC(value::color3h)                \
+  __FUNC(value::color3f)                \
+  __FUNC(value::color3d)                \
+  __FUNC(value::color4h)                \
+  __FUNC(value::color4f)                \
+  __FUNC(value::color4d)                \
+  __FUNC(value::texcoord2h)             \
+  __FUNC(value::texcoord2f)             \
+  __FUNC(value::texcoord2d)             \
+  __FUNC(value::texcoord3h)             \
+  __FUNC(value::texcoord3f)             \
+  __FUNC(value::texcoord3d)
+
+#if defined(TINYUSDZ_ENABLE_THREAD)
+std::mutex &LazyUpdateFlag::get_mutex(const LazyUpdateFlag *flag) {
+  constexpr size_t kNumMutexes = 64;
+  static std::mutex mutexes[kNumMutexes];
+
+  // Flags are embedded in objects of tens of bytes, so drop the low bits.
+  return mutexes[(reinterpret_cast<uintptr_t>(flag) >> 4) % kNumMutexes];
+}
+#endif
+
+void TimeSamples::PODSamples::clear() {
+  type_id = TYPE_ID_INVALID;
+  underlying_type_id = TYPE_ID_INVALID;
+  element_size = 0;
+  is_array = false;
+  times.clear();
+  values.clear();
+  offsets.clear();
+  blocked.clear();
+}
+
+void TimeSamples::PODSamples::set_type(uint32_t tyid, uint32_t underlying_tyid,
+                                       size_t elem_size, bool array) {
+  type_id = tyid;
+  underlying_type_id = underlying_tyid;
+  element_size = elem_size;
+  is_array = array;
+
+  // Samples added so far are all ValueBlock.
+  if (is_array) {
+    offsets.assign(times.size() + 1, 0);
+  } else {
+    values.assign(times.size() * element_size, 0);
+  }
+}
+
+void TimeSamples::PODSamples::push(double t, const void *data, size_t n) {
+  uint8_t *dst = push_uninitialized(t, n);
+  if (n) {
+    memcpy(dst, data, n * element_size);
+  }
+}
+
+uint8_t *TimeSamples::PODSamples::push_uninitialized(double t, size_t n) {
+  size_t loc = values.size();
+  values.resize(loc + n * element_size);
+
+  if (is_array) {
+    offsets.push_back(offsets.back() + n);
+  }
+
+  times.push_back(t);
+  blocked.push_back(false);
+
+  return values.data() + loc;
+}
+
+void TimeSamples::PODSamples::push_blocked(double t) {
+  if (type_id != TYPE_ID_INVALID) {
+    if (is_array) {
+      offsets.push_back(offsets.back());
+    } else {
+      values.resize(values.size() + element_size, 0);
+    }
+  }
+
+  times.push_back(t);
+  blocked.push_back(true);
+}
+
+bool TimeSamples::pod_append(double t, const value::Value &v) {
+  uint32_t tyid = v.type_id();
+
+  if (tyid == TypeTraits<ValueBlock>::type_id()) {
+    _pod.push_blocked(t);
+    return true;
+  }
+
+  if ((_pod.type_id != TYPE_ID_INVALID) && (_pod.type_id != tyid)) {
+    return false;
+  }
+
+#define APPEND_POD(__ty)                                                   \
+  if (tyid == TypeTraits<__ty>::type_id()) {                               \
+    static_assert(std::is_trivially_copyable<__ty>::value, #__ty);         \
+    const __ty *pv = v.as<__ty>(/* strict */ true);                        \
+    if (!pv) {                                                             \
+      return false;                                                        \
+    }                                                                      \
+    if (_pod.type_id == TYPE_ID_INVALID) {                                 \
+      _pod.set_type(tyid, v.underlying_type_id(), sizeof(__ty), false);    \
+    }                                                                      \
+    _pod.push(t, pv, 1);                                                   \
+    return true;                                                           \
+  } else if (tyid == TypeTraits<std::vector<__ty>>::type_id()) {           \
+    const std::vector<__ty> *pv = v.as<std::vector<__ty>>(/* strict */ true); \
+    if (!pv) {                                                             \
+      return false;                                                        \
+    }                                                                      \
+    if (_pod.type_id == TYPE_ID_INVALID) {                                 \
+      _pod.set_type(tyid, v.underlying_type_id(), sizeof(__ty), true);     \
+    }                                                                      \
+    _pod.push(t, pv->data(), pv->size());                                  \
+    return true;                                                           \
+  }
+
+  APPLY_FUNC_TO_POD_TYPES(APPEND_POD)
+
+#undef APPEND_POD
+
+  return false;
+}
+
+nonstd::optional<value::Value> TimeSamples::get_value(size_t idx) const {
+  if (idx >= size()) {
+    return nonstd::nullopt;
+  }
+
+  if (!_use_pod) {
+    return _samples[idx].value;
+  }
+
+  if (_pod.blocked[idx]) {
+    return value::Value(ValueBlock());
+  }
+
+  const uint32_t tyid = _pod.type_id;
+  const uint8_t *src = _pod.data(idx);
+
+#define TO_VALUE(__ty)                                                     \
+  if (tyid == TypeTraits<__ty>::type_id()) {                               \
+    __ty v;                                                                \
+    memcpy(reinterpret_cast<void *>(&v), src, sizeof(__ty));               \
+    return value::Value(v);                                                \
+  } else if (tyid == TypeTraits<std::vector<__ty>>::type_id()) {           \
+    std::vector<__ty> v(_pod.count(idx));                                  \
+    if (v.size()) {                                                        \
+      memcpy(reinterpret_cast<void *>(v.data()), src, v.size() * sizeof(__ty)); \
+    }                                                                      \
+    return value::Value(v);                                                \
+  }
+
+  APPLY_FUNC_TO_POD_TYPES(TO_VALUE)
+
+#undef TO_VALUE
+
+  return nonstd::nullopt;
+}
+
+bool TimeSamples::pod_lerp(size_t idx0, size_t idx1, double dt,
+                           void *dst) const {
+  const uint32_t tyid = _pod.type_id;
+  const uint8_t *src0 = _pod.data(idx0);
+  const uint8_t *src1 = _pod.data(idx1);
+  uint8_t *out = reinterpret_cast<uint8_t *>(dst);
+
+  // Same behavior with `Lerp(value::Value, ...)`
+#define DO_POD_LERP(__ty)                                                  \
+  if (tyid == TypeTraits<__ty>::type_id()) {                               \
+    __ty v0, v1;                                                           \
+    memcpy(reinterpret_cast<void *>(&v0), src0, sizeof(__ty));             \
+    memcpy(reinterpret_cast<void *>(&v1), src1, sizeof(__ty));             \
+    const __ty c = lerp(v0, v1, dt);                                       \
+    memcpy(out, &c, sizeof(__ty));                                         \
+    return true;                                                           \
+  } else if (tyid == TypeTraits<std::vector<__ty>>::type_id()) {           \
+    size_t n0 = _pod.count(idx0);                                          \
+    size_t n1 = _pod.count(idx1);                                          \
+    size_t n = (std::min)(n0, n1);                                         \
+    for (size_t i = 0; i < n; i++) {                                       \
+      __ty c{};                                                            \
+      if (n0 == n1) {                                                      \
+        __ty v0, v1;                                                       \
+        memcpy(reinterpret_cast<void *>(&v0), src0 + i * sizeof(__ty), sizeof(__ty)); \
+        memcpy(reinterpret_cast<void *>(&v1), src1 + i * sizeof(__ty), sizeof(__ty)); \
+        c = lerp(v0, v1, dt);                                              \
+      }                                                                    \
+      memcpy(out + i * sizeof(__ty), &c, sizeof(__ty));                    \
+    }                                                                      \
+    return true;                                                           \
+  }
+
+  DO_POD_LERP(value::half)
+  DO_POD_LERP(value::half2)
+  DO_POD_LERP(value::half3)
+  DO_POD_LERP(value::half4)
+  DO_POD_LERP(float)
+  DO_POD_LERP(value::float2)
+  DO_POD_LERP(value::float3)
+  DO_POD_LERP(value::float4)
+  DO_POD_LERP(double)
+  DO_POD_LERP(value::double2)
+  DO_POD_LERP(value::double3)
+  DO_POD_LERP(value::double4)
+  DO_POD_LERP(value::quath)
+  DO_POD_LERP(value::quatf)
+  DO_POD_LERP(value::quatd)
+  DO_POD_LERP(value::color3h)
+  DO_POD_LERP(value::color3f)
+  DO_POD_LERP(value::color3d)
+  DO_POD_LERP(value::color4h)
+  DO_POD_LERP(value::color4f)
+  DO_POD_LERP(value::color4d)
+  DO_POD_LERP(value::point3h)
+  DO_POD_LERP(value::point3f)
+  DO_POD_LERP(value::point3d)
+  DO_POD_LERP(value::normal3h)
+  DO_POD_LERP(value::normal3f)
+  DO_POD_LERP(value::normal3d)
+  DO_POD_LERP(value::vector3h)
+  DO_POD_LERP(value::vector3f)
+  DO_POD_LERP(value::vector3d)
+  DO_POD_LERP(value::texcoord2h)
+  DO_POD_LERP(value::texcoord2f)
+  DO_POD_LERP(value::texcoord2d)
+  DO_POD_LERP(value::texcoord3h)
+  DO_POD_LERP(value::texcoord3f)
+  DO_POD_LERP(value::texcoord3d)
+
+#undef DO_POD_LERP
+
+  return false;
+}
+
+#undef APPLY_FUNC_TO_POD_TYPES
+
+void TimeSamples::pod_to_samples(std::vector<Sample> *dst) const {
+  std::vector<Sample> samples(_pod.times.size());
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i].t = _pod.times[i];
+    samples[i].value = get_value(i).value();
+    samples[i].blocked = false;
+  }
+
+  (*dst) = std::move(samples);
+}
+
+void TimeSamples::to_samples() {
+  if (!_use_pod) {
+    return;
+  }
+
+  pod_to_samples(&_samples);
+  _pod.clear();
+  _use_pod = false;
+  _samples_cache_dirty = false;
+}
+
+void TimeSamples::pod_sort() {
+  if (std::is_sorted(_pod.times.begin(), _pod.times.end())) {
+    return;
+  }
+
+  std::vector<size_t> perm(_pod.times.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    perm[i] = i;
+  }
+  std::stable_sort(perm.begin(), perm.end(), [this](size_t a, size_t b) {
+    return _pod.times[a] < _pod.times[b];
+  });
+
+  PODSamples sorted;
+  sorted.type_id = _pod.type_id;
+  sorted.underlying_type_id = _pod.underlying_type_id;
+  sorted.element_size = _pod.element_size;
+  sorted.is_array = _pod.is_array;
+  sorted.times.reserve(perm.size());
+  sorted.values.reserve(_pod.values.size());
+  sorted.blocked.reserve(perm.size());
+  if (sorted.is_array) {
+    sorted.offsets.reserve(perm.size() + 1);
+    sorted.offsets.push_back(0);
+  }
+
+  for (size_t i : perm) {
+    if (_pod.blocked[i]) {
+      sorted.push_blocked(_pod.times[i]);
+    } else {
+      sorted.push(_pod.times[i], _pod.data(i), _pod.count(i));
+    }
+  }
+
+  _pod = std::move(sorted);
+}
+
+void TimeSamples::insert_sample(const Sample &s) {
+  const auto it = std::upper_bound(
+      _samples.begin(), _samples.end(), s.t,
+      [](double tval, const Sample &a) { return tval < a.t; });
+  _samples.insert(it, s);
+}
+
+uint32_t TimeSamples::type_id() const {
+  if (empty()) {
+    return value::TypeId::TYPE_ID_INVALID;
+  }
+
+  if (_use_pod) {
+    return _pod.blocked[0] ? TypeTraits<ValueBlock>::type_id() : _pod.type_id;
+  }
+  return _samples[0].value.type_id();
+}
+
+std::string TimeSamples::type_name() const {
+  if (empty()) {
+    return std::string();
+  }
+
+  if (_use_pod) {
+    return get_value(0).value().type_name();
+  }
+  return _samples[0].value.type_name();
+}
+
+bool TimeSamples::is_value_block(size_t idx) const {
+  if (idx >= size()) {
+    return false;
+  }
+
+  if (_use_pod) {
+    return _pod.blocked[idx];
+  }
+
+  return _samples[idx].blocked ||
+         (_samples[idx].value.type_id() == TypeTraits<ValueBlock>::type_id());
+}
+
+size_t TimeSamples::get_held_index(double t) const {
+  size_t idx;
+  if (_use_pod) {
+    idx = size_t(std::distance(
+        _pod.times.begin(),
+        std::upper_bound(_pod.times.begin(), _pod.times.end(), t)));
+  } else {
+    idx = size_t(std::distance(
+        _samples.begin(),
+        std::upper_bound(
+            _samples.begin(), _samples.end(), t,
+            [](double tval, const Sample &a) { return tval < a.t; })));
+  }
+
+  return (idx == 0) ? 0 : (idx - 1);
+}
+
+void TimeSamples::get_lerp_indices(double t, size_t *idx0, size_t *idx1,
+                                   double *dt) const {
+  size_t n = size();
+
+  size_t idx;
+  if (_use_pod) {
+    idx = size_t(std::distance(
+        _pod.times.begin(),
+        std::lower_bound(_pod.times.begin(), _pod.times.end(), t)));
+  } else {
+    idx = size_t(std::distance(
+        _samples.begin(),
+        std::lower_bound(
+            _samples.begin(), _samples.end(), t,
+            [](const Sample &a, double tval) { return a.t < tval; })));
+  }
+
+  size_t i0 = (std::min)(n - 1, (idx == 0) ? 0 : (idx - 1));
+  size_t i1 = (std::min)(n - 1, i0 + 1);
+
+  double tl = _use_pod ? _pod.times[i0] : _samples[i0].t;
+  double tu = _use_pod ? _pod.times[i1] : _samples[i1].t;
+
+  double d = (t - tl);
+  if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
+    // slope is zero.
+    d = 0.0;
+  } else {
+    d /= (tu - tl);
+  }
+
+  // Just in case.
+  d = (std::max)(0.0, (std::min)(1.0, d));
+
+  (*idx0) = i0;
+  (*idx1) = i1;
+  (*dt) = d;
+}
+
 bool TimeSamples::has_sample_at(const double t) const {
-  if (_dirty) {
-    update();
+  if (_use_pod) {
+    const auto it = std::find_if(
+        _pod.times.begin(), _pod.times.end(),
+        [&t](const double st) { return math::is_close(t, st); });
+
+    return (it != _pod.times.end());
   }
 
   const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &s) {
@@ -1093,9 +1536,7 @@ bool TimeSamples::get_sample_at(const double t, Sample **dst) {
     return false;
   }
 
-  if (_dirty) {
-    update();
-  }
+  to_samples();
 
   const auto it = std::find_if(_samples.begin(), _samples.end(), [&t](const Sample &sample) {
     return math::is_close(t, sample.t);
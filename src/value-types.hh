@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <functional>
@@ -19,6 +20,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 #include <vector>
 
@@ -2254,18 +2256,158 @@ bool Lerp(const value::Value &a, const value::Value &b, double dt,
 
 
 
-// Handy, but may not be efficient for large time samples(e.g. 1M samples or
-// more)
+namespace detail {
+
+// Copy a POD sample value from the packed buffer of `TimeSamples`.
+// Returns false for non-POD types(e.g. `std::string`), so the template can be
+// instantiated for any `T` of `TimeSamples::get`.
+template <typename T, bool pod = std::is_trivially_copyable<T>::value &&
+                                 !std::is_same<T, bool>::value>
+struct PODSampleAccess {
+  static bool copy(const uint8_t *, size_t, size_t, T *) { return false; }
+  static void *prepare(T *, size_t) { return nullptr; }
+};
+
+template <typename T>
+struct PODSampleAccess<T, true> {
+  static bool copy(const uint8_t *src, size_t n, size_t element_size, T *dst) {
+    if ((n != 1) || (element_size != sizeof(T))) {
+      return false;
+    }
+    std::memcpy(reinterpret_cast<void *>(dst), src, sizeof(T));
+    return true;
+  }
+
+  static void *prepare(T *dst, size_t n) {
+    if (n != 1) {
+      return nullptr;
+    }
+    return reinterpret_cast<void *>(dst);
+  }
+};
+
+template <typename T>
+struct PODSampleAccess<std::vector<T>, false> {
+  static bool copy(const uint8_t *src, size_t n, size_t element_size,
+                   std::vector<T> *dst) {
+    return copy_array(src, n, element_size, dst,
+                      std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                                       !std::is_same<T, bool>::value>());
+  }
+
+  static void *prepare(std::vector<T> *dst, size_t n) {
+    return prepare_array(dst, n,
+                         std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                                          !std::is_same<T, bool>::value>());
+  }
+
+ private:
+  static bool copy_array(const uint8_t *src, size_t n, size_t element_size,
+                         std::vector<T> *dst, std::true_type) {
+    if (element_size != sizeof(T)) {
+      return false;
+    }
+    dst->resize(n);
+    if (n) {
+      std::memcpy(reinterpret_cast<void *>(dst->data()), src, n * sizeof(T));
+    }
+    return true;
+  }
+
+  static bool copy_array(const uint8_t *, size_t, size_t, std::vector<T> *,
+                         std::false_type) {
+    return false;
+  }
+
+  static void *prepare_array(std::vector<T> *dst, size_t n, std::true_type) {
+    dst->resize(n);
+    return reinterpret_cast<void *>(dst->data());
+  }
+
+  static void *prepare_array(std::vector<T> *, size_t, std::false_type) {
+    return nullptr;
+  }
+};
+
+}  // namespace detail
+
 //
-// For the runtime speed, with "-O2 -g" optimization, adding 10M `double`
-// samples to linb::any takes roughly 1.8 ms on Threadripper 1950X, whereas
-// simple vector<double> push_back takes 390 us(roughly x4 times faster). (Build
-// benchmarks to see the numbers on your CPU)
+// Dirty flag for the lazily updated(e.g. cached) `mutable` members of an
+// object. `update()` runs the update function only once even when it is called
+// from multiple threads through const methods of the object, so const methods
+// can be called concurrently as long as the object is not modified.
 //
-// We assume having large time samples is rare situlation, and above benchmark
-// speed is acceptable in general  usecases.
+// Flags share a small pool of mutexes(selected by the address of the flag)
+// instead of having their own, since a flag is embedded in every TimeSamples.
+// So the update function must not update other LazyUpdateFlag.
 //
-// `None`(ValueBlock) is represented by setting `Sample::blocked` true.
+class LazyUpdateFlag {
+ public:
+  LazyUpdateFlag() = default;
+  explicit LazyUpdateFlag(bool dirty) : _dirty(dirty) {}
+
+  LazyUpdateFlag(const LazyUpdateFlag &rhs) noexcept : _dirty(bool(rhs)) {}
+  LazyUpdateFlag &operator=(const LazyUpdateFlag &rhs) noexcept {
+    _dirty.store(bool(rhs), std::memory_order_release);
+    return *this;
+  }
+
+  LazyUpdateFlag &operator=(bool dirty) noexcept {
+    _dirty.store(dirty, std::memory_order_release);
+    return *this;
+  }
+
+  explicit operator bool() const noexcept {
+    return _dirty.load(std::memory_order_acquire);
+  }
+
+  // Run `f` and clear the flag when the flag is set.
+  template <typename F>
+  void update(F &&f) const {
+#if defined(TINYUSDZ_ENABLE_THREAD)
+    std::lock_guard<std::mutex> lock(get_mutex(this));
+#endif
+    if (!_dirty.load(std::memory_order_relaxed)) {
+      // Already updated by another thread.
+      return;
+    }
+
+    f();
+    _dirty.store(false, std::memory_order_release);
+  }
+
+ private:
+#if defined(TINYUSDZ_ENABLE_THREAD)
+  static std::mutex &get_mutex(const LazyUpdateFlag *flag);
+#endif
+
+  mutable std::atomic<bool> _dirty{false};
+};
+
+//
+// TimeSamples has two storage backends.
+//
+// - Structure-of-arrays(SoA) storage for POD types(e.g. `float`,
+//   `point3f[]`, `matrix4d`): times, packed values and ValueBlock(`None`)
+//   bits are stored in contiguous arrays, so no per-sample `value::Value`(and
+//   its heap allocation) is required. Used while all samples have the same
+//   type(ValueBlock samples are allowed).
+// - Array of `Sample`(AoS) storage for everything else(e.g. `token`,
+//   `string`, dictionary).
+//
+// The backend is selected automatically in `add_sample`. SoA storage is
+// converted to AoS storage when a sample of different type is added, or
+// `samples()` is called. `get_samples()` keeps SoA storage and returns AoS
+// copy of samples(cached until the next modification). Use index-based
+// accessors(`get_time`, `get_value`, `get`) to avoid the copy.
+//
+// Samples are kept sorted by time when they are added(appending samples in
+// time order is O(1)), so const methods just read them and are thread-safe
+// (the AoS copy of `get_samples()` is built only once). Modification is not
+// thread-safe.
+//
+// `None`(ValueBlock) is represented by the ValueBlock value(SoA: blocked bit)
+// or by setting `Sample::blocked` true(AoS only).
 //
 struct TimeSamples {
   struct Sample {
@@ -2274,83 +2416,139 @@ struct TimeSamples {
     bool blocked{false};
   };
 
-  bool empty() const { return _samples.empty(); }
+  bool empty() const { return size() == 0; }
 
-  size_t size() const { return _samples.size(); }
+  size_t size() const {
+    return _use_pod ? _pod.times.size() : _samples.size();
+  }
 
   void clear() {
     _samples.clear();
-    _dirty = true;
+    _pod.clear();
+    _use_pod = true;
+    _samples_cache_dirty = true;
   }
 
-  void update() const {
-    std::sort(_samples.begin(), _samples.end(),
-              [](const Sample &a, const Sample &b) { return a.t < b.t; });
-
-    _dirty = false;
+  // Reserve memory for `n` samples.
+  void reserve(size_t n) {
+    if (_use_pod) {
+      _pod.times.reserve(n);
+      _pod.blocked.reserve(n);
+    } else {
+      _samples.reserve(n);
+    }
   }
 
   bool has_sample_at(const double t) const;
   bool get_sample_at(const double t, Sample **s);
 
   nonstd::optional<double> get_time(size_t idx) const {
-    if (idx >= _samples.size()) {
+    if (idx >= size()) {
       return nonstd::nullopt;
     }
 
-    if (_dirty) {
-      update();
-    }
-
-    return _samples[idx].t;
+    return _use_pod ? _pod.times[idx] : _samples[idx].t;
   }
 
-  nonstd::optional<value::Value> get_value(size_t idx) const {
-    if (idx >= _samples.size()) {
-      return nonstd::nullopt;
-    }
+  nonstd::optional<value::Value> get_value(size_t idx) const;
 
-    if (_dirty) {
-      update();
+  // Type-safe way to get the value of `idx`th sample without constructing
+  // `value::Value`. Returns false when type-mismatch or the sample is
+  // ValueBlock.
+  template <typename T>
+  bool get_value(size_t idx, T *dst) const {
+    if (!dst || (idx >= size())) {
+      return false;
     }
 
-    return _samples[idx].value;
-  }
-
-  uint32_t type_id() const {
-    if (_samples.size()) {
-      if (_dirty) {
-        update();
+    if (_use_pod) {
+      if (_pod.blocked[idx] || !pod_type_compatible<T>()) {
+        return false;
       }
-      return _samples[0].value.type_id();
-    } else {
-      return value::TypeId::TYPE_ID_INVALID;
+
+      return detail::PODSampleAccess<T>::copy(_pod.data(idx), _pod.count(idx),
+                                              _pod.element_size, dst);
     }
-  }
 
-  std::string type_name() const {
-    if (_samples.size()) {
-      if (_dirty) {
-        update();
-      }
-      return _samples[0].value.type_name();
-    } else {
-      return std::string();
+    if (const T *pv = _samples[idx].value.as<T>()) {
+      (*dst) = *pv;
+      return true;
     }
+    return false;
   }
 
+  // Check if `idx`th sample is `None`(ValueBlock value or `Sample::blocked`)
+  bool is_value_block(size_t idx) const;
+
+  // Index of the sample used for Held interpolation at time `t`.
+  // Samples must not be empty.
+  size_t get_held_index(double t) const;
+
+  // Indices of the samples and the interpolator(in [0.0, 1.0]) used for Linear
+  // interpolation at time `t`. Samples must not be empty.
+  void get_lerp_indices(double t, size_t *idx0, size_t *idx1,
+                        double *dt) const;
+
+  uint32_t type_id() const;
+
+  std::string type_name() const;
+
   void add_sample(const Sample &s) {
-    _samples.push_back(s);
-    _dirty = true;
+    if (!s.blocked) {
+      add_sample(s.t, s.value);
+      return;
+    }
+
+    to_samples();
+    insert_sample(s);
   }
 
   void add_sample(double t, const value::Value &v) {
+    if (_use_pod) {
+      const bool in_order = _pod.times.empty() || (_pod.times.back() <= t);
+      if (pod_append(t, v)) {
+        if (!in_order) {
+          pod_sort();
+        }
+        _samples_cache_dirty = true;
+        return;
+      }
+    }
+
+    to_samples();
     Sample s;
     s.t = t;
     s.value = v;
     s.blocked = false;
-    _samples.push_back(s);
-    _dirty = true;
+    insert_sample(s);
+  }
+
+  // Append a sample of POD type `T`(`std::vector<T>` when `array` is true)
+  // with `n` uninitialized elements to SoA storage, and return the pointer to
+  // them(`n * sizeof(T)` bytes) so that the value can be decoded in place.
+  // Returns nullptr when the sample cannot be stored in SoA storage, or `t` is
+  // before the last sample(use `add_sample` then).
+  template <typename T>
+  uint8_t *alloc_pod_sample(double t, bool array, size_t n) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "T must be POD type.");
+    const uint32_t tyid = array ? TypeTraits<std::vector<T>>::type_id()
+                                : TypeTraits<T>::type_id();
+    if (!_use_pod || (!array && (n != 1)) ||
+        ((_pod.type_id != TYPE_ID_INVALID) && (_pod.type_id != tyid)) ||
+        (!_pod.times.empty() && (t < _pod.times.back()))) {
+      return nullptr;
+    }
+
+    if (_pod.type_id == TYPE_ID_INVALID) {
+      _pod.set_type(tyid,
+                    array ? TypeTraits<std::vector<T>>::underlying_type_id()
+                          : TypeTraits<T>::underlying_type_id(),
+                    sizeof(T), array);
+    }
+
+    _samples_cache_dirty = true;
+    return _pod.push_uninitialized(t, n);
   }
 
   // We still need "dummy" value for type_name() and type_id()
@@ -2360,87 +2558,65 @@ struct TimeSamples {
     s.value = v;
     s.blocked = true;
 
-    _samples.emplace_back(s);
-    _dirty = true;
+    to_samples();
+    insert_sample(s);
   }
 
+  // NOTE: Returns cached AoS copy when SoA storage is used. SoA storage is
+  // kept as is, so following samples can still be decoded in place with
+  // `alloc_pod_sample`.
   const std::vector<Sample> &get_samples() const {
-    if (_dirty) {
-      update();
+    if (_use_pod) {
+      _samples_cache_dirty.update([this]() { pod_to_samples(&_samples); });
     }
     return _samples;
   }
 
+  // NOTE: Converts SoA storage to AoS storage. Samples must be kept sorted by
+  // time when they are modified through the returned reference.
   std::vector<Sample> &samples() {
-    if (_dirty) {
-      update();
-    }
+    to_samples();
     return _samples;
   }
 
-#if 1  // TODO: Write implementation in .cc
-
-    // Get value at specified time.
-    // For non-interpolatable types(includes enums and unknown types)
-    //
-    // Return `Held` value even when TimeSampleInterpolationType is
-    // Linear. Returns nullopt when specified time is out-of-range.
-    template<typename T, std::enable_if_t<!value::LerpTraits<T>::supported(), std::nullptr_t> = nullptr>
-    bool get(T *dst, double t = value::TimeCode::Default(),
-             value::TimeSampleInterpolationType interp =
-                 value::TimeSampleInterpolationType::Linear) const {
-
-      (void)interp;
+  // Returns true when samples are stored in SoA storage.
+  bool is_pod_storage() const { return _use_pod; }
 
-      if (!dst) {
-        return false;
-      }
-
-      if (empty()) {
-        return false;
-      }
-
-      if (_dirty) {
-        update();
-      }
-
-      if (value::TimeCode(t).is_default()) {
-        // TODO: Handle bloked
-        if (const auto pv = _samples[0].value.as<T>()) {
-          (*dst) = *pv;
-          return true;
-        }
-        return false;
-      } else {
-
-        if (_samples.size() == 1) {
-          if (const auto pv = _samples[0].value.as<T>()) {
-            (*dst) = *pv;
-            return true;
-          }
-          return false;
-        }
+  // Get value at specified time.
+  // For non-interpolatable types(includes enums and unknown types)
+  //
+  // Return `Held` value even when TimeSampleInterpolationType is
+  // Linear. Returns nullopt when specified time is out-of-range.
+  template <typename T,
+            std::enable_if_t<!value::LerpTraits<T>::supported(),
+                             std::nullptr_t> = nullptr>
+  bool get(T *dst, double t = value::TimeCode::Default(),
+           value::TimeSampleInterpolationType interp =
+               value::TimeSampleInterpolationType::Linear) const {
+    (void)interp;
 
-        auto it = std::upper_bound(
-          _samples.begin(), _samples.end(), t,
-          [](double tval, const Sample &a) { return tval < a.t; });
+    if (!dst) {
+      return false;
+    }
 
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
+    if (empty()) {
+      return false;
+    }
 
-        const value::Value &v = it_minus_1->value;
+    if (value::TimeCode(t).is_default()) {
+      // TODO: Handle bloked
+      return get_value(0, dst);
+    }
 
-        if (const T *pv = v.as<T>()) {
-          (*dst) = *pv;
-          return true;
-        }
-        return false;
-      }
+    return get_value(get_held_index(t), dst);
   }
 
   // Get value at specified time.
   // Return linearly interpolated value when TimeSampleInterpolationType is
   // Linear. Returns false when samples is empty or some internal error.
-  template<typename T, std::enable_if_t<value::LerpTraits<T>::supported(), std::nullptr_t> = nullptr>
+  template <typename T,
+            std::enable_if_t<value::LerpTraits<T>::supported(),
+                             std::nullptr_t> = nullptr>
   bool get(T *dst, double t = value::TimeCode::Default(),
            TimeSampleInterpolationType interp =
                TimeSampleInterpolationType::Linear) const {
@@ -2452,99 +2628,136 @@ struct TimeSamples {
       return false;
     }
 
-    if (_dirty) {
-      update();
-    }
-
     if (value::TimeCode(t).is_default()) {
       // FIXME: Use the first item for now.
       // TODO: Handle bloked
-      if (const auto pv = _samples[0].value.as<T>()) {
-        (*dst) = *pv;
-        return true;
-      }
-      return false;
-    } else {
-
-      if (_samples.size() == 1) {
-        if (const auto pv = _samples[0].value.as<T>()) {
-          (*dst) = *pv;
-          return true;
-        }
-        return true;
-      }
-
-      if (interp == TimeSampleInterpolationType::Linear) {
-        auto it = std::lower_bound(
-            _samples.begin(), _samples.end(), t,
-            [](const Sample &a, double tval) { return a.t < tval; });
-
-
-        // MS STL does not allow seek vector iterator before begin
-        // Issue #110
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
-
-        size_t idx0 = size_t(std::max(
-            int64_t(0),
-            std::min(int64_t(_samples.size() - 1),
-                     int64_t(std::distance(_samples.begin(), it_minus_1)))));
-        size_t idx1 =
-            size_t(std::max(int64_t(0), std::min(int64_t(_samples.size() - 1),
-                                                 int64_t(idx0) + 1)));
-
-        double tl = _samples[idx0].t;
-        double tu = _samples[idx1].t;
-
-        double dt = (t - tl);
-        if (std::fabs(tu - tl) < std::numeric_limits<double>::epsilon()) {
-          // slope is zero.
-          dt = 0.0;
-        } else {
-          dt /= (tu - tl);
-        }
+      return get_value(0, dst);
+    }
 
-        // Just in case.
-        dt = std::max(0.0, std::min(1.0, dt));
+    if (size() == 1) {
+      return get_value(0, dst);
+    }
 
-        const value::Value &p0 = _samples[idx0].value;
-        const value::Value &p1 = _samples[idx1].value;
+    if (interp == TimeSampleInterpolationType::Linear) {
+      size_t idx0, idx1;
+      double dt;
+      get_lerp_indices(t, &idx0, &idx1, &dt);
 
-        value::Value p;
-        if (!Lerp(p0, p1, dt, &p)) {
+      if (_use_pod) {
+        if (_pod.blocked[idx0] || _pod.blocked[idx1] ||
+            !pod_type_compatible<T>()) {
           return false;
         }
 
-        if (const auto pv = p.as<T>()) {
-          (*dst) = *pv;
-          return true;
+        // Choose shorter one(same as `lerp` for std::vector)
+        size_t n = (std::min)(_pod.count(idx0), _pod.count(idx1));
+        void *p = detail::PODSampleAccess<T>::prepare(dst, n);
+        if (!p) {
+          return false;
         }
-        return false;
-      } else {
-        // Held
-        auto it = std::upper_bound(
-          _samples.begin(), _samples.end(), t,
-          [](double tval, const Sample &a) { return tval < a.t; });
-
-        const auto it_minus_1 = (it == _samples.begin()) ? _samples.begin() : (it - 1);
+        return pod_lerp(idx0, idx1, dt, p);
+      }
 
-        const value::Value &v = it_minus_1->value;
+      const value::Value &p0 = _samples[idx0].value;
+      const value::Value &p1 = _samples[idx1].value;
 
-        if (const T *pv = v.as<T>()) {
-          (*dst) = *pv;
-          return true;
-        }
-        
+      value::Value p;
+      if (!Lerp(p0, p1, dt, &p)) {
         return false;
       }
+
+      if (const auto pv = p.as<T>()) {
+        (*dst) = *pv;
+        return true;
+      }
+      return false;
     }
 
-    return false;
+    // Held
+    return get_value(get_held_index(t), dst);
   }
-#endif
 
  private:
+  // SoA storage for POD type samples.
+  struct PODSamples {
+    // TYPE_ID_INVALID until the first non-ValueBlock sample is added.
+    uint32_t type_id{TYPE_ID_INVALID};
+    uint32_t underlying_type_id{TYPE_ID_INVALID};
+    size_t element_size{0};  // in bytes
+    bool is_array{false};
+
+    std::vector<double> times;
+    std::vector<uint8_t> values;  // packed values
+    // Array type only. Offset(in elements) of each sample in `values`.
+    // times.size() + 1 items.
+    std::vector<size_t> offsets;
+    std::vector<bool> blocked;  // ValueBlock
+
+    void clear();
+
+    // Set value type. Fill dummy values for ValueBlock samples added so far.
+    void set_type(uint32_t tyid, uint32_t underlying_tyid, size_t elem_size,
+                  bool array);
+
+    void push(double t, const void *data, size_t n);
+    // Append a sample with `n` elements and return the pointer to its values.
+    uint8_t *push_uninitialized(double t, size_t n);
+    void push_blocked(double t);
+
+    // # of elements of `idx`th sample.
+    size_t count(size_t idx) const {
+      return is_array ? (offsets[idx + 1] - offsets[idx]) : 1;
+    }
+
+    const uint8_t *data(size_t idx) const {
+      return values.data() +
+             (is_array ? offsets[idx] : idx) * element_size;
+    }
+  };
+
+  // Role types are compatible with its underlying type(same rule with
+  // `value::Value::as`)
+  template <typename T>
+  bool pod_type_compatible() const {
+    if (TypeTraits<T>::type_id() == _pod.type_id) {
+      return true;
+    }
+
+    if (TypeTraits<T>::is_array() && _pod.is_array) {
+      return (TypeTraits<T>::underlying_type_id() &
+              (~value::TYPE_ID_1D_ARRAY_BIT)) ==
+             (_pod.underlying_type_id & (~value::TYPE_ID_1D_ARRAY_BIT));
+    } else if (!TypeTraits<T>::is_array() && !_pod.is_array) {
+      return TypeTraits<T>::underlying_type_id() == _pod.underlying_type_id;
+    }
+
+    return false;
+  }
+
+  // Returns false when `v` cannot be stored in SoA storage.
+  bool pod_append(double t, const value::Value &v);
+
+  // Stable sort of SoA samples by time.
+  void pod_sort();
+
+  // Insert `s` to AoS storage after the samples whose time <= `s.t`.
+  void insert_sample(const Sample &s);
+
+  // Linearly interpolate `idx0`th and `idx1`th samples and write the result
+  // to `dst`(`count` elements of stored type).
+  bool pod_lerp(size_t idx0, size_t idx1, double dt, void *dst) const;
+
+  // Convert SoA storage to AoS storage(no-op when AoS storage is used).
+  void to_samples();
+
+  // Store SoA samples to `dst` as AoS samples.
+  void pod_to_samples(std::vector<Sample> *dst) const;
+
+  // AoS storage. Also used as the cache of `get_samples()` for SoA storage.
   mutable std::vector<Sample> _samples;
-  mutable bool _dirty{false};
+  mutable PODSamples _pod;
+  bool _use_pod{true};
+  LazyUpdateFlag _samples_cache_dirty{false};
 };
 
 
@@ -190,22 +190,40 @@ struct Xformable {
   /// @param[out] resetTransformStack Is xformOpOrder contains !resetTransformStack!? 
   ///
   nonstd::expected<value::matrix4d, std::string> GetLocalMatrix(double t = value::TimeCode::Default(), value::TimeSampleInterpolationType tinterp = value::TimeSampleInterpolationType::Linear, bool *resetTransformStack = nullptr) const {
-    if (_dirty) {
+    // Cached matrix is only valid for the time it was evaluated at.
+    const bool same_time =
+        (value::TimeCode(t).is_default() && value::TimeCode(_t).is_default()) ||
+        (t == _t);
+    if (_dirty || !same_time || (tinterp != _tinterp)) {
       value::matrix4d m;
+      bool rxs{false};
       std::string err;
-      if (EvaluateXformOps(t, tinterp, &m, resetTransformStack, &err)) {
+      if (EvaluateXformOps(t, tinterp, &m, &rxs, &err)) {
         _matrix = m;
+        _resetXformStack = rxs;
+        _t = t;
+        _tinterp = tinterp;
         _dirty = false;
       } else {
         return nonstd::make_unexpected(err);
       }
     }
 
+    if (resetTransformStack) {
+      (*resetTransformStack) = _resetXformStack;
+    }
+
     return _matrix;
   }
 
   void set_dirty(bool onoff) { _dirty = onoff; }
 
+  ///
+  /// @return true when any of xformOps has timeSamples, i.e. the local matrix
+  /// may change over time.
+  ///
+  bool is_time_varying() const;
+
   // Return `token[]` representation of `xformOps`
   std::vector<value::token> xformOpOrder() const;
 
@@ -213,6 +231,10 @@ struct Xformable {
 
   mutable bool _dirty{true};
   mutable value::matrix4d _matrix;  // Matrix of this Xform(local matrix)
+  mutable bool _resetXformStack{false};
+  mutable double _t{value::TimeCode::Default()};  // time of `_matrix`
+  mutable value::TimeSampleInterpolationType _tinterp{
+      value::TimeSampleInterpolationType::Linear};
 };
 
 
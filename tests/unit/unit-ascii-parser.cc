@@ -0,0 +1,422 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "unit-ascii-parser.h"
+#include "ascii-parser.hh"
+#include "pprinter.hh"
+#include "prim-types.hh"
+#include "stream-reader.hh"
+#include "thread-util.hh"
+#include "tinyusdz.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+struct ParseResult {
+  bool ok{false};
+  Layer layer;
+  std::string layer_str;
+  std::string err;
+};
+
+ParseResult ParseUSDA(const std::string &usda) {
+  ParseResult result;
+  std::string warn;
+  result.ok = LoadUSDALayerFromMemory(
+      reinterpret_cast<const uint8_t *>(usda.data()), usda.size(), "test.usda",
+      &result.layer, &warn, &result.err);
+  if (result.ok) {
+    result.layer_str = print_layer(result.layer, 0);
+  }
+  return result;
+}
+
+// USDA with an array attribute `decl = [body]`, followed by `after`.
+// A comment in the array makes the parser take the generic path, without
+// changing line numbers.
+std::string MakeArrayUSDA(const std::string &decl, const std::string &body,
+                          bool generic, const std::string &after = "") {
+  std::string s = "#usda 1.0\ndef Xform \"a\"\n{\n";
+  s += "    " + decl + " = [\n";
+  s += generic ? "        # comment\n" : "\n";
+  s += body + "\n    ]\n";
+  s += after;
+  s += "}\n";
+  return s;
+}
+
+template <typename T>
+bool GetAttr(const Layer &layer, const std::string &name, T *v) {
+  auto prim_it = layer.primspecs().find("a");
+  if (prim_it == layer.primspecs().end()) {
+    return false;
+  }
+  auto prop_it = prim_it->second.props().find(name);
+  if (prop_it == prim_it->second.props().end()) {
+    return false;
+  }
+  return prop_it->second.get_attribute().get_value(v);
+}
+
+// Fast path and generic path give the same result.
+void CheckSameResult(const std::string &decl, const std::string &body,
+                     const std::string &after = "") {
+  ParseResult fast = ParseUSDA(MakeArrayUSDA(decl, body, false, after));
+  ParseResult generic = ParseUSDA(MakeArrayUSDA(decl, body, true, after));
+  TEST_CHECK(fast.ok == generic.ok);
+  TEST_CHECK(fast.layer_str == generic.layer_str);
+  TEST_CHECK(fast.err == generic.err);
+  TEST_MSG("%s = [%s]\nfast: %s\ngeneric: %s", decl.c_str(), body.c_str(),
+           fast.err.c_str(), generic.err.c_str());
+}
+
+struct LexResult {
+  bool ok{false};
+  std::string token;
+  uint64_t loc{0};
+};
+
+// Lex a float literal at the beginning of `s` with the buffer scanner.
+LexResult LexFloatRange(const std::string &s) {
+  StreamReader sr(reinterpret_cast<const uint8_t *>(s.data()), s.size(),
+                  /* swap_endian */ false);
+  ascii::AsciiParser parser(&sr);
+
+  LexResult result;
+  const char *begin{nullptr};
+  const char *end{nullptr};
+  result.ok = parser.LexFloat(&begin, &end);
+  if (result.ok) {
+    result.token.assign(begin, end);
+  }
+  result.loc = parser.CurrLoc();
+  return result;
+}
+
+// Same with the std::string overload.
+LexResult LexFloatString(const std::string &s) {
+  StreamReader sr(reinterpret_cast<const uint8_t *>(s.data()), s.size(),
+                  /* swap_endian */ false);
+  ascii::AsciiParser parser(&sr);
+
+  LexResult result;
+  result.ok = parser.LexFloat(&result.token);
+  result.loc = parser.CurrLoc();
+  return result;
+}
+
+template <typename T>
+bool ReadBasicType(const std::string &s, T *value) {
+  StreamReader sr(reinterpret_cast<const uint8_t *>(s.data()), s.size(),
+                  /* swap_endian */ false);
+  ascii::AsciiParser parser(&sr);
+  return parser.ReadBasicType(value);
+}
+
+// Large USDA with many toplevel Prim blocks, so that it is split into chunks
+// for parallel parsing. `bad_prims` are Prims with a malformed statement.
+std::string MakeToplevelBlocksUSDA(int num_prims,
+                                   const std::vector<int> &bad_prims = {}) {
+  std::stringstream ss;
+  ss << "#usda 1.0\n";
+  ss << "(\n    defaultPrim = \"prim0\"\n    doc = \"\"\"def \"fake\" {\"\"\"\n)\n\n";
+  ss << "# def Xform \"commented\" {\n\n";
+  for (int i = 0; i < num_prims; i++) {
+    const char *specifier = (i % 7 == 3) ? "over" : ((i % 11 == 5) ? "class" : "def");
+    ss << specifier << " Xform \"prim" << i << "\" (\n";
+    ss << "    doc = \"braces { in } a string \\\" }\"\n";
+    ss << ")\n{\n";
+    ss << "    # comment with {\n";
+    ss << "    asset tex = @./textures/{name}.png@\n";
+    ss << "    rel target = </prim" << ((i + 1) % num_prims) << ">\n";
+    ss << "    string info = \"\"\"multi\nline { string\"\"\"\n";
+    ss << "    float3[] points = [";
+    for (int k = 0; k < 64; k++) {
+      ss << (k ? ", " : "") << "(" << k << ", " << i << ", " << (k * 0.5) << ")";
+    }
+    ss << "]\n";
+    for (int bad : bad_prims) {
+      if (bad == i) {
+        ss << "    float bad = ?\n";
+      }
+    }
+    ss << "    def Scope \"child\" {\n";
+    ss << "        int depth = " << i << "\n";
+    ss << "    }\n";
+    ss << "}\n\n";
+  }
+  return ss.str();
+}
+
+struct LayerResult {
+  bool ok{false};
+  std::string layer;
+  std::string warn;
+  std::string err;
+};
+
+LayerResult ParseUSDAWithThreads(const std::string &usda, int num_threads) {
+  USDLoadOptions options;
+  options.num_threads = num_threads;
+
+  LayerResult result;
+  Layer layer;
+  result.ok = LoadUSDALayerFromMemory(
+      reinterpret_cast<const uint8_t *>(usda.data()), usda.size(), "test.usda",
+      &layer, &result.warn, &result.err, options);
+  if (result.ok) {
+    result.layer = print_layer(layer, 0);
+  }
+  return result;
+}
+
+}  // namespace
+
+void ascii_parser_numeric_literal_test(void) {
+  // Token and the position after lexing. The position matches the former
+  // per-character lexer, which also consumes a delimiter after some literals.
+  struct LexCase {
+    std::string input;
+    bool ok;
+    std::string token;
+    uint64_t loc;
+  };
+  const std::vector<LexCase> cases = {
+      {"1.5 ", true, "1.5", 4},         {"-2.5e+3,", true, "-2.5e+3", 7},
+      {".5)", true, ".5", 3},           {"+.7]", true, "+.", 2},
+      {"3.\n", true, "3.", 3},          {"1E-2 ", true, "1E-2", 4},
+      {"42\r\n", true, "42", 2},        {"-0", true, "-0", 2},
+      {"6.02e23\t", true, "6.02e23", 7}, {"1e", true, "1", 2},
+      {"1.5.3", true, "1.5", 3},        {"abc", false, "", 1},
+      {"-", false, "", 1},              {"+", false, "", 1}};
+
+  for (const auto &c : cases) {
+    LexResult range = LexFloatRange(c.input);
+    TEST_CHECK(range.ok == c.ok);
+    TEST_CHECK(range.token == c.token);
+    TEST_CHECK(range.loc == c.loc);
+    TEST_MSG("input `%s`, token `%s`, loc %d", c.input.c_str(),
+             range.token.c_str(), int(range.loc));
+
+    LexResult str = LexFloatString(c.input);
+    TEST_CHECK(str.ok == range.ok);
+    TEST_CHECK(str.token == range.token);
+    TEST_CHECK(str.loc == range.loc);
+  }
+
+  TEST_CHECK(!LexFloatRange("abc").ok);
+  TEST_CHECK(!LexFloatRange("").ok);
+
+  {
+    float f;
+    TEST_CHECK(ReadBasicType("1.5", &f));
+    TEST_CHECK(f == 1.5f);
+    TEST_CHECK(ReadBasicType("-0.25e1", &f));
+    TEST_CHECK(f == -2.5f);
+    TEST_CHECK(!ReadBasicType("x", &f));
+
+    double d;
+    TEST_CHECK(ReadBasicType("-2.5e+3", &d));
+    TEST_CHECK(d == -2500.0);
+    TEST_CHECK(ReadBasicType("0.1", &d));
+    TEST_CHECK(d == 0.1);
+
+    // Integer is parsed as a floating-point literal first, and falls back to
+    // the integer-only lexer when it is not a floating-point literal.
+    int i;
+    TEST_CHECK(ReadBasicType("42", &i));
+    TEST_CHECK(i == 42);
+    TEST_CHECK(ReadBasicType("-7 ", &i));
+    TEST_CHECK(i == -7);
+    TEST_CHECK(ReadBasicType("1e3", &i));
+    TEST_CHECK(i == 1000);
+    TEST_CHECK(!ReadBasicType("x", &i));
+  }
+
+  // Scalar attributes and `None`.
+  {
+    std::string usda = "#usda 1.0\ndef Xform \"a\"\n{\n";
+    usda += "    float f = 1.5\n";
+    usda += "    double  d  =  -2.5e+3 \n";
+    usda += "    int i = 1e3\n";
+    usda += "    float blocked = None\n";
+    usda += "}\n";
+    ParseResult result = ParseUSDA(usda);
+    TEST_CHECK(result.ok);
+    TEST_MSG("%s", result.err.c_str());
+
+    float f{0.0f};
+    TEST_CHECK(GetAttr(result.layer, "f", &f));
+    TEST_CHECK(f == 1.5f);
+    double d{0.0};
+    TEST_CHECK(GetAttr(result.layer, "d", &d));
+    TEST_CHECK(d == -2500.0);
+    int i{0};
+    TEST_CHECK(GetAttr(result.layer, "i", &i));
+    TEST_CHECK(i == 1000);
+    TEST_CHECK(result.layer_str.find("float blocked = None") !=
+               std::string::npos);
+  }
+
+  // Line number in the error message.
+  {
+    std::string usda = "#usda 1.0\ndef Xform \"a\"\n{\n";
+    usda += "    float f = 1.5\n";
+    usda += "    double d = -2.5e+3\n";
+    usda += "    int bad = -\n";
+    usda += "}\n";
+    ParseResult result = ParseUSDA(usda);
+    TEST_CHECK(!result.ok);
+    TEST_CHECK(result.err.find("near line 6,") != std::string::npos);
+    TEST_MSG("%s", result.err.c_str());
+  }
+}
+
+void ascii_parser_numeric_array_test(void) {
+  // int
+  {
+    const std::string body = "1, -2, +3,\n 2147483647, -2147483648, 0,";
+    ParseResult fast = ParseUSDA(MakeArrayUSDA("int[] x", body, false));
+    TEST_CHECK(fast.ok);
+    TEST_MSG("%s", fast.err.c_str());
+
+    std::vector<int> v;
+    TEST_CHECK(GetAttr(fast.layer, "x", &v));
+    TEST_CHECK(v == std::vector<int>({1, -2, 3, 2147483647, -2147483648, 0}));
+
+    CheckSameResult("int[] x", body);
+  }
+
+  // Floating-point literals for `int` are handled by the generic parser.
+  {
+    ParseResult fast = ParseUSDA(MakeArrayUSDA("int[] x", "1e3, 1.0, 2", false));
+    ParseResult generic =
+        ParseUSDA(MakeArrayUSDA("int[] x", "1e3, 1.0, 2", true));
+    TEST_CHECK(fast.ok == generic.ok);
+    TEST_CHECK(fast.layer_str == generic.layer_str);
+
+    std::vector<int> v, generic_v;
+    TEST_CHECK(GetAttr(fast.layer, "x", &v) ==
+               GetAttr(generic.layer, "x", &generic_v));
+    TEST_CHECK(v == generic_v);
+
+    CheckSameResult("int[] x", "1e3");
+    CheckSameResult("int[] x", "1.0");
+    CheckSameResult("int[] x", "2, 1.5e2");
+    CheckSameResult("int[] x", "007");
+    CheckSameResult("int[] x", "2147483648");
+    CheckSameResult("int2[] x", "(1, 2), (1e3, 1.0)");
+  }
+
+  // float, double and tuples.
+  {
+    const std::string body = "(0, 1.5, -2), (.5, .25, -1e-3),\n(1E+2, 3., 4)";
+    ParseResult fast = ParseUSDA(MakeArrayUSDA("point3f[] x", body, false));
+    TEST_CHECK(fast.ok);
+    TEST_MSG("%s", fast.err.c_str());
+
+    std::vector<value::point3f> v;
+    TEST_CHECK(GetAttr(fast.layer, "x", &v));
+    TEST_CHECK(v.size() == 3);
+    if (v.size() == 3) {
+      TEST_CHECK(v[1].x == 0.5f);
+      TEST_CHECK(v[1].z == -1e-3f);
+      TEST_CHECK(v[2].x == 100.0f);
+    }
+
+    CheckSameResult("point3f[] x", body);
+    CheckSameResult("float[] x", "1, 2.5, -3e2, .5,");
+    CheckSameResult("float[] x", "+.25, -.5, +1");
+    CheckSameResult("double[] x", "0.1, 1e-300, -2.25");
+    CheckSameResult("color4d[] x", "(1, 0.5, 0.25, 1)");
+    CheckSameResult("texCoord2f[] x", "(0, 1), (1, 0)");
+    CheckSameResult("matrix2d[] x", "((1, 0), (0, 1)), ((2, 0), (0, 2))");
+    CheckSameResult("matrix4d[] x",
+                    "((1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (1, 2, 3, 1))");
+  }
+
+  // Non-plain and malformed input.
+  {
+    CheckSameResult("float[] x", "1, inf, -inf");
+    CheckSameResult("float[] x", "1, , 2");
+    CheckSameResult("float[] x", "1 2");
+    CheckSameResult("float[] x", "1e, 2");
+    CheckSameResult("float3[] x", "(1, 2), (3, 4, 5)");
+    CheckSameResult("float3[] x", "(1, 2, 3, 4)");
+    CheckSameResult("int[] x", "-, 1");
+  }
+
+  // Line and column of the error after the array.
+  CheckSameResult("float3[] x", "(1, 2, 3),\n  (4, 5, 6)",
+                  "    float bad = 1.5.3\n");
+  CheckSameResult("int[] x", "1,\n2,\n3", "    int bad = ?\n");
+}
+
+void ascii_parser_parallel_toplevel_test(void) {
+  if (!thread::IsThreadingEnabled()) {
+    // Parallel parsing is not compiled in. Still check the multi-threaded
+    // option gives the serial result.
+    TEST_CHECK(thread::GetNumThreads(4) == 1);
+  }
+
+  // Larger than the minimum chunk size(64 KB) multiplied by the number of
+  // threads.
+  {
+    const std::string usda = MakeToplevelBlocksUSDA(/* num_prims */ 384);
+    TEST_CHECK(usda.size() > 4 * 64 * 1024);
+
+    LayerResult serial = ParseUSDAWithThreads(usda, 1);
+    TEST_CHECK(serial.ok);
+    TEST_MSG("%s", serial.err.c_str());
+    TEST_CHECK(serial.layer.find("prim383") != std::string::npos);
+
+    for (int num_threads : {2, 4, 7}) {
+      LayerResult parallel = ParseUSDAWithThreads(usda, num_threads);
+      TEST_CHECK(parallel.ok);
+      TEST_CHECK(parallel.layer == serial.layer);
+      TEST_CHECK(parallel.warn == serial.warn);
+      TEST_CHECK(parallel.err == serial.err);
+      TEST_MSG("num_threads %d", num_threads);
+    }
+  }
+
+  // Malformed input reports the same error in the same order.
+  for (const std::vector<int> &bad_prims :
+       std::vector<std::vector<int>>{{0}, {300}, {31, 130, 350}}) {
+    const std::string usda = MakeToplevelBlocksUSDA(384, bad_prims);
+
+    LayerResult serial = ParseUSDAWithThreads(usda, 1);
+    TEST_CHECK(!serial.ok);
+    TEST_CHECK(!serial.err.empty());
+
+    LayerResult parallel = ParseUSDAWithThreads(usda, 4);
+    TEST_CHECK(parallel.ok == serial.ok);
+    TEST_CHECK(parallel.err == serial.err);
+    TEST_CHECK(parallel.warn == serial.warn);
+    TEST_MSG("serial: %s\nparallel: %s", serial.err.c_str(),
+             parallel.err.c_str());
+  }
+
+  // Unbalanced braces.
+  {
+    std::string usda = MakeToplevelBlocksUSDA(384);
+    usda += "def Xform \"unclosed\" {\n    int a = 1\n";
+
+    LayerResult serial = ParseUSDAWithThreads(usda, 1);
+    LayerResult parallel = ParseUSDAWithThreads(usda, 4);
+    TEST_CHECK(parallel.ok == serial.ok);
+    TEST_CHECK(parallel.layer == serial.layer);
+    TEST_CHECK(parallel.err == serial.err);
+    TEST_MSG("serial: %s\nparallel: %s", serial.err.c_str(),
+             parallel.err.c_str());
+  }
+}
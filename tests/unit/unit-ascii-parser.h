@@ -0,0 +1,5 @@
+#pragma once
+
+void ascii_parser_numeric_literal_test(void);
+void ascii_parser_numeric_array_test(void);
+void ascii_parser_parallel_toplevel_test(void);
@@ -0,0 +1,109 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "unit-integer-coding.h"
+#include "integerCoding.h"
+
+using namespace tinyusdz;
+
+namespace {
+
+// Deltas which use all of 2-bit codes(common, 8/16/32-bit for 32-bit ints).
+template <typename T>
+std::vector<T> MakeInts(size_t n, uint32_t seed) {
+  std::vector<T> v(n);
+  uint32_t x = seed;
+  T val = 0;
+  for (size_t i = 0; i < n; i++) {
+    // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    int64_t delta;
+    switch (x % 5) {
+      case 0: delta = 1; break;
+      case 1: delta = int64_t(x % 256) - 128; break;
+      case 2: delta = int64_t(x % 65536) - 32768; break;
+      case 3: delta = int64_t(int32_t(x)); break;
+      default: delta = int64_t(uint64_t(x) << 24); break;
+    }
+    val = T(uint64_t(val) + uint64_t(delta));
+    v[i] = val;
+  }
+  return v;
+}
+
+template <typename T, typename Compressor>
+bool Roundtrip(const std::vector<T> &v) {
+  std::vector<char> compressed(Compressor::GetCompressedBufferSize(v.size()));
+  std::string err;
+  size_t compressed_size = Compressor::CompressToBuffer(
+      v.data(), v.size(), compressed.data(), &err);
+  if (v.size() && !compressed_size) {
+    return false;
+  }
+
+  // With and without working space.
+  std::vector<char> working_space(
+      Compressor::GetDecompressionWorkingSpaceSize(v.size()));
+  for (int i = 0; i < 2; i++) {
+    std::vector<T> decoded(v.size());
+    size_t n = Compressor::DecompressFromBuffer(
+        compressed.data(), compressed_size, decoded.data(), decoded.size(),
+        &err, i ? working_space.data() : nullptr);
+    if ((n != v.size()) || (decoded != v)) {
+      return false;
+    }
+  }
+  return err.empty();
+}
+
+}  // namespace
+
+void integer_coding_test(void) {
+  // Cover the tail handling of SIMD decoders.
+  for (size_t n = 1; n < 80; n++) {
+    TEST_CHECK((Roundtrip<int32_t, Usd_IntegerCompression>(MakeInts<int32_t>(n, uint32_t(n)))));
+    TEST_CHECK((Roundtrip<uint32_t, Usd_IntegerCompression>(MakeInts<uint32_t>(n, uint32_t(n) + 1))));
+    TEST_CHECK((Roundtrip<int64_t, Usd_IntegerCompression64>(MakeInts<int64_t>(n, uint32_t(n) + 2))));
+    TEST_CHECK((Roundtrip<uint64_t, Usd_IntegerCompression64>(MakeInts<uint64_t>(n, uint32_t(n) + 3))));
+  }
+
+  TEST_CHECK((Roundtrip<int32_t, Usd_IntegerCompression>(MakeInts<int32_t>(100000, 7))));
+  TEST_CHECK((Roundtrip<int64_t, Usd_IntegerCompression64>(MakeInts<int64_t>(100000, 7))));
+
+  // Indices(e.g. faceVertexIndices) mostly use the common value.
+  {
+    std::vector<int32_t> v(10000);
+    for (size_t i = 0; i < v.size(); i++) {
+      v[i] = int32_t(i);
+    }
+    TEST_CHECK((Roundtrip<int32_t, Usd_IntegerCompression>(v)));
+  }
+
+  // Encoded data shorter than the requested # of ints must be an error.
+  {
+    std::vector<int32_t> v = MakeInts<int32_t>(1000, 11);
+    std::vector<char> compressed(
+        Usd_IntegerCompression::GetCompressedBufferSize(v.size()));
+    std::string err;
+    size_t compressed_size = Usd_IntegerCompression::CompressToBuffer(
+        v.data(), v.size(), compressed.data(), &err);
+    TEST_CHECK(compressed_size > 0);
+
+    std::vector<int32_t> decoded(v.size() * 2);
+    size_t n = Usd_IntegerCompression::DecompressFromBuffer(
+        compressed.data(), compressed_size, decoded.data(), decoded.size(),
+        &err);
+    TEST_CHECK(n == 0);
+    TEST_CHECK(!err.empty());
+  }
+}
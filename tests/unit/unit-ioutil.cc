@@ -5,6 +5,11 @@
 #define TEST_NO_MAIN
 #include "acutest.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
 #include "unit-ioutil.h"
 #include "io-util.hh"
 
@@ -15,3 +20,47 @@ void ioutil_test(void) {
     TEST_CHECK(io::JoinPath("./", "./dora") == "./dora");
   }
 }
+
+void ioutil_mmap_test(void) {
+  const std::string filename = "unit-ioutil-mmap.bin";
+  const std::string content = "#usda 1.0\n# mmap test\n";
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << content;
+  }
+
+  if (!io::IsMMapSupported()) {
+    std::string err;
+    TEST_CHECK(io::MMapFileShared(filename, /* writable */ false, &err) ==
+               nullptr);
+    std::remove(filename.c_str());
+    return;
+  }
+
+  {
+    std::string err;
+    std::shared_ptr<io::MMapFileHandle> handle =
+        io::MMapFileShared(filename, /* writable */ false, &err);
+    TEST_CHECK(handle != nullptr);
+    TEST_MSG("%s", err.c_str());
+    if (handle) {
+      TEST_CHECK(handle->size == content.size());
+      TEST_CHECK(handle->writable == false);
+
+      // Mapping is alive while any reference to the handle exists.
+      std::shared_ptr<const void> owner = handle;
+      const uint8_t *addr = handle->addr;
+      handle.reset();
+      TEST_CHECK(std::memcmp(addr, content.data(), content.size()) == 0);
+    }
+  }
+
+  {
+    std::string err;
+    TEST_CHECK(io::MMapFileShared("unit-ioutil-mmap-nonexistent.bin",
+                                  /* writable */ false, &err) == nullptr);
+    TEST_CHECK(!err.empty());
+  }
+
+  std::remove(filename.c_str());
+}
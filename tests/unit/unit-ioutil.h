@@ -1,3 +1,4 @@
 #pragma once
 
 void ioutil_test(void);
+void ioutil_mmap_test(void);
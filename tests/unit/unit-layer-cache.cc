@@ -0,0 +1,276 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "unit-layer-cache.h"
+#include "composition.hh"
+#include "layer-cache.hh"
+#include "pprinter.hh"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+std::shared_ptr<const Layer> MakeLayer(const std::string &name) {
+  auto layer = std::make_shared<Layer>();
+  PrimSpec ps(Specifier::Def, "Xform", name);
+  layer->add_primspec(name, ps);
+  return layer;
+}
+
+// In-memory assets served through AssetResolutionHandler.
+using AssetMap = std::map<std::string, std::string>;
+
+int ResolveAsset(const char *asset_name,
+                 const std::vector<std::string> &search_paths,
+                 std::string *resolved_asset_name, std::string *err,
+                 void *userdata) {
+  (void)search_paths;
+  (void)err;
+  const AssetMap *assets = reinterpret_cast<const AssetMap *>(userdata);
+  if (!assets->count(asset_name)) {
+    return -1;
+  }
+  (*resolved_asset_name) = asset_name;
+  return 0;
+}
+
+int SizeAsset(const char *resolved_asset_name, uint64_t *nbytes,
+              std::string *err, void *userdata) {
+  (void)err;
+  const AssetMap *assets = reinterpret_cast<const AssetMap *>(userdata);
+  (*nbytes) = assets->at(resolved_asset_name).size();
+  return 0;
+}
+
+int ReadAsset(const char *resolved_asset_name, uint64_t req_nbytes,
+              uint8_t *out_buf, uint64_t *nbytes, std::string *err,
+              void *userdata) {
+  (void)err;
+  const AssetMap *assets = reinterpret_cast<const AssetMap *>(userdata);
+  const std::string &data = assets->at(resolved_asset_name);
+  if (req_nbytes < data.size()) {
+    return -1;
+  }
+  memcpy(out_buf, data.data(), data.size());
+  (*nbytes) = data.size();
+  return 0;
+}
+
+}  // namespace
+
+void layer_cache_test(void) {
+  LayerCacheKey key_a;
+  key_a.resolved_path = "a.usda";
+  key_a.size = 100;
+  key_a.mtime = 1;
+
+  LayerCacheKey key_b;
+  key_b.resolved_path = "b.usda";
+  key_b.size = 100;
+  key_b.mtime = 1;
+
+  LayerCacheKey key_c;
+  key_c.resolved_path = "c.usda";
+  key_c.size = 100;
+  key_c.mtime = 1;
+
+  // find/insert
+  {
+    LayerCache cache;
+    TEST_CHECK(cache.find(key_a) == nullptr);
+
+    auto layer = MakeLayer("a");
+    TEST_CHECK(cache.insert(key_a, layer, 100) == layer);
+    TEST_CHECK(cache.find(key_a) == layer);
+    TEST_CHECK(cache.size() == 1);
+    TEST_CHECK(cache.memory_usage() == 100);
+    TEST_CHECK(cache.num_hits() == 1);
+    TEST_CHECK(cache.num_misses() == 1);
+
+    // The Layer added first wins.
+    TEST_CHECK(cache.insert(key_a, MakeLayer("a"), 100) == layer);
+
+    // Modified asset.
+    LayerCacheKey modified = key_a;
+    modified.mtime = 2;
+    TEST_CHECK(cache.find(modified) == nullptr);
+    TEST_CHECK(cache.size() == 0);
+    TEST_CHECK(cache.memory_usage() == 0);
+  }
+
+  // LRU eviction
+  {
+    LayerCache cache(/* memory_budget */ 250);
+    auto layer_a = MakeLayer("a");
+    cache.insert(key_a, layer_a, 100);
+    cache.insert(key_b, MakeLayer("b"), 100);
+
+    // `a` is now the most recently used.
+    TEST_CHECK(cache.find(key_a) == layer_a);
+
+    cache.insert(key_c, MakeLayer("c"), 100);
+    TEST_CHECK(cache.size() == 2);
+    TEST_CHECK(cache.memory_usage() == 200);
+    TEST_CHECK(cache.find(key_b) == nullptr);
+    TEST_CHECK(cache.find(key_a) != nullptr);
+    TEST_CHECK(cache.find(key_c) != nullptr);
+
+    // Evicted Layer is still valid.
+    TEST_CHECK(layer_a->has_primspec("a"));
+
+    // Too large to cache.
+    auto large = MakeLayer("b");
+    TEST_CHECK(cache.insert(key_b, large, 1000) == large);
+    TEST_CHECK(cache.find(key_b) == nullptr);
+
+    cache.set_memory_budget(100);
+    TEST_CHECK(cache.size() == 1);
+
+    cache.clear();
+    TEST_CHECK(cache.size() == 0);
+    TEST_CHECK(cache.memory_usage() == 0);
+  }
+}
+
+void layer_cache_composition_test(void) {
+  AssetMap assets;
+  assets["prop.usda"] = R"(#usda 1.0
+(
+    defaultPrim = "prop"
+)
+
+def Xform "prop"
+{
+    int myval = 3
+}
+)";
+
+  const char *root = R"(#usda 1.0
+
+def Xform "a" (
+    prepend references = @prop.usda@
+)
+{
+}
+
+def Xform "b" (
+    prepend references = @prop.usda@
+)
+{
+}
+
+def Xform "c" (
+    references = @prop.usda@
+)
+{
+}
+)";
+
+  Layer layer;
+  std::string warn;
+  std::string err;
+  TEST_CHECK(LoadLayerFromMemory(reinterpret_cast<const uint8_t *>(root),
+                                 strlen(root), "root.usda", &layer, &warn,
+                                 &err));
+  TEST_MSG("%s", err.c_str());
+
+  AssetResolutionHandler handler;
+  handler.resolve_fun = ResolveAsset;
+  handler.size_fun = SizeAsset;
+  handler.read_fun = ReadAsset;
+  handler.userdata = &assets;
+
+  AssetResolutionResolver resolver;
+  resolver.register_asset_resolution_handler("usda", handler);
+
+  Layer expected;
+  TEST_CHECK(CompositeReferences(resolver, layer, &expected, &warn, &err));
+  TEST_MSG("%s", err.c_str());
+
+  LayerCache cache;
+  ReferencesCompositionOptions options;
+  options.layer_cache = &cache;
+
+  Layer composited;
+  TEST_CHECK(CompositeReferences(resolver, layer, &composited, &warn, &err,
+                                 options));
+  TEST_MSG("%s", err.c_str());
+
+  // `prop.usda` is parsed only once.
+  TEST_CHECK(cache.size() == 1);
+  TEST_CHECK(cache.num_misses() == 1);
+  TEST_CHECK(cache.num_hits() == 2);
+
+  TEST_CHECK(print_layer(composited, 0) == print_layer(expected, 0));
+  TEST_CHECK(print_layer(composited, 0).find("int myval = 3") !=
+             std::string::npos);
+
+  // Load assets in parallel.
+  {
+    assets["prop2.usda"] = R"(#usda 1.0
+
+def Xform "prop2"
+{
+    float myval2 = 1.5
+}
+)";
+
+    const char *root2 = R"(#usda 1.0
+
+def Xform "a" (
+    prepend references = @prop.usda@
+)
+{
+    def Xform "child" (
+        prepend references = @prop2.usda@
+    )
+    {
+    }
+}
+
+def Xform "b" (
+    prepend references = @prop2.usda@
+)
+{
+}
+)";
+
+    Layer layer2;
+    TEST_CHECK(LoadLayerFromMemory(reinterpret_cast<const uint8_t *>(root2),
+                                   strlen(root2), "root2.usda", &layer2, &warn,
+                                   &err));
+
+    Layer serial;
+    TEST_CHECK(CompositeReferences(resolver, layer2, &serial, &warn, &err));
+    TEST_MSG("%s", err.c_str());
+
+    ReferencesCompositionOptions parallel_options;
+    parallel_options.num_threads = 4;
+
+    Layer parallel;
+    TEST_CHECK(CompositeReferences(resolver, layer2, &parallel, &warn, &err,
+                                   parallel_options));
+    TEST_MSG("%s", err.c_str());
+
+    TEST_CHECK(print_layer(parallel, 0) == print_layer(serial, 0));
+    TEST_CHECK(print_layer(parallel, 0).find("float myval2 = 1.5") !=
+               std::string::npos);
+  }
+
+  // Modified asset is parsed again.
+  assets["prop.usda"] += "\n";
+  TEST_CHECK(CompositeReferences(resolver, layer, &composited, &warn, &err,
+                                 options));
+  TEST_CHECK(cache.num_misses() == 2);
+  TEST_CHECK(cache.size() == 1);
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+void layer_cache_test(void);
+void layer_cache_composition_test(void);
@@ -16,11 +16,22 @@
 #include "unit-strutil.h"
 #include "unit-timesamples.h"
 #include "unit-pprint.h"
+#include "unit-thread-util.h"
+#include "unit-stage.h"
+#include "unit-usdc-writer.h"
+#include "unit-integer-coding.h"
+#include "unit-layer-cache.h"
+#include "unit-usdc-reader.h"
+#include "unit-ascii-parser.h"
 
 #if defined(TINYUSDZ_WITH_PXR_COMPAT_API)
 #include "unit-pxr-compat-api.h"
 #endif
 
+#if defined(TINYUSDZ_WITH_TYDRA)
+#include "unit-tydra.h"
+#endif
+
 
 
 TEST_LIST = {
@@ -28,6 +39,7 @@ TEST_LIST = {
   { "prim_add_test", prim_add_test },
   { "primvar_test", primvar_test },
   { "value_types_test", value_types_test },
+  { "value_type_pprint_test", value_type_pprint_test },
   { "xformOp_test", xformOp_test },
   { "customdata_test", customdata_test },
   { "handle_allocator_test", handle_allocator_test },
@@ -36,10 +48,40 @@ TEST_LIST = {
   { "math_sin_cos_pi_test", math_sin_cos_pi_test },
   { "pathutil_test", pathutil_test },
   { "ioutil_test", ioutil_test },
+  { "ioutil_mmap_test", ioutil_mmap_test },
   { "strutil_test", strutil_test },
   { "timesamples_test", timesamples_test },
+  { "thread_util_test", thread_util_test },
+  { "stage_prim_lookup_test", stage_prim_lookup_test },
+  { "usdc_writer_roundtrip_test", usdc_writer_roundtrip_test },
+  { "usdc_writer_compression_test", usdc_writer_compression_test },
+  { "usdc_writer_stage_test", usdc_writer_stage_test },
+  { "integer_coding_test", integer_coding_test },
+  { "layer_cache_test", layer_cache_test },
+  { "layer_cache_composition_test", layer_cache_composition_test },
+  { "usdc_reader_thread_test", usdc_reader_thread_test },
+  { "usdc_reader_path_hierarchy_test", usdc_reader_path_hierarchy_test },
+  { "usdc_reader_lazy_test", usdc_reader_lazy_test },
+  { "usdc_reader_mmap_test", usdc_reader_mmap_test },
+  { "usdc_reader_array_view_test", usdc_reader_array_view_test },
+  { "ascii_parser_numeric_literal_test", ascii_parser_numeric_literal_test },
+  { "ascii_parser_numeric_array_test", ascii_parser_numeric_array_test },
+  { "ascii_parser_parallel_toplevel_test", ascii_parser_parallel_toplevel_test },
 #if defined(TINYUSDZ_WITH_PXR_COMPAT_API)
   { "pxr_compat_api_test", pxr_compat_api_test },
+#endif
+#if defined(TINYUSDZ_WITH_TYDRA)
+  { "tydra_build_indices_test", tydra_build_indices_test },
+  { "tydra_point_instancer_test", tydra_point_instancer_test },
+  { "tydra_update_to_time_test", tydra_update_to_time_test },
+  { "tydra_parallel_mesh_conversion_test", tydra_parallel_mesh_conversion_test },
+  { "tydra_compute_vertex_normals_test", tydra_compute_vertex_normals_test },
+  { "tydra_triangulate_test", tydra_triangulate_test },
+  { "tydra_skinning_test", tydra_skinning_test },
+  { "tydra_blendshape_inbetween_test", tydra_blendshape_inbetween_test },
+  { "tydra_xform_cache_test", tydra_xform_cache_test },
+  { "tydra_bbox_cache_test", tydra_bbox_cache_test },
+  { "tydra_mesh_lod_test", tydra_mesh_lod_test },
 #endif
   { nullptr, nullptr }
 };
@@ -7,9 +7,12 @@
 
 #include "unit-pprint.h"
 #include "prim-types.hh"
+#include "usdGeom.hh"
 #include "value-types.hh"
 #include "value-pprint.hh"
 #include "pprinter.hh"
+#include "stage.hh"
+#include "text-sink.hh"
 
 using namespace tinyusdz;
 
@@ -27,5 +30,62 @@ void value_type_pprint_test(void) {
     std::string s = to_string(v);
     TEST_CHECK(s == "(1, 2, 3)");
   }
+
+  // Large arrays are formatted in chunks. Result must be identical to
+  // element-wise printing.
+  {
+    const size_t n = value::kParallelPrintArraySize + 123;
+    std::vector<int32_t> iv(n);
+    std::vector<float> fv(n);
+    std::string expected_i = "[";
+    std::string expected_f = "[";
+    for (size_t i = 0; i < n; i++) {
+      iv[i] = int32_t(i) - 1000;
+      fv[i] = float(i) * 0.5f;
+      if (i > 0) {
+        expected_i += ", ";
+        expected_f += ", ";
+      }
+      expected_i += std::to_string(iv[i]);
+      expected_f += (i % 2) ? std::to_string(i / 2) + ".5" : std::to_string(i / 2);
+    }
+    expected_i += "]";
+    expected_f += "]";
+
+    std::stringstream ss;
+    ss << iv;
+    TEST_CHECK(ss.str() == expected_i);
+
+    std::stringstream fss;
+    fss << fv;
+    TEST_CHECK(fss.str() == expected_f);
+  }
+
+  // TextSink
+  {
+    TextSink w;
+    w << "a" << std::string("bc") << 'd';
+    w.write("efg", 2);
+    TEST_CHECK(w.str() == "abcdef");
+    TEST_CHECK(w.size() == 6);
+    TEST_CHECK(w.take() == "abcdef");
+    TEST_CHECK(w.size() == 0);
+  }
+
+  // Stage::ExportTo produces the same text as ExportToString.
+  {
+    Stage stage;
+    Xform xform;
+    Prim root("root", xform);
+    GeomMesh mesh;
+    Prim child("mesh", mesh);
+    TEST_CHECK(root.add_child(std::move(child)));
+    TEST_CHECK(stage.add_root_prim(std::move(root)));
+
+    TextSink w;
+    stage.ExportTo(w);
+    TEST_CHECK(w.str() == stage.ExportToString());
+    TEST_CHECK(w.str().find("def Mesh \"mesh\"") != std::string::npos);
+  }
 }
 
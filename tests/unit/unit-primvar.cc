@@ -33,4 +33,65 @@ void primvar_test(void) {
     
   }
 
+  // deferred value
+  {
+    int num_loads = 0;
+    PrimVar var;
+    var.set_deferred_value([&num_loads](Value *dst, std::string *err) {
+      (void)err;
+      num_loads++;
+      (*dst) = std::vector<float>{1.0f, 2.0f};
+      return true;
+    });
+
+    TEST_CHECK(var.has_deferred() == true);
+    TEST_CHECK(var.has_value() == true);
+    TEST_CHECK(num_loads == 0);
+
+    auto pv = var.get_value<std::vector<float>>();
+    TEST_CHECK(pv.has_value() == true);
+    TEST_CHECK(pv.value().size() == 2);
+    TEST_CHECK(var.has_deferred() == false);
+
+    // loaded only once.
+    TEST_CHECK(var.as<std::vector<float>>() != nullptr);
+    TEST_CHECK(num_loads == 1);
+
+    PrimVar failed;
+    failed.set_deferred_timesamples([](TimeSamples *dst, std::string *err) {
+      (void)dst;
+      (*err) = "fail";
+      return false;
+    });
+    TEST_CHECK(failed.has_timesamples() == true);
+    std::string err;
+    TEST_CHECK(failed.materialize(&err) == false);
+    TEST_CHECK(err == "fail");
+    TEST_CHECK(failed.has_timesamples() == false);
+
+    // Setting a value after the(failed) load must not bring back the
+    // already loaded TimeSamples.
+    failed.set_value(1.0f);
+    TEST_CHECK(failed.has_deferred() == false);
+    TEST_CHECK(failed.has_timesamples() == false);
+    TEST_CHECK(failed.is_scalar() == true);
+
+    failed.clear_value();
+    TEST_CHECK(failed.has_value() == false);
+
+    // Same for the deferred value followed by TimeSamples edits.
+    PrimVar loaded;
+    loaded.set_deferred_value([](Value *dst, std::string *err) {
+      (void)err;
+      (*dst) = 2.0f;
+      return true;
+    });
+    TEST_CHECK(loaded.materialize() == true);
+    loaded.set_timesamples(TimeSamples());
+    TEST_CHECK(loaded.has_deferred() == false);
+    TEST_CHECK(loaded.has_timesamples() == false);
+    TEST_CHECK(loaded.is_scalar() == true);
+    TEST_CHECK(loaded.get_value<float>().value() == 2.0f);
+  }
+
 }
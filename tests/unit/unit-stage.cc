@@ -0,0 +1,146 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include "unit-stage.h"
+#include "prim-types.hh"
+#include "stage.hh"
+
+using namespace tinyusdz;
+
+void stage_prim_lookup_test(void) {
+  Stage stage;
+
+  {
+    Model amodel;
+    Model bmodel;
+    Model cmodel;
+    Model rootmodel;
+
+    Prim aprim("bora", amodel);
+    Prim bprim("dora", bmodel);
+    Prim cprim("muda", cmodel);
+    Prim root("root", rootmodel);
+
+    TEST_CHECK(aprim.add_child(std::move(cprim)));
+    TEST_CHECK(root.add_child(std::move(aprim)));
+    TEST_CHECK(root.add_child(std::move(bprim)));
+
+    TEST_CHECK(stage.add_root_prim(std::move(root)));
+
+    Model xmodel;
+    Prim xprim("xform", xmodel);
+    TEST_CHECK(stage.add_root_prim(std::move(xprim)));
+  }
+
+  // Lookup before commit()
+  {
+    const Prim *prim{nullptr};
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/bora/muda", ""), prim));
+    TEST_CHECK(prim && prim->element_name() == "muda");
+  }
+
+  TEST_CHECK(stage.commit());
+
+  {
+    const Prim *prim{nullptr};
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/dora", ""), prim));
+    TEST_CHECK(prim && prim->element_name() == "dora");
+    TEST_CHECK(prim && prim->absolute_path().full_path_name() == "/root/dora");
+
+    TEST_CHECK(!stage.find_prim_at_path(Path("/root/muda", ""), prim));
+    TEST_CHECK(!stage.find_prim_at_path(Path("/xform/dora", ""), prim));
+    TEST_CHECK(!stage.find_prim_at_path(Path("/root/bo", ""), prim));
+    TEST_CHECK(!stage.find_prim_at_path(Path("/root/bora/mudamuda", ""), prim));
+
+    int64_t prim_id{-1};
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/bora/muda", ""), &prim_id));
+    TEST_CHECK(prim_id > 0);
+
+    const Prim *iprim{nullptr};
+    TEST_CHECK(stage.find_prim_by_prim_id(uint64_t(prim_id), iprim));
+    TEST_CHECK(iprim && iprim->absolute_path().full_path_name() == "/root/bora/muda");
+  }
+
+  // Subtree
+  {
+    std::vector<const Prim *> prims;
+    TEST_CHECK(stage.find_prims_in_subtree(Path("/root", ""), &prims));
+    TEST_CHECK(prims.size() == 4);
+    if (prims.size() == 4) {
+      TEST_CHECK(prims[0]->element_name() == "root");
+      TEST_CHECK(prims[1]->element_name() == "bora");
+      TEST_CHECK(prims[2]->element_name() == "muda");
+      TEST_CHECK(prims[3]->element_name() == "dora");
+    }
+
+    TEST_CHECK(stage.find_prims_in_subtree(Path("/root/bora", ""), &prims));
+    TEST_CHECK(prims.size() == 2);
+
+    TEST_CHECK(stage.find_prims_in_subtree(Path("/xform", ""), &prims));
+    TEST_CHECK(prims.size() == 1);
+
+    TEST_CHECK(!stage.find_prims_in_subtree(Path("/bora", ""), &prims));
+  }
+
+  // Index is rebuilt after the Stage is modified.
+  {
+    Model model;
+    Prim prim("muda", model);
+    TEST_CHECK(stage.add_root_prim(std::move(prim)));
+
+    const Prim *p{nullptr};
+    TEST_CHECK(stage.find_prim_at_path(Path("/muda", ""), p));
+    TEST_CHECK(p && p->element_name() == "muda");
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/bora/muda", ""), p));
+    TEST_CHECK(p && p->element_name() == "muda");
+  }
+
+  // A miss in the up-to-date index is authoritative. Changes made through a
+  // Prim reference obtained from the Stage become visible after `commit()`.
+  {
+    TEST_CHECK(stage.commit());
+
+    int64_t prim_id{-1};
+    TEST_CHECK(stage.find_prim_at_path(Path("/xform", ""), &prim_id));
+
+    Prim *xprim{nullptr};
+    TEST_CHECK(stage.find_prim_by_prim_id(uint64_t(prim_id), xprim));
+    if (xprim) {
+      Model model;
+      Prim child("child", model);
+      TEST_CHECK(xprim->add_child(std::move(child)));
+    }
+
+    const Prim *p{nullptr};
+    TEST_CHECK(!stage.find_prim_at_path(Path("/xform/child", ""), p));
+
+    TEST_CHECK(stage.commit());
+    TEST_CHECK(stage.find_prim_at_path(Path("/xform/child", ""), p));
+    TEST_CHECK(p && p->element_name() == "child");
+
+    TEST_CHECK(!stage.find_prim_by_prim_id(uint64_t(1024 * 1024), p));
+  }
+
+  // Copied Stage must not refer Prims of the source Stage.
+  {
+    Stage copied;
+    {
+      Stage tmp = stage;
+      const Prim *p{nullptr};
+      TEST_CHECK(tmp.find_prim_at_path(Path("/root/dora", ""), p));
+      copied = tmp;
+    }
+
+    const Prim *p{nullptr};
+    TEST_CHECK(copied.find_prim_at_path(Path("/root/dora", ""), p));
+    TEST_CHECK(p && p->element_name() == "dora");
+
+    const Prim *sp{nullptr};
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/dora", ""), sp));
+    TEST_CHECK(p != sp);
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void stage_prim_lookup_test(void);
@@ -0,0 +1,84 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include "thread-util.hh"
+#include "unit-common.hh"
+
+#include <numeric>
+#include <vector>
+
+using namespace tinyusdz;
+using namespace tinyusdz_test;
+
+void thread_util_test(void) {
+
+  TEST_CHECK(thread::GetNumThreads(1) == 1);
+  TEST_CHECK(thread::GetNumThreads(-1) >= 1);
+  TEST_CHECK(thread::GetNumThreads(100000) <= thread::kMaxThreads);
+
+  // Every item must be visited exactly once.
+  {
+    size_t n = 10000;
+    std::vector<int> visited(n, 0);
+    thread::ParallelFor(0, n, 8, [&](size_t i, int thread_id) {
+      (void)thread_id;
+      visited[i] += 1;
+    });
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+      if (visited[i] != 1) {
+        ok = false;
+        break;
+      }
+    }
+    TEST_CHECK(ok);
+  }
+
+  // thread_id must be within [0, num_threads)
+  {
+    size_t n = 1000;
+    int num_threads = thread::GetNumThreads(4);
+    std::vector<int> ids(n, -1);
+    thread::ParallelFor(0, n, 4, [&](size_t i, int thread_id) {
+      ids[i] = thread_id;
+    });
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+      if ((ids[i] < 0) || (ids[i] >= num_threads)) {
+        ok = false;
+        break;
+      }
+    }
+    TEST_CHECK(ok);
+  }
+
+  // Ranges must cover [begin, end) without overlap.
+  {
+    size_t n = 1003;
+    std::vector<int> visited(n, 0);
+    thread::ParallelForRange(3, n, 64, 8, [&](size_t s, size_t e, int thread_id) {
+      (void)thread_id;
+      TEST_CHECK(s < e);
+      TEST_CHECK((e - s) <= 64);
+      for (size_t i = s; i < e; i++) {
+        visited[i] += 1;
+      }
+    });
+
+    TEST_CHECK(std::accumulate(visited.begin(), visited.begin() + 3, 0) == 0);
+    TEST_CHECK(std::accumulate(visited.begin() + 3, visited.end(), 0) == int(n - 3));
+  }
+
+  // Empty range
+  {
+    bool called = false;
+    thread::ParallelFor(5, 5, 4, [&](size_t, int) { called = true; });
+    TEST_CHECK(called == false);
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void thread_util_test(void);
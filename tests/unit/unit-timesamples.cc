@@ -188,6 +188,196 @@ void timesamples_test(void) {
     }      
   }
 
+  // SoA storage
+  {
+    value::TimeSamples ts;
+    std::vector<value::point3f> p0 = {{0.0f, 1.0f, 2.0f}, {3.0f, 4.0f, 5.0f}};
+    std::vector<value::point3f> p1 = {{10.0f, 11.0f, 12.0f}, {13.0f, 14.0f, 15.0f}};
+
+    // add samples in unsorted order.
+    ts.add_sample(10, p1);
+    ts.add_sample(5, value::Value(value::ValueBlock()));
+    ts.add_sample(0, p0);
+    TEST_CHECK(ts.is_pod_storage());
+    TEST_CHECK(ts.size() == 3);
+    TEST_CHECK(ts.type_id() == value::TypeTraits<std::vector<value::point3f>>::type_id());
+
+    TEST_CHECK(math::is_close(ts.get_time(1).value(), 5.0));
+    TEST_CHECK(ts.is_value_block(1));
+    TEST_CHECK(!ts.is_value_block(2));
+
+    // role type
+    std::vector<value::float3> v;
+    TEST_CHECK(ts.get_value(2, &v));
+    TEST_CHECK(v.size() == 2);
+    TEST_CHECK(math::is_close(v[1][2], 15.0f));
+    TEST_CHECK(!ts.get_value(1, &v));
+
+    std::vector<float> fv;
+    TEST_CHECK(!ts.get_value(2, &fv));
+
+    // Held
+    std::vector<value::point3f> pv;
+    TEST_CHECK(ts.get(&pv, 1.0, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(pv.size() == 2);
+    TEST_CHECK(math::is_close(pv[0][1], 1.0f));
+
+    // ValueBlock
+    TEST_CHECK(!ts.get(&pv, 7.0, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(ts.get(&pv, 11.0, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(math::is_close(pv[0][1], 11.0f));
+
+    // get_samples() returns AoS copy and keeps SoA storage.
+    nonstd::optional<value::Value> val = ts.get_value(0);
+    TEST_CHECK(val.has_value());
+    TEST_CHECK(ts.get_samples().size() == 3);
+    TEST_CHECK(ts.is_pod_storage());
+    TEST_CHECK(ts.get_samples()[1].value.type_id() == value::TypeTraits<value::ValueBlock>::type_id());
+    TEST_CHECK(ts.get_samples()[2].value.type_id() == val.value().type_id());
+
+    // The AoS copy is updated after the modification.
+    ts.add_sample(13.0, value::Value(std::vector<value::point3f>{{0.0f, 13.0f, 0.0f}}));
+    TEST_CHECK(ts.is_pod_storage());
+    TEST_CHECK(ts.get_samples().size() == 4);
+    TEST_CHECK(math::is_close(ts.get_samples()[3].t, 13.0));
+
+    // The value is not changed by the conversion to AoS storage.
+    TEST_CHECK(ts.samples().size() == 4);
+    TEST_CHECK(!ts.is_pod_storage());
+    TEST_CHECK(ts.get_samples()[1].value.type_id() == value::TypeTraits<value::ValueBlock>::type_id());
+    TEST_CHECK(ts.get_samples()[2].value.type_id() == val.value().type_id());
+    TEST_CHECK(ts.get(&pv, 11.0, value::TimeSampleInterpolationType::Held));
+    TEST_CHECK(math::is_close(pv[0][1], 11.0f));
+  }
+
+  {
+    value::TimeSamples ts;
+    ts.add_sample(0, value::Value(value::float3{0.0f, 2.0f, 4.0f}));
+    ts.add_sample(1, value::Value(value::float3{10.0f, 12.0f, 14.0f}));
+    TEST_CHECK(ts.is_pod_storage());
+
+    value::float3 f;
+    TEST_CHECK(ts.get(&f, 0.5, value::TimeSampleInterpolationType::Linear));
+    TEST_CHECK(math::is_close(f[0], 5.0f));
+    TEST_CHECK(math::is_close(f[2], 9.0f));
+
+    value::color3f c;
+    TEST_CHECK(ts.get(&c, 0.5, value::TimeSampleInterpolationType::Linear));
+    TEST_CHECK(math::is_close(c[1], 7.0f));
+
+    // Different type falls back to AoS storage.
+    ts.add_sample(2, value::Value(value::token("bora")));
+    TEST_CHECK(!ts.is_pod_storage());
+    TEST_CHECK(ts.size() == 3);
+    TEST_CHECK(ts.get(&f, 0.5, value::TimeSampleInterpolationType::Linear));
+    TEST_CHECK(math::is_close(f[0], 5.0f));
+  }
+
+  // Decode in place
+  {
+    value::TimeSamples ts;
+
+    const std::vector<value::float3> p0 = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+    uint8_t *dst = ts.alloc_pod_sample<value::float3>(0, /* array */ true, p0.size());
+    TEST_CHECK(dst != nullptr);
+    if (dst) {
+      memcpy(dst, p0.data(), p0.size() * sizeof(value::float3));
+    }
+    ts.add_sample(1, value::Value(value::ValueBlock()));
+    TEST_CHECK(ts.alloc_pod_sample<value::float3>(2, /* array */ true, 0) != nullptr);
+
+    // Type mismatch
+    TEST_CHECK(ts.alloc_pod_sample<value::float3>(3, /* array */ false, 1) == nullptr);
+    TEST_CHECK(ts.alloc_pod_sample<value::double3>(3, /* array */ true, 1) == nullptr);
+
+    // Samples are kept sorted, so a sample before the last one must be added
+    // with `add_sample`.
+    TEST_CHECK(ts.alloc_pod_sample<value::float3>(0.5, /* array */ true, 1) == nullptr);
+
+    TEST_CHECK(ts.is_pod_storage());
+    TEST_CHECK(ts.size() == 3);
+    TEST_CHECK(ts.type_id() == value::TypeTraits<std::vector<value::float3>>::type_id());
+    TEST_CHECK(ts.is_value_block(1));
+
+    std::vector<value::point3f> pv;
+    TEST_CHECK(ts.get_value(0, &pv));
+    TEST_CHECK(pv.size() == 2);
+    if (pv.size() == 2) {
+      TEST_CHECK(math::is_close(pv[1][2], 6.0f));
+    }
+    TEST_CHECK(ts.get_value(2, &pv));
+    TEST_CHECK(pv.empty());
+
+    // Reading samples does not convert SoA storage, so the next sample is
+    // still decoded in place.
+    const value::TimeSamples &cts = ts;
+    TEST_CHECK(cts.get_samples().size() == 3);
+    TEST_CHECK(ts.is_pod_storage());
+    TEST_CHECK(ts.alloc_pod_sample<value::float3>(10, /* array */ true, 1) != nullptr);
+    TEST_CHECK(cts.get_samples().size() == 4);
+  }
+
+  // Batched evaluation
+  {
+    Animatable<std::vector<value::point3f>> points;
+    points.add_sample(2, {{2.0f, 2.0f, 2.0f}, {4.0f, 4.0f, 4.0f}});
+    points.add_sample(0, {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}});
+    points.add_sample(4, {{6.0f, 6.0f, 6.0f}, {8.0f, 8.0f, 8.0f}});
+
+    std::vector<double> times = {-1.0, 0.0, 0.5, 1.0, 2.0, 3.0, 4.0, 10.0};
+
+    for (auto interp : {value::TimeSampleInterpolationType::Linear,
+                        value::TimeSampleInterpolationType::Held}) {
+      std::vector<std::vector<value::point3f>> vs;
+      TEST_CHECK(points.get(times, &vs, interp) == (interp == value::TimeSampleInterpolationType::Linear));
+      if (interp == value::TimeSampleInterpolationType::Held) {
+        // `get` fails for time beyond the last sample.
+        continue;
+      }
+      TEST_CHECK(vs.size() == times.size());
+
+      for (size_t i = 0; i < times.size(); i++) {
+        std::vector<value::point3f> v;
+        TEST_CHECK(points.get(times[i], &v, interp));
+        TEST_CHECK(v.size() == vs[i].size());
+        for (size_t k = 0; k < v.size(); k++) {
+          TEST_CHECK(math::is_close(v[k][0], vs[i][k][0]));
+          TEST_CHECK(math::is_close(v[k][2], vs[i][k][2]));
+        }
+      }
+    }
+
+    std::vector<std::vector<value::point3f>> vs;
+    TEST_CHECK(points.get(std::vector<double>{1.0, 3.0}, &vs));
+    TEST_CHECK(math::is_close(vs[0][1][0], 2.0f));
+    TEST_CHECK(math::is_close(vs[1][1][0], 6.0f));
+
+    // unsorted times
+    TEST_CHECK(points.get(std::vector<double>{3.0, 1.0}, &vs));
+    TEST_CHECK(math::is_close(vs[0][1][0], 6.0f));
+    TEST_CHECK(math::is_close(vs[1][1][0], 2.0f));
+  }
+
+  {
+    value::token tok1("bora");
+    value::token tok2("muda");
+
+    Animatable<value::token> toks;
+    toks.add_sample(0, tok1);
+    toks.add_sample(10, tok2);
+    toks.set_default(value::token("dora"));
+
+    std::vector<value::token> vs;
+    TEST_CHECK(toks.get(std::vector<double>{value::TimeCode::Default(), -1.0, 0.0, 5.0, 10.0, 1000.0}, &vs));
+    TEST_CHECK(vs.size() == 6);
+    TEST_CHECK(vs[0].str() == "dora");
+    TEST_CHECK(vs[1].str() == "bora");
+    TEST_CHECK(vs[2].str() == "bora");
+    TEST_CHECK(vs[3].str() == "bora");
+    TEST_CHECK(vs[4].str() == "muda");
+    TEST_CHECK(vs[5].str() == "muda");
+  }
+
   {
     TEST_CHECK(value::IsLerpSupportedType(value::TypeTraits<value::float2>::type_id()));
     TEST_CHECK(value::IsLerpSupportedType(value::TypeTraits<std::vector<value::float2>>::type_id()));
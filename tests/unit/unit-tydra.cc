@@ -0,0 +1,1602 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "unit-tydra.h"
+#include "thread-util.hh"
+#include "tinyusdz.hh"
+#include "tydra/bbox-cache.hh"
+#include "tydra/mesh-util.hh"
+#include "tydra/render-data.hh"
+#include "tydra/skinning.hh"
+#include "xform.hh"
+
+using namespace tinyusdz;
+using namespace tinyusdz::tydra;
+
+void tydra_build_indices_test(void) {
+  // Quad(2 triangles) with facevarying normals. Corners sharing a point have
+  // the same normal except for the point 2.
+  DefaultVertexInput<DefaultPackedVertexData> input;
+  input.point_indices = {0, 1, 2, 0, 2, 3};
+  input.normals = {{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
+                   {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
+                   {0.0f, 0.001f, 1.0f}, {0.0f, 0.0f, 1.0f}};
+
+  // Exact merge.
+  {
+    DefaultVertexOutput<DefaultPackedVertexData> output;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> point_indices;
+
+    BuildIndices<DefaultVertexInput<DefaultPackedVertexData>,
+                 DefaultVertexOutput<DefaultPackedVertexData>,
+                 DefaultPackedVertexData, DefaultPackedVertexDataHasher,
+                 DefaultPackedVertexDataEqual>(input, output, indices,
+                                               point_indices);
+
+    TEST_CHECK(output.size() == 5);
+    TEST_CHECK(indices.size() == 6);
+    if (indices.size() == 6) {
+      // Output vertices are in the order of the first appearance.
+      TEST_CHECK(indices[0] == 0);
+      TEST_CHECK(indices[1] == 1);
+      TEST_CHECK(indices[2] == 2);
+      TEST_CHECK(indices[3] == 0);
+      TEST_CHECK(indices[4] == 3);
+      TEST_CHECK(indices[5] == 4);
+    }
+    TEST_CHECK(point_indices == input.point_indices);
+  }
+
+  // Merge with tolerance.
+  {
+    DefaultVertexOutput<DefaultPackedVertexData> output;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> point_indices;
+
+    BuildIndices<DefaultVertexInput<DefaultPackedVertexData>,
+                 DefaultVertexOutput<DefaultPackedVertexData>,
+                 DefaultPackedVertexData, DefaultPackedVertexDataHasher,
+                 DefaultPackedVertexDataEqual>(input, output, indices,
+                                               point_indices, 0.01f);
+
+    TEST_CHECK(output.size() == 4);
+    TEST_CHECK(indices.size() == 6);
+    if (indices.size() == 6) {
+      TEST_CHECK(indices[2] == 2);
+      TEST_CHECK(indices[4] == 2);
+      TEST_CHECK(indices[5] == 3);
+    }
+    TEST_CHECK(point_indices == input.point_indices);
+  }
+
+  // Vertices of different points are never merged.
+  {
+    std::vector<uint32_t> points = {0, 1, 0, 1};
+    std::vector<float> attribs = {0.0f, 0.0f, 0.0f, 0.0f,
+                                  0.5f, 0.5f, 0.0f, 0.001f};
+    std::vector<uint32_t> similar;
+
+    TEST_CHECK(FindSimilarVertices(points, attribs, 2, 0.01f, &similar));
+    TEST_CHECK(similar.size() == 4);
+    if (similar.size() == 4) {
+      TEST_CHECK(similar[0] == 0);
+      TEST_CHECK(similar[1] == 1);
+      TEST_CHECK(similar[2] == 2);
+      TEST_CHECK(similar[3] == 1);
+    }
+
+    // Invalid attribute length.
+    attribs.pop_back();
+    TEST_CHECK(!FindSimilarVertices(points, attribs, 2, 0.01f, &similar));
+  }
+}
+
+void tydra_point_instancer_test(void) {
+  const char *usda = R"(#usda 1.0
+
+def PointInstancer "instancer"
+{
+    rel prototypes = [</instancer/protos/tri>, </instancer/protos/empty>]
+    int[] protoIndices = [0, 1, 0, 0]
+    point3f[] positions = [(1, 0, 0), (2, 0, 0), (3, 0, 0), (4, 0, 0)]
+    quath[] orientations = [(1, 0, 0, 0), (1, 0, 0, 0), (0.7071068, 0, 0, 0.7071068), (1, 0, 0, 0)]
+    float3[] scales = [(1, 1, 1), (1, 1, 1), (2, 2, 2), (1, 1, 1)]
+    int64[] invisibleIds = [3]
+
+    def Xform "protos"
+    {
+        def Xform "tri"
+        {
+            double3 xformOp:translate = (0, 1, 0)
+            uniform token[] xformOpOrder = ["xformOp:translate"]
+
+            def Mesh "mesh"
+            {
+                int[] faceVertexCounts = [3]
+                int[] faceVertexIndices = [0, 1, 2]
+                point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+            }
+        }
+
+        def Xform "empty"
+        {
+        }
+    }
+}
+)";
+
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                strlen(usda), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return;
+  }
+
+  RenderSceneConverterEnv env(stage);
+  RenderSceneConverter converter;
+  RenderScene scene;
+
+  ret = converter.ConvertToRenderScene(env, &scene);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", converter.GetError().c_str());
+    return;
+  }
+
+  // Prototype mesh is converted only once.
+  TEST_CHECK(scene.meshes.size() == 1);
+
+  TEST_CHECK(scene.nodes.size() == 1);
+  if (scene.nodes.size() == 1) {
+    TEST_CHECK(scene.nodes[0].nodeType == NodeType::PointInstancer);
+    TEST_CHECK(scene.nodes[0].id == 0);
+    // Prototypes are not traversed as regular nodes.
+    TEST_CHECK(scene.nodes[0].children.empty());
+  }
+
+  TEST_CHECK(scene.instancers.size() == 1);
+  if (scene.instancers.size() != 1) {
+    return;
+  }
+
+  const RenderPointInstancer &instancer = scene.instancers[0];
+  TEST_CHECK(instancer.abs_path == "/instancer");
+  TEST_CHECK(instancer.num_instances == 3);
+  TEST_CHECK(instancer.prototypes.size() == 2);
+  if (instancer.prototypes.size() != 2) {
+    return;
+  }
+
+  const InstancePrototype &tri = instancer.prototypes[0];
+  TEST_CHECK(tri.abs_path == "/instancer/protos/tri");
+  TEST_CHECK(tri.mesh_ids.size() == 1);
+  TEST_CHECK(tri.mesh_local_matrices.size() == 1);
+  if (tri.mesh_local_matrices.size() == 1) {
+    // xform of the prototype Prim is included.
+    TEST_CHECK(std::fabs(tri.mesh_local_matrices[0].m[3][1] - 1.0) < 1e-6);
+  }
+
+  // Instance 3 is invisible.
+  TEST_CHECK(tri.instance_indices.size() == 2);
+  TEST_CHECK(tri.instance_transforms.size() == 2);
+  if (tri.instance_transforms.size() == 2) {
+    TEST_CHECK(tri.instance_indices[0] == 0);
+    TEST_CHECK(tri.instance_indices[1] == 2);
+
+    const value::matrix4f &m0 = tri.instance_transforms[0];
+    TEST_CHECK(std::fabs(m0.m[0][0] - 1.0f) < 1e-6f);
+    TEST_CHECK(std::fabs(m0.m[3][0] - 1.0f) < 1e-6f);
+
+    // scale 2 and 90 degree rotation around Z(x axis -> y axis)
+    const value::matrix4f &m1 = tri.instance_transforms[1];
+    TEST_CHECK(std::fabs(m1.m[0][0]) < 1e-2f);
+    TEST_CHECK(std::fabs(m1.m[0][1] - 2.0f) < 1e-2f);
+    TEST_CHECK(std::fabs(m1.m[1][0] + 2.0f) < 1e-2f);
+    TEST_CHECK(std::fabs(m1.m[2][2] - 2.0f) < 1e-2f);
+    TEST_CHECK(std::fabs(m1.m[3][0] - 3.0f) < 1e-6f);
+    TEST_CHECK(std::fabs(m1.m[3][3] - 1.0f) < 1e-6f);
+  }
+
+  // Prototype without GeomMesh still keeps its instances.
+  const InstancePrototype &empty = instancer.prototypes[1];
+  TEST_CHECK(empty.mesh_ids.empty());
+  TEST_CHECK(empty.instance_indices.size() == 1);
+}
+
+void tydra_update_to_time_test(void) {
+  const char *usda = R"(#usda 1.0
+
+def Xform "root"
+{
+    double3 xformOp:translate.timeSamples = {
+        0: (0, 0, 0),
+        10: (10, 0, 0),
+    }
+    uniform token[] xformOpOrder = ["xformOp:translate"]
+
+    def Mesh "static_mesh"
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+    }
+
+    def Mesh "anim_mesh"
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points.timeSamples = {
+            0: [(0, 0, 0), (1, 0, 0), (0, 1, 0)],
+            10: [(0, 0, 0), (2, 0, 0), (0, 2, 0)],
+        }
+    }
+}
+
+def Xform "static_xform"
+{
+    double3 xformOp:translate = (0, 1, 0)
+    uniform token[] xformOpOrder = ["xformOp:translate"]
+}
+)";
+
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                strlen(usda), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return;
+  }
+
+  RenderSceneConverterEnv env(stage);
+  env.timecode = 0.0;
+  RenderSceneConverter converter;
+  RenderScene scene;
+
+  ret = converter.ConvertToRenderScene(env, &scene);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", converter.GetError().c_str());
+    return;
+  }
+
+  TEST_CHECK(converter.HasTimeVaryingContent());
+  TEST_CHECK(scene.meshes.size() == 2);
+  TEST_CHECK(scene.nodes.size() == 2);
+  if ((scene.meshes.size() != 2) || (scene.nodes.size() != 2)) {
+    return;
+  }
+
+  const std::vector<RenderMesh> static_meshes = scene.meshes;
+
+  RenderSceneDirtyList dirty;
+  ret = converter.UpdateToTime(env, 5.0, &scene, &dirty);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", converter.GetError().c_str());
+    return;
+  }
+
+  // "/root" and its children. "/static_xform" is not changed.
+  TEST_CHECK(dirty.nodes.size() == 3);
+  if (dirty.nodes.size() == 3) {
+    TEST_CHECK(dirty.nodes[0] == "/root");
+  }
+  TEST_CHECK(std::fabs(scene.nodes[0].global_matrix.m[3][0] - 5.0) < 1e-6);
+  TEST_CHECK(scene.nodes[0].children.size() == 2);
+  if (scene.nodes[0].children.size() == 2) {
+    TEST_CHECK(
+        std::fabs(scene.nodes[0].children[1].global_matrix.m[3][0] - 5.0) <
+        1e-6);
+  }
+  TEST_CHECK(std::fabs(scene.nodes[1].global_matrix.m[3][1] - 1.0) < 1e-6);
+
+  // Only the mesh with timesampled points is reconverted.
+  TEST_CHECK(dirty.meshes.size() == 1);
+  if (dirty.meshes.size() == 1) {
+    const RenderMesh &mesh = scene.meshes[size_t(dirty.meshes[0])];
+    TEST_CHECK(mesh.abs_path == "/root/anim_mesh");
+    TEST_CHECK(mesh.points.size() == 3);
+    if (mesh.points.size() == 3) {
+      TEST_CHECK(std::fabs(mesh.points[1][0] - 1.5f) < 1e-6f);
+    }
+  }
+
+  TEST_CHECK(dirty.instancers.empty());
+
+  // Same time again. Transforms are not changed.
+  ret = converter.UpdateToTime(env, 5.0, &scene, &dirty);
+  TEST_CHECK(ret);
+  TEST_CHECK(dirty.nodes.empty());
+
+  // Points are gathered with the topology cached in the previous update.
+  ret = converter.UpdateToTime(env, 10.0, &scene, &dirty);
+  TEST_CHECK(ret);
+  TEST_CHECK(dirty.meshes.size() == 1);
+  if (dirty.meshes.size() == 1) {
+    const RenderMesh &mesh = scene.meshes[size_t(dirty.meshes[0])];
+    TEST_CHECK(mesh.abs_path == "/root/anim_mesh");
+    TEST_CHECK(mesh.points.size() == 3);
+    if (mesh.points.size() == 3) {
+      TEST_CHECK(std::fabs(mesh.points[1][0] - 2.0f) < 1e-6f);
+    }
+  }
+
+  // `points` is held after the last timeSample. Not dirty.
+  ret = converter.UpdateToTime(env, 20.0, &scene, &dirty);
+  TEST_CHECK(ret);
+  TEST_CHECK(dirty.meshes.empty());
+}
+
+// SkelRoot with `n` skinned Meshes sharing one Skeleton/SkelAnimation.
+// timeSamples are written in unsorted order, and are read from all Mesh
+// conversions.
+static std::string MakeSkinnedMeshesUSDA(size_t n) {
+  std::stringstream ss;
+  ss << R"(#usda 1.0
+
+def SkelRoot "root"
+{
+    def Skeleton "Skel"
+    {
+        uniform token[] joints = ["root", "root/arm"]
+        uniform matrix4d[] bindTransforms = [( (1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (0, 0, 0, 1) ), ( (1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (1, 0, 0, 1) )]
+        uniform matrix4d[] restTransforms = [( (1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (0, 0, 0, 1) ), ( (1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (1, 0, 0, 1) )]
+        rel skel:animationSource = </root/Skel/Anim>
+
+        def SkelAnimation "Anim"
+        {
+            uniform token[] joints = ["root/arm"]
+            quatf[] rotations.timeSamples = {
+                2: [(0, 0, 0, 1)],
+                0: [(1, 0, 0, 0)],
+                1: [(0.70710677, 0, 0, 0.70710677)],
+            }
+            float3[] translations.timeSamples = {
+                1: [(1, 0, 0)],
+                0: [(1, 0, 0)],
+            }
+            half3[] scales = [(1, 1, 1)]
+            uniform token[] blendShapes = ["smile"]
+            float[] blendShapeWeights = [0.5]
+            float[] blendShapeWeights.timeSamples = {
+                2: [1],
+                0: [0],
+                1: [0.25],
+            }
+        }
+    }
+)";
+
+  for (size_t i = 0; i < n; i++) {
+    const std::string name = "mesh" + std::to_string(i);
+    const float x = float(i);
+    ss << "    def Mesh \"" << name << R"(" (
+        prepend apiSchemas = ["SkelBindingAPI"]
+    )
+    {
+        int[] faceVertexCounts = [3, 3]
+        int[] faceVertexIndices = [0, 1, 2, 0, 2, 3]
+        point3f[] points.timeSamples = {
+            2: [()" << x << R"(, 0, 0), (2, 0, 0), (2, 2, 0), (0, 2, 1)],
+            0: [()" << x << R"(, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)],
+            1: [()" << x << R"(, 0, 0), (1.5, 0, 0), (1.5, 1.5, 0), (0, 1.5, 0.5)],
+        }
+        int[] primvars:skel:jointIndices = [0, 1, 1, 0] (
+            elementSize = 1
+            interpolation = "vertex"
+        )
+        float[] primvars:skel:jointWeights = [1, 1, 1, 1] (
+            elementSize = 1
+            interpolation = "vertex"
+        )
+        uniform token[] skel:blendShapes = ["smile"]
+        rel skel:blendShapeTargets = </root/)" << name << R"(/smile>
+        rel skel:skeleton = </root/Skel>
+
+        def BlendShape "smile"
+        {
+            uniform vector3f[] offsets = [(0, 0, 1), (0, 0, )" << x << R"()]
+            uniform int[] pointIndices = [0, 2]
+        }
+    }
+)";
+  }
+
+  ss << "}\n";
+  return ss.str();
+}
+
+static bool ConvertUSDAToRenderScene(const std::string &usda, int num_threads,
+                                     double t, std::string *dump) {
+  // Load Stage for each conversion, so that lazily built data of timeSamples
+  // (e.g. AoS copy of samples) is built in the conversion.
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                                usda.size(), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return false;
+  }
+
+  RenderSceneConverterEnv env(stage);
+  env.timecode = t;
+  env.scene_config.num_threads = num_threads;
+  RenderSceneConverter converter;
+  RenderScene scene;
+
+  ret = converter.ConvertToRenderScene(env, &scene);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", converter.GetError().c_str());
+    return false;
+  }
+
+  (*dump) = DumpRenderScene(scene);
+  return true;
+}
+
+void tydra_parallel_mesh_conversion_test(void) {
+  const std::string usda = MakeSkinnedMeshesUSDA(32);
+
+  std::string serial;
+  if (!ConvertUSDAToRenderScene(usda, 1, 0.5, &serial)) {
+    return;
+  }
+  TEST_CHECK(serial.find("/root/mesh31") != std::string::npos);
+
+  // Run several times to catch the race in lazy evaluation.
+  for (int i = 0; i < 4; i++) {
+    for (int num_threads : {2, 4, 7}) {
+      std::string parallel;
+      if (!ConvertUSDAToRenderScene(usda, num_threads, 0.5, &parallel)) {
+        return;
+      }
+      TEST_CHECK(serial == parallel);
+      TEST_MSG("num_threads = %d", num_threads);
+    }
+  }
+}
+
+void tydra_compute_vertex_normals_test(void) {
+  // Cube with outward CCW quads. Point index = x | (y << 1) | (z << 2).
+  // Point 8 is not referenced by any face.
+  std::vector<value::float3> points;
+  for (int i = 0; i < 8; i++) {
+    points.push_back({(i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f,
+                      (i & 4) ? 1.0f : -1.0f});
+  }
+  points.push_back({0.0f, 0.0f, 0.0f});
+
+  std::vector<uint32_t> counts = {4, 4, 4, 4, 4, 4};
+  std::vector<uint32_t> indices = {4, 5, 7, 6, 0, 2, 3, 1, 1, 3, 7, 5,
+                                   0, 4, 6, 2, 2, 6, 7, 3, 0, 1, 5, 4};
+
+  {
+    std::vector<value::float3> normals;
+    std::string err;
+    TEST_CHECK(ComputeVertexNormals(points, counts, indices, &normals, &err));
+    TEST_CHECK(normals.size() == points.size());
+
+    const float k = 1.0f / std::sqrt(3.0f);
+    for (size_t i = 0; i < 8; i++) {
+      for (size_t c = 0; c < 3; c++) {
+        float expected = (points[i][c] > 0.0f) ? k : -k;
+        TEST_CHECK(std::fabs(normals[i][c] - expected) < 1.0e-6f);
+      }
+    }
+    TEST_CHECK(normals[8][0] == 0.0f);
+    TEST_CHECK(normals[8][1] == 0.0f);
+    TEST_CHECK(normals[8][2] == 0.0f);
+  }
+
+  // Invalid topology.
+  {
+    std::vector<value::float3> normals;
+    std::string err;
+    std::vector<uint32_t> bad_indices = indices;
+    bad_indices[5] = 9;
+    TEST_CHECK(
+        !ComputeVertexNormals(points, counts, bad_indices, &normals, &err));
+    TEST_CHECK(!err.empty());
+
+    err.clear();
+    std::vector<uint32_t> bad_counts = {4, 4, 4, 4, 4, 2, 2};
+    TEST_CHECK(
+        !ComputeVertexNormals(points, bad_counts, indices, &normals, &err));
+    TEST_CHECK(!err.empty());
+  }
+
+  // Large bumpy grid. Large enough to be processed with threads. The result
+  // must not depend on the number of threads and matches the scalar
+  // reference.
+  {
+    const size_t res = 200;
+    std::vector<value::float3> gpoints;
+    for (size_t y = 0; y <= res; y++) {
+      for (size_t x = 0; x <= res; x++) {
+        gpoints.push_back({float(x), float(y),
+                           std::sin(0.1f * float(x)) * std::cos(0.2f * float(y))});
+      }
+    }
+    std::vector<uint32_t> gcounts(res * res, 4);
+    std::vector<uint32_t> gindices;
+    for (size_t y = 0; y < res; y++) {
+      for (size_t x = 0; x < res; x++) {
+        uint32_t i0 = uint32_t(y * (res + 1) + x);
+        gindices.push_back(i0);
+        gindices.push_back(i0 + 1);
+        gindices.push_back(i0 + 1 + uint32_t(res + 1));
+        gindices.push_back(i0 + uint32_t(res + 1));
+      }
+    }
+
+    std::vector<value::float3> normals1;
+    std::vector<value::float3> normals4;
+    TEST_CHECK(
+        ComputeVertexNormals(gpoints, gcounts, gindices, &normals1, nullptr, 1));
+    TEST_CHECK(
+        ComputeVertexNormals(gpoints, gcounts, gindices, &normals4, nullptr, 4));
+    TEST_CHECK(normals1.size() == gpoints.size());
+    TEST_CHECK(normals1 == normals4);
+
+    std::vector<double> ref(gpoints.size() * 3, 0.0);
+    for (size_t f = 0; f < gcounts.size(); f++) {
+      const value::float3 &p0 = gpoints[gindices[4 * f + 0]];
+      const value::float3 &p1 = gpoints[gindices[4 * f + 1]];
+      const value::float3 &p2 = gpoints[gindices[4 * f + 2]];
+      double e1[3], e2[3];
+      for (size_t c = 0; c < 3; c++) {
+        e1[c] = double(p1[c]) - double(p0[c]);
+        e2[c] = double(p2[c]) - double(p0[c]);
+      }
+      double n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                     e1[2] * e2[0] - e1[0] * e2[2],
+                     e1[0] * e2[1] - e1[1] * e2[0]};
+      for (size_t v = 0; v < 4; v++) {
+        for (size_t c = 0; c < 3; c++) {
+          ref[3 * gindices[4 * f + v] + c] += n[c];
+        }
+      }
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < gpoints.size(); i++) {
+      double len = std::sqrt(ref[3 * i] * ref[3 * i] +
+                             ref[3 * i + 1] * ref[3 * i + 1] +
+                             ref[3 * i + 2] * ref[3 * i + 2]);
+      for (size_t c = 0; c < 3; c++) {
+        if (std::fabs(double(normals1[i][c]) - ref[3 * i + c] / len) > 1.0e-5) {
+          ok = false;
+        }
+      }
+    }
+    TEST_CHECK(ok);
+  }
+
+  // SoA normalize. Includes SIMD tail and zero vectors.
+  {
+    const size_t n = 11;
+    std::vector<float> x(n), y(n), z(n);
+    for (size_t i = 0; i < n; i++) {
+      x[i] = float(i) - 3.0f;
+      y[i] = 0.5f * float(i);
+      z[i] = (i % 3) ? 2.0f : -1.0f;
+    }
+    x[4] = y[4] = z[4] = 0.0f;
+    x[10] = y[10] = z[10] = 0.0f;
+
+    NormalizeVectors(x.data(), y.data(), z.data(), n);
+
+    for (size_t i = 0; i < n; i++) {
+      float len = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+      if ((i == 4) || (i == 10)) {
+        TEST_CHECK(len == 0.0f);
+      } else {
+        TEST_CHECK(std::fabs(len - 1.0f) < 1.0e-6f);
+      }
+    }
+    TEST_MSG("SIMD: %s", GetMeshUtilSIMDName());
+  }
+}
+
+void tydra_triangulate_test(void) {
+  // Convex quad whose shorter diagonal is (1, 3), concave quad(reflex vertex
+  // 5), convex hexagon and concave pentagon.
+  const char *usda = R"(#usda 1.0
+
+def Mesh "mesh"
+{
+    int[] faceVertexCounts = [4, 4, 6, 5]
+    int[] faceVertexIndices = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18]
+    point3f[] points = [(0, 0, 0), (4, 0, 0), (5, 1, 0), (1, 1, 0), (0, 3, 0), (2, 4, 0), (4, 3, 0), (2, 6, 0), (10, 0, 0), (12, 0, 0), (13, 1, 0), (12, 2, 0), (10, 2, 0), (9, 1, 0), (20, 0, 0), (24, 0, 0), (24, 4, 0), (22, 1, 0), (20, 4, 0)]
+}
+)";
+
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                strlen(usda), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return;
+  }
+
+  RenderSceneConverterEnv env(stage);
+  env.mesh_config.compute_normals = false;
+  env.mesh_config.build_vertex_indices = false;
+  RenderSceneConverter converter;
+  RenderScene scene;
+
+  ret = converter.ConvertToRenderScene(env, &scene);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", converter.GetError().c_str());
+    return;
+  }
+
+  TEST_CHECK(scene.meshes.size() == 1);
+  if (scene.meshes.size() != 1) {
+    return;
+  }
+
+  const RenderMesh &mesh = scene.meshes[0];
+  const std::vector<uint32_t> &indices = mesh.faceVertexIndices();
+
+  // 2 + 2 + 4 + 3 triangles
+  TEST_CHECK(mesh.faceVertexCounts().size() == 11);
+  TEST_CHECK(indices.size() == 33);
+  if (indices.size() != 33) {
+    return;
+  }
+
+  const std::vector<uint32_t> quads = {1, 2, 3, 1, 3, 0, 5, 6, 7, 5, 7, 4};
+  TEST_CHECK(std::equal(quads.begin(), quads.end(), indices.begin()));
+
+  // Triangles must cover each polygon without overlap, so the sum of
+  // unsigned triangle areas equals to the polygon area(4 + 4 + 6 + 10).
+  float area = 0.0f;
+  for (size_t t = 0; t < 11; t++) {
+    const value::float3 &p0 = mesh.points[indices[3 * t + 0]];
+    const value::float3 &p1 = mesh.points[indices[3 * t + 1]];
+    const value::float3 &p2 = mesh.points[indices[3 * t + 2]];
+    area += 0.5f * std::fabs((p1[0] - p0[0]) * (p2[1] - p0[1]) -
+                             (p1[1] - p0[1]) * (p2[0] - p0[0]));
+  }
+  TEST_CHECK(std::fabs(area - 24.0f) < 1.0e-4f);
+  TEST_MSG("area = %f", double(area));
+}
+
+static bool NearlyEqual(const value::float3 &a, const value::float3 &b,
+                        const float eps = 1.0e-4f) {
+  return (std::fabs(a[0] - b[0]) < eps) && (std::fabs(a[1] - b[1]) < eps) &&
+         (std::fabs(a[2] - b[2]) < eps);
+}
+
+void tydra_skinning_test(void) {
+  // root(identity) - arm(translate(1, 0, 0)). `arm` rotates 90 degree around
+  // Z axis from t = 0 to t = 1.
+  SkelHierarchy skel;
+  skel.abs_path = "/skel";
+  skel.root_node.joint_path = "root";
+  skel.root_node.joint_id = 0;
+
+  SkelNode arm;
+  arm.joint_path = "root/arm";
+  arm.joint_id = 1;
+  arm.bind_transform.m[3][0] = 1.0;
+  arm.rest_transform.m[3][0] = 1.0;
+  skel.root_node.children.push_back(arm);
+
+  Animation anim;
+  {
+    const float s = std::sqrt(0.5f);
+    AnimationChannel rot(AnimationChannel::ChannelType::Rotation);
+    rot.rotations.samples.push_back({0.0f, {0.0f, 0.0f, 0.0f, 1.0f}});
+    rot.rotations.samples.push_back({1.0f, {0.0f, 0.0f, s, s}});
+    AnimationChannel trans(AnimationChannel::ChannelType::Translation);
+    trans.translations.static_value = value::float3{1.0f, 0.0f, 0.0f};
+    anim.channels_map["root/arm"].emplace(rot.type, rot);
+    anim.channels_map["root/arm"].emplace(trans.type, trans);
+
+    AnimationSampler<float> weights;
+    weights.samples.push_back({0.0f, 0.75f});
+    weights.samples.push_back({1.0f, 0.25f});
+    anim.blendshape_weights_map["smile"] = weights;
+  }
+
+  RenderMesh mesh;
+  mesh.abs_path = "/mesh";
+  mesh.points = {{0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {1.5f, 0.0f, 0.0f}};
+  mesh.usdFaceVertexCounts = {3};
+  mesh.usdFaceVertexIndices = {0, 1, 2};
+  mesh.skel_id = 0;
+  mesh.joint_and_weights.elementSize = 2;
+  mesh.joint_and_weights.jointIndices = {0, 0, 1, 0, 0, 1};
+  mesh.joint_and_weights.jointWeights = {1.0f, 0.0f, 1.0f, 0.0f, 0.5f, 0.5f};
+
+  const std::vector<value::float3> normals(3, {1.0f, 0.0f, 0.0f});
+  mesh.normals.format = VertexAttributeFormat::Vec3;
+  mesh.normals.variability = VertexVariability::Vertex;
+  mesh.normals.set_buffer(reinterpret_cast<const uint8_t *>(normals.data()),
+                          sizeof(value::float3) * normals.size());
+
+  {
+    // offset (0, 0, 1) at weight 1 and (0, 0, 2) at weight 0.5
+    ShapeTarget target;
+    target.pointIndices = {0};
+    target.pointOffsets = {{0.0f, 0.0f, 1.0f}};
+    InbetweenShapeTarget inbetween;
+    inbetween.pointOffsets = {{0.0f, 0.0f, 2.0f}};
+    inbetween.weight = 0.5f;
+    target.inbetweens[0.5f] = inbetween;
+    mesh.targets["smile"] = target;
+  }
+
+  RenderScene scene;
+  scene.meshes.push_back(mesh);
+  scene.skeletons.push_back(skel);
+  scene.animations.push_back(anim);
+  scene.skeletons[0].anim_id = 0;
+
+  std::string err;
+  SkinningConfig config;
+  DeformedMesh deformed;
+
+  // Rest pose
+  bool ret = DeformRenderMesh(scene, 0, 0.0, config, &deformed, &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+  if (!ret || (deformed.points.size() != 3) || (deformed.normals.size() != 3)) {
+    return;
+  }
+  TEST_CHECK(NearlyEqual(deformed.points[0], {0.0f, 0.0f, 1.5f}));
+  TEST_CHECK(NearlyEqual(deformed.points[1], {2.0f, 0.0f, 0.0f}));
+  TEST_CHECK(NearlyEqual(deformed.points[2], {1.5f, 0.0f, 0.0f}));
+
+  // LBS
+  ret = DeformRenderMesh(scene, 0, 1.0, config, &deformed, &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+  TEST_CHECK(NearlyEqual(deformed.points[0], {0.0f, 0.0f, 1.0f}));
+  TEST_CHECK(NearlyEqual(deformed.points[1], {1.0f, 1.0f, 0.0f}));
+  TEST_MSG("p1 = %f, %f, %f", double(deformed.points[1][0]),
+           double(deformed.points[1][1]), double(deformed.points[1][2]));
+  TEST_CHECK(NearlyEqual(deformed.points[2], {1.25f, 0.25f, 0.0f}));
+  TEST_CHECK(NearlyEqual(deformed.normals[1], {0.0f, 1.0f, 0.0f}));
+
+  // DQS
+  config.method = SkinningMethod::DualQuaternion;
+  ret = DeformRenderMesh(scene, 0, 1.0, config, &deformed, &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+  const float h = std::sqrt(0.125f);
+  TEST_CHECK(NearlyEqual(deformed.points[1], {1.0f, 1.0f, 0.0f}));
+  TEST_CHECK(NearlyEqual(deformed.points[2], {1.0f + h, h, 0.0f}));
+  TEST_MSG("p2 = %f, %f, %f", double(deformed.points[2][0]),
+           double(deformed.points[2][1]), double(deformed.points[2][2]));
+  TEST_CHECK(NearlyEqual(deformed.normals[1], {0.0f, 1.0f, 0.0f}));
+
+  // Result must not depend on the number of threads.
+  {
+    RenderMesh &grid = scene.meshes[0];
+    const size_t n = 50000;
+    grid.points.resize(n);
+    grid.joint_and_weights.jointIndices.resize(2 * n);
+    grid.joint_and_weights.jointWeights.resize(2 * n);
+    for (size_t i = 0; i < n; i++) {
+      const float x = 2.0f * float(i) / float(n);
+      grid.points[i] = {x, float(i % 7), 0.0f};
+      grid.joint_and_weights.jointIndices[2 * i + 0] = 0;
+      grid.joint_and_weights.jointIndices[2 * i + 1] = 1;
+      grid.joint_and_weights.jointWeights[2 * i + 0] = 1.0f - 0.5f * x;
+      grid.joint_and_weights.jointWeights[2 * i + 1] = 0.5f * x;
+    }
+    const std::vector<value::float3> grid_normals(n, {0.0f, 0.0f, 1.0f});
+    grid.normals.set_buffer(
+        reinterpret_cast<const uint8_t *>(grid_normals.data()),
+        sizeof(value::float3) * grid_normals.size());
+
+    // Overlapping BlendShapes. Summation order of offsets must not depend on
+    // the number of threads.
+    for (size_t k = 0; k < 5; k++) {
+      ShapeTarget target;
+      InbetweenShapeTarget inbetween;
+      inbetween.weight = 0.5f;
+      for (size_t i = k; i < n; i += (k + 2)) {
+        const float o = 0.1f * float(k + 1) + 1.0e-4f * float(i % 101);
+        target.pointIndices.push_back(uint32_t(i));
+        target.pointOffsets.push_back({o, -o, 0.3f * o});
+        target.normalOffsets.push_back({0.5f * o, 0.0f, 0.0f});
+        inbetween.pointOffsets.push_back({-o, 0.7f * o, o});
+        inbetween.normalOffsets.push_back({0.0f, o, 0.0f});
+      }
+      target.inbetweens[0.5f] = inbetween;
+      const std::string name = "shape" + std::to_string(k);
+      grid.targets[name] = target;
+
+      AnimationSampler<float> weights;
+      weights.samples.push_back({0.0f, 0.1f * float(k + 1)});
+      weights.samples.push_back({1.0f, 1.0f - 0.15f * float(k)});
+      scene.animations[0].blendshape_weights_map[name] = weights;
+    }
+
+    config.method = SkinningMethod::LinearBlend;
+    config.num_threads = 1;
+    DeformedMesh single;
+    TEST_CHECK(DeformRenderMesh(scene, 0, 0.5, config, &single, &err));
+
+    config.num_threads = 4;
+    DeformedMesh multi;
+    TEST_CHECK(DeformRenderMesh(scene, 0, 0.5, config, &multi, &err));
+
+    TEST_CHECK(single.points.size() == n);
+    TEST_CHECK(single.points == multi.points);
+    TEST_CHECK(single.normals.size() == n);
+    TEST_CHECK(single.normals == multi.normals);
+
+    // BlendShapes are applied.
+    config.apply_blendshapes = false;
+    DeformedMesh no_blendshapes;
+    TEST_CHECK(
+        DeformRenderMesh(scene, 0, 0.5, config, &no_blendshapes, &err));
+    TEST_CHECK(no_blendshapes.points.size() == n);
+    if (no_blendshapes.points.size() == n) {
+      TEST_CHECK(!NearlyEqual(single.points[2], no_blendshapes.points[2]));
+      TEST_CHECK(!NearlyEqual(single.normals[2], no_blendshapes.normals[2]));
+    }
+  }
+}
+
+void tydra_blendshape_inbetween_test(void) {
+  // Inbetween offsets are `2 * x` of the point, so that they can be checked
+  // after the points are reordered.
+  const char *usda = R"(#usda 1.0
+
+def Mesh "mesh" (
+    prepend apiSchemas = ["SkelBindingAPI"]
+)
+{
+    int[] faceVertexCounts = [3, 3]
+    int[] faceVertexIndices = [0, 1, 2, 0, 2, 3]
+    point3f[] points = [(0, 0, 0), (1, 0, 0), (2, 1, 0), (3, 1, 0)]
+    uniform token[] skel:blendShapes = ["smile"]
+    rel skel:blendShapeTargets = </mesh/smile>
+
+    def BlendShape "smile"
+    {
+        uniform vector3f[] offsets = [(0, 0, 1), (0, 0, 1)]
+        uniform int[] pointIndices = [1, 3]
+        uniform vector3f[] inbetweens:half = [(0, 0, 2), (0, 0, 6)] (
+            weight = 0.5
+        )
+        uniform vector3f[] inbetweens:half:normalOffsets = [(0, 1, 0), (0, 1, 0)]
+        uniform vector3f[] inbetweens:noweight = [(0, 0, 1), (0, 0, 1)]
+    }
+}
+)";
+
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                strlen(usda), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return;
+  }
+
+  RenderSceneConverterEnv env(stage);
+  RenderSceneConverter converter;
+  RenderScene scene;
+
+  ret = converter.ConvertToRenderScene(env, &scene);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", converter.GetError().c_str());
+    return;
+  }
+
+  TEST_CHECK(scene.meshes.size() == 1);
+  if (scene.meshes.size() != 1) {
+    return;
+  }
+  const RenderMesh &mesh = scene.meshes[0];
+
+  TEST_CHECK(mesh.targets.count("smile") == 1);
+  if (!mesh.targets.count("smile")) {
+    return;
+  }
+  const ShapeTarget &target = mesh.targets.at("smile");
+
+  // `inbetweens:noweight` is skipped.
+  TEST_CHECK(target.inbetweens.size() == 1);
+  TEST_CHECK(target.inbetweens.count(0.5f) == 1);
+  if (!target.inbetweens.count(0.5f)) {
+    return;
+  }
+
+  const InbetweenShapeTarget &inbetween = target.inbetweens.at(0.5f);
+  TEST_CHECK(inbetween.pointOffsets.size() == target.pointIndices.size());
+  TEST_CHECK(inbetween.normalOffsets.size() == target.pointIndices.size());
+  if (inbetween.pointOffsets.size() != target.pointIndices.size()) {
+    return;
+  }
+
+  for (size_t k = 0; k < target.pointIndices.size(); k++) {
+    const value::float3 &p = mesh.points[target.pointIndices[k]];
+    TEST_CHECK(std::fabs(inbetween.pointOffsets[k][2] - 2.0f * p[0]) < 1e-6f);
+    TEST_MSG("k = %d", int(k));
+  }
+}
+
+static void CompareXformNode(const XformNode &a, const XformNode &b) {
+  TEST_CHECK(a.absolute_path.full_path_name() ==
+             b.absolute_path.full_path_name());
+  TEST_CHECK(a.has_xform() == b.has_xform());
+  TEST_CHECK(is_close(a.get_local_matrix(), b.get_local_matrix(), 1.0e-9));
+  TEST_CHECK(is_close(a.get_world_matrix(), b.get_world_matrix(), 1.0e-9));
+  TEST_MSG("%s", a.absolute_path.full_path_name().c_str());
+  TEST_CHECK(a.children.size() == b.children.size());
+  for (size_t i = 0; i < (std::min)(a.children.size(), b.children.size());
+       i++) {
+    CompareXformNode(a.children[i], b.children[i]);
+  }
+}
+
+void tydra_xform_cache_test(void) {
+  const char *usda = R"(#usda 1.0
+
+def Xform "root"
+{
+    double3 xformOp:translate = (1, 0, 0)
+    uniform token[] xformOpOrder = ["xformOp:translate"]
+
+    def Xform "anim"
+    {
+        double3 xformOp:translate.timeSamples = { 0: (0, 0, 0), 1: (0, 2, 0), 2: (0, 2, 0) }
+        uniform token[] xformOpOrder = ["xformOp:translate"]
+
+        def Scope "scope"
+        {
+            def Xform "child"
+            {
+                double3 xformOp:translate = (0, 0, 3)
+                uniform token[] xformOpOrder = ["xformOp:translate"]
+            }
+        }
+
+        def Xform "reset"
+        {
+            double3 xformOp:translate = (5, 0, 0)
+            uniform token[] xformOpOrder = ["!resetXformStack!", "xformOp:translate"]
+        }
+    }
+
+    def Xform "static"
+    {
+        double3 xformOp:translate = (0, 4, 0)
+        uniform token[] xformOpOrder = ["xformOp:translate"]
+    }
+}
+)";
+
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                strlen(usda), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return;
+  }
+
+  XformCache cache;
+  ret = cache.Build(stage, 0.0, value::TimeSampleInterpolationType::Linear,
+                    &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+
+  // anim, anim/scope, anim/scope/child
+  TEST_CHECK(cache.GetNumTimeVaryingPrims() == 3);
+  TEST_CHECK(cache.IsTimeVarying("/root/anim/scope/child"));
+  TEST_CHECK(!cache.IsTimeVarying("/root/anim/reset"));
+  TEST_CHECK(!cache.IsTimeVarying("/root/static"));
+  TEST_CHECK(!cache.IsTimeVarying("/root"));
+
+  ret = cache.SetTime(1.0, value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+
+  const std::vector<std::string> &updated = cache.GetUpdatedPaths();
+  TEST_CHECK(updated.size() == 3);
+  if (updated.size() == 3) {
+    TEST_CHECK(updated[0] == "/root/anim");
+    TEST_CHECK(updated[1] == "/root/anim/scope");
+    TEST_CHECK(updated[2] == "/root/anim/scope/child");
+  }
+
+  value::matrix4d m;
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/scope/child", &m));
+  TEST_CHECK(m.m[3][0] == 1.0);
+  TEST_CHECK(m.m[3][1] == 2.0);
+  TEST_CHECK(m.m[3][2] == 3.0);
+
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/reset", &m));
+  TEST_CHECK(m.m[3][0] == 5.0);
+  TEST_CHECK(m.m[3][1] == 0.0);
+
+  TEST_CHECK(!cache.GetWorldMatrix("/nonexist", &m));
+
+  // Same matrices as BuildXformNodeFromStage.
+  {
+    XformNode expected;
+    TEST_CHECK(BuildXformNodeFromStage(stage, &expected, 1.0));
+
+    XformNode node;
+    TEST_CHECK(cache.BuildXformNode(&node));
+    CompareXformNode(node, expected);
+  }
+
+  // Held value. Nothing to update.
+  ret = cache.SetTime(2.0, value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_CHECK(cache.GetUpdatedPaths().empty());
+
+  ret = cache.SetTime(0.5, value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_CHECK(cache.GetUpdatedPaths().size() == 3);
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/scope/child", &m));
+  TEST_CHECK(m.m[3][1] == 1.0);
+
+  // Local matrices at t = 0, 1, 2, 0.5 are cached.
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 4);
+
+  // Revisit the cached timecode.
+  ret = cache.SetTime(1.0, value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_CHECK(cache.GetUpdatedPaths().size() == 3);
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 4);
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/scope/child", &m));
+  TEST_CHECK(m.m[3][1] == 2.0);
+  {
+    XformNode expected;
+    TEST_CHECK(BuildXformNodeFromStage(stage, &expected, 1.0));
+
+    XformNode node;
+    TEST_CHECK(cache.BuildXformNode(&node));
+    CompareXformNode(node, expected);
+  }
+
+  // The oldest timecodes are evicted.
+  cache.SetMaxCachedTimeCodes(2);
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 2);
+  ret = cache.SetTime(0.25, value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 2);
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/scope/child", &m));
+  TEST_CHECK(m.m[3][1] == 0.5);
+
+  // Cached matrices are discarded when the interpolation type is changed.
+  ret = cache.SetTime(0.5, value::TimeSampleInterpolationType::Held, &err);
+  TEST_CHECK(ret);
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 1);
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/scope/child", &m));
+  TEST_CHECK(m.m[3][1] == 0.0);
+
+  cache.SetMaxCachedTimeCodes(0);
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 0);
+  ret = cache.SetTime(1.0, value::TimeSampleInterpolationType::Held, &err);
+  TEST_CHECK(ret);
+  TEST_CHECK(cache.GetNumCachedTimeCodes() == 0);
+  TEST_CHECK(cache.GetWorldMatrix("/root/anim/scope/child", &m));
+  TEST_CHECK(m.m[3][1] == 2.0);
+}
+
+static bool IsSameBound(const AABB &b, const value::double3 &lower,
+                        const value::double3 &upper) {
+  for (size_t i = 0; i < 3; i++) {
+    if ((std::fabs(b.lower[i] - lower[i]) > 1.0e-6) ||
+        (std::fabs(b.upper[i] - upper[i]) > 1.0e-6)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void tydra_bbox_cache_test(void) {
+  // SIMD min/max reduction
+  {
+    std::vector<value::float3> points;
+    for (size_t i = 0; i < 37; i++) {
+      const float v = float((i * 7) % 37) - 18.0f;
+      points.push_back({v, -2.0f * v, 0.5f * v});
+    }
+    value::float3 lower, upper;
+    ComputePointsBounds(points.data(), points.size(), &lower, &upper);
+    TEST_CHECK(lower[0] == -18.0f);
+    TEST_CHECK(upper[0] == 18.0f);
+    TEST_CHECK(lower[1] == -36.0f);
+    TEST_CHECK(upper[1] == 36.0f);
+    TEST_CHECK(lower[2] == -9.0f);
+    TEST_CHECK(upper[2] == 9.0f);
+  }
+
+  const char *usda = R"(#usda 1.0
+
+def Xform "World"
+{
+    def Cube "cube"
+    {
+        double size = 2
+        double3 xformOp:translate = (10, 0, 0)
+        uniform token[] xformOpOrder = ["xformOp:translate"]
+    }
+
+    def Mesh "mesh"
+    {
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points.timeSamples = {
+            0: [(0, 0, 0), (1, 0, 0), (1, 1, 1)],
+            1: [(0, 0, 0), (2, 0, 0), (2, 2, 2)],
+        }
+    }
+
+    def Mesh "extent"
+    {
+        float3[] extent = [(-5, -5, -5), (5, 5, 5)]
+        int[] faceVertexCounts = [3]
+        int[] faceVertexIndices = [0, 1, 2]
+        point3f[] points = [(0, 0, 0), (1, 0, 0), (0, 1, 0)]
+    }
+
+    def Sphere "hidden"
+    {
+        double radius = 100
+        token visibility = "invisible"
+    }
+
+    def Sphere "guide"
+    {
+        double radius = 50
+        uniform token purpose = "guide"
+    }
+
+    def Xform "anim"
+    {
+        double3 xformOp:translate.timeSamples = { 0: (0, 0, 0), 1: (0, 10, 0) }
+        uniform token[] xformOpOrder = ["xformOp:translate"]
+
+        def Sphere "sphere"
+        {
+            double radius = 1
+        }
+    }
+
+    def PointInstancer "instancer"
+    {
+        rel prototypes = [</World/instancer/Protos/box>]
+        int[] protoIndices = [0, 0]
+        point3f[] positions = [(0, 0, -20), (0, 0, 20)]
+
+        def Scope "Protos"
+        {
+            def Cube "box"
+            {
+                double size = 2
+                double3 xformOp:translate = (0, 0, 1)
+                uniform token[] xformOpOrder = ["xformOp:translate"]
+            }
+        }
+    }
+}
+)";
+
+  Stage stage;
+  std::string warn, err;
+  bool ret = LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                strlen(usda), "", &stage, &warn, &err);
+  TEST_CHECK(ret);
+  if (!ret) {
+    TEST_MSG("%s", err.c_str());
+    return;
+  }
+
+  BBoxCache cache;
+  BBoxCacheConfig config;
+  ret = cache.Build(stage, config, 0.0,
+                    value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+  if (!ret) {
+    return;
+  }
+
+  AABB b;
+  TEST_CHECK(cache.ComputeWorldBound("/World/cube", &b));
+  TEST_CHECK(IsSameBound(b, {9.0, -1.0, -1.0}, {11.0, 1.0, 1.0}));
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/mesh", &b));
+  TEST_CHECK(IsSameBound(b, {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}));
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/extent", &b));
+  TEST_CHECK(IsSameBound(b, {-5.0, -5.0, -5.0}, {5.0, 5.0, 5.0}));
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/hidden", &b));
+  TEST_CHECK(b.is_empty());
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/guide", &b));
+  TEST_CHECK(b.is_empty());
+
+  // Prototype itself is not counted.
+  TEST_CHECK(cache.ComputeWorldBound("/World/instancer/Protos", &b));
+  TEST_CHECK(b.is_empty());
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/instancer", &b));
+  TEST_CHECK(IsSameBound(b, {-1.0, -1.0, -20.0}, {1.0, 1.0, 22.0}));
+  TEST_MSG("instancer: (%f, %f, %f) - (%f, %f, %f)", b.lower[0], b.lower[1],
+           b.lower[2], b.upper[0], b.upper[1], b.upper[2]);
+
+  TEST_CHECK(IsSameBound(cache.GetStageBound(), {-5.0, -5.0, -20.0},
+                         {11.0, 5.0, 22.0}));
+
+  TEST_CHECK(!cache.ComputeWorldBound("/nonexist", &b));
+
+  ret = cache.SetTime(1.0, value::TimeSampleInterpolationType::Linear, &err);
+  TEST_CHECK(ret);
+  TEST_MSG("%s", err.c_str());
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/mesh", &b));
+  TEST_CHECK(IsSameBound(b, {0.0, 0.0, 0.0}, {2.0, 2.0, 2.0}));
+
+  TEST_CHECK(cache.ComputeWorldBound("/World/anim", &b));
+  TEST_CHECK(IsSameBound(b, {-1.0, 9.0, -1.0}, {1.0, 11.0, 1.0}));
+
+  TEST_CHECK(IsSameBound(cache.GetStageBound(), {-5.0, -5.0, -20.0},
+                         {11.0, 11.0, 22.0}));
+
+  // Same result as Build at t = 1.
+  {
+    BBoxCache cache1;
+    TEST_CHECK(cache1.Build(stage, config, 1.0,
+                            value::TimeSampleInterpolationType::Linear, &err));
+    const AABB &s0 = cache.GetStageBound();
+    const AABB &s1 = cache1.GetStageBound();
+    TEST_CHECK(IsSameBound(s1, s0.lower, s0.upper));
+  }
+
+  // Result must not depend on the number of threads. Use enough Prims to
+  // split the work among threads, and timeSamples written in unsorted order.
+  {
+    const size_t num_prims = 512;
+    TEST_CHECK(thread::GetNumThreads(4) == (thread::IsThreadingEnabled() ? 4 : 1));
+
+    std::stringstream ss;
+    ss << "#usda 1.0\n\ndef Xform \"World\"\n{\n";
+    for (size_t i = 0; i < num_prims; i++) {
+      const float x = float(i);
+      ss << "    def Xform \"xform" << i << R"(" {
+        double3 xformOp:translate.timeSamples = {
+            1: ()" << x << R"(, 1, 0),
+            0: ()" << x << R"(, 0, 0),
+        }
+        uniform token[] xformOpOrder = ["xformOp:translate"]
+
+        def Mesh "mesh" {
+            int[] faceVertexCounts = [3]
+            int[] faceVertexIndices = [0, 1, 2]
+            point3f[] points.timeSamples = {
+                2: [(0, 0, 0), (3, 0, 0), (3, 3, )" << x << R"()],
+                0: [(0, 0, 0), (1, 0, 0), (1, 1, 0)],
+                1: [(0, 0, 0), (2, 0, 0), (2, 2, 1)],
+            }
+        }
+    }
+)";
+    }
+    ss << "}\n";
+    const std::string grid_usda = ss.str();
+
+    std::vector<AABB> bounds[2];
+    for (size_t k = 0; k < 2; k++) {
+      // Load Stage for each Build, since timeSamples are sorted at the first
+      // access.
+      Stage grid_stage;
+      ret = LoadUSDAFromMemory(
+          reinterpret_cast<const uint8_t *>(grid_usda.data()), grid_usda.size(),
+          "", &grid_stage, &warn, &err);
+      TEST_CHECK(ret);
+      if (!ret) {
+        TEST_MSG("%s", err.c_str());
+        return;
+      }
+
+      BBoxCache grid_cache;
+      BBoxCacheConfig grid_config;
+      grid_config.num_threads = (k == 0) ? 1 : 4;
+      TEST_CHECK(grid_cache.Build(grid_stage, grid_config, 1.5,
+                                  value::TimeSampleInterpolationType::Linear,
+                                  &err));
+      TEST_MSG("%s", err.c_str());
+
+      for (size_t i = 0; i < num_prims; i++) {
+        AABB mb;
+        TEST_CHECK(grid_cache.ComputeWorldBound(
+            "/World/xform" + std::to_string(i) + "/mesh", &mb));
+        bounds[k].push_back(mb);
+      }
+    }
+
+    TEST_CHECK(bounds[0].size() == num_prims);
+    TEST_CHECK(bounds[1].size() == num_prims);
+    for (size_t i = 0; i < (std::min)(bounds[0].size(), bounds[1].size());
+         i++) {
+      TEST_CHECK(IsSameBound(bounds[1][i], bounds[0][i].lower,
+                             bounds[0][i].upper));
+      TEST_MSG("prim %d", int(i));
+    }
+    if (bounds[0].size() == num_prims) {
+      const double x = double(num_prims - 1);
+      TEST_CHECK(IsSameBound(bounds[0].back(), {x, 1.0, 0.0},
+                             {x + 2.5, 3.5, 0.5 * (1.0 + x)}));
+    }
+  }
+}
+
+// (n + 1) x (n + 1) grid on XY plane with two triangles per cell.
+static void MakeGrid(const size_t n, std::vector<value::float3> *points,
+                     std::vector<uint32_t> *indices) {
+  points->clear();
+  indices->clear();
+  for (size_t y = 0; y <= n; y++) {
+    for (size_t x = 0; x <= n; x++) {
+      points->push_back({float(x), float(y), 0.0f});
+    }
+  }
+  for (size_t y = 0; y < n; y++) {
+    for (size_t x = 0; x < n; x++) {
+      const uint32_t v0 = uint32_t(y * (n + 1) + x);
+      const uint32_t v1 = v0 + 1;
+      const uint32_t v2 = v0 + uint32_t(n + 1);
+      const uint32_t v3 = v2 + 1;
+      indices->insert(indices->end(), {v0, v1, v3, v0, v3, v2});
+    }
+  }
+}
+
+static bool IsReferenced(const std::vector<uint32_t> &indices, uint32_t v) {
+  return std::find(indices.begin(), indices.end(), v) != indices.end();
+}
+
+void tydra_mesh_lod_test(void) {
+  const size_t n = 16;
+
+  // Flat grid: interior vertices are removed with zero error, border
+  // vertices are kept.
+  {
+    std::vector<value::float3> points;
+    std::vector<uint32_t> indices;
+    MakeGrid(n, &points, &indices);
+    const size_t num_faces = indices.size() / 3;
+
+    std::vector<SimplifiedMesh> lods;
+    std::string err;
+    bool ret = SimplifyTriangleMesh(points, indices, {},
+                                    {num_faces / 2, num_faces / 8}, 1.0e-4f,
+                                    &lods, &err);
+    TEST_CHECK(ret);
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(lods.size() == 2);
+    if (lods.size() != 2) {
+      return;
+    }
+
+    TEST_CHECK(lods[0].indices.size() / 3 <= num_faces / 2);
+    TEST_CHECK(lods[1].indices.size() / 3 <= num_faces / 8);
+    TEST_CHECK(lods[1].indices.size() < lods[0].indices.size());
+    TEST_CHECK(lods[1].error < 1.0e-4f);
+    TEST_CHECK(lods[0].face_remap.size() * 3 == lods[0].indices.size());
+
+    float area = 0.0f;
+    for (size_t t = 0; t < lods[1].indices.size() / 3; t++) {
+      const value::float3 &p0 = points[lods[1].indices[3 * t + 0]];
+      const value::float3 &p1 = points[lods[1].indices[3 * t + 1]];
+      const value::float3 &p2 = points[lods[1].indices[3 * t + 2]];
+      const float cz = (p1[0] - p0[0]) * (p2[1] - p0[1]) -
+                       (p1[1] - p0[1]) * (p2[0] - p0[0]);
+      // No fold-over
+      TEST_CHECK(cz > 0.0f);
+      area += 0.5f * cz;
+    }
+    TEST_CHECK(std::fabs(area - float(n * n)) < 1.0e-3f);
+    TEST_MSG("area = %f", double(area));
+
+    for (uint32_t v = 0; v < points.size(); v++) {
+      const size_t x = v % (n + 1);
+      const size_t y = v / (n + 1);
+      if ((x == 0) || (y == 0) || (x == n) || (y == n)) {
+        TEST_CHECK(IsReferenced(lods[1].indices, v));
+      }
+    }
+  }
+
+  // Face groups and seams(duplicated vertices) are kept.
+  {
+    std::vector<value::float3> points;
+    std::vector<uint32_t> indices;
+    MakeGrid(n, &points, &indices);
+    const size_t num_faces = indices.size() / 3;
+
+    // Left half = group 0, right half = group 1.
+    std::vector<uint32_t> face_groups(num_faces);
+    for (size_t f = 0; f < num_faces; f++) {
+      face_groups[f] = ((f / 2) % n) < (n / 2) ? 0 : 1;
+    }
+
+    // Split the row y = n / 2 for the upper half(e.g. UV seam).
+    std::vector<uint32_t> seam_vertices;
+    for (size_t x = 0; x <= n; x++) {
+      const uint32_t v = uint32_t((n / 2) * (n + 1) + x);
+      const uint32_t dup = uint32_t(points.size());
+      points.push_back(points[v]);
+      seam_vertices.push_back(v);
+      seam_vertices.push_back(dup);
+      for (size_t f = (n / 2) * n * 2; f < num_faces; f++) {
+        for (size_t k = 0; k < 3; k++) {
+          if (indices[3 * f + k] == v) {
+            indices[3 * f + k] = dup;
+          }
+        }
+      }
+    }
+
+    std::vector<SimplifiedMesh> lods;
+    std::string err;
+    bool ret = SimplifyTriangleMesh(points, indices, face_groups, {0},
+                                    1.0e-4f, &lods, &err);
+    TEST_CHECK(ret);
+    TEST_MSG("%s", err.c_str());
+    if (lods.size() != 1) {
+      return;
+    }
+
+    TEST_CHECK(lods[0].indices.size() < indices.size());
+    for (size_t y = 0; y <= n; y++) {
+      TEST_CHECK(IsReferenced(lods[0].indices, uint32_t(y * (n + 1) + n / 2)));
+    }
+    for (uint32_t v : seam_vertices) {
+      TEST_CHECK(IsReferenced(lods[0].indices, v));
+    }
+    for (size_t t = 0; t < lods[0].face_remap.size(); t++) {
+      const uint32_t src = lods[0].face_remap[t];
+      for (size_t k = 0; k < 3; k++) {
+        const value::float3 &p = points[lods[0].indices[3 * t + k]];
+        if (face_groups[src] == 0) {
+          TEST_CHECK(p[0] <= float(n / 2));
+        } else {
+          TEST_CHECK(p[0] >= float(n / 2));
+        }
+      }
+    }
+  }
+
+  // Curved surface is not simplified beyond `max_error`.
+  {
+    std::vector<value::float3> points;
+    std::vector<uint32_t> indices;
+    MakeGrid(n, &points, &indices);
+    for (auto &p : points) {
+      p[2] = 0.1f * (p[0] * p[0] + p[1] * p[1]);
+    }
+
+    std::vector<SimplifiedMesh> lods;
+    TEST_CHECK(
+        SimplifyTriangleMesh(points, indices, {}, {0}, 0.0f, &lods, nullptr));
+    TEST_CHECK(lods.size() == 1);
+    if (lods.size() == 1) {
+      TEST_CHECK(lods[0].indices.size() == indices.size());
+    }
+
+    TEST_CHECK(
+        SimplifyTriangleMesh(points, indices, {}, {0}, 0.5f, &lods, nullptr));
+    if (lods.size() == 1) {
+      TEST_CHECK(lods[0].indices.size() < indices.size());
+      TEST_CHECK(lods[0].error <= 0.5f);
+    }
+  }
+
+  // LODs in RenderMesh
+  {
+    std::vector<value::float3> points;
+    std::vector<uint32_t> indices;
+    MakeGrid(n, &points, &indices);
+
+    std::stringstream ss;
+    ss << "#usda 1.0\n\ndef Mesh \"grid\"\n{\n";
+    ss << "    int[] faceVertexCounts = [";
+    for (size_t f = 0; f < indices.size() / 3; f++) {
+      ss << (f ? ", " : "") << "3";
+    }
+    ss << "]\n    int[] faceVertexIndices = [";
+    for (size_t i = 0; i < indices.size(); i++) {
+      ss << (i ? ", " : "") << indices[i];
+    }
+    ss << "]\n    point3f[] points = [";
+    for (size_t i = 0; i < points.size(); i++) {
+      ss << (i ? ", " : "") << "(" << points[i][0] << ", " << points[i][1]
+         << ", 0)";
+    }
+    ss << "]\n}\n";
+    const std::string usda = ss.str();
+
+    Stage stage;
+    std::string warn, err;
+    bool ret = LoadUSDAFromMemory(
+        reinterpret_cast<const uint8_t *>(usda.c_str()), usda.size(), "",
+        &stage, &warn, &err);
+    TEST_CHECK(ret);
+    if (!ret) {
+      TEST_MSG("%s", err.c_str());
+      return;
+    }
+
+    RenderSceneConverterEnv env(stage);
+    env.mesh_config.num_lods = 2;
+    env.mesh_config.lod_reduction_ratio = 0.25f;
+    RenderSceneConverter converter;
+    RenderScene scene;
+
+    ret = converter.ConvertToRenderScene(env, &scene);
+    TEST_CHECK(ret);
+    if (!ret) {
+      TEST_MSG("%s", converter.GetError().c_str());
+      return;
+    }
+
+    TEST_CHECK(scene.meshes.size() == 1);
+    if (scene.meshes.size() != 1) {
+      return;
+    }
+
+    const RenderMesh &mesh = scene.meshes[0];
+    const size_t num_faces = mesh.faceVertexIndices().size() / 3;
+    TEST_CHECK(mesh.lods.size() == 2);
+    if (mesh.lods.size() != 2) {
+      TEST_MSG("%s", converter.GetWarning().c_str());
+      return;
+    }
+    TEST_CHECK(mesh.lods[0].faceVertexIndices.size() / 3 <= num_faces / 4);
+    TEST_CHECK(mesh.lods[1].faceVertexIndices.size() <
+               mesh.lods[0].faceVertexIndices.size());
+    for (uint32_t idx : mesh.lods[1].faceVertexIndices) {
+      TEST_CHECK(idx < mesh.points.size());
+    }
+  }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+void tydra_build_indices_test(void);
+void tydra_point_instancer_test(void);
+void tydra_update_to_time_test(void);
+void tydra_parallel_mesh_conversion_test(void);
+void tydra_compute_vertex_normals_test(void);
+void tydra_triangulate_test(void);
+void tydra_skinning_test(void);
+void tydra_blendshape_inbetween_test(void);
+void tydra_xform_cache_test(void);
+void tydra_bbox_cache_test(void);
+void tydra_mesh_lod_test(void);
@@ -0,0 +1,562 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "unit-usdc-reader.h"
+#include "crate-reader.hh"
+#include "math-util.inc"
+#include "pprinter.hh"
+#include "prim-types.hh"
+#include "stage.hh"
+#include "stream-reader.hh"
+#include "thread-util.hh"
+#include "tinyusdz.hh"
+#include "usdc-writer.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+// USDA with many Prims, so that each USDC section and fieldset has enough
+// entries to be split among threads.
+std::string MakeTestUSDA(int num_prims) {
+  std::stringstream ss;
+  ss << "#usda 1.0\n";
+  ss << "(\n    defaultPrim = \"prim0\"\n    upAxis = \"Z\"\n)\n\n";
+  for (int i = 0; i < num_prims; i++) {
+    ss << "def Xform \"prim" << i << "\" (\n";
+    ss << "    customData = {\n        int index = " << i << "\n    }\n";
+    ss << "    kind = \"component\"\n";
+    ss << ")\n{\n";
+    ss << "    double value = " << (i * 0.125 + 0.1) << "\n";
+    ss << "    string label = \"label" << i << "\"\n";
+    ss << "    token mode = \"mode" << (i % 5) << "\"\n";
+    ss << "    int[] ints = [";
+    for (int k = 0; k < 32; k++) {
+      ss << (k ? ", " : "") << (k * i - 7);
+    }
+    ss << "]\n";
+    ss << "    float[] floats = [";
+    for (int k = 0; k < 32; k++) {
+      ss << (k ? ", " : "") << (float(k) * 0.5f + float(i));
+    }
+    ss << "]\n";
+    ss << "    float3 animated.timeSamples = {\n";
+    ss << "        0: (0, 0, " << i << "),\n";
+    ss << "        1: (1, 2, " << i << "),\n";
+    ss << "    }\n";
+    ss << "    rel target = </prim" << ((i + 1) % num_prims) << ">\n";
+    ss << "\n    def Scope \"child" << i << "\"\n    {\n";
+    ss << "        int depth = 1\n";
+    ss << "    }\n";
+    ss << "}\n\n";
+  }
+  return ss.str();
+}
+
+bool MakeTestUSDC(int num_prims, std::vector<uint8_t> *usdc) {
+  std::string usda = MakeTestUSDA(num_prims);
+
+  Layer layer;
+  std::string warn, err;
+  if (!LoadUSDALayerFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                               usda.size(), "test.usda", &layer, &warn,
+                               &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+
+  for (int i = 0; i < num_prims; i++) {
+    layer.metas().primChildren.push_back(
+        value::token("prim" + std::to_string(i)));
+  }
+
+  if (!usdc::SaveAsUSDCToMemory(layer, usdc, &warn, &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+
+  return true;
+}
+
+// Nested Prims with many properties, so that the number of paths exceeds the
+// threshold of parallel PathIndex tree decoding.
+bool MakeManyPathsUSDC(std::vector<uint8_t> *usdc) {
+  std::stringstream ss;
+  ss << "#usda 1.0\n";
+  std::vector<value::token> prim_children;
+  for (int i = 0; i < 64; i++) {
+    ss << "def Xform \"group" << i << "\"\n{\n";
+    for (int j = 0; j < 64; j++) {
+      ss << "    def Xform \"item" << j << "\"\n    {\n";
+      for (int k = 0; k < 8; k++) {
+        ss << "        int attr" << k << " = " << (i + j + k) << "\n";
+      }
+      ss << "    }\n";
+    }
+    ss << "}\n";
+    prim_children.push_back(value::token("group" + std::to_string(i)));
+  }
+
+  std::string usda = ss.str();
+  std::string warn, err;
+  Layer layer;
+  if (!LoadUSDALayerFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                               usda.size(), "test.usda", &layer, &warn,
+                               &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+  layer.metas().primChildren = prim_children;
+
+  if (!usdc::SaveAsUSDCToMemory(layer, usdc, &warn, &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+
+  return true;
+}
+
+// Path::operator== is false for invalid Paths(e.g. element Path of the root).
+bool IsSamePath(const Path &a, const Path &b) {
+  return (a.is_valid() == b.is_valid()) &&
+         (a.full_path_name() == b.full_path_name());
+}
+
+struct LoadResult {
+  bool ok{false};
+  std::string layer;
+  std::string warn;
+  std::string err;
+};
+
+LoadResult LoadAsLayer(const std::vector<uint8_t> &usdc, int num_threads) {
+  USDLoadOptions options;
+  options.num_threads = num_threads;
+
+  LoadResult result;
+  Layer layer;
+  result.ok = LoadUSDCLayerFromMemory(usdc.data(), usdc.size(), "test.usdc",
+                                      &layer, &result.warn, &result.err,
+                                      options);
+  if (result.ok) {
+    result.layer = print_layer(layer, 0);
+  }
+  return result;
+}
+
+bool WriteFile(const std::string &filename, const std::vector<uint8_t> &data) {
+  std::ofstream ofs(filename, std::ios::binary);
+  if (!ofs) {
+    return false;
+  }
+  ofs.write(reinterpret_cast<const char *>(data.data()),
+            std::streamsize(data.size()));
+  return bool(ofs);
+}
+
+void CollectDeferredVars(PrimSpec &ps,
+                         std::vector<const primvar::PrimVar *> *vars) {
+  for (auto &prop : ps.props()) {
+    if (prop.second.is_attribute()) {
+      const primvar::PrimVar &var = prop.second.attribute().get_var();
+      if (var.has_deferred()) {
+        vars->push_back(&var);
+      }
+    }
+  }
+  for (auto &child : ps.children()) {
+    CollectDeferredVars(child, vars);
+  }
+}
+
+// USDC file larger than 1MB.
+bool MakeLargeUSDC(std::vector<uint8_t> *usdc) {
+  std::stringstream ss;
+  ss << "#usda 1.0\n";
+  ss << "def Xform \"root\"\n{\n";
+  ss << "    float[] values = [";
+  for (int k = 0; k < 384 * 1024; k++) {
+    ss << (k ? ", " : "") << (float(k) * 0.37f);
+  }
+  ss << "]\n";
+  ss << "}\n";
+
+  std::string usda = ss.str();
+  std::string warn, err;
+  Layer layer;
+  if (!LoadUSDALayerFromMemory(reinterpret_cast<const uint8_t *>(usda.data()),
+                               usda.size(), "test.usda", &layer, &warn,
+                               &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+  layer.metas().primChildren.push_back(value::token("root"));
+
+  if (!usdc::SaveAsUSDCToMemory(layer, usdc, &warn, &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+
+  return usdc->size() > 1024 * 1024;
+}
+
+}  // namespace
+
+void usdc_reader_thread_test(void) {
+  if (!thread::IsThreadingEnabled()) {
+    // Parallel decoding is not compiled in. Still check the multi-threaded
+    // option runs serially.
+    TEST_CHECK(thread::GetNumThreads(4) == 1);
+  }
+
+  std::vector<uint8_t> usdc;
+  TEST_CHECK(MakeTestUSDC(/* num_prims */ 64, &usdc));
+
+  // Layer
+  {
+    LoadResult serial = LoadAsLayer(usdc, 1);
+    TEST_CHECK(serial.ok);
+    TEST_MSG("%s", serial.err.c_str());
+    TEST_CHECK(serial.layer.find("label63") != std::string::npos);
+
+    for (int num_threads : {2, 4, 7}) {
+      LoadResult parallel = LoadAsLayer(usdc, num_threads);
+      TEST_CHECK(parallel.ok);
+      TEST_CHECK(parallel.layer == serial.layer);
+      TEST_CHECK(parallel.warn == serial.warn);
+      TEST_CHECK(parallel.err == serial.err);
+      TEST_MSG("num_threads %d", num_threads);
+    }
+  }
+
+  // Stage
+  {
+    std::string serial_str;
+    for (int num_threads : {1, 4}) {
+      USDLoadOptions options;
+      options.num_threads = num_threads;
+
+      Stage stage;
+      std::string warn, err;
+      TEST_CHECK(LoadUSDCFromMemory(usdc.data(), usdc.size(), "test.usdc",
+                                    &stage, &warn, &err, options));
+      TEST_MSG("%s", err.c_str());
+      if (num_threads == 1) {
+        serial_str = stage.ExportToString();
+      } else {
+        TEST_CHECK(stage.ExportToString() == serial_str);
+      }
+    }
+  }
+
+  // Corrupted data reports the same result regardless of the number of
+  // threads.
+  const size_t stride = usdc.size() / 128;
+  for (size_t offset = 88; offset < usdc.size(); offset += stride) {
+    std::vector<uint8_t> corrupted = usdc;
+    for (size_t i = offset; i < (std::min)(offset + 64, corrupted.size());
+         i++) {
+      corrupted[i] = uint8_t(corrupted[i] ^ 0x5a);
+    }
+
+    LoadResult serial = LoadAsLayer(corrupted, 1);
+    LoadResult parallel = LoadAsLayer(corrupted, 4);
+    TEST_CHECK(parallel.ok == serial.ok);
+    TEST_CHECK(parallel.layer == serial.layer);
+    TEST_CHECK(parallel.err == serial.err);
+    TEST_MSG("offset %d\nserial: %s\nparallel: %s", int(offset),
+             serial.err.c_str(), parallel.err.c_str());
+  }
+}
+
+void usdc_reader_path_hierarchy_test(void) {
+  std::vector<uint8_t> usdc;
+  TEST_CHECK(MakeManyPathsUSDC(&usdc));
+
+  std::vector<std::unique_ptr<crate::CrateReader>> readers;
+  std::vector<std::unique_ptr<StreamReader>> stream_readers;
+
+  for (int num_threads : {1, 4}) {
+    stream_readers.emplace_back(
+        new StreamReader(usdc.data(), usdc.size(), /* swap_endian */ false));
+
+    crate::CrateReaderConfig config;
+    config.numThreads = num_threads;
+    readers.emplace_back(
+        new crate::CrateReader(stream_readers.back().get(), config));
+
+    crate::CrateReader &reader = *readers.back();
+    TEST_CHECK(reader.ReadBootStrap());
+    TEST_CHECK(reader.ReadTOC());
+    TEST_CHECK(reader.ReadKnownSections());
+    TEST_MSG("%s", reader.GetError().c_str());
+  }
+
+  const crate::CrateReader &serial = *readers[0];
+  const crate::CrateReader &parallel = *readers[1];
+
+  // 64 * 64 * 8 property paths.
+  TEST_CHECK(serial.NumPaths() > 64 * 64 * 8);
+  TEST_CHECK(parallel.NumPaths() == serial.NumPaths());
+
+  for (size_t i = 0; i < serial.NumPaths(); i++) {
+    crate::Index idx{uint32_t(i)};
+    auto path = serial.GetPath(idx);
+    auto parallel_path = parallel.GetPath(idx);
+    TEST_CHECK(path && parallel_path);
+    if (path && parallel_path) {
+      TEST_CHECK(IsSamePath(path.value(), parallel_path.value()));
+    }
+
+    auto elem_path = serial.GetElementPath(idx);
+    auto parallel_elem_path = parallel.GetElementPath(idx);
+    TEST_CHECK(bool(elem_path) == bool(parallel_elem_path));
+    if (elem_path && parallel_elem_path) {
+      TEST_CHECK(IsSamePath(elem_path.value(), parallel_elem_path.value()));
+    }
+  }
+
+  const std::vector<crate::CrateReader::Node> nodes = serial.GetNodes();
+  const std::vector<crate::CrateReader::Node> parallel_nodes =
+      parallel.GetNodes();
+  TEST_CHECK(nodes.size() == parallel_nodes.size());
+  for (size_t i = 0; i < (std::min)(nodes.size(), parallel_nodes.size());
+       i++) {
+    TEST_CHECK(nodes[i].GetParent() == parallel_nodes[i].GetParent());
+    TEST_CHECK(nodes[i].GetChildren() == parallel_nodes[i].GetChildren());
+    TEST_CHECK(IsSamePath(nodes[i].GetPath(), parallel_nodes[i].GetPath()));
+    TEST_CHECK(nodes[i].GetPrimChildren() ==
+               parallel_nodes[i].GetPrimChildren());
+    TEST_MSG("node %d", int(i));
+  }
+}
+
+void usdc_reader_lazy_test(void) {
+  std::vector<uint8_t> usdc;
+  TEST_CHECK(MakeTestUSDC(/* num_prims */ 16, &usdc));
+
+  const std::string filename = "unit-usdc-reader-lazy.usdc";
+  TEST_CHECK(WriteFile(filename, usdc));
+
+  USDLoadOptions eager_options;
+  Layer eager;
+  std::string warn, err;
+  TEST_CHECK(LoadLayerFromFile(filename, &eager, &warn, &err, eager_options));
+  TEST_MSG("%s", err.c_str());
+  const std::string eager_str = print_layer(eager, 0);
+  TEST_CHECK(eager_str.find("label15") != std::string::npos);
+
+  USDLoadOptions lazy_options;
+  lazy_options.lazy_value_unpack = true;
+
+  // Deferred values are decoded on the first access.
+  {
+    Layer lazy;
+    TEST_CHECK(LoadLayerFromFile(filename, &lazy, &warn, &err, lazy_options));
+    TEST_MSG("%s", err.c_str());
+
+    std::vector<const primvar::PrimVar *> vars;
+    for (auto &root : lazy.primspecs()) {
+      CollectDeferredVars(root.second, &vars);
+    }
+    // `ints`, `floats` and `animated` of each Prim.
+    TEST_CHECK(vars.size() == 16 * 3);
+
+    TEST_CHECK(print_layer(lazy, 0) == eager_str);
+    for (const primvar::PrimVar *var : vars) {
+      TEST_CHECK(var->has_deferred() == false);
+    }
+  }
+
+  // Concurrent materialization of the same values.
+  {
+    Layer lazy;
+    TEST_CHECK(LoadLayerFromFile(filename, &lazy, &warn, &err, lazy_options));
+
+    std::vector<const primvar::PrimVar *> vars;
+    for (auto &root : lazy.primspecs()) {
+      CollectDeferredVars(root.second, &vars);
+    }
+    TEST_CHECK(vars.size() == 16 * 3);
+
+    const size_t num_tasks = vars.size() * 4;
+    std::vector<std::string> type_names(num_tasks);
+    thread::ParallelFor(size_t(0), num_tasks, thread::GetNumThreads(4),
+                        [&](size_t i, int /* tid */) {
+                          const primvar::PrimVar *var = vars[i % vars.size()];
+                          if (var->materialize()) {
+                            type_names[i] = var->type_name();
+                          }
+                        });
+    for (size_t i = 0; i < num_tasks; i++) {
+      TEST_CHECK(type_names[i] == vars[i % vars.size()]->type_name());
+      TEST_CHECK(type_names[i] != "[[InvalidType]]");
+    }
+
+    TEST_CHECK(print_layer(lazy, 0) == eager_str);
+  }
+
+  // Memory which is not owned by the loader is decoded eagerly.
+  {
+    Layer layer;
+    TEST_CHECK(LoadLayerFromMemory(usdc.data(), usdc.size(), filename, &layer,
+                                   &warn, &err, lazy_options));
+
+    std::vector<const primvar::PrimVar *> vars;
+    for (auto &root : layer.primspecs()) {
+      CollectDeferredVars(root.second, &vars);
+    }
+    TEST_CHECK(vars.empty());
+    TEST_CHECK(print_layer(layer, 0) == eager_str);
+  }
+
+  std::remove(filename.c_str());
+}
+
+void usdc_reader_mmap_test(void) {
+  std::vector<uint8_t> usdc;
+  TEST_CHECK(MakeLargeUSDC(&usdc));
+
+  const std::string filename = "unit-usdc-reader-mmap.usdc";
+  TEST_CHECK(WriteFile(filename, usdc));
+
+  std::string eager_str;
+  {
+    Layer layer;
+    std::string warn, err;
+    TEST_CHECK(LoadLayerFromFile(filename, &layer, &warn, &err));
+    TEST_MSG("%s", err.c_str());
+    eager_str = print_layer(layer, 0);
+  }
+
+  // Memory-mapped(when supported) lazy loading.
+  {
+    USDLoadOptions options;
+    options.lazy_value_unpack = true;
+
+    Layer layer;
+    std::string warn, err;
+    TEST_CHECK(LoadLayerFromFile(filename, &layer, &warn, &err, options));
+    TEST_MSG("%s", err.c_str());
+    TEST_CHECK(print_layer(layer, 0) == eager_str);
+  }
+
+  // `max_memory_limit_in_mb` is applied regardless of lazy value unpacking.
+  for (bool lazy : {false, true}) {
+    USDLoadOptions options;
+    options.lazy_value_unpack = lazy;
+    options.max_memory_limit_in_mb = 1;
+
+    Layer layer;
+    std::string warn, err;
+    TEST_CHECK(!LoadLayerFromFile(filename, &layer, &warn, &err, options));
+    TEST_CHECK(err.find("File size is too large") != std::string::npos);
+    TEST_MSG("lazy %d: %s", int(lazy), err.c_str());
+  }
+
+  std::remove(filename.c_str());
+}
+
+void usdc_reader_array_view_test(void) {
+  std::vector<uint8_t> usdc;
+  TEST_CHECK(MakeTestUSDC(/* num_prims */ 16, &usdc));
+
+  const std::string filename = "unit-usdc-reader-array-view.usdc";
+  TEST_CHECK(WriteFile(filename, usdc));
+
+  USDLoadOptions lazy_options;
+  lazy_options.lazy_value_unpack = true;
+
+  // prim3.floats = [3.0, 3.5, 4.0, ...]
+  auto CheckFloats = [](const primvar::ArrayView<float> &view) {
+    TEST_CHECK(view.size() == 32);
+    if (view.size() == 32) {
+      TEST_CHECK(math::is_close(view[0], 3.0f));
+      TEST_CHECK(math::is_close(view[31], 18.5f));
+    }
+  };
+
+  // Deferred array values are referenced without decoding.
+  primvar::ArrayView<float> floats;
+  {
+    Layer layer;
+    std::string warn, err;
+    TEST_CHECK(LoadLayerFromFile(filename, &layer, &warn, &err, lazy_options));
+    TEST_MSG("%s", err.c_str());
+
+    PrimSpec &ps = layer.primspecs()["prim3"];
+    TEST_CHECK(ps.props().count("floats") == 1);
+    const primvar::PrimVar &var = ps.props()["floats"].attribute().get_var();
+    TEST_CHECK(var.has_deferred());
+
+    TEST_CHECK(var.get_array_view(&floats));
+    TEST_CHECK(var.has_deferred());
+    CheckFloats(floats);
+
+    // Type mismatch
+    primvar::ArrayView<int> ints;
+    TEST_CHECK(!var.get_array_view(&ints));
+  }
+
+  // The view keeps the file content alive.
+  CheckFloats(floats);
+
+  // Stage
+  for (bool lazy : {false, true}) {
+    USDLoadOptions options;
+    options.lazy_value_unpack = lazy;
+
+    Stage stage;
+    std::string warn, err;
+    TEST_CHECK(LoadUSDFromFile(filename, &stage, &warn, &err, options));
+    TEST_MSG("%s", err.c_str());
+
+    Stage usdc_stage;
+    TEST_CHECK(LoadUSDCFromFile(filename, &usdc_stage, &warn, &err, options));
+    TEST_CHECK(stage.ExportToString() == usdc_stage.ExportToString());
+
+    auto prim = stage.GetPrimAtPath(Path("/prim3", ""));
+    TEST_CHECK(prim.has_value());
+    if (!prim) {
+      continue;
+    }
+
+    const Xform *xform = prim.value()->as<Xform>();
+    TEST_CHECK(xform && (xform->props.count("floats") == 1));
+    if (!xform || !xform->props.count("floats")) {
+      continue;
+    }
+
+    const primvar::PrimVar &var =
+        xform->props.at("floats").get_attribute().get_var();
+    TEST_CHECK(var.has_deferred() == lazy);
+
+    // Eagerly loaded value is copied to the view.
+    primvar::ArrayView<float> view;
+    TEST_CHECK(var.get_array_view(&view));
+    TEST_CHECK(var.has_deferred() == lazy);
+    CheckFloats(view);
+  }
+
+  // Lazily loaded Stage is identical to eagerly loaded one.
+  {
+    Stage eager, lazy;
+    std::string warn, err;
+    TEST_CHECK(LoadUSDCFromFile(filename, &eager, &warn, &err));
+    TEST_CHECK(LoadUSDCFromFile(filename, &lazy, &warn, &err, lazy_options));
+    TEST_CHECK(eager.ExportToString() == lazy.ExportToString());
+  }
+
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+void usdc_reader_thread_test(void);
+void usdc_reader_path_hierarchy_test(void);
+void usdc_reader_lazy_test(void);
+void usdc_reader_mmap_test(void);
+void usdc_reader_array_view_test(void);
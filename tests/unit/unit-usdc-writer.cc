@@ -0,0 +1,334 @@
+#ifdef _MSC_VER
+#define NOMINMAX
+#endif
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "unit-usdc-writer.h"
+#include "pprinter.hh"
+#include "prim-types.hh"
+#include "tinyusdz.hh"
+#include "usdc-writer.hh"
+
+using namespace tinyusdz;
+
+namespace {
+
+const char *kRoundtripUSDA = R"(#usda 1.0
+(
+    customLayerData = {
+        string creator = "unit-test"
+    }
+    defaultPrim = "root"
+    metersPerUnit = 0.01
+    timeCodesPerSecond = 24
+    upAxis = "Z"
+)
+
+def Xform "root" (
+    customData = {
+        int count = 3
+        dictionary nested = {
+            token mode = "fast"
+        }
+    }
+    kind = "component"
+    variants = {
+        string shape = "box"
+    }
+    prepend variantSets = "shape"
+)
+{
+    int[] ints = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, -1, -2, -3, 1000000]
+    float[] integral = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]
+    float[] lut = [0.5, 0.25, 0.5, 0.25, 0.5, 0.25, 0.5, 0.25, 0.5, 0.25, 0.5, 0.25, 0.5, 0.25, 0.5, 0.25, 0.5, 0.25]
+    double[] doubles = [0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.1, 1.2, 1.3, 1.4, 1.5, 1.6, 1.7, 1.8]
+    half[] halfs = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17]
+    int64 bigint = 12345678901
+    double pi = 3.14159265358979
+    float3 position = (1, 2, 3)
+    float3 nonint = (0.5, 1.5, 2.25)
+    quatf rot = (1, 0, 0, 0)
+    matrix4d xform = ( (1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (2, 3, 4, 1) )
+    string label = "hello"
+    asset tex = @textures/albedo.png@
+    uniform token[] names = ["a", "b", "c"]
+    bool[] flags = [1, 0, 1]
+    color3f[] colors = [(0.1, 0.2, 0.3), (0.4, 0.5, 0.6)]
+    float blocked = None
+    float3 animated.timeSamples = {
+        0: (0, 0, 0),
+        1: (1, 2, 3),
+        2: None,
+    }
+    token interp = "linear" (
+        customData = {
+            bool editable = 1
+        }
+    )
+    rel material:binding = </root/mat>
+    rel multi = [</root/mat>, </root/child>]
+
+    def "child" (
+        references = @./ref.usda@</src>
+    )
+    {
+        float2[] st = [(0, 0), (1, 0), (1, 1)] (
+            interpolation = "vertex"
+        )
+    }
+
+    def Material "mat"
+    {
+        token outputs:surface.connect = </root/mat/shader.outputs:surface>
+    }
+
+    variantSet "shape" = {
+        "box" {
+            double size = 2
+        }
+        "ball" {
+            double radius = 1
+        }
+    }
+}
+
+class "_base"
+{
+    int value = 7
+}
+)";
+
+// Typed(schema) Prims are converted to PrimSpec when saving a Stage.
+const char *kTypedPrimsUSDA = R"(#usda 1.0
+(
+    defaultPrim = "root"
+    upAxis = "Y"
+)
+
+def Xform "root"
+{
+    double3 xformOp:translate = (1, 2, 3)
+    float3 xformOp:scale.timeSamples = {
+        0: (1, 1, 1),
+        1: (2, 2, 2),
+    }
+    uniform token[] xformOpOrder = ["xformOp:translate", "xformOp:scale", "!invert!xformOp:translate"]
+
+    def Mesh "mesh" (
+        prepend apiSchemas = ["MaterialBindingAPI"]
+    )
+    {
+        float3[] extent = [(-1, -1, 0), (1, 1, 0)]
+        int[] faceVertexCounts = [4]
+        int[] faceVertexIndices = [0, 1, 2, 3]
+        point3f[] points = [(-1, -1, 0), (1, -1, 0), (1, 1, 0), (-1, 1, 0)]
+        uniform token subdivisionScheme = "none"
+        uniform token orientation = "leftHanded"
+        uniform bool doubleSided = 1
+        token visibility.timeSamples = {
+            0: "inherited",
+            1: "invisible",
+        }
+        texCoord2f[] primvars:st = [(0, 0), (1, 0), (1, 1), (0, 1)] (
+            interpolation = "vertex"
+        )
+        rel material:binding = </root/mat>
+
+        def GeomSubset "subset"
+        {
+            uniform token elementType = "face"
+            uniform token familyName = "materialBind"
+            int[] indices = [0]
+        }
+    }
+
+    def Material "mat"
+    {
+        token outputs:surface.connect = </root/mat/surface.outputs:surface>
+
+        def Shader "surface"
+        {
+            uniform token info:id = "UsdPreviewSurface"
+            color3f inputs:diffuseColor.connect = </root/mat/tex.outputs:rgb>
+            float inputs:roughness = 0.25
+            token outputs:surface
+        }
+
+        def Shader "tex"
+        {
+            uniform token info:id = "UsdUVTexture"
+            asset inputs:file = @albedo.png@
+            token inputs:wrapS = "repeat"
+            float3 outputs:rgb
+        }
+    }
+
+    def Camera "cam"
+    {
+        float focalLength = 35
+        token projection = "orthographic"
+    }
+
+    def SphereLight "light"
+    {
+        float inputs:intensity = 10
+        float inputs:radius = 0.25
+    }
+}
+)";
+
+bool ParseUSDALayer(const std::string &usda, Layer *layer) {
+  std::string warn, err;
+  bool ret = LoadUSDALayerFromMemory(
+      reinterpret_cast<const uint8_t *>(usda.data()), usda.size(), "test.usda",
+      layer, &warn, &err);
+  if (!ret) {
+    std::cerr << err << "\n";
+  }
+  return ret;
+}
+
+bool WriteAndReadLayer(const Layer &layer,
+                       const usdc::USDCWriterConfig &config,
+                       std::vector<uint8_t> *usdc, Layer *dst) {
+  std::string warn, err;
+  if (!usdc::SaveAsUSDCToMemory(layer, usdc, &warn, &err, config)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+
+  if (!LoadUSDCLayerFromMemory(usdc->data(), usdc->size(), "test.usdc", dst,
+                               &warn, &err)) {
+    std::cerr << err << "\n";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void usdc_writer_roundtrip_test(void) {
+  Layer layer;
+  TEST_CHECK(ParseUSDALayer(kRoundtripUSDA, &layer));
+  // Keep root Prim order in the output.
+  layer.metas().primChildren = {value::token("root"), value::token("_base")};
+
+  std::vector<usdc::USDCWriterConfig> configs(3);
+  configs[1].compress_arrays = false;
+  configs[2].deduplicate_values = false;
+  configs[2].num_threads = 2;
+
+  for (const auto &config : configs) {
+    std::vector<uint8_t> usdc;
+    Layer dst;
+    TEST_CHECK(WriteAndReadLayer(layer, config, &usdc, &dst));
+    TEST_CHECK(usdc.size() > 88);
+    TEST_CHECK(memcmp(usdc.data(), "PXR-USDC", 8) == 0);
+
+    std::string expected = to_string(layer);
+    std::string actual = to_string(dst);
+    TEST_CHECK(expected == actual);
+    TEST_MSG("expected:\n%s\nactual:\n%s", expected.c_str(), actual.c_str());
+  }
+
+  // Read as Stage
+  {
+    std::vector<uint8_t> usdc;
+    std::string warn, err;
+    TEST_CHECK(usdc::SaveAsUSDCToMemory(layer, &usdc, &warn, &err));
+
+    Stage stage;
+    TEST_CHECK(LoadUSDCFromMemory(usdc.data(), usdc.size(), "test.usdc",
+                                  &stage, &warn, &err));
+
+    const Prim *prim{nullptr};
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/child", ""), prim));
+    TEST_CHECK(stage.find_prim_at_path(Path("/root/mat", ""), prim));
+    TEST_CHECK(stage.find_prim_at_path(Path("/_base", ""), prim));
+    TEST_CHECK(stage.metas().upAxis.get_value() == Axis::Z);
+    TEST_CHECK(stage.metas().defaultPrim.str() == "root");
+  }
+}
+
+void usdc_writer_compression_test(void) {
+  // Large arrays of the same content in two Prims.
+  std::stringstream ss;
+  ss << "#usda 1.0\n";
+  for (const char *name : {"a", "b"}) {
+    ss << "def Xform \"" << name << "\"\n{\n";
+    ss << "    int[] indices = [";
+    for (int i = 0; i < 4096; i++) {
+      ss << (i ? ", " : "") << (i % 64);
+    }
+    ss << "]\n";
+    ss << "    float[] weights = [";
+    for (int i = 0; i < 4096; i++) {
+      ss << (i ? ", " : "") << ((i % 2) ? "0.5" : "0.25");
+    }
+    ss << "]\n}\n";
+  }
+
+  Layer layer;
+  TEST_CHECK(ParseUSDALayer(ss.str(), &layer));
+  layer.metas().primChildren = {value::token("a"), value::token("b")};
+
+  usdc::USDCWriterConfig config;
+
+  std::vector<uint8_t> compressed;
+  Layer dst;
+  TEST_CHECK(WriteAndReadLayer(layer, config, &compressed, &dst));
+  TEST_CHECK(to_string(layer) == to_string(dst));
+
+  config.compress_arrays = false;
+  std::vector<uint8_t> uncompressed;
+  TEST_CHECK(WriteAndReadLayer(layer, config, &uncompressed, &dst));
+  TEST_CHECK(to_string(layer) == to_string(dst));
+
+  config.deduplicate_values = false;
+  std::vector<uint8_t> no_dedup;
+  TEST_CHECK(WriteAndReadLayer(layer, config, &no_dedup, &dst));
+  TEST_CHECK(to_string(layer) == to_string(dst));
+
+  // 2 arrays * 4096 * 4 bytes are stored once when deduplicated.
+  TEST_CHECK(no_dedup.size() >= uncompressed.size() + 2 * 4096 * 4);
+  TEST_CHECK(compressed.size() * 4 < uncompressed.size());
+  TEST_MSG("compressed %d bytes, uncompressed %d bytes",
+           int(compressed.size()), int(uncompressed.size()));
+}
+
+void usdc_writer_stage_test(void) {
+  for (const char *usda : {kRoundtripUSDA, kTypedPrimsUSDA}) {
+    Stage stage;
+    {
+      std::string warn, err;
+      TEST_CHECK(LoadUSDAFromMemory(reinterpret_cast<const uint8_t *>(usda),
+                                    strlen(usda), "", &stage, &warn, &err));
+    }
+
+    std::vector<uint8_t> usdc;
+    std::string warn, err;
+#if defined(TINYUSDZ_WITH_TYDRA)
+    TEST_CHECK(usdc::SaveAsUSDCToMemory(stage, &usdc, &warn, &err));
+    TEST_MSG("%s", err.c_str());
+
+    Stage dst;
+    TEST_CHECK(LoadUSDCFromMemory(usdc.data(), usdc.size(), "test.usdc", &dst,
+                                  &warn, &err));
+    TEST_MSG("%s", err.c_str());
+
+    std::string expected = stage.ExportToString();
+    std::string actual = dst.ExportToString();
+    TEST_CHECK(expected == actual);
+    TEST_MSG("expected:\n%s\nactual:\n%s", expected.c_str(), actual.c_str());
+#else
+    // Stage -> PrimSpec conversion requires Tydra.
+    TEST_CHECK(!usdc::SaveAsUSDCToMemory(stage, &usdc, &warn, &err));
+#endif
+  }
+}
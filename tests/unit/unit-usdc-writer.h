@@ -0,0 +1,5 @@
+#pragma once
+
+void usdc_writer_roundtrip_test(void);
+void usdc_writer_compression_test(void);
+void usdc_writer_stage_test(void);